@@ -0,0 +1,97 @@
+# Novadesk Render Benchmark Script
+# Use: .\Benchmark.ps1 [-Filter "Text*"] [-Frames 60] [-UpdateGolden]
+# Renders every integration widget headlessly and compares against golden images.
+# A script without a golden image under tests\golden fails; record it with
+# -UpdateGolden. Scripts listed in tests\golden\allow-missing.txt render
+# machine-dependent frames and are reported as SKIP instead.
+
+param(
+    [string]$Filter = "*",
+    [int]$Frames = 60,
+    [int]$Tolerance = 2,
+    [string]$GoldenDir = "$PSScriptRoot\tests\golden",
+    [string]$AllowMissing = "$PSScriptRoot\tests\golden\allow-missing.txt",
+    [string]$OutDir = "$PSScriptRoot\dist\benchmark",
+    [switch]$UpdateGolden
+)
+
+$exePath = "$PSScriptRoot\dist\novadesk.exe"
+
+if (-not (Test-Path $exePath)) {
+    Write-Host "Error: Novadesk.exe not found at $exePath" -ForegroundColor Red
+    exit 1
+}
+
+New-Item -ItemType Directory -Force -Path $OutDir | Out-Null
+
+$allowMissingNames = @()
+if (Test-Path $AllowMissing) {
+    $allowMissingNames = Get-Content $AllowMissing |
+        ForEach-Object { $_.Trim() } |
+        Where-Object { $_ -and -not $_.StartsWith("#") }
+}
+
+$tests = Get-ChildItem -Path "$PSScriptRoot\tests\integrations" -Directory -Filter $Filter |
+    Where-Object { Test-Path (Join-Path $_.FullName "index.js") }
+
+Write-Host "====================================================" -ForegroundColor Cyan
+Write-Host " Novadesk Render Benchmark ($($tests.Count) scripts)" -ForegroundColor Cyan
+Write-Host "====================================================" -ForegroundColor Cyan
+
+$failed = @()
+$skipped = @()
+foreach ($test in $tests) {
+    $script = Join-Path $test.FullName "index.js"
+    $report = Join-Path $OutDir "$($test.Name).json"
+    $golden = Join-Path $GoldenDir $test.Name
+
+    $arguments = @("--benchmark", "--benchmark-frames", $Frames, "--benchmark-tolerance", $Tolerance,
+                   "--benchmark-golden", "`"$golden`"", "--benchmark-report", "`"$report`"", "`"$script`"")
+    $allowed = $allowMissingNames -contains $test.Name
+    if ($allowed) {
+        $arguments += "--benchmark-allow-missing"
+    }
+    elseif ($UpdateGolden) {
+        $arguments += "--update-golden"
+    }
+
+    $process = Start-Process -FilePath $exePath -ArgumentList $arguments -PassThru -NoNewWindow -Wait
+
+    $summary = ""
+    $compared = $false
+    if (Test-Path $report) {
+        $data = Get-Content $report -Raw | ConvertFrom-Json
+        foreach ($widget in $data.widgets) {
+            $summary += " [$($widget.id): mean $([math]::Round($widget.meanFrameUs))us p95 $($widget.p95FrameUs)us"
+            if ($widget.golden) {
+                $summary += " $($widget.golden.status)"
+                if ($widget.golden.status -ne "missing") {
+                    $compared = $true
+                }
+            }
+            $summary += "]"
+        }
+    }
+
+    if ($process.ExitCode -eq 0 -and $allowed -and -not $compared) {
+        Write-Host "SKIP $($test.Name)$summary" -ForegroundColor Yellow
+        $skipped += $test.Name
+    }
+    elseif ($process.ExitCode -eq 0) {
+        Write-Host "PASS $($test.Name)$summary" -ForegroundColor Green
+    }
+    else {
+        Write-Host "FAIL $($test.Name)$summary" -ForegroundColor Red
+        $failed += $test.Name
+    }
+}
+
+Write-Host ""
+if ($skipped.Count -gt 0) {
+    Write-Host "$($skipped.Count) allow-listed script(s) have no golden image: $($skipped -join ', ')" -ForegroundColor Yellow
+}
+if ($failed.Count -gt 0) {
+    Write-Host "$($failed.Count) script(s) failed: $($failed -join ', ')" -ForegroundColor Red
+    exit 1
+}
+Write-Host "All benchmarks passed. Reports in $OutDir" -ForegroundColor Cyan
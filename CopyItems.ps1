@@ -56,7 +56,7 @@ try {
     $restartExeSrc = Join-Path $RepoRoot "src\apps\x64\$Configuration\restart_novadesk\restart_novadesk.exe"
     $ndpkgInstallerExeSrc = Join-Path $RepoRoot "src\apps\x64\$Configuration\ndpkg_installer\ndpkg_installer.exe"
     $addonsBuildRoot = Join-Path $RepoRoot "src\addons\dist\$Platform\$Configuration"
-    $addonProjectNames = @("AppVolume", "AudioLevel", "Brightness", "Hotkey", "NowPlaying", "InputBox", "BlurBehind")
+    $addonProjectNames = @("AppVolume", "AudioLevel", "Brightness", "Hotkey", "NowPlaying", "InputBox", "BlurBehind", "DataFeed")
 
     Assert-PathExists -PathValue $novadeskExeSrc -Label "novadesk.exe"
     Assert-PathExists -PathValue $widgetsSrc -Label "Widgets source"
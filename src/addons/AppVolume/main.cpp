@@ -18,12 +18,21 @@
 #include <objbase.h>
 #include <shellapi.h>
 #include <cstdio>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 #include <string>
-#include <algorithm>
 
 const NovadeskHostAPI *g_Host = nullptr;
+static HWND g_MessageWindow = nullptr;
 
 #ifndef __IAudioMeterInformation_INTERFACE_DEFINED__
 #define __IAudioMeterInformation_INTERFACE_DEFINED__
@@ -53,18 +62,8 @@ namespace
         float volume = 0.0f;
         float peak = 0.0f;
         bool muted = false;
-    };
-
-    struct ComInit
-    {
-        HRESULT hr = E_FAIL;
-        ComInit() { hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED); }
-        ~ComInit()
-        {
-            if (SUCCEEDED(hr))
-                CoUninitialize();
-        }
-        bool Ok() const { return SUCCEEDED(hr) || hr == RPC_E_CHANGED_MODE; }
+        bool active = false;
+        int sessionCount = 1;
     };
 
     std::wstring ToLowerCopy(const std::wstring &s)
@@ -380,260 +379,769 @@ namespace
         return L"";
     }
 
-    bool SetForMatchingSessions(DWORD pid, const std::wstring &processName, bool byPid, float *setVolume, bool *setMute)
+    template <typename T>
+    void SafeRelease(T *&p)
     {
-        ComInit com;
-        if (!com.Ok())
-            return false;
+        if (p)
+        {
+            p->Release();
+            p = nullptr;
+        }
+    }
 
-        IMMDeviceEnumerator *deviceEnum = nullptr;
-        IMMDevice *device = nullptr;
-        IAudioSessionManager2 *manager2 = nullptr;
-        IAudioSessionEnumerator *sessionEnum = nullptr;
-        bool anySet = false;
-        std::wstring target = byPid ? L"" : ToLowerCopy(processName);
-
-        do
-        {
-            HRESULT hr = CoCreateInstance(__uuidof(MMDeviceEnumerator), nullptr, CLSCTX_ALL, __uuidof(IMMDeviceEnumerator), (void **)&deviceEnum);
-            if (FAILED(hr) || !deviceEnum)
-                break;
-            hr = deviceEnum->GetDefaultAudioEndpoint(eRender, eMultimedia, &device);
-            if (FAILED(hr) || !device)
-                break;
-            hr = device->Activate(__uuidof(IAudioSessionManager2), CLSCTX_ALL, nullptr, (void **)&manager2);
-            if (FAILED(hr) || !manager2)
-                break;
-            hr = manager2->GetSessionEnumerator(&sessionEnum);
-            if (FAILED(hr) || !sessionEnum)
-                break;
+    class AudioSessionRegistry;
 
-            int count = 0;
-            hr = sessionEnum->GetCount(&count);
-            if (FAILED(hr))
-                break;
+    // Forwards one session's IAudioSessionEvents to the registry by id.
+    class SessionEvents : public IAudioSessionEvents
+    {
+    public:
+        SessionEvents(AudioSessionRegistry *owner, uint64_t id) : m_Owner(owner), m_Id(id) {}
 
-            for (int i = 0; i < count; ++i)
+        ULONG STDMETHODCALLTYPE AddRef() override { return InterlockedIncrement(&m_Ref); }
+        ULONG STDMETHODCALLTYPE Release() override
+        {
+            const ULONG ref = InterlockedDecrement(&m_Ref);
+            if (ref == 0)
+                delete this;
+            return ref;
+        }
+        HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void **ppv) override
+        {
+            if (!ppv)
+                return E_POINTER;
+            if (riid == __uuidof(IUnknown) || riid == __uuidof(IAudioSessionEvents))
             {
-                IAudioSessionControl *control = nullptr;
-                IAudioSessionControl2 *control2 = nullptr;
-                ISimpleAudioVolume *simpleVol = nullptr;
-
-                if (FAILED(sessionEnum->GetSession(i, &control)) || !control)
-                    continue;
-                if (FAILED(control->QueryInterface(__uuidof(IAudioSessionControl2), (void **)&control2)) || !control2)
-                {
-                    control->Release();
-                    continue;
-                }
-                if (FAILED(control->QueryInterface(__uuidof(ISimpleAudioVolume), (void **)&simpleVol)) || !simpleVol)
-                {
-                    control2->Release();
-                    control->Release();
-                    continue;
-                }
+                *ppv = static_cast<IAudioSessionEvents *>(this);
+                AddRef();
+                return S_OK;
+            }
+            *ppv = nullptr;
+            return E_NOINTERFACE;
+        }
 
-                DWORD curPid = 0;
-                control2->GetProcessId(&curPid);
-                bool match = false;
-                if (byPid)
-                {
-                    match = (curPid == pid);
-                }
-                else
-                {
-                    std::wstring curName = ToLowerCopy(FileNameFromPath(GetProcessPathByPid(curPid)));
-                    match = (curName == target);
-                }
+        HRESULT STDMETHODCALLTYPE OnDisplayNameChanged(LPCWSTR newDisplayName, LPCGUID) override;
+        HRESULT STDMETHODCALLTYPE OnIconPathChanged(LPCWSTR, LPCGUID) override { return S_OK; }
+        HRESULT STDMETHODCALLTYPE OnSimpleVolumeChanged(float newVolume, BOOL newMute, LPCGUID) override;
+        HRESULT STDMETHODCALLTYPE OnChannelVolumeChanged(DWORD, float[], DWORD, LPCGUID) override { return S_OK; }
+        HRESULT STDMETHODCALLTYPE OnGroupingParamChanged(LPCGUID, LPCGUID) override { return S_OK; }
+        HRESULT STDMETHODCALLTYPE OnStateChanged(AudioSessionState newState) override;
+        HRESULT STDMETHODCALLTYPE OnSessionDisconnected(AudioSessionDisconnectReason reason) override;
+
+    private:
+        LONG m_Ref = 1;
+        AudioSessionRegistry *m_Owner;
+        uint64_t m_Id;
+    };
 
-                if (match)
-                {
-                    if (setVolume)
-                        simpleVol->SetMasterVolume(*setVolume, nullptr);
-                    if (setMute)
-                        simpleVol->SetMute(*setMute ? TRUE : FALSE, nullptr);
-                    anySet = true;
-                }
+    // New sessions on the endpoint and default render device changes.
+    class RegistryNotifications : public IAudioSessionNotification, public IMMNotificationClient
+    {
+    public:
+        explicit RegistryNotifications(AudioSessionRegistry *owner) : m_Owner(owner) {}
 
-                simpleVol->Release();
-                control2->Release();
-                control->Release();
+        ULONG STDMETHODCALLTYPE AddRef() override { return InterlockedIncrement(&m_Ref); }
+        ULONG STDMETHODCALLTYPE Release() override
+        {
+            const ULONG ref = InterlockedDecrement(&m_Ref);
+            if (ref == 0)
+                delete this;
+            return ref;
+        }
+        HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void **ppv) override
+        {
+            if (!ppv)
+                return E_POINTER;
+            if (riid == __uuidof(IUnknown) || riid == __uuidof(IAudioSessionNotification))
+                *ppv = static_cast<IAudioSessionNotification *>(this);
+            else if (riid == __uuidof(IMMNotificationClient))
+                *ppv = static_cast<IMMNotificationClient *>(this);
+            else
+            {
+                *ppv = nullptr;
+                return E_NOINTERFACE;
             }
-        } while (false);
+            AddRef();
+            return S_OK;
+        }
 
-        if (sessionEnum)
-            sessionEnum->Release();
-        if (manager2)
-            manager2->Release();
-        if (device)
-            device->Release();
-        if (deviceEnum)
-            deviceEnum->Release();
-        return anySet;
-    }
+        HRESULT STDMETHODCALLTYPE OnSessionCreated(IAudioSessionControl *newSession) override;
 
-    bool AppVolumeListSessions(std::vector<AppVolumeSessionInfo> &sessions)
+        HRESULT STDMETHODCALLTYPE OnDefaultDeviceChanged(EDataFlow flow, ERole role, LPCWSTR) override;
+        HRESULT STDMETHODCALLTYPE OnDeviceStateChanged(LPCWSTR, DWORD) override { return S_OK; }
+        HRESULT STDMETHODCALLTYPE OnDeviceAdded(LPCWSTR) override { return S_OK; }
+        HRESULT STDMETHODCALLTYPE OnDeviceRemoved(LPCWSTR) override { return S_OK; }
+        HRESULT STDMETHODCALLTYPE OnPropertyValueChanged(LPCWSTR, const PROPERTYKEY) override { return S_OK; }
+
+    private:
+        LONG m_Ref = 1;
+        AudioSessionRegistry *m_Owner;
+    };
+
+    /*
+    ** Long-lived table of the default render endpoint's audio sessions,
+    ** grouped by process id. An MTA worker thread owns the WASAPI objects
+    ** (session notifications only reach MTA clients): it enumerates once,
+    ** then keeps the table current from IAudioSessionNotification, each
+    ** session's IAudioSessionEvents and default device changes. Process path
+    ** and icon are resolved once per process.
+    **
+    ** Script-thread reads and writes run on the worker through Invoke(), so a
+    ** call costs one thread hop rather than a device and session
+    ** enumeration. Peaks are not evented; reads query the meters live.
+    */
+    class AudioSessionRegistry
     {
-        sessions.clear();
-        ComInit com;
-        if (!com.Ok())
-            return false;
+    public:
+        // 'onChange' runs on the thread that saw a change: a COM notification
+        // thread, the worker, or the script thread after Apply().
+        explicit AudioSessionRegistry(std::function<void()> onChange)
+            : m_OnChange(std::move(onChange))
+        {
+            m_Worker = std::thread([this]()
+                                   { WorkerThread(); });
+        }
 
-        IMMDeviceEnumerator *deviceEnum = nullptr;
-        IMMDevice *device = nullptr;
-        IAudioSessionManager2 *manager2 = nullptr;
-        IAudioSessionEnumerator *sessionEnum = nullptr;
-        bool success = false;
+        ~AudioSessionRegistry()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Stop = true;
+            }
+            m_Wake.notify_all();
+            if (m_Worker.joinable())
+                m_Worker.join();
+        }
 
-        do
+        AudioSessionRegistry(const AudioSessionRegistry &) = delete;
+        AudioSessionRegistry &operator=(const AudioSessionRegistry &) = delete;
+
+        // One entry per session.
+        std::vector<AppVolumeSessionInfo> GetSessions(bool includeInactive)
         {
-            HRESULT hr = CoCreateInstance(__uuidof(MMDeviceEnumerator), nullptr, CLSCTX_ALL, __uuidof(IMMDeviceEnumerator), (void **)&deviceEnum);
-            if (FAILED(hr) || !deviceEnum)
-                break;
+            std::vector<AppVolumeSessionInfo> out;
+            Invoke([&]()
+                   {
+                       std::lock_guard<std::mutex> lock(m_Mutex);
+                       for (const auto &kv : m_Processes)
+                       {
+                           for (uint64_t id : kv.second.sessions)
+                           {
+                               const Session &s = m_Sessions.at(id);
+                               if (includeInactive || s.state == AudioSessionStateActive)
+                                   out.push_back(Describe(kv.second, s));
+                           }
+                       }
+                   });
+            SortByPid(out);
+            return out;
+        }
 
-            hr = deviceEnum->GetDefaultAudioEndpoint(eRender, eMultimedia, &device);
-            if (FAILED(hr) || !device)
-                break;
+        // One entry per process: mean volume, muted if any session is, and
+        // the loudest peak.
+        std::vector<AppVolumeSessionInfo> GetProcesses(bool includeInactive)
+        {
+            std::vector<AppVolumeSessionInfo> out;
+            Invoke([&]()
+                   {
+                       std::lock_guard<std::mutex> lock(m_Mutex);
+                       for (const auto &kv : m_Processes)
+                       {
+                           AppVolumeSessionInfo merged;
+                           double volumeSum = 0.0;
+                           int count = 0;
+                           for (uint64_t id : kv.second.sessions)
+                           {
+                               const Session &s = m_Sessions.at(id);
+                               if (!includeInactive && s.state != AudioSessionStateActive)
+                                   continue;
+                               const AppVolumeSessionInfo info = Describe(kv.second, s);
+                               if (count == 0)
+                                   merged = info;
+                               volumeSum += info.volume;
+                               merged.muted = merged.muted || info.muted;
+                               merged.active = merged.active || info.active;
+                               merged.peak = std::max(merged.peak, info.peak);
+                               if (merged.displayName.empty())
+                                   merged.displayName = info.displayName;
+                               ++count;
+                           }
+                           if (count == 0)
+                               continue;
+                           merged.volume = static_cast<float>(volumeSum / count);
+                           merged.sessionCount = count;
+                           out.push_back(merged);
+                       }
+                   });
+            SortByPid(out);
+            return out;
+        }
 
-            hr = device->Activate(__uuidof(IAudioSessionManager2), CLSCTX_ALL, nullptr, (void **)&manager2);
-            if (FAILED(hr) || !manager2)
-                break;
+        // Set volume and/or mute on every session of the process given by
+        // pid, or by file name when 'processName' is set. False if none.
+        bool Apply(uint32_t pid, const std::wstring *processName, const float *volume, const bool *mute)
+        {
+            bool anySet = false;
+            Invoke([&]()
+                   {
+                       const std::wstring target = processName ? ToLowerCopy(*processName) : std::wstring();
+                       std::vector<ISimpleAudioVolume *> controls;
+                       {
+                           std::lock_guard<std::mutex> lock(m_Mutex);
+                           for (const auto &kv : m_Processes)
+                           {
+                               const bool match = processName ? (ToLowerCopy(kv.second.fileName) == target) : (kv.first == pid);
+                               if (!match)
+                                   continue;
+                               for (uint64_t id : kv.second.sessions)
+                               {
+                                   Session &s = m_Sessions.at(id);
+                                   if (!s.volumeControl)
+                                       continue;
+                                   // Update the table now; the volume event
+                                   // that follows confirms it.
+                                   if (volume)
+                                       s.volume = *volume;
+                                   if (mute)
+                                       s.muted = *mute;
+                                   s.volumeControl->AddRef();
+                                   controls.push_back(s.volumeControl);
+                               }
+                           }
+                       }
+
+                       for (ISimpleAudioVolume *control : controls)
+                       {
+                           if (volume)
+                               control->SetMasterVolume(*volume, nullptr);
+                           if (mute)
+                               control->SetMute(*mute ? TRUE : FALSE, nullptr);
+                           control->Release();
+                       }
+                       anySet = !controls.empty();
+                   });
+            if (anySet)
+                NotifyChanged();
+            return anySet;
+        }
 
-            hr = manager2->GetSessionEnumerator(&sessionEnum);
-            if (FAILED(hr) || !sessionEnum)
-                break;
+        // COM notification threads
 
-            int count = 0;
-            hr = sessionEnum->GetCount(&count);
-            if (FAILED(hr))
-                break;
+        void OnSessionCreated(IAudioSessionControl *control)
+        {
+            control->AddRef();
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Created.push_back(control);
+            }
+            m_Wake.notify_one();
+        }
 
-            for (int i = 0; i < count; ++i)
+        void OnSessionVolume(uint64_t id, float volume, bool muted)
+        {
+            if (UpdateSession(id, [&](Session &s)
+                              {
+                                  if (s.volume == volume && s.muted == muted)
+                                      return false;
+                                  s.volume = volume;
+                                  s.muted = muted;
+                                  return true; }))
+                NotifyChanged();
+        }
+
+        void OnSessionState(uint64_t id, AudioSessionState state)
+        {
+            if (state == AudioSessionStateExpired)
             {
-                IAudioSessionControl *control = nullptr;
-                IAudioSessionControl2 *control2 = nullptr;
-                ISimpleAudioVolume *simpleVol = nullptr;
-                IAudioMeterInformation *meter = nullptr;
+                OnSessionGone(id);
+                return;
+            }
+            if (UpdateSession(id, [&](Session &s)
+                              {
+                                  if (s.state == state)
+                                      return false;
+                                  s.state = state;
+                                  return true; }))
+                NotifyChanged();
+        }
 
-                if (FAILED(sessionEnum->GetSession(i, &control)) || !control)
-                    continue;
-                if (FAILED(control->QueryInterface(__uuidof(IAudioSessionControl2), (void **)&control2)) || !control2)
+        void OnSessionDisplayName(uint64_t id, const wchar_t *name)
+        {
+            const std::wstring displayName = name ? name : L"";
+            if (UpdateSession(id, [&](Session &s)
+                              {
+                                  if (s.displayName == displayName)
+                                      return false;
+                                  s.displayName = displayName;
+                                  return true; }))
+                NotifyChanged();
+        }
+
+        // Expired or disconnected; the worker unregisters and drops it.
+        void OnSessionGone(uint64_t id)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                auto it = m_Sessions.find(id);
+                if (it == m_Sessions.end() || it->second.gone)
+                    return;
+                it->second.gone = true;
+                m_Prune = true;
+            }
+            m_Wake.notify_one();
+        }
+
+        void OnDefaultDeviceChanged()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Rebuild = true;
+            }
+            m_Wake.notify_one();
+        }
+
+    private:
+        struct Session
+        {
+            uint32_t pid = 0;
+            std::wstring instanceId;
+            IAudioSessionControl2 *control = nullptr;
+            ISimpleAudioVolume *volumeControl = nullptr;
+            IAudioMeterInformation *meter = nullptr;
+            SessionEvents *events = nullptr;
+            std::wstring displayName;
+            float volume = 0.0f;
+            bool muted = false;
+            AudioSessionState state = AudioSessionStateInactive;
+            bool gone = false;
+        };
+
+        struct Process
+        {
+            std::wstring filePath;
+            std::wstring fileName;
+            std::wstring iconPath;
+            std::vector<uint64_t> sessions;
+        };
+
+        std::function<void()> m_OnChange;
+        std::thread m_Worker;
+
+        // Guards the table and the worker's inbox.
+        std::mutex m_Mutex;
+        std::condition_variable m_Wake;
+        std::deque<std::function<void()>> m_Commands;
+        std::vector<IAudioSessionControl *> m_Created;
+        bool m_Stop = false;
+        bool m_Prune = false;
+        bool m_Rebuild = false;
+
+        std::unordered_map<uint64_t, Session> m_Sessions;
+        std::unordered_map<uint32_t, Process> m_Processes;
+        uint64_t m_NextId = 1;
+
+        // Worker thread only
+        IMMDeviceEnumerator *m_Enumerator = nullptr;
+        IAudioSessionManager2 *m_Manager = nullptr;
+        RegistryNotifications *m_Notifications = nullptr;
+
+        static void SortByPid(std::vector<AppVolumeSessionInfo> &list)
+        {
+            std::stable_sort(list.begin(), list.end(), [](const AppVolumeSessionInfo &a, const AppVolumeSessionInfo &b)
+                             { return a.pid < b.pid; });
+        }
+
+        // Runs 'fn' on the worker thread and waits for it.
+        void Invoke(const std::function<void()> &fn)
+        {
+            std::packaged_task<void()> task(fn);
+            std::future<void> done = task.get_future();
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Commands.push_back([&task]()
+                                     { task(); });
+            }
+            m_Wake.notify_one();
+            done.wait();
+        }
+
+        void NotifyChanged()
+        {
+            if (m_OnChange)
+                m_OnChange();
+        }
+
+        template <typename F>
+        bool UpdateSession(uint64_t id, F update)
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            auto it = m_Sessions.find(id);
+            return it != m_Sessions.end() && !it->second.gone && update(it->second);
+        }
+
+        // Caller holds m_Mutex.
+        AppVolumeSessionInfo Describe(const Process &process, const Session &s) const
+        {
+            AppVolumeSessionInfo info;
+            info.pid = s.pid;
+            info.filePath = process.filePath;
+            info.fileName = process.fileName;
+            info.processName = process.fileName;
+            info.iconPath = process.iconPath;
+            info.displayName = s.displayName;
+            info.volume = s.volume;
+            info.muted = s.muted;
+            info.active = s.state == AudioSessionStateActive;
+            float peak = 0.0f;
+            if (s.meter && SUCCEEDED(s.meter->GetPeakValue(&peak)))
+                info.peak = peak;
+            return info;
+        }
+
+        void WorkerThread()
+        {
+            const HRESULT hrCom = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+            m_Notifications = new RegistryNotifications(this);
+            if (SUCCEEDED(hrCom) &&
+                SUCCEEDED(CoCreateInstance(__uuidof(MMDeviceEnumerator), nullptr, CLSCTX_ALL, __uuidof(IMMDeviceEnumerator), reinterpret_cast<void **>(&m_Enumerator))))
+            {
+                m_Enumerator->RegisterEndpointNotificationCallback(m_Notifications);
+                Attach();
+            }
+
+            while (true)
+            {
+                std::deque<std::function<void()>> commands;
+                std::vector<IAudioSessionControl *> created;
+                bool prune = false;
+                bool rebuild = false;
                 {
-                    control->Release();
-                    continue;
+                    std::unique_lock<std::mutex> lock(m_Mutex);
+                    m_Wake.wait(lock, [this]()
+                                { return m_Stop || !m_Commands.empty() || !m_Created.empty() || m_Prune || m_Rebuild; });
+                    if (m_Stop)
+                        break;
+                    std::swap(commands, m_Commands);
+                    std::swap(created, m_Created);
+                    std::swap(prune, m_Prune);
+                    std::swap(rebuild, m_Rebuild);
+                }
+
+                if (rebuild)
+                {
+                    // Sessions created on the old endpoint are re-enumerated.
+                    for (IAudioSessionControl *control : created)
+                        control->Release();
+                    created.clear();
+                    Detach();
+                    Attach();
                 }
-                if (FAILED(control->QueryInterface(__uuidof(ISimpleAudioVolume), (void **)&simpleVol)) || !simpleVol)
+                for (IAudioSessionControl *control : created)
                 {
-                    control2->Release();
+                    AddSession(control);
                     control->Release();
-                    continue;
                 }
+                if (prune)
+                    PruneSessions();
+                if (rebuild || prune || !created.empty())
+                    NotifyChanged();
+
+                for (auto &command : commands)
+                    command();
+            }
+
+            for (IAudioSessionControl *control : m_Created)
+                control->Release();
+            m_Created.clear();
+            Detach();
+            if (m_Enumerator)
+                m_Enumerator->UnregisterEndpointNotificationCallback(m_Notifications);
+            SafeRelease(m_Enumerator);
+            SafeRelease(m_Notifications);
+            if (SUCCEEDED(hrCom))
+                CoUninitialize();
+        }
 
-                AudioSessionState state{};
-                if (FAILED(control->GetState(&state)) || state != AudioSessionStateActive)
+        void Attach()
+        {
+            if (!m_Enumerator)
+                return;
+
+            IMMDevice *device = nullptr;
+            if (FAILED(m_Enumerator->GetDefaultAudioEndpoint(eRender, eMultimedia, &device)) || !device)
+                return;
+            device->Activate(__uuidof(IAudioSessionManager2), CLSCTX_ALL, nullptr, reinterpret_cast<void **>(&m_Manager));
+            device->Release();
+            if (!m_Manager)
+                return;
+
+            // The manager only starts sending notifications once a session
+            // enumerator has been created.
+            IAudioSessionEnumerator *sessionEnum = nullptr;
+            if (FAILED(m_Manager->GetSessionEnumerator(&sessionEnum)) || !sessionEnum)
+                return;
+            m_Manager->RegisterSessionNotification(m_Notifications);
+
+            int count = 0;
+            sessionEnum->GetCount(&count);
+            for (int i = 0; i < count; ++i)
+            {
+                IAudioSessionControl *control = nullptr;
+                if (SUCCEEDED(sessionEnum->GetSession(i, &control)) && control)
                 {
-                    simpleVol->Release();
-                    control2->Release();
+                    AddSession(control);
                     control->Release();
-                    continue;
                 }
+            }
+            sessionEnum->Release();
+        }
 
-                DWORD pid = 0;
-                control2->GetProcessId(&pid);
+        void Detach()
+        {
+            std::vector<uint64_t> ids;
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                for (const auto &kv : m_Sessions)
+                    ids.push_back(kv.first);
+            }
+            for (uint64_t id : ids)
+                RemoveSession(id);
+
+            if (m_Manager)
+                m_Manager->UnregisterSessionNotification(m_Notifications);
+            SafeRelease(m_Manager);
+        }
 
-                float volume = 0.0f;
-                float peak = 0.0f;
+        void AddSession(IAudioSessionControl *control)
+        {
+            Session s;
+            if (FAILED(control->QueryInterface(__uuidof(IAudioSessionControl2), reinterpret_cast<void **>(&s.control))) || !s.control)
+                return;
+
+            LPWSTR instanceId = nullptr;
+            if (SUCCEEDED(s.control->GetSessionInstanceIdentifier(&instanceId)) && instanceId)
+            {
+                s.instanceId = instanceId;
+                CoTaskMemFree(instanceId);
+            }
+
+            DWORD pid = 0;
+            s.control->GetProcessId(&pid);
+            s.pid = static_cast<uint32_t>(pid);
+            s.control->GetState(&s.state);
+            if (s.state == AudioSessionStateExpired)
+            {
+                SafeRelease(s.control);
+                return;
+            }
+
+            LPWSTR displayName = nullptr;
+            if (SUCCEEDED(s.control->GetDisplayName(&displayName)) && displayName)
+            {
+                s.displayName = displayName;
+                CoTaskMemFree(displayName);
+            }
+
+            if (SUCCEEDED(s.control->QueryInterface(__uuidof(ISimpleAudioVolume), reinterpret_cast<void **>(&s.volumeControl))) && s.volumeControl)
+            {
                 BOOL muted = FALSE;
-                simpleVol->GetMasterVolume(&volume);
-                simpleVol->GetMute(&muted);
-                if (SUCCEEDED(control2->QueryInterface(IID_IAudioMeterInformation_Local, (void **)&meter)) && meter)
+                s.volumeControl->GetMasterVolume(&s.volume);
+                s.volumeControl->GetMute(&muted);
+                s.muted = muted != FALSE;
+            }
+            s.control->QueryInterface(IID_IAudioMeterInformation_Local, reinterpret_cast<void **>(&s.meter));
+
+            bool knownProcess = false;
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                for (const auto &kv : m_Sessions)
                 {
-                    float meterPeak = 0.0f;
-                    if (SUCCEEDED(meter->GetPeakValue(&meterPeak)))
+                    // Created while the initial enumeration was running.
+                    if (!s.instanceId.empty() && kv.second.instanceId == s.instanceId)
                     {
-                        peak = meterPeak;
+                        SafeRelease(s.meter);
+                        SafeRelease(s.volumeControl);
+                        SafeRelease(s.control);
+                        return;
                     }
                 }
+                knownProcess = m_Processes.count(s.pid) != 0;
+            }
 
-                LPWSTR displayName = nullptr;
-                std::wstring display;
-                if (SUCCEEDED(control->GetDisplayName(&displayName)) && displayName)
+            Process process;
+            if (!knownProcess)
+            {
+                process.filePath = GetProcessPathByPid(pid);
+                process.fileName = FileNameFromPath(process.filePath);
+                process.iconPath = ResolveIconPath(process.filePath);
+            }
+
+            uint64_t id = 0;
+            IAudioSessionControl2 *sessionControl = s.control;
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                id = m_NextId++;
+                auto pit = m_Processes.find(s.pid);
+                if (pit == m_Processes.end())
+                    pit = m_Processes.emplace(s.pid, std::move(process)).first;
+                pit->second.sessions.push_back(id);
+                m_Sessions.emplace(id, std::move(s));
+            }
+
+            // Registered after the insert so no event is dropped for an
+            // unknown id.
+            auto *events = new SessionEvents(this, id);
+            if (SUCCEEDED(sessionControl->RegisterAudioSessionNotification(events)))
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Sessions.at(id).events = events;
+            }
+            else
+            {
+                events->Release();
+            }
+        }
+
+        void RemoveSession(uint64_t id)
+        {
+            Session s;
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                auto it = m_Sessions.find(id);
+                if (it == m_Sessions.end())
+                    return;
+                s = std::move(it->second);
+                m_Sessions.erase(it);
+
+                auto pit = m_Processes.find(s.pid);
+                if (pit != m_Processes.end())
                 {
-                    display = displayName;
-                    CoTaskMemFree(displayName);
+                    auto &ids = pit->second.sessions;
+                    ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+                    if (ids.empty())
+                        m_Processes.erase(pit);
                 }
+            }
 
-                AppVolumeSessionInfo info;
-                info.pid = static_cast<uint32_t>(pid);
-                info.filePath = GetProcessPathByPid(pid);
-                info.fileName = FileNameFromPath(info.filePath);
-                info.processName = info.fileName;
-                info.iconPath = ResolveIconPath(info.filePath);
-                info.displayName = display;
-                info.volume = volume;
-                info.peak = peak;
-                info.muted = muted != FALSE;
-
-                sessions.push_back(info);
+            if (s.events)
+            {
+                s.control->UnregisterAudioSessionNotification(s.events);
+                SafeRelease(s.events);
+            }
+            SafeRelease(s.meter);
+            SafeRelease(s.volumeControl);
+            SafeRelease(s.control);
+        }
 
-                if (meter)
-                    meter->Release();
-                simpleVol->Release();
-                control2->Release();
-                control->Release();
+        void PruneSessions()
+        {
+            std::vector<uint64_t> gone;
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                for (const auto &kv : m_Sessions)
+                {
+                    if (kv.second.gone)
+                        gone.push_back(kv.first);
+                }
             }
+            for (uint64_t id : gone)
+                RemoveSession(id);
+        }
+    };
 
-            success = true;
-        } while (false);
+    HRESULT SessionEvents::OnDisplayNameChanged(LPCWSTR newDisplayName, LPCGUID)
+    {
+        m_Owner->OnSessionDisplayName(m_Id, newDisplayName);
+        return S_OK;
+    }
 
-        if (sessionEnum)
-            sessionEnum->Release();
-        if (manager2)
-            manager2->Release();
-        if (device)
-            device->Release();
-        if (deviceEnum)
-            deviceEnum->Release();
-        return success;
+    HRESULT SessionEvents::OnSimpleVolumeChanged(float newVolume, BOOL newMute, LPCGUID)
+    {
+        m_Owner->OnSessionVolume(m_Id, newVolume, newMute != FALSE);
+        return S_OK;
     }
 
-    bool AppVolumeGetByPid(uint32_t pid, float &outVolume, bool &outMuted, float &outPeak)
+    HRESULT SessionEvents::OnStateChanged(AudioSessionState newState)
     {
-        std::vector<AppVolumeSessionInfo> sessions;
-        if (!AppVolumeListSessions(sessions))
-            return false;
+        m_Owner->OnSessionState(m_Id, newState);
+        return S_OK;
+    }
 
-        double sum = 0.0;
-        int count = 0;
-        bool mutedAny = false;
-        double peakMax = 0.0;
-        for (const auto &s : sessions)
+    HRESULT SessionEvents::OnSessionDisconnected(AudioSessionDisconnectReason reason)
+    {
+        m_Owner->OnSessionGone(m_Id);
+        if (reason == DisconnectReasonDeviceRemoval || reason == DisconnectReasonFormatChanged)
+            m_Owner->OnDefaultDeviceChanged();
+        return S_OK;
+    }
+
+    HRESULT RegistryNotifications::OnSessionCreated(IAudioSessionControl *newSession)
+    {
+        if (newSession)
+            m_Owner->OnSessionCreated(newSession);
+        return S_OK;
+    }
+
+    HRESULT RegistryNotifications::OnDefaultDeviceChanged(EDataFlow flow, ERole role, LPCWSTR)
+    {
+        if (flow == eRender && role == eMultimedia)
+            m_Owner->OnDefaultDeviceChanged();
+        return S_OK;
+    }
+
+    std::unique_ptr<AudioSessionRegistry> g_Registry;
+    std::atomic<void *> g_OnChange{nullptr};
+    std::atomic<bool> g_ChangePosted{false};
+
+    void DispatchChange(void *)
+    {
+        g_ChangePosted.store(false, std::memory_order_release);
+        if (void *fn = g_OnChange.load(std::memory_order_acquire))
+            g_Host->JsCallFunctionNoArgs(nullptr, fn);
+    }
+
+    // Registry change callback. Bursts of session events reach script as a
+    // single onChange call.
+    void PostChange()
+    {
+        if (g_OnChange.load(std::memory_order_acquire) && !g_ChangePosted.exchange(true, std::memory_order_acq_rel))
+            novadesk::Dispatcher(g_MessageWindow).Dispatch(&DispatchChange);
+    }
+
+    AudioSessionRegistry &GetRegistry()
+    {
+        if (!g_Registry)
         {
-            if (s.pid == pid)
-            {
-                sum += s.volume;
-                mutedAny = mutedAny || s.muted;
-                if (s.peak > peakMax)
-                    peakMax = s.peak;
-                ++count;
-            }
+            g_Registry = std::make_unique<AudioSessionRegistry>(&PostChange);
         }
-        if (count == 0)
-            return false;
+        return *g_Registry;
+    }
 
-        outVolume = static_cast<float>(sum / static_cast<double>(count));
-        outMuted = mutedAny;
-        outPeak = static_cast<float>(peakMax);
+    bool AppVolumeListSessions(std::vector<AppVolumeSessionInfo> &sessions)
+    {
+        sessions = GetRegistry().GetSessions(false);
         return true;
     }
 
-    bool AppVolumeGetByProcessName(const std::wstring &processName, float &outVolume, bool &outMuted, float &outPeak)
+    bool AppVolumeGetByPid(uint32_t pid, float &outVolume, bool &outMuted, float &outPeak)
     {
-        std::vector<AppVolumeSessionInfo> sessions;
-        if (!AppVolumeListSessions(sessions))
-            return false;
+        for (const auto &p : GetRegistry().GetProcesses(false))
+        {
+            if (p.pid == pid)
+            {
+                outVolume = p.volume;
+                outMuted = p.muted;
+                outPeak = p.peak;
+                return true;
+            }
+        }
+        return false;
+    }
 
-        std::wstring target = ToLowerCopy(processName);
+    bool AppVolumeGetByProcessName(const std::wstring &processName, float &outVolume, bool &outMuted, float &outPeak)
+    {
+        // Several processes can share a file name; average their sessions.
+        std::vector<AppVolumeSessionInfo> sessions = GetRegistry().GetSessions(false);
+        const std::wstring target = ToLowerCopy(processName);
         double sum = 0.0;
         int count = 0;
         bool mutedAny = false;
@@ -664,7 +1172,7 @@ namespace
             volume01 = 0.0f;
         if (volume01 > 1.0f)
             volume01 = 1.0f;
-        return SetForMatchingSessions(static_cast<DWORD>(pid), L"", true, &volume01, nullptr);
+        return GetRegistry().Apply(pid, nullptr, &volume01, nullptr);
     }
 
     bool AppVolumeSetVolumeByProcessName(const std::wstring &processName, float volume01)
@@ -673,17 +1181,17 @@ namespace
             volume01 = 0.0f;
         if (volume01 > 1.0f)
             volume01 = 1.0f;
-        return SetForMatchingSessions(0, processName, false, &volume01, nullptr);
+        return GetRegistry().Apply(0, &processName, &volume01, nullptr);
     }
 
     bool AppVolumeSetMuteByPid(uint32_t pid, bool mute)
     {
-        return SetForMatchingSessions(static_cast<DWORD>(pid), L"", true, nullptr, &mute);
+        return GetRegistry().Apply(pid, nullptr, nullptr, &mute);
     }
 
     bool AppVolumeSetMuteByProcessName(const std::wstring &processName, bool mute)
     {
-        return SetForMatchingSessions(0, processName, false, nullptr, &mute);
+        return GetRegistry().Apply(0, &processName, nullptr, &mute);
     }
 
     void RegisterSessionProps(novadesk_context ctx, const AppVolumeSessionInfo &s)
@@ -703,6 +1211,7 @@ namespace
         g_Host->RegisterNumber(ctx, "volume", static_cast<double>(s.volume));
         g_Host->RegisterNumber(ctx, "peak", static_cast<double>(s.peak));
         g_Host->RegisterBool(ctx, "muted", s.muted ? 1 : 0);
+        g_Host->RegisterBool(ctx, "active", s.active ? 1 : 0);
     }
 
     int JsAppVolumeListSessions(novadesk_context ctx)
@@ -724,6 +1233,35 @@ namespace
         return 1;
     }
 
+    int JsAppVolumeGetAll(novadesk_context ctx)
+    {
+        const std::vector<AppVolumeSessionInfo> processes = GetRegistry().GetProcesses(true);
+        g_Host->PushArray(ctx);
+        for (const auto &p : processes)
+        {
+            g_Host->ArrayPushObject(ctx);
+            RegisterSessionProps(ctx, p);
+            g_Host->RegisterNumber(ctx, "sessions", static_cast<double>(p.sessionCount));
+            g_Host->Pop(ctx);
+        }
+        return 1;
+    }
+
+    int JsAppVolumeOnChange(novadesk_context ctx)
+    {
+        if (g_Host->GetTop(ctx) < 1 || (!g_Host->IsFunction(ctx, 0) && !g_Host->IsNull(ctx, 0)))
+        {
+            g_Host->ThrowError(ctx, "appVolume.onChange(callback) requires a function or null");
+            return 0;
+        }
+        void *fn = g_Host->IsFunction(ctx, 0) ? g_Host->JsGetFunctionPtr(ctx, 0) : nullptr;
+        g_OnChange.store(fn, std::memory_order_release);
+        if (fn)
+            GetRegistry();
+        g_Host->PushBool(ctx, 1);
+        return 1;
+    }
+
     int JsAppVolumeGetByPid(novadesk_context ctx)
     {
         if (!g_Host->IsNumber(ctx, 0))
@@ -825,14 +1363,16 @@ namespace
 
 NOVADESK_ADDON_INIT(ctx, hMsgWnd, host)
 {
-    (void)hMsgWnd;
     g_Host = host;
+    g_MessageWindow = hMsgWnd;
 
     novadesk::Addon addon(ctx, host);
     addon.RegisterString("name", "AppVolume");
-    addon.RegisterString("version", "1.0.0");
+    addon.RegisterString("version", "1.1.0");
 
     addon.RegisterFunction("listSessions", JsAppVolumeListSessions, 0);
+    addon.RegisterFunction("getAll", JsAppVolumeGetAll, 0);
+    addon.RegisterFunction("onChange", JsAppVolumeOnChange, 1);
     addon.RegisterFunction("getByPid", JsAppVolumeGetByPid, 1);
     addon.RegisterFunction("getByProcessName", JsAppVolumeGetByProcessName, 1);
     addon.RegisterFunction("setVolumeByPid", JsAppVolumeSetVolumeByPid, 2);
@@ -843,4 +1383,6 @@ NOVADESK_ADDON_INIT(ctx, hMsgWnd, host)
 
 NOVADESK_ADDON_UNLOAD()
 {
+    g_OnChange.store(nullptr, std::memory_order_release);
+    g_Registry.reset();
 }
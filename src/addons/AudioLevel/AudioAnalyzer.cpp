@@ -0,0 +1,495 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "AudioAnalyzer.h"
+#include "AudioDsp.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    // Below this a meter or bin counts as silent for IsSettled().
+    const float kSettledLevel = 1.0e-4f;
+
+    float Clamp01(float v)
+    {
+        if (v < 0.0f)
+            return 0.0f;
+        if (v > 1.0f)
+            return 1.0f;
+        return v;
+    }
+
+    int NormalizeFFTSize(int n)
+    {
+        if (n < 2)
+            n = 1024;
+        if (n % 2 != 0)
+            ++n;
+        return n;
+    }
+
+    int ClampMs(int ms) { return (ms <= 0) ? 1 : ms; }
+
+    std::vector<float> HannWindow(int size)
+    {
+        std::vector<float> window(static_cast<size_t>(size));
+        for (int i = 0; i < size; ++i)
+        {
+            window[static_cast<size_t>(i)] = 0.5f * (1.0f - std::cos(2.0f * 3.1415926535f * i / static_cast<float>(size - 1)));
+        }
+        return window;
+    }
+
+    // Perceptual scales for the filter-bank modes; Traunmueller's bark.
+    double HzToMel(double f) { return 2595.0 * std::log10(1.0 + f / 700.0); }
+    double MelToHz(double m) { return 700.0 * (std::pow(10.0, m / 2595.0) - 1.0); }
+    double HzToBark(double f) { return 26.81 * f / (1960.0 + f) - 0.53; }
+    double BarkToHz(double z) { return 1960.0 * (z + 0.53) / (26.28 - z); }
+
+    // Per-update coefficient that leaves e^-2 (~14%) of a step after 'ms'
+    // at 'rate' updates per second.
+    float CalcSmoothCoeff(double rate, int ms)
+    {
+        const double t = static_cast<double>(ClampMs(ms)) * 0.001;
+        return static_cast<float>(std::exp(std::log10(0.01) / (rate * t)));
+    }
+}
+
+bool AudioAnalyzerConfig::operator==(const AudioAnalyzerConfig &c) const
+{
+    return mode == c.mode &&
+           fftSize == c.fftSize &&
+           fftOverlap == c.fftOverlap &&
+           bands == c.bands &&
+           freqMin == c.freqMin &&
+           freqMax == c.freqMax &&
+           sensitivity == c.sensitivity &&
+           rmsAttack == c.rmsAttack &&
+           rmsDecay == c.rmsDecay &&
+           peakAttack == c.peakAttack &&
+           peakDecay == c.peakDecay &&
+           fftAttack == c.fftAttack &&
+           fftDecay == c.fftDecay &&
+           rmsGain == c.rmsGain &&
+           peakGain == c.peakGain &&
+           waveformPoints == c.waveformPoints &&
+           waveformDuration == c.waveformDuration;
+}
+
+AudioAnalyzer::~AudioAnalyzer()
+{
+    Release();
+}
+
+void AudioAnalyzer::Release()
+{
+    for (FFTStage &stage : m_Stages)
+    {
+        if (stage.cfg)
+            free(stage.cfg);
+    }
+    m_Stages.clear();
+}
+
+bool AudioAnalyzer::Configure(const AudioAnalyzerConfig &config, int sampleRate)
+{
+    Release();
+    m_Config = config;
+    m_SampleRate = sampleRate > 0 ? sampleRate : 48000;
+    m_Bands.clear();
+    m_FilterWeights.clear();
+    m_Columns.clear();
+
+    const double sampleRateD = static_cast<double>(m_SampleRate);
+    m_KRMS[0] = CalcSmoothCoeff(sampleRateD, m_Config.rmsAttack);
+    m_KRMS[1] = CalcSmoothCoeff(sampleRateD, m_Config.rmsDecay);
+    m_KPeak[0] = CalcSmoothCoeff(sampleRateD, m_Config.peakAttack);
+    m_KPeak[1] = CalcSmoothCoeff(sampleRateD, m_Config.peakDecay);
+    m_RMS[0] = m_RMS[1] = 0.0f;
+    m_Peak[0] = m_Peak[1] = 0.0f;
+
+    m_Left.resize(kChunkFrames);
+    m_Right.resize(kChunkFrames);
+    m_Mono.resize(kChunkFrames);
+
+    const double sensitivity = (m_Config.sensitivity <= 0.0) ? 35.0 : m_Config.sensitivity;
+    m_InvSensitivity = static_cast<float>(1.0 / sensitivity);
+
+    if (m_Config.mode == AudioAnalysisMode::Waveform)
+    {
+        const int points = m_Config.waveformPoints > 0 ? m_Config.waveformPoints : 256;
+        const double span = sampleRateD * ClampMs(m_Config.waveformDuration) * 0.001;
+        m_ColumnSamples = static_cast<size_t>((std::max)(1.0, std::floor(span / points + 0.5)));
+        m_Columns.assign(static_cast<size_t>(points) * 2, 0.0f);
+        m_ColumnWrite = 0;
+        m_ColumnFill = 0;
+        m_History.clear();
+        return true;
+    }
+
+    const int fftSize = NormalizeFFTSize(m_Config.fftSize);
+    int overlap = m_Config.fftOverlap;
+    if (overlap < 0 || overlap >= fftSize)
+        overlap = fftSize / 2;
+    int stride = fftSize - overlap;
+    if (stride <= 0)
+        stride = fftSize / 2;
+
+    if (!AddStage(fftSize, stride))
+        return false;
+    if (m_Config.mode == AudioAnalysisMode::Mel || m_Config.mode == AudioAnalysisMode::Bark)
+        BuildFilterBank();
+    else
+        BuildBandRanges();
+    for (const FFTStage &stage : m_Stages)
+    {
+        if (!stage.cfg)
+            return false;
+    }
+
+    int largest = 0;
+    for (const FFTStage &stage : m_Stages)
+        largest = (std::max)(largest, stage.size);
+    m_History.assign(static_cast<size_t>(largest) * 2, 0.0f);
+    m_HistoryLength = 0;
+    m_HistoryFilled = 0;
+    return true;
+}
+
+bool AudioAnalyzer::AddStage(int size, int stride)
+{
+    FFTStage stage;
+    stage.size = size;
+    stage.stride = stride;
+    stage.countdown = stride;
+    stage.cfg = kiss_fftr_alloc(size, 0, nullptr, nullptr);
+    stage.window = HannWindow(size);
+    stage.in.resize(static_cast<size_t>(size));
+    stage.out.resize(static_cast<size_t>(size / 2 + 1));
+    stage.spectrum.assign(static_cast<size_t>(size / 2 + 1), 0.0f);
+
+    const double fftRate = static_cast<double>(m_SampleRate) / static_cast<double>(stride);
+    stage.k[0] = CalcSmoothCoeff(fftRate, m_Config.fftAttack);
+    stage.k[1] = CalcSmoothCoeff(fftRate, m_Config.fftDecay);
+
+    const bool ok = stage.cfg != nullptr;
+    m_Stages.push_back(std::move(stage));
+    return ok;
+}
+
+void AudioAnalyzer::BuildBandRanges()
+{
+    // Log-spaced band edges as bin ranges; GetStats() only takes maxima.
+    const int bands = m_Config.bands > 0 ? m_Config.bands : 0;
+    const double freqMin = m_Config.freqMin <= 0.0 ? 20.0 : m_Config.freqMin;
+    const double freqMax = (m_Config.freqMax <= freqMin) ? 20000.0 : m_Config.freqMax;
+    const double sampleRate = static_cast<double>(m_SampleRate);
+    const int baseSize = m_Stages[0].size;
+    const int baseStride = m_Stages[0].stride;
+
+    m_Bands.resize(static_cast<size_t>(bands));
+    for (int i = 0; i < bands; ++i)
+    {
+        const double f1 = freqMin * std::pow(freqMax / freqMin, static_cast<double>(i) / static_cast<double>(bands));
+        const double f2 = freqMin * std::pow(freqMax / freqMin, static_cast<double>(i + 1) / static_cast<double>(bands));
+        BandSource &band = m_Bands[static_cast<size_t>(i)];
+
+        if (m_Config.mode != AudioAnalysisMode::ConstantQ)
+        {
+            const int bins = baseSize / 2 + 1;
+            int idx1 = static_cast<int>(f1 * 2.0 * bins / sampleRate);
+            int idx2 = static_cast<int>(f2 * 2.0 * bins / sampleRate);
+            if (idx1 < 0)
+                idx1 = 0;
+            if (idx1 >= bins)
+                idx1 = bins - 1;
+            if (idx2 >= bins)
+                idx2 = bins - 1;
+            if (idx2 < idx1)
+                idx2 = idx1;
+            band.begin = idx1;
+            band.end = idx2 + 1;
+            continue;
+        }
+
+        // Constant-Q: the smallest multiple-of-two FFT that puts two bins
+        // across the band. Low octaves share the large sizes, and each size
+        // hops proportionally further so every stage costs about the same.
+        int size = baseSize;
+        const double needed = 2.0 * sampleRate / (f2 - f1);
+        while (size < needed && size * 2 <= kMaxConstantQSize)
+            size *= 2;
+
+        int stage = 0;
+        while (stage < static_cast<int>(m_Stages.size()) && m_Stages[static_cast<size_t>(stage)].size != size)
+            ++stage;
+        if (stage == static_cast<int>(m_Stages.size()))
+            AddStage(size, baseStride * (size / baseSize));
+
+        const int bins = size / 2 + 1;
+        const int begin = (std::min)(static_cast<int>(f1 * size / sampleRate), bins - 1);
+        const int end = (std::min)(static_cast<int>(f2 * size / sampleRate), bins);
+        band.stage = stage;
+        band.begin = begin;
+        band.end = (std::max)(end, begin + 1);
+    }
+}
+
+void AudioAnalyzer::BuildFilterBank()
+{
+    // Triangular filters whose edges are evenly spaced on the perceptual
+    // scale; each keeps only the bins it covers, weights summing to one.
+    const bool mel = m_Config.mode == AudioAnalysisMode::Mel;
+    auto toScale = [mel](double f) { return mel ? HzToMel(f) : HzToBark(f); };
+    auto fromScale = [mel](double v) { return mel ? MelToHz(v) : BarkToHz(v); };
+
+    const int bands = m_Config.bands > 0 ? m_Config.bands : 0;
+    const double freqMin = m_Config.freqMin <= 0.0 ? 20.0 : m_Config.freqMin;
+    const double nyquist = static_cast<double>(m_SampleRate) * 0.5;
+    double freqMax = (m_Config.freqMax <= freqMin) ? 20000.0 : m_Config.freqMax;
+    freqMax = (std::min)(freqMax, nyquist);
+
+    const int size = m_Stages[0].size;
+    const int bins = size / 2 + 1;
+    const double binHz = static_cast<double>(m_SampleRate) / size;
+
+    const double lo = toScale(freqMin);
+    const double hi = toScale((std::max)(freqMax, freqMin));
+    std::vector<double> edges(static_cast<size_t>(bands) + 2);
+    for (size_t j = 0; j < edges.size(); ++j)
+        edges[j] = fromScale(lo + (hi - lo) * static_cast<double>(j) / static_cast<double>(bands + 1));
+
+    m_Bands.resize(static_cast<size_t>(bands));
+    for (int i = 0; i < bands; ++i)
+    {
+        const double lower = edges[static_cast<size_t>(i)];
+        const double center = edges[static_cast<size_t>(i) + 1];
+        const double upper = edges[static_cast<size_t>(i) + 2];
+        BandSource &band = m_Bands[static_cast<size_t>(i)];
+        band.filtered = true;
+        band.weights = m_FilterWeights.size();
+
+        int begin = (std::max)(0, static_cast<int>(std::ceil(lower / binHz)));
+        int end = (std::min)(bins, static_cast<int>(std::floor(upper / binHz)) + 1);
+        double sum = 0.0;
+        for (int k = begin; k < end; ++k)
+        {
+            const double f = k * binHz;
+            const double w = f <= center ? (f - lower) / (center - lower) : (upper - f) / (upper - center);
+            m_FilterWeights.push_back(static_cast<float>((std::max)(0.0, w)));
+            sum += (std::max)(0.0, w);
+        }
+
+        if (sum <= 0.0)
+        {
+            // Narrower than a bin (low mel bands on a small FFT): read the
+            // bin nearest the centre.
+            m_FilterWeights.resize(band.weights);
+            begin = (std::min)(bins - 1, static_cast<int>(std::floor(center / binHz + 0.5)));
+            end = begin + 1;
+            m_FilterWeights.push_back(1.0f);
+            sum = 1.0;
+        }
+        for (size_t w = band.weights; w < m_FilterWeights.size(); ++w)
+            m_FilterWeights[w] = static_cast<float>(m_FilterWeights[w] / sum);
+        band.begin = begin;
+        band.end = end;
+    }
+}
+
+std::vector<int> AudioAnalyzer::GetFFTSizes() const
+{
+    std::vector<int> sizes;
+    for (const FFTStage &stage : m_Stages)
+        sizes.push_back(stage.size);
+    std::sort(sizes.begin(), sizes.end());
+    return sizes;
+}
+
+void AudioAnalyzer::Smooth(float &value, float now, const float coeff[2], size_t frameCount) const
+{
+    // The coefficients are per sample; a block of n samples moves the meter
+    // as far as n single-sample steps towards the block's level would.
+    const float k = std::pow(coeff[now < value], static_cast<float>(frameCount));
+    value = Clamp01(now + k * (value - now));
+}
+
+void AudioAnalyzer::Process(const float *frames, size_t frameCount)
+{
+    if (frameCount == 0)
+        return;
+
+    float sumSq[2] = {0.0f, 0.0f};
+    float peak[2] = {0.0f, 0.0f};
+    for (size_t done = 0; done < frameCount; done += kChunkFrames)
+    {
+        const size_t n = (std::min)(kChunkFrames, frameCount - done);
+        AudioDsp::Deinterleave(frames + done * 2, n, m_Left.data(), m_Right.data(), m_Mono.data());
+        AudioDsp::AccumulateLevel(m_Left.data(), n, sumSq[0], peak[0]);
+        AudioDsp::AccumulateLevel(m_Right.data(), n, sumSq[1], peak[1]);
+        if (m_Columns.empty())
+            AppendMono(m_Mono.data(), n);
+        else
+            AppendWaveform(m_Mono.data(), n);
+    }
+
+    const float n = static_cast<float>(frameCount);
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        Smooth(m_RMS[ch], std::sqrt(sumSq[ch] / n), m_KRMS, frameCount);
+        Smooth(m_Peak[ch], peak[ch], m_KPeak, frameCount);
+    }
+}
+
+void AudioAnalyzer::ProcessSilence(size_t frameCount)
+{
+    if (frameCount == 0)
+        return;
+
+    std::fill(m_Mono.begin(), m_Mono.end(), 0.0f);
+    for (size_t done = 0; done < frameCount; done += kChunkFrames)
+    {
+        const size_t n = (std::min)(kChunkFrames, frameCount - done);
+        if (m_Columns.empty())
+            AppendMono(m_Mono.data(), n);
+        else
+            AppendWaveform(m_Mono.data(), n);
+    }
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        Smooth(m_RMS[ch], 0.0f, m_KRMS, frameCount);
+        Smooth(m_Peak[ch], 0.0f, m_KPeak, frameCount);
+    }
+}
+
+bool AudioAnalyzer::IsSettled() const
+{
+    if (m_RMS[0] > kSettledLevel || m_RMS[1] > kSettledLevel ||
+        m_Peak[0] > kSettledLevel || m_Peak[1] > kSettledLevel)
+        return false;
+    for (const FFTStage &stage : m_Stages)
+    {
+        if (AudioDsp::Max(stage.spectrum.data(), stage.spectrum.size()) > kSettledLevel)
+            return false;
+    }
+    if (!m_Columns.empty())
+    {
+        float minValue = 0.0f;
+        float maxValue = 0.0f;
+        AudioDsp::MinMax(m_Columns.data(), m_Columns.size(), minValue, maxValue);
+        if (minValue < -kSettledLevel || maxValue > kSettledLevel)
+            return false;
+    }
+    return true;
+}
+
+void AudioAnalyzer::AppendMono(const float *mono, size_t count)
+{
+    if (m_Stages.empty())
+        return;
+    const size_t largest = m_History.size() / 2;
+    while (count > 0)
+    {
+        // Copy up to the next FFT boundary of any stage; strides are at most
+        // the stage size, so after compaction there is always room.
+        size_t n = count;
+        for (const FFTStage &stage : m_Stages)
+            n = (std::min)(n, static_cast<size_t>(stage.countdown));
+        if (m_HistoryLength + n > m_History.size())
+        {
+            std::memmove(m_History.data(), m_History.data() + m_HistoryLength - largest, largest * sizeof(float));
+            m_HistoryLength = largest;
+        }
+        std::memcpy(m_History.data() + m_HistoryLength, mono, n * sizeof(float));
+        m_HistoryLength += n;
+        m_HistoryFilled = (std::min)(m_HistoryFilled + n, largest);
+        mono += n;
+        count -= n;
+
+        for (FFTStage &stage : m_Stages)
+        {
+            stage.countdown -= static_cast<int>(n);
+            if (stage.countdown <= 0)
+            {
+                stage.countdown = stage.stride;
+                ComputeFFT(stage);
+            }
+        }
+    }
+}
+
+void AudioAnalyzer::ComputeFFT(FFTStage &stage)
+{
+    const size_t size = static_cast<size_t>(stage.size);
+    if (m_HistoryFilled < size)
+        return;
+    AudioDsp::Multiply(m_History.data() + m_HistoryLength - size, stage.window.data(), stage.in.data(), size);
+    kiss_fftr(stage.cfg, stage.in.data(), stage.out.data());
+    const float scalar = 1.0f / std::sqrt(static_cast<float>(stage.size));
+    AudioDsp::SmoothMagnitudes(reinterpret_cast<const float *>(stage.out.data()), stage.spectrum.size(), scalar, stage.k[0], stage.k[1], stage.spectrum.data());
+}
+
+void AudioAnalyzer::AppendWaveform(const float *mono, size_t count)
+{
+    const size_t columns = m_Columns.size() / 2;
+    while (count > 0)
+    {
+        const size_t n = (std::min)(count, m_ColumnSamples - m_ColumnFill);
+        float minValue = 0.0f;
+        float maxValue = 0.0f;
+        AudioDsp::MinMax(mono, n, minValue, maxValue);
+        m_ColumnMin = m_ColumnFill == 0 ? minValue : (std::min)(m_ColumnMin, minValue);
+        m_ColumnMax = m_ColumnFill == 0 ? maxValue : (std::max)(m_ColumnMax, maxValue);
+        m_ColumnFill += n;
+        mono += n;
+        count -= n;
+
+        if (m_ColumnFill == m_ColumnSamples)
+        {
+            m_Columns[m_ColumnWrite * 2 + 0] = m_ColumnMin;
+            m_Columns[m_ColumnWrite * 2 + 1] = m_ColumnMax;
+            m_ColumnWrite = (m_ColumnWrite + 1) % columns;
+            m_ColumnFill = 0;
+        }
+    }
+}
+
+void AudioAnalyzer::GetStats(AudioLevelStats &out) const
+{
+    out.rms[0] = Clamp01(m_RMS[0] * static_cast<float>(m_Config.rmsGain));
+    out.rms[1] = Clamp01(m_RMS[1] * static_cast<float>(m_Config.rmsGain));
+    out.peak[0] = Clamp01(m_Peak[0] * static_cast<float>(m_Config.peakGain));
+    out.peak[1] = Clamp01(m_Peak[1] * static_cast<float>(m_Config.peakGain));
+
+    if (!m_Columns.empty())
+    {
+        // Oldest column first.
+        const size_t split = m_ColumnWrite * 2;
+        out.bands.clear();
+        out.waveform.resize(m_Columns.size());
+        std::copy(m_Columns.begin() + static_cast<std::ptrdiff_t>(split), m_Columns.end(), out.waveform.begin());
+        std::copy(m_Columns.begin(), m_Columns.begin() + static_cast<std::ptrdiff_t>(split),
+                  out.waveform.begin() + static_cast<std::ptrdiff_t>(m_Columns.size() - split));
+        return;
+    }
+
+    out.waveform.clear();
+    out.bands.resize(m_Bands.size());
+    for (size_t i = 0; i < m_Bands.size(); ++i)
+    {
+        const BandSource &band = m_Bands[i];
+        const float *spectrum = m_Stages[static_cast<size_t>(band.stage)].spectrum.data() + band.begin;
+        const size_t count = static_cast<size_t>(band.end - band.begin);
+        const float value = band.filtered ? AudioDsp::Dot(m_FilterWeights.data() + band.weights, spectrum, count)
+                                          : AudioDsp::Max(spectrum, count);
+        out.bands[i] = value > 0.0f ? Clamp01(1.0f + 20.0f * std::log10(value) * m_InvSensitivity) : 0.0f;
+    }
+}
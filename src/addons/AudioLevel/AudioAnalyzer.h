@@ -0,0 +1,171 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "../../third_party/kiss_fft130/kiss_fftr.h"
+
+struct AudioLevelStats
+{
+    float rms[2] = {0.0f, 0.0f};
+    float peak[2] = {0.0f, 0.0f};
+    std::vector<float> bands;    // every mode but Waveform
+    std::vector<float> waveform; // Waveform: min, max per column, oldest first
+};
+
+enum class AudioAnalysisMode
+{
+    Bands,     // one FFT, log-spaced bands taking the loudest bin
+    ConstantQ, // log-spaced bands, each read from the smallest FFT that resolves it
+    Mel,       // triangular filters evenly spaced on the mel scale
+    Bark,      // triangular filters evenly spaced on the bark scale
+    Waveform   // decimated min/max of the mono signal, no FFT
+};
+
+struct AudioAnalyzerConfig
+{
+    AudioAnalysisMode mode = AudioAnalysisMode::Bands;
+
+    int fftSize = 1024;
+    int fftOverlap = 512;
+    int bands = 10;
+
+    double freqMin = 20.0;
+    double freqMax = 20000.0;
+    double sensitivity = 35.0;
+
+    int rmsAttack = 300;
+    int rmsDecay = 300;
+    int peakAttack = 50;
+    int peakDecay = 2500;
+    int fftAttack = 300;
+    int fftDecay = 300;
+
+    double rmsGain = 1.0;
+    double peakGain = 1.0;
+
+    int waveformPoints = 256;   // columns
+    int waveformDuration = 100; // ms covered by all columns
+
+    bool operator==(const AudioAnalyzerConfig &other) const;
+    bool operator!=(const AudioAnalyzerConfig &other) const { return !(*this == other); }
+};
+
+/*
+** Level meter and spectrum analysis of a stereo float stream. Platform
+** neutral: the addon feeds it from the WASAPI capture thread, the headless
+** bench from a WAV file. Not thread-safe; one thread drives it.
+**
+** Configure() sets up only what the mode outputs: the FFT sizes it reads,
+** band bin ranges or sparse filter weights, or the waveform columns.
+*/
+class AudioAnalyzer
+{
+public:
+    AudioAnalyzer() = default;
+    ~AudioAnalyzer();
+
+    AudioAnalyzer(const AudioAnalyzer &) = delete;
+    AudioAnalyzer &operator=(const AudioAnalyzer &) = delete;
+
+    // Reset all state for a stream of the given rate. Returns false if an
+    // FFT could not be set up.
+    bool Configure(const AudioAnalyzerConfig &config, int sampleRate);
+
+    const AudioAnalyzerConfig &GetConfig() const { return m_Config; }
+    int GetSampleRate() const { return m_SampleRate; }
+
+    // FFT sizes in use, smallest first; empty in Waveform mode.
+    std::vector<int> GetFFTSizes() const;
+
+    // Feed 'frames' interleaved stereo frames (left, right).
+    void Process(const float *frames, size_t frameCount);
+
+    // Feed 'frameCount' frames of silence so meters and bands fall back.
+    void ProcessSilence(size_t frameCount);
+
+    // True once meters, spectra and waveform have decayed to (near) zero.
+    bool IsSettled() const;
+
+    // Current values with gains applied and the mode's output.
+    void GetStats(AudioLevelStats &out) const;
+
+private:
+    // Frames deinterleaved per step of Process().
+    static constexpr size_t kChunkFrames = 1024;
+    // Largest FFT the constant-Q mode uses for its lowest octaves.
+    static constexpr int kMaxConstantQSize = 16384;
+
+    // One FFT size with its own hop, window and smoothed spectrum.
+    struct FFTStage
+    {
+        int size = 0;
+        int stride = 0;
+        int countdown = 0;
+        kiss_fftr_cfg cfg = nullptr;
+        std::vector<float> window;
+        std::vector<float> in;
+        std::vector<kiss_fft_cpx> out;
+        std::vector<float> spectrum;
+        float k[2] = {0.0f, 0.0f}; // attack, decay per FFT
+    };
+
+    // Output band read from bins [begin, end) of one stage: the loudest bin,
+    // or a weighted sum when the band has filter weights.
+    struct BandSource
+    {
+        int stage = 0;
+        int begin = 0;
+        int end = 0;
+        size_t weights = 0; // offset into m_FilterWeights, if filtered
+        bool filtered = false;
+    };
+
+    void Release();
+    bool AddStage(int size, int stride);
+    void BuildBandRanges();
+    void BuildFilterBank();
+    void AppendMono(const float *mono, size_t count);
+    void ComputeFFT(FFTStage &stage);
+    void AppendWaveform(const float *mono, size_t count);
+    void Smooth(float &value, float now, const float coeff[2], size_t frameCount) const;
+
+    AudioAnalyzerConfig m_Config;
+    int m_SampleRate = 48000;
+
+    std::vector<FFTStage> m_Stages;
+    // Mono samples in arrival order. Twice the largest FFT size, so the
+    // newest window of every stage is contiguous; compacted when full.
+    std::vector<float> m_History;
+    size_t m_HistoryLength = 0;
+    size_t m_HistoryFilled = 0;
+
+    std::vector<BandSource> m_Bands;
+    std::vector<float> m_FilterWeights;
+    float m_InvSensitivity = 1.0f / 35.0f;
+
+    // Waveform columns as a ring of (min, max) pairs.
+    std::vector<float> m_Columns;
+    size_t m_ColumnWrite = 0;
+    size_t m_ColumnSamples = 1;
+    size_t m_ColumnFill = 0;
+    float m_ColumnMin = 0.0f;
+    float m_ColumnMax = 0.0f;
+
+    std::vector<float> m_Left;
+    std::vector<float> m_Right;
+    std::vector<float> m_Mono;
+
+    float m_RMS[2] = {0.0f, 0.0f};
+    float m_Peak[2] = {0.0f, 0.0f};
+    // Per-sample attack / decay coefficients.
+    float m_KRMS[2] = {0.0f, 0.0f};
+    float m_KPeak[2] = {0.0f, 0.0f};
+};
@@ -0,0 +1,274 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "AudioDsp.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define NOVADESK_AUDIO_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace AudioDsp
+{
+    void ToStereo(const void *data, SampleFormat format, int channels, size_t frames, float *out)
+    {
+        if (channels < 1)
+        {
+            std::memset(out, 0, frames * 2 * sizeof(float));
+            return;
+        }
+
+        size_t i = 0;
+        if (format == SampleFormat::Float32)
+        {
+            const float *in = static_cast<const float *>(data);
+            if (channels == 2)
+            {
+                std::memcpy(out, in, frames * 2 * sizeof(float));
+                return;
+            }
+#ifdef NOVADESK_AUDIO_SSE2
+            if (channels == 1)
+            {
+                for (; i + 4 <= frames; i += 4)
+                {
+                    const __m128 v = _mm_loadu_ps(in + i);
+                    _mm_storeu_ps(out + i * 2, _mm_unpacklo_ps(v, v));
+                    _mm_storeu_ps(out + i * 2 + 4, _mm_unpackhi_ps(v, v));
+                }
+            }
+#endif
+            for (; i < frames; ++i)
+            {
+                const float l = in[i * channels + 0];
+                out[i * 2 + 0] = l;
+                out[i * 2 + 1] = (channels > 1) ? in[i * channels + 1] : l;
+            }
+            return;
+        }
+
+        const int16_t *in = static_cast<const int16_t *>(data);
+        const float scale = 1.0f / 32768.0f;
+#ifdef NOVADESK_AUDIO_SSE2
+        if (channels <= 2)
+        {
+            // Widen with a sign-extending shift, convert, scale.
+            const __m128 vScale = _mm_set1_ps(scale);
+            const size_t samples = frames * static_cast<size_t>(channels);
+            size_t s = 0;
+            for (; s + 8 <= samples; s += 8)
+            {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + s));
+                const __m128 lo = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16)), vScale);
+                const __m128 hi = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16)), vScale);
+                if (channels == 2)
+                {
+                    _mm_storeu_ps(out + s, lo);
+                    _mm_storeu_ps(out + s + 4, hi);
+                }
+                else
+                {
+                    _mm_storeu_ps(out + s * 2, _mm_unpacklo_ps(lo, lo));
+                    _mm_storeu_ps(out + s * 2 + 4, _mm_unpackhi_ps(lo, lo));
+                    _mm_storeu_ps(out + s * 2 + 8, _mm_unpacklo_ps(hi, hi));
+                    _mm_storeu_ps(out + s * 2 + 12, _mm_unpackhi_ps(hi, hi));
+                }
+            }
+            i = s / static_cast<size_t>(channels);
+        }
+#endif
+        for (; i < frames; ++i)
+        {
+            const float l = static_cast<float>(in[i * channels + 0]) * scale;
+            out[i * 2 + 0] = l;
+            out[i * 2 + 1] = (channels > 1) ? static_cast<float>(in[i * channels + 1]) * scale : l;
+        }
+    }
+
+    void Deinterleave(const float *stereo, size_t frames, float *left, float *right, float *mono)
+    {
+        size_t i = 0;
+#ifdef NOVADESK_AUDIO_SSE2
+        const __m128 half = _mm_set1_ps(0.5f);
+        for (; i + 4 <= frames; i += 4)
+        {
+            const __m128 a = _mm_loadu_ps(stereo + i * 2);
+            const __m128 b = _mm_loadu_ps(stereo + i * 2 + 4);
+            const __m128 l = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+            const __m128 r = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+            _mm_storeu_ps(left + i, l);
+            _mm_storeu_ps(right + i, r);
+            _mm_storeu_ps(mono + i, _mm_mul_ps(_mm_add_ps(l, r), half));
+        }
+#endif
+        for (; i < frames; ++i)
+        {
+            const float l = stereo[i * 2 + 0];
+            const float r = stereo[i * 2 + 1];
+            left[i] = l;
+            right[i] = r;
+            mono[i] = (l + r) * 0.5f;
+        }
+    }
+
+    void AccumulateLevel(const float *values, size_t count, float &sumSq, float &peak)
+    {
+        float sum = 0.0f;
+        float maxAbs = peak;
+        size_t i = 0;
+#ifdef NOVADESK_AUDIO_SSE2
+        if (count >= 4)
+        {
+            const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+            __m128 sumAcc = _mm_setzero_ps();
+            __m128 maxAcc = _mm_set1_ps(maxAbs);
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128 v = _mm_loadu_ps(values + i);
+                sumAcc = _mm_add_ps(sumAcc, _mm_mul_ps(v, v));
+                maxAcc = _mm_max_ps(maxAcc, _mm_and_ps(v, absMask));
+            }
+            float lanes[4];
+            _mm_storeu_ps(lanes, sumAcc);
+            sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+            _mm_storeu_ps(lanes, maxAcc);
+            for (float lane : lanes)
+                maxAbs = lane > maxAbs ? lane : maxAbs;
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            const float v = values[i];
+            sum += v * v;
+            const float a = std::fabs(v);
+            maxAbs = a > maxAbs ? a : maxAbs;
+        }
+        sumSq += sum;
+        peak = maxAbs;
+    }
+
+    void Multiply(const float *a, const float *b, float *out, size_t count)
+    {
+        size_t i = 0;
+#ifdef NOVADESK_AUDIO_SSE2
+        for (; i + 4 <= count; i += 4)
+            _mm_storeu_ps(out + i, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+#endif
+        for (; i < count; ++i)
+            out[i] = a[i] * b[i];
+    }
+
+    void SmoothMagnitudes(const float *bins, size_t count, float scale, float attack, float decay, float *spectrum)
+    {
+        size_t i = 0;
+#ifdef NOVADESK_AUDIO_SSE2
+        const __m128 vScale = _mm_set1_ps(scale);
+        const __m128 vAttack = _mm_set1_ps(attack);
+        const __m128 vDecay = _mm_set1_ps(decay);
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 a = _mm_loadu_ps(bins + i * 2);
+            const __m128 b = _mm_loadu_ps(bins + i * 2 + 4);
+            const __m128 re = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+            const __m128 im = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+            const __m128 mag = _mm_mul_ps(_mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(re, re), _mm_mul_ps(im, im))), vScale);
+            const __m128 old = _mm_loadu_ps(spectrum + i);
+            const __m128 falling = _mm_cmplt_ps(mag, old);
+            const __m128 k = _mm_or_ps(_mm_and_ps(falling, vDecay), _mm_andnot_ps(falling, vAttack));
+            _mm_storeu_ps(spectrum + i, _mm_add_ps(mag, _mm_mul_ps(k, _mm_sub_ps(old, mag))));
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            const float re = bins[i * 2 + 0];
+            const float im = bins[i * 2 + 1];
+            const float mag = std::sqrt(re * re + im * im) * scale;
+            const float old = spectrum[i];
+            const float k = (mag < old) ? decay : attack;
+            spectrum[i] = mag + k * (old - mag);
+        }
+    }
+
+    float Max(const float *values, size_t count)
+    {
+        float maxV = 0.0f;
+        size_t i = 0;
+#ifdef NOVADESK_AUDIO_SSE2
+        if (count >= 4)
+        {
+            __m128 maxAcc = _mm_setzero_ps();
+            for (; i + 4 <= count; i += 4)
+                maxAcc = _mm_max_ps(maxAcc, _mm_loadu_ps(values + i));
+            float lanes[4];
+            _mm_storeu_ps(lanes, maxAcc);
+            for (float lane : lanes)
+                maxV = lane > maxV ? lane : maxV;
+        }
+#endif
+        for (; i < count; ++i)
+            maxV = values[i] > maxV ? values[i] : maxV;
+        return maxV;
+    }
+
+    void MinMax(const float *values, size_t count, float &minValue, float &maxValue)
+    {
+        float minV = values[0];
+        float maxV = values[0];
+        size_t i = 1;
+#ifdef NOVADESK_AUDIO_SSE2
+        if (count >= 4)
+        {
+            __m128 minAcc = _mm_set1_ps(minV);
+            __m128 maxAcc = minAcc;
+            for (i = 0; i + 4 <= count; i += 4)
+            {
+                const __m128 v = _mm_loadu_ps(values + i);
+                minAcc = _mm_min_ps(minAcc, v);
+                maxAcc = _mm_max_ps(maxAcc, v);
+            }
+            float lanes[4];
+            _mm_storeu_ps(lanes, minAcc);
+            for (float lane : lanes)
+                minV = lane < minV ? lane : minV;
+            _mm_storeu_ps(lanes, maxAcc);
+            for (float lane : lanes)
+                maxV = lane > maxV ? lane : maxV;
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            minV = values[i] < minV ? values[i] : minV;
+            maxV = values[i] > maxV ? values[i] : maxV;
+        }
+        minValue = minV;
+        maxValue = maxV;
+    }
+
+    float Dot(const float *a, const float *b, size_t count)
+    {
+        float sum = 0.0f;
+        size_t i = 0;
+#ifdef NOVADESK_AUDIO_SSE2
+        if (count >= 4)
+        {
+            __m128 acc = _mm_setzero_ps();
+            for (; i + 4 <= count; i += 4)
+                acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+            float lanes[4];
+            _mm_storeu_ps(lanes, acc);
+            sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+        }
+#endif
+        for (; i < count; ++i)
+            sum += a[i] * b[i];
+        return sum;
+    }
+}
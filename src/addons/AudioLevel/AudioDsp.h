@@ -0,0 +1,54 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#pragma once
+
+#include <cstddef>
+
+/*
+** Whole-buffer sample passes for the AudioLevel pipeline. Each uses SSE2 on
+** x86/x64 (four samples per step) and a scalar loop elsewhere. Conversion,
+** deinterleaving and smoothing give identical results on both paths; the
+** reductions only differ in float summation order.
+*/
+namespace AudioDsp
+{
+    enum class SampleFormat
+    {
+        Float32,
+        Int16
+    };
+
+    // Convert 'frames' interleaved frames of 'channels' channels to
+    // interleaved stereo float. Mono is duplicated, channels past the second
+    // are dropped, int16 is scaled by 1/32768.
+    void ToStereo(const void *data, SampleFormat format, int channels, size_t frames, float *out);
+
+    // Split interleaved stereo into left, right and their average.
+    void Deinterleave(const float *stereo, size_t frames, float *left, float *right, float *mono);
+
+    // Add the sum of squares of 'values' to 'sumSq' and raise 'peak' to their
+    // largest magnitude.
+    void AccumulateLevel(const float *values, size_t count, float &sumSq, float &peak);
+
+    // out[i] = a[i] * b[i]
+    void Multiply(const float *a, const float *b, float *out, size_t count);
+
+    // Smooth spectrum magnitudes towards new FFT bins (re, im pairs):
+    //   mag = |bin| * scale
+    //   spectrum[i] = mag + (mag < spectrum[i] ? decay : attack) * (spectrum[i] - mag)
+    void SmoothMagnitudes(const float *bins, size_t count, float scale, float attack, float decay, float *spectrum);
+
+    // Largest value; 0 for an empty range. Values are expected to be >= 0.
+    float Max(const float *values, size_t count);
+
+    // Smallest and largest value of a non-empty range.
+    void MinMax(const float *values, size_t count, float &minValue, float &maxValue);
+
+    // Sum of a[i] * b[i].
+    float Dot(const float *a, const float *b, size_t count);
+}
@@ -0,0 +1,82 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+** Lock-free single-producer / single-consumer sample ring. The capture thread
+** writes, the analysis thread reads; neither ever blocks. When the reader
+** falls behind, the samples that do not fit are dropped and counted.
+*/
+class AudioRing
+{
+public:
+    // Capacity is rounded up to a power of two.
+    explicit AudioRing(size_t capacity = 1u << 16)
+    {
+        size_t size = 1;
+        while (size < capacity)
+            size <<= 1;
+        m_Buffer.assign(size, 0.0f);
+        m_Mask = size - 1;
+    }
+
+    AudioRing(const AudioRing &) = delete;
+    AudioRing &operator=(const AudioRing &) = delete;
+
+    size_t GetCapacity() const { return m_Buffer.size(); }
+
+    // Producer side. Returns the number of samples stored.
+    size_t Write(const float *samples, size_t count)
+    {
+        const size_t head = m_Head.load(std::memory_order_relaxed);
+        const size_t tail = m_Tail.load(std::memory_order_acquire);
+        const size_t room = m_Buffer.size() - (head - tail);
+        const size_t n = count < room ? count : room;
+        for (size_t i = 0; i < n; ++i)
+            m_Buffer[(head + i) & m_Mask] = samples[i];
+        m_Head.store(head + n, std::memory_order_release);
+        if (n < count)
+            m_Dropped.fetch_add(count - n, std::memory_order_relaxed);
+        return n;
+    }
+
+    // Consumer side. Returns the number of samples copied into 'out'.
+    size_t Read(float *out, size_t count)
+    {
+        const size_t tail = m_Tail.load(std::memory_order_relaxed);
+        const size_t head = m_Head.load(std::memory_order_acquire);
+        const size_t available = head - tail;
+        const size_t n = count < available ? count : available;
+        for (size_t i = 0; i < n; ++i)
+            out[i] = m_Buffer[(tail + i) & m_Mask];
+        m_Tail.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    // Consumer side; a lower bound when called from the producer.
+    size_t GetAvailable() const
+    {
+        return m_Head.load(std::memory_order_acquire) - m_Tail.load(std::memory_order_relaxed);
+    }
+
+    uint64_t GetDropped() const { return m_Dropped.load(std::memory_order_relaxed); }
+
+private:
+    std::vector<float> m_Buffer;
+    size_t m_Mask = 0;
+
+    // Kept on separate cache lines so the two threads do not share one.
+    alignas(64) std::atomic<size_t> m_Head{0};
+    alignas(64) std::atomic<size_t> m_Tail{0};
+    alignas(64) std::atomic<uint64_t> m_Dropped{0};
+};
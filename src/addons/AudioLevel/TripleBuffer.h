@@ -0,0 +1,62 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#pragma once
+
+#include <atomic>
+
+/*
+** Wait-free hand-off of the latest value from one writer thread to one reader
+** thread. The writer fills WriteBuffer() and publishes it; the reader always
+** gets the most recently published value. Each side owns one slot, the third
+** is swapped between them with a single atomic exchange, so neither side ever
+** waits or sees a half-written value.
+*/
+template <typename T>
+class TripleBuffer
+{
+public:
+    // Forget published values. Only while neither side is running.
+    void Reset()
+    {
+        m_Middle.store(1, std::memory_order_relaxed);
+        m_Write = 0;
+        m_Read = 2;
+        m_HasValue = false;
+    }
+
+    // Writer side: slot to fill before the next Publish().
+    T &WriteBuffer() { return m_Slots[m_Write]; }
+
+    // Writer side: make WriteBuffer() the latest value.
+    void Publish()
+    {
+        m_Write = m_Middle.exchange(m_Write | kFresh, std::memory_order_acq_rel) & kIndex;
+    }
+
+    // Reader side: latest published value, or nullptr before the first
+    // Publish(). The pointer stays valid until the next Read().
+    const T *Read()
+    {
+        if (m_Middle.load(std::memory_order_relaxed) & kFresh)
+        {
+            m_Read = m_Middle.exchange(m_Read, std::memory_order_acq_rel) & kIndex;
+            m_HasValue = true;
+        }
+        return m_HasValue ? &m_Slots[m_Read] : nullptr;
+    }
+
+private:
+    static constexpr unsigned kIndex = 3;
+    static constexpr unsigned kFresh = 4;
+
+    T m_Slots[3];
+    std::atomic<unsigned> m_Middle{1};
+    unsigned m_Write = 0;
+    unsigned m_Read = 2;
+    bool m_HasValue = false;
+};
@@ -0,0 +1,633 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+/*
+** Headless checks and throughput benchmark for the AudioLevel DSP pipeline,
+** driven from WAV files.
+**
+**   audiolevel_bench                run checks, then time 10 minutes of audio
+**                                   through each analysis mode
+**   audiolevel_bench --check        run checks only (used by ctest)
+**   audiolevel_bench --wav <file>   print the stats a WAV file ends with
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../AudioAnalyzer.h"
+#include "../AudioDsp.h"
+#include "../AudioRing.h"
+#include "../TripleBuffer.h"
+
+namespace
+{
+    int s_Failures = 0;
+
+    void Check(bool condition, const char *what)
+    {
+        if (!condition)
+        {
+            ++s_Failures;
+            std::printf("FAIL: %s\n", what);
+        }
+    }
+
+    bool Near(float a, float b, float epsilon)
+    {
+        return std::fabs(a - b) <= epsilon;
+    }
+
+    struct WavData
+    {
+        int sampleRate = 0;
+        std::vector<float> stereo; // interleaved left, right
+    };
+
+    uint32_t ReadU32(const unsigned char *p) { return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24); }
+    uint16_t ReadU16(const unsigned char *p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+
+    // 16-bit PCM or 32-bit float, mono or multichannel (first two channels
+    // kept), converted by the same code the capture thread uses.
+    bool ReadWav(const char *path, WavData &out)
+    {
+        FILE *file = std::fopen(path, "rb");
+        if (!file)
+            return false;
+        std::vector<unsigned char> bytes;
+        unsigned char chunk[65536];
+        size_t n = 0;
+        while ((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+            bytes.insert(bytes.end(), chunk, chunk + n);
+        std::fclose(file);
+
+        if (bytes.size() < 12 || std::memcmp(bytes.data(), "RIFF", 4) != 0 || std::memcmp(bytes.data() + 8, "WAVE", 4) != 0)
+            return false;
+
+        int format = 0;
+        int channels = 0;
+        int bits = 0;
+        size_t pos = 12;
+        while (pos + 8 <= bytes.size())
+        {
+            const unsigned char *header = bytes.data() + pos;
+            const size_t size = ReadU32(header + 4);
+            const size_t body = pos + 8;
+            if (body + size > bytes.size())
+                return false;
+            if (std::memcmp(header, "fmt ", 4) == 0 && size >= 16)
+            {
+                format = ReadU16(bytes.data() + body);
+                channels = ReadU16(bytes.data() + body + 2);
+                out.sampleRate = static_cast<int>(ReadU32(bytes.data() + body + 4));
+                bits = ReadU16(bytes.data() + body + 14);
+                if (format == 0xFFFE && size >= 26)
+                    format = ReadU16(bytes.data() + body + 24); // WAVE_FORMAT_EXTENSIBLE subformat
+            }
+            else if (std::memcmp(header, "data", 4) == 0)
+            {
+                const bool pcm16 = format == 1 && bits == 16;
+                const bool float32 = format == 3 && bits == 32;
+                if (channels < 1 || (!pcm16 && !float32))
+                    return false;
+                // Samples are little-endian, as on every platform the addon runs on.
+                const size_t frames = size / (static_cast<size_t>(channels) * (bits / 8));
+                out.stereo.resize(frames * 2);
+                AudioDsp::ToStereo(bytes.data() + body, pcm16 ? AudioDsp::SampleFormat::Int16 : AudioDsp::SampleFormat::Float32,
+                                   channels, frames, out.stereo.data());
+                return out.sampleRate > 0;
+            }
+            pos = body + size + (size & 1);
+        }
+        return false;
+    }
+
+    bool WriteWav16(const char *path, int sampleRate, const std::vector<float> &stereo)
+    {
+        FILE *file = std::fopen(path, "wb");
+        if (!file)
+            return false;
+        const uint32_t dataBytes = static_cast<uint32_t>(stereo.size() * 2);
+        auto u32 = [&](uint32_t v)
+        {
+            const unsigned char b[4] = {static_cast<unsigned char>(v), static_cast<unsigned char>(v >> 8),
+                                        static_cast<unsigned char>(v >> 16), static_cast<unsigned char>(v >> 24)};
+            std::fwrite(b, 1, 4, file);
+        };
+        auto u16 = [&](uint16_t v)
+        {
+            const unsigned char b[2] = {static_cast<unsigned char>(v), static_cast<unsigned char>(v >> 8)};
+            std::fwrite(b, 1, 2, file);
+        };
+        std::fwrite("RIFF", 1, 4, file);
+        u32(36 + dataBytes);
+        std::fwrite("WAVEfmt ", 1, 8, file);
+        u32(16);
+        u16(1);
+        u16(2);
+        u32(static_cast<uint32_t>(sampleRate));
+        u32(static_cast<uint32_t>(sampleRate) * 4);
+        u16(4);
+        u16(16);
+        std::fwrite("data", 1, 4, file);
+        u32(dataBytes);
+        for (float v : stereo)
+        {
+            const float clamped = v < -1.0f ? -1.0f : (v > 1.0f ? 1.0f : v);
+            u16(static_cast<uint16_t>(static_cast<int16_t>(std::lround(clamped * 32767.0f))));
+        }
+        return std::fclose(file) == 0;
+    }
+
+    std::vector<float> MakeTone(int sampleRate, double seconds, double frequency, float amplitude)
+    {
+        const size_t frames = static_cast<size_t>(sampleRate * seconds);
+        std::vector<float> stereo(frames * 2);
+        for (size_t i = 0; i < frames; ++i)
+        {
+            const float v = amplitude * static_cast<float>(std::sin(2.0 * 3.14159265358979 * frequency * static_cast<double>(i) / sampleRate));
+            stereo[i * 2 + 0] = v;
+            stereo[i * 2 + 1] = v;
+        }
+        return stereo;
+    }
+
+    void Drive(AudioAnalyzer &analyzer, const std::vector<float> &stereo, size_t blockFrames)
+    {
+        const size_t frames = stereo.size() / 2;
+        for (size_t i = 0; i < frames; i += blockFrames)
+        {
+            const size_t n = (frames - i) < blockFrames ? (frames - i) : blockFrames;
+            analyzer.Process(stereo.data() + i * 2, n);
+        }
+    }
+
+    // Band the config maps 'frequency' to.
+    int BandOf(const AudioAnalyzerConfig &config, double frequency)
+    {
+        return static_cast<int>(config.bands * std::log(frequency / config.freqMin) / std::log(config.freqMax / config.freqMin));
+    }
+
+    void CheckDsp()
+    {
+        // Odd lengths so both the vector body and the scalar tail run.
+        const size_t frames = 37;
+        std::vector<int16_t> pcm(frames * 2);
+        for (size_t i = 0; i < pcm.size(); ++i)
+            pcm[i] = static_cast<int16_t>((static_cast<int>(i) * 2731) % 65536 - 32768);
+        std::vector<float> stereo(frames * 2);
+        AudioDsp::ToStereo(pcm.data(), AudioDsp::SampleFormat::Int16, 2, frames, stereo.data());
+        bool exact = true;
+        for (size_t i = 0; i < pcm.size(); ++i)
+            exact = exact && stereo[i] == static_cast<float>(pcm[i]) / 32768.0f;
+        Check(exact, "int16 stereo conversion");
+
+        AudioDsp::ToStereo(pcm.data(), AudioDsp::SampleFormat::Int16, 1, frames, stereo.data());
+        exact = true;
+        for (size_t i = 0; i < frames; ++i)
+            exact = exact && stereo[i * 2] == static_cast<float>(pcm[i]) / 32768.0f && stereo[i * 2 + 1] == stereo[i * 2];
+        Check(exact, "int16 mono conversion");
+
+        std::vector<float> surround(frames * 6);
+        for (size_t i = 0; i < surround.size(); ++i)
+            surround[i] = static_cast<float>(i);
+        AudioDsp::ToStereo(surround.data(), AudioDsp::SampleFormat::Float32, 6, frames, stereo.data());
+        Check(stereo[2] == 6.0f && stereo[3] == 7.0f, "multichannel keeps front left/right");
+
+        std::vector<float> left(frames), right(frames), mono(frames);
+        for (size_t i = 0; i < stereo.size(); ++i)
+            stereo[i] = std::sin(static_cast<float>(i) * 0.7f);
+        AudioDsp::Deinterleave(stereo.data(), frames, left.data(), right.data(), mono.data());
+        exact = true;
+        for (size_t i = 0; i < frames; ++i)
+            exact = exact && left[i] == stereo[i * 2] && right[i] == stereo[i * 2 + 1] && mono[i] == (left[i] + right[i]) * 0.5f;
+        Check(exact, "deinterleave");
+
+        float sumSq = 0.0f;
+        float peak = 0.0f;
+        AudioDsp::AccumulateLevel(left.data(), frames, sumSq, peak);
+        float refSum = 0.0f;
+        float refPeak = 0.0f;
+        for (float v : left)
+        {
+            refSum += v * v;
+            refPeak = std::fabs(v) > refPeak ? std::fabs(v) : refPeak;
+        }
+        Check(Near(sumSq, refSum, 1e-4f) && peak == refPeak, "level reduction");
+
+        std::vector<float> bins(frames * 2);
+        std::vector<float> spectrum(frames);
+        std::vector<float> expected(frames);
+        for (size_t i = 0; i < frames; ++i)
+        {
+            bins[i * 2] = std::cos(static_cast<float>(i));
+            bins[i * 2 + 1] = std::sin(static_cast<float>(i) * 3.0f);
+            spectrum[i] = expected[i] = 0.5f * static_cast<float>(i % 3);
+        }
+        AudioDsp::SmoothMagnitudes(bins.data(), frames, 0.9f, 0.25f, 0.75f, spectrum.data());
+        exact = true;
+        for (size_t i = 0; i < frames; ++i)
+        {
+            const float mag = std::sqrt(bins[i * 2] * bins[i * 2] + bins[i * 2 + 1] * bins[i * 2 + 1]) * 0.9f;
+            const float k = mag < expected[i] ? 0.75f : 0.25f;
+            exact = exact && spectrum[i] == mag + k * (expected[i] - mag);
+        }
+        Check(exact, "spectrum smoothing");
+        Check(AudioDsp::Max(spectrum.data(), frames) == *std::max_element(spectrum.begin(), spectrum.end()), "max");
+    }
+
+    void CheckRing()
+    {
+        AudioRing ring(1000);
+        Check(ring.GetCapacity() == 1024, "ring capacity rounds up to a power of two");
+
+        float values[1500];
+        for (int i = 0; i < 1500; ++i)
+            values[i] = static_cast<float>(i);
+        Check(ring.Write(values, 1500) == 1024, "ring write stops when full");
+        Check(ring.GetDropped() == 476, "ring counts dropped samples");
+        float out[1500];
+        Check(ring.Read(out, 1000) == 1000 && out[999] == 999.0f, "ring read order");
+        Check(ring.Write(values, 100) == 100 && ring.GetAvailable() == 124, "ring wraps");
+
+        // One producer, one consumer: every sample arrives once and in order.
+        AudioRing shared(256);
+        const int total = 1 << 20;
+        std::thread producer([&]()
+                             {
+            int sent = 0;
+            while (sent < total)
+            {
+                float chunk[37];
+                const int n = (total - sent) < 37 ? (total - sent) : 37;
+                for (int i = 0; i < n; ++i)
+                    chunk[i] = static_cast<float>((sent + i) & 0xFFFF);
+                size_t written = 0;
+                while (written < static_cast<size_t>(n))
+                {
+                    const size_t w = shared.Write(chunk + written, static_cast<size_t>(n) - written);
+                    if (w == 0)
+                        std::this_thread::yield();
+                    written += w;
+                }
+                sent += n;
+            } });
+        int received = 0;
+        bool ordered = true;
+        while (received < total)
+        {
+            float chunk[64];
+            const size_t n = shared.Read(chunk, 64);
+            if (n == 0)
+                std::this_thread::yield();
+            for (size_t i = 0; i < n; ++i)
+                ordered = ordered && chunk[i] == static_cast<float>((received + static_cast<int>(i)) & 0xFFFF);
+            received += static_cast<int>(n);
+        }
+        producer.join();
+        Check(ordered && received == total, "ring SPSC transfer is lossless and ordered");
+    }
+
+    void CheckTripleBuffer()
+    {
+        TripleBuffer<int> buffer;
+        Check(buffer.Read() == nullptr, "triple buffer empty before publish");
+        buffer.WriteBuffer() = 1;
+        buffer.Publish();
+        buffer.WriteBuffer() = 2;
+        buffer.Publish();
+        const int *value = buffer.Read();
+        Check(value && *value == 2, "triple buffer reads the latest value");
+        Check(buffer.Read() && *buffer.Read() == 2, "triple buffer keeps the value without a new publish");
+
+        // Values are published in increasing order; the reader must never
+        // see one go backwards.
+        TripleBuffer<std::vector<int>> shared;
+        const int total = 200000;
+        std::thread writer([&]()
+                           {
+            for (int i = 1; i <= total; ++i)
+            {
+                shared.WriteBuffer().assign(8, i);
+                shared.Publish();
+            } });
+        int last = 0;
+        bool consistent = true;
+        while (last < total)
+        {
+            const std::vector<int> *latest = shared.Read();
+            if (!latest)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            const int v = (*latest)[0];
+            for (int x : *latest)
+                consistent = consistent && x == v;
+            consistent = consistent && v >= last;
+            last = v;
+        }
+        writer.join();
+        Check(consistent, "triple buffer values are whole and monotonic");
+    }
+
+    void CheckAnalyzer()
+    {
+        const int sampleRate = 48000;
+        const float amplitude = 0.5f;
+        const std::string path = "audiolevel_check_tone.wav";
+        Check(WriteWav16(path.c_str(), sampleRate, MakeTone(sampleRate, 3.0, 1000.0, amplitude)), "write tone wav");
+
+        WavData wav;
+        Check(ReadWav(path.c_str(), wav) && wav.sampleRate == sampleRate, "read tone wav");
+        std::remove(path.c_str());
+        if (wav.stereo.empty())
+            return;
+
+        AudioAnalyzerConfig config;
+        AudioAnalyzer analyzer;
+        Check(analyzer.Configure(config, wav.sampleRate), "configure analyzer");
+        Drive(analyzer, wav.stereo, 480);
+
+        AudioLevelStats stats;
+        analyzer.GetStats(stats);
+        const float rms = amplitude / std::sqrt(2.0f);
+        Check(Near(stats.rms[0], rms, 0.01f) && Near(stats.rms[1], rms, 0.01f), "tone rms");
+        Check(Near(stats.peak[0], amplitude, 0.01f), "tone peak");
+        Check(stats.bands.size() == static_cast<size_t>(config.bands), "band count");
+
+        int loudest = 0;
+        for (size_t i = 1; i < stats.bands.size(); ++i)
+        {
+            if (stats.bands[i] > stats.bands[static_cast<size_t>(loudest)])
+                loudest = static_cast<int>(i);
+        }
+        Check(loudest == BandOf(config, 1000.0), "tone lands in its band");
+
+        // Meter smoothing is per sample, so the block size the capture
+        // thread happens to deliver must not change the result.
+        AudioAnalyzer coarse;
+        coarse.Configure(config, wav.sampleRate);
+        Drive(coarse, wav.stereo, 4096);
+        AudioLevelStats coarseStats;
+        coarse.GetStats(coarseStats);
+        Check(Near(coarseStats.rms[0], stats.rms[0], 0.005f), "rms independent of block size");
+
+        // The attack time is when a meter has closed ~86% (1 - e^-2) of the gap.
+        AudioAnalyzer rise;
+        rise.Configure(config, wav.sampleRate);
+        Drive(rise, std::vector<float>(wav.stereo.begin(), wav.stereo.begin() + sampleRate * 2 * config.rmsAttack / 1000), 480);
+        AudioLevelStats riseStats;
+        rise.GetStats(riseStats);
+        Check(riseStats.rms[0] > rms * 0.8f && riseStats.rms[0] < rms, "rms rises over its attack time");
+
+        bool settled = false;
+        for (int i = 0; i < 1000 && !settled; ++i)
+        {
+            analyzer.ProcessSilence(sampleRate / 50);
+            settled = analyzer.IsSettled();
+        }
+        analyzer.GetStats(stats);
+        Check(settled && stats.peak[0] < 0.001f, "silence settles meters");
+        float bandMax = 0.0f;
+        for (float v : stats.bands)
+            bandMax = v > bandMax ? v : bandMax;
+        Check(bandMax == 0.0f, "silence settles bands");
+    }
+
+    int LoudestBand(const std::vector<float> &bands)
+    {
+        int loudest = 0;
+        for (size_t i = 1; i < bands.size(); ++i)
+        {
+            if (bands[i] > bands[static_cast<size_t>(loudest)])
+                loudest = static_cast<int>(i);
+        }
+        return loudest;
+    }
+
+    // Filter-bank band whose centre is nearest 'frequency', mirroring the
+    // edge spacing AudioAnalyzer uses.
+    int NearestFilterBand(const AudioAnalyzerConfig &config, double (*toScale)(double), double (*fromScale)(double), double frequency)
+    {
+        const double lo = toScale(config.freqMin);
+        const double hi = toScale(config.freqMax);
+        int nearest = 0;
+        double nearestDistance = 1e300;
+        for (int i = 0; i < config.bands; ++i)
+        {
+            const double center = fromScale(lo + (hi - lo) * (i + 1) / (config.bands + 1));
+            if (std::fabs(center - frequency) < nearestDistance)
+            {
+                nearestDistance = std::fabs(center - frequency);
+                nearest = i;
+            }
+        }
+        return nearest;
+    }
+
+    void CheckModes()
+    {
+        const int sampleRate = 48000;
+
+        // Constant-Q: a bass tone lands in its own narrow band, which a
+        // single small FFT cannot resolve; the high bands stay on the base
+        // size.
+        AudioAnalyzerConfig cqt;
+        cqt.mode = AudioAnalysisMode::ConstantQ;
+        cqt.fftSize = 512;
+        cqt.fftOverlap = 256;
+        cqt.bands = 60;
+        AudioAnalyzer analyzer;
+        Check(analyzer.Configure(cqt, sampleRate), "configure constant-Q");
+        const std::vector<int> sizes = analyzer.GetFFTSizes();
+        Check(sizes.size() > 2 && sizes.front() == 512 && sizes.back() <= 16384, "constant-Q uses several FFT sizes");
+        Drive(analyzer, MakeTone(sampleRate, 3.0, 50.0, 0.5f), 480);
+        AudioLevelStats stats;
+        analyzer.GetStats(stats);
+        Check(stats.bands.size() == 60 && stats.waveform.empty(), "constant-Q band count");
+        Check(LoudestBand(stats.bands) == BandOf(cqt, 50.0), "constant-Q resolves a bass tone");
+
+        AudioAnalyzerConfig narrow = cqt;
+        narrow.freqMin = 2000.0;
+        narrow.bands = 10;
+        analyzer.Configure(narrow, sampleRate);
+        Check(analyzer.GetFFTSizes().size() == 1, "constant-Q only adds sizes its bands need");
+
+        // Mel and bark: the tone's energy sits in the filter centred on it.
+        AudioAnalyzerConfig mel;
+        mel.mode = AudioAnalysisMode::Mel;
+        mel.bands = 40;
+        mel.freqMax = 16000.0;
+        analyzer.Configure(mel, sampleRate);
+        Drive(analyzer, MakeTone(sampleRate, 1.0, 1000.0, 0.5f), 480);
+        analyzer.GetStats(stats);
+        Check(stats.bands.size() == 40, "mel band count");
+        Check(LoudestBand(stats.bands) == NearestFilterBand(mel, [](double f) { return 2595.0 * std::log10(1.0 + f / 700.0); },
+                                                            [](double m) { return 700.0 * (std::pow(10.0, m / 2595.0) - 1.0); }, 1000.0),
+              "mel filter centred on the tone is loudest");
+
+        AudioAnalyzerConfig bark = mel;
+        bark.mode = AudioAnalysisMode::Bark;
+        bark.bands = 24;
+        analyzer.Configure(bark, sampleRate);
+        Drive(analyzer, MakeTone(sampleRate, 1.0, 3000.0, 0.5f), 480);
+        analyzer.GetStats(stats);
+        Check(LoudestBand(stats.bands) == NearestFilterBand(bark, [](double f) { return 26.81 * f / (1960.0 + f) - 0.53; },
+                                                            [](double z) { return 1960.0 * (z + 0.53) / (26.28 - z); }, 3000.0),
+              "bark filter centred on the tone is loudest");
+
+        // Waveform: 100 columns over 100 ms, no FFT at all.
+        AudioAnalyzerConfig wave;
+        wave.mode = AudioAnalysisMode::Waveform;
+        wave.waveformPoints = 100;
+        wave.waveformDuration = 100;
+        analyzer.Configure(wave, sampleRate);
+        Check(analyzer.GetFFTSizes().empty(), "waveform runs no FFT");
+        std::vector<float> dc(static_cast<size_t>(sampleRate) / 5 * 2, 0.25f);
+        Drive(analyzer, dc, 480);
+        analyzer.GetStats(stats);
+        bool flat = stats.waveform.size() == 200 && stats.bands.empty();
+        for (float v : stats.waveform)
+            flat = flat && v == 0.25f;
+        Check(flat, "waveform columns hold min/max of a constant signal");
+
+        // One 1 kHz period per 48-sample column; the newest columns are
+        // the tone, the ones before it still hold the constant.
+        Drive(analyzer, MakeTone(sampleRate, 0.05, 1000.0, 0.5f), 480);
+        analyzer.GetStats(stats);
+        Check(Near(stats.waveform[198], -0.5f, 0.01f) && Near(stats.waveform[199], 0.5f, 0.01f), "waveform newest column spans the tone");
+        Check(stats.waveform[0] == 0.25f && stats.waveform[1] == 0.25f, "waveform oldest column first");
+
+        bool settled = false;
+        for (int i = 0; i < 1000 && !settled; ++i)
+        {
+            analyzer.ProcessSilence(sampleRate / 50);
+            settled = analyzer.IsSettled();
+        }
+        Check(settled, "waveform settles during silence");
+    }
+
+    // Ten minutes of 48 kHz stereo in 10 ms packets, as the capture thread
+    // delivers them, with stats() polled at 30 Hz.
+    void RunBenchmark(const char *name, const AudioAnalyzerConfig &config)
+    {
+        const int sampleRate = 48000;
+        const int seconds = 600;
+        const size_t packetFrames = static_cast<size_t>(sampleRate / 100);
+
+        // One second of music-like material, looped.
+        std::vector<int16_t> pcm(static_cast<size_t>(sampleRate) * 2);
+        uint32_t noise = 1;
+        for (int i = 0; i < sampleRate; ++i)
+        {
+            noise = noise * 1664525u + 1013904223u;
+            const double t = static_cast<double>(i) / sampleRate;
+            const double v = 0.3 * std::sin(2.0 * 3.14159265358979 * 55.0 * t) + 0.2 * std::sin(2.0 * 3.14159265358979 * 880.0 * t) +
+                             0.05 * (static_cast<double>(noise >> 8) / 16777216.0 - 0.5);
+            pcm[static_cast<size_t>(i) * 2] = static_cast<int16_t>(v * 32767.0);
+            pcm[static_cast<size_t>(i) * 2 + 1] = static_cast<int16_t>(-v * 32767.0);
+        }
+
+        AudioAnalyzer analyzer;
+        analyzer.Configure(config, sampleRate);
+        std::vector<float> stereo(packetFrames * 2);
+        AudioLevelStats stats;
+
+        const auto start = std::chrono::steady_clock::now();
+        for (int second = 0; second < seconds; ++second)
+        {
+            for (size_t frame = 0; frame + packetFrames <= static_cast<size_t>(sampleRate); frame += packetFrames)
+            {
+                AudioDsp::ToStereo(pcm.data() + frame * 2, AudioDsp::SampleFormat::Int16, 2, packetFrames, stereo.data());
+                analyzer.Process(stereo.data(), packetFrames);
+            }
+            for (int poll = 0; poll < 30; ++poll)
+                analyzer.GetStats(stats);
+        }
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const double frames = static_cast<double>(sampleRate) * seconds;
+        std::printf("%-28s %d s of %d Hz stereo: %.3f s, %5.0fx realtime, %5.1f ns/frame\n",
+                    name, seconds, sampleRate, elapsed, seconds / elapsed, elapsed * 1e9 / frames);
+    }
+
+    void RunBenchmarks()
+    {
+        AudioAnalyzerConfig config;
+        RunBenchmark("bands (1024, 10 bands)", config);
+
+        config.mode = AudioAnalysisMode::ConstantQ;
+        config.fftSize = 512;
+        config.fftOverlap = 256;
+        config.bands = 60;
+        RunBenchmark("constant-Q (512.., 60 bands)", config);
+
+        config = AudioAnalyzerConfig();
+        config.mode = AudioAnalysisMode::Mel;
+        config.bands = 40;
+        RunBenchmark("mel (1024, 40 bands)", config);
+
+        config = AudioAnalyzerConfig();
+        config.mode = AudioAnalysisMode::Waveform;
+        RunBenchmark("waveform (256 points)", config);
+    }
+
+    int PrintWav(const char *path)
+    {
+        WavData wav;
+        if (!ReadWav(path, wav))
+        {
+            std::printf("Cannot read %s (16-bit PCM or 32-bit float WAV expected)\n", path);
+            return 1;
+        }
+        AudioAnalyzer analyzer;
+        if (!analyzer.Configure(AudioAnalyzerConfig(), wav.sampleRate))
+            return 1;
+        Drive(analyzer, wav.stereo, 480);
+
+        AudioLevelStats stats;
+        analyzer.GetStats(stats);
+        std::printf("rms   %.4f %.4f\n", stats.rms[0], stats.rms[1]);
+        std::printf("peak  %.4f %.4f\n", stats.peak[0], stats.peak[1]);
+        std::printf("bands");
+        for (float v : stats.bands)
+            std::printf(" %.3f", v);
+        std::printf("\n");
+        return 0;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 2 && std::strcmp(argv[1], "--wav") == 0)
+        return PrintWav(argv[2]);
+
+    const bool checkOnly = argc > 1 && std::strcmp(argv[1], "--check") == 0;
+
+    CheckDsp();
+    CheckRing();
+    CheckTripleBuffer();
+    CheckAnalyzer();
+    CheckModes();
+
+    if (s_Failures)
+    {
+        std::printf("%d check(s) failed\n", s_Failures);
+        return 1;
+    }
+    std::printf("All checks passed\n");
+
+    if (!checkOnly)
+        RunBenchmarks();
+    return 0;
+}
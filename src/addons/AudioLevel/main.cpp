@@ -13,58 +13,53 @@
 
 #include <mmdeviceapi.h>
 #include <audioclient.h>
+#include <avrt.h>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <cmath>
 #include <string>
+#include <thread>
 #include <algorithm>
 #include <Windows.h>
 #include <objbase.h>
 
-#include "../../third_party/kiss_fft130/kiss_fftr.h"
+#include "AudioAnalyzer.h"
+#include "AudioDsp.h"
+#include "AudioRing.h"
+#include "TripleBuffer.h"
+
+#pragma comment(lib, "Avrt.lib")
 
 const NovadeskHostAPI *g_Host = nullptr;
 
 namespace
 {
-    struct AudioLevelStats
-    {
-        float rms[2] = {0.0f, 0.0f};
-        float peak[2] = {0.0f, 0.0f};
-        std::vector<float> bands;
-    };
-
     struct AudioLevelConfig
     {
         std::string port = "output"; // "output" or "input"
         std::wstring deviceId;
-
-        int fftSize = 1024;
-        int fftOverlap = 512;
-        int bands = 10;
-
-        double freqMin = 20.0;
-        double freqMax = 20000.0;
-        double sensitivity = 35.0;
-
-        int rmsAttack = 300;
-        int rmsDecay = 300;
-        int peakAttack = 50;
-        int peakDecay = 2500;
-        int fftAttack = 300;
-        int fftDecay = 300;
-
-        double rmsGain = 1.0;
-        double peakGain = 1.0;
+        AudioAnalyzerConfig analysis;
     };
 
-    static float Clamp01(float v)
-    {
-        if (v < 0.0f)
-            return 0.0f;
-        if (v > 1.0f)
-            return 1.0f;
-        return v;
-    }
+    // Frames moved from the ring into the analyzer per Process() call.
+    const size_t kAnalysisBlockFrames = 1024;
+    // Loopback streams only signal while something is rendering, so both
+    // threads also wake on a timeout: capture to poll, analysis to let the
+    // meters fall back during silence.
+    const DWORD kCaptureTimeoutMs = 10;
+    const DWORD kAnalysisTimeoutMs = 20;
+    const REFERENCE_TIME kCaptureBufferDuration = 1000000; // 100 ms
+    // Backoff between attempts to (re)open an endpoint or set up an analyzer.
+    const DWORD kReopenMinMs = 500;
+    const DWORD kReopenMaxMs = 30000;
+    const DWORD kConfigureRetryMinMs = 1000;
+    const DWORD kConfigureRetryMaxMs = 60000;
+    // Streams and analyzers nobody polled for this long are dropped.
+    const ULONGLONG kIdleMs = 10000;
+    const ULONGLONG kPruneIntervalMs = 1000;
 
     static std::wstring Utf8ToWide(const char *s)
     {
@@ -78,408 +73,487 @@ namespace
         return out;
     }
 
-    class AudioLevelAnalyzer
+    /*
+    ** Analyzer for one analysis config on a stream. The analysis thread
+    ** drives 'analyzer' and publishes into 'stats'; the script thread reads
+    ** 'stats' and 'failed' and updates 'lastPolled'.
+    */
+    struct AudioAnalyzerSlot
+    {
+        explicit AudioAnalyzerSlot(const AudioAnalyzerConfig &c) : config(c) {}
+
+        const AudioAnalyzerConfig config;
+        TripleBuffer<AudioLevelStats> stats;
+        std::atomic<bool> failed{false};
+        ULONGLONG lastPolled = 0;
+
+        // Analysis thread only.
+        AudioAnalyzer analyzer;
+        int sampleRate = 0; // rate 'analyzer' is configured for, 0 if not
+        bool settled = false;
+        ULONGLONG retryAt = 0;
+        DWORD retryMs = 0;
+    };
+
+    /*
+    ** One WASAPI endpoint with two worker threads. The capture thread runs
+    ** under MMCSS, opens the endpoint (and reopens it with a backoff after a
+    ** failure), wakes on the stream event, converts packets to stereo float
+    ** and pushes them into an SPSC ring. The analysis thread drains the ring
+    ** through one analyzer per analysis config and publishes each one's stats
+    ** through a triple buffer, so the script thread only ever does a
+    ** wait-free read and never blocks on the device.
+    */
+    class AudioStream
     {
     public:
-        ~AudioLevelAnalyzer() { Release(); }
+        AudioStream(const std::string &port, const std::wstring &deviceId)
+            : m_Port(port), m_DeviceId(deviceId) {}
+        ~AudioStream() { Stop(); }
 
-        bool GetStats(AudioLevelStats &outStats, const AudioLevelConfig &config)
+        AudioStream(const AudioStream &) = delete;
+        AudioStream &operator=(const AudioStream &) = delete;
+
+        bool Start()
         {
-            if (!EnsureInitialized(config))
+            m_StopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+            m_DataEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+            if (!m_StopEvent || !m_DataEvent)
             {
+                CloseEvents();
                 return false;
             }
 
-            PollCapture();
-
-            outStats.rms[0] = Clamp01(m_rms[0] * static_cast<float>(m_config.rmsGain));
-            outStats.rms[1] = Clamp01(m_rms[1] * static_cast<float>(m_config.rmsGain));
-            outStats.peak[0] = Clamp01(m_peak[0] * static_cast<float>(m_config.peakGain));
-            outStats.peak[1] = Clamp01(m_peak[1] * static_cast<float>(m_config.peakGain));
-            outStats.bands = BuildBands(m_config.bands);
+            m_CaptureThread = std::thread([this]()
+                                          { CaptureThread(); });
+            m_AnalysisThread = std::thread([this]()
+                                           { AnalysisThread(); });
             return true;
         }
 
-    private:
-        AudioLevelConfig m_config;
-
-        bool m_comInit = false;
-        IMMDeviceEnumerator *m_enumerator = nullptr;
-        IMMDevice *m_device = nullptr;
-        IAudioClient *m_audioClient = nullptr;
-        IAudioCaptureClient *m_captureClient = nullptr;
-        WAVEFORMATEX *m_pwfx = nullptr;
-
-        int m_channels = 2;
-        int m_sampleRate = 48000;
-        bool m_initialized = false;
-        int m_fftSize = 1024;
-        int m_fftOverlap = 512;
-        int m_fftStride = 512;
-
-        kiss_fftr_cfg m_fftCfg = nullptr;
-        std::vector<float> m_ring;
-        int m_ringWrite = 0;
-        int m_ringFilled = 0;
-        int m_fftCountdown = 512;
-
-        std::vector<float> m_fftWindow;
-        std::vector<float> m_fftIn;
-        std::vector<kiss_fft_cpx> m_fftOut;
-        std::vector<float> m_spectrum;
-
-        float m_rms[2] = {0.0f, 0.0f};
-        float m_peak[2] = {0.0f, 0.0f};
-        float m_kRMS[2] = {0.0f, 0.0f};
-        float m_kPeak[2] = {0.0f, 0.0f};
-        float m_kFFT[2] = {0.0f, 0.0f};
-
-        bool SameConfig(const AudioLevelConfig &c) const
-        {
-            return m_config.port == c.port &&
-                   m_config.deviceId == c.deviceId &&
-                   m_config.fftSize == c.fftSize &&
-                   m_config.fftOverlap == c.fftOverlap &&
-                   m_config.bands == c.bands &&
-                   m_config.freqMin == c.freqMin &&
-                   m_config.freqMax == c.freqMax &&
-                   m_config.sensitivity == c.sensitivity &&
-                   m_config.rmsAttack == c.rmsAttack &&
-                   m_config.rmsDecay == c.rmsDecay &&
-                   m_config.peakAttack == c.peakAttack &&
-                   m_config.peakDecay == c.peakDecay &&
-                   m_config.fftAttack == c.fftAttack &&
-                   m_config.fftDecay == c.fftDecay &&
-                   m_config.rmsGain == c.rmsGain &&
-                   m_config.peakGain == c.peakGain;
-        }
-
-        int NormalizeFFTSize(int n) const
+        void Stop()
         {
-            if (n < 2)
-                n = 1024;
-            if (n % 2 != 0)
-                ++n;
-            return n;
+            if (!m_StopEvent)
+                return;
+            m_StopRequested.store(true, std::memory_order_release);
+            SetEvent(m_StopEvent);
+            if (m_CaptureThread.joinable())
+                m_CaptureThread.join();
+            if (m_AnalysisThread.joinable())
+                m_AnalysisThread.join();
+            CloseEvents();
         }
 
-        int ClampMs(int ms) const { return (ms <= 0) ? 1 : ms; }
+        // Script thread: true while the endpoint could not be opened.
+        bool IsFailed() const { return m_State.load(std::memory_order_acquire) == State::Failed; }
 
-        float CalcSmoothCoeff(int ms) const
+        // Script thread: the analyzer for 'config', added if new.
+        std::shared_ptr<AudioAnalyzerSlot> GetSlot(const AudioAnalyzerConfig &config, ULONGLONG now)
         {
-            const double sr = static_cast<double>(m_sampleRate <= 0 ? 48000 : m_sampleRate);
-            const double t = static_cast<double>(ClampMs(ms)) * 0.001;
-            return static_cast<float>(std::exp(std::log10(0.01) / (sr * t)));
-        }
+            // Only this thread changes m_Slots, so it reads without the lock.
+            for (const auto &slot : m_Slots)
+            {
+                if (slot->config == config)
+                {
+                    slot->lastPolled = now;
+                    return slot;
+                }
+            }
 
-        void RecalculateCoeffs()
-        {
-            m_kRMS[0] = CalcSmoothCoeff(m_config.rmsAttack);
-            m_kRMS[1] = CalcSmoothCoeff(m_config.rmsDecay);
-            m_kPeak[0] = CalcSmoothCoeff(m_config.peakAttack);
-            m_kPeak[1] = CalcSmoothCoeff(m_config.peakDecay);
-
-            const double fftRate = static_cast<double>(m_sampleRate <= 0 ? 48000 : m_sampleRate) /
-                                   static_cast<double>(m_fftStride <= 0 ? 1 : m_fftStride);
-            const auto fftCoeff = [&](int ms) -> float
+            auto slot = std::make_shared<AudioAnalyzerSlot>(config);
+            slot->lastPolled = now;
             {
-                const double t = static_cast<double>(ClampMs(ms)) * 0.001;
-                return static_cast<float>(std::exp(std::log10(0.01) / (fftRate * t)));
-            };
-            m_kFFT[0] = fftCoeff(m_config.fftAttack);
-            m_kFFT[1] = fftCoeff(m_config.fftDecay);
+                std::lock_guard<std::mutex> lock(m_SlotsLock);
+                m_Slots.push_back(slot);
+            }
+            m_SlotsGeneration.fetch_add(1, std::memory_order_release);
+            return slot;
         }
 
-        bool EnsureInitialized(const AudioLevelConfig &config)
+        // Script thread: drops analyzers not polled for 'idleMs'. Returns
+        // false once no analyzer is left.
+        bool PruneSlots(ULONGLONG now, ULONGLONG idleMs)
         {
-            if (m_initialized && SameConfig(config))
-                return true;
-            if (m_initialized)
-                Release();
-            m_config = config;
-
-            const HRESULT hrCom = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
-            if (hrCom == RPC_E_CHANGED_MODE)
+            auto idle = [&](const std::shared_ptr<AudioAnalyzerSlot> &slot)
+            { return now - slot->lastPolled > idleMs; };
+            if (std::any_of(m_Slots.begin(), m_Slots.end(), idle))
             {
-                m_comInit = false;
-            }
-            else if (SUCCEEDED(hrCom))
-            {
-                m_comInit = true;
-            }
-            else
-            {
-                return false;
+                {
+                    std::lock_guard<std::mutex> lock(m_SlotsLock);
+                    m_Slots.erase(std::remove_if(m_Slots.begin(), m_Slots.end(), idle), m_Slots.end());
+                }
+                m_SlotsGeneration.fetch_add(1, std::memory_order_release);
             }
+            return !m_Slots.empty();
+        }
 
-            m_fftSize = NormalizeFFTSize(m_config.fftSize);
-            m_fftOverlap = m_config.fftOverlap;
-            if (m_fftOverlap < 0)
-                m_fftOverlap = m_fftSize / 2;
-            if (m_fftOverlap >= m_fftSize)
-                m_fftOverlap = m_fftSize / 2;
-            m_fftStride = m_fftSize - m_fftOverlap;
-            if (m_fftStride <= 0)
-                m_fftStride = m_fftSize / 2;
-            m_fftCountdown = m_fftStride;
-
-            HRESULT hr = CoCreateInstance(__uuidof(MMDeviceEnumerator), nullptr, CLSCTX_ALL, __uuidof(IMMDeviceEnumerator), reinterpret_cast<void **>(&m_enumerator));
-            if (FAILED(hr) || !m_enumerator)
-                return false;
-
-            EDataFlow dataFlow = (m_config.port == "input") ? eCapture : eRender;
-            if (!m_config.deviceId.empty())
-                hr = m_enumerator->GetDevice(m_config.deviceId.c_str(), &m_device);
-            else
-                hr = m_enumerator->GetDefaultAudioEndpoint(dataFlow, eMultimedia, &m_device);
-            if (FAILED(hr) || !m_device)
-                return false;
-
-            hr = m_device->Activate(__uuidof(IAudioClient), CLSCTX_ALL, nullptr, reinterpret_cast<void **>(&m_audioClient));
-            if (FAILED(hr) || !m_audioClient)
-                return false;
-
-            hr = m_audioClient->GetMixFormat(&m_pwfx);
-            if (FAILED(hr) || !m_pwfx)
-                return false;
+    private:
+        enum class State
+        {
+            Opening,
+            Open,
+            Failed
+        };
 
-            m_sampleRate = static_cast<int>(m_pwfx->nSamplesPerSec);
-            m_channels = static_cast<int>(m_pwfx->nChannels);
-            if (m_channels < 1)
-                m_channels = 1;
-            if (m_channels > 2)
-                m_channels = 2;
+        const std::string m_Port;
+        const std::wstring m_DeviceId;
 
-            DWORD flags = (dataFlow == eRender) ? AUDCLNT_STREAMFLAGS_LOOPBACK : 0;
-            hr = m_audioClient->Initialize(AUDCLNT_SHAREMODE_SHARED, flags, 0, 0, m_pwfx, nullptr);
-            if (FAILED(hr))
-                return false;
+        std::thread m_CaptureThread;
+        std::thread m_AnalysisThread;
+        HANDLE m_StopEvent = nullptr;
+        HANDLE m_DataEvent = nullptr;
+        std::atomic<bool> m_StopRequested{false};
+        std::atomic<State> m_State{State::Opening};
+        std::atomic<int> m_SampleRate{0};
 
-            hr = m_audioClient->GetService(__uuidof(IAudioCaptureClient), reinterpret_cast<void **>(&m_captureClient));
-            if (FAILED(hr) || !m_captureClient)
-                return false;
+        AudioRing m_Ring;
 
-            hr = m_audioClient->Start();
-            if (FAILED(hr))
-                return false;
+        std::mutex m_SlotsLock;
+        std::vector<std::shared_ptr<AudioAnalyzerSlot>> m_Slots;
+        std::atomic<uint32_t> m_SlotsGeneration{0};
 
-            m_fftCfg = kiss_fftr_alloc(m_fftSize, 0, nullptr, nullptr);
-            if (!m_fftCfg)
-                return false;
+        void CloseEvents()
+        {
+            if (m_StopEvent)
+                CloseHandle(m_StopEvent);
+            if (m_DataEvent)
+                CloseHandle(m_DataEvent);
+            m_StopEvent = nullptr;
+            m_DataEvent = nullptr;
+        }
 
-            m_ring.assign(static_cast<size_t>(m_fftSize), 0.0f);
-            m_fftWindow.resize(static_cast<size_t>(m_fftSize));
-            m_fftIn.resize(static_cast<size_t>(m_fftSize));
-            m_fftOut.resize(static_cast<size_t>(m_fftSize));
-            m_spectrum.assign(static_cast<size_t>(m_fftSize / 2 + 1), 0.0f);
+        void CaptureThread()
+        {
+            const HRESULT hrCom = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+            DWORD taskIndex = 0;
+            HANDLE mmcss = AvSetMmThreadCharacteristicsW(L"Pro Audio", &taskIndex);
 
-            for (int i = 0; i < m_fftSize; ++i)
+            // Device removed, format changed or not available yet: try again
+            // later, backing off while the endpoint keeps failing to open.
+            DWORD retryMs = kReopenMinMs;
+            while (!m_StopRequested.load(std::memory_order_acquire))
             {
-                m_fftWindow[static_cast<size_t>(i)] = 0.5f * (1.0f - std::cos(2.0f * 3.1415926535f * i / static_cast<float>(m_fftSize - 1)));
+                const bool opened = SUCCEEDED(hrCom) && RunStream();
+                if (m_StopRequested.load(std::memory_order_acquire))
+                    break;
+                m_State.store(State::Failed, std::memory_order_release);
+                if (opened)
+                    retryMs = kReopenMinMs;
+                if (WaitForSingleObject(m_StopEvent, retryMs) != WAIT_TIMEOUT)
+                    break;
+                if (!opened)
+                    retryMs = std::min(retryMs * 2, kReopenMaxMs);
             }
 
-            RecalculateCoeffs();
-            m_initialized = true;
-            return true;
+            if (mmcss)
+                AvRevertMmThreadCharacteristics(mmcss);
+            if (SUCCEEDED(hrCom))
+                CoUninitialize();
         }
 
-        void Release()
+        // Opens the endpoint and captures until stopped or the stream fails.
+        // Returns false if the endpoint could not be opened.
+        bool RunStream()
         {
-            if (m_audioClient)
-                m_audioClient->Stop();
-            if (m_captureClient)
-            {
-                m_captureClient->Release();
-                m_captureClient = nullptr;
-            }
-            if (m_audioClient)
-            {
-                m_audioClient->Release();
-                m_audioClient = nullptr;
-            }
-            if (m_device)
+            IMMDeviceEnumerator *enumerator = nullptr;
+            IMMDevice *device = nullptr;
+            IAudioClient *audioClient = nullptr;
+            IAudioCaptureClient *captureClient = nullptr;
+            WAVEFORMATEX *pwfx = nullptr;
+            HANDLE bufferEvent = nullptr;
+            bool started = false;
+
+            auto release = [&]()
             {
-                m_device->Release();
-                m_device = nullptr;
-            }
-            if (m_enumerator)
+                if (started)
+                    audioClient->Stop();
+                if (captureClient)
+                    captureClient->Release();
+                if (audioClient)
+                    audioClient->Release();
+                if (device)
+                    device->Release();
+                if (enumerator)
+                    enumerator->Release();
+                if (pwfx)
+                    CoTaskMemFree(pwfx);
+                if (bufferEvent)
+                    CloseHandle(bufferEvent);
+            };
+
+            HRESULT hr = CoCreateInstance(__uuidof(MMDeviceEnumerator), nullptr, CLSCTX_ALL, __uuidof(IMMDeviceEnumerator), reinterpret_cast<void **>(&enumerator));
+
+            const EDataFlow dataFlow = (m_Port == "input") ? eCapture : eRender;
+            if (SUCCEEDED(hr))
             {
-                m_enumerator->Release();
-                m_enumerator = nullptr;
+                if (!m_DeviceId.empty())
+                    hr = enumerator->GetDevice(m_DeviceId.c_str(), &device);
+                else
+                    hr = enumerator->GetDefaultAudioEndpoint(dataFlow, eMultimedia, &device);
             }
-            if (m_pwfx)
+            if (SUCCEEDED(hr))
+                hr = device->Activate(__uuidof(IAudioClient), CLSCTX_ALL, nullptr, reinterpret_cast<void **>(&audioClient));
+            if (SUCCEEDED(hr))
+                hr = audioClient->GetMixFormat(&pwfx);
+            if (SUCCEEDED(hr))
             {
-                CoTaskMemFree(m_pwfx);
-                m_pwfx = nullptr;
+                DWORD flags = AUDCLNT_STREAMFLAGS_EVENTCALLBACK;
+                if (dataFlow == eRender)
+                    flags |= AUDCLNT_STREAMFLAGS_LOOPBACK;
+                hr = audioClient->Initialize(AUDCLNT_SHAREMODE_SHARED, flags, kCaptureBufferDuration, 0, pwfx, nullptr);
             }
-            if (m_fftCfg)
+            if (SUCCEEDED(hr))
             {
-                free(m_fftCfg);
-                m_fftCfg = nullptr;
+                bufferEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+                hr = bufferEvent ? audioClient->SetEventHandle(bufferEvent) : E_OUTOFMEMORY;
             }
-            m_initialized = false;
-            if (m_comInit)
+            if (SUCCEEDED(hr))
+                hr = audioClient->GetService(__uuidof(IAudioCaptureClient), reinterpret_cast<void **>(&captureClient));
+            if (SUCCEEDED(hr))
             {
-                CoUninitialize();
-                m_comInit = false;
+                hr = audioClient->Start();
+                started = SUCCEEDED(hr);
             }
-        }
 
-        void PushMonoSample(float s)
-        {
-            m_ring[static_cast<size_t>(m_ringWrite)] = s;
-            m_ringWrite = (m_ringWrite + 1) % m_fftSize;
-            if (m_ringFilled < m_fftSize)
-                ++m_ringFilled;
-            if (--m_fftCountdown <= 0)
+            if (FAILED(hr))
             {
-                m_fftCountdown = m_fftStride;
-                ComputeFFT();
+                release();
+                return false;
             }
-        }
 
-        void ComputeFFT()
-        {
-            if (m_ringFilled < m_fftSize)
-                return;
-            int idx = m_ringWrite;
-            for (int i = 0; i < m_fftSize; ++i)
-            {
-                m_fftIn[static_cast<size_t>(i)] = m_ring[static_cast<size_t>(idx)] * m_fftWindow[static_cast<size_t>(i)];
-                idx = (idx + 1) % m_fftSize;
-            }
-            kiss_fftr(m_fftCfg, m_fftIn.data(), m_fftOut.data());
-            const int outSize = m_fftSize / 2 + 1;
-            const float scalar = 1.0f / std::sqrt(static_cast<float>(m_fftSize));
-            for (int i = 0; i < outSize; ++i)
-            {
-                const float re = m_fftOut[static_cast<size_t>(i)].r;
-                const float im = m_fftOut[static_cast<size_t>(i)].i;
-                const float mag = std::sqrt(re * re + im * im) * scalar;
-                float &old = m_spectrum[static_cast<size_t>(i)];
-                old = mag + m_kFFT[(mag < old)] * (old - mag);
-            }
-        }
+            const int channels = static_cast<int>(pwfx->nChannels);
+            const bool isFloat = (pwfx->wFormatTag == WAVE_FORMAT_IEEE_FLOAT) || (pwfx->wBitsPerSample == 32);
+            const AudioDsp::SampleFormat format = isFloat ? AudioDsp::SampleFormat::Float32 : AudioDsp::SampleFormat::Int16;
+            m_SampleRate.store(static_cast<int>(pwfx->nSamplesPerSec), std::memory_order_release);
+            m_State.store(State::Open, std::memory_order_release);
 
-        std::vector<float> BuildBands(int bands) const
-        {
-            std::vector<float> out(static_cast<size_t>(bands), 0.0f);
-            if (m_spectrum.empty())
-                return out;
-            const int outSize = static_cast<int>(m_spectrum.size());
-            const double freqMin = m_config.freqMin <= 0.0 ? 20.0 : m_config.freqMin;
-            const double freqMax = (m_config.freqMax <= freqMin) ? 20000.0 : m_config.freqMax;
-            const double sensitivity = (m_config.sensitivity <= 0.0) ? 35.0 : m_config.sensitivity;
-
-            for (int i = 0; i < bands; ++i)
+            std::vector<float> stereo;
+            HANDLE waits[2] = {m_StopEvent, bufferEvent};
+            while (!m_StopRequested.load(std::memory_order_acquire))
             {
-                const double f1 = freqMin * std::pow(freqMax / freqMin, static_cast<double>(i) / static_cast<double>(bands));
-                const double f2 = freqMin * std::pow(freqMax / freqMin, static_cast<double>(i + 1) / static_cast<double>(bands));
-                int idx1 = static_cast<int>(f1 * 2.0 * outSize / static_cast<double>(m_sampleRate));
-                int idx2 = static_cast<int>(f2 * 2.0 * outSize / static_cast<double>(m_sampleRate));
-                if (idx1 < 0)
-                    idx1 = 0;
-                if (idx2 >= outSize)
-                    idx2 = outSize - 1;
-                if (idx2 < idx1)
-                    idx2 = idx1;
-                float maxVal = 0.0f;
-                for (int k = idx1; k <= idx2; ++k)
-                    maxVal = std::max(maxVal, m_spectrum[static_cast<size_t>(k)]);
-                if (maxVal > 0.0f)
+                const DWORD wait = WaitForMultipleObjects(2, waits, FALSE, kCaptureTimeoutMs);
+                if (wait == WAIT_OBJECT_0 || wait == WAIT_FAILED)
+                    break;
+
+                UINT32 packetLength = 0;
+                hr = captureClient->GetNextPacketSize(&packetLength);
+                bool pushed = false;
+                while (SUCCEEDED(hr) && packetLength > 0)
                 {
-                    const float db = 20.0f * std::log10(maxVal);
-                    out[static_cast<size_t>(i)] = Clamp01(1.0f + db / static_cast<float>(sensitivity));
+                    BYTE *data = nullptr;
+                    UINT32 frames = 0;
+                    DWORD bufferFlags = 0;
+                    hr = captureClient->GetBuffer(&data, &frames, &bufferFlags, nullptr, nullptr);
+                    if (FAILED(hr))
+                        break;
+
+                    stereo.resize(static_cast<size_t>(frames) * 2);
+                    if ((bufferFlags & AUDCLNT_BUFFERFLAGS_SILENT) || !data)
+                        std::fill(stereo.begin(), stereo.end(), 0.0f);
+                    else
+                        AudioDsp::ToStereo(data, format, channels, frames, stereo.data());
+                    captureClient->ReleaseBuffer(frames);
+
+                    m_Ring.Write(stereo.data(), stereo.size());
+                    pushed = true;
+                    hr = captureClient->GetNextPacketSize(&packetLength);
                 }
+
+                if (pushed)
+                    SetEvent(m_DataEvent);
+                if (FAILED(hr))
+                    break;
             }
-            return out;
+
+            release();
+            return true;
         }
 
-        void PollCapture()
+        void AnalysisThread()
         {
-            if (!m_captureClient || !m_pwfx)
-                return;
-            UINT32 packetLength = 0;
-            HRESULT hr = m_captureClient->GetNextPacketSize(&packetLength);
-
-            bool hadAudio = false;
-            float sumSq[2] = {0.0f, 0.0f};
-            float peak[2] = {0.0f, 0.0f};
-            uint64_t frameCount = 0;
-
-            while (SUCCEEDED(hr) && packetLength > 0)
+            std::vector<std::shared_ptr<AudioAnalyzerSlot>> slots;
+            uint32_t slotsGeneration = 0;
+            bool haveSlots = false;
+
+            std::vector<float> block(kAnalysisBlockFrames * 2);
+            std::vector<bool> changed;
+            HANDLE waits[2] = {m_StopEvent, m_DataEvent};
+            while (!m_StopRequested.load(std::memory_order_acquire))
             {
-                BYTE *data = nullptr;
-                UINT32 frames = 0;
-                DWORD flags = 0;
-                hr = m_captureClient->GetBuffer(&data, &frames, &flags, nullptr, nullptr);
-                if (FAILED(hr))
+                const DWORD wait = WaitForMultipleObjects(2, waits, FALSE, kAnalysisTimeoutMs);
+                if (wait == WAIT_OBJECT_0 || wait == WAIT_FAILED)
                     break;
 
-                const bool silent = (flags & AUDCLNT_BUFFERFLAGS_SILENT) != 0;
-                const bool isFloat = (m_pwfx->wFormatTag == WAVE_FORMAT_IEEE_FLOAT) || (m_pwfx->wBitsPerSample == 32);
+                const uint32_t generation = m_SlotsGeneration.load(std::memory_order_acquire);
+                if (!haveSlots || generation != slotsGeneration)
+                {
+                    std::lock_guard<std::mutex> lock(m_SlotsLock);
+                    slots = m_Slots;
+                    slotsGeneration = generation;
+                    haveSlots = true;
+                }
 
-                if (!silent && data && frames > 0)
+                // Set up new analyzers, and all of them again when the device
+                // came back at another rate. A failed Configure() is retried
+                // with a backoff rather than on every wake.
+                const int rate = m_SampleRate.load(std::memory_order_acquire);
+                const ULONGLONG now = GetTickCount64();
+                for (const auto &slot : slots)
                 {
-                    hadAudio = true;
-                    if (isFloat)
+                    if (rate <= 0 || slot->sampleRate == rate || now < slot->retryAt)
+                        continue;
+                    if (slot->analyzer.Configure(slot->config, rate))
                     {
-                        const float *in = reinterpret_cast<const float *>(data);
-                        for (UINT32 i = 0; i < frames; ++i)
-                        {
-                            const float l = in[i * m_pwfx->nChannels + 0];
-                            const float r = (m_pwfx->nChannels > 1) ? in[i * m_pwfx->nChannels + 1] : l;
-                            sumSq[0] += l * l;
-                            sumSq[1] += r * r;
-                            peak[0] = std::max(peak[0], std::fabs(l));
-                            peak[1] = std::max(peak[1], std::fabs(r));
-                            PushMonoSample((l + r) * 0.5f);
-                        }
+                        slot->sampleRate = rate;
+                        slot->settled = false;
+                        slot->retryMs = 0;
+                        slot->failed.store(false, std::memory_order_release);
                     }
                     else
                     {
-                        const int16_t *in = reinterpret_cast<const int16_t *>(data);
-                        for (UINT32 i = 0; i < frames; ++i)
+                        slot->sampleRate = 0;
+                        slot->retryMs = slot->retryMs ? std::min(slot->retryMs * 2, kConfigureRetryMaxMs) : kConfigureRetryMinMs;
+                        slot->retryAt = now + slot->retryMs;
+                        slot->failed.store(true, std::memory_order_release);
+                    }
+                }
+
+                auto ready = [&](const AudioAnalyzerSlot &slot)
+                { return rate > 0 && slot.sampleRate == rate; };
+
+                changed.assign(slots.size(), false);
+                if (wait == WAIT_TIMEOUT)
+                {
+                    const size_t silenceFrames = static_cast<size_t>(std::max(rate, 0)) * kAnalysisTimeoutMs / 1000;
+                    for (size_t i = 0; i < slots.size(); ++i)
+                    {
+                        AudioAnalyzerSlot &slot = *slots[i];
+                        if (!ready(slot) || slot.settled)
+                            continue;
+                        slot.analyzer.ProcessSilence(silenceFrames);
+                        slot.settled = slot.analyzer.IsSettled();
+                        changed[i] = true;
+                    }
+                }
+                else
+                {
+                    // The ring is drained even without analyzers, so they
+                    // start from fresh samples.
+                    size_t samples = 0;
+                    while ((samples = m_Ring.Read(block.data(), block.size())) > 0)
+                    {
+                        for (size_t i = 0; i < slots.size(); ++i)
                         {
-                            const float l = static_cast<float>(in[i * m_pwfx->nChannels + 0]) / 32768.0f;
-                            const float r = (m_pwfx->nChannels > 1)
-                                                ? static_cast<float>(in[i * m_pwfx->nChannels + 1]) / 32768.0f
-                                                : l;
-                            sumSq[0] += l * l;
-                            sumSq[1] += r * r;
-                            peak[0] = std::max(peak[0], std::fabs(l));
-                            peak[1] = std::max(peak[1], std::fabs(r));
-                            PushMonoSample((l + r) * 0.5f);
+                            AudioAnalyzerSlot &slot = *slots[i];
+                            if (!ready(slot))
+                                continue;
+                            slot.analyzer.Process(block.data(), samples / 2);
+                            slot.settled = false;
+                            changed[i] = true;
                         }
                     }
-                    frameCount += frames;
                 }
 
-                m_captureClient->ReleaseBuffer(frames);
-                hr = m_captureClient->GetNextPacketSize(&packetLength);
+                for (size_t i = 0; i < slots.size(); ++i)
+                {
+                    if (!changed[i])
+                        continue;
+                    slots[i]->analyzer.GetStats(slots[i]->stats.WriteBuffer());
+                    slots[i]->stats.Publish();
+                }
             }
+        }
+    };
 
-            if (hadAudio && frameCount > 0)
+    /*
+    ** Streams by (port, device), each shared by every analysis config polled
+    ** on it. A stream or analyzer nobody polled for kIdleMs is dropped.
+    */
+    class AudioLevelCapture
+    {
+    public:
+        ~AudioLevelCapture() { Stop(); }
+
+        // Script thread: latest stats for 'config'. Returns false while the
+        // endpoint cannot be opened or the analyzer cannot be set up.
+        bool GetStats(AudioLevelStats &outStats, const AudioLevelConfig &config)
+        {
+            const ULONGLONG now = GetTickCount64();
+            if (now - m_LastPrune >= kPruneIntervalMs)
             {
-                const float n = static_cast<float>(frameCount);
-                const float rmsNow0 = std::sqrt(sumSq[0] / n);
-                const float rmsNow1 = std::sqrt(sumSq[1] / n);
-                m_rms[0] = Clamp01(rmsNow0 + m_kRMS[(rmsNow0 < m_rms[0])] * (m_rms[0] - rmsNow0));
-                m_rms[1] = Clamp01(rmsNow1 + m_kRMS[(rmsNow1 < m_rms[1])] * (m_rms[1] - rmsNow1));
-                m_peak[0] = Clamp01(peak[0] + m_kPeak[(peak[0] < m_peak[0])] * (m_peak[0] - peak[0]));
-                m_peak[1] = Clamp01(peak[1] + m_kPeak[(peak[1] < m_peak[1])] * (m_peak[1] - peak[1]));
+                Prune(now);
+                m_LastPrune = now;
+            }
+
+            const StreamKey key(config.port, config.deviceId);
+            auto it = m_Streams.find(key);
+            if (it == m_Streams.end())
+            {
+                auto stream = std::make_unique<AudioStream>(config.port, config.deviceId);
+                if (!stream->Start())
+                    return false;
+                it = m_Streams.emplace(key, std::move(stream)).first;
+            }
+
+            AudioStream &stream = *it->second;
+            const std::shared_ptr<AudioAnalyzerSlot> slot = stream.GetSlot(config.analysis, now);
+            if (stream.IsFailed() || slot->failed.load(std::memory_order_acquire))
+                return false;
+
+            const AudioLevelStats *latest = slot->stats.Read();
+            if (latest)
+            {
+                outStats = *latest;
             }
             else
             {
-                m_rms[0] *= m_kRMS[1];
-                m_rms[1] *= m_kRMS[1];
-                m_peak[0] *= m_kPeak[1];
-                m_peak[1] *= m_kPeak[1];
+                const AudioAnalyzerConfig &analysis = config.analysis;
+                outStats = AudioLevelStats();
+                if (analysis.mode == AudioAnalysisMode::Waveform)
+                    outStats.waveform.assign(static_cast<size_t>(std::max(analysis.waveformPoints, 0)) * 2, 0.0f);
+                else
+                    outStats.bands.assign(static_cast<size_t>(std::max(analysis.bands, 0)), 0.0f);
+            }
+            return true;
+        }
+
+        void Stop()
+        {
+            m_Streams.clear();
+        }
+
+    private:
+        typedef std::pair<std::string, std::wstring> StreamKey;
+
+        std::map<StreamKey, std::unique_ptr<AudioStream>> m_Streams;
+        ULONGLONG m_LastPrune = 0;
+
+        void Prune(ULONGLONG now)
+        {
+            for (auto it = m_Streams.begin(); it != m_Streams.end();)
+            {
+                if (it->second->PruneSlots(now, kIdleMs))
+                    ++it;
+                else
+                    it = m_Streams.erase(it);
             }
         }
     };
 
-    AudioLevelAnalyzer g_audioLevelAnalyzer;
+    AudioLevelCapture g_audioLevelCapture;
+
+    AudioAnalysisMode ParseAnalysisMode(const std::string &mode)
+    {
+        if (mode == "cqt" || mode == "constantQ")
+            return AudioAnalysisMode::ConstantQ;
+        if (mode == "mel")
+            return AudioAnalysisMode::Mel;
+        if (mode == "bark")
+            return AudioAnalysisMode::Bark;
+        if (mode == "waveform")
+            return AudioAnalysisMode::Waveform;
+        return AudioAnalysisMode::Bands;
+    }
 
     int JsAudioLevelStats(novadesk_context ctx)
     {
@@ -539,26 +613,31 @@ namespace
 
         if (hasOptionsObject)
         {
+            std::string mode;
             readPropString("port", cfg.port);
+            readPropString("mode", mode);
+            cfg.analysis.mode = ParseAnalysisMode(mode);
             readPropWString("deviceId", cfg.deviceId);
-            readPropInt("fftSize", cfg.fftSize);
-            readPropInt("fftOverlap", cfg.fftOverlap);
-            readPropInt("bands", cfg.bands);
-            readPropDouble("freqMin", cfg.freqMin);
-            readPropDouble("freqMax", cfg.freqMax);
-            readPropDouble("sensitivity", cfg.sensitivity);
-            readPropInt("rmsAttack", cfg.rmsAttack);
-            readPropInt("rmsDecay", cfg.rmsDecay);
-            readPropInt("peakAttack", cfg.peakAttack);
-            readPropInt("peakDecay", cfg.peakDecay);
-            readPropInt("fftAttack", cfg.fftAttack);
-            readPropInt("fftDecay", cfg.fftDecay);
-            readPropDouble("rmsGain", cfg.rmsGain);
-            readPropDouble("peakGain", cfg.peakGain);
+            readPropInt("fftSize", cfg.analysis.fftSize);
+            readPropInt("fftOverlap", cfg.analysis.fftOverlap);
+            readPropInt("bands", cfg.analysis.bands);
+            readPropDouble("freqMin", cfg.analysis.freqMin);
+            readPropDouble("freqMax", cfg.analysis.freqMax);
+            readPropDouble("sensitivity", cfg.analysis.sensitivity);
+            readPropInt("rmsAttack", cfg.analysis.rmsAttack);
+            readPropInt("rmsDecay", cfg.analysis.rmsDecay);
+            readPropInt("peakAttack", cfg.analysis.peakAttack);
+            readPropInt("peakDecay", cfg.analysis.peakDecay);
+            readPropInt("fftAttack", cfg.analysis.fftAttack);
+            readPropInt("fftDecay", cfg.analysis.fftDecay);
+            readPropDouble("rmsGain", cfg.analysis.rmsGain);
+            readPropDouble("peakGain", cfg.analysis.peakGain);
+            readPropInt("waveformPoints", cfg.analysis.waveformPoints);
+            readPropInt("waveformDuration", cfg.analysis.waveformDuration);
         }
 
         AudioLevelStats stats;
-        if (!g_audioLevelAnalyzer.GetStats(stats, cfg))
+        if (!g_audioLevelCapture.GetStats(stats, cfg))
         {
             g_Host->PushNull(ctx);
             return 1;
@@ -572,11 +651,21 @@ namespace
         double peakVals[2] = {stats.peak[0], stats.peak[1]};
         g_Host->RegisterArrayNumber(ctx, "peak", peakVals, 2);
 
-        std::vector<double> bandVals;
-        bandVals.reserve(stats.bands.size());
-        for (float v : stats.bands)
-            bandVals.push_back(static_cast<double>(v));
-        g_Host->RegisterArrayNumber(ctx, "bands", bandVals.data(), bandVals.size());
+        // The original band mode keeps returning a plain array; the newer
+        // modes hand their output over as one Float32Array copy where the
+        // host has typed arrays.
+        const bool waveform = cfg.analysis.mode == AudioAnalysisMode::Waveform;
+        const std::vector<float> &values = waveform ? stats.waveform : stats.bands;
+        const char *name = waveform ? "waveform" : "bands";
+        if (cfg.analysis.mode != AudioAnalysisMode::Bands && NOVADESK_HOST_HAS(g_Host, RegisterArrayFloat32))
+        {
+            g_Host->RegisterArrayFloat32(ctx, name, values.data(), values.size());
+        }
+        else
+        {
+            std::vector<double> numberVals(values.begin(), values.end());
+            g_Host->RegisterArrayNumber(ctx, name, numberVals.data(), numberVals.size());
+        }
 
         return 1;
     }
@@ -596,4 +685,5 @@ NOVADESK_ADDON_INIT(ctx, hMsgWnd, host)
 
 NOVADESK_ADDON_UNLOAD()
 {
+    g_audioLevelCapture.Stop();
 }
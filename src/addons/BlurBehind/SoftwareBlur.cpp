@@ -0,0 +1,112 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "SoftwareBlur.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "../../apps/novadesk/core/PixelKernels.h"
+
+namespace SoftwareBlur
+{
+    bool CaptureBackdrop(const RECT &rect, std::vector<uint8_t> &outPixels, int &outWidth, int &outHeight)
+    {
+        const int width = (std::min)(static_cast<int>(rect.right - rect.left), kMaxSide);
+        const int height = (std::min)(static_cast<int>(rect.bottom - rect.top), kMaxSide);
+        if (width <= 0 || height <= 0)
+            return false;
+
+        HDC screen = GetDC(nullptr);
+        if (!screen)
+            return false;
+        HDC memory = CreateCompatibleDC(screen);
+
+        BITMAPINFO info = {};
+        info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+        info.bmiHeader.biWidth = width;
+        info.bmiHeader.biHeight = -height; // top-down
+        info.bmiHeader.biPlanes = 1;
+        info.bmiHeader.biBitCount = 32;
+        info.bmiHeader.biCompression = BI_RGB;
+        void *bits = nullptr;
+        HBITMAP bitmap = memory ? CreateDIBSection(screen, &info, DIB_RGB_COLORS, &bits, nullptr, 0) : nullptr;
+
+        bool ok = false;
+        if (bitmap && bits)
+        {
+            HGDIOBJ old = SelectObject(memory, bitmap);
+            // No CAPTUREBLT: layered windows stay out of the copy.
+            ok = BitBlt(memory, 0, 0, width, height, screen, rect.left, rect.top, SRCCOPY) != FALSE;
+            SelectObject(memory, old);
+            GdiFlush();
+
+            if (ok)
+            {
+                const size_t count = static_cast<size_t>(width) * static_cast<size_t>(height);
+                outPixels.resize(count * 4);
+                std::memcpy(outPixels.data(), bits, outPixels.size());
+                for (size_t i = 0; i < count; ++i)
+                    outPixels[i * 4 + 3] = 255;
+                outWidth = width;
+                outHeight = height;
+            }
+        }
+
+        if (bitmap)
+            DeleteObject(bitmap);
+        if (memory)
+            DeleteDC(memory);
+        ReleaseDC(nullptr, screen);
+        return ok;
+    }
+
+    void Blur(std::vector<uint8_t> &pixels, int width, int height, int radius)
+    {
+        radius = (std::max)(1, (std::min)(radius, kMaxRadius));
+        const int passRadius = (std::max)(1, (radius + 2) / 3);
+        std::vector<uint32_t> scratch;
+        for (int pass = 0; pass < 3; ++pass)
+            PixelKernels::BoxBlur(pixels.data(), width, height, width * 4, passRadius, scratch);
+    }
+
+    void EncodeBmp(const std::vector<uint8_t> &pixels, int width, int height, std::vector<uint8_t> &outFile)
+    {
+        const size_t rowBytes = (static_cast<size_t>(width) * 3 + 3) & ~static_cast<size_t>(3);
+        const size_t headerBytes = sizeof(BITMAPFILEHEADER) + sizeof(BITMAPINFOHEADER);
+        outFile.assign(headerBytes + rowBytes * static_cast<size_t>(height), 0);
+
+        BITMAPFILEHEADER file = {};
+        file.bfType = 0x4D42; // "BM"
+        file.bfSize = static_cast<DWORD>(outFile.size());
+        file.bfOffBits = static_cast<DWORD>(headerBytes);
+
+        BITMAPINFOHEADER info = {};
+        info.biSize = sizeof(BITMAPINFOHEADER);
+        info.biWidth = width;
+        info.biHeight = height; // bottom-up
+        info.biPlanes = 1;
+        info.biBitCount = 24;
+        info.biCompression = BI_RGB;
+        info.biSizeImage = static_cast<DWORD>(rowBytes * static_cast<size_t>(height));
+
+        std::memcpy(outFile.data(), &file, sizeof(file));
+        std::memcpy(outFile.data() + sizeof(file), &info, sizeof(info));
+
+        for (int y = 0; y < height; ++y)
+        {
+            const uint8_t *src = pixels.data() + static_cast<size_t>(height - 1 - y) * static_cast<size_t>(width) * 4;
+            uint8_t *dst = outFile.data() + headerBytes + static_cast<size_t>(y) * rowBytes;
+            for (int x = 0; x < width; ++x)
+            {
+                dst[x * 3] = src[x * 4];
+                dst[x * 3 + 1] = src[x * 4 + 1];
+                dst[x * 3 + 2] = src[x * 4 + 2];
+            }
+        }
+    }
+}
@@ -0,0 +1,33 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#pragma once
+
+#include <Windows.h>
+#include <cstdint>
+#include <vector>
+
+/*
+** Software blur-behind for when DWM acrylic is too costly: a one-off copy
+** of the screen under a widget, blurred on the CPU with the host's SIMD box
+** blur and encoded for the host image store.
+*/
+namespace SoftwareBlur
+{
+    constexpr int kMaxRadius = 64;
+    constexpr int kMaxSide = 4096;
+
+    // Copy the screen inside 'rect' as opaque BGRA. Layered windows (every
+    // widget) are left out, so a widget sees what is behind it.
+    bool CaptureBackdrop(const RECT &rect, std::vector<uint8_t> &outPixels, int &outWidth, int &outHeight);
+
+    // Three box passes whose reach adds up to 'radius', close to a Gaussian.
+    void Blur(std::vector<uint8_t> &pixels, int width, int height, int radius);
+
+    // 24-bit BMP file bytes of opaque BGRA pixels.
+    void EncodeBmp(const std::vector<uint8_t> &pixels, int width, int height, std::vector<uint8_t> &outFile);
+}
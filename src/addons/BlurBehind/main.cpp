@@ -3,11 +3,17 @@
 #include <Windows.h>
 #include <VersionHelpers.h>
 #include <cstdint>
+#include <cstdio>
 #include <cstdlib>
 #include <string>
 #include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include "SoftwareBlur.h"
 
 const NovadeskHostAPI* g_Host = nullptr;
+static HWND g_MessageWindow = nullptr;
 HMODULE g_User32 = nullptr;
 HMODULE g_DwmApi = nullptr;
 
@@ -111,6 +117,162 @@ static bool SetWindowCorner(HWND hwnd, DwmWindowCornerPreference corner) {
     return SUCCEEDED(g_DwmSetWindowAttribute(hwnd, DWMWA_WINDOW_CORNER_PREFERENCE_VALUE, &corner, sizeof(corner)));
 }
 
+// Desired composition per window, and what DWM was last told. Only the
+// difference is sent, so re-applying the same look on every refresh costs
+// nothing. apply/disable/setCorner send it at once and report the result;
+// queue() records it and Flush() sends every queued change once per turn of
+// the main loop, counting failures in stats().
+struct CompositionState {
+    bool hasAccent = false;
+    AccentState accent = AccentState::DISABLED;
+    bool hasCorner = false;
+    DwmWindowCornerPreference corner = DWMWCP_DEFAULT;
+    // applied only: DWM refused 'corner' (Windows 10 has no corner attribute).
+    // It is not asked again until a different corner is wanted.
+    bool cornerRefused = false;
+};
+
+struct TrackedWindow {
+    CompositionState desired;
+    CompositionState applied;
+    bool dirty = false;
+};
+
+// Set on every window we changed. A window created later under a recycled
+// handle lacks it, so its stale applied state is not trusted.
+static const wchar_t* kAppliedProp = L"NovadeskBlurBehind.Applied";
+
+static std::unordered_map<HWND, TrackedWindow> g_Windows;
+static bool g_FlushPending = false;
+
+struct BlurStats {
+    double flushes = 0;
+    double accentCalls = 0;
+    double cornerCalls = 0;
+    double skipped = 0;
+    double failed = 0;      // queued changes DWM refused
+    double lastFailed = 0;  // handle of the last one, 0 if none
+};
+static BlurStats g_Stats;
+
+struct SendResult {
+    bool accentOk = true;
+    bool cornerOk = true;
+    bool touched = false;   // DWM took at least one change
+};
+
+// Send what differs between desired and applied.
+static SendResult SendChanges(HWND hwnd, TrackedWindow& w) {
+    w.dirty = false;
+    if (!GetPropW(hwnd, kAppliedProp)) {
+        w.applied = CompositionState();
+    }
+
+    SendResult result;
+    if (w.desired.hasAccent && (!w.applied.hasAccent || w.applied.accent != w.desired.accent)) {
+        // Going through DISABLED makes DWM pick up a changed accent.
+        bool accentOk = SetAccent(hwnd, 0, AccentState::DISABLED);
+        if (accentOk && w.desired.accent != AccentState::DISABLED) {
+            accentOk = SetAccent(hwnd, 0, w.desired.accent);
+        }
+        ++g_Stats.accentCalls;
+        if (accentOk) {
+            w.applied.hasAccent = true;
+            w.applied.accent = w.desired.accent;
+            result.touched = true;
+        }
+        result.accentOk = accentOk;
+    }
+    bool refused = false;
+    if (w.desired.hasCorner && (!w.applied.hasCorner || w.applied.corner != w.desired.corner)) {
+        ++g_Stats.cornerCalls;
+        refused = !SetWindowCorner(hwnd, w.desired.corner);
+        w.applied.hasCorner = true;
+        w.applied.corner = w.desired.corner;
+        w.applied.cornerRefused = refused;
+        result.touched |= !refused;
+        result.cornerOk = !refused;
+    }
+
+    if (result.touched || refused) {
+        SetPropW(hwnd, kAppliedProp, reinterpret_cast<HANDLE>(1));
+    }
+    return result;
+}
+
+static int Flush() {
+    g_FlushPending = false;
+    ++g_Stats.flushes;
+
+    int changed = 0;
+    for (auto it = g_Windows.begin(); it != g_Windows.end();) {
+        HWND hwnd = it->first;
+        TrackedWindow& w = it->second;
+        if (!IsWindow(hwnd)) {
+            it = g_Windows.erase(it);
+            continue;
+        }
+        ++it;
+        if (!w.dirty) continue;
+
+        const SendResult result = SendChanges(hwnd, w);
+        if (!result.accentOk || !result.cornerOk) {
+            ++g_Stats.failed;
+            g_Stats.lastFailed = static_cast<double>(reinterpret_cast<uintptr_t>(hwnd));
+        }
+        if (result.touched) ++changed;
+    }
+    return changed;
+}
+
+static void FlushFromMain(novadesk_context, void*) {
+    Flush();
+}
+
+static void FlushFromDispatch(void*) {
+    Flush();
+}
+
+static bool SameAsApplied(HWND hwnd, const TrackedWindow& w) {
+    const bool accentDone = !w.desired.hasAccent || (w.applied.hasAccent && w.applied.accent == w.desired.accent);
+    const bool cornerDone = !w.desired.hasCorner || (w.applied.hasCorner && w.applied.corner == w.desired.corner);
+    return accentDone && cornerDone && GetPropW(hwnd, kAppliedProp) != nullptr;
+}
+
+// apply/disable/setCorner: send the change now. A look DWM already has, or
+// a corner it already refused, is not sent again.
+static SendResult Commit(HWND hwnd, TrackedWindow& w) {
+    SendResult result;
+    if (SameAsApplied(hwnd, w)) {
+        w.dirty = false;
+        ++g_Stats.skipped;
+    } else {
+        result = SendChanges(hwnd, w);
+    }
+    result.cornerOk = !w.desired.hasCorner || !w.applied.cornerRefused;
+    return result;
+}
+
+// queue(): record the change and make sure one flush is on its way.
+static void Schedule(HWND hwnd, TrackedWindow& w) {
+    if (SameAsApplied(hwnd, w)) {
+        w.dirty = false;
+        ++g_Stats.skipped;
+        return;
+    }
+    w.dirty = true;
+    if (g_FlushPending) return;
+
+    if (NOVADESK_HOST_HAS(g_Host, PostToMain) && g_Host->PostToMain(&FlushFromMain, nullptr)) {
+        g_FlushPending = true;
+    } else if (g_MessageWindow) {
+        novadesk::Dispatcher(g_MessageWindow).Dispatch(&FlushFromDispatch);
+        g_FlushPending = true;
+    } else {
+        Flush();
+    }
+}
+
 static HWND ReadHwndArg(novadesk_context ctx, int idx) {
     if (g_Host->IsString(ctx, idx)) {
         const char* s = g_Host->GetString(ctx, idx);
@@ -235,15 +397,21 @@ static int JsApply(novadesk_context ctx) {
     int base = (hwndIdx >= 0) ? hwndIdx : ResolveArgBase(ctx);
     AccentState state = ReadAccentArg(ctx, base + 1);
     DwmWindowCornerPreference corner = ReadCornerArg(ctx, base + 2);
+    if (!LoadApis()) {
+        g_Host->PushBool(ctx, 0);
+        return 1;
+    }
 
-    bool ok = SetAccent(hwnd, 0, AccentState::DISABLED) && SetAccent(hwnd, 0, state);
-    if (ok && corner != DWMWCP_DEFAULT && corner != DWMWCP_DONOTROUND) {
-        SetWindowCorner(hwnd, corner);
-    } else if (ok && corner == DWMWCP_DONOTROUND) {
-        SetWindowCorner(hwnd, DWMWCP_DONOTROUND);
+    TrackedWindow& w = g_Windows[hwnd];
+    w.desired.hasAccent = true;
+    w.desired.accent = state;
+    if (corner != DWMWCP_DEFAULT) {
+        w.desired.hasCorner = true;
+        w.desired.corner = corner;
     }
 
-    g_Host->PushBool(ctx, ok ? 1 : 0);
+    // Only the accent decides the result; setCorner() reports a refused corner.
+    g_Host->PushBool(ctx, Commit(hwnd, w).accentOk ? 1 : 0);
     return 1;
 }
 
@@ -254,8 +422,16 @@ static int JsDisable(novadesk_context ctx) {
         g_Host->ThrowError(ctx, "disable(hwnd): invalid hwnd");
         return 0;
     }
-    bool ok = SetAccent(hwnd, 0, AccentState::DISABLED);
-    g_Host->PushBool(ctx, ok ? 1 : 0);
+    if (!LoadApis()) {
+        g_Host->PushBool(ctx, 0);
+        return 1;
+    }
+
+    TrackedWindow& w = g_Windows[hwnd];
+    w.desired.hasAccent = true;
+    w.desired.accent = AccentState::DISABLED;
+
+    g_Host->PushBool(ctx, Commit(hwnd, w).accentOk ? 1 : 0);
     return 1;
 }
 
@@ -269,24 +445,149 @@ static int JsSetCorner(novadesk_context ctx) {
 
     int base = (hwndIdx >= 0) ? hwndIdx : ResolveArgBase(ctx);
     DwmWindowCornerPreference corner = ReadCornerArg(ctx, base + 1);
-    bool ok = SetWindowCorner(hwnd, corner);
-    g_Host->PushBool(ctx, ok ? 1 : 0);
+    if (!g_DwmSetWindowAttribute) {
+        g_Host->PushBool(ctx, 0);
+        return 1;
+    }
+
+    TrackedWindow& w = g_Windows[hwnd];
+    w.desired.hasCorner = true;
+    w.desired.corner = corner;
+
+    g_Host->PushBool(ctx, Commit(hwnd, w).cornerOk ? 1 : 0);
+    return 1;
+}
+
+// queue(hwnd, type?, corner?): batched apply for scripts that restyle many
+// windows or restyle often. The change is sent with every other queued one
+// at the end of the turn; true once queued. 'type' may be "none" to disable;
+// a missing or null type or corner leaves that part as it is. Failures show
+// up in stats().failed / stats().lastFailed.
+static int JsQueue(novadesk_context ctx) {
+    int hwndIdx = -1;
+    HWND hwnd = FindHwndArg(ctx, &hwndIdx);
+    if (!hwnd) {
+        g_Host->ThrowError(ctx, "queue(hwnd, type?, corner?): invalid hwnd");
+        return 0;
+    }
+    if (!LoadApis()) {
+        g_Host->PushBool(ctx, 0);
+        return 1;
+    }
+
+    int base = (hwndIdx >= 0) ? hwndIdx : ResolveArgBase(ctx);
+    const bool hasType = g_Host->GetTop(ctx) > base + 1 && g_Host->IsString(ctx, base + 1);
+    const bool hasCorner = g_Host->GetTop(ctx) > base + 2 && g_Host->IsString(ctx, base + 2);
+
+    TrackedWindow& w = g_Windows[hwnd];
+    if (hasType) {
+        w.desired.hasAccent = true;
+        w.desired.accent = ReadAccentArg(ctx, base + 1);
+    }
+    if (hasCorner && g_DwmSetWindowAttribute) {
+        w.desired.hasCorner = true;
+        w.desired.corner = ReadCornerArg(ctx, base + 2);
+    }
+    Schedule(hwnd, w);
+
+    g_Host->PushBool(ctx, 1);
+    return 1;
+}
+
+// Send queued changes now instead of at the end of the turn. Returns the
+// number of windows that changed.
+static int JsFlush(novadesk_context ctx) {
+    g_Host->PushNumber(ctx, static_cast<double>(Flush()));
+    return 1;
+}
+
+static int JsStats(novadesk_context ctx) {
+    g_Host->PushObject(ctx);
+    g_Host->RegisterNumber(ctx, "windows", static_cast<double>(g_Windows.size()));
+    g_Host->RegisterNumber(ctx, "flushes", g_Stats.flushes);
+    g_Host->RegisterNumber(ctx, "accentCalls", g_Stats.accentCalls);
+    g_Host->RegisterNumber(ctx, "cornerCalls", g_Stats.cornerCalls);
+    g_Host->RegisterNumber(ctx, "skipped", g_Stats.skipped);
+    g_Host->RegisterNumber(ctx, "failed", g_Stats.failed);
+    g_Host->RegisterNumber(ctx, "lastFailed", g_Stats.lastFailed);
+    return 1;
+}
+
+// captureBlur(hwnd, radius?): software fallback for when acrylic is too
+// costly. Copies the screen under the window once, blurs it and stores it
+// as an image; returns { path, width, height } for an image element, or
+// null if the capture failed. Call again after the widget moves.
+static int JsCaptureBlur(novadesk_context ctx) {
+    int hwndIdx = -1;
+    HWND hwnd = FindHwndArg(ctx, &hwndIdx);
+    if (!hwnd) {
+        g_Host->ThrowError(ctx, "captureBlur(hwnd, radius?): invalid hwnd");
+        return 0;
+    }
+    if (!NOVADESK_HOST_HAS(g_Host, StoreImage)) {
+        g_Host->ThrowError(ctx, "captureBlur(hwnd, radius?): host has no image store");
+        return 0;
+    }
+
+    int base = (hwndIdx >= 0) ? hwndIdx : ResolveArgBase(ctx);
+    int radius = 16;
+    if (g_Host->GetTop(ctx) > base + 1 && g_Host->IsNumber(ctx, base + 1)) {
+        radius = static_cast<int>(g_Host->GetNumber(ctx, base + 1));
+    }
+
+    RECT rect = {};
+    std::vector<uint8_t> pixels;
+    int width = 0;
+    int height = 0;
+    if (!GetWindowRect(hwnd, &rect) || !SoftwareBlur::CaptureBackdrop(rect, pixels, width, height)) {
+        g_Host->PushNull(ctx);
+        return 1;
+    }
+    SoftwareBlur::Blur(pixels, width, height, radius);
+
+    std::vector<uint8_t> bmp;
+    SoftwareBlur::EncodeBmp(pixels, width, height, bmp);
+
+    // A new path per capture so elements showing the previous one reload.
+    static unsigned long long s_Capture = 0;
+    char path[96];
+    snprintf(path, sizeof(path), "memory://blurbehind/%llx-%llu.bmp",
+        static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(hwnd)), ++s_Capture);
+    if (!g_Host->StoreImage(ctx, path, bmp.data(), bmp.size())) {
+        g_Host->PushNull(ctx);
+        return 1;
+    }
+
+    g_Host->PushObject(ctx);
+    g_Host->RegisterString(ctx, "path", path);
+    g_Host->RegisterNumber(ctx, "width", static_cast<double>(width));
+    g_Host->RegisterNumber(ctx, "height", static_cast<double>(height));
     return 1;
 }
 
 NOVADESK_ADDON_INIT(ctx, hMsgWnd, host) {
-    (void)hMsgWnd;
     g_Host = host;
+    g_MessageWindow = hMsgWnd;
     LoadApis();
 
     novadesk::Addon addon(ctx, host);
     addon.RegisterString("name", "BlurBehind");
-    addon.RegisterString("version", "2.0.0");
+    addon.RegisterString("version", "2.2.0");
     addon.RegisterFunction("apply", JsApply, 3);
     addon.RegisterFunction("disable", JsDisable, 1);
     addon.RegisterFunction("setCorner", JsSetCorner, 2);
+    addon.RegisterFunction("queue", JsQueue, 3);
+    addon.RegisterFunction("flush", JsFlush, 0);
+    addon.RegisterFunction("stats", JsStats, 0);
+    addon.RegisterFunction("captureBlur", JsCaptureBlur, 2);
 }
 
 NOVADESK_ADDON_UNLOAD() {
+    for (auto& kv : g_Windows) {
+        if (IsWindow(kv.first)) RemovePropW(kv.first, kAppliedProp);
+    }
+    g_Windows.clear();
+    g_FlushPending = false;
+    g_Stats = BlurStats();
     UnloadApis();
 }
@@ -0,0 +1,461 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "BrightnessService.h"
+
+#include <HighLevelMonitorConfigurationAPI.h>
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace
+{
+    const wchar_t *kWindowClass = L"NovadeskBrightnessWatcher";
+
+    int ToPercent(uint32_t min, uint32_t max, uint32_t value)
+    {
+        if (max <= min)
+            return 0;
+        const long percent = std::lround((static_cast<double>(value) - min) * 100.0 / (max - min));
+        return static_cast<int>((std::min)(100L, (std::max)(0L, percent)));
+    }
+
+    bool SameReading(const BrightnessInfo &a, const BrightnessInfo &b)
+    {
+        return a.supported == b.supported && a.current == b.current && a.min == b.min && a.max == b.max;
+    }
+
+    BOOL CALLBACK CollectMonitor(HMONITOR monitor, HDC, LPRECT, LPARAM data)
+    {
+        reinterpret_cast<std::vector<HMONITOR> *>(data)->push_back(monitor);
+        return TRUE;
+    }
+
+    bool IsPrimary(HMONITOR monitor)
+    {
+        MONITORINFO info{};
+        info.cbSize = sizeof(info);
+        return GetMonitorInfoW(monitor, &info) && (info.dwFlags & MONITORINFOF_PRIMARY);
+    }
+}
+
+BrightnessService::BrightnessService(ChangeCallback onChange)
+    : m_onChange(std::move(onChange))
+{
+    m_wakeEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    m_worker = std::thread(&BrightnessService::WorkerThread, this);
+}
+
+BrightnessService::~BrightnessService()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    Wake();
+    if (m_worker.joinable())
+        m_worker.join();
+    if (m_wakeEvent)
+        CloseHandle(m_wakeEvent);
+}
+
+bool BrightnessService::Get(int display, BrightnessInfo &outInfo)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_ready)
+    {
+        outInfo = BrightnessInfo{};
+        outInfo.pending = display >= 0 && m_pendingSets.count(static_cast<size_t>(display)) != 0;
+        return false;
+    }
+    if (display < 0 || static_cast<size_t>(display) >= m_values.size())
+        return false;
+
+    const size_t index = static_cast<size_t>(display);
+    outInfo = m_values[index];
+    outInfo.pending = m_pendingSets.count(index) != 0;
+    outInfo.ready = true;
+
+    if (outInfo.supported && GetTickCount64() - m_readTicks[index] >= kRefreshInterval &&
+        m_pendingReads.insert(index).second)
+    {
+        lock.unlock();
+        Wake();
+    }
+    return true;
+}
+
+bool BrightnessService::Set(int display, int percent)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (display < 0 || (m_ready && (static_cast<size_t>(display) >= m_values.size() || !m_values[display].supported)))
+            return false;
+        m_pendingSets[static_cast<size_t>(display)] = (std::min)(100, (std::max)(0, percent));
+    }
+    Wake();
+    return true;
+}
+
+int BrightnessService::GetDisplayCount()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<int>(m_values.size());
+}
+
+void BrightnessService::Wake()
+{
+    if (m_wakeEvent)
+        SetEvent(m_wakeEvent);
+}
+
+LRESULT CALLBACK BrightnessService::WindowProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
+{
+    if (msg == WM_NCCREATE)
+    {
+        const auto *create = reinterpret_cast<CREATESTRUCTW *>(lParam);
+        SetWindowLongPtrW(hWnd, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(create->lpCreateParams));
+    }
+    else if (msg == WM_DISPLAYCHANGE)
+    {
+        // Runs on the worker while it pumps messages.
+        if (auto *self = reinterpret_cast<BrightnessService *>(GetWindowLongPtrW(hWnd, GWLP_USERDATA)))
+        {
+            std::lock_guard<std::mutex> lock(self->m_mutex);
+            self->m_invalidated = true;
+        }
+    }
+    return DefWindowProcW(hWnd, msg, wParam, lParam);
+}
+
+void BrightnessService::WorkerThread()
+{
+    // WM_DISPLAYCHANGE is only broadcast to top-level windows, so this is a
+    // hidden popup rather than a message-only window.
+    HINSTANCE instance = nullptr;
+    GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                       reinterpret_cast<LPCWSTR>(&BrightnessService::WindowProc), &instance);
+    WNDCLASSEXW wc{};
+    wc.cbSize = sizeof(wc);
+    wc.lpfnWndProc = &BrightnessService::WindowProc;
+    wc.hInstance = instance;
+    wc.lpszClassName = kWindowClass;
+    RegisterClassExW(&wc);
+    m_window = CreateWindowExW(WS_EX_TOOLWINDOW, kWindowClass, L"", WS_POPUP, 0, 0, 0, 0, nullptr, nullptr, instance, this);
+
+    bool enumerate = true;
+    while (true)
+    {
+        std::map<size_t, int> sets;
+        std::set<size_t> reads;
+
+        if (enumerate)
+        {
+            ReleaseDisplays();
+            Enumerate();
+            for (size_t i = 0; i < m_displays.size(); ++i)
+                reads.insert(i);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            sets = m_pendingSets;
+            reads.swap(m_pendingReads);
+        }
+
+        // Send only the newest level per display; later sets pile up in
+        // m_pendingSets meanwhile and replace each other.
+        for (const auto &set : sets)
+        {
+            Write(set.first, set.second);
+            reads.insert(set.first);
+        }
+
+        for (size_t display : reads)
+        {
+            BrightnessInfo info;
+            if (!Read(display, info))
+                info.supported = false;
+            m_displays[display].info = info;
+        }
+
+        bool changed = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const ULONGLONG now = GetTickCount64();
+            if (enumerate)
+            {
+                changed = true;
+                m_values.assign(m_displays.size(), BrightnessInfo{});
+                m_readTicks.assign(m_displays.size(), now);
+                m_pendingReads.clear();
+                m_ready = true;
+            }
+            for (size_t display : reads)
+            {
+                if (!SameReading(m_values[display], m_displays[display].info))
+                    changed = true;
+                m_values[display] = m_displays[display].info;
+                m_readTicks[display] = now;
+            }
+            for (const auto &set : sets)
+            {
+                auto it = m_pendingSets.find(set.first);
+                if (it != m_pendingSets.end() && it->second == set.second)
+                    m_pendingSets.erase(it);
+            }
+            if (enumerate)
+            {
+                // Sets queued before or during the scan are sent on the next
+                // turn, unless their display went away or has no control.
+                for (auto it = m_pendingSets.begin(); it != m_pendingSets.end();)
+                {
+                    if (it->first < m_values.size() && m_values[it->first].supported)
+                        it = std::next(it);
+                    else
+                        it = m_pendingSets.erase(it);
+                }
+            }
+        }
+        if (changed && m_onChange)
+            m_onChange();
+
+        enumerate = false;
+        bool work = false;
+        while (!enumerate && !work)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_stop)
+                    break;
+                enumerate = m_invalidated;
+                m_invalidated = false;
+                work = !m_pendingSets.empty() || !m_pendingReads.empty();
+            }
+            if (enumerate || work)
+                break;
+
+            MsgWaitForMultipleObjects(1, &m_wakeEvent, FALSE, INFINITE, QS_ALLINPUT);
+            MSG msg;
+            while (PeekMessageW(&msg, nullptr, 0, 0, PM_REMOVE))
+                DispatchMessageW(&msg);
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stop)
+            break;
+    }
+
+    ReleaseDisplays();
+    if (m_window)
+    {
+        DestroyWindow(m_window);
+        m_window = nullptr;
+    }
+    UnregisterClassW(kWindowClass, instance);
+}
+
+void BrightnessService::Enumerate()
+{
+    std::vector<HMONITOR> monitors;
+    EnumDisplayMonitors(nullptr, nullptr, &CollectMonitor, reinterpret_cast<LPARAM>(&monitors));
+    std::stable_partition(monitors.begin(), monitors.end(), &IsPrimary);
+
+    // Internal panels do not speak DDC/CI, so the LCD device goes to the
+    // first monitor that has no DDC/CI brightness.
+    bool panelAvailable = InitializeLaptopIoctl();
+    for (HMONITOR monitor : monitors)
+    {
+        Display display;
+        DWORD count = 0;
+        if (GetNumberOfPhysicalMonitorsFromHMONITOR(monitor, &count) && count > 0)
+        {
+            display.physical.resize(count);
+            if (!GetPhysicalMonitorsFromHMONITOR(monitor, count, display.physical.data()))
+                display.physical.clear();
+        }
+
+        DWORD minValue = 0, current = 0, maxValue = 0;
+        if (!display.physical.empty() &&
+            GetMonitorBrightness(display.physical.front().hPhysicalMonitor, &minValue, &current, &maxValue))
+        {
+            display.method = Method::DdcCi;
+        }
+        else if (panelAvailable)
+        {
+            display.method = Method::LaptopIoctl;
+            panelAvailable = false;
+        }
+        m_displays.push_back(std::move(display));
+    }
+}
+
+void BrightnessService::ReleaseDisplays()
+{
+    for (Display &display : m_displays)
+    {
+        if (!display.physical.empty())
+            DestroyPhysicalMonitors(static_cast<DWORD>(display.physical.size()), display.physical.data());
+    }
+    m_displays.clear();
+
+    if (m_lcdDevice != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_lcdDevice);
+        m_lcdDevice = INVALID_HANDLE_VALUE;
+    }
+    m_laptopLevels.clear();
+}
+
+bool BrightnessService::Read(size_t display, BrightnessInfo &outInfo)
+{
+    const Display &target = m_displays[display];
+    if (target.method == Method::LaptopIoctl)
+        return GetLaptopBrightness(outInfo);
+    if (target.method != Method::DdcCi)
+        return false;
+
+    DWORD minValue = 0, current = 0, maxValue = 0;
+    if (!GetMonitorBrightness(target.physical.front().hPhysicalMonitor, &minValue, &current, &maxValue))
+        return false;
+
+    outInfo.min = minValue;
+    outInfo.max = maxValue;
+    outInfo.current = current;
+    outInfo.percent = ToPercent(minValue, maxValue, current);
+    outInfo.supported = true;
+    return true;
+}
+
+bool BrightnessService::Write(size_t display, int percent)
+{
+    const Display &target = m_displays[display];
+    if (target.method == Method::LaptopIoctl)
+        return SetLaptopBrightnessPercent(percent);
+    if (target.method != Method::DdcCi || target.info.max <= target.info.min)
+        return false;
+
+    const DWORD value = target.info.min +
+                        static_cast<DWORD>(std::lround((target.info.max - target.info.min) * percent / 100.0));
+    bool ok = true;
+    for (const PHYSICAL_MONITOR &monitor : target.physical)
+        ok = SetMonitorBrightness(monitor.hPhysicalMonitor, value) && ok;
+    return ok;
+}
+
+bool BrightnessService::InitializeLaptopIoctl()
+{
+#ifndef IOCTL_VIDEO_QUERY_SUPPORTED_BRIGHTNESS
+#define IOCTL_VIDEO_QUERY_SUPPORTED_BRIGHTNESS CTL_CODE(FILE_DEVICE_VIDEO, 0x125, METHOD_BUFFERED, FILE_ANY_ACCESS)
+#endif
+    m_lcdDevice = CreateFileW(L"\\\\.\\LCD", GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, 0, nullptr);
+    if (m_lcdDevice == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    BYTE levels[256] = {};
+    DWORD bytesReturned = 0;
+    if (!DeviceIoControl(m_lcdDevice, IOCTL_VIDEO_QUERY_SUPPORTED_BRIGHTNESS, nullptr, 0, levels, sizeof(levels), &bytesReturned, nullptr) || bytesReturned < 2)
+    {
+        CloseHandle(m_lcdDevice);
+        m_lcdDevice = INVALID_HANDLE_VALUE;
+        return false;
+    }
+
+    m_laptopLevels.assign(levels, levels + bytesReturned);
+    std::sort(m_laptopLevels.begin(), m_laptopLevels.end());
+    m_laptopLevels.erase(std::unique(m_laptopLevels.begin(), m_laptopLevels.end()), m_laptopLevels.end());
+    return m_laptopLevels.size() >= 2;
+}
+
+BYTE BrightnessService::FindClosestLaptopLevel(BYTE raw) const
+{
+    if (m_laptopLevels.empty())
+        return raw;
+
+    BYTE best = m_laptopLevels.front();
+    int bestDiff = std::abs(static_cast<int>(best) - static_cast<int>(raw));
+    for (BYTE level : m_laptopLevels)
+    {
+        const int diff = std::abs(static_cast<int>(level) - static_cast<int>(raw));
+        if (diff < bestDiff)
+        {
+            best = level;
+            bestDiff = diff;
+        }
+    }
+    return best;
+}
+
+bool BrightnessService::GetLaptopBrightness(BrightnessInfo &outInfo)
+{
+#ifndef IOCTL_VIDEO_QUERY_DISPLAY_BRIGHTNESS
+#define IOCTL_VIDEO_QUERY_DISPLAY_BRIGHTNESS CTL_CODE(FILE_DEVICE_VIDEO, 0x126, METHOD_BUFFERED, FILE_ANY_ACCESS)
+#endif
+    if (m_lcdDevice == INVALID_HANDLE_VALUE || m_laptopLevels.size() < 2)
+        return false;
+
+    BYTE values[3] = {};
+    DWORD bytesReturned = 0;
+    if (!DeviceIoControl(m_lcdDevice, IOCTL_VIDEO_QUERY_DISPLAY_BRIGHTNESS, nullptr, 0, values, sizeof(values), &bytesReturned, nullptr) || bytesReturned < 3)
+    {
+        return false;
+    }
+
+    const BYTE rawCurrent = (values[0] == 1) ? values[1] : values[2];
+    const BYTE minRaw = m_laptopLevels.front();
+    const BYTE maxRaw = m_laptopLevels.back();
+    const BYTE normalizedRaw = FindClosestLaptopLevel(rawCurrent);
+
+    outInfo.min = minRaw;
+    outInfo.max = maxRaw;
+    outInfo.current = normalizedRaw;
+    outInfo.supported = true;
+
+    if (maxRaw > minRaw)
+    {
+        outInfo.percent = static_cast<int>((static_cast<double>(normalizedRaw - minRaw) * 100.0) / static_cast<double>(maxRaw - minRaw));
+    }
+    else
+    {
+        outInfo.percent = 0;
+    }
+
+    if (outInfo.percent < 0)
+        outInfo.percent = 0;
+    if (outInfo.percent > 100)
+        outInfo.percent = 100;
+    return true;
+}
+
+bool BrightnessService::SetLaptopBrightnessPercent(int percent)
+{
+#ifndef IOCTL_VIDEO_SET_DISPLAY_BRIGHTNESS
+#define IOCTL_VIDEO_SET_DISPLAY_BRIGHTNESS CTL_CODE(FILE_DEVICE_VIDEO, 0x127, METHOD_BUFFERED, FILE_ANY_ACCESS)
+#endif
+    if (m_lcdDevice == INVALID_HANDLE_VALUE || m_laptopLevels.size() < 2)
+        return false;
+
+    if (percent < 0)
+        percent = 0;
+    if (percent > 100)
+        percent = 100;
+
+    const BYTE minRaw = m_laptopLevels.front();
+    const BYTE maxRaw = m_laptopLevels.back();
+    BYTE targetRaw = minRaw;
+    if (maxRaw > minRaw)
+    {
+        targetRaw = static_cast<BYTE>(minRaw + static_cast<BYTE>((static_cast<double>(maxRaw - minRaw) * static_cast<double>(percent)) / 100.0));
+    }
+    targetRaw = FindClosestLaptopLevel(targetRaw);
+
+    BYTE setValues[3] = {3, targetRaw, targetRaw};
+    DWORD bytesReturned = 0;
+    return DeviceIoControl(m_lcdDevice, IOCTL_VIDEO_SET_DISPLAY_BRIGHTNESS, setValues, sizeof(setValues), nullptr, 0, &bytesReturned, nullptr) == TRUE;
+}
@@ -0,0 +1,126 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#pragma once
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <Windows.h>
+#include <PhysicalMonitorEnumerationAPI.h>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+struct BrightnessInfo
+{
+    uint32_t min = 0;
+    uint32_t max = 100;
+    uint32_t current = 0;
+    int percent = 0;
+    bool supported = false;
+    bool pending = false; // a set is queued or being sent
+    bool ready = false;   // the first enumeration has finished
+};
+
+/*
+** Brightness of every display, driven from one worker thread. The laptop
+** panel is set through the LCD IOCTLs, external monitors through DDC/CI,
+** which can take tens of milliseconds per command.
+**
+** Display 0 is the primary monitor, the rest follow in enumeration order.
+** Physical monitor handles are kept until WM_DISPLAYCHANGE, when the worker
+** enumerates again. Nothing waits for the worker: reads return the last
+** confirmed values at once, and sets are coalesced so only the newest
+** pending level per display is sent. Pending sets survive an enumeration
+** and are applied afterwards if the display still has brightness control.
+** The change callback runs on the worker after each enumeration (the first
+** included) and whenever a confirmed value changes.
+*/
+class BrightnessService
+{
+public:
+    using ChangeCallback = std::function<void()>;
+
+    explicit BrightnessService(ChangeCallback onChange);
+    ~BrightnessService();
+
+    BrightnessService(const BrightnessService &) = delete;
+    BrightnessService &operator=(const BrightnessService &) = delete;
+
+    // Last known values of a display; values older than kRefreshInterval are
+    // re-read in the background. False if there is no such display, or
+    // before the first enumeration (outInfo.ready is false then).
+    bool Get(int display, BrightnessInfo &outInfo);
+
+    // Queue a level in percent, replacing any level still pending for the
+    // display. False if the display has no brightness control. Before the
+    // first enumeration the level is queued and dropped if the display turns
+    // out to have none.
+    bool Set(int display, int percent);
+
+    // 0 before the first enumeration.
+    int GetDisplayCount();
+
+private:
+    static constexpr ULONGLONG kRefreshInterval = 2000; // ms
+
+    enum class Method
+    {
+        None,
+        LaptopIoctl,
+        DdcCi
+    };
+
+    // Worker-owned state of one display.
+    struct Display
+    {
+        Method method = Method::None;
+        std::vector<PHYSICAL_MONITOR> physical; // several when cloned
+        BrightnessInfo info;                    // last read
+    };
+
+    static LRESULT CALLBACK WindowProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
+
+    void WorkerThread();
+    void Wake();
+
+    void Enumerate();
+    void ReleaseDisplays();
+    bool Read(size_t display, BrightnessInfo &outInfo);
+    bool Write(size_t display, int percent);
+
+    bool InitializeLaptopIoctl();
+    BYTE FindClosestLaptopLevel(BYTE raw) const;
+    bool GetLaptopBrightness(BrightnessInfo &outInfo);
+    bool SetLaptopBrightnessPercent(int percent);
+
+    ChangeCallback m_onChange;
+    std::thread m_worker;
+    HANDLE m_wakeEvent = nullptr;
+
+    // Shared with the worker, guarded by m_mutex.
+    std::mutex m_mutex;
+    bool m_ready = false;
+    bool m_stop = false;
+    bool m_invalidated = false;
+    std::vector<BrightnessInfo> m_values;
+    std::vector<ULONGLONG> m_readTicks;
+    std::map<size_t, int> m_pendingSets;
+    std::set<size_t> m_pendingReads;
+
+    // Worker only.
+    HWND m_window = nullptr;
+    std::vector<Display> m_displays;
+    HANDLE m_lcdDevice = INVALID_HANDLE_VALUE;
+    std::vector<BYTE> m_laptopLevels;
+};
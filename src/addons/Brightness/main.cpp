@@ -12,224 +12,56 @@
 #include <NovadeskAPI/novadesk_addon.h>
 
 #include <Windows.h>
-#include <algorithm>
-#include <cmath>
-#include <cstdint>
-#include <vector>
+#include <atomic>
+#include <memory>
+
+#include "BrightnessService.h"
 
 const NovadeskHostAPI* g_Host = nullptr;
+static HWND g_MessageWindow = nullptr;
 
 namespace
 {
-    struct BrightnessInfo
-    {
-        uint32_t min = 0;
-        uint32_t max = 100;
-        uint32_t current = 0;
-        int percent = 0;
-        bool supported = false;
-    };
+    std::unique_ptr<BrightnessService> g_Service;
+    std::atomic<void *> g_OnChange{nullptr};
+    std::atomic<bool> g_ChangePosted{false};
 
-    class BrightnessControl
+    void DeliverChange(novadesk_context ctx, void *)
     {
-    public:
-        explicit BrightnessControl(int displayIndex = 0) : m_displayIndex(displayIndex) {}
-        ~BrightnessControl() { Cleanup(); }
-
-        bool GetBrightness(BrightnessInfo &outInfo)
-        {
-            if (!Initialize())
-            {
-                outInfo.supported = false;
-                return false;
-            }
-
-            const bool ok = (m_method == Method::LaptopIoctl) ? GetLaptopBrightness(outInfo) : false;
-            if (!ok)
-            {
-                outInfo.supported = false;
-            }
-            return ok;
-        }
-
-        bool SetBrightnessPercent(int percent)
-        {
-            if (!Initialize())
-            {
-                return false;
-            }
-            if (m_method == Method::LaptopIoctl)
-            {
-                return SetLaptopBrightnessPercent(percent);
-            }
-            return false;
-        }
-
-    private:
-        enum class Method
-        {
-            Unknown,
-            LaptopIoctl,
-            None
-        };
-
-        int m_displayIndex = 0;
-        Method m_method = Method::Unknown;
-        HANDLE m_lcdDevice = INVALID_HANDLE_VALUE;
-        std::vector<BYTE> m_laptopLevels;
-        bool m_initialized = false;
-
-        bool Initialize()
-        {
-            (void)m_displayIndex;
-            if (m_initialized)
-                return m_method != Method::None;
-
-            m_initialized = true;
-            m_method = Method::None;
-
-            if (InitializeLaptopIoctl())
-            {
-                m_method = Method::LaptopIoctl;
-                return true;
-            }
-            return false;
-        }
-
-        bool InitializeLaptopIoctl()
-        {
-#ifndef IOCTL_VIDEO_QUERY_SUPPORTED_BRIGHTNESS
-#define IOCTL_VIDEO_QUERY_SUPPORTED_BRIGHTNESS CTL_CODE(FILE_DEVICE_VIDEO, 0x125, METHOD_BUFFERED, FILE_ANY_ACCESS)
-#endif
-            m_lcdDevice = CreateFileW(L"\\\\.\\LCD", GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, 0, nullptr);
-            if (m_lcdDevice == INVALID_HANDLE_VALUE)
-            {
-                return false;
-            }
-
-            BYTE levels[256] = {};
-            DWORD bytesReturned = 0;
-            if (!DeviceIoControl(m_lcdDevice, IOCTL_VIDEO_QUERY_SUPPORTED_BRIGHTNESS, nullptr, 0, levels, sizeof(levels), &bytesReturned, nullptr) || bytesReturned < 2)
-            {
-                CloseHandle(m_lcdDevice);
-                m_lcdDevice = INVALID_HANDLE_VALUE;
-                return false;
-            }
-
-            m_laptopLevels.assign(levels, levels + bytesReturned);
-            std::sort(m_laptopLevels.begin(), m_laptopLevels.end());
-            m_laptopLevels.erase(std::unique(m_laptopLevels.begin(), m_laptopLevels.end()), m_laptopLevels.end());
-            return m_laptopLevels.size() >= 2;
-        }
-
-        void Cleanup()
-        {
-            if (m_lcdDevice != INVALID_HANDLE_VALUE)
-            {
-                CloseHandle(m_lcdDevice);
-                m_lcdDevice = INVALID_HANDLE_VALUE;
-            }
-            m_laptopLevels.clear();
-        }
-
-        BYTE FindClosestLaptopLevel(BYTE raw) const
-        {
-            if (m_laptopLevels.empty())
-                return raw;
-
-            BYTE best = m_laptopLevels.front();
-            int bestDiff = std::abs(static_cast<int>(best) - static_cast<int>(raw));
-            for (BYTE level : m_laptopLevels)
-            {
-                const int diff = std::abs(static_cast<int>(level) - static_cast<int>(raw));
-                if (diff < bestDiff)
-                {
-                    best = level;
-                    bestDiff = diff;
-                }
-            }
-            return best;
-        }
-
-        bool GetLaptopBrightness(BrightnessInfo &outInfo)
-        {
-#ifndef IOCTL_VIDEO_QUERY_DISPLAY_BRIGHTNESS
-#define IOCTL_VIDEO_QUERY_DISPLAY_BRIGHTNESS CTL_CODE(FILE_DEVICE_VIDEO, 0x126, METHOD_BUFFERED, FILE_ANY_ACCESS)
-#endif
-            if (m_lcdDevice == INVALID_HANDLE_VALUE || m_laptopLevels.size() < 2)
-                return false;
-
-            BYTE values[3] = {};
-            DWORD bytesReturned = 0;
-            if (!DeviceIoControl(m_lcdDevice, IOCTL_VIDEO_QUERY_DISPLAY_BRIGHTNESS, nullptr, 0, values, sizeof(values), &bytesReturned, nullptr) || bytesReturned < 3)
-            {
-                return false;
-            }
-
-            const BYTE rawCurrent = (values[0] == 1) ? values[1] : values[2];
-            const BYTE minRaw = m_laptopLevels.front();
-            const BYTE maxRaw = m_laptopLevels.back();
-            const BYTE normalizedRaw = FindClosestLaptopLevel(rawCurrent);
-
-            outInfo.min = minRaw;
-            outInfo.max = maxRaw;
-            outInfo.current = normalizedRaw;
-            outInfo.supported = true;
-
-            if (maxRaw > minRaw)
-            {
-                outInfo.percent = static_cast<int>((static_cast<double>(normalizedRaw - minRaw) * 100.0) / static_cast<double>(maxRaw - minRaw));
-            }
-            else
-            {
-                outInfo.percent = 0;
-            }
+        g_ChangePosted.store(false, std::memory_order_release);
+        if (void *fn = g_OnChange.load(std::memory_order_acquire))
+            g_Host->JsCallFunctionNoArgs(ctx, fn);
+    }
 
-            if (outInfo.percent < 0)
-                outInfo.percent = 0;
-            if (outInfo.percent > 100)
-                outInfo.percent = 100;
-            return true;
-        }
+    // Older hosts without PostToMain.
+    void DeliverChangeLegacy(void *)
+    {
+        DeliverChange(nullptr, nullptr);
+    }
 
-        bool SetLaptopBrightnessPercent(int percent)
+    // Runs on the service worker; coalesces into one callback per turn of
+    // the main message loop. PostToMain callbacks are dropped on unload, so
+    // a change queued then never calls into the unloaded DLL.
+    void PostChange()
+    {
+        if (!g_OnChange.load(std::memory_order_acquire) || g_ChangePosted.exchange(true, std::memory_order_acq_rel))
+            return;
+        if (NOVADESK_HOST_HAS(g_Host, PostToMain))
         {
-#ifndef IOCTL_VIDEO_SET_DISPLAY_BRIGHTNESS
-#define IOCTL_VIDEO_SET_DISPLAY_BRIGHTNESS CTL_CODE(FILE_DEVICE_VIDEO, 0x127, METHOD_BUFFERED, FILE_ANY_ACCESS)
-#endif
-            if (m_lcdDevice == INVALID_HANDLE_VALUE || m_laptopLevels.size() < 2)
-                return false;
-
-            if (percent < 0)
-                percent = 0;
-            if (percent > 100)
-                percent = 100;
-
-            const BYTE minRaw = m_laptopLevels.front();
-            const BYTE maxRaw = m_laptopLevels.back();
-            BYTE targetRaw = minRaw;
-            if (maxRaw > minRaw)
-            {
-                targetRaw = static_cast<BYTE>(minRaw + static_cast<BYTE>((static_cast<double>(maxRaw - minRaw) * static_cast<double>(percent)) / 100.0));
-            }
-            targetRaw = FindClosestLaptopLevel(targetRaw);
-
-            BYTE setValues[3] = {3, targetRaw, targetRaw};
-            DWORD bytesReturned = 0;
-            return DeviceIoControl(m_lcdDevice, IOCTL_VIDEO_SET_DISPLAY_BRIGHTNESS, setValues, sizeof(setValues), nullptr, 0, &bytesReturned, nullptr) == TRUE;
+            if (!g_Host->PostToMain(&DeliverChange, nullptr))
+                g_ChangePosted.store(false, std::memory_order_release);
+            return;
         }
-    };
-
-    bool GetBrightness(BrightnessInfo &outInfo, int displayIndex)
-    {
-        BrightnessControl control(displayIndex);
-        return control.GetBrightness(outInfo);
+        novadesk::Dispatcher(g_MessageWindow).Dispatch(&DeliverChangeLegacy);
     }
 
-    bool SetBrightnessPercent(int percent, int displayIndex)
+    BrightnessService &GetService()
     {
-        BrightnessControl control(displayIndex);
-        return control.SetBrightnessPercent(percent);
+        if (!g_Service)
+        {
+            g_Service = std::make_unique<BrightnessService>(&PostChange);
+        }
+        return *g_Service;
     }
 
     bool TryReadPropInt(novadesk_context ctx, const char *name, int &outValue, bool &outFound)
@@ -274,7 +106,7 @@ namespace
         }
 
         BrightnessInfo info;
-        GetBrightness(info, display);
+        GetService().Get(display, info);
 
         g_Host->PushObject(ctx);
         g_Host->RegisterBool(ctx, "supported", info.supported ? 1 : 0);
@@ -282,6 +114,8 @@ namespace
         g_Host->RegisterNumber(ctx, "min", static_cast<double>(info.min));
         g_Host->RegisterNumber(ctx, "max", static_cast<double>(info.max));
         g_Host->RegisterNumber(ctx, "percent", static_cast<double>(info.percent));
+        g_Host->RegisterBool(ctx, "pending", info.pending ? 1 : 0);
+        g_Host->RegisterBool(ctx, "ready", info.ready ? 1 : 0);
         return 1;
     }
 
@@ -330,25 +164,53 @@ namespace
             return 0;
         }
 
-        const bool ok = SetBrightnessPercent(percent, display);
+        const bool ok = GetService().Set(display, percent);
         g_Host->PushBool(ctx, ok ? 1 : 0);
         return 1;
     }
+
+    int JsBrightnessGetDisplayCount(novadesk_context ctx)
+    {
+        g_Host->PushNumber(ctx, static_cast<double>(GetService().GetDisplayCount()));
+        return 1;
+    }
+
+    int JsBrightnessOnChange(novadesk_context ctx)
+    {
+        if (g_Host->GetTop(ctx) < 1 || (!g_Host->IsFunction(ctx, 0) && !g_Host->IsNull(ctx, 0)))
+        {
+            g_Host->ThrowError(ctx, "brightness.onChange(callback) requires a function or null");
+            return 0;
+        }
+        void *fn = g_Host->IsFunction(ctx, 0) ? g_Host->JsGetFunctionPtr(ctx, 0) : nullptr;
+        g_OnChange.store(fn, std::memory_order_release);
+        if (fn)
+            GetService();
+        g_Host->PushBool(ctx, 1);
+        return 1;
+    }
 } // namespace
 
 NOVADESK_ADDON_INIT(ctx, hMsgWnd, host)
 {
-    (void)hMsgWnd;
     g_Host = host;
+    g_MessageWindow = hMsgWnd;
 
     novadesk::Addon addon(ctx, host);
     addon.RegisterString("name", "Brightness");
-    addon.RegisterString("version", "1.0.0");
+    addon.RegisterString("version", "1.1.0");
 
     addon.RegisterFunction("getValue", JsBrightnessGetValue, 1);
     addon.RegisterFunction("setValue", JsBrightnessSetValue, 1);
+    addon.RegisterFunction("getDisplayCount", JsBrightnessGetDisplayCount, 0);
+    addon.RegisterFunction("onChange", JsBrightnessOnChange, 1);
+
+    // Start enumerating now; getValue() reports ready once it finished.
+    GetService();
 }
 
 NOVADESK_ADDON_UNLOAD()
 {
+    g_OnChange.store(nullptr, std::memory_order_release);
+    g_Service.reset();
 }
@@ -0,0 +1,434 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "FeedCore.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+static_assert(sizeof(NovadeskFeedHeader) == 64, "NovadeskFeedHeader layout");
+static_assert(sizeof(NovadeskFeedField) == 48, "NovadeskFeedField layout");
+static_assert(sizeof(NovadeskFeedRecord) == 16, "NovadeskFeedRecord layout");
+static_assert(offsetof(NovadeskFeedHeader, generation) % 8 == 0, "generation must be 8-byte aligned");
+
+// Shared words are accessed through std::atomic views of the mapped memory,
+// which other processes see as plain aligned integers.
+static_assert(sizeof(std::atomic<uint64_t>) == 8 && std::atomic<uint64_t>::is_always_lock_free, "lock-free 64-bit atomics required");
+static_assert(sizeof(std::atomic<uint32_t>) == 4 && std::atomic<uint32_t>::is_always_lock_free, "lock-free 32-bit atomics required");
+
+namespace
+{
+    constexpr uint32_t kRecordHeaderSize = sizeof(NovadeskFeedRecord);
+    constexpr uint32_t kMaxRecords = 1u << 20;
+    constexpr uint64_t kMaxSegmentSize = 1ull << 30;
+
+    std::atomic<uint64_t> &Word(void *p) { return *reinterpret_cast<std::atomic<uint64_t> *>(p); }
+    const std::atomic<uint64_t> &Word(const void *p) { return *reinterpret_cast<const std::atomic<uint64_t> *>(p); }
+    std::atomic<uint32_t> &Word32(void *p) { return *reinterpret_cast<std::atomic<uint32_t> *>(p); }
+    const std::atomic<uint32_t> &Word32(const void *p) { return *reinterpret_cast<const std::atomic<uint32_t> *>(p); }
+
+    uint64_t AlignUp(uint64_t value, uint64_t align) { return (value + align - 1) / align * align; }
+
+    struct Layout
+    {
+        std::vector<FeedField> fields;
+        uint32_t payloadBytes = 0;
+        uint32_t recordsOffset = 0;
+        uint32_t stride = 0;
+        uint64_t total = 0;
+    };
+
+    bool ComputeLayout(const std::vector<FeedFieldSpec> &specs, uint32_t recordCount, Layout &out)
+    {
+        if (specs.empty() || specs.size() > NOVADESK_FEED_MAX_FIELDS || recordCount == 0 || recordCount > kMaxRecords)
+            return false;
+
+        uint64_t offset = 0;
+        out.fields.clear();
+        for (const FeedFieldSpec &spec : specs)
+        {
+            if (spec.name.empty() || spec.name.size() >= NOVADESK_FEED_NAME_MAX)
+                return false;
+            for (const FeedField &existing : out.fields)
+            {
+                if (existing.name == spec.name)
+                    return false;
+            }
+
+            FeedField field;
+            field.name = spec.name;
+            field.type = spec.type;
+            field.offset = static_cast<uint32_t>(offset);
+            switch (spec.type)
+            {
+            case NOVADESK_FEED_NUMBER:
+            case NOVADESK_FEED_INTEGER:
+                field.size = 8;
+                break;
+            case NOVADESK_FEED_STRING:
+                if (spec.size == 0 || spec.size > 4096)
+                    return false;
+                field.size = static_cast<uint32_t>(AlignUp(spec.size, 8));
+                break;
+            default:
+                return false;
+            }
+            offset += field.size;
+            out.fields.push_back(field);
+        }
+
+        out.payloadBytes = static_cast<uint32_t>(offset);
+        out.recordsOffset = static_cast<uint32_t>(AlignUp(sizeof(NovadeskFeedHeader) + sizeof(NovadeskFeedField) * specs.size(), NOVADESK_FEED_ALIGN));
+        out.stride = static_cast<uint32_t>(AlignUp(kRecordHeaderSize + offset, NOVADESK_FEED_ALIGN));
+        out.total = out.recordsOffset + static_cast<uint64_t>(out.stride) * recordCount;
+        return out.total <= kMaxSegmentSize;
+    }
+
+    bool MatchesLayout(const unsigned char *base, const Layout &layout, uint32_t recordCount)
+    {
+        const auto *header = reinterpret_cast<const NovadeskFeedHeader *>(base);
+        if (Word32(&header->magic).load(std::memory_order_acquire) != NOVADESK_FEED_MAGIC ||
+            header->version != NOVADESK_FEED_VERSION || header->headerSize != sizeof(NovadeskFeedHeader) ||
+            header->fieldCount != layout.fields.size() || header->recordCount != recordCount ||
+            header->recordStride != layout.stride || header->recordsOffset != layout.recordsOffset)
+        {
+            return false;
+        }
+
+        const auto *entries = reinterpret_cast<const NovadeskFeedField *>(base + sizeof(NovadeskFeedHeader));
+        for (size_t i = 0; i < layout.fields.size(); ++i)
+        {
+            const FeedField &field = layout.fields[i];
+            if (strncmp(entries[i].name, field.name.c_str(), NOVADESK_FEED_NAME_MAX) != 0 ||
+                entries[i].type != static_cast<uint32_t>(field.type) || entries[i].offset != field.offset || entries[i].size != field.size)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int FindFieldIn(const std::vector<FeedField> &fields, const char *name)
+    {
+        if (!name)
+            return -1;
+        for (size_t i = 0; i < fields.size(); ++i)
+        {
+            if (fields[i].name == name)
+                return static_cast<int>(i);
+        }
+        return -1;
+    }
+} // namespace
+
+double FeedSnapshot::GetNumber(const FeedField &field) const
+{
+    if (field.type == NOVADESK_FEED_INTEGER)
+        return static_cast<double>(GetInteger(field));
+    double value = 0.0;
+    if (field.type == NOVADESK_FEED_NUMBER && field.offset / 8 < payload.size())
+        std::memcpy(&value, &payload[field.offset / 8], sizeof(value));
+    return value;
+}
+
+int64_t FeedSnapshot::GetInteger(const FeedField &field) const
+{
+    if (field.type == NOVADESK_FEED_NUMBER)
+        return static_cast<int64_t>(GetNumber(field));
+    int64_t value = 0;
+    if (field.type == NOVADESK_FEED_INTEGER && field.offset / 8 < payload.size())
+        std::memcpy(&value, &payload[field.offset / 8], sizeof(value));
+    return value;
+}
+
+std::string FeedSnapshot::GetString(const FeedField &field) const
+{
+    if (field.type != NOVADESK_FEED_STRING || (field.offset + field.size) / 8 > payload.size())
+        return std::string();
+    const char *text = reinterpret_cast<const char *>(payload.data()) + field.offset;
+    const size_t length = strnlen(text, field.size);
+    return std::string(text, length);
+}
+
+size_t FeedSegmentSize(const std::vector<FeedFieldSpec> &fields, uint32_t recordCount)
+{
+    Layout layout;
+    return ComputeLayout(fields, recordCount, layout) ? static_cast<size_t>(layout.total) : 0;
+}
+
+bool FeedWriter::Create(void *base, size_t size, const std::vector<FeedFieldSpec> &fields, uint32_t recordCount, uint32_t producerPid)
+{
+    Layout layout;
+    if (!base || !ComputeLayout(fields, recordCount, layout) || size < layout.total)
+        return false;
+
+    m_Base = static_cast<unsigned char *>(base);
+    m_Header = reinterpret_cast<NovadeskFeedHeader *>(m_Base);
+    m_Fields = layout.fields;
+    m_RecordCount = recordCount;
+    m_Stride = layout.stride;
+    m_PayloadWords = layout.payloadBytes / 8;
+    m_Scratch.assign(m_PayloadWords, 0);
+    m_Staged = -1;
+
+    if (!MatchesLayout(m_Base, layout, recordCount))
+    {
+        // Hide the segment while it is rewritten; readers attaching now fail
+        // until the magic is back.
+        Word32(&m_Header->magic).store(0, std::memory_order_release);
+        std::memset(m_Base + sizeof(uint32_t), 0, static_cast<size_t>(layout.total) - sizeof(uint32_t));
+
+        m_Header->version = NOVADESK_FEED_VERSION;
+        m_Header->headerSize = sizeof(NovadeskFeedHeader);
+        m_Header->fieldCount = static_cast<uint32_t>(m_Fields.size());
+        m_Header->recordCount = recordCount;
+        m_Header->recordStride = layout.stride;
+        m_Header->recordsOffset = layout.recordsOffset;
+
+        auto *entries = reinterpret_cast<NovadeskFeedField *>(m_Base + sizeof(NovadeskFeedHeader));
+        for (size_t i = 0; i < m_Fields.size(); ++i)
+        {
+            std::memcpy(entries[i].name, m_Fields[i].name.c_str(), m_Fields[i].name.size());
+            entries[i].type = m_Fields[i].type;
+            entries[i].offset = m_Fields[i].offset;
+            entries[i].size = m_Fields[i].size;
+        }
+
+        Word32(&m_Header->magic).store(NOVADESK_FEED_MAGIC, std::memory_order_release);
+    }
+
+    Word32(&m_Header->producerPid).store(producerPid, std::memory_order_relaxed);
+    return true;
+}
+
+int FeedWriter::FindField(const char *name) const
+{
+    return FindFieldIn(m_Fields, name);
+}
+
+unsigned char *FeedWriter::RecordAt(uint32_t record) const
+{
+    return m_Base + m_Header->recordsOffset + static_cast<size_t>(m_Stride) * record;
+}
+
+bool FeedWriter::Begin(uint32_t record)
+{
+    if (!m_Base || record >= m_RecordCount)
+        return false;
+
+    const unsigned char *payload = RecordAt(record) + kRecordHeaderSize;
+    for (uint32_t i = 0; i < m_PayloadWords; ++i)
+        m_Scratch[i] = Word(payload + i * 8).load(std::memory_order_relaxed);
+    m_Staged = record;
+    return true;
+}
+
+void FeedWriter::SetNumber(int field, double value)
+{
+    if (m_Staged < 0 || field < 0 || static_cast<size_t>(field) >= m_Fields.size())
+        return;
+    const FeedField &f = m_Fields[field];
+    if (f.type == NOVADESK_FEED_NUMBER)
+        std::memcpy(&m_Scratch[f.offset / 8], &value, sizeof(value));
+    else if (f.type == NOVADESK_FEED_INTEGER)
+        SetInteger(field, static_cast<int64_t>(value));
+}
+
+void FeedWriter::SetInteger(int field, int64_t value)
+{
+    if (m_Staged < 0 || field < 0 || static_cast<size_t>(field) >= m_Fields.size())
+        return;
+    const FeedField &f = m_Fields[field];
+    if (f.type == NOVADESK_FEED_INTEGER)
+        std::memcpy(&m_Scratch[f.offset / 8], &value, sizeof(value));
+    else if (f.type == NOVADESK_FEED_NUMBER)
+        SetNumber(field, static_cast<double>(value));
+}
+
+void FeedWriter::SetString(int field, const char *value)
+{
+    if (m_Staged < 0 || field < 0 || static_cast<size_t>(field) >= m_Fields.size())
+        return;
+    const FeedField &f = m_Fields[field];
+    if (f.type != NOVADESK_FEED_STRING)
+        return;
+
+    char *dest = reinterpret_cast<char *>(m_Scratch.data()) + f.offset;
+    std::memset(dest, 0, f.size);
+    if (value)
+    {
+        // Cut on a UTF-8 boundary so the reader never sees half a character.
+        size_t length = strnlen(value, f.size - 1);
+        if (value[length] != '\0')
+        {
+            while (length > 0 && (static_cast<unsigned char>(value[length]) & 0xC0) == 0x80)
+                --length;
+        }
+        std::memcpy(dest, value, length);
+    }
+}
+
+void FeedWriter::Commit(int64_t timestamp)
+{
+    if (m_Staged < 0)
+        return;
+
+    unsigned char *record = RecordAt(static_cast<uint32_t>(m_Staged));
+    std::atomic<uint64_t> &sequence = Word(record);
+    uint64_t s = sequence.load(std::memory_order_relaxed);
+    if (s & 1)
+        ++s; // left odd by a producer that died mid-write
+
+    sequence.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    Word(record + 8).store(static_cast<uint64_t>(timestamp), std::memory_order_relaxed);
+    unsigned char *payload = record + kRecordHeaderSize;
+    for (uint32_t i = 0; i < m_PayloadWords; ++i)
+        Word(payload + i * 8).store(m_Scratch[i], std::memory_order_relaxed);
+
+    sequence.store(s + 2, std::memory_order_release);
+    Word(&m_Header->generation).fetch_add(1, std::memory_order_release);
+    m_Staged = -1;
+}
+
+bool FeedReader::Attach(const void *base, size_t size)
+{
+    Detach();
+    if (!base || size < sizeof(NovadeskFeedHeader))
+        return false;
+
+    const auto *bytes = static_cast<const unsigned char *>(base);
+    const auto *header = reinterpret_cast<const NovadeskFeedHeader *>(bytes);
+    if (Word32(&header->magic).load(std::memory_order_acquire) != NOVADESK_FEED_MAGIC ||
+        header->version != NOVADESK_FEED_VERSION || header->headerSize != sizeof(NovadeskFeedHeader))
+    {
+        return false;
+    }
+
+    const uint32_t fieldCount = header->fieldCount;
+    const uint32_t recordCount = header->recordCount;
+    const uint32_t stride = header->recordStride;
+    const uint32_t recordsOffset = header->recordsOffset;
+    if (fieldCount == 0 || fieldCount > NOVADESK_FEED_MAX_FIELDS || recordCount == 0 || recordCount > kMaxRecords ||
+        stride % NOVADESK_FEED_ALIGN != 0 || stride <= kRecordHeaderSize || recordsOffset % NOVADESK_FEED_ALIGN != 0 ||
+        recordsOffset < sizeof(NovadeskFeedHeader) + sizeof(NovadeskFeedField) * static_cast<uint64_t>(fieldCount) ||
+        recordsOffset + static_cast<uint64_t>(stride) * recordCount > size)
+    {
+        return false;
+    }
+
+    std::vector<FeedField> fields;
+    fields.reserve(fieldCount);
+    uint32_t payloadBytes = 0;
+    const auto *entries = reinterpret_cast<const NovadeskFeedField *>(bytes + sizeof(NovadeskFeedHeader));
+    for (uint32_t i = 0; i < fieldCount; ++i)
+    {
+        const NovadeskFeedField &entry = entries[i];
+        const size_t nameLength = strnlen(entry.name, NOVADESK_FEED_NAME_MAX);
+        if (nameLength == 0 || nameLength == NOVADESK_FEED_NAME_MAX)
+            return false;
+
+        const bool scalar = entry.type == NOVADESK_FEED_NUMBER || entry.type == NOVADESK_FEED_INTEGER;
+        if ((!scalar && entry.type != NOVADESK_FEED_STRING) || (scalar && entry.size != 8) || entry.size == 0 ||
+            entry.size % 8 != 0 || entry.offset % 8 != 0 || static_cast<uint64_t>(entry.offset) + entry.size > stride - kRecordHeaderSize)
+        {
+            return false;
+        }
+
+        FeedField field;
+        field.name.assign(entry.name, nameLength);
+        field.type = static_cast<NovadeskFeedType>(entry.type);
+        field.offset = entry.offset;
+        field.size = entry.size;
+        payloadBytes = (std::max)(payloadBytes, entry.offset + entry.size);
+        fields.push_back(std::move(field));
+    }
+
+    m_Base = bytes;
+    m_Fields = std::move(fields);
+    m_RecordCount = recordCount;
+    m_Stride = stride;
+    m_RecordsOffset = recordsOffset;
+    m_PayloadWords = payloadBytes / 8;
+    return true;
+}
+
+void FeedReader::Detach()
+{
+    m_Base = nullptr;
+    m_Fields.clear();
+    m_RecordCount = 0;
+    m_Stride = 0;
+    m_RecordsOffset = 0;
+    m_PayloadWords = 0;
+}
+
+int FeedReader::FindField(const char *name) const
+{
+    return FindFieldIn(m_Fields, name);
+}
+
+uint32_t FeedReader::GetProducerPid() const
+{
+    if (!m_Base)
+        return 0;
+    return Word32(&reinterpret_cast<const NovadeskFeedHeader *>(m_Base)->producerPid).load(std::memory_order_relaxed);
+}
+
+uint64_t FeedReader::GetGeneration() const
+{
+    if (!m_Base)
+        return 0;
+    return Word(&reinterpret_cast<const NovadeskFeedHeader *>(m_Base)->generation).load(std::memory_order_acquire);
+}
+
+uint64_t FeedReader::GetSequence(uint32_t record) const
+{
+    if (!m_Base || record >= m_RecordCount)
+        return 0;
+    return Word(m_Base + m_RecordsOffset + static_cast<size_t>(m_Stride) * record).load(std::memory_order_acquire);
+}
+
+bool FeedReader::Read(uint32_t record, FeedSnapshot &out) const
+{
+    if (!m_Base || record >= m_RecordCount)
+        return false;
+
+    const unsigned char *base = m_Base + m_RecordsOffset + static_cast<size_t>(m_Stride) * record;
+    const std::atomic<uint64_t> &sequence = Word(base);
+    const unsigned char *payload = base + kRecordHeaderSize;
+    out.payload.resize(m_PayloadWords);
+
+    for (int attempt = 0; attempt < kMaxRetries; ++attempt)
+    {
+        const uint64_t s1 = sequence.load(std::memory_order_acquire);
+        if (s1 == 0)
+            return false;
+        if (s1 & 1)
+        {
+            if (attempt >= 8)
+                std::this_thread::yield();
+            continue;
+        }
+
+        const uint64_t timestamp = Word(base + 8).load(std::memory_order_relaxed);
+        for (uint32_t i = 0; i < m_PayloadWords; ++i)
+            out.payload[i] = Word(payload + i * 8).load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) == s1)
+        {
+            out.sequence = s1;
+            out.timestamp = static_cast<int64_t>(timestamp);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,119 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "FeedLayout.h"
+
+struct FeedFieldSpec
+{
+    std::string name;
+    NovadeskFeedType type = NOVADESK_FEED_NUMBER;
+    uint32_t size = 8; // string capacity including the NUL, rounded up to 8
+};
+
+struct FeedField
+{
+    std::string name;
+    NovadeskFeedType type = NOVADESK_FEED_NUMBER;
+    uint32_t offset = 0;
+    uint32_t size = 0;
+};
+
+// A consistent copy of one record, taken by FeedReader::Read().
+struct FeedSnapshot
+{
+    uint64_t sequence = 0;
+    int64_t timestamp = 0;
+    std::vector<uint64_t> payload;
+
+    double GetNumber(const FeedField &field) const;
+    int64_t GetInteger(const FeedField &field) const;
+    std::string GetString(const FeedField &field) const;
+};
+
+// Bytes needed for a segment with these fields and records; 0 if the schema
+// is invalid (empty, duplicate or overlong names, too many fields).
+size_t FeedSegmentSize(const std::vector<FeedFieldSpec> &fields, uint32_t recordCount);
+
+/*
+** Producer side: formats a segment and publishes records into it. Records
+** are staged with Begin() and the setters, then made visible by Commit().
+** One FeedWriter per segment; the seqlock allows a single writer per record.
+*/
+class FeedWriter
+{
+public:
+    // Attach to 'base' (at least FeedSegmentSize() bytes). A segment already
+    // formatted with the same schema is kept as it is, so a restarted
+    // producer continues its sequences; anything else is reformatted.
+    bool Create(void *base, size_t size, const std::vector<FeedFieldSpec> &fields, uint32_t recordCount, uint32_t producerPid = 0);
+
+    int FindField(const char *name) const;
+    const std::vector<FeedField> &GetFields() const { return m_Fields; }
+    uint32_t GetRecordCount() const { return m_RecordCount; }
+
+    // Start a record from its current contents.
+    bool Begin(uint32_t record);
+    void SetNumber(int field, double value);
+    void SetInteger(int field, int64_t value);
+    void SetString(int field, const char *value); // truncated to fit
+    void Commit(int64_t timestamp);
+
+private:
+    unsigned char *RecordAt(uint32_t record) const;
+
+    unsigned char *m_Base = nullptr;
+    NovadeskFeedHeader *m_Header = nullptr;
+    std::vector<FeedField> m_Fields;
+    uint32_t m_RecordCount = 0;
+    uint32_t m_Stride = 0;
+    uint32_t m_PayloadWords = 0;
+    int64_t m_Staged = -1;
+    std::vector<uint64_t> m_Scratch;
+};
+
+/*
+** Consumer side: validates a mapped segment once, then reads records without
+** locks or system calls. Read() retries while the producer is mid-write.
+*/
+class FeedReader
+{
+public:
+    static constexpr int kMaxRetries = 64;
+
+    // False if the memory does not hold a complete, valid segment.
+    bool Attach(const void *base, size_t size);
+    void Detach();
+
+    bool IsAttached() const { return m_Base != nullptr; }
+    const std::vector<FeedField> &GetFields() const { return m_Fields; }
+    int FindField(const char *name) const;
+    uint32_t GetRecordCount() const { return m_RecordCount; }
+    uint32_t GetProducerPid() const;
+
+    uint64_t GetGeneration() const;
+    // Current sequence without copying the record; changes on every publish.
+    uint64_t GetSequence(uint32_t record) const;
+
+    // False if the record does not exist, was never published or stayed
+    // mid-write for kMaxRetries attempts.
+    bool Read(uint32_t record, FeedSnapshot &out) const;
+
+private:
+    const unsigned char *m_Base = nullptr;
+    std::vector<FeedField> m_Fields;
+    uint32_t m_RecordCount = 0;
+    uint32_t m_Stride = 0;
+    uint32_t m_RecordsOffset = 0;
+    uint32_t m_PayloadWords = 0;
+};
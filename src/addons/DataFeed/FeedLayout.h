@@ -0,0 +1,98 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+/*
+** Binary layout of a DataFeed segment. Plain C so producers in any language
+** can follow it; FeedCore.h implements both sides in C++.
+**
+** A segment is a named shared-memory block:
+**
+**   Windows  file mapping "Local\NovadeskFeed.<name>"
+**   POSIX    shm object   "/NovadeskFeed.<name>"
+**
+** and holds, in order:
+**
+**   NovadeskFeedHeader                        at offset 0
+**   NovadeskFeedField[fieldCount]             at offset headerSize
+**   record[recordCount], recordStride apart   at offset recordsOffset
+**
+** Every record has the same fields (the schema). A record starts with a
+** NovadeskFeedRecord and its payload follows at offset 16; field offsets are
+** relative to the payload. All integers are little-endian, numbers are
+** IEEE doubles or int64, strings are UTF-8 and NUL-terminated within their
+** field. recordsOffset and recordStride are multiples of 64 so records never
+** share a cache line.
+**
+** Records are seqlocks with one writer each:
+**
+**   writer                                 reader
+**   s = sequence (+1 if odd)               s1 = sequence (acquire); odd: retry
+**   sequence = s + 1                       copy timestamp and payload
+**   release fence                          acquire fence
+**   write timestamp and payload            s2 = sequence
+**   sequence = s + 2 (release)             s1 != s2: retry
+**   generation += 1 (release)
+**
+** Payload words should be written and read as aligned 64-bit accesses.
+** A sequence of 0 means the record was never published. A producer that dies
+** mid-write leaves the sequence odd; readers report the record unavailable
+** until it is written again. The header's generation counts publishes over
+** the whole segment so a reader can tell "nothing changed" from one load.
+**
+** The schema is fixed for the life of the segment. A producer restarting
+** with the same schema keeps the segment and its sequences; a different
+** schema needs a different name while readers still have the old one open.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#define NOVADESK_FEED_MAGIC 0x4446444Eu /* "NDFD" */
+#define NOVADESK_FEED_VERSION 1
+#define NOVADESK_FEED_NAME_MAX 32
+#define NOVADESK_FEED_MAX_FIELDS 256
+#define NOVADESK_FEED_ALIGN 64
+
+enum NovadeskFeedType
+{
+    NOVADESK_FEED_NUMBER = 1,  /* double, size 8 */
+    NOVADESK_FEED_INTEGER = 2, /* int64_t, size 8 */
+    NOVADESK_FEED_STRING = 3   /* char[size], size a multiple of 8 */
+};
+
+/* 64 bytes. magic is written last when a segment is formatted. */
+typedef struct NovadeskFeedHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t headerSize; /* sizeof(NovadeskFeedHeader) */
+    uint32_t fieldCount;
+    uint32_t recordCount;
+    uint32_t recordStride;
+    uint32_t recordsOffset;
+    uint64_t generation; /* publishes so far, bumped after each one */
+    uint32_t producerPid;
+    uint32_t reserved[7];
+} NovadeskFeedHeader;
+
+/* 48 bytes. */
+typedef struct NovadeskFeedField
+{
+    char name[NOVADESK_FEED_NAME_MAX]; /* NUL-terminated */
+    uint32_t type;                     /* NovadeskFeedType */
+    uint32_t offset;                   /* from the payload start, multiple of 8 */
+    uint32_t size;                     /* bytes, multiple of 8 */
+    uint32_t reserved;
+} NovadeskFeedField;
+
+/* 16 bytes at the start of every record. */
+typedef struct NovadeskFeedRecord
+{
+    uint64_t sequence;
+    int64_t timestamp; /* producer defined, e.g. Unix time in ms; under the seqlock */
+} NovadeskFeedRecord;
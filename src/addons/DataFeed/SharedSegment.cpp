@@ -0,0 +1,206 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "SharedSegment.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr size_t kMaxNameLength = 64;
+
+#ifdef _WIN32
+    std::wstring SystemName(const std::string &name)
+    {
+        // IsValidName() admits ASCII only, so widening is a plain copy.
+        return L"Local\\NovadeskFeed." + std::wstring(name.begin(), name.end());
+    }
+
+    size_t ViewSize(const void *view)
+    {
+        MEMORY_BASIC_INFORMATION info = {};
+        if (!VirtualQuery(view, &info, sizeof(info)))
+            return 0;
+        return info.RegionSize;
+    }
+#else
+    std::string SystemName(const std::string &name)
+    {
+        return "/NovadeskFeed." + name;
+    }
+#endif
+} // namespace
+
+SharedSegment::~SharedSegment()
+{
+    Close();
+}
+
+bool SharedSegment::IsValidName(const std::string &name)
+{
+    if (name.empty() || name.size() > kMaxNameLength)
+        return false;
+    for (char c : name)
+    {
+        const bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '.' || c == '_' || c == '-';
+        if (!ok)
+            return false;
+    }
+    return true;
+}
+
+#ifdef _WIN32
+
+bool SharedSegment::Create(const std::string &name, size_t size)
+{
+    Close();
+    if (!IsValidName(name) || size == 0)
+        return false;
+
+    const unsigned long long size64 = size;
+    HANDLE mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                        static_cast<DWORD>(size64 >> 32), static_cast<DWORD>(size64 & 0xFFFFFFFFu), SystemName(name).c_str());
+    if (!mapping)
+        return false;
+
+    void *view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    const size_t viewSize = view ? ViewSize(view) : 0;
+    if (!view || viewSize < size)
+    {
+        if (view)
+            UnmapViewOfFile(view);
+        CloseHandle(mapping);
+        return false;
+    }
+
+    m_Mapping = mapping;
+    m_Data = view;
+    m_Size = viewSize;
+    return true;
+}
+
+bool SharedSegment::Open(const std::string &name)
+{
+    Close();
+    if (!IsValidName(name))
+        return false;
+
+    HANDLE mapping = OpenFileMappingW(FILE_MAP_READ, FALSE, SystemName(name).c_str());
+    if (!mapping)
+        return false;
+
+    void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    m_Mapping = mapping;
+    m_Data = view;
+    m_Size = ViewSize(view);
+    return true;
+}
+
+void SharedSegment::Close()
+{
+    if (m_Data)
+        UnmapViewOfFile(m_Data);
+    if (m_Mapping)
+        CloseHandle(m_Mapping);
+    m_Data = nullptr;
+    m_Mapping = nullptr;
+    m_Size = 0;
+}
+
+void SharedSegment::Remove(const std::string &)
+{
+}
+
+#else
+
+bool SharedSegment::Create(const std::string &name, size_t size)
+{
+    Close();
+    if (!IsValidName(name) || size == 0)
+        return false;
+
+    const std::string systemName = SystemName(name);
+    const int fd = shm_open(systemName.c_str(), O_CREAT | O_RDWR, 0600);
+    if (fd < 0)
+        return false;
+
+    struct stat st = {};
+    if (fstat(fd, &st) != 0 || (static_cast<size_t>(st.st_size) < size && ftruncate(fd, static_cast<off_t>(size)) != 0))
+    {
+        close(fd);
+        return false;
+    }
+
+    const size_t mapSize = static_cast<size_t>(st.st_size) > size ? static_cast<size_t>(st.st_size) : size;
+    void *view = mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED)
+        return false;
+
+    m_Data = view;
+    m_Size = mapSize;
+    return true;
+}
+
+bool SharedSegment::Open(const std::string &name)
+{
+    Close();
+    if (!IsValidName(name))
+        return false;
+
+    const int fd = shm_open(SystemName(name).c_str(), O_RDONLY, 0);
+    if (fd < 0)
+        return false;
+
+    struct stat st = {};
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    void *view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED)
+        return false;
+
+    m_Data = view;
+    m_Size = static_cast<size_t>(st.st_size);
+    return true;
+}
+
+void SharedSegment::Close()
+{
+    if (m_Data)
+        munmap(m_Data, m_Size);
+    m_Data = nullptr;
+    m_Size = 0;
+}
+
+void SharedSegment::Remove(const std::string &name)
+{
+    if (IsValidName(name))
+        shm_unlink(SystemName(name).c_str());
+}
+
+#endif
@@ -0,0 +1,52 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/*
+** A named shared-memory block mapped into this process: a file mapping in
+** the session namespace on Windows, a POSIX shm object elsewhere. Names are
+** the feed name only; the platform prefix from FeedLayout.h is added here.
+*/
+class SharedSegment
+{
+public:
+    SharedSegment() = default;
+    ~SharedSegment();
+
+    SharedSegment(const SharedSegment &) = delete;
+    SharedSegment &operator=(const SharedSegment &) = delete;
+
+    // Producer side: create the segment, or open it if it already exists
+    // and is at least 'size' bytes. New segments are zero-filled.
+    bool Create(const std::string &name, size_t size);
+
+    // Consumer side: map an existing segment read-only. False if no
+    // producer has created it.
+    bool Open(const std::string &name);
+
+    void Close();
+
+    // POSIX segments outlive their processes until removed; no-op on Windows,
+    // where the segment goes away with its last handle.
+    static void Remove(const std::string &name);
+
+    static bool IsValidName(const std::string &name);
+
+    void *GetData() const { return m_Data; }
+    size_t GetSize() const { return m_Size; }
+
+private:
+    void *m_Data = nullptr;
+    size_t m_Size = 0;
+#ifdef _WIN32
+    void *m_Mapping = nullptr;
+#endif
+};
@@ -0,0 +1,474 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+/*
+** Headless checks and latency benchmark for the DataFeed seqlock segments.
+**
+**   datafeed_bench                          run checks, then time reads,
+**                                           publishes and publish-to-read
+**                                           latency through shared memory
+**   datafeed_bench --check                  run checks only (used by ctest)
+**   datafeed_bench --publish <name> [sec]   demo producer: 4 records of
+**                                           { counter, value, label },
+**                                           updated every 100 ms
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+#include "../FeedCore.h"
+#include "../SharedSegment.h"
+
+namespace
+{
+    int s_Failures = 0;
+
+    void Check(bool condition, const char *what)
+    {
+        if (!condition)
+        {
+            ++s_Failures;
+            std::printf("FAIL: %s\n", what);
+        }
+    }
+
+    int64_t NowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Segment memory for checks that do not need a real mapping.
+    struct Buffer
+    {
+        explicit Buffer(size_t bytes) : words((bytes + 7) / 8, 0), size(bytes) {}
+        void *Data() { return words.data(); }
+        std::vector<uint64_t> words;
+        size_t size;
+    };
+
+    std::vector<FeedFieldSpec> MetricSchema()
+    {
+        return {{"load", NOVADESK_FEED_NUMBER, 8},
+                {"count", NOVADESK_FEED_INTEGER, 8},
+                {"status", NOVADESK_FEED_STRING, 20}};
+    }
+
+    void CheckLayout()
+    {
+        // 20-byte string rounds to 24: payload 40, record 16 + 40 -> 64.
+        // Header 64 + 3 fields * 48 = 208 -> records at 256.
+        Check(FeedSegmentSize(MetricSchema(), 4) == 256 + 4 * 64, "FeedSegmentSize follows the documented layout");
+        Check(FeedSegmentSize({}, 4) == 0, "empty schema rejected");
+        Check(FeedSegmentSize(MetricSchema(), 0) == 0, "zero records rejected");
+        Check(FeedSegmentSize({{"a", NOVADESK_FEED_NUMBER, 8}, {"a", NOVADESK_FEED_INTEGER, 8}}, 1) == 0, "duplicate field names rejected");
+        Check(FeedSegmentSize({{std::string(NOVADESK_FEED_NAME_MAX, 'x'), NOVADESK_FEED_NUMBER, 8}}, 1) == 0, "overlong field name rejected");
+        Check(FeedSegmentSize({{"s", NOVADESK_FEED_STRING, 0}}, 1) == 0, "zero-size string rejected");
+    }
+
+    void CheckRoundTrip()
+    {
+        const std::vector<FeedFieldSpec> schema = MetricSchema();
+        Buffer buffer(FeedSegmentSize(schema, 4));
+
+        FeedWriter writer;
+        Check(writer.Create(buffer.Data(), buffer.size, schema, 4, 1234), "writer formats a segment");
+        Check(!writer.Create(buffer.Data(), buffer.size - 1, schema, 4), "writer refuses a short segment");
+
+        FeedReader reader;
+        Check(reader.Attach(buffer.Data(), buffer.size), "reader attaches to a fresh segment");
+        Check(reader.GetRecordCount() == 4 && reader.GetFields().size() == 3, "reader sees the schema");
+        Check(reader.GetProducerPid() == 1234, "reader sees the producer pid");
+        Check(reader.FindField("status") == 2 && reader.FindField("nope") == -1, "FindField");
+
+        FeedSnapshot snap;
+        Check(!reader.Read(0, snap), "unpublished record is unavailable");
+        Check(!reader.Read(4, snap), "out-of-range record is unavailable");
+
+        const int load = writer.FindField("load");
+        const int count = writer.FindField("count");
+        const int status = writer.FindField("status");
+        writer.Begin(1);
+        writer.SetNumber(load, 0.75);
+        writer.SetInteger(count, -42);
+        writer.SetString(status, "ok");
+        writer.Commit(1000);
+
+        const std::vector<FeedField> &fields = reader.GetFields();
+        Check(reader.Read(1, snap), "published record is readable");
+        Check(snap.sequence == 2 && snap.timestamp == 1000, "sequence and timestamp");
+        Check(snap.GetNumber(fields[load]) == 0.75, "number round trip");
+        Check(snap.GetInteger(fields[count]) == -42, "integer round trip");
+        Check(snap.GetString(fields[status]) == "ok", "string round trip");
+        Check(reader.GetGeneration() == 1 && reader.GetSequence(1) == 2, "generation and sequence after one publish");
+
+        // Partial update keeps the other fields.
+        writer.Begin(1);
+        writer.SetInteger(count, 7);
+        writer.Commit(2000);
+        Check(reader.Read(1, snap) && snap.GetNumber(fields[load]) == 0.75 && snap.GetInteger(fields[count]) == 7 &&
+                  snap.GetString(fields[status]) == "ok",
+              "partial update keeps other fields");
+        Check(reader.GetGeneration() == 2 && snap.sequence == 4, "generation counts publishes");
+
+        // 23 bytes fit in the 24-byte field; "é" straddling the cut is dropped whole.
+        writer.Begin(2);
+        writer.SetString(status, "abcdefghijklmnopqrstuvwxyz");
+        writer.Commit(0);
+        Check(reader.Read(2, snap) && snap.GetString(fields[status]) == "abcdefghijklmnopqrstuvw", "long string truncated to capacity");
+        writer.Begin(2);
+        writer.SetString(status, "abcdefghijklmnopqrstuv\xC3\xA9");
+        writer.Commit(0);
+        Check(reader.Read(2, snap) && snap.GetString(fields[status]) == "abcdefghijklmnopqrstuv", "truncation keeps UTF-8 whole");
+
+        // Numbers convert between the two numeric types.
+        writer.Begin(3);
+        writer.SetInteger(load, 3);
+        writer.SetNumber(count, 9.9);
+        writer.Commit(0);
+        Check(reader.Read(3, snap) && snap.GetNumber(fields[load]) == 3.0 && snap.GetInteger(fields[count]) == 9, "numeric conversions");
+    }
+
+    void CheckValidation()
+    {
+        const std::vector<FeedFieldSpec> schema = MetricSchema();
+        const size_t size = FeedSegmentSize(schema, 2);
+        FeedReader reader;
+
+        {
+            Buffer buffer(size);
+            FeedWriter writer;
+            writer.Create(buffer.Data(), buffer.size, schema, 2);
+            Check(!reader.Attach(buffer.Data(), buffer.size - 1), "truncated mapping rejected");
+        }
+        {
+            Buffer buffer(size);
+            FeedWriter writer;
+            writer.Create(buffer.Data(), buffer.size, schema, 2);
+            reinterpret_cast<NovadeskFeedHeader *>(buffer.Data())->magic = 0;
+            Check(!reader.Attach(buffer.Data(), buffer.size), "bad magic rejected");
+        }
+        {
+            Buffer buffer(size);
+            FeedWriter writer;
+            writer.Create(buffer.Data(), buffer.size, schema, 2);
+            auto *fields = reinterpret_cast<NovadeskFeedField *>(static_cast<unsigned char *>(buffer.Data()) + sizeof(NovadeskFeedHeader));
+            fields[2].offset = 48;
+            Check(!reader.Attach(buffer.Data(), buffer.size), "field past the record rejected");
+        }
+        {
+            Buffer buffer(size);
+            FeedWriter writer;
+            writer.Create(buffer.Data(), buffer.size, schema, 2);
+            auto *fields = reinterpret_cast<NovadeskFeedField *>(static_cast<unsigned char *>(buffer.Data()) + sizeof(NovadeskFeedHeader));
+            std::memset(fields[0].name, 'x', NOVADESK_FEED_NAME_MAX);
+            Check(!reader.Attach(buffer.Data(), buffer.size), "unterminated field name rejected");
+        }
+        {
+            Buffer buffer(size);
+            FeedWriter writer;
+            writer.Create(buffer.Data(), buffer.size, schema, 2);
+            reinterpret_cast<NovadeskFeedHeader *>(buffer.Data())->recordCount = 3;
+            Check(!reader.Attach(buffer.Data(), buffer.size), "record count beyond the mapping rejected");
+        }
+        Check(SharedSegment::IsValidName("metrics.cpu_1-a") && !SharedSegment::IsValidName("a/b") && !SharedSegment::IsValidName(""),
+              "segment name validation");
+    }
+
+    void CheckRestart()
+    {
+        const std::vector<FeedFieldSpec> schema = MetricSchema();
+        Buffer buffer(FeedSegmentSize(schema, 2) + 256);
+
+        FeedWriter first;
+        first.Create(buffer.Data(), buffer.size, schema, 2);
+        first.Begin(0);
+        first.SetInteger(1, 5);
+        first.Commit(0);
+
+        // Same schema: sequences and values survive the restart.
+        FeedWriter second;
+        second.Create(buffer.Data(), buffer.size, schema, 2);
+        FeedReader reader;
+        FeedSnapshot snap;
+        Check(reader.Attach(buffer.Data(), buffer.size) && reader.Read(0, snap) && snap.sequence == 2 && snap.GetInteger(reader.GetFields()[1]) == 5,
+              "restart with the same schema keeps the segment");
+        second.Begin(0);
+        second.Commit(0);
+        Check(reader.GetSequence(0) == 4, "restarted writer continues the sequence");
+
+        // A producer killed mid-write leaves the sequence odd.
+        unsigned char *record = static_cast<unsigned char *>(buffer.Data()) + reinterpret_cast<NovadeskFeedHeader *>(buffer.Data())->recordsOffset;
+        reinterpret_cast<NovadeskFeedRecord *>(record)->sequence = 5;
+        Check(!reader.Read(0, snap), "record left mid-write is unavailable");
+        second.Begin(0);
+        second.Commit(0);
+        Check(reader.Read(0, snap) && snap.sequence == 8, "next publish recovers an abandoned record");
+
+        // Different schema: reformatted from scratch.
+        FeedWriter third;
+        Check(third.Create(buffer.Data(), buffer.size, {{"other", NOVADESK_FEED_NUMBER, 8}}, 3), "restart with another schema");
+        Check(reader.Attach(buffer.Data(), buffer.size) && reader.GetFields().size() == 1 && reader.GetRecordCount() == 3 && !reader.Read(0, snap) &&
+                  reader.GetGeneration() == 0,
+              "another schema reformats the segment");
+    }
+
+    // One writer hammers a record whose fields must always agree; readers
+    // must never return a mix of two publishes.
+    void CheckConcurrentReads()
+    {
+        const std::vector<FeedFieldSpec> schema = {{"a", NOVADESK_FEED_INTEGER, 8},
+                                                   {"b", NOVADESK_FEED_INTEGER, 8},
+                                                   {"c", NOVADESK_FEED_NUMBER, 8},
+                                                   {"text", NOVADESK_FEED_STRING, 40}};
+        Buffer buffer(FeedSegmentSize(schema, 1));
+        FeedWriter writer;
+        writer.Create(buffer.Data(), buffer.size, schema, 1);
+
+        std::atomic<bool> done{false};
+        std::atomic<int> torn{0};
+        std::atomic<long long> reads{0};
+        auto readerLoop = [&]()
+        {
+            FeedReader reader;
+            reader.Attach(buffer.Data(), buffer.size);
+            const std::vector<FeedField> &fields = reader.GetFields();
+            FeedSnapshot snap;
+            long long local = 0;
+            while (!done.load(std::memory_order_acquire))
+            {
+                if (!reader.Read(0, snap))
+                    continue;
+                ++local;
+                const int64_t a = snap.GetInteger(fields[0]);
+                if (snap.GetInteger(fields[1]) != a || snap.GetNumber(fields[2]) != static_cast<double>(a) ||
+                    snap.GetString(fields[3]) != std::to_string(a) + "-padding-padding" || snap.timestamp != a)
+                {
+                    torn.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            reads.fetch_add(local, std::memory_order_relaxed);
+        };
+
+        std::thread r1(readerLoop);
+        std::thread r2(readerLoop);
+        for (int64_t i = 1; i <= 200000; ++i)
+        {
+            writer.Begin(0);
+            writer.SetInteger(0, i);
+            writer.SetInteger(1, i);
+            writer.SetNumber(2, static_cast<double>(i));
+            writer.SetString(3, (std::to_string(i) + "-padding-padding").c_str());
+            writer.Commit(i);
+        }
+        done.store(true, std::memory_order_release);
+        r1.join();
+        r2.join();
+
+        Check(torn.load() == 0, "no torn reads under a concurrent writer");
+        Check(reads.load() > 0, "readers made progress under a concurrent writer");
+    }
+
+    void CheckSharedSegment()
+    {
+        const std::string name = "datafeed_check_" + std::to_string(getpid());
+        const std::vector<FeedFieldSpec> schema = MetricSchema();
+        const size_t size = FeedSegmentSize(schema, 2);
+
+        SharedSegment missing;
+        Check(!missing.Open(name), "opening a segment nobody created fails");
+
+        SharedSegment producer;
+        Check(producer.Create(name, size) && producer.GetSize() >= size, "create a named segment");
+        FeedWriter writer;
+        writer.Create(producer.GetData(), producer.GetSize(), schema, 2);
+
+        SharedSegment consumer;
+        FeedReader reader;
+        Check(consumer.Open(name) && reader.Attach(consumer.GetData(), consumer.GetSize()), "open the segment from a second mapping");
+
+        writer.Begin(1);
+        writer.SetString(2, "shared");
+        writer.Commit(77);
+        FeedSnapshot snap;
+        Check(reader.Read(1, snap) && snap.timestamp == 77 && snap.GetString(reader.GetFields()[2]) == "shared", "publish is visible through the other mapping");
+
+        consumer.Close();
+        producer.Close();
+        SharedSegment::Remove(name);
+    }
+
+    template <typename Fn>
+    void TimeLoop(const char *name, long long iterations, Fn fn)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (long long i = 0; i < iterations; ++i)
+            fn(i);
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::printf("%-36s %10lld ops: %7.1f ns/op\n", name, iterations, elapsed * 1e9 / static_cast<double>(iterations));
+    }
+
+    void RunBenchmarks()
+    {
+        const std::string name = "datafeed_bench_" + std::to_string(getpid());
+        const std::vector<FeedFieldSpec> schema = {{"load", NOVADESK_FEED_NUMBER, 8},
+                                                   {"count", NOVADESK_FEED_INTEGER, 8},
+                                                   {"sent", NOVADESK_FEED_INTEGER, 8},
+                                                   {"rate", NOVADESK_FEED_NUMBER, 8},
+                                                   {"status", NOVADESK_FEED_STRING, 32}};
+        SharedSegment producer;
+        SharedSegment consumer;
+        if (!producer.Create(name, FeedSegmentSize(schema, 16)))
+        {
+            std::printf("Cannot create shared memory segment %s\n", name.c_str());
+            return;
+        }
+        FeedWriter writer;
+        writer.Create(producer.GetData(), producer.GetSize(), schema, 16, static_cast<uint32_t>(getpid()));
+        FeedReader reader;
+        consumer.Open(name);
+        reader.Attach(consumer.GetData(), consumer.GetSize());
+
+        for (uint32_t r = 0; r < 16; ++r)
+        {
+            writer.Begin(r);
+            writer.SetString(4, "running");
+            writer.Commit(0);
+        }
+
+        FeedSnapshot snap;
+        volatile uint64_t sink = 0;
+        TimeLoop("read record (4 numbers + 32 B text)", 10000000, [&](long long i)
+                 { reader.Read(static_cast<uint32_t>(i & 15), snap); sink = sink + snap.sequence; });
+        TimeLoop("poll generation", 10000000, [&](long long)
+                 { sink = sink + reader.GetGeneration(); });
+        TimeLoop("publish one field", 10000000, [&](long long i)
+                 { writer.Begin(static_cast<uint32_t>(i & 15)); writer.SetInteger(1, i); writer.Commit(i); });
+
+        // Publish-to-observe latency: the producer stamps steady_clock into
+        // the record every 50 us, the consumer polls the generation through
+        // another mapping and measures when the value arrives.
+        const int samples = 5000;
+        std::vector<int64_t> latencies;
+        latencies.reserve(samples);
+        std::atomic<bool> stop{false};
+        std::thread producerThread([&]()
+                                   {
+            FeedWriter feed;
+            feed.Create(producer.GetData(), producer.GetSize(), schema, 16);
+            while (!stop.load(std::memory_order_acquire))
+            {
+                feed.Begin(0);
+                feed.SetInteger(2, NowNs());
+                feed.Commit(0);
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            } });
+
+        uint64_t seen = reader.GetGeneration();
+        const FeedField &sent = reader.GetFields()[2];
+        while (static_cast<int>(latencies.size()) < samples)
+        {
+            const uint64_t generation = reader.GetGeneration();
+            if (generation == seen)
+            {
+                std::this_thread::yield(); // lets the producer run on a single core
+                continue;
+            }
+            seen = generation;
+            if (reader.Read(0, snap))
+                latencies.push_back(NowNs() - snap.GetInteger(sent));
+        }
+        stop.store(true, std::memory_order_release);
+        producerThread.join();
+
+        std::sort(latencies.begin(), latencies.end());
+        std::printf("%-36s %10d samples: p50 %lld ns, p99 %lld ns, max %lld ns\n", "publish -> observe (polling)", samples,
+                    static_cast<long long>(latencies[samples / 2]), static_cast<long long>(latencies[samples * 99 / 100]),
+                    static_cast<long long>(latencies.back()));
+
+        consumer.Close();
+        producer.Close();
+        SharedSegment::Remove(name);
+    }
+
+    int Publish(const std::string &name, int seconds)
+    {
+        const std::vector<FeedFieldSpec> schema = {{"counter", NOVADESK_FEED_INTEGER, 8},
+                                                   {"value", NOVADESK_FEED_NUMBER, 8},
+                                                   {"label", NOVADESK_FEED_STRING, 32}};
+        const uint32_t records = 4;
+        SharedSegment segment;
+        FeedWriter writer;
+        if (!segment.Create(name, FeedSegmentSize(schema, records)) ||
+            !writer.Create(segment.GetData(), segment.GetSize(), schema, records, static_cast<uint32_t>(getpid())))
+        {
+            std::printf("Cannot create feed %s\n", name.c_str());
+            return 1;
+        }
+
+        std::printf("Publishing %s (%u records of counter, value, label)\n", name.c_str(), records);
+        const auto end = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+        for (int64_t tick = 0; seconds <= 0 || std::chrono::steady_clock::now() < end; ++tick)
+        {
+            const int64_t unixMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+            for (uint32_t r = 0; r < records; ++r)
+            {
+                writer.Begin(r);
+                writer.SetInteger(0, tick);
+                writer.SetNumber(1, std::sin(static_cast<double>(tick) * 0.1 + r));
+                writer.SetString(2, ("service-" + std::to_string(r)).c_str());
+                writer.Commit(unixMs);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+
+        segment.Close();
+        SharedSegment::Remove(name);
+        return 0;
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    if (argc > 2 && std::strcmp(argv[1], "--publish") == 0)
+        return Publish(argv[2], argc > 3 ? std::atoi(argv[3]) : 0);
+
+    const bool checkOnly = argc > 1 && std::strcmp(argv[1], "--check") == 0;
+
+    CheckLayout();
+    CheckRoundTrip();
+    CheckValidation();
+    CheckRestart();
+    CheckConcurrentReads();
+    CheckSharedSegment();
+
+    if (s_Failures)
+    {
+        std::printf("%d check(s) failed\n", s_Failures);
+        return 1;
+    }
+    std::printf("All checks passed\n");
+
+    if (!checkOnly)
+        RunBenchmarks();
+    return 0;
+}
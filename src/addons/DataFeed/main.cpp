@@ -0,0 +1,472 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <NovadeskAPI/novadesk_addon.h>
+
+#include <Windows.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FeedCore.h"
+#include "SharedSegment.h"
+
+const NovadeskHostAPI* g_Host = nullptr;
+static HWND g_MessageWindow = nullptr;
+
+namespace
+{
+    constexpr int kDefaultIntervalMs = 50;
+
+    struct Feed
+    {
+        std::string name;
+        SharedSegment segment;
+        FeedReader reader;
+    };
+
+    // Watcher state of one subscribe() call.
+    struct Subscription
+    {
+        std::shared_ptr<Feed> feed;
+        void *fn = nullptr;
+        std::chrono::milliseconds interval{kDefaultIntervalMs};
+        std::chrono::steady_clock::time_point nextPoll;
+        uint64_t generation = 0;
+        std::vector<uint64_t> sequences; // last seen per record
+        std::vector<uint32_t> changed;   // not yet delivered
+        std::vector<uint8_t> pending;    // per record: 1 while listed in 'changed'
+        bool posted = false;
+
+        // Hand the undelivered records to the caller. g_WatchMutex held.
+        void TakeChanged(std::vector<uint32_t> &out)
+        {
+            for (uint32_t r : changed)
+                pending[r] = 0;
+            out.clear();
+            out.swap(changed);
+        }
+    };
+
+    // Main thread only.
+    std::map<int, std::shared_ptr<Feed>> g_Feeds;
+    int g_NextFeedId = 1;
+
+    // Shared with the watcher thread, guarded by g_WatchMutex.
+    std::mutex g_WatchMutex;
+    std::condition_variable g_WatchCv;
+    std::map<int, Subscription> g_Subscriptions;
+    int g_NextSubscriptionId = 1;
+    bool g_WatchStop = false;
+    std::thread g_Watcher;
+
+    void DeliverChanges(novadesk_context ctx, void *payload)
+    {
+        const int id = static_cast<int>(reinterpret_cast<intptr_t>(payload));
+        void *fn = nullptr;
+        uint64_t generation = 0;
+        std::vector<uint32_t> changed;
+        {
+            std::lock_guard<std::mutex> lock(g_WatchMutex);
+            auto it = g_Subscriptions.find(id);
+            if (it == g_Subscriptions.end())
+                return;
+            it->second.posted = false;
+            it->second.TakeChanged(changed);
+            fn = it->second.fn;
+            generation = it->second.generation;
+        }
+        if (!fn || changed.empty())
+            return;
+
+        std::sort(changed.begin(), changed.end());
+        const std::vector<double> records(changed.begin(), changed.end());
+        g_Host->PushObject(ctx);
+        g_Host->RegisterNumber(ctx, "generation", static_cast<double>(generation));
+        g_Host->RegisterArrayNumber(ctx, "records", records.data(), records.size());
+        g_Host->JsCallFunction(ctx, fn, 1);
+    }
+
+    // Hosts without PostToMain get one plain dispatch and no arguments.
+    void DeliverChangesLegacy(void *payload)
+    {
+        void *fn = nullptr;
+        std::vector<uint32_t> changed;
+        {
+            std::lock_guard<std::mutex> lock(g_WatchMutex);
+            auto it = g_Subscriptions.find(static_cast<int>(reinterpret_cast<intptr_t>(payload)));
+            if (it == g_Subscriptions.end())
+                return;
+            it->second.posted = false;
+            it->second.TakeChanged(changed);
+            fn = it->second.fn;
+        }
+        if (fn)
+            g_Host->JsCallFunctionNoArgs(nullptr, fn);
+    }
+
+    bool PostChanges(int id)
+    {
+        void *payload = reinterpret_cast<void *>(static_cast<intptr_t>(id));
+        if (NOVADESK_HOST_HAS(g_Host, PostToMain))
+            return g_Host->PostToMain(&DeliverChanges, payload) != 0;
+        novadesk::Dispatcher(g_MessageWindow).Dispatch(&DeliverChangesLegacy, payload);
+        return true;
+    }
+
+    // Called with g_WatchMutex held. Costs one load when nothing changed.
+    void Poll(int id, Subscription &sub)
+    {
+        const FeedReader &reader = sub.feed->reader;
+        const uint64_t generation = reader.GetGeneration();
+        if (generation == sub.generation)
+            return;
+
+        bool busy = false;
+        for (uint32_t r = 0; r < reader.GetRecordCount(); ++r)
+        {
+            const uint64_t sequence = reader.GetSequence(r);
+            if (sequence & 1)
+            {
+                busy = true; // mid-write; pick it up on the next poll
+                continue;
+            }
+            if (sequence != sub.sequences[r])
+            {
+                sub.sequences[r] = sequence;
+                if (!sub.pending[r])
+                {
+                    sub.pending[r] = 1;
+                    sub.changed.push_back(r);
+                }
+            }
+        }
+        if (!busy)
+            sub.generation = generation;
+
+        if (!sub.changed.empty() && !sub.posted)
+            sub.posted = PostChanges(id);
+    }
+
+    void WatchThread()
+    {
+        std::unique_lock<std::mutex> lock(g_WatchMutex);
+        while (!g_WatchStop)
+        {
+            const auto now = std::chrono::steady_clock::now();
+            auto next = now + std::chrono::seconds(1);
+            for (auto &kv : g_Subscriptions)
+            {
+                Subscription &sub = kv.second;
+                if (sub.nextPoll <= now)
+                {
+                    Poll(kv.first, sub);
+                    sub.nextPoll = now + sub.interval;
+                }
+                next = (std::min)(next, sub.nextPoll);
+            }
+            g_WatchCv.wait_until(lock, next);
+        }
+    }
+
+    void StopWatcher()
+    {
+        {
+            std::lock_guard<std::mutex> lock(g_WatchMutex);
+            g_WatchStop = true;
+            g_Subscriptions.clear();
+        }
+        g_WatchCv.notify_all();
+        if (g_Watcher.joinable())
+            g_Watcher.join();
+        g_WatchStop = false;
+    }
+
+    std::shared_ptr<Feed> GetFeedArg(novadesk_context ctx, const char *usage)
+    {
+        if (g_Host->GetTop(ctx) < 1 || !g_Host->IsNumber(ctx, 0))
+        {
+            g_Host->ThrowError(ctx, usage);
+            return nullptr;
+        }
+        auto it = g_Feeds.find(static_cast<int>(g_Host->GetNumber(ctx, 0)));
+        if (it == g_Feeds.end())
+        {
+            g_Host->ThrowError(ctx, "dataFeed: unknown or closed feed id");
+            return nullptr;
+        }
+        return it->second;
+    }
+
+    const char *TypeName(NovadeskFeedType type)
+    {
+        switch (type)
+        {
+        case NOVADESK_FEED_INTEGER:
+            return "integer";
+        case NOVADESK_FEED_STRING:
+            return "string";
+        default:
+            return "number";
+        }
+    }
+
+    // Fills the object on top of the stack. Field values come after the
+    // record metadata, so a field named like one of them wins.
+    void RegisterRecord(novadesk_context ctx, const Feed &feed, uint32_t index, const FeedSnapshot &snap)
+    {
+        g_Host->RegisterNumber(ctx, "index", static_cast<double>(index));
+        g_Host->RegisterNumber(ctx, "sequence", static_cast<double>(snap.sequence));
+        g_Host->RegisterNumber(ctx, "timestamp", static_cast<double>(snap.timestamp));
+        for (const FeedField &field : feed.reader.GetFields())
+        {
+            if (field.type == NOVADESK_FEED_STRING)
+                g_Host->RegisterString(ctx, field.name.c_str(), snap.GetString(field).c_str());
+            else
+                g_Host->RegisterNumber(ctx, field.name.c_str(), snap.GetNumber(field));
+        }
+    }
+
+    int JsDataFeedOpen(novadesk_context ctx)
+    {
+        if (g_Host->GetTop(ctx) < 1 || !g_Host->IsString(ctx, 0))
+        {
+            g_Host->ThrowError(ctx, "dataFeed.open(name) requires a string name");
+            return 0;
+        }
+        const char *name = g_Host->GetString(ctx, 0);
+        if (!name || !SharedSegment::IsValidName(name))
+        {
+            g_Host->ThrowError(ctx, "dataFeed.open(name): names use letters, digits, '.', '_' and '-' (64 at most)");
+            return 0;
+        }
+
+        // Null until a producer has created and formatted the segment.
+        auto feed = std::make_shared<Feed>();
+        feed->name = name;
+        if (!feed->segment.Open(feed->name) || !feed->reader.Attach(feed->segment.GetData(), feed->segment.GetSize()))
+        {
+            g_Host->PushNull(ctx);
+            return 1;
+        }
+
+        const int id = g_NextFeedId++;
+        g_Feeds[id] = std::move(feed);
+        g_Host->PushNumber(ctx, static_cast<double>(id));
+        return 1;
+    }
+
+    int JsDataFeedClose(novadesk_context ctx)
+    {
+        if (g_Host->GetTop(ctx) < 1 || !g_Host->IsNumber(ctx, 0))
+        {
+            g_Host->ThrowError(ctx, "dataFeed.close(feed) requires a feed id");
+            return 0;
+        }
+        auto it = g_Feeds.find(static_cast<int>(g_Host->GetNumber(ctx, 0)));
+        if (it == g_Feeds.end())
+        {
+            g_Host->PushBool(ctx, 0);
+            return 1;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(g_WatchMutex);
+            for (auto sit = g_Subscriptions.begin(); sit != g_Subscriptions.end();)
+            {
+                if (sit->second.feed == it->second)
+                    sit = g_Subscriptions.erase(sit);
+                else
+                    ++sit;
+            }
+        }
+        g_Feeds.erase(it);
+        g_Host->PushBool(ctx, 1);
+        return 1;
+    }
+
+    int JsDataFeedInfo(novadesk_context ctx)
+    {
+        std::shared_ptr<Feed> feed = GetFeedArg(ctx, "dataFeed.info(feed) requires a feed id");
+        if (!feed)
+            return 0;
+
+        std::vector<std::string> names;
+        std::vector<std::string> types;
+        for (const FeedField &field : feed->reader.GetFields())
+        {
+            names.push_back(field.name);
+            types.push_back(TypeName(field.type));
+        }
+
+        novadesk::Addon info(ctx, g_Host);
+        info.RegisterString("name", feed->name.c_str());
+        info.RegisterNumber("recordCount", static_cast<double>(feed->reader.GetRecordCount()));
+        info.RegisterNumber("generation", static_cast<double>(feed->reader.GetGeneration()));
+        info.RegisterNumber("producerPid", static_cast<double>(feed->reader.GetProducerPid()));
+        info.RegisterArray("fields", names);
+        info.RegisterArray("types", types);
+        return 1;
+    }
+
+    int JsDataFeedGeneration(novadesk_context ctx)
+    {
+        std::shared_ptr<Feed> feed = GetFeedArg(ctx, "dataFeed.generation(feed) requires a feed id");
+        if (!feed)
+            return 0;
+        g_Host->PushNumber(ctx, static_cast<double>(feed->reader.GetGeneration()));
+        return 1;
+    }
+
+    int JsDataFeedRead(novadesk_context ctx)
+    {
+        std::shared_ptr<Feed> feed = GetFeedArg(ctx, "dataFeed.read(feed[, record]) requires a feed id");
+        if (!feed)
+            return 0;
+
+        int index = 0;
+        if (g_Host->GetTop(ctx) > 1 && !g_Host->IsNull(ctx, 1))
+        {
+            if (!g_Host->IsNumber(ctx, 1))
+            {
+                g_Host->ThrowError(ctx, "dataFeed.read(feed, record) requires a numeric record index");
+                return 0;
+            }
+            index = static_cast<int>(g_Host->GetNumber(ctx, 1));
+        }
+
+        FeedSnapshot snap;
+        if (index < 0 || !feed->reader.Read(static_cast<uint32_t>(index), snap))
+        {
+            g_Host->PushNull(ctx);
+            return 1;
+        }
+        g_Host->PushObject(ctx);
+        RegisterRecord(ctx, *feed, static_cast<uint32_t>(index), snap);
+        return 1;
+    }
+
+    int JsDataFeedReadAll(novadesk_context ctx)
+    {
+        std::shared_ptr<Feed> feed = GetFeedArg(ctx, "dataFeed.readAll(feed) requires a feed id");
+        if (!feed)
+            return 0;
+
+        // Records that were never published or are mid-write are left out;
+        // each entry carries its index.
+        FeedSnapshot snap;
+        g_Host->PushArray(ctx);
+        for (uint32_t r = 0; r < feed->reader.GetRecordCount(); ++r)
+        {
+            if (!feed->reader.Read(r, snap))
+                continue;
+            g_Host->ArrayPushObject(ctx);
+            RegisterRecord(ctx, *feed, r, snap);
+            g_Host->Pop(ctx);
+        }
+        return 1;
+    }
+
+    int JsDataFeedSubscribe(novadesk_context ctx)
+    {
+        std::shared_ptr<Feed> feed = GetFeedArg(ctx, "dataFeed.subscribe(feed, callback[, intervalMs]) requires a feed id");
+        if (!feed)
+            return 0;
+        if (g_Host->GetTop(ctx) < 2 || !g_Host->IsFunction(ctx, 1))
+        {
+            g_Host->ThrowError(ctx, "dataFeed.subscribe(feed, callback[, intervalMs]) requires a function");
+            return 0;
+        }
+
+        int intervalMs = kDefaultIntervalMs;
+        if (g_Host->GetTop(ctx) > 2 && !g_Host->IsNull(ctx, 2))
+        {
+            if (!g_Host->IsNumber(ctx, 2))
+            {
+                g_Host->ThrowError(ctx, "dataFeed.subscribe(feed, callback, intervalMs) requires a numeric interval");
+                return 0;
+            }
+            intervalMs = (std::max)(1, (std::min)(60000, static_cast<int>(g_Host->GetNumber(ctx, 2))));
+        }
+
+        Subscription sub;
+        sub.feed = feed;
+        sub.fn = g_Host->JsGetFunctionPtr(ctx, 1);
+        sub.interval = std::chrono::milliseconds(intervalMs);
+        sub.nextPoll = std::chrono::steady_clock::now() + sub.interval;
+        // Start from the current state so only later publishes are reported.
+        sub.generation = feed->reader.GetGeneration();
+        sub.sequences.resize(feed->reader.GetRecordCount());
+        sub.pending.assign(feed->reader.GetRecordCount(), 0);
+        for (uint32_t r = 0; r < feed->reader.GetRecordCount(); ++r)
+            sub.sequences[r] = feed->reader.GetSequence(r);
+
+        int id = 0;
+        {
+            std::lock_guard<std::mutex> lock(g_WatchMutex);
+            id = g_NextSubscriptionId++;
+            g_Subscriptions[id] = std::move(sub);
+            if (!g_Watcher.joinable())
+                g_Watcher = std::thread(&WatchThread);
+        }
+        g_WatchCv.notify_all();
+
+        g_Host->PushNumber(ctx, static_cast<double>(id));
+        return 1;
+    }
+
+    int JsDataFeedUnsubscribe(novadesk_context ctx)
+    {
+        if (g_Host->GetTop(ctx) < 1 || !g_Host->IsNumber(ctx, 0))
+        {
+            g_Host->ThrowError(ctx, "dataFeed.unsubscribe(subscription) requires a subscription id");
+            return 0;
+        }
+        size_t erased = 0;
+        {
+            std::lock_guard<std::mutex> lock(g_WatchMutex);
+            erased = g_Subscriptions.erase(static_cast<int>(g_Host->GetNumber(ctx, 0)));
+        }
+        g_Host->PushBool(ctx, erased ? 1 : 0);
+        return 1;
+    }
+} // namespace
+
+NOVADESK_ADDON_INIT(ctx, hMsgWnd, host)
+{
+    g_Host = host;
+    g_MessageWindow = hMsgWnd;
+
+    novadesk::Addon addon(ctx, host);
+    addon.RegisterString("name", "DataFeed");
+    addon.RegisterString("version", "1.0.0");
+
+    addon.RegisterFunction("open", JsDataFeedOpen, 1);
+    addon.RegisterFunction("close", JsDataFeedClose, 1);
+    addon.RegisterFunction("info", JsDataFeedInfo, 1);
+    addon.RegisterFunction("generation", JsDataFeedGeneration, 1);
+    addon.RegisterFunction("read", JsDataFeedRead, 2);
+    addon.RegisterFunction("readAll", JsDataFeedReadAll, 1);
+    addon.RegisterFunction("subscribe", JsDataFeedSubscribe, 3);
+    addon.RegisterFunction("unsubscribe", JsDataFeedUnsubscribe, 1);
+}
+
+NOVADESK_ADDON_UNLOAD()
+{
+    StopWatcher();
+    g_Feeds.clear();
+}
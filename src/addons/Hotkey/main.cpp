@@ -16,8 +16,10 @@
 #include <atomic>
 #include <cstdint>
 #include <cwctype>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -36,22 +38,86 @@ namespace
     {
         UINT modifiers = 0;
         UINT vk = 0;
-        bool pressed = false;
         void* onKeyDown = nullptr;
         void* onKeyUp = nullptr;
     };
 
+    // Authoritative registrations, owned by the script thread. The keyboard
+    // hook never touches these; it reads the compiled g_hotkeyTable instead.
     std::unordered_map<int, HotkeyEntry> g_hotkeys;
     std::mutex g_hotkeyMutex;
     int g_nextHotkeyId = 10000;
-    HHOOK g_keyboardHook = nullptr;
 
-    struct DispatchEvent
+    // The keyboard hook is installed on, and called on, a dedicated thread
+    // with its own message loop, so keystrokes never wait for the script
+    // thread. Started with the first hotkey, stopped with the last.
+    std::thread g_hookThread;
+    DWORD g_hookThreadId = 0;
+    std::atomic<bool> g_hooked{false};
+
+    /*
+    ** Immutable lookup table compiled from g_hotkeys for the keyboard hook.
+    ** 'index' holds hotkey slots grouped by virtual key (lists 0-255) and by
+    ** the modifier they require (lists 256-259, alt/ctrl/shift/win), so a
+    ** keystroke only visits the hotkeys it can change.
+    **
+    ** Registration builds a new table and swaps the pointer (read-copy-
+    ** update). The replaced table is freed once no hook call is inside it.
+    */
+    struct CompiledHotkey
     {
         int id = -1;
-        bool down = false;
+        UINT vk = 0;
+        UINT modifiers = 0;
+        std::atomic<bool> pressed{false}; // written by the hook only
     };
 
+    constexpr size_t kModifierListBase = 256;
+    constexpr size_t kListCount = kModifierListBase + 4;
+
+    struct HotkeyTable
+    {
+        std::unique_ptr<CompiledHotkey[]> hotkeys;
+        size_t count = 0;
+        std::vector<uint32_t> index;
+        uint32_t begin[kListCount + 1] = {};
+    };
+
+    std::atomic<HotkeyTable*> g_hotkeyTable{nullptr};
+    std::atomic<int> g_hookReaders{0};
+    std::vector<HotkeyTable*> g_retiredTables;
+
+    /*
+    ** Hook thread to script thread event queue: a fixed single-producer,
+    ** single-consumer ring. One delivery is posted when the ring goes from
+    ** idle to pending; DrainHotkeyEvents handles everything queued.
+    */
+    struct HotkeyEvent
+    {
+        int id;
+        bool down;
+    };
+
+    constexpr uint32_t kEventRingSize = 256; // power of two
+    HotkeyEvent g_eventRing[kEventRingSize];
+    std::atomic<uint32_t> g_eventHead{0}; // next write, hook
+    std::atomic<uint32_t> g_eventTail{0}; // next read, script thread
+    std::atomic<bool> g_dispatchPending{false};
+
+    // Hook latency, in QueryPerformanceCounter ticks.
+    std::atomic<uint64_t> g_hookCalls{0};
+    std::atomic<uint64_t> g_hookTicksTotal{0};
+    std::atomic<uint64_t> g_hookTicksMax{0};
+    std::atomic<uint64_t> g_hookTicksLast{0};
+    std::atomic<uint64_t> g_eventsPosted{0};
+    std::atomic<uint64_t> g_eventsDropped{0};
+    double g_ticksToMicros = 0.0;
+
+    // Key state as seen by the hook, kept from its own events so matching
+    // does not query the system per keystroke. Hook thread only.
+    uint64_t g_keyDown[4] = {};
+    uint8_t g_modifierKeys = 0; // one bit per physical modifier key, see kModifierVks
+
     std::wstring TrimUpperCopy(std::wstring s)
     {
         auto isSpace = [](wchar_t c) { return c == L' ' || c == L'\t' || c == L'\r' || c == L'\n'; };
@@ -146,147 +212,409 @@ namespace
         return vk != 0;
     }
 
-    bool IsModifierVk(UINT vk)
+    // Left/right modifier keys in g_modifierKeys bit order, with the MOD_*
+    // flag each one satisfies.
+    constexpr struct
     {
-        return vk == VK_CONTROL || vk == VK_LCONTROL || vk == VK_RCONTROL ||
-               vk == VK_MENU || vk == VK_LMENU || vk == VK_RMENU ||
-               vk == VK_SHIFT || vk == VK_LSHIFT || vk == VK_RSHIFT ||
-               vk == VK_LWIN || vk == VK_RWIN;
-    }
+        UINT vk;
+        UINT modifier;
+    } kModifierVks[] = {
+        {VK_LMENU, MOD_ALT}, {VK_RMENU, MOD_ALT},
+        {VK_LCONTROL, MOD_CONTROL}, {VK_RCONTROL, MOD_CONTROL},
+        {VK_LSHIFT, MOD_SHIFT}, {VK_RSHIFT, MOD_SHIFT},
+        {VK_LWIN, MOD_WIN}, {VK_RWIN, MOD_WIN},
+    };
 
-    bool IsDownWithEvent(UINT checkVk, UINT eventVk, bool eventDown)
+    // Bit of vk in g_modifierKeys, or 0 if vk is not a modifier. The generic
+    // VK_CONTROL/VK_MENU/VK_SHIFT codes are folded onto the left key.
+    uint8_t ModifierKeyBit(UINT vk)
     {
-        if (checkVk == VK_CONTROL)
+        switch (vk)
         {
-            if (eventVk == VK_LCONTROL || eventVk == VK_RCONTROL || eventVk == VK_CONTROL)
-                return eventDown;
-            return (GetAsyncKeyState(VK_CONTROL) & 0x8000) != 0;
+        case VK_MENU:
+        case VK_LMENU: return 0x01;
+        case VK_RMENU: return 0x02;
+        case VK_CONTROL:
+        case VK_LCONTROL: return 0x04;
+        case VK_RCONTROL: return 0x08;
+        case VK_SHIFT:
+        case VK_LSHIFT: return 0x10;
+        case VK_RSHIFT: return 0x20;
+        case VK_LWIN: return 0x40;
+        case VK_RWIN: return 0x80;
+        default: return 0;
         }
-        if (checkVk == VK_MENU)
+    }
+
+    UINT ModifierMask(uint8_t keys)
+    {
+        UINT mask = 0;
+        for (size_t i = 0; i < 8; ++i)
         {
-            if (eventVk == VK_LMENU || eventVk == VK_RMENU || eventVk == VK_MENU)
-                return eventDown;
-            return (GetAsyncKeyState(VK_MENU) & 0x8000) != 0;
+            if (keys & (1u << i))
+                mask |= kModifierVks[i].modifier;
         }
-        if (checkVk == VK_SHIFT)
+        return mask;
+    }
+
+    // List of hotkeys that require a MOD_* flag.
+    size_t ModifierList(UINT modifier)
+    {
+        switch (modifier)
         {
-            if (eventVk == VK_LSHIFT || eventVk == VK_RSHIFT || eventVk == VK_SHIFT)
-                return eventDown;
-            return (GetAsyncKeyState(VK_SHIFT) & 0x8000) != 0;
+        case MOD_ALT: return kModifierListBase + 0;
+        case MOD_CONTROL: return kModifierListBase + 1;
+        case MOD_SHIFT: return kModifierListBase + 2;
+        default: return kModifierListBase + 3;
         }
-        if (checkVk == VK_LWIN || checkVk == VK_RWIN)
+    }
+
+    bool IsKeyDown(UINT vk)
+    {
+        return (g_keyDown[(vk >> 6) & 3] >> (vk & 63)) & 1;
+    }
+
+    void SetKeyDown(UINT vk, bool down)
+    {
+        const uint64_t bit = 1ull << (vk & 63);
+        if (down)
+            g_keyDown[(vk >> 6) & 3] |= bit;
+        else
+            g_keyDown[(vk >> 6) & 3] &= ~bit;
+    }
+
+    // Seed the hook's key state from the system when the hook is installed.
+    void SyncKeyState()
+    {
+        g_modifierKeys = 0;
+        for (UINT vk = 1; vk < 256; ++vk)
         {
-            if (eventVk == checkVk)
-                return eventDown;
-            return (GetAsyncKeyState(checkVk) & 0x8000) != 0;
+            const bool down = (GetAsyncKeyState(static_cast<int>(vk)) & 0x8000) != 0;
+            SetKeyDown(vk, down);
+            if (down)
+                g_modifierKeys |= ModifierKeyBit(vk);
         }
-        if (eventVk == checkVk)
-            return eventDown;
-        return (GetAsyncKeyState(checkVk) & 0x8000) != 0;
     }
 
-    bool IsHotkeyPressedNow(const HotkeyEntry &hk, UINT eventVk, bool eventDown)
+    // Modifier releases can be swallowed (secure desktop, another hook
+    // eating the event). Confirm the modifiers we believe are held before a
+    // hotkey may match on them; only runs while some modifier is down.
+    void ConfirmModifiers()
     {
-        if ((hk.modifiers & MOD_CONTROL) && !IsDownWithEvent(VK_CONTROL, eventVk, eventDown))
-            return false;
-        if ((hk.modifiers & MOD_ALT) && !IsDownWithEvent(VK_MENU, eventVk, eventDown))
-            return false;
-        if ((hk.modifiers & MOD_SHIFT) && !IsDownWithEvent(VK_SHIFT, eventVk, eventDown))
-            return false;
-        if ((hk.modifiers & MOD_WIN) &&
-            !IsDownWithEvent(VK_LWIN, eventVk, eventDown) &&
-            !IsDownWithEvent(VK_RWIN, eventVk, eventDown))
-            return false;
-        return IsDownWithEvent(hk.vk, eventVk, eventDown);
+        for (size_t i = 0; i < 8; ++i)
+        {
+            const uint8_t bit = static_cast<uint8_t>(1u << i);
+            if ((g_modifierKeys & bit) && !(GetAsyncKeyState(static_cast<int>(kModifierVks[i].vk)) & 0x8000))
+                g_modifierKeys &= static_cast<uint8_t>(~bit);
+        }
     }
 
-    void DispatchHotkey(void *data)
+    HotkeyTable* BuildTable(const HotkeyTable* previous)
     {
-        auto *evt = reinterpret_cast<DispatchEvent *>(data);
-        if (!evt)
-            return;
+        auto* table = new HotkeyTable();
+        if (g_hotkeys.empty())
+            return table;
 
-        HotkeyEntry entry{};
+        std::vector<int> ids;
+        ids.reserve(g_hotkeys.size());
+        for (const auto& kv : g_hotkeys)
+            ids.push_back(kv.first);
+        std::sort(ids.begin(), ids.end());
+
+        table->count = ids.size();
+        table->hotkeys.reset(new CompiledHotkey[table->count]);
+
+        uint32_t sizes[kListCount] = {};
+        for (size_t i = 0; i < table->count; ++i)
         {
-            std::lock_guard<std::mutex> lock(g_hotkeyMutex);
-            auto it = g_hotkeys.find(evt->id);
-            if (it != g_hotkeys.end())
+            const HotkeyEntry& entry = g_hotkeys[ids[i]];
+            CompiledHotkey& hk = table->hotkeys[i];
+            hk.id = ids[i];
+            hk.vk = entry.vk & 0xFF;
+            hk.modifiers = entry.modifiers & (MOD_ALT | MOD_CONTROL | MOD_SHIFT | MOD_WIN);
+
+            // Carry over held state so a key-up still reaches hotkeys that
+            // were down while another one was registered.
+            if (previous)
             {
-                entry = it->second;
+                for (size_t p = 0; p < previous->count; ++p)
+                {
+                    if (previous->hotkeys[p].id == hk.id)
+                    {
+                        hk.pressed.store(previous->hotkeys[p].pressed.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                        break;
+                    }
+                }
+            }
+
+            ++sizes[hk.vk];
+            for (UINT modifier : {MOD_ALT, MOD_CONTROL, MOD_SHIFT, MOD_WIN})
+            {
+                if (hk.modifiers & modifier)
+                    ++sizes[ModifierList(modifier)];
             }
         }
 
-        void *fn = evt->down ? entry.onKeyDown : entry.onKeyUp;
-        auto *handle = reinterpret_cast<JsFunctionHandleMirror *>(fn);
-        if (handle && handle->ctx)
+        for (size_t list = 0; list < kListCount; ++list)
+            table->begin[list + 1] = table->begin[list] + sizes[list];
+        table->index.resize(table->begin[kListCount]);
+
+        uint32_t fill[kListCount];
+        std::copy(table->begin, table->begin + kListCount, fill);
+        for (size_t i = 0; i < table->count; ++i)
         {
-            g_Host->JsCallFunctionNoArgs(nullptr, fn);
+            const CompiledHotkey& hk = table->hotkeys[i];
+            table->index[fill[hk.vk]++] = static_cast<uint32_t>(i);
+            for (UINT modifier : {MOD_ALT, MOD_CONTROL, MOD_SHIFT, MOD_WIN})
+            {
+                if (hk.modifiers & modifier)
+                    table->index[fill[ModifierList(modifier)]++] = static_cast<uint32_t>(i);
+            }
         }
-        delete evt;
+        return table;
+    }
+
+    // Free retired tables once no hook call can still be reading them. A
+    // hook call enters g_hookReaders before loading the table pointer, so
+    // seeing zero after the swap means every later call sees the new table.
+    void ReclaimTables()
+    {
+        if (g_retiredTables.empty() || g_hookReaders.load() != 0)
+            return;
+        for (HotkeyTable* table : g_retiredTables)
+            delete table;
+        g_retiredTables.clear();
+    }
+
+    // Rebuild and publish the hook's table. Call with g_hotkeyMutex held.
+    void PublishTable()
+    {
+        HotkeyTable* table = BuildTable(g_hotkeyTable.load());
+        HotkeyTable* old = g_hotkeyTable.exchange(table);
+        if (old)
+            g_retiredTables.push_back(old);
+        ReclaimTables();
+    }
+
+    void DrainHotkeyEvents(novadesk_context ctx)
+    {
+        g_dispatchPending.store(false);
+
+        uint32_t tail = g_eventTail.load(std::memory_order_relaxed);
+        const uint32_t head = g_eventHead.load(std::memory_order_acquire);
+        while (tail != head)
+        {
+            const HotkeyEvent evt = g_eventRing[tail & (kEventRingSize - 1)];
+            g_eventTail.store(++tail, std::memory_order_release);
+
+            HotkeyEntry entry{};
+            {
+                std::lock_guard<std::mutex> lock(g_hotkeyMutex);
+                auto it = g_hotkeys.find(evt.id);
+                if (it != g_hotkeys.end())
+                {
+                    entry = it->second;
+                }
+            }
+
+            void *fn = evt.down ? entry.onKeyDown : entry.onKeyUp;
+            auto *handle = reinterpret_cast<JsFunctionHandleMirror *>(fn);
+            if (handle && handle->ctx)
+            {
+                g_Host->JsCallFunctionNoArgs(ctx, fn);
+            }
+        }
+    }
+
+    void DeliverHotkeys(novadesk_context ctx, void *)
+    {
+        DrainHotkeyEvents(ctx);
+    }
+
+    // Hosts without PostToMain get a plain dispatch and no call context.
+    void DispatchHotkeys(void *)
+    {
+        DrainHotkeyEvents(nullptr);
     }
 
     void PostHotkeyEvent(int id, bool down)
     {
-        if (!g_MessageWindow)
+        const bool hasPostToMain = NOVADESK_HOST_HAS(g_Host, PostToMain);
+        if (!hasPostToMain && !g_MessageWindow)
             return;
-        auto *evt = new DispatchEvent{};
-        evt->id = id;
-        evt->down = down;
-        PostMessageW(g_MessageWindow, WM_USER + 101, reinterpret_cast<WPARAM>(&DispatchHotkey), reinterpret_cast<LPARAM>(evt));
+
+        const uint32_t head = g_eventHead.load(std::memory_order_relaxed);
+        if (head - g_eventTail.load(std::memory_order_acquire) >= kEventRingSize)
+        {
+            g_eventsDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        g_eventRing[head & (kEventRingSize - 1)] = HotkeyEvent{id, down};
+        g_eventHead.store(head + 1, std::memory_order_release);
+        g_eventsPosted.fetch_add(1, std::memory_order_relaxed);
+
+        if (!g_dispatchPending.exchange(true))
+        {
+            if (!hasPostToMain)
+                novadesk::Dispatcher(g_MessageWindow).Dispatch(&DispatchHotkeys);
+            else if (!g_Host->PostToMain(&DeliverHotkeys, nullptr))
+                g_dispatchPending.store(false); // unloading; let a later event retry
+        }
+    }
+
+    // Re-evaluate the hotkeys of one table list. 'confirmKey' is set for
+    // modifier events, where the hotkey's own key was not part of the event
+    // and its remembered state is confirmed before a press fires.
+    void UpdateHotkeys(const HotkeyTable &table, size_t list, UINT modifiers, bool confirmKey)
+    {
+        for (uint32_t i = table.begin[list]; i < table.begin[list + 1]; ++i)
+        {
+            CompiledHotkey &hk = table.hotkeys[table.index[i]];
+            bool nowPressed = (modifiers & hk.modifiers) == hk.modifiers && IsKeyDown(hk.vk);
+            if (nowPressed && confirmKey && !hk.pressed.load(std::memory_order_relaxed) &&
+                !(GetAsyncKeyState(static_cast<int>(hk.vk)) & 0x8000))
+            {
+                SetKeyDown(hk.vk, false);
+                nowPressed = false;
+            }
+            if (nowPressed != hk.pressed.load(std::memory_order_relaxed))
+            {
+                hk.pressed.store(nowPressed, std::memory_order_relaxed);
+                PostHotkeyEvent(hk.id, nowPressed);
+            }
+        }
+    }
+
+    void RecordHookTime(const LARGE_INTEGER &start)
+    {
+        LARGE_INTEGER end;
+        QueryPerformanceCounter(&end);
+        const uint64_t ticks = static_cast<uint64_t>(end.QuadPart - start.QuadPart);
+        g_hookCalls.fetch_add(1, std::memory_order_relaxed);
+        g_hookTicksTotal.fetch_add(ticks, std::memory_order_relaxed);
+        g_hookTicksLast.store(ticks, std::memory_order_relaxed);
+        uint64_t max = g_hookTicksMax.load(std::memory_order_relaxed);
+        while (ticks > max && !g_hookTicksMax.compare_exchange_weak(max, ticks, std::memory_order_relaxed))
+        {
+        }
     }
 
     LRESULT CALLBACK KeyboardHookProc(int nCode, WPARAM wParam, LPARAM lParam)
     {
         if (nCode == HC_ACTION && lParam)
         {
+            LARGE_INTEGER start;
+            QueryPerformanceCounter(&start);
+
             const auto *kb = reinterpret_cast<KBDLLHOOKSTRUCT *>(lParam);
-            const UINT vk = kb->vkCode;
+            const UINT vk = kb->vkCode & 0xFF;
             const bool isDown = (wParam == WM_KEYDOWN || wParam == WM_SYSKEYDOWN);
             const bool isUp = (wParam == WM_KEYUP || wParam == WM_SYSKEYUP);
             if (isDown || isUp)
             {
-                const bool relevant = IsModifierVk(vk);
-                std::lock_guard<std::mutex> lock(g_hotkeyMutex);
-                for (auto &kv : g_hotkeys)
+                const uint8_t modifierBit = ModifierKeyBit(vk);
+                const bool wasDown = IsKeyDown(vk);
+                SetKeyDown(vk, isDown);
+                if (modifierBit)
                 {
-                    HotkeyEntry &hk = kv.second;
-                    if (!relevant && vk != hk.vk)
-                    {
-                        continue;
-                    }
+                    if (isDown)
+                        g_modifierKeys |= modifierBit;
+                    else
+                        g_modifierKeys &= static_cast<uint8_t>(~modifierBit);
+                }
+                else if (isDown && !wasDown && g_modifierKeys)
+                {
+                    ConfirmModifiers();
+                }
 
-                    const bool nowPressed = IsHotkeyPressedNow(hk, vk, isDown);
-                    if (nowPressed && !hk.pressed)
-                    {
-                        hk.pressed = true;
-                        PostHotkeyEvent(kv.first, true);
-                    }
-                    else if (!nowPressed && hk.pressed)
-                    {
-                        hk.pressed = false;
-                        PostHotkeyEvent(kv.first, false);
-                    }
+                g_hookReaders.fetch_add(1);
+                const HotkeyTable *table = g_hotkeyTable.load();
+                if (table && table->count)
+                {
+                    const UINT modifiers = ModifierMask(g_modifierKeys);
+                    if (modifierBit)
+                        UpdateHotkeys(*table, ModifierList(ModifierMask(modifierBit)), modifiers, true);
+                    else
+                        UpdateHotkeys(*table, vk, modifiers, false);
                 }
+                g_hookReaders.fetch_sub(1);
             }
+
+            RecordHookTime(start);
         }
-        return CallNextHookEx(g_keyboardHook, nCode, wParam, lParam);
+        return CallNextHookEx(nullptr, nCode, wParam, lParam);
     }
 
-    void EnsureKeyboardHook()
+    void HookThread(HANDLE ready)
     {
-        if (!g_keyboardHook)
+        // Low-level hooks are dropped when they stall, so keep this thread
+        // ahead of ordinary work.
+        SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_HIGHEST);
+
+        // Create the message queue before the starter can post WM_QUIT.
+        MSG msg;
+        PeekMessageW(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
+        g_hookThreadId = GetCurrentThreadId();
+
+        // The hook runs on this thread, so its state is seeded here.
+        SyncKeyState();
+        HHOOK hook = SetWindowsHookExW(WH_KEYBOARD_LL, KeyboardHookProc, GetModuleHandleW(nullptr), 0);
+        g_hooked.store(hook != nullptr);
+        SetEvent(ready);
+        if (!hook)
+            return;
+
+        while (GetMessageW(&msg, nullptr, 0, 0) > 0)
         {
-            g_keyboardHook = SetWindowsHookExW(WH_KEYBOARD_LL, KeyboardHookProc, GetModuleHandleW(nullptr), 0);
+            TranslateMessage(&msg);
+            DispatchMessageW(&msg);
         }
+
+        UnhookWindowsHookEx(hook);
+        g_hooked.store(false);
     }
 
-    void MaybeRemoveKeyboardHook()
+    bool EnsureKeyboardHook()
     {
-        if (g_hotkeys.empty() && g_keyboardHook)
+        if (g_hookThread.joinable())
+            return g_hooked.load();
+
+        if (g_ticksToMicros == 0.0)
         {
-            UnhookWindowsHookEx(g_keyboardHook);
-            g_keyboardHook = nullptr;
+            LARGE_INTEGER freq;
+            QueryPerformanceFrequency(&freq);
+            g_ticksToMicros = 1e6 / static_cast<double>(freq.QuadPart);
         }
+
+        HANDLE ready = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        if (!ready)
+            return false;
+        g_hookThread = std::thread(HookThread, ready);
+        WaitForSingleObject(ready, INFINITE);
+        CloseHandle(ready);
+
+        if (!g_hooked.load())
+        {
+            g_hookThread.join();
+            g_hookThreadId = 0;
+            return false;
+        }
+        return true;
+    }
+
+    void StopKeyboardHook()
+    {
+        if (!g_hookThread.joinable())
+            return;
+        PostThreadMessageW(g_hookThreadId, WM_QUIT, 0, 0);
+        g_hookThread.join();
+        g_hookThreadId = 0;
+    }
+
+    void MaybeRemoveKeyboardHook()
+    {
+        if (g_hotkeys.empty())
+            StopKeyboardHook();
     }
 
     int RegisterHotkey(const std::wstring &hotkey, void *keyDownFn, void *keyUpFn)
@@ -296,8 +624,7 @@ namespace
         if (!ParseHotkeyString(hotkey, modifiers, vk))
             return -1;
 
-        EnsureKeyboardHook();
-        if (!g_keyboardHook)
+        if (!EnsureKeyboardHook())
             return -1;
 
         std::lock_guard<std::mutex> lock(g_hotkeyMutex);
@@ -308,6 +635,7 @@ namespace
         entry.onKeyDown = keyDownFn;
         entry.onKeyUp = keyUpFn;
         g_hotkeys[id] = entry;
+        PublishTable();
         return id;
     }
 
@@ -318,6 +646,7 @@ namespace
         if (it == g_hotkeys.end())
             return false;
         g_hotkeys.erase(it);
+        PublishTable();
         MaybeRemoveKeyboardHook();
         return true;
     }
@@ -327,6 +656,12 @@ namespace
         std::lock_guard<std::mutex> lock(g_hotkeyMutex);
         g_hotkeys.clear();
         MaybeRemoveKeyboardHook();
+
+        // The hook thread has exited, so nothing can be reading any table.
+        delete g_hotkeyTable.exchange(nullptr);
+        for (HotkeyTable* table : g_retiredTables)
+            delete table;
+        g_retiredTables.clear();
     }
 
     bool ReadHandler(novadesk_context ctx, int argIndex, void *&outDown, void *&outUp)
@@ -410,6 +745,22 @@ namespace
         g_Host->PushBool(ctx, ok ? 1 : 0);
         return 1;
     }
+
+    int JsHotkeyStats(novadesk_context ctx)
+    {
+        const uint64_t calls = g_hookCalls.load(std::memory_order_relaxed);
+        const double total = static_cast<double>(g_hookTicksTotal.load(std::memory_order_relaxed));
+
+        g_Host->PushObject(ctx);
+        g_Host->RegisterNumber(ctx, "hookCalls", static_cast<double>(calls));
+        g_Host->RegisterNumber(ctx, "lastMicros", static_cast<double>(g_hookTicksLast.load(std::memory_order_relaxed)) * g_ticksToMicros);
+        g_Host->RegisterNumber(ctx, "avgMicros", calls ? total * g_ticksToMicros / static_cast<double>(calls) : 0.0);
+        g_Host->RegisterNumber(ctx, "maxMicros", static_cast<double>(g_hookTicksMax.load(std::memory_order_relaxed)) * g_ticksToMicros);
+        g_Host->RegisterNumber(ctx, "events", static_cast<double>(g_eventsPosted.load(std::memory_order_relaxed)));
+        g_Host->RegisterNumber(ctx, "dropped", static_cast<double>(g_eventsDropped.load(std::memory_order_relaxed)));
+        g_Host->RegisterBool(ctx, "hooked", g_hooked.load() ? 1 : 0);
+        return 1;
+    }
 } // namespace
 
 NOVADESK_ADDON_INIT(ctx, hMsgWnd, host)
@@ -418,9 +769,10 @@ NOVADESK_ADDON_INIT(ctx, hMsgWnd, host)
     g_MessageWindow = hMsgWnd;
     novadesk::Addon addon(ctx, host);
     addon.RegisterString("name", "Hotkey");
-    addon.RegisterString("version", "1.0.0");
+    addon.RegisterString("version", "1.1.0");
     addon.RegisterFunction("register", JsHotkeyRegister, 2);
     addon.RegisterFunction("unregister", JsHotkeyUnregister, 1);
+    addon.RegisterFunction("stats", JsHotkeyStats, 0);
 }
 
 NOVADESK_ADDON_UNLOAD()
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <Windows.h>
+#include <stddef.h>
+#include <stdint.h>
 
 /**
  * @file novadesk_addon.h
@@ -23,6 +25,10 @@ typedef void* novadesk_context;
  * 
  * Addons interact with the JavaScript engine exclusively through these functions.
  * Host API functions MUST only be called from the main thread.
+ *
+ * The layout never changes; new entries are only ever appended. An addon may
+ * run on a host built before an entry it uses was added; check those with
+ * NOVADESK_HOST_HAS first.
  */
 struct NovadeskHostAPI {
     /** Export properties to JavaScript */
@@ -70,17 +76,72 @@ struct NovadeskHostAPI {
     void (*JsCallFunction)(novadesk_context ctx, void* funcPtr, int nargs);
     void (*JsCallFunctionNoArgs)(novadesk_context ctx, void* funcPtr);
     void (*ArrayPushObject)(novadesk_context ctx);
+
+    /** Typed arrays (appended; check with NOVADESK_HOST_HAS) */
+    void (*RegisterArrayFloat32)(novadesk_context ctx, const char* name, const float* values, size_t count);
+
+    /**
+     * Image store (appended; check with NOVADESK_HOST_HAS).
+     * Keeps a copy of encoded image bytes under a "memory://..." path that image
+     * elements accept like a file path. Returns 0 if the path or data is invalid.
+     * May be called from any thread; 'ctx' may be null.
+     */
+    int (*StoreImage)(novadesk_context ctx, const char* path, const unsigned char* data, size_t size);
+
+    /**
+     * Async helpers (appended; check with NOVADESK_HOST_HAS).
+     *
+     * QueueWork runs work(payload) on a worker thread shared by all addons.
+     * PostToMain runs callback(ctx, payload) on the main thread. Everything posted
+     * before the main loop gets to it is delivered as one batch, in order. 'ctx'
+     * is a fresh call context: push values and call JsCallFunction with arguments
+     * as inside a registered function.
+     *
+     * CreatePromise may only be called inside a registered function. It pushes a
+     * Promise (leave it on top to return it) and returns its handle.
+     * SettlePromise resolves (resolve != 0) or rejects it. 'build', if given, runs
+     * on the main thread and pushes the value; ThrowError in it rejects instead.
+     * A promise settles once; later calls are ignored and their 'build' is not run.
+     *
+     * QueueWork, PostToMain and SettlePromise may be called from any thread. They
+     * return 0 if nothing was queued. When an addon unloads, the host drops its
+     * queued work and waits for its running work, then calls NovadeskAddonUnload,
+     * then drops its undelivered callbacks and rejects its pending promises.
+     */
+    int (*QueueWork)(void (*work)(void* payload), void* payload);
+    int (*PostToMain)(void (*callback)(novadesk_context ctx, void* payload), void* payload);
+    void* (*CreatePromise)(novadesk_context ctx);
+    int (*SettlePromise)(void* promise, int resolve, void (*build)(novadesk_context ctx, void* payload), void* payload);
 };
 
+/**
+ * @brief True if 'host' provides the appended entry 'member'.
+ * Hosts that know about appended entries report the size of their table
+ * through NovadeskAddonSetHostApiSize before NovadeskAddonInit; on older hosts
+ * it stays 0 and only the entries up to ArrayPushObject are used.
+ */
+#define NOVADESK_HOST_HAS(host, member) \
+    (novadesk::HostApiSize() >= offsetof(NovadeskHostAPI, member) + sizeof((host)->member) && (host)->member != NULL)
+
 // Function signatures for the DLL entry points
 typedef void (*NovadeskAddonInitFn)(novadesk_context ctx, HWND hMsgWnd, const NovadeskHostAPI* host);
 typedef void (*NovadeskAddonUnloadFn)();
+typedef uint32_t (*NovadeskAddonSetHostApiSizeFn)(uint32_t hostSize);
 
 /**
  * @brief Defines the main entry point for the addon.
  * Called when system.loadAddon() is executed.
+ *
+ * Also exports NovadeskAddonSetHostApiSize. Hosts that have it call it first
+ * with the size of their table and get back the size the addon was built
+ * against. Addons without it load as before.
  */
-#define NOVADESK_ADDON_INIT(ctx, hMsgWnd, host) extern "C" __declspec(dllexport) void NovadeskAddonInit(novadesk_context ctx, HWND hMsgWnd, const NovadeskHostAPI* host)
+#define NOVADESK_ADDON_INIT(ctx, hMsgWnd, host) \
+    extern "C" __declspec(dllexport) uint32_t NovadeskAddonSetHostApiSize(uint32_t hostSize) { \
+        novadesk::HostApiSize() = hostSize; \
+        return (uint32_t)sizeof(NovadeskHostAPI); \
+    } \
+    extern "C" __declspec(dllexport) void NovadeskAddonInit(novadesk_context ctx, HWND hMsgWnd, const NovadeskHostAPI* host)
 
 /**
  * @brief Defines the optional cleanup hook.
@@ -95,6 +156,12 @@ typedef void (*NovadeskAddonUnloadFn)();
 #include <string>
 
 namespace novadesk {
+
+    /// Size of the host's NovadeskHostAPI; 0 until a host that knows it says so.
+    inline uint32_t& HostApiSize() {
+        static uint32_t size = 0;
+        return size;
+    }
     
     /**
      * @class JsFunction
@@ -137,6 +204,9 @@ namespace novadesk {
     /**
      * @class Dispatcher
      * @brief Mechanism for safe communication from background threads to the main thread.
+     *
+     * One window message per call, and the function gets no call context. Hosts
+     * with NovadeskHostAPI::PostToMain batch deliveries and pass one.
      */
     class Dispatcher {
     public:
@@ -151,6 +221,51 @@ namespace novadesk {
         static const UINT WM_NOVADESK_DISPATCH = WM_USER + 101;
     };
 
+    /**
+     * @brief Runs work() on the host thread pool and returns a Promise for its result.
+     *
+     * Call inside a registered function; the Promise is left on top of the stack.
+     * work() runs on a worker thread and returns a value; settle(ctx, value) then
+     * runs on the main thread and pushes the JavaScript result (or calls
+     * ThrowError to reject). Returns false if the host has no async helpers.
+     */
+    template <typename Work, typename Settle>
+    bool RunAsync(novadesk_context ctx, const NovadeskHostAPI* host, Work work, Settle settle) {
+        if (!NOVADESK_HOST_HAS(host, QueueWork) || !NOVADESK_HOST_HAS(host, CreatePromise) ||
+            !NOVADESK_HOST_HAS(host, SettlePromise)) return false;
+
+        using Result = decltype(work());
+        struct Job {
+            const NovadeskHostAPI* host;
+            void* promise;
+            Work work;
+            Settle settle;
+            Result result;
+
+            static void Run(void* p) {
+                Job* job = static_cast<Job*>(p);
+                job->result = job->work();
+                if (!job->host->SettlePromise(job->promise, 1, &Job::Build, job)) delete job;
+            }
+
+            static void Build(novadesk_context c, void* p) {
+                Job* job = static_cast<Job*>(p);
+                job->settle(c, job->result);
+                delete job;
+            }
+        };
+
+        void* promise = host->CreatePromise(ctx);
+        if (!promise) return false;
+
+        Job* job = new Job{host, promise, static_cast<Work&&>(work), static_cast<Settle&&>(settle), Result()};
+        if (!host->QueueWork(&Job::Run, job)) {
+            host->SettlePromise(promise, 0, nullptr, nullptr);
+            delete job;
+        }
+        return true;
+    }
+
     /**
      * @class Addon
      * @brief The main C++ helper for creating addons and registering properties/functions.
@@ -192,6 +307,16 @@ namespace novadesk {
             m_host->RegisterArrayNumber(m_ctx, name, values.data(), (size_t)values.size());
         }
 
+        /// Registers a Float32Array, copied in one block; a plain array on hosts without typed arrays.
+        void RegisterArray(const char* name, const std::vector<float>& values) {
+            if (NOVADESK_HOST_HAS(m_host, RegisterArrayFloat32)) {
+                m_host->RegisterArrayFloat32(m_ctx, name, values.data(), (size_t)values.size());
+                return;
+            }
+            std::vector<double> numbers(values.begin(), values.end());
+            m_host->RegisterArrayNumber(m_ctx, name, numbers.data(), (size_t)numbers.size());
+        }
+
         /** Stack & Data Access Utilities */
         int GetTop() { return m_host->GetTop(m_ctx); }
         void Pop() { m_host->Pop(m_ctx); }
@@ -6,55 +6,80 @@
  * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
  
 #include "ImageUtils.h"
-#include <fstream>
-#include <vector>
+#include <memory>
+#include <shlwapi.h>
 
 using namespace winrt;
-using namespace winrt::Windows::Storage;
 using namespace winrt::Windows::Storage::Streams;
 using namespace Gdiplus;
 
 namespace ImageUtils
 {
-    hstring SaveCover(IRandomAccessStreamReference image)
+    namespace
+    {
+        // GDI+ bitmap decoded from encoded bytes; null if they do not decode.
+        std::unique_ptr<Bitmap> DecodeCover(const std::vector<uint8_t>& cover)
+        {
+            if (cover.empty())
+                return nullptr;
+
+            com_ptr<IStream> stream;
+            stream.attach(SHCreateMemStream(cover.data(), static_cast<UINT>(cover.size())));
+            if (!stream)
+                return nullptr;
+
+            auto bitmap = std::make_unique<Bitmap>(stream.get());
+            if (bitmap->GetLastStatus() != Ok)
+                return nullptr;
+            return bitmap;
+        }
+    }
+
+    std::vector<uint8_t> ReadCover(IRandomAccessStreamReference image)
     {
         try
         {
             auto cover_stream = image.OpenReadAsync().get();
             uint64_t size = cover_stream.Size();
-            if (size == 0) return L"";
-
-            auto cover_buffer = Buffer(static_cast<uint32_t>(size));
-            
-            // Get temp folder path
-            wchar_t tempPath[MAX_PATH];
-            GetTempPathW(MAX_PATH, tempPath);
-            std::filesystem::path dir = std::filesystem::path(tempPath) / L"Novadesk" / L"NowPlaying";
-            std::filesystem::create_directories(dir);
-            
-            auto temp_folder = StorageFolder::GetFolderFromPathAsync(dir.wstring()).get();
-            auto cover_file = temp_folder.CreateFileAsync(L"cover.png", CreationCollisionOption::ReplaceExisting).get();
-
-            cover_stream.ReadAsync(cover_buffer, cover_buffer.Capacity(), InputStreamOptions::ReadAhead).get();
-            FileIO::WriteBufferAsync(cover_file, cover_buffer).get();
-
-            return cover_file.Path();
+            if (size == 0 || size > UINT32_MAX) return {};
+
+            DataReader reader(cover_stream);
+            const uint32_t loaded = reader.LoadAsync(static_cast<uint32_t>(size)).get();
+
+            std::vector<uint8_t> cover(loaded);
+            reader.ReadBytes(cover);
+            return cover;
         }
         catch (...)
         {
-            return L"";
+            return {};
         }
     }
 
-    bool CoverHasTransparentBorder(hstring original)
+    uint64_t HashCover(const std::vector<uint8_t>& cover)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (uint8_t b : cover)
+        {
+            hash ^= b;
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    bool CoverHasTransparentBorder(const std::vector<uint8_t>& cover)
     {
         const int width = 300;
         const int height = 300;
         const int border = 33;
 
-        Bitmap cover(original.c_str());
+        auto decoded = DecodeCover(cover);
+        if (!decoded)
+        {
+            return false;
+        }
 
-        if (cover.GetHeight() != height || cover.GetWidth() != width)
+        if (decoded->GetHeight() != height || decoded->GetWidth() != width)
         {
             return false;
         }
@@ -62,7 +87,7 @@ namespace ImageUtils
         Rect r(0, 0, width, height);
         BitmapData data;
 
-        if (cover.LockBits(&r, ImageLockModeRead, PixelFormat32bppARGB, &data) != Ok)
+        if (decoded->LockBits(&r, ImageLockModeRead, PixelFormat32bppARGB, &data) != Ok)
         {
             return false;
         }
@@ -93,51 +118,56 @@ namespace ImageUtils
             return true;
         };
 
-        // Check left border: x = 0 .. 32
-        if (!checkStrip(0, 0, border, height))
+        // Left border x = 0 .. 32, right border x = 267 .. 299
+        const bool transparent = checkStrip(0, 0, border, height) &&
+                                 checkStrip(width - border, 0, width, height);
+
+        decoded->UnlockBits(&data);
+        return transparent;
+    }
+
+    std::vector<uint8_t> CropCover(const std::vector<uint8_t>& cover)
+    {
+        auto decoded = DecodeCover(cover);
+        if (!decoded)
         {
-            cover.UnlockBits(&data);
-            return false;
+            return {};
         }
 
-        // Check right border: x = 300-33 .. 299
-        if (!checkStrip(width - border, 0, width, height))
+        com_ptr<IStream> stream;
+        if (FAILED(CreateStreamOnHGlobal(nullptr, TRUE, stream.put())))
         {
-            cover.UnlockBits(&data);
-            return false;
+            return {};
         }
 
-        cover.UnlockBits(&data);
-        return true;
-    }
-
-    hstring CropCover(hstring original)
-    {
-        try
         {
-            wchar_t tempPath[MAX_PATH];
-            GetTempPathW(MAX_PATH, tempPath);
-            std::filesystem::path dir = std::filesystem::path(tempPath) / L"Novadesk" / L"NowPlaying";
-            
-            auto temp_folder = StorageFolder::GetFolderFromPathAsync(dir.wstring()).get();
-            auto cropped_file = temp_folder.CreateFileAsync(L"cover_cropped.png", CreationCollisionOption::ReplaceExisting).get();
+            Bitmap b(300, 300);
+            Graphics g(&b);
+            Gdiplus::Rect r(0, 0, 300, 300);
+            g.DrawImage(decoded.get(), r, 33, 0, 234, 234, UnitPixel);
 
+            const CLSID pngEncoderClsId = { 0x557cf406, 0x1a04, 0x11d3,{ 0x9a,0x73,0x00,0x00,0xf8,0x1e,0xf3,0x2e } };
+            if (b.Save(stream.get(), &pngEncoderClsId, NULL) != Ok)
             {
-                Bitmap b(300, 300);
-                Graphics g(&b);
-                Bitmap cover(original.c_str());
-                Gdiplus::Rect r(0, 0, 300, 300);
-                g.DrawImage(&cover, r, 33, 0, 234, 234, UnitPixel);
-
-                const CLSID pngEncoderClsId = { 0x557cf406, 0x1a04, 0x11d3,{ 0x9a,0x73,0x00,0x00,0xf8,0x1e,0xf3,0x2e } };
-                b.Save(cropped_file.Path().c_str(), &pngEncoderClsId, NULL);
+                return {};
             }
+        }
 
-            return cropped_file.Path();
+        STATSTG stat{};
+        if (FAILED(stream->Stat(&stat, STATFLAG_NONAME)) || stat.cbSize.QuadPart == 0)
+        {
+            return {};
         }
-        catch (...)
+
+        std::vector<uint8_t> png(static_cast<size_t>(stat.cbSize.QuadPart));
+        LARGE_INTEGER start{};
+        ULONG read = 0;
+        if (FAILED(stream->Seek(start, STREAM_SEEK_SET, nullptr)) ||
+            FAILED(stream->Read(png.data(), static_cast<ULONG>(png.size()), &read)) ||
+            read != png.size())
         {
-            return original;
+            return {};
         }
+        return png;
     }
 }
@@ -7,17 +7,26 @@
  
 #pragma once
 
-#include <filesystem>
+#include <cstdint>
+#include <vector>
 #include <Windows.h>
 #include <gdiplus.h>
 #include <winrt/base.h>
 #include <winrt/Windows.Foundation.h>
-#include <winrt/Windows.Storage.h>
 #include <winrt/Windows.Storage.Streams.h>
 
+// Cover art is handled as encoded bytes in memory; nothing is written to disk.
 namespace ImageUtils
 {
-    winrt::hstring SaveCover(winrt::Windows::Storage::Streams::IRandomAccessStreamReference image);
-    bool CoverHasTransparentBorder(winrt::hstring original);
-    winrt::hstring CropCover(winrt::hstring original);
+    // Whole thumbnail stream; empty on failure.
+    std::vector<uint8_t> ReadCover(winrt::Windows::Storage::Streams::IRandomAccessStreamReference image);
+
+    // 64-bit FNV-1a of the encoded bytes, used as the cover cache key.
+    uint64_t HashCover(const std::vector<uint8_t>& cover);
+
+    // Spotify pads 234x234 art to 300x300 with transparent side columns.
+    bool CoverHasTransparentBorder(const std::vector<uint8_t>& cover);
+
+    // The padded art scaled back to 300x300, as PNG; empty on failure.
+    std::vector<uint8_t> CropCover(const std::vector<uint8_t>& cover);
 }
@@ -8,15 +8,31 @@
 #include "MediaController.h"
 #include <winrt/Windows.Foundation.h>
 #include <winrt/Windows.Foundation.Collections.h>
-#include <chrono>
 #include <algorithm>
+#include <cstdio>
 #include <string_view>
 
 using namespace winrt;
 using namespace winrt::Windows::Media::Control;
 using namespace winrt::Windows::Foundation;
 
-MediaController::MediaController()
+namespace
+{
+    // How often to retry when the session manager is unavailable.
+    constexpr auto kManagerRetry = std::chrono::seconds(5);
+}
+
+void MediaController::Signal::Mark(unsigned flags)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        dirty |= flags;
+    }
+    cv.notify_one();
+}
+
+MediaController::MediaController(CoverSink coverSink)
+    : m_coverSink(std::move(coverSink)), m_signal(std::make_shared<Signal>())
 {
     // Initialize GDI+
     Gdiplus::GdiplusStartupInput gdiplusStartupInput;
@@ -28,10 +44,10 @@ MediaController::MediaController()
 MediaController::~MediaController()
 {
     {
-        std::lock_guard<std::mutex> lock(m_actionMutex);
-        m_stop = true;
+        std::lock_guard<std::mutex> lock(m_signal->mutex);
+        m_signal->stop = true;
     }
-    m_actionCv.notify_all();
+    m_signal->cv.notify_all();
     if (m_worker.joinable())
         m_worker.join();
 
@@ -41,16 +57,36 @@ MediaController::~MediaController()
 MediaStats MediaController::GetStats()
 {
     std::lock_guard<std::mutex> lock(m_statsMutex);
-    return m_stats;
+    MediaStats stats = m_stats;
+
+    const double position = CurrentPosition(std::chrono::steady_clock::now());
+    stats.position = static_cast<int>(position);
+    if (stats.duration > 0)
+    {
+        stats.position = (std::min)(stats.position, stats.duration);
+        stats.progress = (stats.position * 100) / stats.duration;
+    }
+    return stats;
+}
+
+double MediaController::CurrentPosition(std::chrono::steady_clock::time_point now) const
+{
+    double position = m_positionSec;
+    if (m_stats.state == 1)
+    {
+        const double elapsed = std::chrono::duration<double>(now - m_positionTime).count();
+        if (elapsed > 0.0) position += elapsed;
+    }
+    return position;
 }
 
 void MediaController::QueueAction(MediaAction action, int value, bool flag)
 {
     {
-        std::lock_guard<std::mutex> lock(m_actionMutex);
-        m_actions.push({ action, value, flag });
+        std::lock_guard<std::mutex> lock(m_signal->mutex);
+        m_signal->actions.push({ action, value, flag });
     }
-    m_actionCv.notify_one();
+    m_signal->cv.notify_one();
 }
 
 void MediaController::WorkerThread()
@@ -58,65 +94,93 @@ void MediaController::WorkerThread()
     // Initialize WinRT for this thread
     winrt::init_apartment();
 
-    try {
-        m_manager = GlobalSystemMediaTransportControlsSessionManager::RequestAsync().get();
-    } catch (...) {
-        m_manager = nullptr;
-    }
-
-    auto nextRefresh = std::chrono::steady_clock::now();
+    Signal& signal = *m_signal;
+    EnsureManager();
 
     while (true)
     {
         std::queue<MediaActionItem> pending;
+        unsigned dirty = 0;
         {
-            std::unique_lock<std::mutex> lock(m_actionMutex);
-            m_actionCv.wait_until(lock, nextRefresh, [this] { return m_stop || !m_actions.empty(); });
-
-            if (m_stop)
+            std::unique_lock<std::mutex> lock(signal.mutex);
+            auto ready = [&] { return signal.stop || !signal.actions.empty() || (m_manager && signal.dirty != 0); };
+            if (m_manager)
+                signal.cv.wait(lock, ready);
+            else
+                signal.cv.wait_for(lock, kManagerRetry, ready);
+
+            if (signal.stop)
                 break;
 
-            if (!m_actions.empty())
-            {
-                std::swap(pending, m_actions);
-            }
+            std::swap(pending, signal.actions);
+            dirty = signal.dirty;
+            signal.dirty = 0;
         }
 
-        if (!pending.empty())
+        if (!m_manager)
         {
-            ProcessActions(pending);
+            // No session to act on until the manager is available.
+            if (!EnsureManager())
+                continue;
+            dirty = DirtyAll;
         }
 
-        auto now = std::chrono::steady_clock::now();
-        if (now >= nextRefresh)
+        if ((dirty & DirtySession) && SelectSession())
+            dirty |= DirtyAll;
+        if (dirty & DirtyMedia)
+            UpdateMedia();
+        if (dirty & DirtyPlayback)
+            UpdatePlayback();
+        if (dirty & DirtyTimeline)
+            UpdateTimeline();
+
+        if (!pending.empty())
         {
-            UpdateData();
-            nextRefresh = now + std::chrono::milliseconds(500);
+            ProcessActions(pending);
         }
     }
 
+    m_mediaChanged = {};
+    m_playbackChanged = {};
+    m_timelineChanged = {};
+    m_sessionsChanged = {};
+    m_currentSessionChanged = {};
+    m_session = nullptr;
+    m_manager = nullptr;
+
     winrt::uninit_apartment();
 }
 
-void MediaController::UpdateData()
+bool MediaController::EnsureManager()
 {
-    if (!m_manager) {
-        try {
-            m_manager = GlobalSystemMediaTransportControlsSessionManager::RequestAsync().get();
-        } catch (...) {
-            return;
-        }
+    if (m_manager)
+        return true;
+
+    try {
+        m_manager = GlobalSystemMediaTransportControlsSessionManager::RequestAsync().get();
+    } catch (...) {
+        m_manager = nullptr;
     }
+    if (!m_manager)
+        return false;
 
-    if (!m_manager) return;
+    auto signal = m_signal;
+    try {
+        m_sessionsChanged = m_manager.SessionsChanged(winrt::auto_revoke, [signal](auto&&, auto&&) { signal->Mark(DirtySession); });
+        m_currentSessionChanged = m_manager.CurrentSessionChanged(winrt::auto_revoke, [signal](auto&&, auto&&) { signal->Mark(DirtySession); });
+    } catch (...) {}
+    return true;
+}
 
-    MediaStats newStats;
-    auto session = m_manager.GetCurrentSession();
-    
-    // Fallback: If no current session, try to find ANY playing session from the list
-    if (!session)
-    {
-        try {
+bool MediaController::SelectSession()
+{
+    GlobalSystemMediaTransportControlsSession session{ nullptr };
+    try {
+        session = m_manager.GetCurrentSession();
+
+        // Fallback: If no current session, try to find ANY playing session from the list
+        if (!session)
+        {
             auto sessions = m_manager.GetSessions();
             for (auto const& s : sessions)
             {
@@ -132,171 +196,210 @@ void MediaController::UpdateData()
             if (!session && sessions.Size() > 0) {
                 session = sessions.GetAt(0);
             }
+        }
+    } catch (...) {}
+
+    if (session == m_session)
+        return false;
+
+    m_mediaChanged = {};
+    m_playbackChanged = {};
+    m_timelineChanged = {};
+    m_session = session;
+    m_trackId.clear();
+    m_prevSyncTrackId.clear();
+    m_lockedStartTime = -1;
+
+    MediaStats stats;
+    if (m_session)
+    {
+        auto signal = m_signal;
+        try {
+            m_mediaChanged = m_session.MediaPropertiesChanged(winrt::auto_revoke, [signal](auto&&, auto&&) { signal->Mark(DirtyMedia); });
+            m_playbackChanged = m_session.PlaybackInfoChanged(winrt::auto_revoke, [signal](auto&&, auto&&) { signal->Mark(DirtyPlayback); });
+            m_timelineChanged = m_session.TimelinePropertiesChanged(winrt::auto_revoke, [signal](auto&&, auto&&) { signal->Mark(DirtyTimeline); });
+            stats.player = winrt::to_string(m_session.SourceAppUserModelId());
         } catch (...) {}
+        stats.available = true;
+        stats.status = 1;
     }
 
-    if (session)
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats = stats;
+    m_positionSec = 0.0;
+    m_positionTime = std::chrono::steady_clock::now();
+    return true;
+}
+
+void MediaController::UpdateMedia()
+{
+    if (!m_session) return;
+
+    try
     {
-        try
+        auto props = m_session.TryGetMediaPropertiesAsync().get();
+        if (!props) return;
+
+        const hstring appId = m_session.SourceAppUserModelId();
+        std::wstring trackId = appId.c_str();
+        trackId += L"|";
+        trackId += props.Artist().c_str();
+        trackId += L"|";
+        trackId += props.Title().c_str();
+
+        std::string genres;
+        for (auto g : props.Genres())
         {
-            newStats.available = true;
-            newStats.status = 1;
-            newStats.player = winrt::to_string(session.SourceAppUserModelId());
-            // 1. Get Playback Info first (State, Shuffle, Repeat)
-            auto pbInfo = session.GetPlaybackInfo();
-            if (pbInfo)
-            {
-                auto statusCode = pbInfo.PlaybackStatus();
-                if (statusCode == GlobalSystemMediaTransportControlsSessionPlaybackStatus::Playing)
-                    newStats.state = 1;
-                else if (statusCode == GlobalSystemMediaTransportControlsSessionPlaybackStatus::Paused)
-                    newStats.state = 2;
-                else
-                    newStats.state = 0;
-
-                auto shuffle = pbInfo.IsShuffleActive();
-                if (shuffle) newStats.shuffle = shuffle.Value();
-
-                auto repeat = pbInfo.AutoRepeatMode();
-                if (repeat) newStats.repeat = repeat.Value() != winrt::Windows::Media::MediaPlaybackAutoRepeatMode::None;
-            }
+            if (!genres.empty()) genres += ", ";
+            genres += winrt::to_string(g);
+        }
 
-            // 2. Get Metadata (Title, Artist, etc.)
-            auto props = session.TryGetMediaPropertiesAsync().get();
-            if (props)
-            {
-                newStats.artist = winrt::to_string(props.Artist());
-                newStats.album = winrt::to_string(props.AlbumTitle());
-                newStats.title = winrt::to_string(props.Title());
+        std::string thumbnail = UpdateCover(appId, props);
+        m_trackId = trackId;
 
-                std::string genres;
-                for (auto g : props.Genres())
-                {
-                    if (!genres.empty()) genres += ", ";
-                    genres += winrt::to_string(g);
-                }
-                newStats.genres = genres;
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        m_stats.artist = winrt::to_string(props.Artist());
+        m_stats.album = winrt::to_string(props.AlbumTitle());
+        m_stats.title = winrt::to_string(props.Title());
+        m_stats.genres = std::move(genres);
+        m_stats.thumbnail = std::move(thumbnail);
+    }
+    catch (...) {}
+}
 
-                UpdateCover(session.SourceAppUserModelId(), props);
-                newStats.thumbnail = winrt::to_string(m_lastCoverPath);
-            }
+void MediaController::UpdatePlayback()
+{
+    if (!m_session) return;
 
-            // 3. Get Timeline (Duration, Position)
-            auto timeline = session.GetTimelineProperties();
-            if (timeline)
-            {
-                auto duration = timeline.EndTime() - timeline.StartTime();
-                newStats.duration = static_cast<int>(std::chrono::duration_cast<std::chrono::seconds>(duration).count());
-
-                std::wstring currentTrackId = session.SourceAppUserModelId().c_str();
-                currentTrackId += L"|";
-                if (props) {
-                    currentTrackId += props.Artist().c_str();
-                    currentTrackId += L"|";
-                    currentTrackId += props.Title().c_str();
-                }
-                currentTrackId += L"|";
-                currentTrackId += std::to_wstring(newStats.duration);
+    try
+    {
+        auto pbInfo = m_session.GetPlaybackInfo();
+        if (!pbInfo) return;
+
+        int state = 0;
+        auto statusCode = pbInfo.PlaybackStatus();
+        if (statusCode == GlobalSystemMediaTransportControlsSessionPlaybackStatus::Playing)
+            state = 1;
+        else if (statusCode == GlobalSystemMediaTransportControlsSessionPlaybackStatus::Paused)
+            state = 2;
+
+        bool shuffle = false;
+        auto shuffleActive = pbInfo.IsShuffleActive();
+        if (shuffleActive) shuffle = shuffleActive.Value();
+
+        bool repeat = false;
+        auto repeatMode = pbInfo.AutoRepeatMode();
+        if (repeatMode) repeat = repeatMode.Value() != winrt::Windows::Media::MediaPlaybackAutoRepeatMode::None;
+
+        const auto now = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        // Freeze the interpolated position on pause, restart it on play.
+        m_positionSec = CurrentPosition(now);
+        m_positionTime = now;
+        m_stats.state = state;
+        m_stats.shuffle = shuffle;
+        m_stats.repeat = repeat;
+    }
+    catch (...) {}
+}
 
-                bool trackChanged = (currentTrackId != m_prevSyncTrackId);
-                m_prevSyncTrackId = currentTrackId;
+void MediaController::UpdateTimeline()
+{
+    if (!m_session) return;
 
-                if (trackChanged || m_lockedStartTime == -1)
-                {
-                    m_lockedStartTime = timeline.StartTime().count();
-                    m_hasLocalPos = false;
-                }
+    try
+    {
+        auto timeline = m_session.GetTimelineProperties();
+        if (!timeline) return;
 
-                int64_t relativeTicks = timeline.Position().count() - m_lockedStartTime;
-                newStats.position = static_cast<int>(relativeTicks / 10000000);
-                if (newStats.position < 0) newStats.position = 0;
+        auto duration = timeline.EndTime() - timeline.StartTime();
+        const int durationSec = static_cast<int>(std::chrono::duration_cast<std::chrono::seconds>(duration).count());
 
-                const auto nowSteady = std::chrono::steady_clock::now();
-                if (newStats.state == 1 && newStats.duration > 0)
-                {
-                    if (!m_hasLocalPos)
-                    {
-                        m_localPosSec = static_cast<double>(newStats.position);
-                        m_localPosTime = nowSteady;
-                        m_hasLocalPos = true;
-                    }
-                    else
-                    {
-                        double elapsed = std::chrono::duration<double>(nowSteady - m_localPosTime).count();
-                        m_localPosTime = nowSteady;
-                        if (elapsed > 0 && elapsed < 5.0) m_localPosSec += elapsed;
-
-                        int predicted = static_cast<int>(m_localPosSec);
-
-                        if (newStats.position > predicted)
-                            m_localPosSec = static_cast<double>(newStats.position);
-                        else if (predicted > newStats.position + 10)
-                            m_localPosSec = static_cast<double>(newStats.position);
-                        else
-                            newStats.position = (std::min)(predicted, newStats.duration);
-                    }
-                }
-                else
-                {
-                    m_hasLocalPos = false;
-                }
-
-                if (newStats.duration > 0)
-                {
-                    newStats.position = (std::min)(newStats.position, newStats.duration);
-                    newStats.progress = (newStats.position * 100) / newStats.duration;
-                }
-            }
+        // Chrome/Edge move StartTime around; keep the first one seen per track.
+        std::wstring syncTrackId = m_trackId + L"|" + std::to_wstring(durationSec);
+        if (syncTrackId != m_prevSyncTrackId || m_lockedStartTime == -1)
+        {
+            m_prevSyncTrackId = syncTrackId;
+            m_lockedStartTime = timeline.StartTime().count();
         }
-        catch (...) {}
-    }
 
-    std::lock_guard<std::mutex> lock(m_statsMutex);
-    m_stats = newStats;
+        const int64_t relativeTicks = timeline.Position().count() - m_lockedStartTime;
+        const double position = (std::max)(0.0, static_cast<double>(relativeTicks) / 10000000.0);
+
+        // Position was sampled at LastUpdatedTime, which may be a while ago.
+        const auto age = winrt::clock::now() - timeline.LastUpdatedTime();
+        const auto now = std::chrono::steady_clock::now();
+
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        m_stats.duration = durationSec;
+        m_positionSec = position;
+        m_positionTime = now;
+        if (m_stats.state == 1 && age > TimeSpan::zero() && age < duration)
+            m_positionTime -= std::chrono::duration_cast<std::chrono::steady_clock::duration>(age);
+    }
+    catch (...) {}
 }
 
-void MediaController::UpdateCover(const winrt::hstring& playerAppId, const winrt::GlobalSystemMediaTransportControlsSessionMediaProperties& props)
+std::string MediaController::UpdateCover(const winrt::hstring& playerAppId, const winrt::GlobalSystemMediaTransportControlsSessionMediaProperties& props)
 {
-    std::wstring trackId = playerAppId.c_str();
-    trackId += L"|";
-    trackId += props.Artist().c_str();
-    trackId += L"|";
-    trackId += props.Title().c_str();
+    auto thumb = props.Thumbnail();
+    if (!thumb)
+        return {};
 
-    if (trackId == m_lastTrackId && !m_lastCoverPath.empty())
-        return;
+    std::vector<uint8_t> original = ImageUtils::ReadCover(thumb);
+    if (original.empty())
+        return {};
 
-    m_lastTrackId = trackId;
-    auto thumb = props.Thumbnail();
-    if (thumb)
+    // Players re-send unchanged art with every property change; only new
+    // bytes are decoded, cropped and handed to the host.
+    const uint64_t hash = ImageUtils::HashCover(original);
+    auto it = std::find_if(m_covers.begin(), m_covers.end(), [hash](const CachedCover& c) { return c.hash == hash; });
+    if (it == m_covers.begin() && it != m_covers.end())
+        return it->path;
+
+    if (it != m_covers.end())
+    {
+        CachedCover cover = std::move(*it);
+        m_covers.erase(it);
+        m_covers.push_front(std::move(cover));
+    }
+    else
     {
-        auto path = ImageUtils::SaveCover(thumb);
-        if (!path.empty())
+        CachedCover cover;
+        cover.hash = hash;
+
+        char path[64];
+        snprintf(path, sizeof(path), "memory://nowplaying/cover-%016llx", static_cast<unsigned long long>(hash));
+        cover.path = path;
+
+        // Advanced cropping from reference project
+        // Spotify check (Reference says Spotify.exe, SMTC usually gives AppId)
+        bool isSpotify = (std::wstring_view(playerAppId).find(L"Spotify") != std::wstring_view::npos);
+        if (isSpotify && ImageUtils::CoverHasTransparentBorder(original))
         {
-            // Advanced cropping from reference project
-            // Spotify check (Reference says Spotify.exe, SMTC usually gives AppId)
-            bool isSpotify = (std::wstring_view(playerAppId).find(L"Spotify") != std::wstring_view::npos);
-            
-            if (isSpotify && ImageUtils::CoverHasTransparentBorder(path))
-            {
-                path = ImageUtils::CropCover(path);
-            }
-            m_lastCoverPath = path;
+            cover.data = ImageUtils::CropCover(original);
         }
-        else
+        if (cover.data.empty())
         {
-            m_lastCoverPath = L"";
+            cover.data = std::move(original);
         }
+
+        m_covers.push_front(std::move(cover));
+        if (m_covers.size() > kCoverCacheSize)
+            m_covers.pop_back();
     }
-    else
-    {
-        m_lastCoverPath = L"";
-    }
+
+    // The host store is bounded, so a cached cover is handed over again
+    // when it becomes current.
+    const CachedCover& cover = m_covers.front();
+    if (!m_coverSink || !m_coverSink(cover.path, cover.data))
+        return {};
+    return cover.path;
 }
 
 void MediaController::ProcessActions(std::queue<MediaActionItem> &pending)
 {
-    auto session = m_manager ? m_manager.GetCurrentSession() : nullptr;
+    auto session = m_session;
     if (!session) return;
 
     while (!pending.empty())
@@ -7,10 +7,14 @@
  
 #pragma once
 
+#include <chrono>
 #include <string>
 #include <mutex>
 #include <thread>
 #include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
 #include <queue>
 #include <winrt/Windows.Media.Control.h>
 #include "ImageUtils.h"
@@ -58,44 +62,92 @@ struct MediaActionItem
     bool flag;
 };
 
+/*
+** Tracks one SMTC session without polling. The worker thread sleeps until a
+** manager or session event marks part of the state dirty, or an action is
+** queued, and re-reads only that part. Position is interpolated in GetStats()
+** between timeline events, which players send on seeks and state changes
+** rather than continuously.
+*/
 class MediaController
 {
 public:
-    MediaController();
+    // Hands encoded cover art to the host under a memory:// path.
+    using CoverSink = std::function<bool(const std::string& path, const std::vector<uint8_t>& data)>;
+
+    explicit MediaController(CoverSink coverSink);
     ~MediaController();
 
     MediaStats GetStats();
     void QueueAction(MediaAction action, int value = 0, bool flag = false);
 
 private:
+    enum Dirty : unsigned
+    {
+        DirtySession = 1 << 0,  // re-pick the session and re-subscribe
+        DirtyMedia = 1 << 1,    // title, artist, genres, cover
+        DirtyPlayback = 1 << 2, // state, shuffle, repeat
+        DirtyTimeline = 1 << 3, // duration, position
+        DirtyAll = DirtySession | DirtyMedia | DirtyPlayback | DirtyTimeline
+    };
+
+    // Wake-up state shared with WinRT event handlers, which run on pool
+    // threads and may still be in flight after their revoker is reset.
+    struct Signal
+    {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::queue<MediaActionItem> actions;
+        unsigned dirty = DirtyAll;
+        bool stop = false;
+
+        void Mark(unsigned flags);
+    };
+
+    // Cover art after cropping, keyed by the hash of the original bytes.
+    struct CachedCover
+    {
+        uint64_t hash = 0;
+        std::string path;
+        std::vector<uint8_t> data;
+    };
+
+    static constexpr size_t kCoverCacheSize = 8;
+
     void WorkerThread();
-    void UpdateData();
-    void UpdateCover(const winrt::hstring& playerAppId, const winrt::GlobalSystemMediaTransportControlsSessionMediaProperties& props);
+    bool EnsureManager();
+    bool SelectSession(); // true if the session changed
+    void UpdateMedia();
+    void UpdatePlayback();
+    void UpdateTimeline();
+    std::string UpdateCover(const winrt::hstring& playerAppId, const winrt::GlobalSystemMediaTransportControlsSessionMediaProperties& props);
     void ProcessActions(std::queue<MediaActionItem> &pending);
+    double CurrentPosition(std::chrono::steady_clock::time_point now) const;
 
-    winrt::GlobalSystemMediaTransportControlsSessionManager m_manager{ nullptr };
-    
-    std::mutex m_statsMutex;
-    MediaStats m_stats;
-
-    std::mutex m_actionMutex;
-    std::condition_variable m_actionCv;
-    std::queue<MediaActionItem> m_actions;
-    bool m_stop = false;
+    CoverSink m_coverSink;
+    std::shared_ptr<Signal> m_signal;
     std::thread m_worker;
 
+    // Worker thread only
+    winrt::GlobalSystemMediaTransportControlsSessionManager m_manager{ nullptr };
+    winrt::GlobalSystemMediaTransportControlsSession m_session{ nullptr };
+    winrt::GlobalSystemMediaTransportControlsSessionManager::SessionsChanged_revoker m_sessionsChanged;
+    winrt::GlobalSystemMediaTransportControlsSessionManager::CurrentSessionChanged_revoker m_currentSessionChanged;
+    winrt::GlobalSystemMediaTransportControlsSession::MediaPropertiesChanged_revoker m_mediaChanged;
+    winrt::GlobalSystemMediaTransportControlsSession::PlaybackInfoChanged_revoker m_playbackChanged;
+    winrt::GlobalSystemMediaTransportControlsSession::TimelinePropertiesChanged_revoker m_timelineChanged;
+    std::deque<CachedCover> m_covers; // most recent first
+    std::wstring m_trackId;           // app|artist|title of the current media
+    std::wstring m_prevSyncTrackId;
+    int64_t m_lockedStartTime = -1;
+
     // GDI+
     ULONG_PTR m_gdiToken;
 
-    // Tracker for cover art
-    winrt::hstring m_lastCoverPath;
-    std::wstring m_lastTrackId;
-
-    // Tracker for position prediction (robust handling for Chrome/Edge)
-    double m_localPosSec = 0.0;
-    std::chrono::steady_clock::time_point m_localPosTime{};
-    bool m_hasLocalPos = false;
-    std::wstring m_prevSyncTrackId;
-    int m_prevSyncDuration = 0;
-    int64_t m_lockedStartTime = -1;
+    // m_positionSec is the position at m_positionTime; GetStats() adds the
+    // time since while playing.
+    mutable std::mutex m_statsMutex;
+    MediaStats m_stats;
+    double m_positionSec = 0.0;
+    std::chrono::steady_clock::time_point m_positionTime{};
 };
@@ -18,7 +18,14 @@ namespace
     {
         if (!g_Controller)
         {
-            g_Controller = std::make_unique<MediaController>();
+            // Cover art goes to the host image store; stats() reports its
+            // memory:// path, which image elements load like a file.
+            g_Controller = std::make_unique<MediaController>(
+                [](const std::string& path, const std::vector<uint8_t>& data)
+                {
+                    return NOVADESK_HOST_HAS(g_Host, StoreImage) &&
+                           g_Host->StoreImage(nullptr, path.c_str(), data.data(), data.size()) != 0;
+                });
         }
         return *g_Controller;
     }
@@ -129,7 +136,7 @@ NOVADESK_ADDON_INIT(ctx, hMsgWnd, host)
 
     novadesk::Addon addon(ctx, host);
     addon.RegisterString("name", "NowPlaying");
-    addon.RegisterString("version", "2.1.0");
+    addon.RegisterString("version", "2.2.0");
     addon.RegisterFunction("stats", JsNowPlayingStats, 0);
     addon.RegisterFunction("backend", JsNowPlayingBackend, 0);
     addon.RegisterFunction("play", JsNowPlayingPlay, 0);
@@ -0,0 +1,351 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "StructuredLogReader.h"
+#include <algorithm>
+#include <cwchar>
+
+StructuredLogReader::~StructuredLogReader()
+{
+    Close();
+}
+
+void StructuredLogReader::SetPath(const std::wstring &path)
+{
+    if (path == m_Path)
+        return;
+    Close();
+    ResetIndex();
+    m_Path = path;
+}
+
+void StructuredLogReader::Close()
+{
+    if (m_View)
+    {
+        UnmapViewOfFile(m_View);
+        m_View = nullptr;
+    }
+    if (m_Mapping)
+    {
+        CloseHandle(m_Mapping);
+        m_Mapping = nullptr;
+    }
+    if (m_File != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_File);
+        m_File = INVALID_HANDLE_VALUE;
+    }
+    m_MappedSize = 0;
+}
+
+void StructuredLogReader::ResetIndex()
+{
+    m_IndexedEnd = sizeof(LogRecordFormat::FileHeader);
+    m_Records.clear();
+    for (auto &list : m_ByLevel)
+        list.clear();
+    m_BySource.clear();
+    m_Sources.clear();
+    m_SourceIds.clear();
+    m_Filtered.clear();
+    m_ClearedCount = 0;
+    m_SourceFilter = -1;
+    m_FilterActive = m_MinLevel > 0;
+    ++m_IndexGeneration;
+}
+
+bool StructuredLogReader::Open()
+{
+    m_File = CreateFileW(m_Path.c_str(), GENERIC_READ,
+                         FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                         OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_File == INVALID_HANDLE_VALUE)
+        return false;
+
+    BY_HANDLE_FILE_INFORMATION info{};
+    if (GetFileInformationByHandle(m_File, &info))
+    {
+        m_VolumeSerial = info.dwVolumeSerialNumber;
+        m_FileIndexHigh = info.nFileIndexHigh;
+        m_FileIndexLow = info.nFileIndexLow;
+    }
+    return true;
+}
+
+/*
+** Map the whole file read-only. Novadesk only ever appends, so earlier
+** offsets stay valid; the view is simply recreated when the file grows.
+*/
+bool StructuredLogReader::Remap(uint64_t size)
+{
+    if (m_View)
+    {
+        UnmapViewOfFile(m_View);
+        m_View = nullptr;
+    }
+    if (m_Mapping)
+    {
+        CloseHandle(m_Mapping);
+        m_Mapping = nullptr;
+    }
+    m_MappedSize = 0;
+
+    if (size < sizeof(LogRecordFormat::FileHeader))
+        return false;
+
+    m_Mapping = CreateFileMappingW(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_Mapping)
+        return false;
+    m_View = static_cast<const uint8_t *>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!m_View)
+    {
+        CloseHandle(m_Mapping);
+        m_Mapping = nullptr;
+        return false;
+    }
+
+    m_MappedSize = size;
+    if (!LogRecordFormat::IsValidFileHeader(m_View, m_MappedSize))
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+bool StructuredLogReader::IsSameFileAsPath() const
+{
+    HANDLE probe = CreateFileW(m_Path.c_str(), 0,
+                               FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                               OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (probe == INVALID_HANDLE_VALUE)
+        return false;
+
+    BY_HANDLE_FILE_INFORMATION info{};
+    const bool ok = GetFileInformationByHandle(probe, &info) != FALSE;
+    CloseHandle(probe);
+    return ok &&
+           info.dwVolumeSerialNumber == m_VolumeSerial &&
+           info.nFileIndexHigh == m_FileIndexHigh &&
+           info.nFileIndexLow == m_FileIndexLow;
+}
+
+bool StructuredLogReader::Poll()
+{
+    if (m_Path.empty())
+        return false;
+
+    bool changed = false;
+
+    // Novadesk rotated the file (renamed it away and started a new one).
+    if (m_File != INVALID_HANDLE_VALUE && !IsSameFileAsPath())
+    {
+        Close();
+        ResetIndex();
+        changed = true;
+    }
+
+    if (m_File == INVALID_HANDLE_VALUE && !Open())
+        return changed;
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(m_File, &size))
+        return changed;
+
+    const uint64_t fileSize = static_cast<uint64_t>(size.QuadPart);
+    if (fileSize < m_MappedSize)
+    {
+        Close();
+        ResetIndex();
+        changed = true;
+        if (!Open())
+            return changed;
+    }
+
+    if (fileSize > m_MappedSize && !Remap(fileSize))
+        return changed;
+
+    const size_t before = GetRowCount();
+    IndexNewRecords();
+    return changed || GetRowCount() != before;
+}
+
+uint32_t StructuredLogReader::InternSource(const wchar_t *source, size_t length)
+{
+    // Consecutive records almost always come from the same widget.
+    if (!m_Records.empty())
+    {
+        const uint32_t last = m_Records.back().sourceId;
+        const std::wstring &lastSource = m_Sources[last];
+        if (lastSource.size() == length && wmemcmp(lastSource.data(), source, length) == 0)
+            return last;
+    }
+
+    std::wstring key(source, length);
+    auto it = m_SourceIds.find(key);
+    if (it != m_SourceIds.end())
+        return it->second;
+
+    const uint32_t id = static_cast<uint32_t>(m_Sources.size());
+    m_Sources.push_back(key);
+    m_SourceIds.emplace(std::move(key), id);
+    m_BySource.emplace_back();
+    return id;
+}
+
+void StructuredLogReader::IndexNewRecords()
+{
+    if (!m_View)
+        return;
+
+    LogRecordFormat::RecordHeader header{};
+    while (LogRecordFormat::ReadRecordHeader(m_View, m_MappedSize, m_IndexedEnd, header))
+    {
+        RecordMeta meta{};
+        meta.offset = m_IndexedEnd;
+        meta.level = static_cast<uint8_t>(std::min<int>(header.level, kLevelCount - 1));
+        meta.sourceId = InternSource(LogRecordFormat::GetRecordSource(m_View, m_IndexedEnd), header.sourceLength);
+
+        const uint32_t index = static_cast<uint32_t>(m_Records.size());
+        m_Records.push_back(meta);
+        m_ByLevel[meta.level].push_back(index);
+        m_BySource[meta.sourceId].push_back(index);
+        if (m_FilterActive && MatchesFilter(meta))
+            m_Filtered.push_back(index);
+
+        m_IndexedEnd += header.size;
+    }
+}
+
+bool StructuredLogReader::MatchesFilter(const RecordMeta &meta) const
+{
+    if (meta.level < m_MinLevel)
+        return false;
+    return m_SourceFilter < 0 || meta.sourceId == static_cast<uint32_t>(m_SourceFilter);
+}
+
+void StructuredLogReader::Clear()
+{
+    m_ClearedCount = m_Records.size();
+    m_Filtered.clear();
+}
+
+void StructuredLogReader::SetFilter(int minLevel, int sourceId)
+{
+    minLevel = std::max(0, std::min(minLevel, kLevelCount - 1));
+    if (sourceId >= static_cast<int>(m_Sources.size()))
+        sourceId = -1;
+    if (minLevel == m_MinLevel && sourceId == m_SourceFilter)
+        return;
+
+    m_MinLevel = minLevel;
+    m_SourceFilter = sourceId;
+    m_FilterActive = (m_MinLevel > 0 || m_SourceFilter >= 0);
+    RebuildFiltered();
+}
+
+/*
+** Build the filtered row list from the smallest matching posting list
+** instead of scanning every record.
+*/
+void StructuredLogReader::RebuildFiltered()
+{
+    m_Filtered.clear();
+    if (!m_FilterActive)
+        return;
+
+    auto firstVisible = [this](const std::vector<uint32_t> &list)
+    {
+        return std::lower_bound(list.begin(), list.end(), static_cast<uint32_t>(m_ClearedCount));
+    };
+
+    if (m_SourceFilter >= 0)
+    {
+        const auto &list = m_BySource[m_SourceFilter];
+        for (auto it = firstVisible(list); it != list.end(); ++it)
+        {
+            if (m_Records[*it].level >= m_MinLevel)
+                m_Filtered.push_back(*it);
+        }
+        return;
+    }
+
+    // Level-only filter: merge the sorted per-level lists.
+    for (int level = m_MinLevel; level < kLevelCount; ++level)
+    {
+        const auto &list = m_ByLevel[level];
+        const size_t mid = m_Filtered.size();
+        m_Filtered.insert(m_Filtered.end(), firstVisible(list), list.end());
+        std::inplace_merge(m_Filtered.begin(), m_Filtered.begin() + mid, m_Filtered.end());
+    }
+}
+
+size_t StructuredLogReader::GetRowCount() const
+{
+    if (m_FilterActive)
+        return m_Filtered.size();
+    return m_Records.size() - m_ClearedCount;
+}
+
+// The id is the record index, tagged with the index generation.
+bool StructuredLogReader::GetRowId(size_t row, uint64_t &id) const
+{
+    const size_t count = GetRowCount();
+    if (row >= count)
+        return false;
+
+    const size_t position = count - 1 - row;
+    const size_t index = m_FilterActive ? m_Filtered[position] : m_ClearedCount + position;
+    id = (static_cast<uint64_t>(m_IndexGeneration) << 32) | static_cast<uint32_t>(index);
+    return true;
+}
+
+bool StructuredLogReader::FindRow(uint64_t id, size_t &row) const
+{
+    if (static_cast<uint32_t>(id >> 32) != m_IndexGeneration)
+        return false;
+    const uint32_t index = static_cast<uint32_t>(id);
+    if (index < m_ClearedCount || index >= m_Records.size())
+        return false;
+
+    size_t position = index - m_ClearedCount;
+    if (m_FilterActive)
+    {
+        const auto it = std::lower_bound(m_Filtered.begin(), m_Filtered.end(), index);
+        if (it == m_Filtered.end() || *it != index)
+            return false;
+        position = static_cast<size_t>(it - m_Filtered.begin());
+    }
+    row = GetRowCount() - 1 - position;
+    return true;
+}
+
+bool StructuredLogReader::ReadRow(size_t row, Row &out) const
+{
+    const size_t count = GetRowCount();
+    if (!m_View || row >= count)
+        return false;
+
+    // Newest first.
+    const size_t position = count - 1 - row;
+    const size_t index = m_FilterActive ? m_Filtered[position] : m_ClearedCount + position;
+    const RecordMeta &meta = m_Records[index];
+
+    LogRecordFormat::RecordHeader header{};
+    if (!LogRecordFormat::ReadRecordHeader(m_View, m_MappedSize, meta.offset, header))
+        return false;
+
+    out.timestamp = header.timestamp;
+    out.level = meta.level;
+    out.messageId = header.messageId;
+    out.source = LogRecordFormat::GetRecordSource(m_View, meta.offset);
+    out.sourceLength = header.sourceLength;
+    out.message = LogRecordFormat::GetRecordMessage(m_View, meta.offset, header);
+    out.messageLength = header.messageLength;
+    return true;
+}
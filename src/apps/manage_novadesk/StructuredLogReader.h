@@ -0,0 +1,112 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#pragma once
+
+#include <windows.h>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../novadesk/shared/LogRecordFormat.h"
+
+/*
+** Memory-maps the structured log written by Novadesk (--structured-log) and
+** keeps a compact in-memory index of record offsets so the logs list view can
+** page through millions of records without copying them.
+**
+** Rows are addressed newest-first through GetRowCount()/ReadRow(), after the
+** active level/source filter and the Clear() watermark are applied.
+*/
+class StructuredLogReader
+{
+public:
+    struct Row
+    {
+        uint64_t timestamp = 0; // FILETIME (UTC)
+        int level = 0;          // LogLevel
+        uint32_t messageId = 0;
+        const wchar_t *source = nullptr;
+        size_t sourceLength = 0;
+        const wchar_t *message = nullptr;
+        size_t messageLength = 0;
+    };
+
+    StructuredLogReader() = default;
+    ~StructuredLogReader();
+    StructuredLogReader(const StructuredLogReader &) = delete;
+    StructuredLogReader &operator=(const StructuredLogReader &) = delete;
+
+    void SetPath(const std::wstring &path);
+    const std::wstring &GetPath() const { return m_Path; }
+    bool IsActive() const { return m_View != nullptr; }
+
+    // Pick up appended records (or a rotated file). Returns true when the visible rows changed.
+    bool Poll();
+    void Close();
+
+    // Hide everything indexed so far (the "Clear Logs" button).
+    void Clear();
+
+    // minLevel: lowest LogLevel shown; sourceId: index into GetSources(), or -1 for all.
+    // A rotated file renumbers sources, so the source filter resets to -1.
+    void SetFilter(int minLevel, int sourceId);
+    const std::vector<std::wstring> &GetSources() const { return m_Sources; }
+    // Bumped whenever the index is rebuilt from scratch (rotation, truncation).
+    uint32_t GetIndexGeneration() const { return m_IndexGeneration; }
+
+    size_t GetRowCount() const;
+    bool ReadRow(size_t row, Row &out) const;
+
+    // Id of the record shown at 'row', stable while new records arrive.
+    // FindRow() maps it back to its current row; false once the record is
+    // filtered out, cleared or the index was rebuilt.
+    bool GetRowId(size_t row, uint64_t &id) const;
+    bool FindRow(uint64_t id, size_t &row) const;
+
+private:
+    struct RecordMeta
+    {
+        uint64_t offset;
+        uint32_t sourceId;
+        uint8_t level;
+    };
+
+    static constexpr int kLevelCount = 4;
+
+    bool Open();
+    bool Remap(uint64_t size);
+    void ResetIndex();
+    void IndexNewRecords();
+    void RebuildFiltered();
+    bool MatchesFilter(const RecordMeta &meta) const;
+    bool IsSameFileAsPath() const;
+    uint32_t InternSource(const wchar_t *source, size_t length);
+
+    std::wstring m_Path;
+    HANDLE m_File = INVALID_HANDLE_VALUE;
+    HANDLE m_Mapping = nullptr;
+    const uint8_t *m_View = nullptr;
+    uint64_t m_MappedSize = 0;
+    uint64_t m_IndexedEnd = 0;
+    DWORD m_VolumeSerial = 0;
+    DWORD m_FileIndexHigh = 0;
+    DWORD m_FileIndexLow = 0;
+
+    std::vector<RecordMeta> m_Records;
+    std::vector<uint32_t> m_ByLevel[kLevelCount];
+    std::vector<std::vector<uint32_t>> m_BySource;
+    std::vector<std::wstring> m_Sources;
+    std::unordered_map<std::wstring, uint32_t> m_SourceIds;
+
+    size_t m_ClearedCount = 0;
+    int m_MinLevel = 0;
+    int m_SourceFilter = -1;
+    bool m_FilterActive = false;
+    uint32_t m_IndexGeneration = 0;
+    std::vector<uint32_t> m_Filtered;
+};
@@ -23,9 +23,11 @@
 #include <fstream>
 #include <iterator>
 #include <cwctype>
+#include <deque>
 #include "../../third_party/json/json.hpp"
 
 #include "resource.h"
+#include "StructuredLogReader.h"
 
 #pragma comment(lib, "comctl32.lib")
 #pragma comment(lib, "gdiplus.lib")
@@ -69,6 +71,8 @@ static bool g_novadeskRunning = false;
 static HMENU g_trayMenu = nullptr;
 static HWND g_btnRefreshList = nullptr;
 static HWND g_btnClearLogs = nullptr;
+static HWND g_cmbLogLevel = nullptr;
+static HWND g_cmbLogSource = nullptr;
 static HWND g_btnLoad = nullptr;
 static HWND g_btnRefresh = nullptr;
 static HWND g_btnRefreshAll = nullptr;
@@ -76,6 +80,7 @@ static HWND g_btnClose = nullptr;
 static HWND g_tab = nullptr;
 static HWND g_logsList = nullptr;
 static HWND g_addonsList = nullptr;
+static HWND g_perfList = nullptr;
 static HWND g_settingsPanel = nullptr;
 static HWND g_aboutPanel = nullptr;
 static HWND g_settingsTitle = nullptr;
@@ -107,6 +112,25 @@ static HANDLE g_novadeskLogRead = nullptr;
 static HANDLE g_novadeskLogWrite = nullptr;
 static HANDLE g_novadeskLogThread = nullptr;
 static std::wstring g_pendingLogLine;
+
+// Rows parsed from the console pipe, newest first. Used when no structured log is available.
+struct TextLogRow
+{
+    std::wstring time;
+    std::wstring source;
+    std::wstring level;
+    std::wstring message;
+    int levelValue = 1;
+    uint64_t id = 0; // counts up; the front row has the highest id
+};
+static std::deque<TextLogRow> g_textLogRows;
+static uint64_t g_textLogNextId = 0;
+static std::vector<size_t> g_textLogVisible;
+static StructuredLogReader g_structuredLog;
+static int g_logMinLevel = 0;
+static size_t g_logSourceCount = 0;
+static uint32_t g_logSourceGeneration = 0;
+static std::wstring g_perfStatsPath;
 static int g_activeTab = 0;
 static int g_logsMessageColumnWidth = 600;
 static std::unordered_map<std::wstring, std::wstring> g_savedLoadedScripts;
@@ -123,6 +147,8 @@ static HFONT g_aboutBodyFont = nullptr;
 
 static const int kControlIdRefreshList = 101;
 static const int kControlIdClearLogs = 108;
+static const int kControlIdLogLevelFilter = 109;
+static const int kControlIdLogSourceFilter = 110;
 static const int kControlIdLoad = 102;
 static const int kControlIdRefresh = 104;
 static const int kControlIdRefreshAll = 105;
@@ -145,6 +171,8 @@ static const UINT_PTR kLogsRefreshTimerId = 1;
 static const UINT_PTR kAutoUpdateTimerId = 2;
 static const UINT_PTR kStartupSyncTimerId = 3;
 static const UINT_PTR kProcessMonitorTimerId = 4;
+static const UINT_PTR kPerfRefreshTimerId = 5;
+static const UINT kPerfRefreshIntervalMs = 2000;
 static const UINT kProcessMonitorIntervalMs = 500;
 static const UINT kStartupSyncDelayMs = 120;
 static const UINT kAutoUpdateIntervalMs = 60 * 1000; // 1 minute
@@ -1220,6 +1248,16 @@ static void StartNovadesk()
     PROCESS_INFORMATION pi{};
     std::wstring cmdLine = L"\"" + exe + L"\" " + EnsureSingleInstanceArg(L"");
 
+    // Ask Novadesk for structured log records so the logs tab can map them instead of parsing text.
+    wchar_t tempPath[MAX_PATH + 1] = {};
+    if (GetTempPathW(MAX_PATH, tempPath))
+    {
+        const std::wstring structuredLogPath = std::wstring(tempPath) + L"Novadesk.Manage." + std::to_wstring(GetCurrentProcessId()) + L".ndlog";
+        DeleteFileW(structuredLogPath.c_str());
+        g_structuredLog.SetPath(structuredLogPath);
+        cmdLine += L" --structured-log \"" + structuredLogPath + L"\"";
+    }
+
     if (CreateProcessW(nullptr, cmdLine.data(), nullptr, nullptr, TRUE, CREATE_NO_WINDOW, nullptr, nullptr, &si, &pi))
     {
         g_novadeskProcess = pi;
@@ -1544,53 +1582,313 @@ static void ShowLogsContextMenu(HWND hWnd, int x, int y)
     }
 }
 
+static int LogLevelFromTag(const std::wstring &level)
+{
+    if (level == L"DEBUG")
+        return 0;
+    if (level == L"WARN")
+        return 2;
+    if (level == L"ERROR")
+        return 3;
+    return 1;
+}
+
+static const wchar_t *LogTagFromLevel(int level)
+{
+    switch (level)
+    {
+    case 0:
+        return L"DEBUG";
+    case 2:
+        return L"WARN";
+    case 3:
+        return L"ERROR";
+    default:
+        return L"LOG";
+    }
+}
+
+static void RebuildTextLogVisible()
+{
+    g_textLogVisible.clear();
+    if (g_logMinLevel <= 0)
+        return;
+    for (size_t i = 0; i < g_textLogRows.size(); ++i)
+    {
+        if (g_textLogRows[i].levelValue >= g_logMinLevel)
+            g_textLogVisible.push_back(i);
+    }
+}
+
+static size_t GetLogRowCount()
+{
+    if (g_structuredLog.IsActive())
+        return g_structuredLog.GetRowCount();
+    return g_logMinLevel > 0 ? g_textLogVisible.size() : g_textLogRows.size();
+}
+
+static bool GetLogRowId(int row, uint64_t &id)
+{
+    if (row < 0)
+        return false;
+    if (g_structuredLog.IsActive())
+        return g_structuredLog.GetRowId(static_cast<size_t>(row), id);
+
+    size_t index = static_cast<size_t>(row);
+    if (g_logMinLevel > 0)
+    {
+        if (index >= g_textLogVisible.size())
+            return false;
+        index = g_textLogVisible[index];
+    }
+    if (index >= g_textLogRows.size())
+        return false;
+    id = g_textLogRows[index].id;
+    return true;
+}
+
+static bool FindLogRow(uint64_t id, int &row)
+{
+    if (g_structuredLog.IsActive())
+    {
+        size_t found = 0;
+        if (!g_structuredLog.FindRow(id, found))
+            return false;
+        row = static_cast<int>(found);
+        return true;
+    }
+
+    // Ids are consecutive from the front row down.
+    if (g_textLogRows.empty() || id > g_textLogRows.front().id || g_textLogRows.front().id - id >= g_textLogRows.size())
+        return false;
+    const size_t index = static_cast<size_t>(g_textLogRows.front().id - id);
+    if (g_logMinLevel > 0)
+    {
+        const auto it = std::lower_bound(g_textLogVisible.begin(), g_textLogVisible.end(), index);
+        if (it == g_textLogVisible.end() || *it != index)
+            return false;
+        row = static_cast<int>(it - g_textLogVisible.begin());
+        return true;
+    }
+    row = static_cast<int>(index);
+    return true;
+}
+
+/*
+** Rows are newest-first, so every new record moves the others down one row.
+** CaptureLogsAnchor() remembers the top and selected records before the rows
+** change and SyncLogsListCount() puts them back where they were; only a view
+** already showing the newest row follows new records.
+*/
+struct LogsViewAnchor
+{
+    bool structured = false;
+    bool atNewest = true;
+    bool hasTop = false;
+    uint64_t topId = 0;
+    bool hasSelected = false;
+    uint64_t selectedId = 0;
+};
+
+static LogsViewAnchor CaptureLogsAnchor()
+{
+    LogsViewAnchor anchor;
+    if (!g_logsList)
+        return anchor;
+
+    anchor.structured = g_structuredLog.IsActive();
+    const int top = ListView_GetTopIndex(g_logsList);
+    anchor.atNewest = top == 0;
+    anchor.hasTop = GetLogRowId(top, anchor.topId);
+    anchor.hasSelected = GetLogRowId(ListView_GetNextItem(g_logsList, -1, LVNI_SELECTED), anchor.selectedId);
+    return anchor;
+}
+
+/*
+** The logs list is virtual (LVS_OWNERDATA); rows are pulled on demand through
+** LVN_GETDISPINFO, so only the item count and the anchored rows need updating.
+*/
+static void SyncLogsListCount(const LogsViewAnchor &anchor)
+{
+    if (!g_logsList)
+        return;
+
+    ListView_SetItemCountEx(g_logsList, static_cast<int>(GetLogRowCount()), LVSICF_NOSCROLL);
+    if (ListView_GetItemCount(g_logsList) <= 0)
+        return;
+
+    // The control tracks the selection by row; move it with its record.
+    const bool sameRows = anchor.structured == g_structuredLog.IsActive();
+    int row = 0;
+    if (anchor.hasSelected)
+    {
+        ListView_SetItemState(g_logsList, -1, 0, LVIS_SELECTED | LVIS_FOCUSED);
+        if (sameRows && FindLogRow(anchor.selectedId, row))
+            ListView_SetItemState(g_logsList, row, LVIS_SELECTED | LVIS_FOCUSED, LVIS_SELECTED | LVIS_FOCUSED);
+    }
+
+    if (anchor.atNewest)
+    {
+        ListView_EnsureVisible(g_logsList, 0, FALSE);
+    }
+    else if (anchor.hasTop && sameRows && FindLogRow(anchor.topId, row))
+    {
+        const int shift = row - ListView_GetTopIndex(g_logsList);
+        RECT item{};
+        if (shift != 0 && ListView_GetItemRect(g_logsList, 0, &item, LVIR_BOUNDS))
+            ListView_Scroll(g_logsList, 0, shift * (item.bottom - item.top));
+    }
+}
+
 static void AppendLogRow(const std::wstring &time, const std::wstring &source, const std::wstring &level, const std::wstring &message)
 {
     if (!g_logsList)
         return;
 
-    const int first = ListView_GetItemCount(g_logsList) > 0 ? 0 : -1;
-    if (first >= 0)
+    if (!g_textLogRows.empty())
     {
-        const std::wstring firstTime = GetListViewText(g_logsList, first, 0);
-        const std::wstring firstSource = GetListViewText(g_logsList, first, 1);
-        const std::wstring firstLevel = GetListViewText(g_logsList, first, 2);
-        const std::wstring firstMessage = GetListViewText(g_logsList, first, 3);
-        if (time == firstTime && source == firstSource && level == firstLevel && message == firstMessage)
+        const TextLogRow &first = g_textLogRows.front();
+        if (time == first.time && source == first.source && level == first.level && message == first.message)
         {
             return;
         }
     }
 
-    LVITEMW item{};
-    item.mask = LVIF_TEXT;
-    item.iItem = 0;
-    item.pszText = const_cast<wchar_t *>(time.c_str());
-    int row = ListView_InsertItem(g_logsList, &item);
-    ListView_SetItemText(g_logsList, row, 1, const_cast<wchar_t *>(source.c_str()));
-    ListView_SetItemText(g_logsList, row, 2, const_cast<wchar_t *>(level.c_str()));
-    ListView_SetItemText(g_logsList, row, 3, const_cast<wchar_t *>(message.c_str()));
+    TextLogRow row;
+    row.time = time;
+    row.source = source;
+    row.level = level;
+    row.message = message;
+    row.levelValue = LogLevelFromTag(level);
+    row.id = ++g_textLogNextId;
+    g_textLogRows.push_front(std::move(row));
     AutoExpandLogsMessageColumn(message);
 
-    while (ListView_GetItemCount(g_logsList) > kMaxLogRows)
+    while (g_textLogRows.size() > static_cast<size_t>(kMaxLogRows))
     {
-        const int last = ListView_GetItemCount(g_logsList) - 1;
-        if (last >= 0)
-        {
-            ListView_DeleteItem(g_logsList, last);
-        }
-        else
+        g_textLogRows.pop_back();
+    }
+}
+
+static std::wstring FormatLogTimestamp(uint64_t ticks)
+{
+    FILETIME utc{};
+    utc.dwLowDateTime = static_cast<DWORD>(ticks & 0xFFFFFFFFu);
+    utc.dwHighDateTime = static_cast<DWORD>(ticks >> 32);
+    FILETIME local{};
+    SYSTEMTIME st{};
+    FileTimeToLocalFileTime(&utc, &local);
+    FileTimeToSystemTime(&local, &st);
+
+    wchar_t buf[32] = {};
+    swprintf_s(buf, L"%04d-%02d-%02d %02d:%02d:%02d.%03d",
+               st.wYear, st.wMonth, st.wDay, st.wHour, st.wMinute, st.wSecond, st.wMilliseconds);
+    return buf;
+}
+
+// Structured records carry the widget script path; show the widget folder name.
+static std::wstring GetLogSourceLabel(const std::wstring &source)
+{
+    if (source.empty())
+        return L"Novadesk";
+    const std::filesystem::path path(source);
+    const std::wstring folder = path.parent_path().filename().wstring();
+    return folder.empty() ? path.filename().wstring() : folder;
+}
+
+static std::wstring GetLogCellText(int row, int subItem)
+{
+    if (row < 0)
+        return L"";
+
+    if (g_structuredLog.IsActive())
+    {
+        StructuredLogReader::Row record;
+        if (!g_structuredLog.ReadRow(static_cast<size_t>(row), record))
+            return L"";
+        switch (subItem)
         {
-            break;
+        case 0:
+            return FormatLogTimestamp(record.timestamp);
+        case 1:
+            return GetLogSourceLabel(std::wstring(record.source, record.sourceLength));
+        case 2:
+            return LogTagFromLevel(record.level);
+        default:
+            return std::wstring(record.message, record.messageLength);
         }
     }
 
-    if (ListView_GetItemCount(g_logsList) > 0)
+    size_t index = static_cast<size_t>(row);
+    if (g_logMinLevel > 0)
     {
-        ListView_EnsureVisible(g_logsList, 0, FALSE);
+        if (index >= g_textLogVisible.size())
+            return L"";
+        index = g_textLogVisible[index];
+    }
+    if (index >= g_textLogRows.size())
+        return L"";
+
+    const TextLogRow &text = g_textLogRows[index];
+    switch (subItem)
+    {
+    case 0:
+        return text.time;
+    case 1:
+        return text.source;
+    case 2:
+        return text.level;
+    default:
+        return text.message;
     }
 }
 
+static void OnLogsGetDispInfo(NMLVDISPINFOW *info)
+{
+    if (!info || !(info->item.mask & LVIF_TEXT) || !info->item.pszText || info->item.cchTextMax <= 0)
+        return;
+
+    const std::wstring text = GetLogCellText(info->item.iItem, info->item.iSubItem);
+    wcsncpy_s(info->item.pszText, static_cast<size_t>(info->item.cchTextMax), text.c_str(), _TRUNCATE);
+}
+
+// Append widgets that appeared in the structured log to the source filter.
+// After a rotation the reader renumbers sources and drops its source filter;
+// start the list over so the combo matches it.
+static void UpdateLogSourceFilter()
+{
+    if (!g_cmbLogSource)
+        return;
+
+    const auto &sources = g_structuredLog.GetSources();
+    const uint32_t generation = g_structuredLog.GetIndexGeneration();
+    if (generation != g_logSourceGeneration || sources.size() < g_logSourceCount)
+    {
+        g_logSourceGeneration = generation;
+        SendMessageW(g_cmbLogSource, CB_RESETCONTENT, 0, 0);
+        SendMessageW(g_cmbLogSource, CB_ADDSTRING, 0, reinterpret_cast<LPARAM>(L"All sources"));
+        SendMessageW(g_cmbLogSource, CB_SETCURSEL, 0, 0);
+        g_logSourceCount = 0;
+    }
+    for (size_t i = g_logSourceCount; i < sources.size(); ++i)
+    {
+        const std::wstring label = GetLogSourceLabel(sources[i]);
+        SendMessageW(g_cmbLogSource, CB_ADDSTRING, 0, reinterpret_cast<LPARAM>(label.c_str()));
+    }
+    g_logSourceCount = sources.size();
+}
+
+static void OnLogFilterChanged()
+{
+    const LRESULT level = g_cmbLogLevel ? SendMessageW(g_cmbLogLevel, CB_GETCURSEL, 0, 0) : 0;
+    const LRESULT source = g_cmbLogSource ? SendMessageW(g_cmbLogSource, CB_GETCURSEL, 0, 0) : 0;
+    const LogsViewAnchor anchor = CaptureLogsAnchor();
+    g_logMinLevel = level > 0 ? static_cast<int>(level) : 0;
+    g_structuredLog.SetFilter(g_logMinLevel, source > 0 ? static_cast<int>(source) - 1 : -1);
+    RebuildTextLogVisible();
+    SyncLogsListCount(anchor);
+}
+
 static void ParseAndAppendLogLine(const std::wstring &line)
 {
     if (line.empty())
@@ -1639,6 +1937,14 @@ static void ProcessLogChunk(const std::wstring &chunk)
     if (chunk.empty())
         return;
 
+    // The structured log carries the same records; the pipe only needs draining.
+    if (g_structuredLog.IsActive())
+    {
+        g_pendingLogLine.clear();
+        return;
+    }
+
+    const LogsViewAnchor anchor = CaptureLogsAnchor();
     g_pendingLogLine += chunk;
     size_t start = 0;
     for (;;)
@@ -1653,6 +1959,8 @@ static void ProcessLogChunk(const std::wstring &chunk)
     if (start > 0)
     {
         g_pendingLogLine.erase(0, start);
+        RebuildTextLogVisible();
+        SyncLogsListCount(anchor);
     }
 }
 
@@ -1691,6 +1999,132 @@ static std::unordered_set<std::wstring> GetRunningScripts()
     return out;
 }
 
+/*
+** Ask the running Novadesk for a perf-stats report and show it as
+** metric/value rows. Polled while the Performance tab is visible.
+*/
+static void AddPerfRow(int &row, const std::wstring &metric, const std::wstring &value)
+{
+    LVITEMW item{};
+    item.mask = LVIF_TEXT;
+    item.iItem = row;
+    item.pszText = const_cast<wchar_t *>(metric.c_str());
+    const int inserted = ListView_InsertItem(g_perfList, &item);
+    ListView_SetItemText(g_perfList, inserted, 1, const_cast<wchar_t *>(value.c_str()));
+    ++row;
+}
+
+static std::wstring FormatPerfBytes(uint64_t bytes)
+{
+    wchar_t buf[64] = {};
+    if (bytes >= 1024ull * 1024ull)
+        swprintf_s(buf, L"%.1f MB", static_cast<double>(bytes) / (1024.0 * 1024.0));
+    else
+        swprintf_s(buf, L"%.1f KB", static_cast<double>(bytes) / 1024.0);
+    return buf;
+}
+
+static void RefreshPerfView()
+{
+    if (!g_perfList || !g_novadeskRunning)
+        return;
+
+    if (g_perfStatsPath.empty())
+    {
+        wchar_t tempPath[MAX_PATH + 1] = {};
+        if (!GetTempPathW(MAX_PATH, tempPath))
+            return;
+        g_perfStatsPath = std::wstring(tempPath) + L"Novadesk.Manage." + std::to_wstring(GetCurrentProcessId()) + L".perf.json";
+    }
+
+    if (!RunProcessWait(GetNovadeskExePath(), L"--perf-stats-file \"" + g_perfStatsPath + L"\""))
+        return;
+
+    nlohmann::json report;
+    try
+    {
+        std::ifstream in{std::filesystem::path(g_perfStatsPath)};
+        if (!in.is_open())
+            return;
+        in >> report;
+    }
+    catch (const std::exception &)
+    {
+        return;
+    }
+
+    const int topIndex = ListView_GetTopIndex(g_perfList);
+    SendMessageW(g_perfList, WM_SETREDRAW, FALSE, 0);
+    ListView_DeleteAllItems(g_perfList);
+
+    int row = 0;
+    wchar_t buf[256] = {};
+    AddPerfRow(row, L"Uptime", std::to_wstring(report.value("uptimeMs", 0ull) / 1000ull) + L" s");
+
+    const auto &js = report["js"];
+    if (js.is_object())
+    {
+        AddPerfRow(row, L"JS heap", FormatPerfBytes(js.value("heapUsedBytes", 0ull)));
+        AddPerfRow(row, L"JS objects", std::to_wstring(js.value("objects", 0ull)));
+        AddPerfRow(row, L"JS timers", std::to_wstring(js.value("timers", 0ull)));
+        AddPerfRow(row, L"Scripts", std::to_wstring(js.value("scripts", 0ull)));
+    }
+
+    const auto &process = report["process"];
+    if (process.is_object())
+    {
+        AddPerfRow(row, L"Working set", FormatPerfBytes(process.value("workingSetBytes", 0ull)));
+        AddPerfRow(row, L"Private bytes", FormatPerfBytes(process.value("privateBytes", 0ull)));
+        AddPerfRow(row, L"GDI / USER objects", std::to_wstring(process.value("gdiObjects", 0ull)) + L" / " +
+                                                    std::to_wstring(process.value("userObjects", 0ull)));
+    }
+
+    const auto &counters = report["counters"];
+    if (counters.is_object())
+    {
+        for (auto it = counters.begin(); it != counters.end(); ++it)
+        {
+            AddPerfRow(row, Utf8ToWide(it.key()), std::to_wstring(it.value().get<uint64_t>()));
+        }
+    }
+
+    const auto &histograms = report["histograms"];
+    if (histograms.is_object())
+    {
+        for (auto it = histograms.begin(); it != histograms.end(); ++it)
+        {
+            const auto &h = it.value();
+            swprintf_s(buf, L"n=%llu  mean=%.0f us  p50=%llu  p95=%llu  p99=%llu  max=%llu us",
+                       h.value("count", 0ull), h.value("meanUs", 0.0), h.value("p50Us", 0ull),
+                       h.value("p95Us", 0ull), h.value("p99Us", 0ull), h.value("maxUs", 0ull));
+            AddPerfRow(row, Utf8ToWide(it.key()), buf);
+        }
+    }
+
+    const auto &widgets = report["widgets"];
+    if (widgets.is_array())
+    {
+        for (const auto &w : widgets)
+        {
+            swprintf_s(buf, L"frames=%llu  mean=%.0f us  max=%llu us  elements=%llu  images=",
+                       w.value("frames", 0ull), w.value("meanFrameUs", 0.0), w.value("maxFrameUs", 0ull),
+                       w.value("elements", 0ull));
+            AddPerfRow(row, L"Widget " + Utf8ToWide(w.value("id", std::string())),
+                       buf + FormatPerfBytes(w.value("imageBytes", 0ull)) +
+                           L"  cache=" + FormatPerfBytes(w.value("renderCacheBytes", 0ull)));
+        }
+    }
+
+    if (topIndex > 0 && topIndex < row)
+    {
+        // Scroll past the end first so the previous top row ends up at the top again.
+        ListView_EnsureVisible(g_perfList, row - 1, FALSE);
+        ListView_EnsureVisible(g_perfList, topIndex, FALSE);
+    }
+    SendMessageW(g_perfList, WM_SETREDRAW, TRUE, 0);
+    InvalidateRect(g_perfList, nullptr, TRUE);
+}
+
 static std::vector<WidgetEntry> LoadWidgets()
 {
     std::vector<WidgetEntry> list;
@@ -1796,6 +2230,19 @@ static void RefreshLogsView()
 {
     if (!g_logsList)
         return;
+
+    const LogsViewAnchor anchor = CaptureLogsAnchor();
+    const bool wasActive = g_structuredLog.IsActive();
+    const bool changed = g_structuredLog.Poll();
+    UpdateLogSourceFilter();
+    if (changed || wasActive != g_structuredLog.IsActive())
+    {
+        SyncLogsListCount(anchor);
+        if (g_structuredLog.IsActive())
+        {
+            AutoExpandLogsMessageColumn(GetLogCellText(0, 3));
+        }
+    }
 }
 
 static void OnClearLogs()
@@ -1803,8 +2250,11 @@ static void OnClearLogs()
     if (!g_logsList)
         return;
 
-    ListView_DeleteAllItems(g_logsList);
+    g_structuredLog.Clear();
+    g_textLogRows.clear();
+    g_textLogVisible.clear();
     g_pendingLogLine.clear();
+    SyncLogsListCount(LogsViewAnchor());
 }
 
 static bool ExecuteNovadeskCommandNoPath(const std::wstring &cmd)
@@ -2020,6 +2470,10 @@ static void LayoutTabPages(const RECT &pageRect)
     {
         MoveWindow(g_addonsList, pageRect.left, pageRect.top, pageWidth, pageHeight, TRUE);
     }
+    if (g_perfList)
+    {
+        MoveWindow(g_perfList, pageRect.left, pageRect.top, pageWidth, pageHeight, TRUE);
+    }
     if (g_settingsPanel)
     {
         MoveWindow(g_settingsPanel, pageRect.left, pageRect.top, pageWidth, pageHeight, TRUE);
@@ -2102,12 +2556,14 @@ static void ApplyTabState()
     const bool widgetsTab = (g_activeTab == 0);
     const bool logsTab = (g_activeTab == 1);
     const bool addonsTab = (g_activeTab == 2);
-    const bool settingsTab = (g_activeTab == 3);
-    const bool aboutTab = (g_activeTab == 4);
+    const bool perfTab = (g_activeTab == 3);
+    const bool settingsTab = (g_activeTab == 4);
+    const bool aboutTab = (g_activeTab == 5);
 
     ShowWindow(g_list, widgetsTab ? SW_SHOW : SW_HIDE);
     ShowWindow(g_logsList, logsTab ? SW_SHOW : SW_HIDE);
     ShowWindow(g_addonsList, addonsTab ? SW_SHOW : SW_HIDE);
+    ShowWindow(g_perfList, perfTab ? SW_SHOW : SW_HIDE);
     ShowWindow(g_settingsPanel, settingsTab ? SW_SHOW : SW_HIDE);
     ShowWindow(g_aboutPanel, aboutTab ? SW_SHOW : SW_HIDE);
     ShowWindow(g_settingsTitle, settingsTab ? SW_SHOW : SW_HIDE);
@@ -2134,6 +2590,8 @@ static void ApplyTabState()
     ShowWindow(g_aboutBottomNote, aboutTab ? SW_SHOW : SW_HIDE);
     ShowWindow(g_btnRefreshList, widgetsTab ? SW_SHOW : SW_HIDE);
     ShowWindow(g_btnClearLogs, logsTab ? SW_SHOW : SW_HIDE);
+    ShowWindow(g_cmbLogLevel, logsTab ? SW_SHOW : SW_HIDE);
+    ShowWindow(g_cmbLogSource, logsTab ? SW_SHOW : SW_HIDE);
     ShowWindow(g_btnLoad, widgetsTab ? SW_SHOW : SW_HIDE);
     ShowWindow(g_btnRefresh, widgetsTab ? SW_SHOW : SW_HIDE);
     ShowWindow(g_btnRefreshAll, widgetsTab ? SW_SHOW : SW_HIDE);
@@ -2147,6 +2605,15 @@ static void ApplyTabState()
     {
         RefreshAddonsView();
     }
+    if (g_mainWindow)
+    {
+        KillTimer(g_mainWindow, kPerfRefreshTimerId);
+        if (perfTab)
+        {
+            RefreshPerfView();
+            SetTimer(g_mainWindow, kPerfRefreshTimerId, kPerfRefreshIntervalMs, nullptr);
+        }
+    }
     if (settingsTab)
     {
         RefreshSettingsControls();
@@ -2259,10 +2726,12 @@ static LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM l
         TabCtrl_InsertItem(g_tab, 1, &tabItem);
         tabItem.pszText = const_cast<wchar_t *>(L"Addons");
         TabCtrl_InsertItem(g_tab, 2, &tabItem);
-        tabItem.pszText = const_cast<wchar_t *>(L"Settings");
+        tabItem.pszText = const_cast<wchar_t *>(L"Performance");
         TabCtrl_InsertItem(g_tab, 3, &tabItem);
-        tabItem.pszText = const_cast<wchar_t *>(L"About");
+        tabItem.pszText = const_cast<wchar_t *>(L"Settings");
         TabCtrl_InsertItem(g_tab, 4, &tabItem);
+        tabItem.pszText = const_cast<wchar_t *>(L"About");
+        TabCtrl_InsertItem(g_tab, 5, &tabItem);
 
         RECT tabRectOnParent{};
         GetWindowRect(g_tab, &tabRectOnParent);
@@ -2277,13 +2746,17 @@ static LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM l
                                  pageRect.left, pageRect.top, pageRect.right - pageRect.left, pageRect.bottom - pageRect.top,
                                  hWnd, nullptr, GetModuleHandleW(nullptr), nullptr);
         g_logsList = CreateWindowExW(WS_EX_CLIENTEDGE, WC_LISTVIEWW, L"",
-                                     WS_CHILD | LVS_REPORT | LVS_SINGLESEL | LVS_SHOWSELALWAYS | WS_HSCROLL,
+                                     WS_CHILD | LVS_REPORT | LVS_SINGLESEL | LVS_SHOWSELALWAYS | LVS_OWNERDATA | WS_HSCROLL,
                                      pageRect.left, pageRect.top, pageRect.right - pageRect.left, pageRect.bottom - pageRect.top,
                                      hWnd, nullptr, GetModuleHandleW(nullptr), nullptr);
         g_addonsList = CreateWindowExW(WS_EX_CLIENTEDGE, WC_LISTVIEWW, L"",
                                        WS_CHILD | LVS_REPORT | LVS_SINGLESEL | LVS_SHOWSELALWAYS,
                                        pageRect.left, pageRect.top, pageRect.right - pageRect.left, pageRect.bottom - pageRect.top,
                                        hWnd, nullptr, GetModuleHandleW(nullptr), nullptr);
+        g_perfList = CreateWindowExW(WS_EX_CLIENTEDGE, WC_LISTVIEWW, L"",
+                                     WS_CHILD | LVS_REPORT | LVS_SINGLESEL | LVS_SHOWSELALWAYS | LVS_NOSORTHEADER,
+                                     pageRect.left, pageRect.top, pageRect.right - pageRect.left, pageRect.bottom - pageRect.top,
+                                     hWnd, nullptr, GetModuleHandleW(nullptr), nullptr);
         g_settingsPanel = CreateWindowExW(0, L"STATIC", L"",
                                           WS_CHILD,
                                           pageRect.left, pageRect.top, pageRect.right - pageRect.left, pageRect.bottom - pageRect.top,
@@ -2431,12 +2904,33 @@ static LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM l
         acol.pszText = const_cast<wchar_t *>(L"Copyright");
         acol.cx = 420;
         ListView_InsertColumn(g_addonsList, 3, &acol);
+
+        ListView_SetExtendedListViewStyle(g_perfList, LVS_EX_FULLROWSELECT | LVS_EX_GRIDLINES | LVS_EX_DOUBLEBUFFER);
+        LVCOLUMNW pcol{};
+        pcol.mask = LVCF_TEXT | LVCF_WIDTH;
+        pcol.pszText = const_cast<wchar_t *>(L"Metric");
+        pcol.cx = 220;
+        ListView_InsertColumn(g_perfList, 0, &pcol);
+        pcol.pszText = const_cast<wchar_t *>(L"Value");
+        pcol.cx = 620;
+        ListView_InsertColumn(g_perfList, 1, &pcol);
         UpdateAboutLogo();
 
         g_btnRefreshList = CreateWindowW(L"BUTTON", L"Refresh List", WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON,
                                          10, rc.bottom - 40, 110, 28, hWnd, reinterpret_cast<HMENU>(static_cast<INT_PTR>(kControlIdRefreshList)), GetModuleHandleW(nullptr), nullptr);
         g_btnClearLogs = CreateWindowW(L"BUTTON", L"Clear Logs", WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON,
                                        10, rc.bottom - 40, 110, 28, hWnd, reinterpret_cast<HMENU>(static_cast<INT_PTR>(kControlIdClearLogs)), GetModuleHandleW(nullptr), nullptr);
+        g_cmbLogLevel = CreateWindowW(WC_COMBOBOXW, L"", WS_CHILD | WS_VSCROLL | CBS_DROPDOWNLIST,
+                                      130, rc.bottom - 38, 150, 200, hWnd, reinterpret_cast<HMENU>(static_cast<INT_PTR>(kControlIdLogLevelFilter)), GetModuleHandleW(nullptr), nullptr);
+        g_cmbLogSource = CreateWindowW(WC_COMBOBOXW, L"", WS_CHILD | WS_VSCROLL | CBS_DROPDOWNLIST,
+                                       290, rc.bottom - 38, 200, 300, hWnd, reinterpret_cast<HMENU>(static_cast<INT_PTR>(kControlIdLogSourceFilter)), GetModuleHandleW(nullptr), nullptr);
+        for (const wchar_t *label : {L"All levels", L"Info and above", L"Warnings and errors", L"Errors only"})
+        {
+            SendMessageW(g_cmbLogLevel, CB_ADDSTRING, 0, reinterpret_cast<LPARAM>(label));
+        }
+        SendMessageW(g_cmbLogLevel, CB_SETCURSEL, 0, 0);
+        SendMessageW(g_cmbLogSource, CB_ADDSTRING, 0, reinterpret_cast<LPARAM>(L"All sources"));
+        SendMessageW(g_cmbLogSource, CB_SETCURSEL, 0, 0);
         g_btnLoad = CreateWindowW(L"BUTTON", L"Load", WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON,
                                   130, rc.bottom - 40, 80, 28, hWnd, reinterpret_cast<HMENU>(static_cast<INT_PTR>(kControlIdLoad)), GetModuleHandleW(nullptr), nullptr);
         g_btnRefresh = CreateWindowW(L"BUTTON", L"Refresh", WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON,
@@ -2451,12 +2945,15 @@ static LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM l
             SendMessageW(g_tab, WM_SETFONT, (WPARAM)g_buttonFont, TRUE);
             SendMessageW(g_btnRefreshList, WM_SETFONT, (WPARAM)g_buttonFont, TRUE);
             SendMessageW(g_btnClearLogs, WM_SETFONT, (WPARAM)g_buttonFont, TRUE);
+            SendMessageW(g_cmbLogLevel, WM_SETFONT, (WPARAM)g_buttonFont, TRUE);
+            SendMessageW(g_cmbLogSource, WM_SETFONT, (WPARAM)g_buttonFont, TRUE);
             SendMessageW(g_btnLoad, WM_SETFONT, (WPARAM)g_buttonFont, TRUE);
             SendMessageW(g_btnRefresh, WM_SETFONT, (WPARAM)g_buttonFont, TRUE);
             SendMessageW(g_btnRefreshAll, WM_SETFONT, (WPARAM)g_buttonFont, TRUE);
             SendMessageW(g_btnClose, WM_SETFONT, (WPARAM)g_buttonFont, TRUE);
             SendMessageW(g_logsList, WM_SETFONT, (WPARAM)g_buttonFont, TRUE);
             SendMessageW(g_addonsList, WM_SETFONT, (WPARAM)g_buttonFont, TRUE);
+            SendMessageW(g_perfList, WM_SETFONT, (WPARAM)g_buttonFont, TRUE);
             SendMessageW(g_settingsPanel, WM_SETFONT, (WPARAM)g_buttonFont, TRUE);
             SendMessageW(g_settingsTitle, WM_SETFONT, (WPARAM)g_aboutSectionFont, TRUE);
             SendMessageW(g_chkRunOnStartup, WM_SETFONT, (WPARAM)g_buttonFont, TRUE);
@@ -2525,6 +3022,8 @@ static LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM l
         {
             MoveWindow(g_btnRefreshList, 10, rc.bottom - 40, 110, 28, TRUE);
             MoveWindow(g_btnClearLogs, 10, rc.bottom - 40, 110, 28, TRUE);
+            MoveWindow(g_cmbLogLevel, 130, rc.bottom - 38, 150, 200, TRUE);
+            MoveWindow(g_cmbLogSource, 290, rc.bottom - 38, 200, 300, TRUE);
             MoveWindow(g_btnLoad, 130, rc.bottom - 40, 80, 28, TRUE);
             MoveWindow(g_btnRefresh, 220, rc.bottom - 40, 80, 28, TRUE);
             MoveWindow(g_btnRefreshAll, 310, rc.bottom - 40, 100, 28, TRUE);
@@ -2541,6 +3040,13 @@ static LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM l
         case kControlIdClearLogs:
             OnClearLogs();
             break;
+        case kControlIdLogLevelFilter:
+        case kControlIdLogSourceFilter:
+            if (HIWORD(wParam) == CBN_SELCHANGE)
+            {
+                OnLogFilterChanged();
+            }
+            break;
         case kControlIdLoad:
             OnToggleLoadSelected();
             break;
@@ -2596,7 +3102,7 @@ static LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM l
         case kTrayMenuSettingsOpenId:
             if (g_tab)
             {
-                g_activeTab = 3;
+                g_activeTab = 4;
                 TabCtrl_SetCurSel(g_tab, g_activeTab);
                 ApplyTabState();
             }
@@ -2606,7 +3112,7 @@ static LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM l
         case kTrayMenuSettingsCheckUpdatesId:
             ShowWindow(hWnd, SW_SHOW);
             SetForegroundWindow(hWnd);
-            g_activeTab = 3;
+            g_activeTab = 4;
             if (g_tab)
             {
                 TabCtrl_SetCurSel(g_tab, g_activeTab);
@@ -2628,6 +3134,11 @@ static LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM l
         {
             UpdateButtonState();
         }
+        else if (hdr && hdr->hwndFrom == g_logsList && hdr->code == LVN_GETDISPINFOW)
+        {
+            OnLogsGetDispInfo(reinterpret_cast<NMLVDISPINFOW *>(lParam));
+            return 0;
+        }
         else if (hdr && hdr->hwndFrom == g_tab && hdr->code == TCN_SELCHANGE)
         {
             g_activeTab = TabCtrl_GetCurSel(g_tab);
@@ -2652,10 +3163,15 @@ static LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM l
         }
         break;
     case WM_TIMER:
-        if (wParam == kLogsRefreshTimerId && g_activeTab == 1)
+        if (wParam == kLogsRefreshTimerId)
         {
+            // Keep indexing the structured log while hidden so the tab opens instantly.
             RefreshLogsView();
         }
+        else if (wParam == kPerfRefreshTimerId)
+        {
+            RefreshPerfView();
+        }
         else if (wParam == kAutoUpdateTimerId && g_manageAutoCheckForUpdates)
         {
             CheckForUpdates(true);
@@ -2723,6 +3239,16 @@ static LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM l
         KillTimer(hWnd, kAutoUpdateTimerId);
         KillTimer(hWnd, kStartupSyncTimerId);
         KillTimer(hWnd, kProcessMonitorTimerId);
+        KillTimer(hWnd, kPerfRefreshTimerId);
+        if (!g_perfStatsPath.empty())
+        {
+            DeleteFileW(g_perfStatsPath.c_str());
+        }
+        g_structuredLog.Close();
+        if (!g_structuredLog.GetPath().empty())
+        {
+            DeleteFileW(g_structuredLog.GetPath().c_str());
+        }
         if (g_windowIconLarge)
         {
             DestroyIcon(g_windowIconLarge);
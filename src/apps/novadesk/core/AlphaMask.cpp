@@ -0,0 +1,69 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "AlphaMask.h"
+
+void AlphaMask::Clear()
+{
+    m_Width = 0;
+    m_Height = 0;
+    m_Scale = 1;
+    m_WordsPerRow = 0;
+    m_Bits.clear();
+}
+
+void AlphaMask::Build(const uint8_t *pixels, int width, int height, int stride)
+{
+    Clear();
+    if (!pixels || width <= 0 || height <= 0 || stride < width * 4)
+        return;
+
+    int scale = 1;
+    auto cellsAt = [&](int s)
+    {
+        return static_cast<size_t>((width + s - 1) / s) * static_cast<size_t>((height + s - 1) / s);
+    };
+    while (cellsAt(scale) > kMaxCells)
+        scale *= 2;
+
+    const size_t cols = static_cast<size_t>((width + scale - 1) / scale);
+    const size_t rows = static_cast<size_t>((height + scale - 1) / scale);
+    m_Width = width;
+    m_Height = height;
+    m_Scale = scale;
+    m_WordsPerRow = (cols + 63) / 64;
+    m_Bits.assign(m_WordsPerRow * rows, 0);
+
+    for (int y = 0; y < height; ++y)
+    {
+        const uint8_t *alpha = pixels + static_cast<size_t>(y) * static_cast<size_t>(stride) + 3;
+        uint64_t *row = &m_Bits[static_cast<size_t>(y / scale) * m_WordsPerRow];
+        if (scale == 1)
+        {
+            // Pack 64 pixels per word without a branch per pixel.
+            for (int word = 0; word * 64 < width; ++word)
+            {
+                const int end = (word * 64 + 64 < width) ? word * 64 + 64 : width;
+                uint64_t bits = 0;
+                for (int x = word * 64; x < end; ++x)
+                    bits |= static_cast<uint64_t>(alpha[static_cast<size_t>(x) * 4] != 0) << (x & 63);
+                row[word] = bits;
+            }
+        }
+        else
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                if (alpha[static_cast<size_t>(x) * 4] != 0)
+                {
+                    const size_t cx = static_cast<size_t>(x / scale);
+                    row[cx >> 6] |= uint64_t(1) << (cx & 63);
+                }
+            }
+        }
+    }
+}
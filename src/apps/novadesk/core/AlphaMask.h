@@ -0,0 +1,54 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+** One bit per pixel (or per scale x scale cell) saying whether an image is
+** opaque enough to be hit there. Built once per decoded image so pixel-precise
+** hit testing is a shift and a mask instead of a bitmap lock per mouse move.
+** A downsampled cell is set if any pixel in it is.
+*/
+class AlphaMask
+{
+public:
+    // Bitmaps with more pixels than this are downsampled by powers of two
+    // until the mask fits (1 MB of bits).
+    static const size_t kMaxCells = 8u * 1024u * 1024u;
+
+    // 'pixels' are rows of 'stride' bytes holding 4-byte pixels with alpha in
+    // byte 3 (BGRA / RGBA, straight or premultiplied).
+    void Build(const uint8_t *pixels, int width, int height, int stride);
+    void Clear();
+
+    bool IsEmpty() const { return m_Width <= 0 || m_Height <= 0; }
+    int GetWidth() const { return m_Width; }
+    int GetHeight() const { return m_Height; }
+    int GetScale() const { return m_Scale; }
+    size_t GetMemoryBytes() const { return m_Bits.size() * sizeof(uint64_t); }
+
+    // True if image pixel (x, y) has non-zero alpha; false outside the image.
+    bool Test(int x, int y) const
+    {
+        if (x < 0 || y < 0 || x >= m_Width || y >= m_Height)
+            return false;
+        const size_t cx = static_cast<size_t>(x / m_Scale);
+        const size_t cy = static_cast<size_t>(y / m_Scale);
+        return (m_Bits[cy * m_WordsPerRow + (cx >> 6)] >> (cx & 63)) & 1u;
+    }
+
+private:
+    int m_Width = 0;
+    int m_Height = 0;
+    int m_Scale = 1;
+    size_t m_WordsPerRow = 0;
+    std::vector<uint64_t> m_Bits;
+};
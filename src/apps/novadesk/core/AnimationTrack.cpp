@@ -0,0 +1,143 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "AnimationTrack.h"
+
+#include "AnimationEasing.h"
+
+namespace AnimationTrack
+{
+    AnimationTarget SampleTransform(const AnimationTarget &from, const AnimationTarget &to, float p)
+    {
+        AnimationTarget out{};
+        auto lerp = [p](float a, float b) { return a + (b - a) * p; };
+
+        if (to.hasX) { out.hasX = true; out.x = lerp(from.x, to.x); }
+        if (to.hasY) { out.hasY = true; out.y = lerp(from.y, to.y); }
+        if (to.hasWidth) { out.hasWidth = true; out.width = lerp(from.width, to.width); }
+        if (to.hasHeight) { out.hasHeight = true; out.height = lerp(from.height, to.height); }
+        if (to.hasRotate) { out.hasRotate = true; out.rotate = lerp(from.rotate, to.rotate); }
+        return out;
+    }
+
+    AnimationTarget Sample(const AnimationTarget &from, const AnimationTarget &to, float p)
+    {
+        AnimationTarget out = SampleTransform(from, to, p);
+        auto lerp = [p](float a, float b) { return a + (b - a) * p; };
+
+        if (to.hasFontSize) { out.hasFontSize = true; out.fontSize = lerp(from.fontSize, to.fontSize); }
+        if (to.hasFontWeight) { out.hasFontWeight = true; out.fontWeight = lerp(from.fontWeight, to.fontWeight); }
+        if (to.hasLetterSpacing) { out.hasLetterSpacing = true; out.letterSpacing = lerp(from.letterSpacing, to.letterSpacing); }
+        if (to.hasFontColor)
+        {
+            out.hasFontColor = true;
+            out.fontColorR = lerp(from.fontColorR, to.fontColorR);
+            out.fontColorG = lerp(from.fontColorG, to.fontColorG);
+            out.fontColorB = lerp(from.fontColorB, to.fontColorB);
+            out.fontAlpha = lerp(from.fontAlpha, to.fontAlpha);
+        }
+        return out;
+    }
+
+    void Merge(AnimationTarget &base, const AnimationTarget &patch)
+    {
+        if (patch.hasX) { base.hasX = true; base.x = patch.x; }
+        if (patch.hasY) { base.hasY = true; base.y = patch.y; }
+        if (patch.hasWidth) { base.hasWidth = true; base.width = patch.width; }
+        if (patch.hasHeight) { base.hasHeight = true; base.height = patch.height; }
+        if (patch.hasRotate) { base.hasRotate = true; base.rotate = patch.rotate; }
+        if (patch.hasFontSize) { base.hasFontSize = true; base.fontSize = patch.fontSize; }
+        if (patch.hasFontWeight) { base.hasFontWeight = true; base.fontWeight = patch.fontWeight; }
+        if (patch.hasLetterSpacing) { base.hasLetterSpacing = true; base.letterSpacing = patch.letterSpacing; }
+        if (patch.hasFontColor)
+        {
+            base.hasFontColor = true;
+            base.fontColorR = patch.fontColorR;
+            base.fontColorG = patch.fontColorG;
+            base.fontColorB = patch.fontColorB;
+            base.fontAlpha = patch.fontAlpha;
+        }
+    }
+
+    void ResolveKeyframeStops(
+        const AnimationTarget &initial,
+        const std::vector<AnimationKeyframe> &keyframes,
+        std::vector<float> &offsets,
+        std::vector<std::wstring> &easings,
+        std::vector<AnimationTarget> &resolved)
+    {
+        offsets.clear();
+        easings.clear();
+        resolved.clear();
+        if (keyframes.empty())
+            return;
+
+        AnimationTarget carry = initial;
+        AnimationTarget unionMask{};
+
+        for (const AnimationKeyframe &kf : keyframes)
+            Merge(unionMask, kf.values);
+
+        for (const AnimationKeyframe &kf : keyframes)
+        {
+            Merge(carry, kf.values);
+            AnimationTarget stop{};
+            if (unionMask.hasX) { stop.hasX = true; stop.x = carry.x; }
+            if (unionMask.hasY) { stop.hasY = true; stop.y = carry.y; }
+            if (unionMask.hasWidth) { stop.hasWidth = true; stop.width = carry.width; }
+            if (unionMask.hasHeight) { stop.hasHeight = true; stop.height = carry.height; }
+            if (unionMask.hasRotate) { stop.hasRotate = true; stop.rotate = carry.rotate; }
+            if (unionMask.hasFontSize) { stop.hasFontSize = true; stop.fontSize = carry.fontSize; }
+            if (unionMask.hasFontWeight) { stop.hasFontWeight = true; stop.fontWeight = carry.fontWeight; }
+            if (unionMask.hasLetterSpacing) { stop.hasLetterSpacing = true; stop.letterSpacing = carry.letterSpacing; }
+            if (unionMask.hasFontColor)
+            {
+                stop.hasFontColor = true;
+                stop.fontColorR = carry.fontColorR;
+                stop.fontColorG = carry.fontColorG;
+                stop.fontColorB = carry.fontColorB;
+                stop.fontAlpha = carry.fontAlpha;
+            }
+
+            offsets.push_back(kf.offset);
+            easings.push_back(kf.easing);
+            resolved.push_back(stop);
+        }
+    }
+
+    AnimationTarget SampleKeyframes(
+        const std::vector<float> &offsets,
+        const std::vector<std::wstring> &easings,
+        const std::vector<AnimationTarget> &stops,
+        float t,
+        const std::wstring &defaultEasing)
+    {
+        if (offsets.empty() || stops.empty())
+            return AnimationTarget{};
+
+        if (t <= offsets.front())
+            return stops.front();
+        if (t >= offsets.back())
+            return stops.back();
+
+        for (size_t i = 0; i + 1 < offsets.size(); ++i)
+        {
+            if (t < offsets[i + 1])
+            {
+                const float span = offsets[i + 1] - offsets[i];
+                float u = span > 0.0f ? (t - offsets[i]) / span : 0.0f;
+                if (u < 0.0f) u = 0.0f;
+                if (u > 1.0f) u = 1.0f;
+                const std::wstring &segmentEasing =
+                    (i + 1 < easings.size() && !easings[i + 1].empty()) ? easings[i + 1] : defaultEasing;
+                const float p = AnimationEasing::Evaluate(u, segmentEasing);
+                return Sample(stops[i], stops[i + 1], p);
+            }
+        }
+        return stops.back();
+    }
+}
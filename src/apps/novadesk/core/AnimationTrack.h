@@ -0,0 +1,85 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+struct AnimationTarget
+{
+    bool hasX = false;
+    bool hasY = false;
+    bool hasWidth = false;
+    bool hasHeight = false;
+    bool hasRotate = false;
+    float x = 0.0f;
+    float y = 0.0f;
+    float width = 0.0f;
+    float height = 0.0f;
+    float rotate = 0.0f;
+    bool hasFontSize = false;
+    bool hasFontWeight = false;
+    bool hasLetterSpacing = false;
+    bool hasFontColor = false;
+    float fontSize = 12.0f;
+    float fontWeight = 400.0f;
+    float letterSpacing = 0.0f;
+    float fontColorR = 0.0f;
+    float fontColorG = 0.0f;
+    float fontColorB = 0.0f;
+    float fontAlpha = 255.0f;
+
+    bool HasTransformProps() const
+    {
+        return hasX || hasY || hasWidth || hasHeight || hasRotate;
+    }
+
+    bool HasTextProps() const
+    {
+        return hasFontSize || hasFontWeight || hasLetterSpacing || hasFontColor;
+    }
+
+    bool HasAnyProps() const
+    {
+        return HasTransformProps() || HasTextProps();
+    }
+};
+
+struct AnimationKeyframe
+{
+    float offset = 0.0f;
+    std::wstring easing;
+    AnimationTarget values;
+};
+
+/*
+** Interpolation of animation targets, independent of elements and windows.
+** WidgetAnimationHelper captures element state and applies the samples.
+*/
+namespace AnimationTrack
+{
+    AnimationTarget SampleTransform(const AnimationTarget &from, const AnimationTarget &to, float p);
+    AnimationTarget Sample(const AnimationTarget &from, const AnimationTarget &to, float p);
+    void Merge(AnimationTarget &base, const AnimationTarget &patch);
+
+    // Expand sparse keyframes (sorted by offset) into full stops, carrying
+    // values forward from the element's starting state.
+    void ResolveKeyframeStops(
+        const AnimationTarget &initial,
+        const std::vector<AnimationKeyframe> &keyframes,
+        std::vector<float> &offsets,
+        std::vector<std::wstring> &easings,
+        std::vector<AnimationTarget> &resolved);
+
+    AnimationTarget SampleKeyframes(
+        const std::vector<float> &offsets,
+        const std::vector<std::wstring> &easings,
+        const std::vector<AnimationTarget> &stops,
+        float t,
+        const std::wstring &defaultEasing);
+}
@@ -0,0 +1,378 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "FlexLayout.h"
+
+#include <algorithm>
+#include <cwctype>
+
+namespace
+{
+    // Lowercase and drop separators so "row-reverse", "rowReverse" and
+    // "row_reverse" all compare equal to "rowreverse".
+    std::wstring Normalize(const std::wstring& value)
+    {
+        std::wstring out;
+        out.reserve(value.size());
+        for (wchar_t c : value)
+        {
+            if (c == L'-' || c == L'_' || c == L' ')
+                continue;
+            out.push_back(static_cast<wchar_t>(::towlower(c)));
+        }
+        return out;
+    }
+
+    // Items [begin, end) in document order; mainSize includes gaps.
+    struct Line
+    {
+        size_t begin = 0;
+        size_t end = 0;
+        int mainSize = 0;
+        int crossSize = 0;
+    };
+
+    int MainOf(const FlexLayoutItem& item, bool horizontal)
+    {
+        return horizontal ? item.width : item.height;
+    }
+
+    int CrossOf(const FlexLayoutItem& item, bool horizontal)
+    {
+        return horizontal ? item.height : item.width;
+    }
+
+    int BaseOf(const FlexLayoutItem& item, bool horizontal)
+    {
+        return item.basis >= 0 ? item.basis : MainOf(item, horizontal);
+    }
+
+    // Greedy line breaking on base sizes. innerMain < 0 keeps every item on one line.
+    void BuildLines(const std::vector<FlexLayoutItem>& items, const std::vector<int>& sizes, bool horizontal, int gap, int innerMain, std::vector<Line>& lines)
+    {
+        lines.clear();
+        Line line;
+        for (size_t i = 0; i < items.size(); ++i)
+        {
+            const int extra = (i > line.begin) ? gap + sizes[i] : sizes[i];
+            if (innerMain >= 0 && i > line.begin && line.mainSize + extra > innerMain)
+            {
+                line.end = i;
+                lines.push_back(line);
+                line = Line();
+                line.begin = i;
+                line.mainSize = sizes[i];
+            }
+            else
+            {
+                line.mainSize += extra;
+            }
+            line.crossSize = std::max(line.crossSize, CrossOf(items[i], horizontal));
+        }
+        line.end = items.size();
+        lines.push_back(line);
+    }
+
+    // Hand 'amount' out in proportion to weights; cumulative rounding so the
+    // parts always add up to 'amount' exactly.
+    void Distribute(const std::vector<float>& weights, float totalWeight, int amount, std::vector<int>& parts)
+    {
+        parts.assign(weights.size(), 0);
+        float accumulated = 0.0f;
+        int given = 0;
+        for (size_t i = 0; i < weights.size(); ++i)
+        {
+            accumulated += weights[i];
+            const int target = static_cast<int>(static_cast<double>(amount) * accumulated / totalWeight);
+            parts[i] = target - given;
+            given = target;
+        }
+    }
+
+    // Free space placed before the k-th of n items by the justify mode.
+    int JustifyOffset(FlexJustify justify, int freeSpace, size_t k, size_t n)
+    {
+        if (freeSpace <= 0)
+            return 0;
+
+        const long long space = freeSpace;
+        switch (justify)
+        {
+        case FlexJustify::Center:       return freeSpace / 2;
+        case FlexJustify::End:          return freeSpace;
+        case FlexJustify::SpaceBetween: return n > 1 ? static_cast<int>(space * k / (n - 1)) : 0;
+        case FlexJustify::SpaceAround:  return static_cast<int>(space * (2 * k + 1) / (2 * n));
+        case FlexJustify::SpaceEvenly:  return static_cast<int>(space * (k + 1) / (n + 1));
+        case FlexJustify::Start:
+        default:                        return 0;
+        }
+    }
+}
+
+void FlexLayout::Arrange(const FlexLayoutConfig& config, int containerWidth, int containerHeight, std::vector<FlexLayoutItem>& items)
+{
+    if (items.empty())
+        return;
+
+    int innerW = containerWidth - config.paddingLeft - config.paddingRight;
+    int innerH = containerHeight - config.paddingTop - config.paddingBottom;
+    if (innerW < 0) innerW = 0;
+    if (innerH < 0) innerH = 0;
+
+    const bool isRtl = (config.direction == FlexTextDirection::Rtl);
+    const bool isHorizontal = IsHorizontal(config.flexDirection);
+    const bool isReverse = (config.flexDirection == FlexDirection::RowReverse || config.flexDirection == FlexDirection::ColumnReverse);
+    const bool isWrapping = (config.wrap != FlexWrap::NoWrap);
+
+    const int mainAvail = isHorizontal ? innerW : innerH;
+    const int crossAvail = isHorizontal ? innerH : innerW;
+
+    const size_t count = items.size();
+    std::vector<int> sizes(count);
+    for (size_t i = 0; i < count; ++i)
+        sizes[i] = BaseOf(items[i], isHorizontal);
+
+    std::vector<Line> lines;
+    BuildLines(items, sizes, isHorizontal, config.gap, isWrapping ? mainAvail : -1, lines);
+
+    // A single-line container aligns against its own cross size; wrapped
+    // lines are as tall as their tallest item and stack with 'gap'.
+    if (!isWrapping)
+        lines[0].crossSize = crossAvail;
+
+    // Wrap-reverse stacks lines from the cross end; so does RTL for columns.
+    const bool linesFromEnd = (config.wrap == FlexWrap::WrapReverse) != (!isHorizontal && isRtl);
+    const bool isCenter = (config.align == FlexAlign::Center);
+    const bool isStart = (config.align == FlexAlign::Start);
+    const bool isEnd = (config.align == FlexAlign::End);
+    const bool isStretch = (config.align == FlexAlign::Stretch || config.align == FlexAlign::Normal);
+
+    std::vector<float> weights;
+    std::vector<int> parts;
+    int lineStart = 0;
+    for (const Line& line : lines)
+    {
+        const size_t n = line.end - line.begin;
+
+        // Resolve flexible lengths: grow into positive free space, shrink
+        // (weighted by base size) out of negative free space.
+        int freeSpace = mainAvail - line.mainSize;
+        if (freeSpace != 0)
+        {
+            weights.assign(n, 0.0f);
+            float totalWeight = 0.0f;
+            for (size_t k = 0; k < n; ++k)
+            {
+                const FlexLayoutItem& item = items[line.begin + k];
+                weights[k] = freeSpace > 0 ? std::max(item.grow, 0.0f)
+                                           : std::max(item.shrink, 0.0f) * static_cast<float>(sizes[line.begin + k]);
+                totalWeight += weights[k];
+            }
+            if (totalWeight > 0.0f)
+            {
+                Distribute(weights, totalWeight, freeSpace, parts);
+                for (size_t k = 0; k < n; ++k)
+                {
+                    int& size = sizes[line.begin + k];
+                    const int before = size;
+                    size = std::max(0, size + parts[k]);
+                    freeSpace -= size - before;
+                }
+            }
+        }
+
+        const int lineOffset = linesFromEnd ? crossAvail - lineStart - line.crossSize : lineStart;
+        int cursor = 0;
+        for (size_t k = 0; k < n; ++k)
+        {
+            const size_t index = isReverse ? line.end - 1 - k : line.begin + k;
+            FlexLayoutItem& item = items[index];
+            const int mainSize = sizes[index];
+            int crossSize = CrossOf(item, isHorizontal);
+
+            int crossPos = 0;
+            if (isCenter)
+            {
+                crossPos = (line.crossSize - crossSize) / 2;
+            }
+            else if (isStretch)
+            {
+                if (line.crossSize > 0)
+                    crossSize = line.crossSize;
+            }
+            else if (!isHorizontal && isStart)
+            {
+                // RTL: start means right side, LTR: start means left side
+                crossPos = isRtl ? (line.crossSize - crossSize) : 0;
+            }
+            else if (isEnd)
+            {
+                // Rows: end is the bottom. Columns: RTL end is the left side.
+                crossPos = (!isHorizontal && isRtl) ? 0 : (line.crossSize - crossSize);
+            }
+            if (crossPos < 0) crossPos = 0;
+
+            const int mainPos = cursor + JustifyOffset(config.justify, freeSpace, k, n);
+            cursor += mainSize + config.gap;
+
+            const int newWidth = isHorizontal ? mainSize : crossSize;
+            const int newHeight = isHorizontal ? crossSize : mainSize;
+            if (newWidth != item.width || newHeight != item.height)
+            {
+                item.width = newWidth;
+                item.height = newHeight;
+                item.resized = true;
+            }
+
+            if (isHorizontal)
+            {
+                item.x = config.paddingLeft + mainPos;
+                item.y = config.paddingTop + lineOffset + crossPos;
+            }
+            else
+            {
+                item.x = config.paddingLeft + lineOffset + crossPos;
+                item.y = config.paddingTop + mainPos;
+            }
+        }
+
+        lineStart += line.crossSize + config.gap;
+    }
+}
+
+void FlexLayout::MeasureContent(const FlexLayoutConfig& config, int innerMain, const std::vector<FlexLayoutItem>& items, int& width, int& height)
+{
+    width = 0;
+    height = 0;
+    if (items.empty())
+        return;
+
+    const bool isHorizontal = IsHorizontal(config.flexDirection);
+    std::vector<int> sizes(items.size());
+    for (size_t i = 0; i < items.size(); ++i)
+        sizes[i] = BaseOf(items[i], isHorizontal);
+
+    std::vector<Line> lines;
+    BuildLines(items, sizes, isHorizontal, config.gap, config.wrap != FlexWrap::NoWrap ? innerMain : -1, lines);
+
+    int mainSize = 0;
+    int crossSize = 0;
+    for (const Line& line : lines)
+    {
+        mainSize = std::max(mainSize, line.mainSize);
+        crossSize += line.crossSize;
+    }
+    crossSize += config.gap * static_cast<int>(lines.size() - 1);
+
+    width = isHorizontal ? mainSize : crossSize;
+    height = isHorizontal ? crossSize : mainSize;
+}
+
+bool FlexLayout::ParseTextDirection(const std::wstring& value, FlexTextDirection& out)
+{
+    const std::wstring v = Normalize(value);
+    if (v == L"ltr") { out = FlexTextDirection::Ltr; return true; }
+    if (v == L"rtl") { out = FlexTextDirection::Rtl; return true; }
+    return false;
+}
+
+bool FlexLayout::ParseDirection(const std::wstring& value, FlexDirection& out)
+{
+    const std::wstring v = Normalize(value);
+    if (v == L"row") { out = FlexDirection::Row; return true; }
+    if (v == L"rowreverse") { out = FlexDirection::RowReverse; return true; }
+    if (v == L"column") { out = FlexDirection::Column; return true; }
+    if (v == L"columnreverse") { out = FlexDirection::ColumnReverse; return true; }
+    return false;
+}
+
+bool FlexLayout::ParseWrap(const std::wstring& value, FlexWrap& out)
+{
+    const std::wstring v = Normalize(value);
+    if (v == L"nowrap") { out = FlexWrap::NoWrap; return true; }
+    if (v == L"wrap") { out = FlexWrap::Wrap; return true; }
+    if (v == L"wrapreverse") { out = FlexWrap::WrapReverse; return true; }
+    return false;
+}
+
+bool FlexLayout::ParseAlign(const std::wstring& value, FlexAlign& out)
+{
+    const std::wstring v = Normalize(value);
+    if (v == L"normal") { out = FlexAlign::Normal; return true; }
+    if (v == L"stretch") { out = FlexAlign::Stretch; return true; }
+    if (v == L"center") { out = FlexAlign::Center; return true; }
+    if (v == L"start" || v == L"flexstart") { out = FlexAlign::Start; return true; }
+    if (v == L"end" || v == L"flexend") { out = FlexAlign::End; return true; }
+    return false;
+}
+
+bool FlexLayout::ParseJustify(const std::wstring& value, FlexJustify& out)
+{
+    const std::wstring v = Normalize(value);
+    if (v == L"start" || v == L"flexstart") { out = FlexJustify::Start; return true; }
+    if (v == L"center") { out = FlexJustify::Center; return true; }
+    if (v == L"end" || v == L"flexend") { out = FlexJustify::End; return true; }
+    if (v == L"spacebetween") { out = FlexJustify::SpaceBetween; return true; }
+    if (v == L"spacearound") { out = FlexJustify::SpaceAround; return true; }
+    if (v == L"spaceevenly") { out = FlexJustify::SpaceEvenly; return true; }
+    return false;
+}
+
+const wchar_t* FlexLayout::ToString(FlexTextDirection value)
+{
+    return value == FlexTextDirection::Rtl ? L"rtl" : L"ltr";
+}
+
+const wchar_t* FlexLayout::ToString(FlexDirection value)
+{
+    switch (value)
+    {
+    case FlexDirection::RowReverse:    return L"rowReverse";
+    case FlexDirection::Column:        return L"column";
+    case FlexDirection::ColumnReverse: return L"columnReverse";
+    case FlexDirection::Row:
+    default:                           return L"row";
+    }
+}
+
+const wchar_t* FlexLayout::ToString(FlexWrap value)
+{
+    switch (value)
+    {
+    case FlexWrap::Wrap:        return L"wrap";
+    case FlexWrap::WrapReverse: return L"wrapReverse";
+    case FlexWrap::NoWrap:
+    default:                    return L"nowrap";
+    }
+}
+
+const wchar_t* FlexLayout::ToString(FlexAlign value)
+{
+    switch (value)
+    {
+    case FlexAlign::Normal:  return L"normal";
+    case FlexAlign::Stretch: return L"stretch";
+    case FlexAlign::Center:  return L"center";
+    case FlexAlign::End:     return L"end";
+    case FlexAlign::Start:
+    default:                 return L"start";
+    }
+}
+
+const wchar_t* FlexLayout::ToString(FlexJustify value)
+{
+    switch (value)
+    {
+    case FlexJustify::Center:       return L"center";
+    case FlexJustify::End:          return L"end";
+    case FlexJustify::SpaceBetween: return L"spaceBetween";
+    case FlexJustify::SpaceAround:  return L"spaceAround";
+    case FlexJustify::SpaceEvenly:  return L"spaceEvenly";
+    case FlexJustify::Start:
+    default:                        return L"start";
+    }
+}
@@ -0,0 +1,118 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#ifndef __NOVADESK_FLEX_LAYOUT_H__
+#define __NOVADESK_FLEX_LAYOUT_H__
+
+#include <string>
+#include <vector>
+
+enum class FlexTextDirection { Ltr, Rtl };
+enum class FlexDirection { Row, RowReverse, Column, ColumnReverse };
+enum class FlexWrap { NoWrap, Wrap, WrapReverse };
+// "normal" and "stretch" both stretch flex items (CSS); "flexStart"/"flexEnd" map to Start/End.
+enum class FlexAlign { Normal, Stretch, Center, Start, End };
+enum class FlexJustify { Start, Center, End, SpaceBetween, SpaceAround, SpaceEvenly };
+
+/**
+ * Flex values as the script last set them, so property getters read back
+ * what was written rather than the parsed enum's name. Empty when never set;
+ * the getter then names the enum.
+ */
+struct FlexLayoutNames
+{
+    std::wstring flexDirection;
+    std::wstring wrap;
+    std::wstring align;
+    std::wstring justify;
+};
+
+/**
+ * Configuration for flexbox layout. Parsed once from script strings
+ * (FlexLayout::Parse*) so Arrange() does no string work.
+ */
+struct FlexLayoutConfig
+{
+    FlexTextDirection direction = FlexTextDirection::Ltr;   // Text directionality
+    FlexDirection flexDirection = FlexDirection::Row;
+    FlexWrap wrap = FlexWrap::NoWrap;
+    int gap = 0;                                            // Gap between items and between lines
+    FlexAlign align = FlexAlign::Start;                     // Cross axis alignment
+    FlexJustify justify = FlexJustify::Start;               // Main axis alignment
+    int paddingLeft = 0;
+    int paddingTop = 0;
+    int paddingRight = 0;
+    int paddingBottom = 0;
+    FlexLayoutNames names;                                  // For getters only; Arrange() ignores it
+};
+
+/**
+ * One child of a flex container. Width/height are the measured size on
+ * input; Arrange() fills in x/y (relative to the container) and, for
+ * stretched, grown or shrunk items, the new size.
+ */
+struct FlexLayoutItem
+{
+    int width = 0;
+    int height = 0;
+    float grow = 0.0f;      // flexGrow: share of positive free space
+    float shrink = 0.0f;    // flexShrink: share of negative free space (weighted by basis).
+                            // 0 rather than CSS's 1 so existing layouts keep overflowing.
+    int basis = -1;         // flexBasis: main size before grow/shrink; < 0 = measured size
+    int x = 0;
+    int y = 0;
+    bool resized = false;
+};
+
+/**
+ * FlexLayout - the element-independent part of the flexbox algorithm.
+ */
+namespace FlexLayout
+{
+    /**
+     * Position items inside a container of the given outer size.
+     *
+     * @param config The flexbox configuration (direction, alignment, gaps, etc.)
+     * @param containerWidth Container width including padding
+     * @param containerHeight Container height including padding
+     * @param items Children in document order; updated in place
+     */
+    void Arrange(const FlexLayoutConfig& config, int containerWidth, int containerHeight, std::vector<FlexLayoutItem>& items);
+
+    /**
+     * Size the items need, excluding padding (auto-sized containers).
+     * Items wrap only when the main axis is bounded.
+     *
+     * @param config The flexbox configuration
+     * @param innerMain Available main-axis size, or < 0 if unbounded
+     * @param items Measured children
+     * @param width Output content width
+     * @param height Output content height
+     */
+    void MeasureContent(const FlexLayoutConfig& config, int innerMain, const std::vector<FlexLayoutItem>& items, int& width, int& height);
+
+    inline bool IsHorizontal(FlexDirection direction)
+    {
+        return direction == FlexDirection::Row || direction == FlexDirection::RowReverse;
+    }
+
+    // Case-insensitive; '-' and '_' are ignored ("row-reverse", "spaceBetween").
+    // Return false and leave 'out' untouched for unknown values.
+    bool ParseTextDirection(const std::wstring& value, FlexTextDirection& out);
+    bool ParseDirection(const std::wstring& value, FlexDirection& out);
+    bool ParseWrap(const std::wstring& value, FlexWrap& out);
+    bool ParseAlign(const std::wstring& value, FlexAlign& out);
+    bool ParseJustify(const std::wstring& value, FlexJustify& out);
+
+    const wchar_t* ToString(FlexTextDirection value);
+    const wchar_t* ToString(FlexDirection value);
+    const wchar_t* ToString(FlexWrap value);
+    const wchar_t* ToString(FlexAlign value);
+    const wchar_t* ToString(FlexJustify value);
+}
+
+#endif // __NOVADESK_FLEX_LAYOUT_H__
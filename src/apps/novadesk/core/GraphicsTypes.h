@@ -0,0 +1,72 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#ifndef __NOVADESK_GRAPHICSTYPES_H__
+#define __NOVADESK_GRAPHICSTYPES_H__
+
+#include <string>
+#include <vector>
+
+#include "PlatformTypes.h"
+
+// Helper macros for color extraction from COLORREF (0x00BBGGRR)
+#ifndef GetRValue
+#define GetRValue(rgb)      (LOBYTE(rgb))
+#endif
+#ifndef GetGValue
+#define GetGValue(rgb)      (LOBYTE((WORD)(rgb) >> 8))
+#endif
+#ifndef GetBValue
+#define GetBValue(rgb)      (LOBYTE((rgb) >> 16))
+#endif
+
+struct GfxRect {
+    int X, Y, Width, Height;
+    GfxRect() : X(0), Y(0), Width(0), Height(0) {}
+    GfxRect(int x, int y, int w, int h) : X(x), Y(y), Width(w), Height(h) {}
+
+    bool Intersects(const GfxRect& o) const {
+        return X < o.X + o.Width && o.X < X + Width && Y < o.Y + o.Height && o.Y < Y + Height;
+    }
+    GfxRect Union(const GfxRect& o) const {
+        const int left = X < o.X ? X : o.X;
+        const int top = Y < o.Y ? Y : o.Y;
+        const int right = (X + Width) > (o.X + o.Width) ? (X + Width) : (o.X + o.Width);
+        const int bottom = (Y + Height) > (o.Y + o.Height) ? (Y + Height) : (o.Y + o.Height);
+        return GfxRect(left, top, right - left, bottom - top);
+    }
+    GfxRect Inflate(int d) const { return GfxRect(X - d, Y - d, Width + d * 2, Height + d * 2); }
+};
+
+struct TextShadow {
+    float offsetX = 0;
+    float offsetY = 0;
+    float blur = 0;
+    COLORREF color = 0;
+    BYTE alpha = 255;
+};
+
+struct GradientStop {
+    COLORREF color;
+    BYTE alpha;
+    float position;
+};
+
+enum GradientType {
+    GRADIENT_NONE,
+    GRADIENT_LINEAR,
+    GRADIENT_RADIAL
+};
+
+struct GradientInfo {
+    GradientType type = GRADIENT_NONE;
+    std::vector<GradientStop> stops;
+    float angle = 0.0f; // For linear
+    std::wstring shape = L"circle"; // For radial
+};
+
+#endif // __NOVADESK_GRAPHICSTYPES_H__
@@ -0,0 +1,109 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "HitGrid.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace
+{
+    const int kMinCellSize = 32;
+    const int kMaxCells = 64 * 64;
+}
+
+void HitGrid::Build(int width, int height, const std::vector<Entry> &entries)
+{
+    m_Width = (std::max)(width, 1);
+    m_Height = (std::max)(height, 1);
+    m_Entries = entries;
+    m_Unbounded.clear();
+
+    // Cells roughly the size of a typical control, coarser on huge surfaces
+    // so the grid stays small.
+    m_CellSize = kMinCellSize * 2;
+    while (((m_Width + m_CellSize - 1) / m_CellSize) * ((m_Height + m_CellSize - 1) / m_CellSize) > kMaxCells)
+        m_CellSize *= 2;
+    m_Cols = (m_Width + m_CellSize - 1) / m_CellSize;
+    m_Rows = (m_Height + m_CellSize - 1) / m_CellSize;
+
+    // Two passes (count, then fill) keep every cell's list contiguous.
+    const size_t cellCount = static_cast<size_t>(m_Cols) * m_Rows;
+    m_CellStart.assign(cellCount + 1, 0);
+
+    auto forEachCell = [this](const GfxRect &r, auto &&fn)
+    {
+        if (r.Width <= 0 || r.Height <= 0)
+            return;
+        const int c0 = (std::max)(0, r.X / m_CellSize);
+        const int r0 = (std::max)(0, r.Y / m_CellSize);
+        const int c1 = (std::min)(m_Cols - 1, (r.X + r.Width - 1) / m_CellSize);
+        const int r1 = (std::min)(m_Rows - 1, (r.Y + r.Height - 1) / m_CellSize);
+        for (int row = r0; row <= r1; ++row)
+            for (int col = c0; col <= c1; ++col)
+                fn(static_cast<size_t>(row) * m_Cols + col);
+    };
+
+    for (size_t i = 0; i < m_Entries.size(); ++i)
+    {
+        if (m_Entries[i].unbounded)
+        {
+            m_Unbounded.push_back(static_cast<int>(i));
+            continue;
+        }
+        forEachCell(m_Entries[i].bounds, [this](size_t cell) { ++m_CellStart[cell + 1]; });
+    }
+    for (size_t c = 0; c < cellCount; ++c)
+        m_CellStart[c + 1] += m_CellStart[c];
+
+    m_CellItems.assign(m_CellStart[cellCount], 0);
+    std::vector<int> cursor(m_CellStart.begin(), m_CellStart.end() - 1);
+    for (size_t i = 0; i < m_Entries.size(); ++i)
+    {
+        if (m_Entries[i].unbounded)
+            continue;
+        const int index = static_cast<int>(i);
+        forEachCell(m_Entries[i].bounds, [&](size_t cell) { m_CellItems[cursor[cell]++] = index; });
+    }
+}
+
+void HitGrid::Clear()
+{
+    m_Entries.clear();
+    m_CellStart.clear();
+    m_CellItems.clear();
+    m_Unbounded.clear();
+    m_Cols = m_Rows = 0;
+}
+
+void HitGrid::Query(int x, int y, std::vector<int> &out) const
+{
+    const size_t mark = out.size();
+
+    if (x < 0 || y < 0 || x >= m_Width || y >= m_Height)
+    {
+        // Captured drags can report points off the surface; fall back to a scan.
+        for (size_t i = 0; i < m_Entries.size(); ++i)
+        {
+            if (m_Entries[i].unbounded || Contains(m_Entries[i].bounds, x, y))
+                out.push_back(static_cast<int>(i));
+        }
+    }
+    else
+    {
+        const size_t cell = static_cast<size_t>(y / m_CellSize) * m_Cols + (x / m_CellSize);
+        for (int k = m_CellStart[cell]; k < m_CellStart[cell + 1]; ++k)
+        {
+            const int index = m_CellItems[k];
+            if (Contains(m_Entries[index].bounds, x, y))
+                out.push_back(index);
+        }
+        out.insert(out.end(), m_Unbounded.begin(), m_Unbounded.end());
+    }
+
+    std::sort(out.begin() + mark, out.end(), std::greater<int>());
+}
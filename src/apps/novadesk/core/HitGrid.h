@@ -0,0 +1,56 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "GraphicsTypes.h"
+
+/*
+** Uniform grid over a widget surface used to narrow mouse hit-testing to the
+** elements whose bounds cover the cursor. Entries are passed in paint order
+** and returned front to back, so the first precise hit is the topmost one.
+** Entries without usable bounds (rotated, transformed) are "unbounded" and
+** returned for every point.
+*/
+class HitGrid
+{
+public:
+    struct Entry
+    {
+        GfxRect bounds;
+        bool unbounded = false;
+    };
+
+    void Build(int width, int height, const std::vector<Entry> &entries);
+    void Clear();
+
+    bool IsEmpty() const { return m_Entries.empty(); }
+    size_t Size() const { return m_Entries.size(); }
+
+    // Append the indices (as passed to Build) of entries whose bounds contain
+    // (x, y), topmost first.
+    void Query(int x, int y, std::vector<int> &out) const;
+
+private:
+    static bool Contains(const GfxRect &r, int x, int y)
+    {
+        return x >= r.X && x < r.X + r.Width && y >= r.Y && y < r.Y + r.Height;
+    }
+
+    int m_Width = 0;
+    int m_Height = 0;
+    int m_CellSize = 64;
+    int m_Cols = 0;
+    int m_Rows = 0;
+    std::vector<Entry> m_Entries;
+    std::vector<int> m_CellStart; // m_Cols * m_Rows + 1 offsets into m_CellItems
+    std::vector<int> m_CellItems;
+    std::vector<int> m_Unbounded;
+};
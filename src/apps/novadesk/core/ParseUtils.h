@@ -0,0 +1,26 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "GraphicsTypes.h"
+
+/*
+** String-level option parsing shared by the PropertyParser family.
+** Nothing here touches QuickJS, so it can be measured in isolation.
+*/
+namespace ParseUtils
+{
+    // Split on top-level commas (commas inside parentheses are kept) and trim spaces.
+    std::vector<std::wstring> SplitByComma(const std::wstring &s);
+
+    // "linearGradient(angle, color, color, ...)" or "radialGradient(shape, color, ...)".
+    bool ParseGradientString(const std::wstring &str, GradientInfo &out);
+}
@@ -0,0 +1,231 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "PerfCounters.h"
+
+#include <atomic>
+#include <cstdio>
+
+namespace PerfCounters
+{
+    namespace
+    {
+        constexpr int kCounterCount = static_cast<int>(Counter::Count);
+        constexpr int kHistogramCount = static_cast<int>(Histogram::Count);
+
+        struct HistogramState
+        {
+            std::atomic<uint64_t> count{0};
+            std::atomic<uint64_t> sumMicros{0};
+            std::atomic<uint64_t> maxMicros{0};
+            std::atomic<uint64_t> buckets[kHistogramBuckets] = {};
+        };
+
+        std::atomic<uint64_t> s_Counters[kCounterCount] = {};
+        HistogramState s_Histograms[kHistogramCount];
+        const std::chrono::steady_clock::time_point s_StartTime = std::chrono::steady_clock::now();
+
+        const char *const kCounterNames[kCounterCount] = {
+            "widgetRedraws",
+            "timerCallbacks",
+            "ipcMessages",
+            "imageLoads",
+            "imageLoadFailures",
+            "settingsLoads",
+            "settingsSaves",
+            "elementsCulled",
+            "layoutReflows",
+            "renderCacheHits",
+            "renderCacheBuilds",
+            "imageEffectBuilds",
+        };
+
+        const char *const kHistogramNames[kHistogramCount] = {
+            "widgetFrameTime",
+            "timerCallbackTime",
+            "ipcDispatchTime",
+            "imageLoadTime",
+            "settingsIoTime",
+        };
+    }
+
+    void Increment(Counter counter, uint64_t amount)
+    {
+        const int index = static_cast<int>(counter);
+        if (index < 0 || index >= kCounterCount)
+            return;
+        s_Counters[index].fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    void Record(Histogram histogram, uint64_t micros)
+    {
+        const int index = static_cast<int>(histogram);
+        if (index < 0 || index >= kHistogramCount)
+            return;
+
+        HistogramState &state = s_Histograms[index];
+        state.count.fetch_add(1, std::memory_order_relaxed);
+        state.sumMicros.fetch_add(micros, std::memory_order_relaxed);
+        state.buckets[BucketForMicros(micros)].fetch_add(1, std::memory_order_relaxed);
+
+        uint64_t previous = state.maxMicros.load(std::memory_order_relaxed);
+        while (micros > previous &&
+               !state.maxMicros.compare_exchange_weak(previous, micros, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    uint64_t GetCounter(Counter counter)
+    {
+        const int index = static_cast<int>(counter);
+        if (index < 0 || index >= kCounterCount)
+            return 0;
+        return s_Counters[index].load(std::memory_order_relaxed);
+    }
+
+    HistogramSnapshot GetHistogram(Histogram histogram)
+    {
+        HistogramSnapshot snapshot;
+        const int index = static_cast<int>(histogram);
+        if (index < 0 || index >= kHistogramCount)
+            return snapshot;
+
+        // Fields are read independently, so a snapshot taken while another
+        // thread records may be off by the in-flight sample.
+        const HistogramState &state = s_Histograms[index];
+        snapshot.count = state.count.load(std::memory_order_relaxed);
+        snapshot.sumMicros = state.sumMicros.load(std::memory_order_relaxed);
+        snapshot.maxMicros = state.maxMicros.load(std::memory_order_relaxed);
+        for (int i = 0; i < kHistogramBuckets; ++i)
+            snapshot.buckets[i] = state.buckets[i].load(std::memory_order_relaxed);
+        return snapshot;
+    }
+
+    void Reset()
+    {
+        for (auto &counter : s_Counters)
+            counter.store(0, std::memory_order_relaxed);
+        for (auto &state : s_Histograms)
+        {
+            state.count.store(0, std::memory_order_relaxed);
+            state.sumMicros.store(0, std::memory_order_relaxed);
+            state.maxMicros.store(0, std::memory_order_relaxed);
+            for (auto &bucket : state.buckets)
+                bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    const char *GetName(Counter counter)
+    {
+        const int index = static_cast<int>(counter);
+        return (index >= 0 && index < kCounterCount) ? kCounterNames[index] : "";
+    }
+
+    const char *GetName(Histogram histogram)
+    {
+        const int index = static_cast<int>(histogram);
+        return (index >= 0 && index < kHistogramCount) ? kHistogramNames[index] : "";
+    }
+
+    int BucketForMicros(uint64_t micros)
+    {
+        int bucket = 0;
+        while (micros != 0 && bucket < kHistogramBuckets - 1)
+        {
+            micros >>= 1;
+            ++bucket;
+        }
+        return bucket;
+    }
+
+    uint64_t BucketUpperBoundMicros(int bucket)
+    {
+        if (bucket < 0)
+            return 0;
+        if (bucket >= kHistogramBuckets - 1)
+            return UINT64_MAX;
+        return uint64_t(1) << bucket;
+    }
+
+    uint64_t HistogramSnapshot::PercentileMicros(double percentile) const
+    {
+        if (count == 0)
+            return 0;
+        if (percentile < 0.0)
+            percentile = 0.0;
+        if (percentile > 100.0)
+            percentile = 100.0;
+
+        uint64_t target = (uint64_t)((percentile / 100.0) * (double)count + 0.5);
+        if (target == 0)
+            target = 1;
+
+        uint64_t seen = 0;
+        for (int i = 0; i < kHistogramBuckets; ++i)
+        {
+            seen += buckets[i];
+            if (seen >= target)
+            {
+                const uint64_t bound = BucketUpperBoundMicros(i);
+                return bound < maxMicros ? bound : maxMicros;
+            }
+        }
+        return maxMicros;
+    }
+
+    uint64_t ScopedTimer::ElapsedMicros() const
+    {
+        const auto elapsed = std::chrono::steady_clock::now() - m_Start;
+        return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    }
+
+    ScopedTimer::~ScopedTimer()
+    {
+        Record(m_Histogram, ElapsedMicros());
+        if (m_HasCounter)
+            Increment(m_Counter);
+    }
+
+    std::string FormatJson()
+    {
+        std::string out;
+        out.reserve(2048);
+        char buffer[256];
+
+        const auto uptime = std::chrono::steady_clock::now() - s_StartTime;
+        snprintf(buffer, sizeof(buffer), "{\"uptimeMs\":%llu,\"counters\":{",
+                 (unsigned long long)std::chrono::duration_cast<std::chrono::milliseconds>(uptime).count());
+        out += buffer;
+
+        for (int i = 0; i < kCounterCount; ++i)
+        {
+            snprintf(buffer, sizeof(buffer), "%s\"%s\":%llu", i ? "," : "", kCounterNames[i],
+                     (unsigned long long)s_Counters[i].load(std::memory_order_relaxed));
+            out += buffer;
+        }
+
+        out += "},\"histograms\":{";
+        for (int i = 0; i < kHistogramCount; ++i)
+        {
+            const HistogramSnapshot h = GetHistogram(static_cast<Histogram>(i));
+            snprintf(buffer, sizeof(buffer),
+                     "%s\"%s\":{\"count\":%llu,\"meanUs\":%.1f,\"p50Us\":%llu,\"p95Us\":%llu,\"p99Us\":%llu,\"maxUs\":%llu,\"buckets\":[",
+                     i ? "," : "", kHistogramNames[i], (unsigned long long)h.count, h.MeanMicros(),
+                     (unsigned long long)h.PercentileMicros(50.0), (unsigned long long)h.PercentileMicros(95.0),
+                     (unsigned long long)h.PercentileMicros(99.0), (unsigned long long)h.maxMicros);
+            out += buffer;
+            for (int b = 0; b < kHistogramBuckets; ++b)
+            {
+                snprintf(buffer, sizeof(buffer), "%s%llu", b ? "," : "", (unsigned long long)h.buckets[b]);
+                out += buffer;
+            }
+            out += "]}";
+        }
+        out += "}}";
+        return out;
+    }
+}
@@ -0,0 +1,134 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#ifndef __NOVADESK_PERFCOUNTERS_H__
+#define __NOVADESK_PERFCOUNTERS_H__
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/*
+** Process-wide performance counters.
+**
+** Counters and histograms are fixed arrays of relaxed atomics, so recording
+** is a couple of uncontended atomic adds and is safe from any thread.
+** Histograms use power-of-two microsecond buckets: bucket 0 holds samples
+** below 1 us, bucket i holds [2^(i-1), 2^i) us, and the last bucket holds
+** everything from ~4 s upwards.
+**
+** This file has no platform dependencies; Windows-side reporting lives in
+** domain/PerfReport.
+*/
+namespace PerfCounters
+{
+    enum class Counter
+    {
+        WidgetRedraws = 0,
+        TimerCallbacks,
+        IpcMessages,
+        ImageLoads,
+        ImageLoadFailures,
+        SettingsLoads,
+        SettingsSaves,
+        ElementsCulled,
+        LayoutReflows,
+        RenderCacheHits,
+        RenderCacheBuilds,
+        ImageEffectBuilds,
+        Count
+    };
+
+    enum class Histogram
+    {
+        WidgetFrameTime = 0,
+        TimerCallbackTime,
+        IpcDispatchTime,
+        ImageLoadTime,
+        SettingsIoTime,
+        Count
+    };
+
+    constexpr int kHistogramBuckets = 24;
+
+    struct HistogramSnapshot
+    {
+        uint64_t count = 0;
+        uint64_t sumMicros = 0;
+        uint64_t maxMicros = 0;
+        uint64_t buckets[kHistogramBuckets] = {};
+
+        double MeanMicros() const { return count ? (double)sumMicros / (double)count : 0.0; }
+        // Upper bound of the bucket containing the given percentile (0..100).
+        uint64_t PercentileMicros(double percentile) const;
+    };
+
+    void Increment(Counter counter, uint64_t amount = 1);
+    void Record(Histogram histogram, uint64_t micros);
+
+    uint64_t GetCounter(Counter counter);
+    HistogramSnapshot GetHistogram(Histogram histogram);
+    void Reset();
+
+    const char *GetName(Counter counter);
+    const char *GetName(Histogram histogram);
+
+    int BucketForMicros(uint64_t micros);
+    uint64_t BucketUpperBoundMicros(int bucket);
+
+    // Counters, histograms and uptime as a JSON object (no trailing newline).
+    std::string FormatJson();
+
+    /*
+    ** Records the lifetime of the scope into a histogram and, optionally,
+    ** bumps a counter.
+    */
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(Histogram histogram)
+            : m_Histogram(histogram), m_Start(std::chrono::steady_clock::now()) {}
+        ScopedTimer(Histogram histogram, Counter counter)
+            : m_Histogram(histogram), m_Counter(counter), m_HasCounter(true), m_Start(std::chrono::steady_clock::now()) {}
+        ~ScopedTimer();
+
+        ScopedTimer(const ScopedTimer &) = delete;
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+        uint64_t ElapsedMicros() const;
+
+    private:
+        Histogram m_Histogram;
+        Counter m_Counter = Counter::Count;
+        bool m_HasCounter = false;
+        std::chrono::steady_clock::time_point m_Start;
+    };
+
+    /*
+    ** Per-object frame statistics (e.g. one per widget). Not atomic: owned
+    ** and updated by the thread that renders the object.
+    */
+    struct FrameStats
+    {
+        uint64_t frames = 0;
+        uint64_t lastMicros = 0;
+        uint64_t maxMicros = 0;
+        uint64_t totalMicros = 0;
+
+        void Record(uint64_t micros)
+        {
+            ++frames;
+            lastMicros = micros;
+            totalMicros += micros;
+            if (micros > maxMicros)
+                maxMicros = micros;
+        }
+        double MeanMicros() const { return frames ? (double)totalMicros / (double)frames : 0.0; }
+    };
+}
+
+#endif
@@ -0,0 +1,542 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "PixelKernels.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define NOVADESK_PIXELS_SSE2 1
+#endif
+#define NOVADESK_PIXELS_AVX2 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+// MSVC accepts AVX2 intrinsics in any function; GCC/Clang need the target.
+#define NOVADESK_TARGET_AVX2
+#else
+#define NOVADESK_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace PixelKernels
+{
+    namespace
+    {
+        std::atomic<int> s_Level{-1};
+
+        bool CpuHasAvx2()
+        {
+#if defined(NOVADESK_PIXELS_AVX2) && defined(_MSC_VER)
+            int regs[4] = {};
+            __cpuid(regs, 0);
+            if (regs[0] < 7)
+                return false;
+            __cpuid(regs, 1);
+            const bool osxsave = (regs[2] & (1 << 27)) != 0;
+            const bool avx = (regs[2] & (1 << 28)) != 0;
+            if (!osxsave || !avx || (_xgetbv(0) & 6) != 6)
+                return false;
+            __cpuidex(regs, 7, 0);
+            return (regs[1] & (1 << 5)) != 0;
+#elif defined(NOVADESK_PIXELS_AVX2)
+            return __builtin_cpu_supports("avx2") != 0;
+#else
+            return false;
+#endif
+        }
+
+        // round(c * a / 255) for bytes, exact.
+        inline uint8_t MulDiv255(unsigned c, unsigned a)
+        {
+            const unsigned t = c * a + 128;
+            return static_cast<uint8_t>((t + (t >> 8)) >> 8);
+        }
+
+        inline uint8_t RoundToByte(float v)
+        {
+            v = v < 0.0f ? 0.0f : v;
+            v = v > 255.0f ? 255.0f : v;
+            return static_cast<uint8_t>(static_cast<int>(v + 0.5f));
+        }
+
+        // ---- Scalar ----
+
+        void StampAlphaScalar(uint8_t *row, int count)
+        {
+            for (int x = 0; x < count; ++x)
+            {
+                uint8_t &alpha = row[static_cast<size_t>(x) * 4 + 3];
+                if (alpha == 0)
+                    alpha = 1;
+            }
+        }
+
+        void PremultiplyScalar(uint8_t *p, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i, p += 4)
+            {
+                const unsigned a = p[3];
+                p[0] = MulDiv255(p[0], a);
+                p[1] = MulDiv255(p[1], a);
+                p[2] = MulDiv255(p[2], a);
+            }
+        }
+
+        void UnpremultiplyScalar(uint8_t *p, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i, p += 4)
+            {
+                const unsigned a = p[3];
+                if (a == 0)
+                {
+                    p[0] = p[1] = p[2] = 0;
+                    continue;
+                }
+                const float scale = 255.0f / static_cast<float>(a);
+                for (int c = 0; c < 3; ++c)
+                {
+                    const int v = static_cast<int>(static_cast<float>(p[c]) * scale + 0.5f);
+                    p[c] = static_cast<uint8_t>(v > 255 ? 255 : v);
+                }
+            }
+        }
+
+        // Weights laid out per input channel in memory order (B, G, R, A),
+        // each holding the four output lanes in memory order.
+        struct MatrixLanes
+        {
+            float in[4][4];
+            float offset[4];
+        };
+
+        MatrixLanes MakeMatrixLanes(const float m[20])
+        {
+            // Memory lane k holds channel kToRgba[k] (B=2, G=1, R=0, A=3).
+            static const int kToRgba[4] = {2, 1, 0, 3};
+            MatrixLanes lanes;
+            for (int in = 0; in < 4; ++in)
+                for (int out = 0; out < 4; ++out)
+                    lanes.in[in][out] = m[kToRgba[in] * 4 + kToRgba[out]];
+            for (int out = 0; out < 4; ++out)
+                lanes.offset[out] = m[16 + kToRgba[out]] * 255.0f;
+            return lanes;
+        }
+
+        // Accumulation order (offset, R, G, B, A) is shared by every level so
+        // the float results match bit for bit.
+        const int kAccumulateOrder[4] = {2, 1, 0, 3};
+
+        void ApplyColorMatrixScalar(uint8_t *p, size_t count, const MatrixLanes &lanes)
+        {
+            for (size_t i = 0; i < count; ++i, p += 4)
+            {
+                float acc[4];
+                for (int out = 0; out < 4; ++out)
+                {
+                    acc[out] = lanes.offset[out];
+                    for (int k : kAccumulateOrder)
+                        acc[out] = acc[out] + static_cast<float>(p[k]) * lanes.in[k][out];
+                }
+                for (int out = 0; out < 4; ++out)
+                    p[out] = RoundToByte(acc[out]);
+            }
+        }
+
+        inline uint8_t MeanToByte(uint32_t sum, float inv)
+        {
+            return static_cast<uint8_t>(static_cast<int>(static_cast<float>(sum) * inv + 0.5f));
+        }
+
+        // Horizontal pass over one row: out[i] is the mean of the pixels
+        // in[clamp(i - r .. i + r)].
+        void BlurRowScalar(const uint8_t *in, uint8_t *out, int count, int radius, float inv)
+        {
+            uint32_t sum[4] = {};
+            for (int k = -radius; k <= radius; ++k)
+            {
+                const uint8_t *s = in + static_cast<size_t>((std::min)((std::max)(k, 0), count - 1)) * 4;
+                for (int c = 0; c < 4; ++c)
+                    sum[c] += s[c];
+            }
+            for (int i = 0; i < count; ++i)
+            {
+                uint8_t *d = out + static_cast<size_t>(i) * 4;
+                for (int c = 0; c < 4; ++c)
+                    d[c] = MeanToByte(sum[c], inv);
+                const uint8_t *add = in + static_cast<size_t>((std::min)(i + radius + 1, count - 1)) * 4;
+                const uint8_t *sub = in + static_cast<size_t>((std::max)(i - radius, 0)) * 4;
+                for (int c = 0; c < 4; ++c)
+                    sum[c] = sum[c] + add[c] - sub[c];
+            }
+        }
+
+        // Vertical pass, walking rows with one running sum per byte column so
+        // memory is read in order.
+        void BlurColumnsScalar(const uint8_t *in, size_t inStride, uint8_t *out, size_t outStride,
+                               int width, int height, int radius, float inv, uint32_t *sums)
+        {
+            const size_t bytes = static_cast<size_t>(width) * 4;
+            std::fill(sums, sums + bytes, 0u);
+            for (int k = -radius; k <= radius; ++k)
+            {
+                const uint8_t *row = in + static_cast<size_t>((std::min)((std::max)(k, 0), height - 1)) * inStride;
+                for (size_t j = 0; j < bytes; ++j)
+                    sums[j] += row[j];
+            }
+            for (int y = 0; y < height; ++y)
+            {
+                uint8_t *d = out + static_cast<size_t>(y) * outStride;
+                for (size_t j = 0; j < bytes; ++j)
+                    d[j] = MeanToByte(sums[j], inv);
+                const uint8_t *add = in + static_cast<size_t>((std::min)(y + radius + 1, height - 1)) * inStride;
+                const uint8_t *sub = in + static_cast<size_t>((std::max)(y - radius, 0)) * inStride;
+                for (size_t j = 0; j < bytes; ++j)
+                    sums[j] = sums[j] + add[j] - sub[j];
+            }
+        }
+
+#ifdef NOVADESK_PIXELS_SSE2
+        // ---- SSE2: four pixels per step, or one pixel's four channels ----
+
+        void StampAlphaSse2(uint8_t *row, int count)
+        {
+            const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+            const __m128i alphaOne = _mm_set1_epi32(0x01000000);
+            const __m128i zero = _mm_setzero_si128();
+            int x = 0;
+            for (; x + 4 <= count; x += 4)
+            {
+                __m128i *p = reinterpret_cast<__m128i *>(row + static_cast<size_t>(x) * 4);
+                const __m128i v = _mm_loadu_si128(p);
+                const __m128i transparent = _mm_cmpeq_epi32(_mm_and_si128(v, alphaMask), zero);
+                _mm_storeu_si128(p, _mm_or_si128(v, _mm_and_si128(transparent, alphaOne)));
+            }
+            StampAlphaScalar(row + static_cast<size_t>(x) * 4, count - x);
+        }
+
+        inline __m128i MulDiv255Epi16(__m128i c, __m128i a)
+        {
+            const __m128i t = _mm_add_epi16(_mm_mullo_epi16(c, a), _mm_set1_epi16(128));
+            return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+        }
+
+        void PremultiplySse2(uint8_t *p, size_t count)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128i *ptr = reinterpret_cast<__m128i *>(p + i * 4);
+                const __m128i v = _mm_loadu_si128(ptr);
+                const __m128i lo = _mm_unpacklo_epi8(v, zero);
+                const __m128i hi = _mm_unpackhi_epi8(v, zero);
+                const __m128i aLo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+                const __m128i aHi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+                const __m128i scaled = _mm_packus_epi16(MulDiv255Epi16(lo, aLo), MulDiv255Epi16(hi, aHi));
+                _mm_storeu_si128(ptr, _mm_or_si128(_mm_andnot_si128(alphaMask, scaled), _mm_and_si128(alphaMask, v)));
+            }
+            PremultiplyScalar(p + i * 4, count - i);
+        }
+
+        inline __m128 LoadPixelPs(const uint8_t *p)
+        {
+            uint32_t bits = 0;
+            std::memcpy(&bits, p, 4);
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i v = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(bits)), zero), zero);
+            return _mm_cvtepi32_ps(v);
+        }
+
+        inline void StorePixelPs(uint8_t *p, __m128 v)
+        {
+            v = _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(255.0f));
+            const __m128i i32 = _mm_cvttps_epi32(_mm_add_ps(v, _mm_set1_ps(0.5f)));
+            const __m128i i16 = _mm_packs_epi32(i32, i32);
+            const uint32_t bits = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(i16, i16)));
+            std::memcpy(p, &bits, 4);
+        }
+
+        void UnpremultiplySse2(uint8_t *p, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i, p += 4)
+            {
+                const unsigned a = p[3];
+                if (a == 0)
+                {
+                    p[0] = p[1] = p[2] = 0;
+                    continue;
+                }
+                if (a == 255)
+                    continue;
+                const __m128 scale = _mm_set1_ps(255.0f / static_cast<float>(a));
+                const __m128 v = _mm_add_ps(_mm_mul_ps(LoadPixelPs(p), scale), _mm_set1_ps(0.5f));
+                __m128i i32 = _mm_cvttps_epi32(v);
+                i32 = _mm_packs_epi32(i32, i32);
+                const uint32_t bits = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(i32, i32)));
+                const uint8_t alpha = p[3];
+                std::memcpy(p, &bits, 4);
+                p[3] = alpha;
+            }
+        }
+
+        void ApplyColorMatrixSse2(uint8_t *p, size_t count, const MatrixLanes &lanes)
+        {
+            __m128 rows[4];
+            for (int k = 0; k < 4; ++k)
+                rows[k] = _mm_loadu_ps(lanes.in[k]);
+            const __m128 offset = _mm_loadu_ps(lanes.offset);
+            for (size_t i = 0; i < count; ++i, p += 4)
+            {
+                __m128 acc = offset;
+                for (int k : kAccumulateOrder)
+                    acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(static_cast<float>(p[k])), rows[k]));
+                StorePixelPs(p, acc);
+            }
+        }
+
+        inline __m128i LoadPixelEpi32(const uint8_t *p)
+        {
+            uint32_t bits = 0;
+            std::memcpy(&bits, p, 4);
+            const __m128i zero = _mm_setzero_si128();
+            return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(bits)), zero), zero);
+        }
+
+        inline void StoreMeanEpi32(uint8_t *p, __m128i sum, __m128 inv)
+        {
+            __m128i v = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(sum), inv), _mm_set1_ps(0.5f)));
+            v = _mm_packs_epi32(v, v);
+            const uint32_t bits = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(v, v)));
+            std::memcpy(p, &bits, 4);
+        }
+
+        void BlurRowSse2(const uint8_t *in, uint8_t *out, int count, int radius, float inv)
+        {
+            __m128i sum = _mm_setzero_si128();
+            for (int k = -radius; k <= radius; ++k)
+                sum = _mm_add_epi32(sum, LoadPixelEpi32(in + static_cast<size_t>((std::min)((std::max)(k, 0), count - 1)) * 4));
+
+            const __m128 scale = _mm_set1_ps(inv);
+            for (int i = 0; i < count; ++i)
+            {
+                StoreMeanEpi32(out + static_cast<size_t>(i) * 4, sum, scale);
+                const __m128i add = LoadPixelEpi32(in + static_cast<size_t>((std::min)(i + radius + 1, count - 1)) * 4);
+                const __m128i sub = LoadPixelEpi32(in + static_cast<size_t>((std::max)(i - radius, 0)) * 4);
+                sum = _mm_sub_epi32(_mm_add_epi32(sum, add), sub);
+            }
+        }
+
+        void BlurColumnsSse2(const uint8_t *in, size_t inStride, uint8_t *out, size_t outStride,
+                             int width, int height, int radius, float inv, uint32_t *sums)
+        {
+            __m128i *lanes = reinterpret_cast<__m128i *>(sums);
+            for (int x = 0; x < width; ++x)
+                _mm_storeu_si128(lanes + x, _mm_setzero_si128());
+            for (int k = -radius; k <= radius; ++k)
+            {
+                const uint8_t *row = in + static_cast<size_t>((std::min)((std::max)(k, 0), height - 1)) * inStride;
+                for (int x = 0; x < width; ++x)
+                    _mm_storeu_si128(lanes + x, _mm_add_epi32(_mm_loadu_si128(lanes + x), LoadPixelEpi32(row + static_cast<size_t>(x) * 4)));
+            }
+
+            const __m128 scale = _mm_set1_ps(inv);
+            for (int y = 0; y < height; ++y)
+            {
+                uint8_t *d = out + static_cast<size_t>(y) * outStride;
+                const uint8_t *add = in + static_cast<size_t>((std::min)(y + radius + 1, height - 1)) * inStride;
+                const uint8_t *sub = in + static_cast<size_t>((std::max)(y - radius, 0)) * inStride;
+                for (int x = 0; x < width; ++x)
+                {
+                    const size_t offset = static_cast<size_t>(x) * 4;
+                    const __m128i sum = _mm_loadu_si128(lanes + x);
+                    StoreMeanEpi32(d + offset, sum, scale);
+                    _mm_storeu_si128(lanes + x, _mm_sub_epi32(_mm_add_epi32(sum, LoadPixelEpi32(add + offset)), LoadPixelEpi32(sub + offset)));
+                }
+            }
+        }
+#endif
+
+#ifdef NOVADESK_PIXELS_AVX2
+        // ---- AVX2: eight pixels per step for the integer passes ----
+
+        NOVADESK_TARGET_AVX2 void StampAlphaAvx2(uint8_t *row, int count)
+        {
+            const __m256i alphaMask = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+            const __m256i alphaOne = _mm256_set1_epi32(0x01000000);
+            const __m256i zero = _mm256_setzero_si256();
+            int x = 0;
+            for (; x + 8 <= count; x += 8)
+            {
+                __m256i *p = reinterpret_cast<__m256i *>(row + static_cast<size_t>(x) * 4);
+                const __m256i v = _mm256_loadu_si256(p);
+                const __m256i transparent = _mm256_cmpeq_epi32(_mm256_and_si256(v, alphaMask), zero);
+                _mm256_storeu_si256(p, _mm256_or_si256(v, _mm256_and_si256(transparent, alphaOne)));
+            }
+            StampAlphaScalar(row + static_cast<size_t>(x) * 4, count - x);
+        }
+
+        NOVADESK_TARGET_AVX2 void PremultiplyAvx2(uint8_t *p, size_t count)
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i alphaMask = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+            const __m256i bias = _mm256_set1_epi16(128);
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256i *ptr = reinterpret_cast<__m256i *>(p + i * 4);
+                const __m256i v = _mm256_loadu_si256(ptr);
+                // unpack/pack work within 128-bit lanes, so pixel order is kept.
+                const __m256i lo = _mm256_unpacklo_epi8(v, zero);
+                const __m256i hi = _mm256_unpackhi_epi8(v, zero);
+                const __m256i aLo = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(lo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+                const __m256i aHi = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(hi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+                __m256i tLo = _mm256_add_epi16(_mm256_mullo_epi16(lo, aLo), bias);
+                __m256i tHi = _mm256_add_epi16(_mm256_mullo_epi16(hi, aHi), bias);
+                tLo = _mm256_srli_epi16(_mm256_add_epi16(tLo, _mm256_srli_epi16(tLo, 8)), 8);
+                tHi = _mm256_srli_epi16(_mm256_add_epi16(tHi, _mm256_srli_epi16(tHi, 8)), 8);
+                const __m256i scaled = _mm256_packus_epi16(tLo, tHi);
+                _mm256_storeu_si256(ptr, _mm256_or_si256(_mm256_andnot_si256(alphaMask, scaled), _mm256_and_si256(alphaMask, v)));
+            }
+            PremultiplyScalar(p + i * 4, count - i);
+        }
+#endif
+    }
+
+    Level GetSupportedLevel()
+    {
+        static const Level supported = []()
+        {
+            if (CpuHasAvx2())
+                return Level::Avx2;
+#ifdef NOVADESK_PIXELS_SSE2
+            return Level::Sse2;
+#else
+            return Level::Scalar;
+#endif
+        }();
+        return supported;
+    }
+
+    Level GetLevel()
+    {
+        const int level = s_Level.load(std::memory_order_relaxed);
+        return level < 0 ? GetSupportedLevel() : static_cast<Level>(level);
+    }
+
+    void SetLevel(Level level)
+    {
+        const Level supported = GetSupportedLevel();
+        s_Level.store(static_cast<int>(level > supported ? supported : level), std::memory_order_relaxed);
+    }
+
+    const char *GetLevelName(Level level)
+    {
+        switch (level)
+        {
+        case Level::Avx2:
+            return "avx2";
+        case Level::Sse2:
+            return "sse2";
+        default:
+            return "scalar";
+        }
+    }
+
+    void StampAlpha(uint8_t *pixels, int stride, int left, int top, int right, int bottom)
+    {
+        if (!pixels || left >= right || top >= bottom)
+            return;
+
+        void (*kernel)(uint8_t *, int) = StampAlphaScalar;
+        const Level level = GetLevel();
+#ifdef NOVADESK_PIXELS_AVX2
+        if (level == Level::Avx2)
+            kernel = StampAlphaAvx2;
+#endif
+#ifdef NOVADESK_PIXELS_SSE2
+        if (level == Level::Sse2)
+            kernel = StampAlphaSse2;
+#endif
+        (void)level;
+
+        for (int y = top; y < bottom; ++y)
+            kernel(pixels + static_cast<size_t>(y) * static_cast<size_t>(stride) + static_cast<size_t>(left) * 4, right - left);
+    }
+
+    void Premultiply(uint8_t *pixels, size_t count)
+    {
+        if (!pixels)
+            return;
+        const Level level = GetLevel();
+#ifdef NOVADESK_PIXELS_AVX2
+        if (level == Level::Avx2)
+            return PremultiplyAvx2(pixels, count);
+#endif
+#ifdef NOVADESK_PIXELS_SSE2
+        if (level >= Level::Sse2)
+            return PremultiplySse2(pixels, count);
+#endif
+        (void)level;
+        PremultiplyScalar(pixels, count);
+    }
+
+    void Unpremultiply(uint8_t *pixels, size_t count)
+    {
+        if (!pixels)
+            return;
+#ifdef NOVADESK_PIXELS_SSE2
+        if (GetLevel() >= Level::Sse2)
+            return UnpremultiplySse2(pixels, count);
+#endif
+        UnpremultiplyScalar(pixels, count);
+    }
+
+    void ApplyColorMatrix(uint8_t *pixels, size_t count, const float matrix[20])
+    {
+        if (!pixels || !matrix)
+            return;
+        const MatrixLanes lanes = MakeMatrixLanes(matrix);
+#ifdef NOVADESK_PIXELS_SSE2
+        if (GetLevel() >= Level::Sse2)
+            return ApplyColorMatrixSse2(pixels, count, lanes);
+#endif
+        ApplyColorMatrixScalar(pixels, count, lanes);
+    }
+
+    void BoxBlur(uint8_t *pixels, int width, int height, int stride, int radius, std::vector<uint32_t> &scratch)
+    {
+        if (!pixels || width <= 0 || height <= 0 || radius <= 0)
+            return;
+
+        void (*blurRow)(const uint8_t *, uint8_t *, int, int, float) = BlurRowScalar;
+        void (*blurColumns)(const uint8_t *, size_t, uint8_t *, size_t, int, int, int, float, uint32_t *) = BlurColumnsScalar;
+#ifdef NOVADESK_PIXELS_SSE2
+        if (GetLevel() >= Level::Sse2)
+        {
+            blurRow = BlurRowSse2;
+            blurColumns = BlurColumnsSse2;
+        }
+#endif
+
+        // Scratch holds the horizontally blurred image followed by the
+        // per-column running sums of the vertical pass.
+        const size_t pixelCount = static_cast<size_t>(width) * static_cast<size_t>(height);
+        scratch.resize(pixelCount + static_cast<size_t>(width) * 4);
+        uint8_t *temp = reinterpret_cast<uint8_t *>(scratch.data());
+        const size_t tempStride = static_cast<size_t>(width) * 4;
+        const float inv = 1.0f / static_cast<float>(2 * radius + 1);
+
+        for (int y = 0; y < height; ++y)
+            blurRow(pixels + static_cast<size_t>(y) * static_cast<size_t>(stride), temp + static_cast<size_t>(y) * tempStride, width, radius, inv);
+        blurColumns(temp, tempStride, pixels, static_cast<size_t>(stride), width, height, radius, inv, scratch.data() + pixelCount);
+    }
+}
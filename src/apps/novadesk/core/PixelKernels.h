@@ -0,0 +1,58 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+** Per-pixel passes over 32-bit BGRA buffers (alpha in byte 3). Each kernel has
+** a scalar version and SSE2/AVX2 versions on x86/x64; the widest one the CPU
+** supports is picked at run time. Every level gives bit-identical results.
+**
+** Buffers are rows of 'stride' bytes; 'count' variants take tightly packed
+** pixels.
+*/
+namespace PixelKernels
+{
+    enum class Level
+    {
+        Scalar = 0,
+        Sse2,
+        Avx2
+    };
+
+    // Widest level supported by this CPU and build.
+    Level GetSupportedLevel();
+    // Level the kernels currently use (defaults to the supported one).
+    Level GetLevel();
+    // Force a level, clamped to what is supported; used by checks and benches.
+    void SetLevel(Level level);
+    const char *GetLevelName(Level level);
+
+    // Lift fully transparent pixels in [left, right) x [top, bottom) to
+    // alpha 1 so a layered window keeps the area mouse-reachable. Colour
+    // bytes are left alone. The rectangle must lie inside the buffer.
+    void StampAlpha(uint8_t *pixels, int stride, int left, int top, int right, int bottom);
+
+    // Straight <-> premultiplied alpha, rounding to nearest. Unpremultiplying
+    // a pixel with zero alpha gives transparent black.
+    void Premultiply(uint8_t *pixels, size_t count);
+    void Unpremultiply(uint8_t *pixels, size_t count);
+
+    // Apply a 5x4 colour matrix to straight-alpha pixels, using the D2D /
+    // script layout: row i holds the weights of input channel i (R, G, B, A),
+    // row 4 the offsets, column j the output channel. Results are clamped.
+    void ApplyColorMatrix(uint8_t *pixels, size_t count, const float matrix[20]);
+
+    // Box blur of all four channels with a (2 * radius + 1) window, edges
+    // clamped; horizontal then vertical pass. Works on premultiplied pixels.
+    // 'scratch' is reused between calls.
+    void BoxBlur(uint8_t *pixels, int width, int height, int stride, int radius, std::vector<uint32_t> &scratch);
+}
@@ -0,0 +1,51 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#ifndef __NOVADESK_PLATFORMTYPES_H__
+#define __NOVADESK_PLATFORMTYPES_H__
+
+/*
+** Win32 scalar types used by the portable core (colour, layout, parsing).
+** On Windows this is just <windows.h>; elsewhere the handful of types and
+** CRT helpers the core relies on are defined with identical semantics so
+** the same sources build in the standalone core library.
+*/
+
+#ifdef _WIN32
+
+#include <windows.h>
+
+#else
+
+#include <cstdint>
+#include <cstdio>
+#include <cwchar>
+
+typedef uint8_t BYTE;
+typedef uint16_t WORD;
+typedef uint32_t DWORD;
+typedef DWORD COLORREF;
+
+#ifndef LOBYTE
+#define LOBYTE(w) ((BYTE)(((uintptr_t)(w)) & 0xff))
+#endif
+#ifndef RGB
+#define RGB(r, g, b) ((COLORREF)(((BYTE)(r) | ((WORD)((BYTE)(g)) << 8)) | (((DWORD)(BYTE)(b)) << 16)))
+#endif
+
+// The core only uses the secure CRT variants with numeric conversions.
+#define swscanf_s swscanf
+
+template <size_t N, typename... Args>
+inline int swprintf_s(wchar_t (&buffer)[N], const wchar_t *format, Args... args)
+{
+    return swprintf(buffer, N, format, args...);
+}
+
+#endif // _WIN32
+
+#endif // __NOVADESK_PLATFORMTYPES_H__
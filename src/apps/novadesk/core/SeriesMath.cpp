@@ -0,0 +1,232 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "SeriesMath.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define NOVADESK_SERIES_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace SeriesMath
+{
+    bool MinMax(const float *values, size_t count, float &minValue, float &maxValue)
+    {
+        float minV = std::numeric_limits<float>::infinity();
+        float maxV = -std::numeric_limits<float>::infinity();
+        size_t i = 0;
+
+#ifdef NOVADESK_SERIES_SSE2
+        if (count >= 4)
+        {
+            // minps/maxps return the second operand when either is NaN, so
+            // NaN inputs leave the accumulators alone.
+            __m128 minAcc = _mm_set1_ps(minV);
+            __m128 maxAcc = _mm_set1_ps(maxV);
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128 v = _mm_loadu_ps(values + i);
+                minAcc = _mm_min_ps(v, minAcc);
+                maxAcc = _mm_max_ps(v, maxAcc);
+            }
+            float lanes[4];
+            _mm_storeu_ps(lanes, minAcc);
+            for (float lane : lanes)
+                minV = lane < minV ? lane : minV;
+            _mm_storeu_ps(lanes, maxAcc);
+            for (float lane : lanes)
+                maxV = lane > maxV ? lane : maxV;
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            const float v = values[i];
+            if (v < minV)
+                minV = v;
+            if (v > maxV)
+                maxV = v;
+        }
+
+        if (!(minV <= maxV))
+            return false;
+        minValue = minV;
+        maxValue = maxV;
+        return true;
+    }
+
+    void ScaleToPixels(const float *values, size_t count, float minValue, float maxValue, float scale, int *out)
+    {
+        const float range = maxValue - minValue;
+        if (range <= 0.000001f)
+        {
+            for (size_t i = 0; i < count; ++i)
+                out[i] = 0;
+            return;
+        }
+
+        size_t i = 0;
+#ifdef NOVADESK_SERIES_SSE2
+        const __m128 minVec = _mm_set1_ps(minValue);
+        const __m128 rangeVec = _mm_set1_ps(range);
+        const __m128 scaleVec = _mm_set1_ps(scale);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 n = _mm_div_ps(_mm_sub_ps(_mm_loadu_ps(values + i), minVec), rangeVec);
+            n = _mm_max_ps(n, zero); // NaN -> 0
+            n = _mm_min_ps(n, one);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_cvttps_epi32(_mm_mul_ps(n, scaleVec)));
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            float n = (values[i] - minValue) / range;
+            if (!(n > 0.0f))
+                n = 0.0f;
+            if (n > 1.0f)
+                n = 1.0f;
+            out[i] = static_cast<int>(n * scale);
+        }
+    }
+
+    bool AppendBandOutline(const int *lower, const int *upper, size_t count, std::vector<Point> &out)
+    {
+        bool empty = true;
+        for (size_t c = 0; c < count && empty; ++c)
+            empty = upper[c] <= lower[c];
+        if (empty)
+            return false;
+
+        const size_t first = out.size();
+        auto add = [&out, first](size_t u, int v)
+        {
+            if (out.size() > first && out.back().u == static_cast<int>(u) && out.back().v == v)
+                return;
+            Point p;
+            p.u = static_cast<int>(u);
+            p.v = v;
+            out.push_back(p);
+        };
+
+        // Forward along the top edge, then back along the bottom edge.
+        add(0, lower[0]);
+        add(0, upper[0]);
+        for (size_t c = 1; c < count; ++c)
+        {
+            if (upper[c] != upper[c - 1])
+            {
+                add(c, upper[c - 1]);
+                add(c, upper[c]);
+            }
+        }
+        add(count, upper[count - 1]);
+        add(count, lower[count - 1]);
+        for (size_t c = count - 1; c > 0; --c)
+        {
+            if (lower[c - 1] != lower[c])
+            {
+                add(c, lower[c]);
+                add(c, lower[c - 1]);
+            }
+        }
+        return true;
+    }
+
+    bool FindScroll(const float *previous, size_t previousCount, const float *values, size_t count, size_t maxDropped, size_t &dropped)
+    {
+        if (previousCount == 0)
+            return false;
+        const size_t last = previousCount - 1 < maxDropped ? previousCount - 1 : maxDropped;
+        for (size_t k = 0; k <= last; ++k)
+        {
+            const size_t kept = previousCount - k;
+            if (kept > count)
+                continue;
+            // Cheap probes at both ends before comparing the whole overlap.
+            if (std::memcmp(previous + k, values, sizeof(float)) != 0 ||
+                std::memcmp(previous + previousCount - 1, values + kept - 1, sizeof(float)) != 0)
+                continue;
+            if (std::memcmp(previous + k, values, kept * sizeof(float)) == 0)
+            {
+                dropped = k;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void DecimateLttb(const float *values, size_t count, size_t threshold, std::vector<size_t> &out)
+    {
+        out.clear();
+        if (threshold >= count || threshold < 3)
+        {
+            out.resize(count);
+            for (size_t i = 0; i < count; ++i)
+                out[i] = i;
+            return;
+        }
+
+        // Buckets between the fixed first and last sample.
+        const double every = static_cast<double>(count - 2) / static_cast<double>(threshold - 2);
+        size_t a = 0;
+        out.push_back(a);
+        for (size_t bucket = 0; bucket < threshold - 2; ++bucket)
+        {
+            // Average of the next bucket is the third triangle corner.
+            size_t avgBegin = static_cast<size_t>(std::floor((bucket + 1) * every)) + 1;
+            size_t avgEnd = static_cast<size_t>(std::floor((bucket + 2) * every)) + 1;
+            avgEnd = avgEnd < count ? avgEnd : count;
+            double avgX = 0.0;
+            double avgY = 0.0;
+            size_t avgCount = 0;
+            for (size_t i = avgBegin; i < avgEnd; ++i)
+            {
+                if (std::isnan(values[i]))
+                    continue;
+                avgX += static_cast<double>(i);
+                avgY += values[i];
+                ++avgCount;
+            }
+            if (avgCount > 0)
+            {
+                avgX /= static_cast<double>(avgCount);
+                avgY /= static_cast<double>(avgCount);
+            }
+            else
+            {
+                avgX = static_cast<double>(avgBegin < count ? avgBegin : count - 1);
+                avgY = 0.0;
+            }
+
+            const size_t rangeBegin = static_cast<size_t>(std::floor(bucket * every)) + 1;
+            const size_t rangeEnd = static_cast<size_t>(std::floor((bucket + 1) * every)) + 1;
+            const double ax = static_cast<double>(a);
+            const double ay = values[a];
+            double maxArea = -1.0;
+            size_t next = rangeBegin;
+            for (size_t i = rangeBegin; i < rangeEnd && i < count; ++i)
+            {
+                const double area = std::fabs((ax - avgX) * (values[i] - ay) - (ax - static_cast<double>(i)) * (avgY - ay));
+                if (area > maxArea)
+                {
+                    maxArea = area;
+                    next = i;
+                }
+            }
+            out.push_back(next);
+            a = next;
+        }
+        out.push_back(count - 1);
+    }
+}
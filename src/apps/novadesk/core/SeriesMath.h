@@ -0,0 +1,51 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/*
+** Data-series helpers for the chart elements. The per-value passes use SSE2
+** on x86/x64 (four values per step) and a scalar loop elsewhere; both give
+** identical results.
+*/
+namespace SeriesMath
+{
+    // Smallest and largest value; NaNs are ignored. Returns false, leaving the
+    // outputs untouched, if there is no value.
+    bool MinMax(const float *values, size_t count, float &minValue, float &maxValue);
+
+    // Bar length of each value in whole pixels:
+    //   out[i] = (int)(clamp((values[i] - minValue) / (maxValue - minValue), 0, 1) * scale)
+    // NaN maps to 0, and so does everything when the range is (nearly) empty.
+    void ScaleToPixels(const float *values, size_t count, float minValue, float maxValue, float scale, int *out);
+
+    struct Point
+    {
+        int u = 0;  // along the series (one column per value)
+        int v = 0;  // along the bars
+    };
+
+    // Outline of the band covered by bars that run from lower[c] to upper[c]
+    // in column [c, c + 1), as one closed polygon (runs of equal columns are
+    // merged). Requires upper[c] >= lower[c]. Returns false and appends nothing
+    // if the band is empty.
+    bool AppendBandOutline(const int *lower, const int *upper, size_t count, std::vector<Point> &out);
+
+    // Finds how 'values' follows on from 'previous' when a chart scrolls:
+    // 'dropped' samples left the front (at most maxDropped) and the rest were
+    // kept bit-for-bit, possibly with new samples appended. Returns false if
+    // no such overlap exists.
+    bool FindScroll(const float *previous, size_t previousCount, const float *values, size_t count, size_t maxDropped, size_t &dropped);
+
+    // Largest-triangle-three-buckets: indices, ascending, of 'threshold'
+    // samples that keep the visual shape of the series. The first and last
+    // sample are always kept; shorter series are returned whole.
+    void DecimateLttb(const float *values, size_t count, size_t threshold, std::vector<size_t> &out);
+}
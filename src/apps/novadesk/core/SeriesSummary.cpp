@@ -0,0 +1,211 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "SeriesSummary.h"
+#include "SeriesMath.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Direct scan: the min/max pass is vectorised, locating the first sample
+    // holding each extreme is a plain compare.
+    bool ScanMinMax(const float *values, size_t begin, size_t end, size_t &minIndex, size_t &maxIndex)
+    {
+        float minValue = 0.0f;
+        float maxValue = 0.0f;
+        if (begin >= end || !SeriesMath::MinMax(values + begin, end - begin, minValue, maxValue))
+            return false;
+
+        minIndex = maxIndex = end;
+        for (size_t i = begin; i < end && (minIndex == end || maxIndex == end); ++i)
+        {
+            if (minIndex == end && values[i] == minValue)
+                minIndex = i;
+            if (maxIndex == end && values[i] == maxValue)
+                maxIndex = i;
+        }
+        return true;
+    }
+}
+
+void SeriesSummary::Clear()
+{
+    m_Blocks.clear();
+    m_Skipped = 0;
+    m_FirstBlock = 0;
+    m_Origin = 0;
+    m_Count = 0;
+}
+
+void SeriesSummary::Assign(const float *values, size_t count)
+{
+    Clear();
+    m_Count = count;
+    m_Blocks.resize((count + kBlockSize - 1) / kBlockSize);
+    for (size_t block = 0; block < m_Blocks.size(); ++block)
+        BuildBlock(values, block);
+}
+
+void SeriesSummary::Scroll(const float *values, size_t count, size_t dropped)
+{
+    if (dropped > m_Count || m_Count - dropped > count || count == 0)
+    {
+        Assign(values, count);
+        return;
+    }
+
+    const size_t keptEnd = m_Origin + m_Count;
+    m_Origin += dropped;
+    m_Count = count;
+    const size_t newEnd = m_Origin + m_Count;
+
+    // Retire blocks that now lie entirely before the first sample.
+    const size_t firstBlock = m_Origin / kBlockSize;
+    const size_t live = m_Blocks.size() - m_Skipped;
+    m_Skipped += (std::min)(firstBlock - m_FirstBlock, live);
+    m_FirstBlock = firstBlock;
+    if (m_Skipped > m_Blocks.size() - m_Skipped)
+    {
+        m_Blocks.erase(m_Blocks.begin(), m_Blocks.begin() + static_cast<std::ptrdiff_t>(m_Skipped));
+        m_Skipped = 0;
+    }
+
+    const size_t lastBlock = (newEnd - 1) / kBlockSize;
+    m_Blocks.resize(m_Skipped + lastBlock - m_FirstBlock + 1);
+
+    // The first block lost samples off its front, the block holding the old
+    // end gained some, and everything after it is new.
+    if (dropped > 0 && m_Origin % kBlockSize != 0)
+        BuildBlock(values, firstBlock);
+    if (newEnd > keptEnd)
+    {
+        for (size_t block = (std::max)(keptEnd / kBlockSize, firstBlock); block <= lastBlock; ++block)
+            BuildBlock(values, block);
+    }
+}
+
+void SeriesSummary::BuildBlock(const float *values, size_t absoluteBlock)
+{
+    const size_t begin = (std::max)(absoluteBlock * kBlockSize, m_Origin) - m_Origin;
+    const size_t end = (std::min)((absoluteBlock + 1) * kBlockSize, m_Origin + m_Count) - m_Origin;
+
+    Block &block = BlockAt(absoluteBlock);
+    size_t minIndex = 0;
+    size_t maxIndex = 0;
+    block.hasValue = ScanMinMax(values, begin, end, minIndex, maxIndex);
+    if (block.hasValue)
+    {
+        block.minValue = values[minIndex];
+        block.maxValue = values[maxIndex];
+        block.minIndex = m_Origin + minIndex;
+        block.maxIndex = m_Origin + maxIndex;
+    }
+}
+
+bool SeriesSummary::MinMax(float &minValue, float &maxValue) const
+{
+    bool hasValue = false;
+    for (size_t i = m_Skipped; i < m_Blocks.size(); ++i)
+    {
+        const Block &block = m_Blocks[i];
+        if (!block.hasValue)
+            continue;
+        minValue = hasValue ? (std::min)(minValue, block.minValue) : block.minValue;
+        maxValue = hasValue ? (std::max)(maxValue, block.maxValue) : block.maxValue;
+        hasValue = true;
+    }
+    return hasValue;
+}
+
+bool SeriesSummary::RangeMinMax(const float *values, size_t begin, size_t end, size_t &minIndex, size_t &maxIndex) const
+{
+    const size_t absBegin = m_Origin + begin;
+    const size_t absEnd = m_Origin + end;
+    const size_t fullBegin = (absBegin + kBlockSize - 1) / kBlockSize;
+    const size_t fullEnd = absEnd / kBlockSize;
+    if (fullBegin >= fullEnd)
+        return ScanMinMax(values, begin, end, minIndex, maxIndex);
+
+    bool hasValue = false;
+    auto merge = [&](size_t candidateMin, size_t candidateMax)
+    {
+        if (!hasValue || values[candidateMin] < values[minIndex])
+            minIndex = candidateMin;
+        if (!hasValue || values[candidateMax] > values[maxIndex])
+            maxIndex = candidateMax;
+        hasValue = true;
+    };
+
+    size_t partMin = 0;
+    size_t partMax = 0;
+    if (ScanMinMax(values, begin, fullBegin * kBlockSize - m_Origin, partMin, partMax))
+        merge(partMin, partMax);
+    for (size_t block = fullBegin; block < fullEnd; ++block)
+    {
+        const Block &summary = BlockAt(block);
+        if (summary.hasValue)
+            merge(summary.minIndex - m_Origin, summary.maxIndex - m_Origin);
+    }
+    if (ScanMinMax(values, fullEnd * kBlockSize - m_Origin, end, partMin, partMax))
+        merge(partMin, partMax);
+    return hasValue;
+}
+
+void SeriesSummary::DecimateMinMax(const float *values, float offset, float spacing, std::vector<size_t> &out) const
+{
+    out.clear();
+    const size_t count = m_Count;
+    if (count == 0)
+        return;
+
+    // Worth it only when columns hold more than the four samples kept per column.
+    const double columns = spacing > 0.0f ? static_cast<double>(count - 1) * spacing + 1.0 : 0.0;
+    if (spacing <= 0.0f || static_cast<double>(count) <= 4.0 * (columns + 1.0))
+    {
+        out.resize(count);
+        for (size_t i = 0; i < count; ++i)
+            out[i] = i;
+        return;
+    }
+
+    const double origin = offset;
+    const double step = spacing;
+    auto columnOf = [&](size_t i) { return std::floor(origin + static_cast<double>(i) * step); };
+
+    size_t kept[4];
+    size_t begin = 0;
+    while (begin < count)
+    {
+        const double column = columnOf(begin);
+        size_t end = static_cast<size_t>((std::max)(0.0, std::ceil((column + 1.0 - origin) / step)));
+        end = (std::min)((std::max)(end, begin + 1), count);
+        while (end > begin + 1 && columnOf(end - 1) > column)
+            --end;
+        while (end < count && columnOf(end) <= column)
+            ++end;
+
+        size_t keptCount = 0;
+        kept[keptCount++] = begin;
+        size_t minIndex = 0;
+        size_t maxIndex = 0;
+        if (RangeMinMax(values, begin, end, minIndex, maxIndex))
+        {
+            kept[keptCount++] = minIndex;
+            kept[keptCount++] = maxIndex;
+        }
+        kept[keptCount++] = end - 1;
+        std::sort(kept, kept + keptCount);
+        for (size_t k = 0; k < keptCount; ++k)
+        {
+            if (out.empty() || kept[k] > out.back())
+                out.push_back(kept[k]);
+        }
+        begin = end;
+    }
+}
@@ -0,0 +1,80 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// How line-type charts thin out series that are longer than they are wide.
+enum class SeriesDecimation
+{
+    None,   // draw every sample
+    MinMax, // first, last, min and max sample per pixel column (default)
+    Lttb    // largest-triangle-three-buckets, two points per pixel column
+};
+
+/*
+** Block min/max summary of a chart series that scrolls: samples drop off the
+** front and new ones are appended. Blocks are aligned to absolute sample
+** positions, so a scroll only recomputes the blocks at both ends and a
+** whole-series or per-column min/max costs O(count / kBlockSize) instead of
+** O(count). The summary does not own the samples; every call that needs them
+** takes the caller's current array.
+*/
+class SeriesSummary
+{
+public:
+    static const size_t kBlockSize = 64;
+
+    void Clear();
+
+    // Summarise 'values' from scratch.
+    void Assign(const float *values, size_t count);
+
+    // 'values' is the previous series with 'dropped' samples removed from the
+    // front and zero or more appended. Falls back to Assign() if that cannot
+    // be the case.
+    void Scroll(const float *values, size_t count, size_t dropped);
+
+    size_t Size() const { return m_Count; }
+
+    // Smallest and largest sample; NaNs are ignored. Returns false if there is
+    // no value.
+    bool MinMax(float &minValue, float &maxValue) const;
+
+    // Indices, ascending, of the samples to draw when sample i sits at axis
+    // position offset + i * spacing (in pixels, spacing > 0). Every pixel
+    // column keeps its first, last, smallest and largest sample, so the
+    // polyline covers the same pixels as the full one. Short series are
+    // returned whole.
+    void DecimateMinMax(const float *values, float offset, float spacing, std::vector<size_t> &out) const;
+
+private:
+    struct Block
+    {
+        float minValue = 0.0f;
+        float maxValue = 0.0f;
+        size_t minIndex = 0; // absolute sample positions
+        size_t maxIndex = 0;
+        bool hasValue = false;
+    };
+
+    Block &BlockAt(size_t absoluteBlock) { return m_Blocks[m_Skipped + absoluteBlock - m_FirstBlock]; }
+    const Block &BlockAt(size_t absoluteBlock) const { return m_Blocks[m_Skipped + absoluteBlock - m_FirstBlock]; }
+    void BuildBlock(const float *values, size_t absoluteBlock);
+    // Min/max sample indices in [begin, end) (relative); false if all NaN.
+    bool RangeMinMax(const float *values, size_t begin, size_t end, size_t &minIndex, size_t &maxIndex) const;
+
+    // m_Blocks[m_Skipped + k] is absolute block m_FirstBlock + k; the skipped
+    // front is compacted once it outgrows the live part.
+    std::vector<Block> m_Blocks;
+    size_t m_Skipped = 0;
+    size_t m_FirstBlock = 0;
+    size_t m_Origin = 0; // absolute position of values[0]
+    size_t m_Count = 0;
+};
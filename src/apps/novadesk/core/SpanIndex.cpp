@@ -0,0 +1,63 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "SpanIndex.h"
+
+#include <algorithm>
+
+void SpanIndex::Build(const std::vector<Span> &spans)
+{
+    const size_t count = spans.size();
+    m_Order.resize(count);
+    for (size_t i = 0; i < count; ++i)
+        m_Order[i] = static_cast<int>(i);
+
+    // Children of a list are usually already in scroll order; stable_sort
+    // keeps that cheap and leaves ties in paint order.
+    std::stable_sort(m_Order.begin(), m_Order.end(), [&spans](int a, int b)
+                     { return spans[a].start < spans[b].start; });
+
+    m_Starts.resize(count);
+    m_Ends.resize(count);
+    m_MaxEnds.resize(count);
+    int maxEnd = 0;
+    for (size_t k = 0; k < count; ++k)
+    {
+        const Span &span = spans[m_Order[k]];
+        m_Starts[k] = span.start;
+        m_Ends[k] = span.end;
+        maxEnd = (k == 0 || span.end > maxEnd) ? span.end : maxEnd;
+        m_MaxEnds[k] = maxEnd;
+    }
+}
+
+void SpanIndex::Clear()
+{
+    m_Order.clear();
+    m_Starts.clear();
+    m_Ends.clear();
+    m_MaxEnds.clear();
+}
+
+void SpanIndex::Query(int lo, int hi, std::vector<int> &out) const
+{
+    if (m_Order.empty() || hi <= lo)
+        return;
+
+    // Everything before 'first' ends at or before lo; everything from 'last'
+    // on starts at or after hi.
+    const size_t first = std::upper_bound(m_MaxEnds.begin(), m_MaxEnds.end(), lo) - m_MaxEnds.begin();
+    const size_t last = std::lower_bound(m_Starts.begin(), m_Starts.end(), hi) - m_Starts.begin();
+
+    const size_t mark = out.size();
+    for (size_t k = first; k < last; ++k)
+    {
+        if (m_Ends[k] > lo)
+            out.push_back(m_Order[k]);
+    }
+    std::sort(out.begin() + mark, out.end());
+}
@@ -0,0 +1,45 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/*
+** One-dimensional interval index used to find the container children that
+** overlap a viewport along the scroll axis. Spans are sorted by start with a
+** running maximum of their ends, so a query is two binary searches plus a
+** scan over the candidates; children whose span cannot reach the viewport are
+** never looked at.
+*/
+class SpanIndex
+{
+public:
+    // Half-open interval [start, end).
+    struct Span
+    {
+        int start = 0;
+        int end = 0;
+    };
+
+    void Build(const std::vector<Span> &spans);
+    void Clear();
+
+    bool IsEmpty() const { return m_Order.empty(); }
+    size_t Size() const { return m_Order.size(); }
+
+    // Append the indices (as passed to Build) of spans overlapping [lo, hi),
+    // in ascending order.
+    void Query(int lo, int hi, std::vector<int> &out) const;
+
+private:
+    std::vector<int> m_Order;
+    std::vector<int> m_Starts;
+    std::vector<int> m_Ends;
+    std::vector<int> m_MaxEnds;
+};
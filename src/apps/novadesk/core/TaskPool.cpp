@@ -0,0 +1,158 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "TaskPool.h"
+
+#include <algorithm>
+
+TaskPool::TaskPool(size_t threadCount)
+{
+    if (threadCount == 0)
+        threadCount = (std::min)((std::max)(static_cast<size_t>(std::thread::hardware_concurrency()), static_cast<size_t>(2)), static_cast<size_t>(8));
+    m_ThreadCount = threadCount;
+}
+
+TaskPool::~TaskPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stop = true;
+        m_Queue.clear();
+    }
+    m_WorkCv.notify_all();
+    for (std::thread &thread : m_Threads)
+    {
+        if (thread.joinable())
+            thread.join();
+    }
+}
+
+bool TaskPool::Submit(const void *owner, Task task)
+{
+    if (!task)
+        return false;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_Stop)
+            return false;
+        if (m_Threads.empty())
+        {
+            m_Running.assign(m_ThreadCount, nullptr);
+            for (size_t i = 0; i < m_ThreadCount; ++i)
+                m_Threads.emplace_back(&TaskPool::Run, this, i);
+        }
+        m_Queue.push_back(Item{owner, std::move(task)});
+    }
+    m_WorkCv.notify_one();
+    return true;
+}
+
+size_t TaskPool::Cancel(const void *owner)
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    const size_t before = m_Queue.size();
+    m_Queue.erase(std::remove_if(m_Queue.begin(), m_Queue.end(), [owner](const Item &item)
+                                 { return item.owner == owner; }),
+                  m_Queue.end());
+    const size_t dropped = before - m_Queue.size();
+
+    m_DoneCv.wait(lock, [this, owner]
+                  { return std::find(m_Running.begin(), m_Running.end(), owner) == m_Running.end(); });
+    return dropped;
+}
+
+void TaskPool::Run(size_t slot)
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    while (true)
+    {
+        m_WorkCv.wait(lock, [this]
+                      { return m_Stop || !m_Queue.empty(); });
+        if (m_Stop)
+            return;
+
+        Item item = std::move(m_Queue.front());
+        m_Queue.pop_front();
+        m_Running[slot] = item.owner;
+        lock.unlock();
+
+        item.task();
+        item.task = nullptr; // release captures before reporting done
+
+        lock.lock();
+        m_Running[slot] = nullptr;
+        m_DoneCv.notify_all();
+    }
+}
+
+bool MainQueue::Post(const void *owner, Task task)
+{
+    if (!task)
+        return false;
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Items.push_back(Item{owner, std::move(task)});
+    if (m_WakePending)
+        return false;
+    m_WakePending = true;
+    return true;
+}
+
+void MainQueue::WakeFailed()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_WakePending = false;
+}
+
+size_t MainQueue::Drain()
+{
+    // A task may run a nested message loop and drain again, so each call
+    // keeps its own batch; m_Draining lists them for Cancel().
+    std::vector<Item> batch;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        batch.swap(m_Items);
+        m_WakePending = false;
+    }
+    m_Draining.push_back(&batch);
+
+    size_t count = 0;
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+        if (!batch[i].task)
+            continue;
+        Task task = std::move(batch[i].task);
+        batch[i].task = nullptr;
+        task();
+        ++count;
+    }
+
+    m_Draining.pop_back();
+    return count;
+}
+
+size_t MainQueue::Cancel(const void *owner)
+{
+    size_t dropped = 0;
+    for (std::vector<Item> *batch : m_Draining)
+    {
+        for (Item &item : *batch)
+        {
+            if (item.owner == owner && item.task)
+            {
+                item.task = nullptr;
+                ++dropped;
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    const size_t before = m_Items.size();
+    m_Items.erase(std::remove_if(m_Items.begin(), m_Items.end(), [owner](const Item &item)
+                                 { return item.owner == owner; }),
+                  m_Items.end());
+    return dropped + before - m_Items.size();
+}
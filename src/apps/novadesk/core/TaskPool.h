@@ -0,0 +1,100 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+** Worker threads shared by all addons. Every task carries an owner tag (the
+** addon module) so an unloading addon can drop what it queued and wait for
+** what is still running. Threads are started on the first Submit().
+*/
+class TaskPool
+{
+public:
+    using Task = std::function<void()>;
+
+    // 0 picks the hardware thread count, clamped to [2, 8].
+    explicit TaskPool(size_t threadCount = 0);
+    ~TaskPool();
+
+    TaskPool(const TaskPool &) = delete;
+    TaskPool &operator=(const TaskPool &) = delete;
+
+    // Queue a task; false once the pool is shutting down.
+    bool Submit(const void *owner, Task task);
+
+    // Drop the owner's queued tasks and wait for its running ones. Returns
+    // the number dropped. Must not be called from one of the owner's tasks.
+    size_t Cancel(const void *owner);
+
+    size_t GetThreadCount() const { return m_ThreadCount; }
+
+private:
+    struct Item
+    {
+        const void *owner = nullptr;
+        Task task;
+    };
+
+    void Run(size_t slot);
+
+    size_t m_ThreadCount = 0;
+    std::mutex m_Mutex;
+    std::condition_variable m_WorkCv;
+    std::condition_variable m_DoneCv;
+    std::deque<Item> m_Queue;
+    std::vector<const void *> m_Running; // owner per busy thread
+    std::vector<std::thread> m_Threads;
+    bool m_Stop = false;
+};
+
+/*
+** Completions waiting for the main thread. Post() may be called from any
+** thread and reports when the main thread needs waking; Drain() on the main
+** thread then runs everything posted so far as one batch, in order. Tasks
+** posted while a batch runs wait for the next wake.
+*/
+class MainQueue
+{
+public:
+    using Task = std::function<void()>;
+
+    // Queue a task. True when no wake is pending yet: the caller must then
+    // arrange one Drain() on the main thread.
+    bool Post(const void *owner, Task task);
+
+    // The wake Post() asked for could not be arranged. Queued tasks wait and
+    // the next Post() asks again.
+    void WakeFailed();
+
+    // Run the queued batch on the main thread. Returns the number run.
+    size_t Drain();
+
+    // Drop the owner's queued tasks, including those left in a batch that is
+    // being drained. Main thread only. Returns the number dropped.
+    size_t Cancel(const void *owner);
+
+private:
+    struct Item
+    {
+        const void *owner = nullptr;
+        Task task;
+    };
+
+    std::mutex m_Mutex;
+    std::vector<Item> m_Items;
+    bool m_WakePending = false;
+    std::vector<std::vector<Item> *> m_Draining; // main thread only
+};
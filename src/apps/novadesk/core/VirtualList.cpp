@@ -0,0 +1,98 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "VirtualList.h"
+
+#include <algorithm>
+
+namespace VirtualList
+{
+    int ContentSize(int itemCount, int itemSize, int gap)
+    {
+        if (itemCount <= 0 || itemSize <= 0)
+            return 0;
+        return itemCount * itemSize + (itemCount - 1) * gap;
+    }
+
+    Range VisibleRange(int offset, int viewport, int itemCount, int itemSize, int gap, int overscan)
+    {
+        Range range;
+        const int stride = Stride(itemSize, gap);
+        if (itemCount <= 0 || itemSize <= 0 || stride <= 0 || viewport <= 0)
+            return range;
+
+        if (offset < 0)
+            offset = 0;
+
+        // An item at index i covers [i * stride, i * stride + itemSize).
+        int first = offset / stride;
+        if (offset - first * stride >= itemSize)
+            ++first;
+        const int end = offset + viewport;
+        int last = (end + stride - 1) / stride;
+
+        if (overscan > 0)
+        {
+            first -= overscan;
+            last += overscan;
+        }
+        range.first = std::max(0, std::min(first, itemCount));
+        range.last = std::max(range.first, std::min(last, itemCount));
+        return range;
+    }
+
+    void AssignSlots(const Range &range, std::vector<int> &slots, std::vector<SlotUpdate> &updates)
+    {
+        const int count = range.Count();
+        std::vector<bool> covered(count, false);
+        std::vector<int> parked;
+        std::vector<int> hideUpdate(slots.size(), -1);
+
+        for (size_t i = 0; i < slots.size(); ++i)
+        {
+            const int index = slots[i];
+            if (index >= range.first && index < range.last && !covered[index - range.first])
+            {
+                covered[index - range.first] = true;
+                continue;
+            }
+            if (index != -1)
+            {
+                slots[i] = -1;
+                hideUpdate[i] = static_cast<int>(updates.size());
+                updates.push_back({static_cast<int>(i), -1, false});
+            }
+            parked.push_back(static_cast<int>(i));
+        }
+
+        size_t nextParked = 0;
+        for (int n = 0; n < count; ++n)
+        {
+            if (covered[n])
+                continue;
+
+            const int index = range.first + n;
+            if (nextParked < parked.size())
+            {
+                const int slot = parked[nextParked++];
+                slots[slot] = index;
+
+                // A slot parked and reused in the same pass needs a single
+                // rebind, not a hide followed by a show.
+                if (hideUpdate[slot] >= 0)
+                    updates[hideUpdate[slot]].index = index;
+                else
+                    updates.push_back({slot, index, false});
+            }
+            else
+            {
+                slots.push_back(index);
+                updates.push_back({static_cast<int>(slots.size() - 1), index, true});
+            }
+        }
+    }
+}
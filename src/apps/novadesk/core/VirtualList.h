@@ -0,0 +1,49 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#pragma once
+
+#include <vector>
+
+/*
+** Windowing for fixed-size virtual lists: which item indices are on screen
+** for a scroll offset, and which pooled slots should show them. Slots keep
+** their item while it stays in range so scrolling only rebinds the rows that
+** actually entered the viewport.
+*/
+namespace VirtualList
+{
+    // Half-open item range [first, last).
+    struct Range
+    {
+        int first = 0;
+        int last = 0;
+
+        int Count() const { return last > first ? last - first : 0; }
+    };
+
+    struct SlotUpdate
+    {
+        int slot = 0;
+        int index = -1;       // -1: slot is parked (hide it)
+        bool created = false; // slot did not exist before this update
+    };
+
+    // Distance between the starts of consecutive items.
+    inline int Stride(int itemSize, int gap) { return itemSize + gap; }
+
+    int ContentSize(int itemCount, int itemSize, int gap);
+
+    // Items intersecting [offset, offset + viewport), widened by 'overscan'
+    // items on both sides and clamped to [0, itemCount).
+    Range VisibleRange(int offset, int viewport, int itemCount, int itemSize, int gap, int overscan);
+
+    // slots[i] is the item index shown by slot i, or -1 if parked. Items in
+    // 'range' without a slot take a parked slot (or a new one); slots whose
+    // item left the range are parked. Changed slots are appended to 'updates'.
+    void AssignSlots(const Range &range, std::vector<int> &slots, std::vector<SlotUpdate> &updates);
+}
@@ -0,0 +1,1263 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+/*
+** Correctness checks and microbenchmarks for novadesk_core.
+**
+**   novadesk_core_bench           run checks, then print ns/op per benchmark
+**   novadesk_core_bench --check   run checks only (used by ctest)
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AlphaMask.h"
+#include "AnimationEasing.h"
+#include "AnimationTrack.h"
+#include "FlexLayout.h"
+#include "HitGrid.h"
+#include "ParseUtils.h"
+#include "PerfCounters.h"
+#include "PixelKernels.h"
+#include "SeriesMath.h"
+#include "SeriesSummary.h"
+#include "SpanIndex.h"
+#include "TaskPool.h"
+#include "VirtualList.h"
+#include "../../shared/ColorUtil.h"
+
+namespace
+{
+    int s_Failures = 0;
+
+    void Check(bool condition, const char *what)
+    {
+        if (!condition)
+        {
+            ++s_Failures;
+            std::printf("FAIL: %s\n", what);
+        }
+    }
+
+    bool Near(float a, float b, float epsilon = 1e-4f)
+    {
+        return std::fabs(a - b) <= epsilon;
+    }
+
+    std::vector<FlexLayoutItem> MakeItems(int count, int width, int height)
+    {
+        std::vector<FlexLayoutItem> items(count);
+        for (FlexLayoutItem &item : items)
+        {
+            item.width = width;
+            item.height = height;
+        }
+        return items;
+    }
+
+    void CheckLayout()
+    {
+        FlexLayoutConfig config;
+        config.gap = 10;
+        config.justify = FlexJustify::Center;
+        config.align = FlexAlign::Center;
+        std::vector<FlexLayoutItem> items = MakeItems(2, 20, 10);
+        FlexLayout::Arrange(config, 100, 50, items);
+        Check(items[0].x == 25 && items[1].x == 55, "row/justify center main axis");
+        Check(items[0].y == 20 && items[1].y == 20, "row/align center cross axis");
+
+        config = FlexLayoutConfig();
+        config.flexDirection = FlexDirection::RowReverse;
+        config.paddingLeft = 5;
+        items = MakeItems(3, 10, 10);
+        FlexLayout::Arrange(config, 100, 20, items);
+        Check(items[2].x == 5 && items[1].x == 15 && items[0].x == 25, "rowReverse places last item first");
+
+        config = FlexLayoutConfig();
+        config.flexDirection = FlexDirection::Column;
+        config.align = FlexAlign::Stretch;
+        config.paddingLeft = 4;
+        config.paddingRight = 6;
+        items = MakeItems(2, 10, 15);
+        FlexLayout::Arrange(config, 60, 100, items);
+        Check(items[0].resized && items[0].width == 50, "column/stretch fills inner width");
+        Check(items[1].y == 15, "column advances by height");
+
+        config = FlexLayoutConfig();
+        config.flexDirection = FlexDirection::Column;
+        config.direction = FlexTextDirection::Rtl;
+        items = MakeItems(1, 10, 10);
+        FlexLayout::Arrange(config, 40, 40, items);
+        Check(items[0].x == 30, "column/rtl start aligns right");
+
+        config = FlexLayoutConfig();
+        config.justify = FlexJustify::SpaceBetween;
+        items = MakeItems(3, 10, 10);
+        FlexLayout::Arrange(config, 100, 10, items);
+        Check(items[0].x == 0 && items[1].x == 45 && items[2].x == 90, "spaceBetween pins the ends");
+
+        config.justify = FlexJustify::SpaceEvenly;
+        items = MakeItems(3, 10, 10);
+        FlexLayout::Arrange(config, 110, 10, items);
+        Check(items[0].x == 20 && items[1].x == 50 && items[2].x == 80, "spaceEvenly");
+
+        config.justify = FlexJustify::SpaceAround;
+        items = MakeItems(2, 10, 10);
+        FlexLayout::Arrange(config, 100, 10, items);
+        Check(items[0].x == 20 && items[1].x == 70, "spaceAround");
+
+        config = FlexLayoutConfig();
+        config.gap = 10;
+        items = MakeItems(3, 20, 10);
+        items[0].grow = 1.0f;
+        items[2].grow = 3.0f;
+        FlexLayout::Arrange(config, 120, 10, items);
+        Check(items[0].width == 30 && items[1].width == 20 && items[2].width == 50, "flexGrow shares free space by weight");
+        Check(items[2].x == 70 && items[2].resized && !items[1].resized, "flexGrow positions and resized flags");
+
+        items = MakeItems(2, 60, 10);
+        items[0].shrink = 1.0f;
+        items[1].shrink = 1.0f;
+        items[1].basis = 20;
+        FlexLayout::Arrange(config, 50, 10, items);
+        Check(items[0].width == 30 && items[1].width == 10 && items[1].x == 40, "flexShrink weights by basis");
+
+        items = MakeItems(2, 60, 10);
+        FlexLayout::Arrange(config, 50, 10, items);
+        Check(items[0].width == 60 && items[1].x == 70, "flexShrink defaults to 0 (overflow)");
+
+        config = FlexLayoutConfig();
+        config.wrap = FlexWrap::Wrap;
+        config.gap = 5;
+        items = MakeItems(5, 30, 10);
+        items[4].height = 20;
+        FlexLayout::Arrange(config, 100, 100, items);
+        Check(items[2].x == 70 && items[2].y == 0 && items[3].x == 0 && items[3].y == 15, "wrap breaks lines at the container edge");
+        Check(items[4].y == 15, "wrap keeps items on the same line together");
+
+        config.wrap = FlexWrap::WrapReverse;
+        items = MakeItems(4, 30, 10);
+        FlexLayout::Arrange(config, 100, 100, items);
+        Check(items[0].y == 90 && items[3].y == 75, "wrapReverse stacks lines from the cross end");
+
+        int width = 0;
+        int height = 0;
+        config.wrap = FlexWrap::Wrap;
+        FlexLayout::MeasureContent(config, 100, MakeItems(5, 30, 10), width, height);
+        Check(width == 100 && height == 25, "MeasureContent wraps when bounded");
+        FlexLayout::MeasureContent(config, -1, MakeItems(5, 30, 10), width, height);
+        Check(width == 170 && height == 10, "MeasureContent single line when unbounded");
+
+        FlexJustify justify = FlexJustify::Start;
+        FlexDirection direction = FlexDirection::Row;
+        Check(FlexLayout::ParseJustify(L"space-between", justify) && justify == FlexJustify::SpaceBetween, "parse space-between");
+        Check(FlexLayout::ParseDirection(L"columnReverse", direction) && direction == FlexDirection::ColumnReverse, "parse columnReverse");
+        Check(!FlexLayout::ParseDirection(L"diagonal", direction) && direction == FlexDirection::ColumnReverse, "unknown value leaves output alone");
+        Check(std::wstring(FlexLayout::ToString(FlexJustify::SpaceEvenly)) == L"spaceEvenly", "ToString round trip");
+    }
+
+    void CheckEasing()
+    {
+        Check(Near(AnimationEasing::Evaluate(0.5f, L"linear"), 0.5f), "linear midpoint");
+        Check(Near(AnimationEasing::Evaluate(0.5f, L"easeInQuad"), 0.25f), "easeInQuad midpoint (case-insensitive)");
+        Check(Near(AnimationEasing::Evaluate(1.0f, L"easeoutbounce"), 1.0f), "easeOutBounce end");
+        Check(Near(AnimationEasing::Evaluate(2.0f, L"easeincubic"), 1.0f), "t is clamped");
+        Check(Near(AnimationEasing::Evaluate(0.3f, L"unknown"), 0.3f), "unknown easing is linear");
+
+        AnimationKeyframe a, b;
+        a.offset = 0.0f;
+        a.values.hasX = true;
+        a.values.x = 0.0f;
+        b.offset = 1.0f;
+        b.values.hasX = true;
+        b.values.x = 100.0f;
+        b.values.hasY = true;
+        b.values.y = 40.0f;
+
+        AnimationTarget initial;
+        initial.hasY = true;
+        initial.y = 20.0f;
+
+        std::vector<float> offsets;
+        std::vector<std::wstring> easings;
+        std::vector<AnimationTarget> stops;
+        AnimationTrack::ResolveKeyframeStops(initial, {a, b}, offsets, easings, stops);
+        Check(stops.size() == 2 && stops[0].hasY && Near(stops[0].y, 20.0f), "keyframe stops carry initial state");
+
+        const AnimationTarget mid = AnimationTrack::SampleKeyframes(offsets, easings, stops, 0.5f, L"linear");
+        Check(Near(mid.x, 50.0f) && Near(mid.y, 30.0f), "keyframe linear midpoint");
+    }
+
+    void CheckColor()
+    {
+        COLORREF color = 0;
+        BYTE alpha = 0;
+        Check(ColorUtil::ParseRGBA(L"#ff8000", color, alpha) && color == RGB(255, 128, 0) && alpha == 255, "#RRGGBB");
+        Check(ColorUtil::ParseRGBA(L"#0f08", color, alpha) && color == RGB(0, 255, 0) && alpha == 136, "#RGBA");
+        Check(ColorUtil::ParseRGBA(L"rgba(10, 20, 30, 0.5)", color, alpha) && color == RGB(10, 20, 30) && alpha == 127, "rgba() fractional alpha");
+        Check(ColorUtil::ParseRGBA(L"rgba(10,20,30,200)", color, alpha) && alpha == 200, "rgba() byte alpha");
+        Check(ColorUtil::ParseRGBA(L"Red", color, alpha) && color == RGB(255, 0, 0), "named colour");
+        Check(ColorUtil::ParseRGBA(L"transparent", color, alpha) && alpha == 0, "transparent");
+        Check(!ColorUtil::ParseRGBA(L"#12345", color, alpha), "bad hex length rejected");
+        Check(ColorUtil::ToRGBAString(RGB(1, 2, 3), 255) == L"rgba(1,2,3,1.00)", "ToRGBAString");
+    }
+
+    void CheckOptionParsing()
+    {
+        const std::vector<std::wstring> parts = ParseUtils::SplitByComma(L"a, rgb(1,2,3) ,b");
+        Check(parts.size() == 3 && parts[1] == L"rgb(1,2,3)" && parts[2] == L"b", "SplitByComma keeps nested commas");
+
+        GradientInfo gradient;
+        Check(ParseUtils::ParseGradientString(L"linearGradient(90, #000000, rgba(255,255,255,1))", gradient), "linear gradient parses");
+        Check(gradient.type == GRADIENT_LINEAR && Near(gradient.angle, 90.0f) && gradient.stops.size() == 2, "linear gradient fields");
+        Check(Near(gradient.stops[1].position, 1.0f), "stop positions are distributed");
+
+        GradientInfo radial;
+        Check(ParseUtils::ParseGradientString(L"radialGradient(ellipse, red, blue, green)", radial) &&
+                  radial.type == GRADIENT_RADIAL && radial.shape == L"ellipse" && radial.stops.size() == 3,
+              "radial gradient parses");
+        Check(!ParseUtils::ParseGradientString(L"linearGradient(red)", radial), "single-stop gradient rejected");
+    }
+
+    void CheckViewport()
+    {
+        std::vector<SpanIndex::Span> spans = {{0, 10}, {40, 50}, {10, 20}, {0, 100}, {20, 30}};
+        SpanIndex index;
+        index.Build(spans);
+        std::vector<int> hits;
+        index.Query(15, 25, hits);
+        Check(hits == std::vector<int>({2, 3, 4}), "SpanIndex overlap query in index order");
+        hits.clear();
+        index.Query(30, 40, hits);
+        Check(hits == std::vector<int>({3}), "SpanIndex half-open edges");
+        hits.clear();
+        index.Query(200, 300, hits);
+        Check(hits.empty(), "SpanIndex query past the end");
+
+        VirtualList::Range range = VirtualList::VisibleRange(0, 100, 1000, 20, 5, 0);
+        Check(range.first == 0 && range.last == 4, "VisibleRange from top");
+        range = VirtualList::VisibleRange(45, 10, 1000, 20, 5, 0);
+        Check(range.first == 2 && range.last == 3, "VisibleRange skips an item that only touches via its gap");
+        range = VirtualList::VisibleRange(24990, 100, 1000, 20, 5, 2);
+        Check(range.first == 997 && range.last == 1000, "VisibleRange overscan clamps to item count");
+        Check(VirtualList::ContentSize(3, 20, 5) == 70, "ContentSize");
+
+        std::vector<int> slots;
+        std::vector<VirtualList::SlotUpdate> updates;
+        VirtualList::AssignSlots({0, 3}, slots, updates);
+        Check(slots == std::vector<int>({0, 1, 2}) && updates.size() == 3 && updates[0].created, "AssignSlots creates the pool");
+
+        updates.clear();
+        VirtualList::AssignSlots({1, 4}, slots, updates);
+        Check(slots == std::vector<int>({3, 1, 2}), "AssignSlots recycles the slot that scrolled out");
+        Check(updates.size() == 1 && updates[0].slot == 0 && updates[0].index == 3 && !updates[0].created, "AssignSlots rebinds once");
+
+        updates.clear();
+        VirtualList::AssignSlots({1, 3}, slots, updates);
+        Check(slots == std::vector<int>({-1, 1, 2}) && updates.size() == 1 && updates[0].index == -1, "AssignSlots parks unused slots");
+    }
+
+    void CheckHitGrid()
+    {
+        std::vector<HitGrid::Entry> entries(4);
+        entries[0].bounds = GfxRect(0, 0, 400, 300);    // background
+        entries[1].bounds = GfxRect(10, 10, 50, 20);
+        entries[2].unbounded = true;                    // rotated
+        entries[3].bounds = GfxRect(40, 20, 100, 100);
+
+        HitGrid grid;
+        grid.Build(400, 300, entries);
+        std::vector<int> hits;
+        grid.Query(45, 25, hits);
+        Check(hits == std::vector<int>({3, 2, 1, 0}), "HitGrid returns topmost first");
+        hits.clear();
+        grid.Query(200, 200, hits);
+        Check(hits == std::vector<int>({2, 0}), "HitGrid filters by bounds");
+        hits.clear();
+        grid.Query(60, 10, hits);
+        Check(hits == std::vector<int>({2, 0}), "HitGrid right edge is exclusive");
+        hits.clear();
+        grid.Query(-5, 15, hits);
+        Check(hits == std::vector<int>({2}), "HitGrid off-surface point");
+    }
+
+    // Values a histogram sees: a noisy load curve with a few spikes.
+    std::vector<float> MakeSeries(size_t count)
+    {
+        std::vector<float> values(count);
+        for (size_t i = 0; i < count; ++i)
+            values[i] = 50.0f + 40.0f * std::sin(0.05f * (float)i) + (float)((i * 7919) % 13) - (i % 97 == 0 ? 80.0f : 0.0f);
+        return values;
+    }
+
+    void CheckSeries()
+    {
+        const float nan = std::nanf("");
+        const std::vector<float> mixed = {3.0f, nan, -2.5f, 7.0f, 1.0f, nan, 6.5f};
+        float minV = 0.0f, maxV = 0.0f;
+        Check(SeriesMath::MinMax(mixed.data(), mixed.size(), minV, maxV) && minV == -2.5f && maxV == 7.0f, "MinMax ignores NaN");
+        const std::vector<float> nans = {nan, nan, nan, nan, nan};
+        Check(!SeriesMath::MinMax(nans.data(), nans.size(), minV, maxV) && minV == -2.5f, "MinMax of no values");
+
+        // Same arithmetic as HistogramElement's per-sample path.
+        const std::vector<float> series = MakeSeries(1003);
+        SeriesMath::MinMax(series.data(), series.size(), minV, maxV);
+        std::vector<int> pixels(series.size());
+        SeriesMath::ScaleToPixels(series.data(), series.size(), minV, maxV, 87.0f, pixels.data());
+        bool same = true;
+        for (size_t i = 0; i < series.size(); ++i)
+        {
+            float n = (series[i] - minV) / (maxV - minV);
+            n = n < 0.0f ? 0.0f : (n > 1.0f ? 1.0f : n);
+            same = same && pixels[i] == static_cast<int>(n * 87.0f);
+        }
+        Check(same, "ScaleToPixels matches scalar normalisation");
+
+        const std::vector<float> edge = {-10.0f, 150.0f, nan, 100.0f, 0.0f};
+        int edgePixels[5] = {};
+        SeriesMath::ScaleToPixels(edge.data(), edge.size(), 0.0f, 100.0f, 40.0f, edgePixels);
+        Check(edgePixels[0] == 0 && edgePixels[1] == 40 && edgePixels[2] == 0 && edgePixels[3] == 40, "ScaleToPixels clamps");
+        SeriesMath::ScaleToPixels(edge.data(), edge.size(), 5.0f, 5.0f, 40.0f, edgePixels);
+        Check(edgePixels[1] == 0, "ScaleToPixels empty range");
+
+        const int zeros[4] = {0, 0, 0, 0};
+        const int tops[4] = {2, 2, 5, 0};
+        std::vector<SeriesMath::Point> outline;
+        Check(SeriesMath::AppendBandOutline(zeros, tops, 4, outline) && outline.size() == 7, "band outline merges runs");
+        outline.clear();
+        Check(!SeriesMath::AppendBandOutline(tops, tops, 4, outline) && outline.empty(), "empty band");
+
+        // Shoelace area of the outline equals the summed bar lengths.
+        std::vector<int> lower(series.size()), upper(series.size());
+        SeriesMath::ScaleToPixels(series.data(), series.size(), minV, maxV, 30.0f, lower.data());
+        long long expected = 0;
+        for (size_t i = 0; i < series.size(); ++i)
+        {
+            upper[i] = (std::max)(lower[i], pixels[i]);
+            expected += upper[i] - lower[i];
+        }
+        outline.clear();
+        SeriesMath::AppendBandOutline(lower.data(), upper.data(), series.size(), outline);
+        long long twiceArea = 0;
+        for (size_t i = 0; i < outline.size(); ++i)
+        {
+            const SeriesMath::Point &a = outline[i];
+            const SeriesMath::Point &b = outline[(i + 1) % outline.size()];
+            twiceArea += (long long)a.u * b.v - (long long)b.u * a.v;
+        }
+        Check(std::llabs(twiceArea) == expected * 2, "band outline covers the bars exactly");
+    }
+
+    void CheckDecimation()
+    {
+        // Scroll a series through random drops and appends; the summary must
+        // track a brute-force min/max throughout.
+        std::vector<float> series = MakeSeries(5000);
+        series[17] = std::nanf("");
+        SeriesSummary summary;
+        summary.Assign(series.data(), series.size());
+        unsigned seed = 12345;
+        auto next = [&seed](unsigned range)
+        {
+            seed = seed * 1103515245u + 12345u;
+            return (seed >> 16) % range;
+        };
+        bool tracked = true;
+        for (int step = 0; step < 300; ++step)
+        {
+            const size_t dropped = (std::min)(static_cast<size_t>(next(70)), series.size());
+            series.erase(series.begin(), series.begin() + static_cast<std::ptrdiff_t>(dropped));
+            const unsigned appended = next(140);
+            for (unsigned i = 0; i < appended; ++i)
+                series.push_back(static_cast<float>(next(1000)) * 0.1f - 20.0f);
+            summary.Scroll(series.data(), series.size(), dropped);
+
+            float minV = 0.0f, maxV = 0.0f, bruteMin = 0.0f, bruteMax = 0.0f;
+            const bool has = summary.MinMax(minV, maxV);
+            const bool bruteHas = SeriesMath::MinMax(series.data(), series.size(), bruteMin, bruteMax);
+            tracked = tracked && summary.Size() == series.size() && has == bruteHas && (!has || (minV == bruteMin && maxV == bruteMax));
+        }
+        Check(tracked, "SeriesSummary tracks scrolling series");
+
+        size_t dropped = 0;
+        const std::vector<float> before = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+        const std::vector<float> after = {4, 5, 6, 7, 8, 9, 10, 11, 12};
+        Check(SeriesMath::FindScroll(before.data(), before.size(), after.data(), after.size(), 16, dropped) && dropped == 3, "FindScroll shift");
+        Check(SeriesMath::FindScroll(before.data(), before.size(), before.data(), before.size(), 16, dropped) && dropped == 0, "FindScroll unchanged");
+        Check(!SeriesMath::FindScroll(after.data(), after.size(), before.data(), before.size(), 16, dropped), "FindScroll unrelated");
+
+        // Per pixel column the decimated series keeps the first, last,
+        // smallest and largest sample.
+        const float offset = 3.25f;
+        const float spacing = 0.013f;
+        std::vector<size_t> kept;
+        summary.DecimateMinMax(series.data(), offset, spacing, kept);
+        bool ordered = !kept.empty() && kept.front() == 0 && kept.back() == series.size() - 1;
+        for (size_t i = 1; i < kept.size(); ++i)
+            ordered = ordered && kept[i] > kept[i - 1];
+        Check(ordered, "DecimateMinMax keeps ends, ascending");
+
+        bool columnsKept = true;
+        size_t columns = 0;
+        for (size_t begin = 0; begin < series.size();)
+        {
+            const double column = std::floor(offset + (double)begin * spacing);
+            size_t end = begin + 1;
+            while (end < series.size() && std::floor(offset + (double)end * spacing) == column)
+                ++end;
+            float minV = 0.0f, maxV = 0.0f;
+            bool hasMin = false, hasMax = false;
+            const bool has = SeriesMath::MinMax(series.data() + begin, end - begin, minV, maxV);
+            for (size_t index : kept)
+            {
+                if (index < begin || index >= end)
+                    continue;
+                hasMin = hasMin || series[index] == minV;
+                hasMax = hasMax || series[index] == maxV;
+            }
+            columnsKept = columnsKept && std::binary_search(kept.begin(), kept.end(), begin) &&
+                          std::binary_search(kept.begin(), kept.end(), end - 1) && (!has || (hasMin && hasMax));
+            ++columns;
+            begin = end;
+        }
+        Check(columnsKept && kept.size() <= columns * 4 && kept.size() < series.size(), "DecimateMinMax keeps column extremes");
+
+        summary.DecimateMinMax(series.data(), 0.0f, 1.0f, kept);
+        Check(kept.size() == series.size(), "DecimateMinMax leaves short series whole");
+
+        SeriesMath::DecimateLttb(series.data(), series.size(), 200, kept);
+        bool lttb = kept.size() == 200 && kept.front() == 0 && kept.back() == series.size() - 1;
+        for (size_t i = 1; i < kept.size(); ++i)
+            lttb = lttb && kept[i] > kept[i - 1];
+        Check(lttb, "DecimateLttb size and order");
+    }
+
+    volatile uint64_t s_Sink = 0;
+
+    // Headless model of the widget's layout tree: the same measure cache and
+    // dirty propagation WidgetLayoutHelper uses, over plain nodes.
+    struct TreeNode
+    {
+        FlexLayoutConfig config;
+        std::vector<int> children;
+        int parent = -1;
+        int depth = 0;
+        bool fixedSize = false;     // width/height declared: children cannot resize it
+        int width = 0;              // declared (leaf/fixed) or assigned size
+        int height = 0;
+        int x = 0;
+        int y = 0;
+        bool measured = false;
+        int measureWidth = 0;
+        int measureHeight = 0;
+        bool dirty = false;
+    };
+
+    struct LayoutTree
+    {
+        std::vector<TreeNode> nodes;
+        std::vector<int> dirty;
+        std::vector<FlexLayoutItem> items;
+
+        int Add(int parent, bool fixedSize, int width, int height)
+        {
+            TreeNode node;
+            node.parent = parent;
+            node.depth = parent < 0 ? 0 : nodes[parent].depth + 1;
+            node.fixedSize = fixedSize;
+            node.width = width;
+            node.height = height;
+            nodes.push_back(node);
+            const int id = static_cast<int>(nodes.size()) - 1;
+            if (parent >= 0)
+                nodes[parent].children.push_back(id);
+            return id;
+        }
+
+        void Measure(int id, int &width, int &height)
+        {
+            TreeNode &node = nodes[id];
+            if (!node.measured)
+            {
+                if (node.fixedSize || node.children.empty())
+                {
+                    node.measureWidth = node.width;
+                    node.measureHeight = node.height;
+                }
+                else
+                {
+                    std::vector<FlexLayoutItem> childItems(node.children.size());
+                    for (size_t i = 0; i < node.children.size(); ++i)
+                        Measure(node.children[i], childItems[i].width, childItems[i].height);
+                    FlexLayout::MeasureContent(node.config, -1, childItems, node.measureWidth, node.measureHeight);
+                }
+                node.measured = true;
+            }
+            width = node.measureWidth;
+            height = node.measureHeight;
+        }
+
+        void Arrange(int id)
+        {
+            TreeNode &node = nodes[id];
+            node.dirty = false;
+            if (node.children.empty())
+                return;
+
+            items.assign(node.children.size(), FlexLayoutItem());
+            for (size_t i = 0; i < node.children.size(); ++i)
+                Measure(node.children[i], items[i].width, items[i].height);
+            FlexLayout::Arrange(node.config, node.width, node.height, items);
+            for (size_t i = 0; i < node.children.size(); ++i)
+            {
+                TreeNode &child = nodes[node.children[i]];
+                child.x = items[i].x;
+                child.y = items[i].y;
+                const bool resized = items[i].width != child.width || items[i].height != child.height;
+                child.width = items[i].width;
+                child.height = items[i].height;
+                if (resized && !child.children.empty())
+                    MarkArrange(node.children[i]);
+            }
+        }
+
+        void MarkArrange(int id)
+        {
+            if (!nodes[id].dirty)
+            {
+                nodes[id].dirty = true;
+                dirty.push_back(id);
+            }
+        }
+
+        // A leaf changed size: drop cached measures up to the first container
+        // whose size does not depend on its children, and reflow from there.
+        void Invalidate(int id)
+        {
+            nodes[id].measured = false;
+            int cursor = nodes[id].parent;
+            while (cursor >= 0)
+            {
+                TreeNode &node = nodes[cursor];
+                node.measured = false;
+                MarkArrange(cursor);
+                if (node.fixedSize)
+                    break;
+                cursor = node.parent;
+            }
+        }
+
+        // Outermost first so nested containers arrange inside their final size.
+        void Flush()
+        {
+            while (!dirty.empty())
+            {
+                size_t best = 0;
+                for (size_t i = 1; i < dirty.size(); ++i)
+                {
+                    if (nodes[dirty[i]].depth < nodes[dirty[best]].depth)
+                        best = i;
+                }
+                const int id = dirty[best];
+                dirty[best] = dirty.back();
+                dirty.pop_back();
+                if (nodes[id].dirty)
+                    Arrange(id);
+            }
+        }
+
+        void FullReflow()
+        {
+            for (TreeNode &node : nodes)
+                node.measured = false;
+            for (size_t id = 0; id < nodes.size(); ++id)
+            {
+                if (!nodes[id].children.empty())
+                    MarkArrange(static_cast<int>(id));
+            }
+            Flush();
+        }
+    };
+
+    // Fixed 1000x4000 column of 100 auto-height wrapping rows, 99 leaves each (10,001 nodes).
+    void BuildTree(LayoutTree &tree, std::vector<int> &leaves)
+    {
+        const int root = tree.Add(-1, true, 1000, 4000);
+        tree.nodes[root].config.flexDirection = FlexDirection::Column;
+        tree.nodes[root].config.align = FlexAlign::Stretch;
+        tree.nodes[root].config.gap = 4;
+        for (int r = 0; r < 100; ++r)
+        {
+            const int row = tree.Add(root, false, 0, 0);
+            tree.nodes[row].config.wrap = FlexWrap::Wrap;
+            tree.nodes[row].config.justify = FlexJustify::SpaceBetween;
+            tree.nodes[row].config.gap = 2;
+            for (int c = 0; c < 99; ++c)
+                leaves.push_back(tree.Add(row, false, 8 + (c * 7) % 40, 10 + (c % 3) * 4));
+        }
+    }
+
+    void CheckLayoutTree()
+    {
+        LayoutTree incremental;
+        LayoutTree full;
+        std::vector<int> leaves;
+        std::vector<int> unused;
+        BuildTree(incremental, leaves);
+        BuildTree(full, unused);
+        incremental.FullReflow();
+
+        for (int step = 0; step < 50; ++step)
+        {
+            const int leaf = leaves[(step * 977) % leaves.size()];
+            incremental.nodes[leaf].width = full.nodes[leaf].width = 5 + (step * 13) % 60;
+            incremental.Invalidate(leaf);
+            incremental.Flush();
+        }
+        full.FullReflow();
+
+        bool same = true;
+        for (size_t i = 0; i < full.nodes.size(); ++i)
+        {
+            const TreeNode &a = incremental.nodes[i];
+            const TreeNode &b = full.nodes[i];
+            same = same && a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height;
+        }
+        Check(same, "incremental reflow matches a full reflow (10k nodes)");
+    }
+
+    std::vector<uint8_t> MakeIcon(int width, int height)
+    {
+        // Opaque disc on a transparent background, BGRA.
+        std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4, 0);
+        const int r = (std::min)(width, height) / 2;
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                const int dx = x - width / 2;
+                const int dy = y - height / 2;
+                if (dx * dx + dy * dy < r * r)
+                    pixels[(static_cast<size_t>(y) * width + x) * 4 + 3] = static_cast<uint8_t>(1 + (x + y) % 255);
+            }
+        }
+        return pixels;
+    }
+
+    void CheckAlphaMask()
+    {
+        const int w = 131;
+        const int h = 77;
+        std::vector<uint8_t> icon = MakeIcon(w, h);
+        AlphaMask mask;
+        mask.Build(icon.data(), w, h, w * 4);
+
+        bool same = mask.GetScale() == 1;
+        for (int y = 0; y < h; ++y)
+            for (int x = 0; x < w; ++x)
+                same = same && mask.Test(x, y) == (icon[(static_cast<size_t>(y) * w + x) * 4 + 3] != 0);
+        Check(same, "alpha mask matches per-pixel alpha");
+        Check(!mask.Test(-1, 0) && !mask.Test(w, 0) && !mask.Test(0, h), "alpha mask is clear outside the image");
+
+        // Large bitmaps downsample; a cell is set if any of its pixels is.
+        const int big = 4096;
+        std::vector<uint8_t> large(static_cast<size_t>(big) * big * 4, 0);
+        large[(static_cast<size_t>(1001) * big + 3001) * 4 + 3] = 10;
+        mask.Build(large.data(), big, big, big * 4);
+        Check(mask.GetScale() == 2 && mask.GetMemoryBytes() <= AlphaMask::kMaxCells / 8,
+              "large alpha mask downsamples to its cap");
+        Check(mask.Test(3001, 1001) && mask.Test(3000, 1000) && !mask.Test(3002, 1001),
+              "downsampled alpha mask keeps isolated opaque pixels");
+    }
+
+    std::vector<uint8_t> MakePixels(size_t count, unsigned seed)
+    {
+        // Mix of transparent, opaque and partial pixels in premultiplied form.
+        std::vector<uint8_t> pixels(count * 4);
+        for (size_t i = 0; i < count; ++i)
+        {
+            seed = seed * 1103515245u + 12345u;
+            const unsigned r = seed >> 8;
+            const uint8_t a = (r % 5 == 0) ? 0 : (r % 5 == 1) ? 255 : static_cast<uint8_t>(r >> 3);
+            for (int c = 0; c < 3; ++c)
+                pixels[i * 4 + c] = static_cast<uint8_t>(a ? ((r >> (c * 5)) % (a + 1u)) : 0);
+            pixels[i * 4 + 3] = a;
+        }
+        return pixels;
+    }
+
+    void CheckPixelKernels()
+    {
+        using PixelKernels::Level;
+        const Level supported = PixelKernels::GetSupportedLevel();
+        const size_t count = 1037; // not a multiple of any vector width
+        const std::vector<uint8_t> source = MakePixels(count, 7);
+        const float sepia[20] = {
+            0.393f, 0.349f, 0.272f, 0.0f,
+            0.769f, 0.686f, 0.534f, 0.0f,
+            0.189f, 0.168f, 0.131f, 0.0f,
+            0.0f, 0.0f, 0.0f, 0.8f,
+            0.05f, -0.02f, 0.0f, 0.1f};
+
+        // Scalar reference results.
+        PixelKernels::SetLevel(Level::Scalar);
+        std::vector<uint8_t> premul = source;
+        PixelKernels::Premultiply(premul.data(), count);
+        std::vector<uint8_t> unpremul = source;
+        PixelKernels::Unpremultiply(unpremul.data(), count);
+        std::vector<uint8_t> matrix = source;
+        PixelKernels::ApplyColorMatrix(matrix.data(), count, sepia);
+        std::vector<uint8_t> stamped = source;
+        PixelKernels::StampAlpha(stamped.data(), 61 * 4, 3, 2, 58, 15);
+        std::vector<uint32_t> scratch;
+        std::vector<uint8_t> blurred(source.begin(), source.begin() + 61 * 17 * 4);
+        PixelKernels::BoxBlur(blurred.data(), 61, 17, 61 * 4, 3, scratch);
+
+        bool exact = true;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const unsigned a = source[i * 4 + 3];
+            for (int c = 0; c < 3; ++c)
+                exact = exact && premul[i * 4 + c] == static_cast<uint8_t>((source[i * 4 + c] * a + 127) / 255);
+        }
+        Check(exact, "premultiply rounds to nearest");
+
+        bool stampOk = true;
+        for (int y = 0; y < 17; ++y)
+            for (int x = 0; x < 61; ++x)
+            {
+                const size_t i = (static_cast<size_t>(y) * 61 + x) * 4;
+                const bool inside = x >= 3 && x < 58 && y >= 2 && y < 15;
+                const uint8_t expected = (inside && source[i + 3] == 0) ? 1 : source[i + 3];
+                stampOk = stampOk && stamped[i + 3] == expected && std::memcmp(&stamped[i], &source[i], 3) == 0;
+            }
+        Check(stampOk, "alpha stamp lifts only transparent pixels inside the rect");
+
+        // Naive 2D box blur with clamped edges, rounding once per pass.
+        bool blurOk = true;
+        std::vector<uint8_t> rows(61 * 17 * 4);
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            const std::vector<uint8_t> &in = pass == 0 ? source : rows;
+            for (int y = 0; y < 17; ++y)
+                for (int x = 0; x < 61; ++x)
+                    for (int c = 0; c < 4; ++c)
+                    {
+                        unsigned sum = 0;
+                        for (int k = -3; k <= 3; ++k)
+                        {
+                            const int sx = pass == 0 ? (std::min)((std::max)(x + k, 0), 60) : x;
+                            const int sy = pass == 1 ? (std::min)((std::max)(y + k, 0), 16) : y;
+                            sum += in[(static_cast<size_t>(sy) * 61 + sx) * 4 + c];
+                        }
+                        const uint8_t mean = static_cast<uint8_t>(static_cast<int>(static_cast<float>(sum) * (1.0f / 7.0f) + 0.5f));
+                        if (pass == 0)
+                            rows[(static_cast<size_t>(y) * 61 + x) * 4 + c] = mean;
+                        else
+                            blurOk = blurOk && blurred[(static_cast<size_t>(y) * 61 + x) * 4 + c] == mean;
+                    }
+        }
+        Check(blurOk, "box blur matches a naive two-pass blur");
+
+        // Every SIMD level must reproduce the scalar output exactly.
+        for (int level = static_cast<int>(Level::Sse2); level <= static_cast<int>(supported); ++level)
+        {
+            PixelKernels::SetLevel(static_cast<Level>(level));
+            std::vector<uint8_t> work = source;
+            PixelKernels::Premultiply(work.data(), count);
+            bool same = work == premul;
+            work = source;
+            PixelKernels::Unpremultiply(work.data(), count);
+            same = same && work == unpremul;
+            work = source;
+            PixelKernels::ApplyColorMatrix(work.data(), count, sepia);
+            same = same && work == matrix;
+            work = source;
+            PixelKernels::StampAlpha(work.data(), 61 * 4, 3, 2, 58, 15);
+            same = same && work == stamped;
+            work.assign(source.begin(), source.begin() + 61 * 17 * 4);
+            PixelKernels::BoxBlur(work.data(), 61, 17, 61 * 4, 3, scratch);
+            same = same && work == blurred;
+
+            char what[96];
+            std::snprintf(what, sizeof(what), "%s pixel kernels match scalar", PixelKernels::GetLevelName(static_cast<Level>(level)));
+            Check(same, what);
+        }
+        PixelKernels::SetLevel(supported);
+    }
+
+    void CheckTaskPool()
+    {
+        int ownerA = 0, ownerB = 0;
+
+        // Every task runs once; Cancel waits for the owner's running tasks.
+        {
+            TaskPool pool(4);
+            std::atomic<int> ran{0};
+            std::atomic<bool> release{false};
+            std::atomic<int> blocked{0};
+            for (int i = 0; i < 2; ++i)
+            {
+                pool.Submit(&ownerA, [&]()
+                            {
+                                ++blocked;
+                                while (!release)
+                                    std::this_thread::yield();
+                                ++ran; });
+            }
+            for (int i = 0; i < 100; ++i)
+                pool.Submit(&ownerB, [&]() { ++ran; });
+            while (blocked < 2)
+                std::this_thread::yield();
+
+            std::thread releaser([&]()
+                                 {
+                                     std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                                     release = true; });
+            pool.Cancel(&ownerA);
+            Check(ran >= 2, "TaskPool::Cancel waits for the owner's running tasks");
+            releaser.join();
+            pool.Cancel(&ownerB);
+            Check(ran == 102, "TaskPool runs every task once");
+            Check(pool.GetThreadCount() == 4, "TaskPool keeps its thread count");
+        }
+
+        // Queued tasks of a cancelled owner are dropped, others still run.
+        {
+            TaskPool pool(1);
+            std::atomic<bool> release{false};
+            std::atomic<int> ranA{0}, ranB{0};
+            pool.Submit(&ownerB, [&]()
+                        {
+                            while (!release)
+                                std::this_thread::yield(); });
+            for (int i = 0; i < 10; ++i)
+            {
+                pool.Submit(&ownerA, [&]() { ++ranA; });
+                pool.Submit(&ownerB, [&]() { ++ranB; });
+            }
+            Check(pool.Cancel(&ownerA) == 10, "TaskPool::Cancel drops queued tasks");
+            release = true;
+            while (ranB < 10)
+                std::this_thread::yield();
+            Check(ranA == 0, "TaskPool::Cancel leaves other owners alone");
+        }
+
+        // MainQueue asks for one wake per batch and runs posts in order.
+        {
+            MainQueue queue;
+            std::vector<int> order;
+            int wakes = 0;
+            for (int i = 0; i < 5; ++i)
+                wakes += queue.Post(&ownerA, [&order, i]() { order.push_back(i); }) ? 1 : 0;
+            Check(wakes == 1, "MainQueue wakes once per batch");
+            Check(queue.Drain() == 5 && order == std::vector<int>({0, 1, 2, 3, 4}), "MainQueue drains in order");
+            Check(queue.Post(&ownerA, [&order]() { order.push_back(5); }), "MainQueue wakes again after a drain");
+
+            // A task cancelling an owner drops that owner's rest of the batch;
+            // tasks posted while draining wait for the next batch.
+            queue.Post(&ownerB, [&]()
+                       {
+                           queue.Cancel(&ownerA);
+                           queue.Post(&ownerB, [&order]() { order.push_back(7); }); });
+            queue.Post(&ownerA, [&order]() { order.push_back(6); });
+            Check(queue.Drain() == 2 && order.back() == 5, "MainQueue::Cancel reaches the running batch");
+            Check(queue.Drain() == 1 && order.back() == 7, "MainQueue defers posts made while draining");
+
+            // A failed wake is asked for again by the next post; nothing queued is lost.
+            Check(queue.Post(&ownerA, [&order]() { order.push_back(8); }), "MainQueue asks for a wake");
+            queue.WakeFailed();
+            Check(queue.Post(&ownerA, [&order]() { order.push_back(9); }), "MainQueue asks again after a failed wake");
+            Check(queue.Drain() == 2 && order.back() == 9, "MainQueue keeps tasks across a failed wake");
+        }
+
+        // Many producers, one consumer: nothing lost.
+        {
+            MainQueue queue;
+            std::atomic<int> wakes{0};
+            int ran = 0;
+            std::vector<std::thread> producers;
+            for (int t = 0; t < 4; ++t)
+            {
+                producers.emplace_back([&]()
+                                       {
+                                           for (int i = 0; i < 1000; ++i)
+                                               if (queue.Post(&ownerA, [&ran]() { ++ran; }))
+                                                   ++wakes; });
+            }
+            for (std::thread &p : producers)
+                p.join();
+            queue.Drain();
+            Check(ran == 4000, "MainQueue keeps every post from many threads");
+            Check(wakes >= 1 && wakes <= 4000, "MainQueue coalesces wakes");
+        }
+    }
+
+    void CheckPerfCounters()
+    {
+        using namespace PerfCounters;
+
+        // Bucket 0 is below 1 us, bucket i is [2^(i-1), 2^i), the last is open-ended.
+        Check(BucketForMicros(0) == 0, "BucketForMicros(0)");
+        Check(BucketForMicros(1) == 1 && BucketForMicros(2) == 2 && BucketForMicros(3) == 2, "BucketForMicros small values");
+        bool powersOk = true;
+        for (int k = 1; k < kHistogramBuckets - 1; ++k)
+        {
+            const uint64_t p = uint64_t(1) << k;
+            powersOk = powersOk && BucketForMicros(p) == k + 1 && BucketForMicros(p - 1) == k &&
+                       p - 1 < BucketUpperBoundMicros(BucketForMicros(p - 1));
+        }
+        Check(powersOk, "BucketForMicros 2^k edges");
+        Check(BucketForMicros(UINT64_MAX) == kHistogramBuckets - 1, "BucketForMicros huge value lands in the last bucket");
+        Check(BucketUpperBoundMicros(kHistogramBuckets - 1) == UINT64_MAX && BucketUpperBoundMicros(-1) == 0, "BucketUpperBoundMicros ends");
+
+        HistogramSnapshot empty;
+        Check(empty.PercentileMicros(50.0) == 0 && empty.MeanMicros() == 0.0, "empty histogram percentiles are 0");
+
+        Reset();
+        for (int i = 0; i < 99; ++i)
+            Record(Histogram::WidgetFrameTime, 5);
+        Record(Histogram::WidgetFrameTime, 1000);
+        HistogramSnapshot h = GetHistogram(Histogram::WidgetFrameTime);
+        Check(h.count == 100 && h.sumMicros == 99 * 5 + 1000 && h.maxMicros == 1000, "Record count, sum and max");
+        Check(h.PercentileMicros(50.0) == 8, "p50 is the upper bound of its bucket");
+        Check(h.PercentileMicros(0.0) == 8 && h.PercentileMicros(-5.0) == 8, "p0 is the first occupied bucket");
+        Check(h.PercentileMicros(100.0) == 1000 && h.PercentileMicros(250.0) == 1000, "p100 clamps to the max sample");
+        Record(Histogram::TimerCallbackTime, 5);
+        Check(GetHistogram(Histogram::TimerCallbackTime).PercentileMicros(99.0) == 5, "percentile clamps to max inside one bucket");
+
+        Increment(Counter::WidgetRedraws, 3);
+        Increment(static_cast<Counter>(-1));
+        Record(Histogram::Count, 1);
+        Check(GetCounter(Counter::WidgetRedraws) == 3 && GetCounter(Counter::Count) == 0, "Increment and out-of-range ids");
+        Reset();
+        h = GetHistogram(Histogram::WidgetFrameTime);
+        bool bucketsClear = true;
+        for (uint64_t bucket : h.buckets)
+            bucketsClear = bucketsClear && bucket == 0;
+        Check(GetCounter(Counter::WidgetRedraws) == 0 && h.count == 0 && h.sumMicros == 0 && h.maxMicros == 0 && bucketsClear,
+              "Reset clears counters and histograms");
+
+        // Concurrent writers lose nothing (also run under -fsanitize=thread).
+        {
+            constexpr int kThreads = 4;
+            constexpr int kPerThread = 20000;
+            std::vector<std::thread> writers;
+            for (int t = 0; t < kThreads; ++t)
+            {
+                writers.emplace_back([t]()
+                                     {
+                                         for (int i = 0; i < kPerThread; ++i)
+                                         {
+                                             Increment(Counter::IpcMessages);
+                                             Record(Histogram::IpcDispatchTime, static_cast<uint64_t>(t * kPerThread + i));
+                                         }
+                                     });
+            }
+            for (int i = 0; i < 100; ++i)
+            {
+                const HistogramSnapshot live = GetHistogram(Histogram::IpcDispatchTime);
+                (void)live;
+                (void)FormatJson();
+            }
+            for (std::thread &w : writers)
+                w.join();
+
+            h = GetHistogram(Histogram::IpcDispatchTime);
+            uint64_t bucketTotal = 0;
+            for (uint64_t bucket : h.buckets)
+                bucketTotal += bucket;
+            const uint64_t n = uint64_t(kThreads) * kPerThread;
+            Check(GetCounter(Counter::IpcMessages) == n, "concurrent Increment keeps every add");
+            Check(h.count == n && bucketTotal == n && h.sumMicros == n * (n - 1) / 2, "concurrent Record keeps every sample");
+            Check(h.maxMicros == n - 1, "concurrent Record keeps the max");
+        }
+        Reset();
+    }
+
+    void Bench(const char *name, int iterations, const std::function<void()> &body)
+    {
+        for (int i = 0; i < iterations / 10; ++i)
+            body();
+
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+            body();
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / iterations;
+        std::printf("%-36s %12.1f ns/op  (%d iterations)\n", name, ns, iterations);
+    }
+
+    void RunBenchmarks()
+    {
+        FlexLayoutConfig row;
+        row.gap = 4;
+        row.justify = FlexJustify::Center;
+        row.align = FlexAlign::Stretch;
+        std::vector<FlexLayoutItem> items = MakeItems(64, 20, 12);
+        Bench("FlexLayout::Arrange (64 items)", 200000, [&]()
+              {
+                  FlexLayout::Arrange(row, 2000, 40, items);
+                  s_Sink += items.back().x; });
+
+        Bench("AnimationEasing::Evaluate", 2000000, [&]()
+              { s_Sink += (uint64_t)(AnimationEasing::Evaluate(0.37f, L"easeInOutCubic") * 1000.0f); });
+
+        std::vector<float> offsets = {0.0f, 0.5f, 1.0f};
+        std::vector<std::wstring> easings = {L"", L"easeOutQuad", L"easeInQuad"};
+        std::vector<AnimationTarget> stops(3);
+        for (size_t i = 0; i < stops.size(); ++i)
+        {
+            stops[i].hasX = stops[i].hasFontColor = true;
+            stops[i].x = 10.0f * i;
+        }
+        Bench("AnimationTrack::SampleKeyframes", 2000000, [&]()
+              { s_Sink += (uint64_t)AnimationTrack::SampleKeyframes(offsets, easings, stops, 0.7f, L"linear").x; });
+
+        const wchar_t *colors[] = {L"#ff8000", L"rgba(10,20,30,0.5)", L"cornflowerblue", L"#0f08"};
+        int colorIndex = 0;
+        Bench("ColorUtil::ParseRGBA", 1000000, [&]()
+              {
+                  COLORREF color = 0;
+                  BYTE alpha = 0;
+                  ColorUtil::ParseRGBA(colors[colorIndex++ & 3], color, alpha);
+                  s_Sink += color + alpha; });
+
+        Bench("ParseUtils::ParseGradientString", 300000, [&]()
+              {
+                  GradientInfo gradient;
+                  ParseUtils::ParseGradientString(L"linearGradient(45, #000000, rgba(255,0,0,0.5), white)", gradient);
+                  s_Sink += gradient.stops.size(); });
+
+        LayoutTree tree;
+        std::vector<int> leaves;
+        BuildTree(tree, leaves);
+        Bench("Layout tree full reflow (10k nodes)", 200, [&]()
+              {
+                  tree.FullReflow();
+                  s_Sink += tree.nodes.back().y; });
+
+        size_t leafIndex = 0;
+        Bench("Layout tree dirty reflow (10k nodes)", 20000, [&]()
+              {
+                  const int leaf = leaves[leafIndex++ % leaves.size()];
+                  tree.nodes[leaf].width = 8 + static_cast<int>(leafIndex % 40);
+                  tree.Invalidate(leaf);
+                  tree.Flush();
+                  s_Sink += tree.nodes.back().y; });
+
+        // 10,000 rows of 32px with a 4px gap, viewport of 600px.
+        std::vector<SpanIndex::Span> rows(10000);
+        for (size_t i = 0; i < rows.size(); ++i)
+            rows[i] = {static_cast<int>(i) * 36, static_cast<int>(i) * 36 + 32};
+        SpanIndex rowIndex;
+        Bench("SpanIndex::Build (10k spans)", 200, [&]()
+              {
+                  rowIndex.Build(rows);
+                  s_Sink += rowIndex.Size(); });
+
+        std::vector<int> visible;
+        int scroll = 0;
+        Bench("SpanIndex::Query (10k spans)", 1000000, [&]()
+              {
+                  visible.clear();
+                  scroll = (scroll + 48) % 360000;
+                  rowIndex.Query(scroll, scroll + 600, visible);
+                  s_Sink += visible.size(); });
+
+        // 300 controls of 40x24 on a 20-column grid over a 1000x400 widget.
+        std::vector<HitGrid::Entry> controls(300);
+        for (size_t i = 0; i < controls.size(); ++i)
+            controls[i].bounds = GfxRect(static_cast<int>(i % 20) * 50, static_cast<int>(i / 20) * 26, 40, 24);
+        HitGrid hitGrid;
+        Bench("HitGrid::Build (300 elements)", 20000, [&]()
+              {
+                  hitGrid.Build(1000, 400, controls);
+                  s_Sink += hitGrid.Size(); });
+
+        std::vector<int> candidates;
+        int cursor = 0;
+        Bench("HitGrid::Query (300 elements)", 2000000, [&]()
+              {
+                  candidates.clear();
+                  cursor = (cursor + 7) % 400000;
+                  hitGrid.Query(cursor % 1000, cursor / 1000, candidates);
+                  s_Sink += candidates.size(); });
+
+        std::vector<int> slots;
+        std::vector<VirtualList::SlotUpdate> updates;
+        int offset = 0;
+        Bench("VirtualList scroll step (10k rows)", 1000000, [&]()
+              {
+                  updates.clear();
+                  offset = (offset + 48) % 360000;
+                  VirtualList::AssignSlots(VirtualList::VisibleRange(offset, 600, 10000, 32, 4, 2), slots, updates);
+                  s_Sink += updates.size(); });
+
+        // A 500-sample histogram: range, bar lengths and the band outline the
+        // element turns into a single path geometry.
+        const std::vector<float> series = MakeSeries(500);
+        std::vector<int> bars(series.size());
+        std::vector<int> baseline(series.size(), 0);
+        std::vector<SeriesMath::Point> outline;
+        Bench("Histogram series (500 samples)", 200000, [&]()
+              {
+                  float minV = 0.0f, maxV = 0.0f;
+                  SeriesMath::MinMax(series.data(), series.size(), minV, maxV);
+                  SeriesMath::ScaleToPixels(series.data(), series.size(), minV, maxV, 120.0f, bars.data());
+                  outline.clear();
+                  SeriesMath::AppendBandOutline(baseline.data(), bars.data(), bars.size(), outline);
+                  s_Sink += outline.size(); });
+
+        // 1M-point line graph, 500 px wide, scrolling one sample per tick.
+        const size_t points = 1000000;
+        const std::vector<float> feed = MakeSeries(points + 120000);
+        SeriesSummary pointSummary;
+        pointSummary.Assign(feed.data(), points);
+        size_t window = 0;
+        Bench("SeriesSummary::Scroll (1M, +1)", 100000, [&]()
+              {
+                  ++window;
+                  pointSummary.Scroll(feed.data() + window, points, 1);
+                  s_Sink += pointSummary.Size(); });
+
+        size_t scrolled = 0;
+        Bench("SeriesMath::FindScroll (1M samples)", 200, [&]()
+              {
+                  SeriesMath::FindScroll(feed.data(), points, feed.data() + 1, points, 64, scrolled);
+                  s_Sink += scrolled; });
+
+        std::vector<size_t> kept;
+        const float spacing = 499.0f / (float)(points - 1);
+        Bench("SeriesSummary::Decimate (1M, 500px)", 2000, [&]()
+              {
+                  pointSummary.DecimateMinMax(feed.data() + window, 0.0f, spacing, kept);
+                  s_Sink += kept.size(); });
+
+        Bench("SeriesMath::DecimateLttb (1M -> 1k)", 50, [&]()
+              {
+                  SeriesMath::DecimateLttb(feed.data(), points, 1000, kept);
+                  s_Sink += kept.size(); });
+
+        Bench("1M-sample scalar scan (old path)", 200, [&]()
+              {
+                  float minV = 0.0f, maxV = 0.0f;
+                  for (size_t i = 0; i < points; ++i)
+                  {
+                      minV = (std::min)(minV, feed[i]);
+                      maxV = (std::max)(maxV, feed[i]);
+                  }
+                  s_Sink += (uint64_t)(maxV - minV); });
+
+        const int iconSize = 256;
+        std::vector<uint8_t> icon = MakeIcon(iconSize, iconSize);
+        AlphaMask mask;
+        Bench("AlphaMask::Build (256x256)", 2000, [&]()
+              {
+                  mask.Build(icon.data(), iconSize, iconSize, iconSize * 4);
+                  s_Sink += mask.GetMemoryBytes(); });
+
+        int probe = 0;
+        Bench("AlphaMask::Test", 20000000, [&]()
+              {
+                  probe = (probe + 97) & 0xffff;
+                  s_Sink += mask.Test(probe & 255, probe >> 8); });
+
+        // A 3840x400 widget surface: the layered-window post-pass and the
+        // other BGRA kernels at each dispatch level.
+        const int surfaceW = 3840;
+        const int surfaceH = 400;
+        const size_t surfacePixels = static_cast<size_t>(surfaceW) * surfaceH;
+        std::vector<uint8_t> surface = MakePixels(surfacePixels, 11);
+        std::vector<uint32_t> blurScratch;
+        const float grayscale[20] = {
+            0.299f, 0.299f, 0.299f, 0.0f,
+            0.587f, 0.587f, 0.587f, 0.0f,
+            0.114f, 0.114f, 0.114f, 0.0f,
+            0.0f, 0.0f, 0.0f, 1.0f,
+            0.0f, 0.0f, 0.0f, 0.0f};
+        const PixelKernels::Level supported = PixelKernels::GetSupportedLevel();
+        for (int level = 0; level <= static_cast<int>(supported); ++level)
+        {
+            PixelKernels::SetLevel(static_cast<PixelKernels::Level>(level));
+            const std::string suffix = std::string(" [") + PixelKernels::GetLevelName(static_cast<PixelKernels::Level>(level)) + "]";
+            Bench(("StampAlpha 3840x400" + suffix).c_str(), 200, [&]()
+                  {
+                      PixelKernels::StampAlpha(surface.data(), surfaceW * 4, 0, 0, surfaceW, surfaceH);
+                      s_Sink += surface[3]; });
+            Bench(("Premultiply 3840x400" + suffix).c_str(), 200, [&]()
+                  {
+                      PixelKernels::Premultiply(surface.data(), surfacePixels);
+                      s_Sink += surface[0]; });
+            Bench(("ApplyColorMatrix 3840x400" + suffix).c_str(), 20, [&]()
+                  {
+                      PixelKernels::ApplyColorMatrix(surface.data(), surfacePixels, grayscale);
+                      s_Sink += surface[0]; });
+            Bench(("BoxBlur r=8 3840x400" + suffix).c_str(), 20, [&]()
+                  {
+                      PixelKernels::BoxBlur(surface.data(), surfaceW, surfaceH, surfaceW * 4, 8, blurScratch);
+                      s_Sink += surface[0]; });
+        }
+        PixelKernels::SetLevel(supported);
+
+        int owner = 0;
+        MainQueue mainQueue;
+        Bench("MainQueue Post+Drain (batch of 64)", 20000, [&]()
+              {
+                  for (int i = 0; i < 64; ++i)
+                      mainQueue.Post(&owner, [&]() { ++s_Sink; });
+                  mainQueue.Drain(); });
+
+        TaskPool pool;
+        Bench("TaskPool Submit -> MainQueue round trip", 20000, [&]()
+              {
+                  std::atomic<bool> done{false};
+                  pool.Submit(&owner, [&]()
+                              { mainQueue.Post(&owner, [&]() { done = true; }); });
+                  while (!done)
+                      mainQueue.Drain(); });
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const bool checkOnly = argc > 1 && std::strcmp(argv[1], "--check") == 0;
+
+    CheckLayout();
+    CheckLayoutTree();
+    CheckEasing();
+    CheckColor();
+    CheckOptionParsing();
+    CheckViewport();
+    CheckHitGrid();
+    CheckSeries();
+    CheckDecimation();
+    CheckAlphaMask();
+    CheckPixelKernels();
+    CheckTaskPool();
+    CheckPerfCounters();
+
+    if (s_Failures)
+    {
+        std::printf("%d check(s) failed\n", s_Failures);
+        return 1;
+    }
+    std::printf("All checks passed\n");
+
+    if (!checkOnly)
+        RunBenchmarks();
+    return 0;
+}
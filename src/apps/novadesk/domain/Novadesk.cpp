@@ -12,6 +12,7 @@
 #include "Settings.h"
 #include "Resource.h"
 #include <vector>
+#include <algorithm>
 #include <unordered_map>
 #include <shellapi.h>
 #include <fcntl.h>
@@ -23,6 +24,8 @@
 #include <commctrl.h>
 #include "Direct2DHelper.h"
 #include "FontManager.h"
+#include "PerfReport.h"
+#include "RenderBenchmark.h"
 #include "../shared/Logging.h"
 #include "../scripting/quickjs/engine/JSEngine.h"
 #include "../scripting/quickjs/modules/NovadeskModule.h"
@@ -284,6 +287,8 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
     std::wstring className = L"NovadeskTrayClass_" + appTitle;
     bool requestSingleInstanceLock = false;
     bool forceNewInstance = false;
+    std::wstring structuredLogPath;
+    RenderBenchmark::Options benchmarkOptions;
     {
         int argc = 0;
         LPWSTR *argv = CommandLineToArgvW(GetCommandLineW(), &argc);
@@ -300,10 +305,22 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
                 if (arg == L"--new-instance")
                 {
                     forceNewInstance = true;
+                    continue;
                 }
+                if (arg == L"--structured-log" && i + 1 < argc)
+                {
+                    structuredLogPath = argv[++i];
+                    continue;
+                }
+                RenderBenchmark::ParseArgument(argc, argv, i, benchmarkOptions);
             }
             LocalFree(argv);
         }
+        // A benchmark run is self-contained and never talks to a running instance.
+        if (benchmarkOptions.enabled)
+        {
+            forceNewInstance = true;
+        }
     }
 
     bool lockAlreadyHeld = false;
@@ -343,6 +360,7 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
             bool refreshAll = false;
             bool listScripts = false;
             std::wstring listScriptsFile;
+            std::wstring perfStatsFile;
             std::optional<bool> setHardwareAcceleration;
             std::optional<bool> setDebugging;
             std::optional<bool> setLogging;
@@ -367,12 +385,22 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
                 {
                     continue;
                 }
+                if (arg == L"--structured-log" && i + 1 < argc)
+                {
+                    ++i;
+                    continue;
+                }
                 if (arg == L"--list-scripts-file" && i + 1 < argc)
                 {
                     listScripts = true;
                     listScriptsFile = argv[++i];
                     continue;
                 }
+                if (arg == L"--perf-stats-file" && i + 1 < argc)
+                {
+                    perfStatsFile = argv[++i];
+                    continue;
+                }
                 if (arg == L"--refresh" && i + 1 < argc)
                 {
                     refreshPath = argv[++i];
@@ -480,6 +508,10 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
                         handledCommand = SendIpcCommand(hExisting, L"list", L"") || handledCommand;
                     }
                 }
+                if (!perfStatsFile.empty())
+                {
+                    handledCommand = SendIpcCommand(hExisting, L"perf-stats", perfStatsFile) || handledCommand;
+                }
                 if (!refreshPath.empty())
                 {
                     handledCommand = SendIpcCommand(hExisting, L"refresh", refreshPath) || handledCommand;
@@ -525,9 +557,15 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
             MessageBoxW(nullptr, message.c_str(), appTitle.c_str(), MB_OK | MB_ICONINFORMATION);
         }
 
+        Logging::Shutdown();
         return 0;
     }
 
+    if (!structuredLogPath.empty())
+    {
+        Logging::SetStructuredLogFile(structuredLogPath);
+    }
+
     Logging::Log(LogLevel::Info, L"Application starting...");
 
     // Initialize Common Controls
@@ -563,7 +601,14 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
         switch (message)
         {
         case WM_TIMER:
-            JSEngine::OnTimer(wParam);
+            if (wParam == PerfReport::kDumpTimerId)
+            {
+                PerfReport::OnDumpTimer();
+            }
+            else
+            {
+                JSEngine::OnTimer(wParam);
+            }
             break;
         case WM_TRAYICON:
         {
@@ -657,6 +702,10 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
                     }
                 }
             }
+            else if (command == L"perf-stats")
+            {
+                PerfReport::WriteToFile(path);
+            }
             else if (command == L"set-hardware-acceleration-on")
             {
                 Settings::SetGlobalBool("useHardwareAcceleration", true);
@@ -723,12 +772,14 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
     if (!hWnd)
     {
         Logging::Log(LogLevel::Error, L"Failed to create message window");
+        Logging::Shutdown();
         return FALSE;
     }
 
     // Initialize JS message routing; tray icon is lazy-initialized on first use.
     JSEngine::SetMessageWindow(hWnd);
     g_trayMessageWindow = hWnd;
+    PerfReport::SetDumpInterval(hWnd, static_cast<UINT>((std::max)(0, Settings::GetGlobalInt("perfStatsDumpIntervalMs", 0))));
 
     g_trayMouseHook = SetWindowsHookEx(WH_MOUSE_LL, TrayMouseHookProc, GetModuleHandle(nullptr), 0);
     if (!g_trayMouseHook)
@@ -758,7 +809,8 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
             for (int i = 1; i < argc; ++i)
             {
                 const std::wstring arg = argv[i];
-                if (arg == L"--refresh" || arg == L"--unload")
+                if (arg == L"--refresh" || arg == L"--unload" || arg == L"--structured-log" || arg == L"--perf-stats-file" ||
+                    RenderBenchmark::TakesValue(arg))
                 {
                     if (i + 1 < argc)
                         ++i;
@@ -865,19 +917,33 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
         Logging::Log(LogLevel::Info, L"Using custom scripts: %s", joined.c_str());
     }
 
+    if (benchmarkOptions.enabled)
+    {
+        Widget::SetHeadless(true);
+    }
+
     // Load and execute script (with optional custom path)
     if (!JSEngine::LoadAndExecuteScripts(ctx, scriptPaths))
     {
         Logging::Log(LogLevel::Error, L"Script execution failed. See QuickJS exception logs above.");
     }
 
-    MSG msg;
-
-    // Main message loop:
-    while (GetMessage(&msg, nullptr, 0, 0))
+    int exitCode = 0;
+    if (benchmarkOptions.enabled)
+    {
+        exitCode = RenderBenchmark::Run(benchmarkOptions);
+    }
+    else
     {
-        TranslateMessage(&msg);
-        DispatchMessage(&msg);
+        MSG msg;
+
+        // Main message loop:
+        while (GetMessage(&msg, nullptr, 0, 0))
+        {
+            TranslateMessage(&msg);
+            DispatchMessage(&msg);
+        }
+        exitCode = (int)msg.wParam;
     }
 
     // Cleanup
@@ -895,7 +961,10 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
 
     ReleaseSingleInstanceLock();
 
-    return (int)msg.wParam;
+    // Write out anything still queued before the process exits.
+    Logging::Shutdown();
+
+    return exitCode;
 }
 
 int APIENTRY WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR, int nCmdShow)
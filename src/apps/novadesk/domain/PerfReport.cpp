@@ -0,0 +1,149 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "PerfReport.h"
+
+#include <psapi.h>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "Widget.h"
+#include "../shared/Logging.h"
+#include "../shared/PathUtils.h"
+#include "../core/PerfCounters.h"
+#include "../shared/Utils.h"
+#include "../scripting/quickjs/engine/JSEngine.h"
+#include "../../../third_party/json/json.hpp"
+
+extern std::vector<Widget *> widgets; // Defined in Novadesk.cpp
+
+namespace PerfReport
+{
+    namespace
+    {
+        using json = nlohmann::json;
+
+        HWND s_DumpWindow = nullptr;
+        UINT s_DumpIntervalMs = 0;
+
+        json BuildProcessStats()
+        {
+            json process = json::object();
+            PROCESS_MEMORY_COUNTERS_EX pmc{};
+            pmc.cb = sizeof(pmc);
+            if (GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS *>(&pmc), sizeof(pmc)))
+            {
+                process["workingSetBytes"] = static_cast<uint64_t>(pmc.WorkingSetSize);
+                process["peakWorkingSetBytes"] = static_cast<uint64_t>(pmc.PeakWorkingSetSize);
+                process["privateBytes"] = static_cast<uint64_t>(pmc.PrivateUsage);
+            }
+            process["gdiObjects"] = GetGuiResources(GetCurrentProcess(), GR_GDIOBJECTS);
+            process["userObjects"] = GetGuiResources(GetCurrentProcess(), GR_USEROBJECTS);
+
+            const LogStats log = Logging::GetStats();
+            process["logEnqueued"] = log.enqueued;
+            process["logDropped"] = log.dropped;
+            return process;
+        }
+
+        json BuildWidgetStats()
+        {
+            json list = json::array();
+            for (Widget *widget : widgets)
+            {
+                if (!widget)
+                    continue;
+                const WidgetOptions &options = widget->GetOptions();
+                const PerfCounters::FrameStats &frames = widget->GetFrameStats();
+
+                json entry = json::object();
+                entry["id"] = Utils::ToString(options.id);
+                entry["script"] = Utils::ToString(options.scriptPath);
+                entry["width"] = options.width;
+                entry["height"] = options.height;
+                entry["elements"] = static_cast<uint64_t>(widget->GetElementCount());
+                entry["imageBytes"] = static_cast<uint64_t>(widget->GetImageMemoryBytes());
+                entry["renderCacheBytes"] = static_cast<uint64_t>(widget->GetRenderCacheBytes());
+                entry["frames"] = frames.frames;
+                entry["lastFrameUs"] = frames.lastMicros;
+                entry["meanFrameUs"] = frames.MeanMicros();
+                entry["maxFrameUs"] = frames.maxMicros;
+                list.push_back(std::move(entry));
+            }
+            return list;
+        }
+    }
+
+    std::string BuildJson()
+    {
+        json report = json::parse(PerfCounters::FormatJson());
+        report["process"] = BuildProcessStats();
+
+        const JSEngine::RuntimeStats runtime = JSEngine::GetRuntimeStats();
+        json js = json::object();
+        js["heapMallocBytes"] = runtime.mallocSize;
+        js["heapUsedBytes"] = runtime.memoryUsed;
+        js["objects"] = runtime.objectCount;
+        js["timers"] = static_cast<uint64_t>(runtime.timerCount);
+        js["scripts"] = static_cast<uint64_t>(runtime.scriptCount);
+        report["js"] = std::move(js);
+
+        report["widgets"] = BuildWidgetStats();
+        return report.dump();
+    }
+
+    bool WriteToFile(const std::wstring &path)
+    {
+        if (path.empty())
+            return false;
+
+        // Write then rename so pollers never read a half-written report.
+        const std::wstring tempPath = path + L".tmp";
+        {
+            std::ofstream out{std::filesystem::path(tempPath), std::ios::binary | std::ios::trunc};
+            if (!out.is_open())
+            {
+                Logging::Log(LogLevel::Warn, L"Failed to write perf stats: %s", path.c_str());
+                return false;
+            }
+            out << BuildJson();
+        }
+        if (!MoveFileExW(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING))
+        {
+            DeleteFileW(tempPath.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    std::wstring GetDefaultDumpPath()
+    {
+        return PathUtils::GetAppDataPath() + L"perf-stats.json";
+    }
+
+    void SetDumpInterval(HWND hWnd, UINT intervalMs)
+    {
+        if (s_DumpWindow && s_DumpIntervalMs)
+        {
+            KillTimer(s_DumpWindow, kDumpTimerId);
+        }
+
+        s_DumpWindow = hWnd;
+        s_DumpIntervalMs = intervalMs;
+        if (s_DumpWindow && s_DumpIntervalMs)
+        {
+            SetTimer(s_DumpWindow, kDumpTimerId, s_DumpIntervalMs, nullptr);
+            Logging::Log(LogLevel::Info, L"Writing perf stats to %s every %u ms", GetDefaultDumpPath().c_str(), s_DumpIntervalMs);
+        }
+    }
+
+    void OnDumpTimer()
+    {
+        WriteToFile(GetDefaultDumpPath());
+    }
+}
@@ -0,0 +1,32 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#pragma once
+
+#include <windows.h>
+#include <string>
+
+/*
+** Diagnostics snapshot combining the PerfCounters registry with process,
+** QuickJS runtime and per-widget statistics. Served to scripts through
+** app.getPerfStats(), to manage_novadesk through the "perf-stats" IPC
+** command, and optionally dumped to AppData on an interval.
+*/
+namespace PerfReport
+{
+    // Timer id used on the main message window; JS timers start at 50000.
+    constexpr UINT_PTR kDumpTimerId = 49000;
+
+    // Must be called on the UI thread (reads widgets and the JS runtime).
+    std::string BuildJson();
+    bool WriteToFile(const std::wstring &path);
+
+    std::wstring GetDefaultDumpPath();
+    // Periodically write BuildJson() to GetDefaultDumpPath(). 0 stops the dump.
+    void SetDumpInterval(HWND hWnd, UINT intervalMs);
+    void OnDumpTimer();
+}
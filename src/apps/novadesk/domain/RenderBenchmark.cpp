@@ -0,0 +1,357 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "RenderBenchmark.h"
+
+#include <windows.h>
+#include <wincodec.h>
+#include <wrl/client.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+
+#include "Widget.h"
+#include "../render/Direct2DHelper.h"
+#include "../render/RenderBackend.h"
+#include "../shared/Logging.h"
+#include "../shared/PathUtils.h"
+#include "../shared/Utils.h"
+#include "../../../third_party/json/json.hpp"
+
+extern std::vector<Widget *> widgets; // Defined in Novadesk.cpp
+
+using Microsoft::WRL::ComPtr;
+
+namespace RenderBenchmark
+{
+    namespace
+    {
+        using json = nlohmann::json;
+
+        struct ElementTotals
+        {
+            std::wstring id;
+            uint64_t totalMicros = 0;
+            uint64_t maxMicros = 0;
+            uint64_t samples = 0;
+        };
+
+        struct DiffResult
+        {
+            std::string status;
+            uint64_t diffPixels = 0;
+            int maxDelta = 0;
+        };
+
+        void PumpMessages(int durationMs)
+        {
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(durationMs);
+            MSG msg;
+            while (std::chrono::steady_clock::now() < deadline)
+            {
+                while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
+                {
+                    TranslateMessage(&msg);
+                    DispatchMessage(&msg);
+                }
+                MsgWaitForMultipleObjects(0, nullptr, FALSE, 10, QS_ALLINPUT);
+            }
+        }
+
+        std::wstring GoldenFileName(const std::wstring &widgetId)
+        {
+            std::wstring name = widgetId.empty() ? L"widget" : widgetId;
+            for (wchar_t &c : name)
+            {
+                if (!iswalnum(c) && c != L'-' && c != L'_')
+                    c = L'_';
+            }
+            return name + L".png";
+        }
+
+        bool LoadGolden(const std::wstring &path, int &width, int &height, std::vector<BYTE> &pixels)
+        {
+            IWICImagingFactory *factory = Direct2D::GetWICFactory();
+            if (!factory)
+                return false;
+
+            ComPtr<IWICBitmapDecoder> decoder;
+            ComPtr<IWICBitmapFrameDecode> frame;
+            ComPtr<IWICBitmapSource> converted;
+            HRESULT hr = factory->CreateDecoderFromFilename(path.c_str(), nullptr, GENERIC_READ,
+                                                            WICDecodeMetadataCacheOnDemand, decoder.GetAddressOf());
+            if (SUCCEEDED(hr))
+                hr = decoder->GetFrame(0, frame.GetAddressOf());
+            if (SUCCEEDED(hr))
+                hr = WICConvertBitmapSource(GUID_WICPixelFormat32bppPBGRA, frame.Get(), converted.GetAddressOf());
+
+            UINT w = 0, h = 0;
+            if (SUCCEEDED(hr))
+                hr = converted->GetSize(&w, &h);
+            if (FAILED(hr))
+                return false;
+
+            width = static_cast<int>(w);
+            height = static_cast<int>(h);
+            pixels.resize(static_cast<size_t>(w) * h * 4);
+            return SUCCEEDED(converted->CopyPixels(nullptr, w * 4, static_cast<UINT>(pixels.size()), pixels.data()));
+        }
+
+        DiffResult CompareWithGolden(WicBitmapBackend &backend, int width, int height,
+                                     const std::wstring &goldenPath, const Options &options)
+        {
+            DiffResult result;
+            if (options.updateGolden)
+            {
+                result.status = backend.SavePng(goldenPath) ? "updated" : "error";
+                return result;
+            }
+
+            int goldenW = 0, goldenH = 0;
+            std::vector<BYTE> golden;
+            if (!LoadGolden(goldenPath, goldenW, goldenH, golden))
+            {
+                // No reference yet (run with --update-golden to record one).
+                result.status = "missing";
+                return result;
+            }
+            if (goldenW != width || goldenH != height)
+            {
+                result.status = "size-mismatch";
+                return result;
+            }
+
+            int stride = 0;
+            const BYTE *pixels = backend.GetPixels(stride);
+            if (!pixels)
+            {
+                result.status = "error";
+                return result;
+            }
+
+            for (int y = 0; y < height; ++y)
+            {
+                const BYTE *row = pixels + static_cast<size_t>(y) * stride;
+                const BYTE *goldenRow = golden.data() + static_cast<size_t>(y) * width * 4;
+                for (int x = 0; x < width * 4; x += 4)
+                {
+                    int pixelDelta = 0;
+                    for (int c = 0; c < 4; ++c)
+                        pixelDelta = (std::max)(pixelDelta, std::abs(int(row[x + c]) - int(goldenRow[x + c])));
+                    result.maxDelta = (std::max)(result.maxDelta, pixelDelta);
+                    if (pixelDelta > options.tolerance)
+                        ++result.diffPixels;
+                }
+            }
+
+            result.status = result.diffPixels > static_cast<uint64_t>(options.maxDiffPixels) ? "mismatch" : "match";
+            if (result.status == "mismatch")
+            {
+                // Keep the failing frame next to the golden for inspection.
+                std::filesystem::path actual(goldenPath);
+                actual.replace_extension(L".actual.png");
+                backend.SavePng(actual.wstring());
+            }
+            return result;
+        }
+
+        json BenchmarkWidget(Widget *widget, const Options &options, bool &passed)
+        {
+            const WidgetOptions &widgetOptions = widget->GetOptions();
+            json entry = json::object();
+            entry["id"] = Utils::ToString(widgetOptions.id);
+            entry["script"] = Utils::ToString(widgetOptions.scriptPath);
+            entry["width"] = widgetOptions.width;
+            entry["height"] = widgetOptions.height;
+
+            WicBitmapBackend backend;
+            std::vector<uint64_t> frameTimes;
+            frameTimes.reserve(options.frames);
+            std::vector<ElementTotals> elements;
+            std::unordered_map<std::wstring, size_t> elementIndex;
+            std::vector<Widget::ElementRenderTime> timings;
+
+            // One untimed frame creates the target and any cached device resources.
+            if (!widget->RenderFrame(backend))
+            {
+                entry["error"] = "render failed";
+                passed = false;
+                return entry;
+            }
+
+            for (int frame = 0; frame < options.frames; ++frame)
+            {
+                timings.clear();
+                const auto start = std::chrono::steady_clock::now();
+                widget->RenderFrame(backend, &timings);
+                const auto elapsed = std::chrono::steady_clock::now() - start;
+                frameTimes.push_back((uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+
+                for (const auto &timing : timings)
+                {
+                    auto it = elementIndex.find(timing.id);
+                    if (it == elementIndex.end())
+                    {
+                        it = elementIndex.emplace(timing.id, elements.size()).first;
+                        elements.push_back({timing.id});
+                    }
+                    ElementTotals &totals = elements[it->second];
+                    totals.totalMicros += timing.micros;
+                    totals.maxMicros = (std::max)(totals.maxMicros, timing.micros);
+                    ++totals.samples;
+                }
+            }
+
+            std::vector<uint64_t> sorted = frameTimes;
+            std::sort(sorted.begin(), sorted.end());
+            auto percentile = [&](double p) -> uint64_t
+            {
+                if (sorted.empty())
+                    return 0;
+                size_t index = static_cast<size_t>(p / 100.0 * (sorted.size() - 1) + 0.5);
+                return sorted[(std::min)(index, sorted.size() - 1)];
+            };
+            uint64_t total = 0;
+            for (uint64_t t : frameTimes)
+                total += t;
+
+            entry["frames"] = static_cast<uint64_t>(frameTimes.size());
+            entry["meanFrameUs"] = frameTimes.empty() ? 0.0 : double(total) / frameTimes.size();
+            entry["p50FrameUs"] = percentile(50.0);
+            entry["p95FrameUs"] = percentile(95.0);
+            entry["maxFrameUs"] = sorted.empty() ? 0 : sorted.back();
+
+            json elementList = json::array();
+            for (const ElementTotals &totals : elements)
+            {
+                json element = json::object();
+                element["id"] = Utils::ToString(totals.id);
+                element["meanUs"] = totals.samples ? double(totals.totalMicros) / totals.samples : 0.0;
+                element["maxUs"] = totals.maxMicros;
+                elementList.push_back(std::move(element));
+            }
+            entry["elements"] = std::move(elementList);
+
+            if (!options.goldenDir.empty())
+            {
+                // Timed frames flush per element; compare a normal frame.
+                widget->RenderFrame(backend);
+                const std::wstring goldenPath = (std::filesystem::path(options.goldenDir) / GoldenFileName(widgetOptions.id)).wstring();
+                const DiffResult diff = CompareWithGolden(backend, widgetOptions.width, widgetOptions.height, goldenPath, options);
+
+                json golden = json::object();
+                golden["status"] = diff.status;
+                golden["diffPixels"] = diff.diffPixels;
+                golden["maxDelta"] = diff.maxDelta;
+                entry["golden"] = std::move(golden);
+
+                if (diff.status == "missing" && options.allowMissingGolden)
+                {
+                    Logging::Log(LogLevel::Warn, L"Benchmark: widget '%s' has no golden image, comparison skipped",
+                                 widgetOptions.id.c_str());
+                }
+                else if (diff.status != "match" && diff.status != "updated")
+                {
+                    passed = false;
+                    Logging::Log(LogLevel::Error, L"Benchmark: widget '%s' golden %S (%llu pixels, max delta %d)",
+                                 widgetOptions.id.c_str(), diff.status.c_str(), (unsigned long long)diff.diffPixels, diff.maxDelta);
+                }
+            }
+            return entry;
+        }
+    }
+
+    bool TakesValue(const std::wstring &arg)
+    {
+        return arg == L"--benchmark-frames" || arg == L"--benchmark-warmup" ||
+               arg == L"--benchmark-golden" || arg == L"--benchmark-tolerance" ||
+               arg == L"--benchmark-max-diff" || arg == L"--benchmark-report";
+    }
+
+    bool ParseArgument(int argc, wchar_t **argv, int &i, Options &options)
+    {
+        const std::wstring arg = argv[i];
+        if (arg == L"--benchmark")
+        {
+            options.enabled = true;
+            return true;
+        }
+        if (arg == L"--update-golden")
+        {
+            options.updateGolden = true;
+            return true;
+        }
+        if (arg == L"--benchmark-allow-missing")
+        {
+            options.allowMissingGolden = true;
+            return true;
+        }
+        if (!TakesValue(arg))
+            return false;
+        if (i + 1 >= argc)
+            return true;
+
+        const std::wstring value = argv[++i];
+        if (arg == L"--benchmark-frames")
+            options.frames = (std::max)(1, _wtoi(value.c_str()));
+        else if (arg == L"--benchmark-warmup")
+            options.warmupMs = (std::max)(0, _wtoi(value.c_str()));
+        else if (arg == L"--benchmark-golden")
+            options.goldenDir = value;
+        else if (arg == L"--benchmark-tolerance")
+            options.tolerance = (std::max)(0, _wtoi(value.c_str()));
+        else if (arg == L"--benchmark-max-diff")
+            options.maxDiffPixels = (std::max)(0, _wtoi(value.c_str()));
+        else if (arg == L"--benchmark-report")
+            options.reportPath = value;
+        return true;
+    }
+
+    int Run(const Options &options)
+    {
+        PumpMessages(options.warmupMs);
+
+        if (!options.goldenDir.empty() && options.updateGolden)
+        {
+            std::error_code ec;
+            std::filesystem::create_directories(options.goldenDir, ec);
+        }
+
+        bool passed = true;
+        json report = json::object();
+        report["frames"] = options.frames;
+        json list = json::array();
+        for (Widget *widget : std::vector<Widget *>(widgets))
+        {
+            if (widget)
+                list.push_back(BenchmarkWidget(widget, options, passed));
+        }
+        report["widgets"] = std::move(list);
+        report["passed"] = passed;
+
+        const std::wstring reportPath = options.reportPath.empty()
+                                            ? PathUtils::GetAppDataPath() + L"benchmark.json"
+                                            : options.reportPath;
+        std::ofstream out{std::filesystem::path(reportPath), std::ios::binary | std::ios::trunc};
+        if (out.is_open())
+        {
+            out << report.dump(2);
+        }
+        else
+        {
+            Logging::Log(LogLevel::Error, L"Benchmark: failed to write report %s", reportPath.c_str());
+            passed = false;
+        }
+
+        Logging::Log(LogLevel::Info, L"Benchmark finished: %d widget(s), report %s", (int)widgets.size(), reportPath.c_str());
+        return passed ? 0 : 1;
+    }
+}
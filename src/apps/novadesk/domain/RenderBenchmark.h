@@ -0,0 +1,43 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#pragma once
+
+#include <string>
+
+/*
+** Headless render benchmark, enabled with --benchmark.
+**
+** Widgets created by the loaded scripts are never shown. After a warm-up
+** period (timers, downloads and animations get to run) every widget is
+** rendered N times into an offscreen software backend, per-element render
+** times are collected, and the last frame is compared with a golden PNG.
+** A widget without one fails the run unless --benchmark-allow-missing.
+*/
+namespace RenderBenchmark
+{
+    struct Options
+    {
+        bool enabled = false;
+        int frames = 60;
+        int warmupMs = 500;
+        std::wstring goldenDir;  // Empty: no image comparison.
+        bool updateGolden = false;
+        bool allowMissingGolden = false; // A widget without a golden image passes.
+        int tolerance = 2;       // Max per-channel delta still treated as equal.
+        int maxDiffPixels = 0;   // Pixels over tolerance allowed before failing.
+        std::wstring reportPath; // Empty: AppData\benchmark.json
+    };
+
+    // Consumes a benchmark argument at argv[i] (advancing i past its value).
+    bool ParseArgument(int argc, wchar_t **argv, int &i, Options &options);
+    // True for arguments that carry a value, so other parsers can skip it.
+    bool TakesValue(const std::wstring &arg);
+
+    // Returns the process exit code: 0 when all golden images match.
+    int Run(const Options &options);
+}
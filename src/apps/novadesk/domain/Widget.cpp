@@ -12,10 +12,12 @@
 #include "Resource.h"
 #include "Utils.h"
 #include "../render/FlexLayoutEngine.h"
+#include "../core/PixelKernels.h"
 #include "WidgetLayoutHelper.h"
 #include <vector>
 #include <windowsx.h>
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <functional>
 #include "Direct2DHelper.h"
@@ -224,7 +226,7 @@ bool Widget::Create()
 */
 void Widget::Show()
 {
-    if (m_hWnd)
+    if (m_hWnd && !s_Headless)
     {
         ShowWindow(m_hWnd, SW_SHOWNOACTIVATE);
         UpdateWindow(m_hWnd);
@@ -730,7 +732,7 @@ LRESULT CALLBACK Widget::WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM
             }
 
             // Don't start widget drag if we're selecting text or an input box is focused
-            const bool isSelectingText = (widget->m_TextSelectionElement != nullptr);
+            const bool isSelectingText = (widget->GetTextSelectionElement() != nullptr);
             const bool inputBoxFocused = (widget->m_FocusedInputBox != nullptr);
 
             const bool ctrlHeld = (GetAsyncKeyState(VK_CONTROL) & 0x8000) != 0;
@@ -897,7 +899,7 @@ LRESULT CALLBACK Widget::WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM
         if (widget)
         {
             // Don't allow widget drag while selecting text or input box is focused
-            if (widget->m_IsDragging && (widget->m_TextSelectionElement != nullptr || widget->m_FocusedInputBox != nullptr))
+            if (widget->m_IsDragging && (widget->GetTextSelectionElement() != nullptr || widget->m_FocusedInputBox != nullptr))
             {
                 widget->m_IsDragging = false;
                 if (GetCapture() == hWnd)
@@ -1234,9 +1236,8 @@ LRESULT CALLBACK Widget::WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM
         break;
 
     case WM_KEYDOWN:
-        if (widget && widget->m_TextSelectionElement)
+        if (TextElement* textElem = widget ? widget->GetTextSelectionElement() : nullptr)
         {
-            TextElement* textElem = widget->m_TextSelectionElement;
             
             // Handle Ctrl+C (Copy)
             if (wParam == 'C' && (GetAsyncKeyState(VK_CONTROL) & 0x8000))
@@ -1262,7 +1263,7 @@ LRESULT CALLBACK Widget::WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM
             else if (wParam == VK_ESCAPE)
             {
                 textElem->ClearTextSelection();
-                widget->m_TextSelectionElement = nullptr;
+                widget->m_TextSelectionElement.Reset();
                 widget->Redraw();
                 return 0;
             }
@@ -1431,6 +1432,7 @@ void Widget::AddImage(const PropertyParser::ImageOptions &options)
         element->SetImageTint(options.imageTint, options.imageTintAlpha);
     }
 
+    element->SetOwnerWidget(this);
     m_Elements.push_back(element);
     UpdateContainerForElement(element, options.containerId);
 
@@ -1457,6 +1459,7 @@ void Widget::AddButton(const PropertyParser::ButtonOptions &options)
 
     PropertyParser::ApplyButtonOptions(element, options);
 
+    element->SetOwnerWidget(this);
     m_Elements.push_back(element);
     UpdateContainerForElement(element, options.containerId);
 
@@ -1483,6 +1486,7 @@ void Widget::AddBitmap(const PropertyParser::BitmapOptions &options)
 
     PropertyParser::ApplyBitmapOptions(element, options);
 
+    element->SetOwnerWidget(this);
     m_Elements.push_back(element);
     UpdateContainerForElement(element, options.containerId);
 
@@ -1510,6 +1514,7 @@ void Widget::AddRotator(const PropertyParser::RotatorOptions &options)
 
     PropertyParser::ApplyRotatorOptions(element, options);
 
+    element->SetOwnerWidget(this);
     m_Elements.push_back(element);
     UpdateContainerForElement(element, options.containerId);
 
@@ -1547,6 +1552,7 @@ void Widget::AddText(const PropertyParser::TextOptions &options)
 
     PropertyParser::ApplyTextOptions(element, options); // Changed from ApplyElementOptions
 
+    element->SetOwnerWidget(this);
     m_Elements.push_back(element);
     UpdateContainerForElement(element, options.containerId);
 
@@ -1573,6 +1579,7 @@ void Widget::AddBar(const PropertyParser::BarOptions &options)
 
     PropertyParser::ApplyBarOptions(element, options); // Changed from ApplyElementOptions
 
+    element->SetOwnerWidget(this);
     m_Elements.push_back(element);
     UpdateContainerForElement(element, options.containerId);
 
@@ -1598,6 +1605,7 @@ void Widget::AddLine(const PropertyParser::LineOptions &options)
     LineElement *element = new LineElement(options.id, options.x, options.y, options.width, options.height);
     PropertyParser::ApplyLineOptions(element, options);
 
+    element->SetOwnerWidget(this);
     m_Elements.push_back(element);
     UpdateContainerForElement(element, options.containerId);
 
@@ -1623,6 +1631,7 @@ void Widget::AddHistogram(const PropertyParser::HistogramOptions &options)
     HistogramElement *element = new HistogramElement(options.id, options.x, options.y, options.width, options.height);
     PropertyParser::ApplyHistogramOptions(element, options);
 
+    element->SetOwnerWidget(this);
     m_Elements.push_back(element);
     UpdateContainerForElement(element, options.containerId);
 
@@ -1649,6 +1658,7 @@ void Widget::AddRoundLine(const PropertyParser::RoundLineOptions &options)
 
     PropertyParser::ApplyRoundLineOptions(element, options);
 
+    element->SetOwnerWidget(this);
     m_Elements.push_back(element);
     UpdateContainerForElement(element, options.containerId);
 
@@ -1710,6 +1720,7 @@ void Widget::AddShape(const PropertyParser::ShapeOptions &options)
         BuildCombinedShapeGeometry(path, options);
     }
 
+    element->SetOwnerWidget(this);
     m_Elements.push_back(element);
     UpdateContainerForElement(element, options.containerId);
 
@@ -1735,6 +1746,7 @@ void Widget::AddAreaGraph(const PropertyParser::AreaGraphOptions &options)
     AreaGraphElement *element = new AreaGraphElement(options.id, options.x, options.y, options.width, options.height);
     PropertyParser::ApplyAreaGraphOptions(element, options);
 
+    element->SetOwnerWidget(this);
     m_Elements.push_back(element);
     UpdateContainerForElement(element, options.containerId);
 
@@ -1756,6 +1768,7 @@ void Widget::AddLayoutBox(const PropertyParser::ShapeOptions &options)
 
     ElementLayoutBox *element = new ElementLayoutBox(options.id, options.x, options.y, options.width, options.height);
     PropertyParser::ApplyShapeOptions(element, options);
+    element->SetOwnerWidget(this);
     m_Elements.push_back(element);
     UpdateContainerForElement(element, options.containerId);
     Redraw();
@@ -1783,6 +1796,7 @@ void Widget::AddInputBox(const PropertyParser::InputBoxOptions &options)
 
     PropertyParser::ApplyInputBoxOptions(element, options);
 
+    element->SetOwnerWidget(this);
     m_Elements.push_back(element);
     UpdateContainerForElement(element, options.containerId);
 
@@ -1921,6 +1935,7 @@ bool Widget::BuildCombinedShapeGeometry(PathShape *target, const PropertyParser:
     bool consumeBase = options.hasCombineConsumeAll ? options.combineConsumeAll : false;
     target->SetCombineData(options.combineBaseId, resolvedOps, consumeBase);
     target->SetCombinedGeometry(combinedGeometry, bounds);
+    target->InvalidateRender();
 
     if (consumeBase)
     {
@@ -1984,6 +1999,21 @@ bool Widget::TryGetLayoutConfig(const std::wstring &id, LayoutConfig &config) co
     return WidgetLayoutHelper::TryGetLayoutConfig(*this, id, config);
 }
 
+void Widget::SetVirtualList(const std::wstring &id, const WidgetVirtualListHelper::Config &config)
+{
+    WidgetVirtualListHelper::SetVirtualList(*this, id, config);
+}
+
+bool Widget::TryGetVirtualList(const std::wstring &id, WidgetVirtualListHelper::Config &config) const
+{
+    return WidgetVirtualListHelper::TryGetVirtualList(*this, id, config);
+}
+
+void Widget::UpdateVirtualList(const std::wstring &id)
+{
+    WidgetVirtualListHelper::Update(*this, id);
+}
+
 void Widget::StartElementAnimation(const std::wstring &id, const AnimationTarget &to, const AnimationTarget &from, int durationMs, const std::wstring &easing, int iterationCount)
 {
     WidgetAnimationHelper::StartElementAnimation(*this, id, to, from, durationMs, easing, iterationCount);
@@ -2004,6 +2034,16 @@ void Widget::ReflowLayout(const std::wstring &id)
     WidgetLayoutHelper::ReflowLayout(*this, id);
 }
 
+void Widget::MarkLayoutDirty(Element *element)
+{
+    WidgetLayoutHelper::MarkLayoutDirty(*this, element);
+}
+
+void Widget::FlushLayout()
+{
+    WidgetLayoutHelper::FlushLayout(*this);
+}
+
 void Widget::ApplyLayoutForContainer(Element *container)
 {
     WidgetLayoutHelper::ApplyLayoutForContainer(*this, container);
@@ -2014,9 +2054,9 @@ bool Widget::WouldCreateContainerCycle(Element *element, Element *container) con
     return WidgetLayoutHelper::WouldCreateContainerCycle(element, container);
 }
 
-void Widget::RenderContainerChildren(Element *container)
+void Widget::RenderElement(ID2D1DeviceContext *context, Element *element, bool renderSelf)
 {
-    WidgetLayoutHelper::RenderContainerChildren(*this, container);
+    WidgetLayoutHelper::RenderElement(*this, context, element, renderSelf);
 }
 
 bool Widget::HitTestContainerChildren(Element *container, int x, int y, Element *&outElement)
@@ -2102,43 +2142,12 @@ void Widget::ApplyParsedPropertiesToElement(Element *element, JSContext *ctx, JS
     {
         auto *layout = static_cast<ElementLayoutBox *>(element);
         PropertyParser::LayoutBoxOptions parsed;
-        LayoutConfig cfg{};
-        if (TryGetLayoutConfig(element->GetId(), cfg))
-        {
-            PropertyParser::PreFillLayoutBoxOptions(
-                parsed,
-                layout,
-                &cfg.direction,
-                &cfg.gap,
-                &cfg.align,
-                &cfg.justify,
-                &cfg.paddingLeft,
-                &cfg.paddingTop,
-                &cfg.paddingRight,
-                &cfg.paddingBottom,
-                &cfg.flexDirection);
-        }
-        else
-        {
-            PropertyParser::PreFillLayoutBoxOptions(parsed, layout);
-        }
+        PropertyParser::PreFillLayoutBoxOptions(parsed, layout);
         PropertyParser::ParseLayoutBoxOptions(ctx, options, parsed, baseDir);
         if (!parsed.hasBoxShadowError)
         {
             PropertyParser::ApplyLayoutBoxOptions(layout, parsed);
-            LayoutConfig nextCfg{};
-            nextCfg.direction = parsed.direction;
-            nextCfg.flexDirection = parsed.flexDirection;
-            nextCfg.gap = parsed.gap;
-            nextCfg.align = parsed.align.empty() ? L"start" : parsed.align;
-            nextCfg.justify = parsed.justify.empty() ? L"start" : parsed.justify;
-            nextCfg.paddingLeft = parsed.paddingLeft;
-            nextCfg.paddingTop = parsed.paddingTop;
-            nextCfg.paddingRight = parsed.paddingRight;
-            nextCfg.paddingBottom = parsed.paddingBottom;
-            // Logging::Log(LogLevel::Debug, L"[PADDING] SetLayoutConfig for '%s': L=%d, T=%d, R=%d, B=%d, flexDirection='%s'",
-            //     element->GetId().c_str(), nextCfg.paddingLeft, nextCfg.paddingTop, 
-            //     nextCfg.paddingRight, nextCfg.paddingBottom, nextCfg.flexDirection.c_str());
+            const LayoutConfig nextCfg = PropertyParser::GetLayoutBoxFlexConfig(parsed);
             SetLayoutConfig(element->GetId(), nextCfg);
             UpdateContainerForElement(element, parsed.shape.containerId);
         }
@@ -2202,6 +2211,7 @@ void Widget::SetElementProperties(const std::wstring &id, JSContext *ctx, JSValu
         return;
 
     ApplyParsedPropertiesToElement(element, ctx, options);
+    UpdateVirtualList(id);
 
     if (!m_IsBatchUpdating)
     {
@@ -2215,6 +2225,7 @@ void Widget::SetGroupProperties(const std::wstring &group, JSContext *ctx, JSVal
         return;
 
     bool changed = false;
+    std::vector<std::wstring> scrolledLists;
     for (Element *element : m_Elements)
     {
         if (!element)
@@ -2222,8 +2233,13 @@ void Widget::SetGroupProperties(const std::wstring &group, JSContext *ctx, JSVal
         if (element->GetGroupId() != group)
             continue;
         ApplyParsedPropertiesToElement(element, ctx, options);
+        if (m_VirtualLists.find(element->GetId()) != m_VirtualLists.end())
+            scrolledLists.push_back(element->GetId());
         changed = true;
     }
+    // Binding runs script that may add elements; do it after the walk.
+    for (const std::wstring &listId : scrolledLists)
+        UpdateVirtualList(listId);
 
     if (changed && !m_IsBatchUpdating)
     {
@@ -2242,8 +2258,8 @@ void Widget::RemoveElementsByGroup(const std::wstring &group)
         Element *element = *it;
         if (element && element->GetGroupId() == group)
         {
-            if (element == m_MouseOverElement)
-                m_MouseOverElement = nullptr;
+            if (m_MouseOverElement.Get() == element)
+                m_MouseOverElement.Reset();
             if (element == m_TooltipElement)
                 m_TooltipElement = nullptr;
             
@@ -2312,8 +2328,10 @@ bool Widget::RemoveElements(const std::wstring &id)
         }
         m_Elements.clear();
         m_LayoutConfigs.clear();
+        m_DirtyLayouts.clear();
+        m_VirtualLists.clear();
         WidgetAnimationHelper::ClearAllAnimations(*this);
-        m_MouseOverElement = nullptr;
+        m_MouseOverElement.Reset();
         m_TooltipElement = nullptr;
         Redraw();
         return true;
@@ -2325,8 +2343,8 @@ bool Widget::RemoveElements(const std::wstring &id)
         Element *element = *it;
         if (element && element->GetId() == id)
         {
-            if (element == m_MouseOverElement)
-                m_MouseOverElement = nullptr;
+            if (m_MouseOverElement.Get() == element)
+                m_MouseOverElement.Reset();
             if (element == m_TooltipElement)
                 m_TooltipElement = nullptr;
             
@@ -2350,6 +2368,7 @@ bool Widget::RemoveElements(const std::wstring &id)
             
             UpdateContainerForElement(element, L"");
             m_LayoutConfigs.erase(id);
+            m_VirtualLists.erase(id);
             WidgetAnimationHelper::RemoveAnimationsForElement(*this, id);
             delete element;
             it = m_Elements.erase(it);
@@ -2381,8 +2400,8 @@ void Widget::RemoveElements(const std::vector<std::wstring> &ids)
         {
             if ((*it)->GetId() == id)
             {
-                if (*it == m_MouseOverElement)
-                    m_MouseOverElement = nullptr;
+                if (m_MouseOverElement.Get() == *it)
+                    m_MouseOverElement.Reset();
                 if (*it == m_TooltipElement)
                     m_TooltipElement = nullptr;
                 if (PathShape *path = dynamic_cast<PathShape *>(*it))
@@ -2402,6 +2421,7 @@ void Widget::RemoveElements(const std::vector<std::wstring> &ids)
                 }
                 UpdateContainerForElement(*it, L"");
                 m_LayoutConfigs.erase(id);
+                m_VirtualLists.erase(id);
                 WidgetAnimationHelper::RemoveAnimationsForElement(*this, id);
                 delete *it;
                 m_Elements.erase(it);
@@ -2435,6 +2455,8 @@ void Widget::ClearContextMenu()
 */
 void Widget::Redraw()
 {
+    // Anything that needs a redraw may have moved, resized or removed elements.
+    m_HitGridDirty = true;
     if (m_IsBatchUpdating <= 0)
     {
         UpdateLayeredWindowContent();
@@ -2449,6 +2471,7 @@ void Widget::OnImageDownloaded(const std::wstring& url, const std::vector<BYTE>&
         if (element)
         {
             element->OnImageDownloaded(url, buffer);
+            element->InvalidateRender();
             updated = true;
         }
     }
@@ -2469,6 +2492,7 @@ void Widget::SetElementFontPath(const std::wstring& elementId, const std::wstrin
     if (textElem)
     {
         textElem->SetFontPath(fontDir);
+        textElem->InvalidateRender();
         Redraw();
         return;
     }
@@ -2484,24 +2508,85 @@ void Widget::SetElementFontPath(const std::wstring& elementId, const std::wstrin
 
 void Widget::ReleaseRenderSurface()
 {
-    if (m_hRenderMemDc && m_hRenderOldBitmap)
-    {
-        SelectObject(m_hRenderMemDc, m_hRenderOldBitmap);
-        m_hRenderOldBitmap = nullptr;
-    }
-    if (m_hRenderBitmap)
+    m_WindowBackend.ReleaseSurface();
+}
+
+bool Widget::s_Headless = false;
+
+/*
+** Headless mode keeps widgets off screen: windows are never shown and
+** Redraw() only updates layout. Frames are produced through RenderFrame().
+*/
+void Widget::SetHeadless(bool headless)
+{
+    s_Headless = headless;
+}
+
+/*
+** Draw the widget background and all elements into an open context.
+** When timings is set each top-level element is flushed and timed
+** separately, which is slower and meant for benchmarking only.
+*/
+void Widget::RenderContent(ID2D1DeviceContext *context, int w, int h, std::vector<ElementRenderTime> *timings)
+{
+    m_pContext = context;
+
+    // Draw Background
+    D2D1_RECT_F backRect = D2D1::RectF(0, 0, (float)w, (float)h);
+    Microsoft::WRL::ComPtr<ID2D1Brush> pBackBrush;
+    Direct2D::CreateBrushFromGradientOrColor(
+        context,
+        backRect,
+        &m_Options.bgGradient,
+        m_Options.color,
+        m_Options.bgAlpha / 255.0f,
+        pBackBrush.GetAddressOf());
+
+    if (pBackBrush)
     {
-        DeleteObject(m_hRenderBitmap);
-        m_hRenderBitmap = nullptr;
+        context->FillRectangle(backRect, pBackBrush.Get());
     }
-    if (m_hRenderMemDc)
+
+    if (timings)
+        context->Flush();
+
+    // Draw Elements
+    for (Element *element : m_Elements)
     {
-        DeleteDC(m_hRenderMemDc);
-        m_hRenderMemDc = nullptr;
+        if (!element->IsVisible())
+            continue;
+        if (element->IsContained())
+            continue;
+
+        const auto start = std::chrono::steady_clock::now();
+        // LayoutBox is both structural and visual; other top-level containers
+        // only clip their children.
+        RenderElement(context, element, !element->IsContainer() || element->GetType() == ELEMENT_LAYOUT_BOX);
+
+        if (timings)
+        {
+            context->Flush();
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            timings->push_back({element->GetId(), (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()});
+        }
     }
-    m_pRenderBitmapBits = nullptr;
-    m_RenderBitmapW = 0;
-    m_RenderBitmapH = 0;
+
+    m_pContext = nullptr;
+}
+
+/*
+** Draw one frame into an arbitrary backend at the widget's current size.
+*/
+bool Widget::RenderFrame(RenderBackend &backend, std::vector<ElementRenderTime> *timings)
+{
+    const int w = m_Options.width;
+    const int h = m_Options.height;
+    ID2D1DeviceContext *context = backend.BeginFrame(w, h);
+    if (!context)
+        return false;
+
+    RenderContent(context, w, h, timings);
+    return backend.EndFrame();
 }
 
 /*
@@ -2513,6 +2598,11 @@ void Widget::UpdateLayeredWindowContent()
     if (!m_hWnd)
         return;
 
+    PerfCounters::ScopedTimer frameTimer(PerfCounters::Histogram::WidgetFrameTime, PerfCounters::Counter::WidgetRedraws);
+
+    // Property changes only queue layout work; settle it before measuring.
+    FlushLayout();
+
     for (Element *element : m_Elements)
     {
         if (element)
@@ -2566,157 +2656,31 @@ void Widget::UpdateLayeredWindowContent()
         }
     }
 
+    if (s_Headless)
+        return;
+
     // Use current dimensions
     int w = m_Options.width;
     int h = m_Options.height;
     if (w <= 0 || h <= 0)
         return;
 
-    HDC hdcScreen = GetDC(NULL);
+    // Advance the caret blink phase for the focused input box.
+    if (m_FocusedInputBox)
+        m_FocusedInputBox->UpdateBlink();
 
-    if (!m_hRenderMemDc)
-    {
-        m_hRenderMemDc = CreateCompatibleDC(hdcScreen);
-        if (!m_hRenderMemDc)
-        {
-            ReleaseDC(NULL, hdcScreen);
-            return;
-        }
-    }
-
-    void *pvBits = m_pRenderBitmapBits;
-    if (w != m_RenderBitmapW || h != m_RenderBitmapH || !m_hRenderBitmap)
+    ID2D1DeviceContext *context = m_WindowBackend.BeginFrame(w, h);
+    HDC hdcMem = m_WindowBackend.GetMemoryDC();
+    if (!hdcMem)
+        return;
+    if (context)
     {
-        if (m_hRenderBitmap)
-        {
-            SelectObject(m_hRenderMemDc, m_hRenderOldBitmap);
-            DeleteObject(m_hRenderBitmap);
-            m_hRenderBitmap = nullptr;
-            m_hRenderOldBitmap = nullptr;
-            m_pRenderBitmapBits = nullptr;
-        }
-
-        BITMAPINFO bmi;
-        ZeroMemory(&bmi, sizeof(BITMAPINFO));
-        bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
-        bmi.bmiHeader.biWidth = w;
-        bmi.bmiHeader.biHeight = -h;
-        bmi.bmiHeader.biPlanes = 1;
-        bmi.bmiHeader.biBitCount = 32;
-        bmi.bmiHeader.biCompression = BI_RGB;
-
-        m_hRenderBitmap = CreateDIBSection(m_hRenderMemDc, &bmi, DIB_RGB_COLORS, &pvBits, NULL, 0);
-        if (!m_hRenderBitmap)
-        {
-            ReleaseDC(NULL, hdcScreen);
-            return;
-        }
-        m_hRenderOldBitmap = (HBITMAP)SelectObject(m_hRenderMemDc, m_hRenderBitmap);
-        m_pRenderBitmapBits = pvBits;
-        m_RenderBitmapW = w;
-        m_RenderBitmapH = h;
+        RenderContent(context, w, h, nullptr);
+        m_WindowBackend.EndFrame();
     }
 
-    HDC hdcMem = m_hRenderMemDc;
-
-    // Draw Direct2D
-    {
-        if (!m_pContext)
-        {
-            bool useHW = Settings::GetGlobalBool("useHardwareAcceleration", false);
-            D2D1_RENDER_TARGET_TYPE rtType = useHW ? D2D1_RENDER_TARGET_TYPE_DEFAULT : D2D1_RENDER_TARGET_TYPE_SOFTWARE;
-
-            // Logging::Log(LogLevel::Info, L"Creating Direct2D Context: Hardware Acceleration = %s", useHW ? L"ON" : L"OFF");
-
-            D2D1_RENDER_TARGET_PROPERTIES props = D2D1::RenderTargetProperties(
-                rtType,
-                D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED),
-                0, 0,
-                D2D1_RENDER_TARGET_USAGE_GDI_COMPATIBLE);
-
-            Microsoft::WRL::ComPtr<ID2D1DCRenderTarget> pDCRT;
-            HRESULT hr = Direct2D::GetFactory()->CreateDCRenderTarget(&props, pDCRT.GetAddressOf());
-            if (SUCCEEDED(hr))
-            {
-                hr = pDCRT.As<ID2D1DeviceContext>(&m_pContext);
-            }
-
-            if (FAILED(hr))
-            {
-                Logging::Log(LogLevel::Error, L"Failed to create D2D Context (0x%08X)", hr);
-            }
-        }
-
-        if (m_pContext)
-        {
-            Microsoft::WRL::ComPtr<ID2D1DCRenderTarget> pDCRT;
-            if (SUCCEEDED(m_pContext.As(&pDCRT)))
-            {
-                RECT renderRect = {0, 0, w, h};
-                HRESULT hr = pDCRT->BindDC(hdcMem, &renderRect);
-                if (FAILED(hr))
-                {
-                    Logging::Log(LogLevel::Error, L"BindDC failed (0x%08X)", hr);
-                }
-            }
-
-            m_pContext->BeginDraw();
-            m_pContext->Clear(D2D1::ColorF(0, 0, 0, 0));
-
-            // Draw Background
-            D2D1_RECT_F backRect = D2D1::RectF(0, 0, (float)w, (float)h);
-            Microsoft::WRL::ComPtr<ID2D1Brush> pBackBrush;
-            Direct2D::CreateBrushFromGradientOrColor(
-                m_pContext.Get(),
-                backRect,
-                &m_Options.bgGradient,
-                m_Options.color,
-                m_Options.bgAlpha / 255.0f,
-                pBackBrush.GetAddressOf());
-
-            if (pBackBrush)
-            {
-                m_pContext->FillRectangle(backRect, pBackBrush.Get());
-            }
-
-            // Advance the caret blink phase for the focused input box.
-            if (m_FocusedInputBox)
-                m_FocusedInputBox->UpdateBlink();
-
-            // Draw Elements
-            for (Element *element : m_Elements)
-            {
-                if (!element->IsVisible())
-                    continue;
-                if (element->IsContained())
-                    continue;
-                if (!element->IsContainer())
-                {
-                    element->Render(m_pContext.Get());
-                }
-                else if (element->GetType() == ELEMENT_LAYOUT_BOX)
-                {
-                    // LayoutBox is both structural and visual; render box chrome first.
-                    element->Render(m_pContext.Get());
-                }
-                if (element->IsContainer())
-                {
-                    RenderContainerChildren(element);
-                }
-            }
-
-            HRESULT hr = m_pContext->EndDraw();
-            if (hr == D2DERR_RECREATE_TARGET)
-            {
-                m_pContext.Reset();
-                Logging::Log(LogLevel::Error, L"D2D Device lost, resetting RenderContext");
-            }
-            else if (FAILED(hr))
-            {
-                Logging::Log(LogLevel::Error, L"D2D EndDraw failed (0x%08X)", hr);
-            }
-        }
-    }
+    int stride = 0;
+    void *pvBits = m_WindowBackend.GetPixels(stride);
 
     // Keep bounds-hit interactive element areas mouse-reachable even when their
     // pixels are fully transparent in the layered window surface.
@@ -2731,23 +2695,13 @@ void Widget::UpdateLayeredWindowContent()
             if (left >= right || top >= bottom)
                 return;
 
-            BYTE *pixels = static_cast<BYTE *>(pvBits);
-            for (int yy = top; yy < bottom; ++yy)
-            {
-                BYTE *row = pixels + static_cast<size_t>(yy) * static_cast<size_t>(w) * 4;
-                for (int xx = left; xx < right; ++xx)
-                {
-                    BYTE &alpha = row[static_cast<size_t>(xx) * 4 + 3];
-                    if (alpha == 0)
-                    {
-                        alpha = 1;
-                    }
-                }
-            }
+            PixelKernels::StampAlpha(static_cast<uint8_t *>(pvBits), stride, left, top, right, bottom);
         };
 
-        std::function<void(Element *, int, int)> stampInteractiveBounds;
-        stampInteractiveBounds = [&](Element *element, int offsetX, int offsetY)
+        // Children are clipped to their container, so only the part of a
+        // child inside the container's viewport is stamped.
+        std::function<void(Element *, int, int, const RECT &)> stampInteractiveBounds;
+        stampInteractiveBounds = [&](Element *element, int offsetX, int offsetY, const RECT &clip)
         {
             if (!element || !element->IsVisible())
                 return;
@@ -2760,23 +2714,31 @@ void Widget::UpdateLayeredWindowContent()
 
             if (element->HasMouseAction() && !element->GetPixelHitTest())
             {
-                stampRectAlpha(absLeft, absTop, absRight, absBottom);
+                stampRectAlpha(
+                    (std::max)(absLeft, (int)clip.left), (std::max)(absTop, (int)clip.top),
+                    (std::min)(absRight, (int)clip.right), (std::min)(absBottom, (int)clip.bottom));
             }
 
             if (element->IsContainer())
             {
-                for (Element *child : element->GetContainerItems())
+                const RECT childClip = {
+                    (std::max)(absLeft, (int)clip.left), (std::max)(absTop, (int)clip.top),
+                    (std::min)(absRight, (int)clip.right), (std::min)(absBottom, (int)clip.bottom)};
+                std::vector<Element *> visible;
+                WidgetLayoutHelper::CollectViewportChildren(element, visible);
+                for (Element *child : visible)
                 {
-                    stampInteractiveBounds(child, absLeft, absTop);
+                    stampInteractiveBounds(child, absLeft - element->GetScrollX(), absTop - element->GetScrollY(), childClip);
                 }
             }
         };
 
+        const RECT surface = {0, 0, w, h};
         for (Element *element : m_Elements)
         {
             if (!element || element->IsContained())
                 continue;
-            stampInteractiveBounds(element, 0, 0);
+            stampInteractiveBounds(element, 0, 0, surface);
         }
     }
 
@@ -2796,6 +2758,7 @@ void Widget::UpdateLayeredWindowContent()
     bf.SourceConstantAlpha = m_Options.windowOpacity; // Master opacity
     bf.AlphaFormat = AC_SRC_ALPHA;                    // Pre-multiplied alpha
 
+    HDC hdcScreen = GetDC(NULL);
     BOOL success = UpdateLayeredWindow(m_hWnd, hdcScreen, &pptDst, &size, hdcMem, &pptSrc, 0, &bf, ULW_ALPHA);
     if (!success)
     {
@@ -2805,6 +2768,35 @@ void Widget::UpdateLayeredWindowContent()
     }
 
     ReleaseDC(NULL, hdcScreen);
+    m_FrameStats.Record(frameTimer.ElapsedMicros());
+}
+
+/*
+** Approximate memory held by decoded images of this widget's elements.
+*/
+size_t Widget::GetImageMemoryBytes() const
+{
+    size_t total = 0;
+    for (const Element *element : m_Elements)
+    {
+        if (element)
+            total += element->GetImageMemoryBytes();
+    }
+    return total;
+}
+
+/*
+** Memory held by cacheAsBitmap bitmaps of this widget's elements.
+*/
+size_t Widget::GetRenderCacheBytes() const
+{
+    size_t total = 0;
+    for (const Element *element : m_Elements)
+    {
+        if (element)
+            total += element->GetRenderCacheBytes();
+    }
+    return total;
 }
 
 /*
@@ -2832,36 +2824,9 @@ bool Widget::HandleMouseMessage(UINT message, WPARAM wParam, LPARAM lParam)
     int y = GET_Y_LPARAM(lParam);
     bool justEnteredWidget = false;
 
-    std::function<bool(Element *)> isTrackedElement = [&](Element *el) -> bool
+    if (!m_DragElement.Get())
     {
-        if (!el)
-            return false;
-        
-        // Search in top-level elements
-        for (Element* root : m_Elements) {
-            if (root == el) return true;
-            
-            // If it's a container, search recursively
-            if (root && root->IsContainer()) {
-                const auto& items = root->GetContainerItems();
-                std::function<bool(const std::vector<Element*>&)> searchInItems = [&](const std::vector<Element*>& subItems) -> bool {
-                    for (Element* item : subItems) {
-                        if (item == el) return true;
-                        if (item && item->IsContainer()) {
-                            if (searchInItems(item->GetContainerItems())) return true;
-                        }
-                    }
-                    return false;
-                };
-                if (searchInItems(items)) return true;
-            }
-        }
-        return false;
-    };
-
-    if (!isTrackedElement(m_DragElement))
-    {
-        m_DragElement = nullptr;
+        m_DragElement.Reset();
         m_IsElementDragging = false;
     }
 
@@ -3031,15 +2996,13 @@ bool Widget::HandleMouseMessage(UINT message, WPARAM wParam, LPARAM lParam)
     Element *mouseActionElement = nullptr;
     Element *toolTipElement = nullptr;
 
-    for (auto it = m_Elements.rbegin(); it != m_Elements.rend(); ++it)
+    // Only top-level elements whose bounds contain the cursor, front to back.
+    std::vector<Element *> candidates;
+    WidgetLayoutHelper::CollectHitCandidates(*this, x, y, candidates);
+    for (Element *el : candidates)
     {
-        Element *el = *it;
-        if (!el)
-            continue;
         if (!el->IsVisible())
             continue;
-        if (el->IsContained())
-            continue;
 
         if (el->IsContainer())
         {
@@ -3076,6 +3039,13 @@ bool Widget::HandleMouseMessage(UINT message, WPARAM wParam, LPARAM lParam)
             break;
     }
 
+    // Script callbacks below may delete any of these; re-resolve through
+    // handles after each one instead of searching the element tree.
+    const ElementHandle hitHandle(hitElement);
+    const ElementHandle actionHandle(actionElement);
+    const ElementHandle mouseActionHandle(mouseActionElement);
+    const ElementHandle toolTipHandle(toolTipElement);
+
     // Handle Hover/Leave logic.
     // Prefer the element that can handle hover callbacks; this avoids
     // non-interactive overlays (for example text labels) stealing hover
@@ -3083,40 +3053,44 @@ bool Widget::HandleMouseMessage(UINT message, WPARAM wParam, LPARAM lParam)
     if (message == WM_MOUSEMOVE)
     {
         Element *hoverElement = actionElement ? actionElement : (mouseActionElement ? mouseActionElement : hitElement);
-        if (m_MouseOverElement && m_MouseOverElement->IsVisible() && m_MouseOverElement->HasMouseAction() && m_MouseOverElement->HitTest(x, y))
+        Element *previousHover = m_MouseOverElement.Get(this);
+        if (previousHover && previousHover->IsVisible() && previousHover->HasMouseAction() && previousHover->HitTest(x, y))
         {
-            hoverElement = m_MouseOverElement;
+            hoverElement = previousHover;
         }
-        Element *nextToolTipElement = toolTipElement ? toolTipElement : hoverElement;
+        const ElementHandle nextToolTipHandle(toolTipElement ? toolTipElement : hoverElement);
 
-        if (hoverElement != m_MouseOverElement)
+        if (hoverElement != previousHover)
         {
-            if (m_MouseOverElement && isTrackedElement(m_MouseOverElement))
+            if (previousHover)
             {
-                m_MouseOverElement->m_IsMouseOver = false;
-                int leaveId = m_MouseOverElement->m_OnMouseLeaveCallbackId;
+                const ElementHandle hoverHandle(hoverElement);
+                previousHover->m_IsMouseOver = false;
+                int leaveId = previousHover->m_OnMouseLeaveCallbackId;
                 if (leaveId != -1)
                 {
-                    JSEngine::MouseEventData leaveData = buildElementEventData(m_MouseOverElement);
+                    JSEngine::MouseEventData leaveData = buildElementEventData(previousHover);
                     JSEngine::CallEventCallback(leaveId, this, &leaveData);
                 }
 
                 // If callback cleared the elements or deleted hoverElement/actionElement, handle it
-                if (!isTrackedElement(hoverElement)) hoverElement = nullptr;
-                if (!isTrackedElement(actionElement)) actionElement = nullptr;
-                if (!isTrackedElement(mouseActionElement)) mouseActionElement = nullptr;
-                if (!isTrackedElement(toolTipElement)) toolTipElement = nullptr;
+                hoverElement = hoverHandle.Get();
+                hitElement = hitHandle.Get();
+                actionElement = actionHandle.Get();
+                mouseActionElement = mouseActionHandle.Get();
+                toolTipElement = toolTipHandle.Get();
 
                 if (m_Elements.empty())
                 {
-                    m_MouseOverElement = nullptr;
+                    m_MouseOverElement.Reset();
                     m_TooltipElement = nullptr;
                     return true;
                 }
             }
 
-            if (hoverElement && isTrackedElement(hoverElement))
+            if (hoverElement)
             {
+                const ElementHandle hoverHandle(hoverElement);
                 hoverElement->m_IsMouseOver = true;
                 int overId = hoverElement->m_OnMouseOverCallbackId;
                 if (overId != -1)
@@ -3126,24 +3100,26 @@ bool Widget::HandleMouseMessage(UINT message, WPARAM wParam, LPARAM lParam)
                 }
 
                 // Re-verify after callback
-                if (!isTrackedElement(hoverElement)) hoverElement = nullptr;
-                if (!isTrackedElement(actionElement)) actionElement = nullptr;
-                if (!isTrackedElement(mouseActionElement)) mouseActionElement = nullptr;
-                if (!isTrackedElement(toolTipElement)) toolTipElement = nullptr;
+                hoverElement = hoverHandle.Get();
+                hitElement = hitHandle.Get();
+                actionElement = actionHandle.Get();
+                mouseActionElement = mouseActionHandle.Get();
+                toolTipElement = toolTipHandle.Get();
 
                 if (m_Elements.empty())
                 {
-                    m_MouseOverElement = nullptr;
+                    m_MouseOverElement.Reset();
                     m_TooltipElement = nullptr;
                     return true;
                 }
             }
-            m_MouseOverElement = hoverElement;
+            m_MouseOverElement = ElementHandle(hoverElement);
 
             // Refresh cursor when element under mouse changes as it might have different action state
             PostMessage(m_hWnd, WM_SETCURSOR, (WPARAM)m_hWnd, MAKELPARAM(HTCLIENT, WM_MOUSEMOVE));
         }
 
+        Element *nextToolTipElement = nextToolTipHandle.Get();
         if (nextToolTipElement != m_TooltipElement)
         {
             m_Tooltip.Update(nextToolTipElement);
@@ -3194,10 +3170,10 @@ bool Widget::HandleMouseMessage(UINT message, WPARAM wParam, LPARAM lParam)
             }
             JSEngine::TriggerWidgetEvent(this, "mouseLeave", &leaveEventData);
         }
-        if (m_MouseOverElement && isTrackedElement(m_MouseOverElement))
+        if (Element *leaving = m_MouseOverElement.Get(this))
         {
-            m_MouseOverElement->m_IsMouseOver = false;
-            int leaveId = m_MouseOverElement->m_OnMouseLeaveCallbackId;
+            leaving->m_IsMouseOver = false;
+            int leaveId = leaving->m_OnMouseLeaveCallbackId;
             if (leaveId != -1)
             {
                 JSEngine::MouseEventData elementLeaveData;
@@ -3208,13 +3184,13 @@ bool Widget::HandleMouseMessage(UINT message, WPARAM wParam, LPARAM lParam)
                     ScreenToClient(m_hWnd, &clientPt);
                     elementLeaveData.clientX = clientPt.x;
                     elementLeaveData.clientY = clientPt.y;
-                    elementLeaveData.offsetX = clientPt.x - m_MouseOverElement->GetX();
-                    elementLeaveData.offsetY = clientPt.y - m_MouseOverElement->GetY();
+                    elementLeaveData.offsetX = clientPt.x - leaving->GetX();
+                    elementLeaveData.offsetY = clientPt.y - leaving->GetY();
                     elementLeaveData.screenX = screenPt.x;
                     elementLeaveData.screenY = screenPt.y;
 
-                    const int elementW = m_MouseOverElement->GetWidth();
-                    const int elementH = m_MouseOverElement->GetHeight();
+                    const int elementW = leaving->GetWidth();
+                    const int elementH = leaving->GetHeight();
                     if (elementW > 0)
                     {
                         elementLeaveData.offsetXPercent = (int)(((elementLeaveData.offsetX + 1) / (double)elementW) * 100.0);
@@ -3226,7 +3202,7 @@ bool Widget::HandleMouseMessage(UINT message, WPARAM wParam, LPARAM lParam)
                 }
                 JSEngine::CallEventCallback(leaveId, this, &elementLeaveData);
             }
-            m_MouseOverElement = nullptr;
+            m_MouseOverElement.Reset();
             m_TooltipElement = nullptr;
         }
         // Tooltip Update and kill timer
@@ -3236,7 +3212,7 @@ bool Widget::HandleMouseMessage(UINT message, WPARAM wParam, LPARAM lParam)
     }
 
     // Dispatch Actions
-    if (actionElement && isTrackedElement(actionElement))
+    if (actionElement)
     {
         int actionId = -1;
 
@@ -3351,6 +3327,9 @@ bool Widget::HandleMouseMessage(UINT message, WPARAM wParam, LPARAM lParam)
             // Execute function callback with mouse position aliases.
             JSEngine::CallEventCallback(actionId, this, &eventData);
             handled = true;
+
+            hitElement = hitHandle.Get();
+            actionElement = actionHandle.Get();
         }
     }
 
@@ -3362,11 +3341,12 @@ bool Widget::HandleMouseMessage(UINT message, WPARAM wParam, LPARAM lParam)
         if (textElem && textElem->GetTextSelection())
         {
             // Clear previous selection from other elements
-            if (m_TextSelectionElement && m_TextSelectionElement != textElem)
+            TextElement* previous = GetTextSelectionElement();
+            if (previous && previous != textElem)
             {
-                m_TextSelectionElement->ClearTextSelection();
+                previous->ClearTextSelection();
             }
-            m_TextSelectionElement = textElem;
+            m_TextSelectionElement = ElementHandle(textElem);
             textElem->HandleTextSelectionMouseDown(x, y);
             handled = true;
             needRedraw = true;
@@ -3374,12 +3354,12 @@ bool Widget::HandleMouseMessage(UINT message, WPARAM wParam, LPARAM lParam)
         else
         {
             // Clicked on non-selectable element, clear selection
-            if (m_TextSelectionElement)
+            if (TextElement* previous = GetTextSelectionElement())
             {
-                m_TextSelectionElement->ClearTextSelection();
-                m_TextSelectionElement = nullptr;
+                previous->ClearTextSelection();
                 needRedraw = true;
             }
+            m_TextSelectionElement.Reset();
         }
 
         // Input box focus + caret placement on click.
@@ -3429,10 +3409,10 @@ bool Widget::HandleMouseMessage(UINT message, WPARAM wParam, LPARAM lParam)
             m_IsElementDragging = true;
             SetCapture(m_hWnd);
 
-            if (m_DragElement->m_OnDragStartCallbackId != -1)
+            if (dragTarget->m_OnDragStartCallbackId != -1)
             {
-                JSEngine::MouseEventData eventData = buildElementEventData(m_DragElement);
-                JSEngine::CallEventCallback(m_DragElement->m_OnDragStartCallbackId, this, &eventData);
+                JSEngine::MouseEventData eventData = buildElementEventData(dragTarget);
+                JSEngine::CallEventCallback(dragTarget->m_OnDragStartCallbackId, this, &eventData);
                 handled = true;
             }
         }
@@ -3443,7 +3423,7 @@ bool Widget::HandleMouseMessage(UINT message, WPARAM wParam, LPARAM lParam)
         TextElement* textElem = dynamic_cast<TextElement*>(hitElement);
         if (textElem && textElem->GetTextSelection())
         {
-            m_TextSelectionElement = textElem;
+            m_TextSelectionElement = ElementHandle(textElem);
             textElem->HandleTextSelectionDoubleClick(x, y);
             handled = true;
             needRedraw = true;
@@ -3452,21 +3432,20 @@ bool Widget::HandleMouseMessage(UINT message, WPARAM wParam, LPARAM lParam)
     else if (message == WM_MOUSEMOVE)
     {
         // Handle text selection dragging
-        if (m_TextSelectionElement && m_TextSelectionElement->GetTextSelection())
+        TextElement* selecting = GetTextSelectionElement();
+        if (selecting && selecting->GetTextSelection())
         {
-            if (hitElement == m_TextSelectionElement || isTrackedElement(m_TextSelectionElement))
-            {
-                m_TextSelectionElement->HandleTextSelectionMouseMove(x, y);
-                needRedraw = true;
-            }
+            selecting->HandleTextSelectionMouseMove(x, y);
+            needRedraw = true;
         }
 
-        if (m_IsElementDragging && isTrackedElement(m_DragElement))
+        Element *dragElement = m_DragElement.Get();
+        if (m_IsElementDragging && dragElement)
         {
-            if (m_DragElement->m_OnDragCallbackId != -1)
+            if (dragElement->m_OnDragCallbackId != -1)
             {
-                JSEngine::MouseEventData eventData = buildElementEventData(m_DragElement);
-                JSEngine::CallEventCallback(m_DragElement->m_OnDragCallbackId, this, &eventData);
+                JSEngine::MouseEventData eventData = buildElementEventData(dragElement);
+                JSEngine::CallEventCallback(dragElement->m_OnDragCallbackId, this, &eventData);
                 handled = true;
             }
         }
@@ -3481,9 +3460,10 @@ bool Widget::HandleMouseMessage(UINT message, WPARAM wParam, LPARAM lParam)
     else if (message == WM_LBUTTONUP)
     {
         // Handle text selection release
-        if (m_TextSelectionElement && m_TextSelectionElement->GetTextSelection())
+        TextElement* selecting = GetTextSelectionElement();
+        if (selecting && selecting->GetTextSelection())
         {
-            m_TextSelectionElement->HandleTextSelectionMouseUp();
+            selecting->HandleTextSelectionMouseUp();
         }
 
         if (m_FocusedInputBox)
@@ -3491,16 +3471,17 @@ bool Widget::HandleMouseMessage(UINT message, WPARAM wParam, LPARAM lParam)
             m_FocusedInputBox->HandleMouseUp();
         }
 
-        if (m_IsElementDragging && isTrackedElement(m_DragElement))
+        Element *dragElement = m_DragElement.Get();
+        if (m_IsElementDragging && dragElement)
         {
-            if (m_DragElement->m_OnDragEndCallbackId != -1)
+            if (dragElement->m_OnDragEndCallbackId != -1)
             {
-                JSEngine::MouseEventData eventData = buildElementEventData(m_DragElement);
-                JSEngine::CallEventCallback(m_DragElement->m_OnDragEndCallbackId, this, &eventData);
+                JSEngine::MouseEventData eventData = buildElementEventData(dragElement);
+                JSEngine::CallEventCallback(dragElement->m_OnDragEndCallbackId, this, &eventData);
                 handled = true;
             }
         }
-        m_DragElement = nullptr;
+        m_DragElement.Reset();
         m_IsElementDragging = false;
         if (GetCapture() == m_hWnd && !m_IsDragging)
         {
@@ -30,6 +30,11 @@
 #include "../render/CursorManager.h"
 #include "../render/FlexLayoutEngine.h"
 #include "../render/InputBoxElement.h"
+#include "../render/RenderBackend.h"
+#include "WidgetVirtualListHelper.h"
+#include "../core/AnimationTrack.h"
+#include "../core/HitGrid.h"
+#include "../core/PerfCounters.h"
 
 #pragma comment(lib, "comctl32.lib")
 
@@ -86,52 +91,9 @@ class Widget
 public:
     // Use FlexLayoutConfig from FlexLayoutEngine
     using LayoutConfig = FlexLayoutConfig;
-    struct AnimationTarget
-    {
-        bool hasX = false;
-        bool hasY = false;
-        bool hasWidth = false;
-        bool hasHeight = false;
-        bool hasRotate = false;
-        float x = 0.0f;
-        float y = 0.0f;
-        float width = 0.0f;
-        float height = 0.0f;
-        float rotate = 0.0f;
-        bool hasFontSize = false;
-        bool hasFontWeight = false;
-        bool hasLetterSpacing = false;
-        bool hasFontColor = false;
-        float fontSize = 12.0f;
-        float fontWeight = 400.0f;
-        float letterSpacing = 0.0f;
-        float fontColorR = 0.0f;
-        float fontColorG = 0.0f;
-        float fontColorB = 0.0f;
-        float fontAlpha = 255.0f;
-
-        bool HasTransformProps() const
-        {
-            return hasX || hasY || hasWidth || hasHeight || hasRotate;
-        }
-
-        bool HasTextProps() const
-        {
-            return hasFontSize || hasFontWeight || hasLetterSpacing || hasFontColor;
-        }
-
-        bool HasAnyProps() const
-        {
-            return HasTransformProps() || HasTextProps();
-        }
-    };
-
-    struct AnimationKeyframe
-    {
-        float offset = 0.0f;
-        std::wstring easing;
-        AnimationTarget values;
-    };
+    // Defined in the core library (AnimationTrack.h)
+    using AnimationTarget = ::AnimationTarget;
+    using AnimationKeyframe = ::AnimationKeyframe;
 
     Widget(const WidgetOptions& options);
 
@@ -165,7 +127,24 @@ public:
     const WidgetOptions& GetOptions() const { return m_Options; }
     HWND GetWindow() const { return m_hWnd; }
     ZPOSITION GetWindowZPosition() const { return m_WindowZPosition; }
-    ID2D1DeviceContext* GetDeviceContext() const { return m_pContext.Get(); }
+    // Context of the frame currently being drawn; nullptr outside rendering.
+    ID2D1DeviceContext* GetDeviceContext() const { return m_pContext; }
+
+    struct ElementRenderTime
+    {
+        std::wstring id;
+        uint64_t micros;
+    };
+    // Render the current state into an offscreen backend (benchmarks, snapshots).
+    bool RenderFrame(RenderBackend& backend, std::vector<ElementRenderTime>* timings = nullptr);
+    static void SetHeadless(bool headless);
+    static bool IsHeadless() { return s_Headless; }
+
+    // Diagnostics (see PerfReport)
+    const PerfCounters::FrameStats& GetFrameStats() const { return m_FrameStats; }
+    size_t GetElementCount() const { return m_Elements.size(); }
+    size_t GetImageMemoryBytes() const;
+    size_t GetRenderCacheBytes() const;
 
     void AddImage(const PropertyParser::ImageOptions& options);
     void AddText(const PropertyParser::TextOptions& options);
@@ -209,6 +188,11 @@ public:
     bool TryGetLayoutConfig(const std::wstring &id, LayoutConfig &config) const;
     bool IsLayoutContainer(const std::wstring &id) const;
     void ReflowLayout(const std::wstring &id);
+    void MarkLayoutDirty(Element *element);
+    void FlushLayout();
+    void SetVirtualList(const std::wstring &id, const WidgetVirtualListHelper::Config &config);
+    bool TryGetVirtualList(const std::wstring &id, WidgetVirtualListHelper::Config &config) const;
+    void UpdateVirtualList(const std::wstring &id);
     void StartElementAnimation(const std::wstring &id, const AnimationTarget &to, const AnimationTarget &from, int durationMs, const std::wstring &easing, int iterationCount);
     void StartElementKeyframeAnimation(const std::wstring &id, const std::vector<AnimationKeyframe> &keyframes, int durationMs, const std::wstring &easing, int iterationCount);
     static Widget* GetWidgetFromHWND(HWND hWnd);
@@ -216,6 +200,7 @@ public:
 
     friend class WidgetAnimationHelper;
     friend class WidgetLayoutHelper;
+    friend class WidgetVirtualListHelper;
 
 private:
     static LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
@@ -223,6 +208,7 @@ private:
     static bool Register();
 
     void UpdateLayeredWindowContent();
+    void RenderContent(ID2D1DeviceContext* context, int w, int h, std::vector<ElementRenderTime>* timings);
 
     bool HandleMouseMessage(UINT message, WPARAM wParam, LPARAM lParam);
 
@@ -233,7 +219,7 @@ private:
     void UpdateContainerForElement(Element* element, const std::wstring& newContainerId);
     bool WouldCreateContainerCycle(Element* element, Element* container) const;
     void ApplyLayoutForContainer(Element *container);
-    void RenderContainerChildren(Element* container);
+    void RenderElement(ID2D1DeviceContext* context, Element* element, bool renderSelf);
     bool HitTestContainerChildren(Element* container, int x, int y, Element*& outElement);
     bool HitTestContainerChildrenDetailed(
         Element* container,
@@ -255,6 +241,14 @@ private:
     ZPOSITION m_WindowZPosition;
     std::vector<Element*> m_Elements;
     std::unordered_map<std::wstring, LayoutConfig> m_LayoutConfigs;
+    // Layout containers waiting for reflow (WidgetLayoutHelper::FlushLayout).
+    std::vector<ElementHandle> m_DirtyLayouts;
+    std::unordered_map<std::wstring, WidgetVirtualListHelper::State> m_VirtualLists;
+    // Top-level elements bucketed by bounds for mouse hit-testing; marked
+    // dirty by every redraw and rebuilt on the next mouse message.
+    HitGrid m_HitGrid;
+    std::vector<ElementHandle> m_HitGridElements;
+    bool m_HitGridDirty = true;
     struct ElementAnimation
     {
         std::wstring id;
@@ -272,7 +266,9 @@ private:
     };
 
     std::vector<ElementAnimation> m_Animations;
-    Element* m_MouseOverElement = nullptr;
+    // Held by handle: script callbacks may delete it, and the address can be
+    // reused by a new element.
+    ElementHandle m_MouseOverElement;
     Element* m_TooltipElement = nullptr;
     int m_IsBatchUpdating = 0;
     
@@ -287,7 +283,7 @@ private:
     POINT m_DragStartCursor = { 0, 0 };
     POINT m_DragStartWindow = { 0, 0 };
     bool m_IsElementDragging = false;
-    Element *m_DragElement = nullptr;
+    ElementHandle m_DragElement;
     bool m_IsMouseOverWidget = false;
     bool m_IsMinimized = false;
     bool m_SkipCloseEventOnDestroy = false;
@@ -295,8 +291,9 @@ private:
     HICON m_ToolbarIconHandle = nullptr;
     bool m_ToolbarIconOwned = false;
 
-    // Text Selection State
-    TextElement* m_TextSelectionElement = nullptr;
+    // Text Selection State (always a TextElement)
+    ElementHandle m_TextSelectionElement;
+    TextElement* GetTextSelectionElement() const { return static_cast<TextElement*>(m_TextSelectionElement.Get(this)); }
 
     // Input box focus state
     InputBoxElement* m_FocusedInputBox = nullptr;
@@ -308,13 +305,10 @@ private:
     void ReleaseRenderSurface();
     
     // Rendering
-    Microsoft::WRL::ComPtr<ID2D1DeviceContext> m_pContext;
-    HDC m_hRenderMemDc = nullptr;
-    HBITMAP m_hRenderBitmap = nullptr;
-    HBITMAP m_hRenderOldBitmap = nullptr;
-    void *m_pRenderBitmapBits = nullptr;
-    int m_RenderBitmapW = 0;
-    int m_RenderBitmapH = 0;
+    LayeredWindowBackend m_WindowBackend;
+    ID2D1DeviceContext* m_pContext = nullptr;
+    static bool s_Headless;
+    PerfCounters::FrameStats m_FrameStats;
 
     static const UINT_PTR TIMER_TOPMOST = 2;
     static const UINT_PTR TIMER_TOOLTIP = 3;
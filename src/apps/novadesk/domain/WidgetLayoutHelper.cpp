@@ -10,8 +10,13 @@
 #include "../shared/Logging.h"
 #include "../render/ElementLayoutBox.h"
 #include "../render/ShapeElement.h"
+#include "../render/RectangleShape.h"
 #include "../render/FlexLayoutEngine.h"
 #include "../render/Direct2DHelper.h"
+#include "../core/PerfCounters.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
 
 // Helper to access Widget's layout configs
 std::unordered_map<std::wstring, WidgetLayoutHelper::LayoutConfig>& 
@@ -32,7 +37,13 @@ void WidgetLayoutHelper::SetLayoutConfig(Widget& widget, const std::wstring& id,
         return;
     
     GetLayoutConfigs(widget)[id] = config;
-    ReflowLayout(widget, id);
+
+    Element* container = widget.FindElementById(id);
+    if (!container)
+        return;
+    if (ElementLayoutBox* layoutBox = dynamic_cast<ElementLayoutBox*>(container))
+        layoutBox->SetFlexConfig(config);
+    MarkLayoutDirty(widget, container);
 }
 
 bool WidgetLayoutHelper::TryGetLayoutConfig(const Widget& widget, const std::wstring& id, LayoutConfig& config)
@@ -65,13 +76,16 @@ void WidgetLayoutHelper::ReflowLayout(Widget& widget, const std::wstring& id)
         return;
     
     ApplyLayoutForContainer(widget, container);
+    FlushLayout(widget);
 }
 
-void WidgetLayoutHelper::ApplyLayoutForContainer(const Widget& widget, Element* container)
+void WidgetLayoutHelper::ApplyLayoutForContainer(Widget& widget, Element* container)
 {
     if (!container)
         return;
 
+    container->SetLayoutDirty(false);
+
     const auto& configs = GetLayoutConfigs(widget);
     auto cfgIt = configs.find(container->GetId());
     if (cfgIt == configs.end())
@@ -83,7 +97,89 @@ void WidgetLayoutHelper::ApplyLayoutForContainer(const Widget& widget, Element*
         return;
 
     // Delegate to FlexLayoutEngine
-    FlexLayoutEngine::ApplyLayout(container, cfg);
+    PerfCounters::Increment(PerfCounters::Counter::LayoutReflows);
+    std::vector<Element*> resized;
+    FlexLayoutEngine::ApplyLayout(container, cfg, &resized);
+
+    // A nested layout box given a new size re-arranges its own children.
+    for (Element* child : resized)
+    {
+        if (IsLayoutContainer(widget, child->GetId()))
+            QueueReflow(widget, child);
+    }
+}
+
+void WidgetLayoutHelper::QueueReflow(Widget& widget, Element* container)
+{
+    if (container->IsLayoutDirty())
+        return;
+
+    container->SetLayoutDirty(true);
+    widget.m_DirtyLayouts.push_back(ElementHandle(container));
+}
+
+void WidgetLayoutHelper::MarkLayoutDirty(Widget& widget, Element* element)
+{
+    if (!element)
+        return;
+
+    for (Element* cursor = element; cursor; cursor = cursor->GetContainer())
+    {
+        cursor->InvalidateLayoutMeasure();
+        if (!IsLayoutContainer(widget, cursor->GetId()))
+        {
+            // Plain containers do not size from their children.
+            if (cursor != element)
+                break;
+            continue;
+        }
+
+        QueueReflow(widget, cursor);
+
+        // A container with a declared size absorbs the change: its own
+        // parent is unaffected.
+        if (cursor != element && cursor->GetSpecifiedWidth() > 0 && cursor->GetSpecifiedHeight() > 0)
+            break;
+    }
+}
+
+void WidgetLayoutHelper::FlushLayout(Widget& widget)
+{
+    if (widget.m_DirtyLayouts.empty())
+        return;
+
+    // Children move; the hit grid has to follow.
+    widget.m_HitGridDirty = true;
+
+    std::vector<std::pair<int, Element*>> batch;
+    while (!widget.m_DirtyLayouts.empty())
+    {
+        // Arranging a container may queue resized nested containers; those
+        // are handled in the next round.
+        batch.clear();
+        for (const ElementHandle& handle : widget.m_DirtyLayouts)
+        {
+            Element* container = handle.Get();
+            if (!container || !container->IsLayoutDirty())
+                continue;
+
+            int depth = 0;
+            for (const Element* cursor = container->GetContainer(); cursor; cursor = cursor->GetContainer())
+                ++depth;
+            batch.emplace_back(depth, container);
+        }
+        widget.m_DirtyLayouts.clear();
+
+        std::stable_sort(batch.begin(), batch.end(),
+            [](const std::pair<int, Element*>& a, const std::pair<int, Element*>& b) { return a.first < b.first; });
+
+        for (const auto& entry : batch)
+        {
+            // Skip containers already arranged (and cleaned) this round.
+            if (entry.second->IsLayoutDirty())
+                ApplyLayoutForContainer(widget, entry.second);
+        }
+    }
 }
 
 void WidgetLayoutHelper::UpdateContainerForElement(Widget& widget, Element* element, const std::wstring& newContainerId)
@@ -99,13 +195,11 @@ void WidgetLayoutHelper::UpdateContainerForElement(Widget& widget, Element* elem
         if (currentContainer)
         {
             currentContainer->RemoveContainerItem(element);
-            if (IsLayoutContainer(widget, currentContainer->GetId()))
-            {
-                ApplyLayoutForContainer(widget, currentContainer);
-            }
+            MarkLayoutDirty(widget, currentContainer);
             element->SetContainer(nullptr);
         }
         element->SetContainerId(L"");
+        MarkLayoutDirty(widget, element);
         return;
     }
 
@@ -152,20 +246,14 @@ void WidgetLayoutHelper::UpdateContainerForElement(Widget& widget, Element* elem
         if (currentContainer)
         {
             currentContainer->RemoveContainerItem(element);
-            if (IsLayoutContainer(widget, currentContainer->GetId()))
-            {
-                ApplyLayoutForContainer(widget, currentContainer);
-            }
+            MarkLayoutDirty(widget, currentContainer);
         }
         newContainer->AddContainerItem(element);
         element->SetContainer(newContainer);
     }
 
     element->SetContainerId(newContainerId);
-    if (IsLayoutContainer(widget, newContainer->GetId()))
-    {
-        ApplyLayoutForContainer(widget, newContainer);
-    }
+    MarkLayoutDirty(widget, element);
 }
 
 bool WidgetLayoutHelper::WouldCreateContainerCycle(const Element* element, const Element* container)
@@ -187,111 +275,463 @@ bool WidgetLayoutHelper::WouldCreateContainerCycle(const Element* element, const
     return false;
 }
 
-void WidgetLayoutHelper::RenderContainerChildren(const Widget& widget, Element* container)
+namespace
 {
-    if (!container || !container->IsContainer())
-        return;
+    // Below this many children a linear scan beats maintaining the index.
+    const size_t kChildIndexThreshold = 32;
 
-    ID2D1DeviceContext* context = widget.GetDeviceContext();
-    if (!context)
-        return;
+    bool IsTransformed(Element* element)
+    {
+        return element->GetRotate() != 0.0f || element->HasTransformMatrix();
+    }
 
-    GfxRect bounds = container->GetBounds();
-    D2D1_RECT_F clipRect = D2D1::RectF(
-        (float)bounds.X, (float)bounds.Y,
-        (float)(bounds.X + bounds.Width), (float)(bounds.Y + bounds.Height));
+    // Conservative: rotated/transformed children are always considered visible.
+    bool MayIntersect(Element* child, const GfxRect& area)
+    {
+        return IsTransformed(child) || child->GetVisualBounds().Intersects(area);
+    }
 
-    Microsoft::WRL::ComPtr<ID2D1Layer> layer;
-    context->CreateLayer(layer.GetAddressOf());
-    if (!layer)
-        return;
+    /*
+    ** Index the children along whichever axis their content is spread over the
+    ** most, relative to the container size (the axis the container scrolls).
+    */
+    void RebuildChildIndex(Element* container)
+    {
+        Element::ChildIndex& index = container->GetChildIndex();
+        const auto& items = container->GetContainerItems();
+
+        std::vector<GfxRect> rects(items.size());
+        std::vector<bool> unbounded(items.size(), false);
+        int minX = INT_MAX, minY = INT_MAX, maxX = INT_MIN, maxY = INT_MIN;
+        for (size_t i = 0; i < items.size(); ++i)
+        {
+            Element* child = items[i];
+            if (!child || IsTransformed(child))
+            {
+                unbounded[i] = true;
+                continue;
+            }
+            const GfxRect& r = rects[i] = child->GetVisualBounds();
+            minX = (std::min)(minX, r.X);
+            minY = (std::min)(minY, r.Y);
+            maxX = (std::max)(maxX, r.X + r.Width);
+            maxY = (std::max)(maxY, r.Y + r.Height);
+        }
 
-    Microsoft::WRL::ComPtr<ID2D1BitmapBrush> opacityBrush;
-    bool hasOpacityMask = false;
-    const bool isLayoutContainer = IsLayoutContainer(widget, container->GetId());
+        const GfxRect bounds = container->GetBounds();
+        const long long spreadX = maxX > minX ? (long long)(maxX - minX) : 0;
+        const long long spreadY = maxY > minY ? (long long)(maxY - minY) : 0;
+        index.vertical = spreadY * (std::max)(1, bounds.Width) >= spreadX * (std::max)(1, bounds.Height);
 
-    // Layout containers are structural wrappers; they should clip children,
-    // but must not apply alpha masking from their own fill/stroke.
-    if (!isLayoutContainer && bounds.Width > 0 && bounds.Height > 0)
+        std::vector<SpanIndex::Span>& spans = index.indexed;
+        spans.resize(items.size());
+        for (size_t i = 0; i < items.size(); ++i)
+        {
+            if (items[i])
+                items[i]->TakeAutoBoundsStale();
+            if (unbounded[i])
+            {
+                spans[i] = {INT_MIN, INT_MAX};
+                continue;
+            }
+            const GfxRect& r = rects[i];
+            spans[i] = index.vertical ? SpanIndex::Span{r.Y, r.Y + r.Height} : SpanIndex::Span{r.X, r.X + r.Width};
+        }
+        index.spans.Build(spans);
+        index.dirty = false;
+        index.recheck = false;
+    }
+
+    /*
+    ** Auto-sized children change bounds with their content (text, images)
+    ** without going through SetSize/SetPosition. Re-measure only the children
+    ** flagged since the last build and rebuild if any of their spans moved.
+    */
+    void RecheckChildIndex(Element* container)
     {
-        Microsoft::WRL::ComPtr<ID2D1BitmapRenderTarget> maskTarget;
-        HRESULT hr = context->CreateCompatibleRenderTarget(
-            D2D1::SizeF((FLOAT)bounds.Width, (FLOAT)bounds.Height),
-            maskTarget.GetAddressOf());
-        
-        if (SUCCEEDED(hr) && maskTarget)
+        Element::ChildIndex& index = container->GetChildIndex();
+        index.recheck = false;
+
+        const auto& items = container->GetContainerItems();
+        if (index.indexed.size() != items.size())
+        {
+            index.dirty = true;
+            return;
+        }
+        for (size_t i = 0; i < items.size(); ++i)
+        {
+            Element* child = items[i];
+            if (!child || !child->TakeAutoBoundsStale() || index.dirty)
+                continue;
+
+            SpanIndex::Span span = {INT_MIN, INT_MAX};
+            if (!IsTransformed(child))
+            {
+                const GfxRect r = child->GetVisualBounds();
+                span = index.vertical ? SpanIndex::Span{r.Y, r.Y + r.Height} : SpanIndex::Span{r.X, r.X + r.Width};
+            }
+            const SpanIndex::Span& old = index.indexed[i];
+            if (span.start != old.start || span.end != old.end)
+                index.dirty = true;
+        }
+    }
+
+    // Indices of children that may overlap 'area' (container content
+    // coordinates), in paint order. Callers still test each candidate.
+    void CollectChildren(Element* container, const GfxRect& area, std::vector<int>& out)
+    {
+        const auto& items = container->GetContainerItems();
+        if (items.size() < kChildIndexThreshold)
+        {
+            for (size_t i = 0; i < items.size(); ++i)
+                out.push_back(static_cast<int>(i));
+            return;
+        }
+
+        Element::ChildIndex& index = container->GetChildIndex();
+        if (!index.dirty && index.recheck)
+            RecheckChildIndex(container);
+        if (index.dirty)
+            RebuildChildIndex(container);
+        if (index.vertical)
+            index.spans.Query(area.Y, area.Y + area.Height, out);
+        else
+            index.spans.Query(area.X, area.X + area.Width, out);
+    }
+
+    // Rectangles without rounded corners clip exactly to their bounds, so they
+    // can use an axis-aligned clip instead of a layer with an opacity mask.
+    bool IsAxisAlignedRectangle(ShapeElement* shape)
+    {
+        if (shape->GetRadiusX() > 0.0f || shape->GetRadiusY() > 0.0f)
+            return false;
+        return dynamic_cast<RectangleShape*>(shape) || dynamic_cast<ElementLayoutBox*>(shape);
+    }
+
+    /*
+    ** Return the container's opacity mask brush, rasterising the shape geometry
+    ** only when the device context, size or outline changed since last frame.
+    ** Moving the container just updates the brush transform.
+    */
+    ID2D1BitmapBrush* AcquireContainerMask(ID2D1DeviceContext* context, ShapeElement* shape, const GfxRect& bounds)
+    {
+        ShapeElement::ContainerMask& mask = shape->GetContainerMask();
+        const int offsetX = shape->GetX() - bounds.X;
+        const int offsetY = shape->GetY() - bounds.Y;
+
+        const bool stale = mask.context.Get() != context ||
+                           !mask.brush ||
+                           mask.width != bounds.Width ||
+                           mask.height != bounds.Height ||
+                           mask.offsetX != offsetX ||
+                           mask.offsetY != offsetY ||
+                           mask.geometryRevision != shape->GetGeometryRevision();
+
+        if (stale)
         {
+            mask = ShapeElement::ContainerMask();
+
+            Microsoft::WRL::ComPtr<ID2D1BitmapRenderTarget> maskTarget;
+            HRESULT hr = context->CreateCompatibleRenderTarget(
+                D2D1::SizeF((FLOAT)bounds.Width, (FLOAT)bounds.Height),
+                maskTarget.GetAddressOf());
+            if (FAILED(hr) || !maskTarget)
+                return nullptr;
+
             maskTarget->BeginDraw();
             maskTarget->Clear(D2D1::ColorF(0, 0.0f));
 
-            if (ShapeElement* shapeContainer = dynamic_cast<ShapeElement*>(container))
+            // Geometry is in widget coordinates; the mask bitmap starts at the
+            // container's top-left corner.
+            maskTarget->SetTransform(D2D1::Matrix3x2F::Translation((FLOAT)-bounds.X, (FLOAT)-bounds.Y));
+
+            Microsoft::WRL::ComPtr<ID2D1Geometry> geom;
+            ID2D1Factory1* factory = Direct2D::GetFactory();
+            if (factory && shape->CreateGeometry(factory, geom))
             {
-                Microsoft::WRL::ComPtr<ID2D1Geometry> geom;
-                ID2D1Factory1* factory = Direct2D::GetFactory();
-                if (factory && shapeContainer->CreateGeometry(factory, geom))
+                Microsoft::WRL::ComPtr<ID2D1SolidColorBrush> brush;
+                if (Direct2D::CreateSolidBrush(maskTarget.Get(), RGB(255, 255, 255), 1.0f, &brush))
                 {
-                    Microsoft::WRL::ComPtr<ID2D1SolidColorBrush> brush;
-                    if (Direct2D::CreateSolidBrush(maskTarget.Get(), RGB(255, 255, 255), 1.0f, &brush))
-                    {
-                        maskTarget->FillGeometry(geom.Get(), brush.Get());
-                    }
+                    maskTarget->FillGeometry(geom.Get(), brush.Get());
                 }
             }
 
-            maskTarget->EndDraw();
+            if (FAILED(maskTarget->EndDraw()))
+                return nullptr;
 
             Microsoft::WRL::ComPtr<ID2D1Bitmap> maskBitmap;
             maskTarget->GetBitmap(&maskBitmap);
-            if (maskBitmap)
+            if (!maskBitmap || FAILED(context->CreateBitmapBrush(maskBitmap.Get(), &mask.brush)) || !mask.brush)
             {
-                Microsoft::WRL::ComPtr<ID2D1BitmapBrush> brush1;
-                HRESULT brushResult = context->CreateBitmapBrush(maskBitmap.Get(), &brush1);
-                if (SUCCEEDED(brushResult) && brush1)
-                {
-                    brush1->SetTransform(D2D1::Matrix3x2F::Translation((FLOAT)bounds.X, (FLOAT)bounds.Y));
-                    opacityBrush = brush1;
-                    hasOpacityMask = true;
-                }
+                mask.brush.Reset();
+                return nullptr;
             }
+
+            context->CreateLayer(mask.layer.GetAddressOf());
+            mask.context = context;
+            mask.width = bounds.Width;
+            mask.height = bounds.Height;
+            mask.offsetX = offsetX;
+            mask.offsetY = offsetY;
+            mask.geometryRevision = shape->GetGeometryRevision();
+        }
+        else if (mask.originX == bounds.X && mask.originY == bounds.Y)
+        {
+            return mask.brush.Get();
         }
+
+        mask.brush->SetTransform(D2D1::Matrix3x2F::Translation((FLOAT)bounds.X, (FLOAT)bounds.Y));
+        mask.originX = bounds.X;
+        mask.originY = bounds.Y;
+        return mask.brush.Get();
     }
 
-    // Push layer with optional opacity mask
-    if (hasOpacityMask)
+    // Frames a cacheAsBitmap subtree has to stay unchanged before it is
+    // rasterised, so elements that are being edited are not cached every frame.
+    const int kRenderCacheStableFrames = 3;
+
+    // A cached bitmap is blitted 1:1, which is only exact under a whole-pixel
+    // translation.
+    bool IsPixelAlignedTranslation(const D2D1_MATRIX_3X2_F& m)
+    {
+        return m._11 == 1.0f && m._12 == 0.0f && m._21 == 0.0f && m._22 == 1.0f &&
+               m._31 == std::floor(m._31) && m._32 == std::floor(m._32);
+    }
+
+    bool IsSubtreeVolatile(Element* element)
+    {
+        if (element->IsRenderVolatile())
+            return true;
+        for (Element* child : element->GetContainerItems())
+        {
+            if (child && IsSubtreeVolatile(child))
+                return true;
+        }
+        return false;
+    }
+}
+
+void WidgetLayoutHelper::RenderElement(const Widget& widget, ID2D1DeviceContext* context, Element* element, bool renderSelf)
+{
+    if (!context || !element)
+        return;
+
+    if (element->GetCacheAsBitmap() && DrawFromRenderCache(widget, context, element, renderSelf))
+        return;
+
+    PaintElement(widget, context, element, renderSelf);
+}
+
+void WidgetLayoutHelper::PaintElement(const Widget& widget, ID2D1DeviceContext* context, Element* element, bool renderSelf)
+{
+    if (renderSelf)
+        element->Render(context);
+    if (element->IsContainer())
+        RenderContainerChildren(widget, context, element);
+}
+
+/*
+** Composite a cacheAsBitmap subtree from its bitmap, rasterising it first if
+** it has been unchanged for kRenderCacheStableFrames. Returns false when the
+** caller has to paint the subtree directly.
+*/
+bool WidgetLayoutHelper::DrawFromRenderCache(const Widget& widget, ID2D1DeviceContext* context, Element* element, bool renderSelf)
+{
+    Element::RenderCache& cache = element->GetRenderCache();
+    if (cache.revision != element->GetRenderRevision())
+    {
+        cache.revision = element->GetRenderRevision();
+        cache.stableFrames = 0;
+        element->ReleaseRenderCache();
+        return false;
+    }
+
+    D2D1_MATRIX_3X2_F transform;
+    context->GetTransform(&transform);
+    if (IsTransformed(element) || !IsPixelAlignedTranslation(transform))
+        return false;
+
+    // Children are clipped to the container bounds; the element itself may
+    // paint outside them (bevel, shadow).
+    GfxRect region = element->GetBounds();
+    if (renderSelf)
+        region = region.Union(element->GetVisualBounds());
+    if (region.Width <= 0 || region.Height <= 0)
+        return false;
+
+    Microsoft::WRL::ComPtr<ID2D1Device> device;
+    context->GetDevice(device.GetAddressOf());
+
+    const int offsetX = region.X - element->GetX();
+    const int offsetY = region.Y - element->GetY();
+    const bool valid = cache.bitmap && cache.device == device &&
+                       cache.offsetX == offsetX && cache.offsetY == offsetY &&
+                       cache.width == region.Width && cache.height == region.Height;
+
+    if (!valid)
+    {
+        element->ReleaseRenderCache();
+        if (++cache.stableFrames < kRenderCacheStableFrames || IsSubtreeVolatile(element))
+            return false;
+
+        Microsoft::WRL::ComPtr<ID2D1BitmapRenderTarget> target;
+        Microsoft::WRL::ComPtr<ID2D1DeviceContext> targetContext;
+        HRESULT hr = context->CreateCompatibleRenderTarget(
+            D2D1::SizeF((FLOAT)region.Width, (FLOAT)region.Height),
+            target.GetAddressOf());
+        if (FAILED(hr) || !target || FAILED(target.As(&targetContext)))
+            return false;
+
+        targetContext->SetTextAntialiasMode(context->GetTextAntialiasMode());
+        targetContext->BeginDraw();
+        targetContext->Clear(D2D1::ColorF(0, 0.0f));
+        targetContext->SetTransform(D2D1::Matrix3x2F::Translation((FLOAT)-region.X, (FLOAT)-region.Y));
+        PaintElement(widget, targetContext.Get(), element, renderSelf);
+        if (FAILED(targetContext->EndDraw()))
+            return false;
+
+        target->GetBitmap(cache.bitmap.GetAddressOf());
+        if (!cache.bitmap)
+            return false;
+
+        cache.device = device;
+        cache.offsetX = offsetX;
+        cache.offsetY = offsetY;
+        cache.width = region.Width;
+        cache.height = region.Height;
+        PerfCounters::Increment(PerfCounters::Counter::RenderCacheBuilds);
+    }
+    else
+    {
+        PerfCounters::Increment(PerfCounters::Counter::RenderCacheHits);
+    }
+
+    const D2D1_RECT_F dest = D2D1::RectF(
+        (FLOAT)region.X, (FLOAT)region.Y,
+        (FLOAT)(region.X + region.Width), (FLOAT)(region.Y + region.Height));
+    context->DrawBitmap(cache.bitmap.Get(), &dest, 1.0f, D2D1_INTERPOLATION_MODE_NEAREST_NEIGHBOR);
+    return true;
+}
+
+void WidgetLayoutHelper::RenderContainerChildren(const Widget& widget, ID2D1DeviceContext* context, Element* container)
+{
+    if (!container || !container->IsContainer() || !context)
+        return;
+
+    GfxRect bounds = container->GetBounds();
+    D2D1_RECT_F clipRect = D2D1::RectF(
+        (float)bounds.X, (float)bounds.Y,
+        (float)(bounds.X + bounds.Width), (float)(bounds.Y + bounds.Height));
+
+    // Layout containers are structural wrappers; they should clip children,
+    // but must not apply alpha masking from their own fill/stroke. Shapes with
+    // a non-rectangular outline clip through a cached opacity mask; everything
+    // else takes the cheaper axis-aligned clip.
+    ShapeElement::ContainerMask* mask = nullptr;
+    ShapeElement* shapeContainer = dynamic_cast<ShapeElement*>(container);
+    if (shapeContainer && !IsLayoutContainer(widget, container->GetId()) &&
+        !IsAxisAlignedRectangle(shapeContainer) && bounds.Width > 0 && bounds.Height > 0)
+    {
+        if (AcquireContainerMask(context, shapeContainer, bounds))
+            mask = &shapeContainer->GetContainerMask();
+    }
+
+    if (mask)
     {
         context->PushLayer(
             D2D1::LayerParameters(clipRect, nullptr, D2D1_ANTIALIAS_MODE_PER_PRIMITIVE,
-                                 D2D1::Matrix3x2F::Identity(), 1.0f, opacityBrush.Get()),
-            layer.Get());
+                                 D2D1::Matrix3x2F::Identity(), 1.0f, mask->brush.Get()),
+            mask->layer.Get());
     }
     else
     {
-        context->PushLayer(D2D1::LayerParameters(clipRect), layer.Get());
+        context->PushAxisAlignedClip(clipRect, D2D1_ANTIALIAS_MODE_ALIASED);
     }
 
-    // Apply translation for container offset
+    // Apply translation for container offset and scroll position
+    const int scrollX = container->GetScrollX();
+    const int scrollY = container->GetScrollY();
     D2D1_MATRIX_3X2_F originalTransform;
     context->GetTransform(&originalTransform);
-    D2D1_MATRIX_3X2_F translate = D2D1::Matrix3x2F::Translation((float)bounds.X, (float)bounds.Y);
+    D2D1_MATRIX_3X2_F translate = D2D1::Matrix3x2F::Translation((float)(bounds.X - scrollX), (float)(bounds.Y - scrollY));
     context->SetTransform(translate * originalTransform);
 
-    // Render all children recursively
-    for (Element* child : container->GetContainerItems())
+    // Render the children that intersect the viewport, recursively
+    std::vector<Element*> visible;
+    CollectViewportChildren(container, visible);
+    const size_t culled = container->GetContainerItems().size() - visible.size();
+
+    for (Element* child : visible)
     {
-        if (!child || !child->IsVisible())
-            continue;
-        
-        child->Render(context);
-        
-        if (child->IsContainer())
+        RenderElement(widget, context, child);
+    }
+
+    if (culled)
+        PerfCounters::Increment(PerfCounters::Counter::ElementsCulled, culled);
+
+    // Restore transform and pop clip
+    context->SetTransform(originalTransform);
+    if (mask)
+        context->PopLayer();
+    else
+        context->PopAxisAlignedClip();
+}
+
+void WidgetLayoutHelper::CollectViewportChildren(Element* container, std::vector<Element*>& out)
+{
+    if (!container)
+        return;
+
+    const GfxRect bounds = container->GetBounds();
+    const GfxRect viewport(container->GetScrollX(), container->GetScrollY(), bounds.Width, bounds.Height);
+    const auto& items = container->GetContainerItems();
+
+    std::vector<int> candidates;
+    candidates.reserve((std::min)(items.size(), kChildIndexThreshold));
+    CollectChildren(container, viewport, candidates);
+
+    for (int i : candidates)
+    {
+        Element* child = items[i];
+        if (child && child->IsVisible() && MayIntersect(child, viewport))
+            out.push_back(child);
+    }
+}
+
+void WidgetLayoutHelper::CollectHitCandidates(Widget& widget, int x, int y, std::vector<Element*>& out)
+{
+    FlushLayout(widget);
+    if (widget.m_HitGridDirty)
+    {
+        RECT client = {};
+        GetClientRect(widget.m_hWnd, &client);
+
+        std::vector<HitGrid::Entry> entries;
+        widget.m_HitGridElements.clear();
+        for (Element* element : widget.m_Elements)
         {
-            RenderContainerChildren(widget, child);
+            if (!element || element->IsContained() || !element->IsVisible())
+                continue;
+
+            HitGrid::Entry entry;
+            entry.unbounded = IsTransformed(element);
+            if (!entry.unbounded)
+                entry.bounds = element->GetBounds().Union(element->GetVisualBounds());
+            entries.push_back(entry);
+            widget.m_HitGridElements.push_back(element);
         }
+        widget.m_HitGrid.Build(client.right - client.left, client.bottom - client.top, entries);
+        widget.m_HitGridDirty = false;
     }
 
-    // Restore transform and pop layer
-    context->SetTransform(originalTransform);
-    context->PopLayer();
+    std::vector<int> hits;
+    widget.m_HitGrid.Query(x, y, hits);
+    for (int index : hits)
+    {
+        // Handles skip anything deleted since the grid was built.
+        if (Element* element = widget.m_HitGridElements[index].Get())
+            out.push_back(element);
+    }
 }
 
 bool WidgetLayoutHelper::HitTestContainerChildren(Element* container, int x, int y, Element*& outElement)
@@ -319,14 +759,16 @@ bool WidgetLayoutHelper::HitTestContainerChildren(Element* container, int x, int
             return false;
     }
 
-    int localX = x - bounds.X;
-    int localY = y - bounds.Y;
+    int localX = x - bounds.X + container->GetScrollX();
+    int localY = y - bounds.Y + container->GetScrollY();
     bool foundAny = false;
 
     const auto& items = container->GetContainerItems();
-    for (auto it = items.rbegin(); it != items.rend(); ++it)
+    std::vector<int> candidates;
+    CollectChildren(container, GfxRect(localX, localY, 1, 1), candidates);
+    for (auto it = candidates.rbegin(); it != candidates.rend(); ++it)
     {
-        Element* child = *it;
+        Element* child = items[*it];
         if (!child || !child->IsVisible())
             continue;
 
@@ -381,23 +823,25 @@ bool WidgetLayoutHelper::HitTestContainerChildrenDetailed(
     }
 
     // Test children in reverse order (top to bottom)
-    int localX = x - bounds.X;
-    int localY = y - bounds.Y;
+    int localX = x - bounds.X + container->GetScrollX();
+    int localY = y - bounds.Y + container->GetScrollY();
     bool foundAny = false;
 
     const auto& items = container->GetContainerItems();
-    for (auto it = items.rbegin(); it != items.rend(); ++it)
+    std::vector<int> candidates;
+    CollectChildren(container, GfxRect(localX, localY, 1, 1), candidates);
+    for (auto it = candidates.rbegin(); it != candidates.rend(); ++it)
     {
-        Element* child = *it;
+        Element* child = items[*it];
         if (!child || !child->IsVisible())
             continue;
 
-        // Recursively test child containers
+        // Recursively test child containers (their bounds are local to us)
         if (child->IsContainer())
         {
             if (HitTestContainerChildrenDetailed(
                     widget, child,
-                    x, y, message, wParam,
+                    localX, localY, message, wParam,
                     outHitElement, outActionElement, outMouseActionElement, outToolTipElement))
             {
                 return true;
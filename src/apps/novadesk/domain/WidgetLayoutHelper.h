@@ -10,6 +10,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include "../render/Element.h"
 #include "../render/FlexLayoutEngine.h"
 
@@ -60,18 +61,36 @@ public:
     static bool IsLayoutContainer(const Widget& widget, const std::wstring& id);
 
     /**
-     * Reflow layout for a specific container
+     * Reflow layout for a specific container now (and any queued reflows)
      * @param widget The widget instance
      * @param id Container element ID
      */
     static void ReflowLayout(Widget& widget, const std::wstring& id);
 
     /**
-     * Apply layout to a container element
+     * Apply layout to a container element; nested layout containers that
+     * were resized are queued for the next FlushLayout()
      * @param widget The widget instance
      * @param container The container element
      */
-    static void ApplyLayoutForContainer(const Widget& widget, Element* container);
+    static void ApplyLayoutForContainer(Widget& widget, Element* container);
+
+    /**
+     * Note that an element's size or content changed: drop its cached
+     * measure and queue its layout container for reflow, walking up while
+     * the container's own size follows its children.
+     * @param widget The widget instance
+     * @param element The changed element
+     */
+    static void MarkLayoutDirty(Widget& widget, Element* element);
+
+    /**
+     * Reflow every queued layout container, outermost first, so nested
+     * containers are arranged inside their final size. Cheap when clean;
+     * call before rendering, hit testing or reporting geometry.
+     * @param widget The widget instance
+     */
+    static void FlushLayout(Widget& widget);
 
     /**
      * Update the container assignment for an element
@@ -89,12 +108,32 @@ public:
      */
     static bool WouldCreateContainerCycle(const Element* element, const Element* container);
 
+    /**
+     * Render an element and, for containers, its children. Subtrees marked
+     * cacheAsBitmap are composited from their cached bitmap while unchanged.
+     * @param widget The widget instance
+     * @param context Target to draw into
+     * @param element The element to render
+     * @param renderSelf false to draw only the children (top-level shape
+     *        containers act as a clip, not as paint)
+     */
+    static void RenderElement(const Widget& widget, ID2D1DeviceContext* context, Element* element, bool renderSelf = true);
+
     /**
      * Render all children of a container element
      * @param widget The widget instance
+     * @param context Target to draw into
+     * @param container The container element
+     */
+    static void RenderContainerChildren(const Widget& widget, ID2D1DeviceContext* context, Element* container);
+
+    /**
+     * Collect the visible children that intersect a container's viewport
+     * (its bounds shifted by the scroll offset), in paint order
      * @param container The container element
+     * @param out Receives the children; not cleared first
      */
-    static void RenderContainerChildren(const Widget& widget, Element* container);
+    static void CollectViewportChildren(Element* container, std::vector<Element*>& out);
 
     /**
      * Hit test children of a container
@@ -132,6 +171,17 @@ public:
         Element*& outMouseActionElement,
         Element*& outToolTipElement);
 
+    /**
+     * Collect the top-level elements whose bounds contain a point, topmost
+     * first, using the widget's hit grid (rebuilt lazily after a redraw).
+     * Candidates still need a precise Element::HitTest.
+     * @param widget The widget instance
+     * @param x X coordinate (client)
+     * @param y Y coordinate (client)
+     * @param out Output: candidate elements, front to back
+     */
+    static void CollectHitCandidates(Widget& widget, int x, int y, std::vector<Element*>& out);
+
     /**
      * Get the layout configs map from widget (for internal use)
      * @param widget The widget instance
@@ -141,6 +191,10 @@ public:
     static const std::unordered_map<std::wstring, LayoutConfig>& GetLayoutConfigs(const Widget& widget);
 
 private:
+    static void QueueReflow(Widget& widget, Element* container);
+    static void PaintElement(const Widget& widget, ID2D1DeviceContext* context, Element* element, bool renderSelf);
+    static bool DrawFromRenderCache(const Widget& widget, ID2D1DeviceContext* context, Element* element, bool renderSelf);
+
     // No instances - static utility class
     WidgetLayoutHelper() = delete;
 };
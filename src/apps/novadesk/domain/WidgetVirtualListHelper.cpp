@@ -0,0 +1,113 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "WidgetVirtualListHelper.h"
+#include "Widget.h"
+#include "../core/VirtualList.h"
+#include "../scripting/quickjs/engine/JSEngine.h"
+
+void WidgetVirtualListHelper::SetVirtualList(Widget& widget, const std::wstring& id, const Config& config)
+{
+    if (id.empty())
+        return;
+
+    State& state = widget.m_VirtualLists[id];
+    // Item geometry changed: every visible slot has to be re-laid out and
+    // rebound, so park every slot but keep its elements for reuse.
+    for (size_t slot = 0; slot < state.slots.size(); ++slot)
+    {
+        state.slots[slot] = -1;
+        if (Element* item = widget.FindElementById(GetItemId(id, static_cast<int>(slot))))
+            item->SetShow(false);
+    }
+    state.config = config;
+    Update(widget, id);
+}
+
+bool WidgetVirtualListHelper::TryGetVirtualList(const Widget& widget, const std::wstring& id, Config& config)
+{
+    auto it = widget.m_VirtualLists.find(id);
+    if (it == widget.m_VirtualLists.end())
+        return false;
+
+    config = it->second.config;
+    return true;
+}
+
+void WidgetVirtualListHelper::RemoveVirtualList(Widget& widget, const std::wstring& id)
+{
+    widget.m_VirtualLists.erase(id);
+}
+
+std::wstring WidgetVirtualListHelper::GetItemId(const std::wstring& listId, int slot)
+{
+    return listId + L".slot" + std::to_wstring(slot);
+}
+
+void WidgetVirtualListHelper::Update(Widget& widget, const std::wstring& id)
+{
+    auto it = widget.m_VirtualLists.find(id);
+    if (it == widget.m_VirtualLists.end() || it->second.updating)
+        return;
+
+    Element* container = widget.FindElementById(id);
+    if (!container)
+        return;
+
+    // The viewport is the container's laid-out size.
+    widget.FlushLayout();
+    const Config config = it->second.config;
+    const GfxRect bounds = container->GetBounds();
+    const int offset = config.horizontal ? container->GetScrollX() : container->GetScrollY();
+    const int viewport = config.horizontal ? bounds.Width : bounds.Height;
+    const VirtualList::Range range = VirtualList::VisibleRange(
+        offset, viewport, config.itemCount, config.itemSize, config.gap, config.overscan);
+
+    std::vector<VirtualList::SlotUpdate> updates;
+    VirtualList::AssignSlots(range, it->second.slots, updates);
+    if (updates.empty())
+        return;
+
+    // Callbacks run script that may add elements, set properties or even
+    // replace this list; hold the redraw and guard against re-entry.
+    it->second.updating = true;
+    widget.m_IsBatchUpdating++;
+
+    for (const VirtualList::SlotUpdate& update : updates)
+    {
+        if (!update.created)
+            continue;
+        JSEngine::CallVirtualListCallback(config.onCreateItemCallbackId, &widget, id, update.slot, -1);
+    }
+
+    const int stride = VirtualList::Stride(config.itemSize, config.gap);
+    for (const VirtualList::SlotUpdate& update : updates)
+    {
+        Element* item = widget.FindElementById(GetItemId(id, update.slot));
+        if (!item)
+            continue;
+
+        if (update.index < 0)
+        {
+            item->SetShow(false);
+            continue;
+        }
+
+        const int pos = update.index * stride;
+        if (config.horizontal)
+            item->SetPosition(pos, item->GetY());
+        else
+            item->SetPosition(item->GetX(), pos);
+        item->SetShow(true);
+        JSEngine::CallVirtualListCallback(config.onBindItemCallbackId, &widget, id, update.slot, update.index);
+    }
+
+    widget.m_IsBatchUpdating--;
+    auto after = widget.m_VirtualLists.find(id);
+    if (after != widget.m_VirtualLists.end())
+        after->second.updating = false;
+}
@@ -0,0 +1,97 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#ifndef __NOVADESK_WIDGET_VIRTUAL_LIST_HELPER_H__
+#define __NOVADESK_WIDGET_VIRTUAL_LIST_HELPER_H__
+
+#include <string>
+#include <vector>
+
+// Forward declaration
+class Widget;
+
+/**
+ * WidgetVirtualListHelper - Pooled rows for long scrolling containers
+ *
+ * A virtual list turns a container into a window over 'itemCount' fixed-size
+ * rows. Only the rows inside the viewport (plus overscan) exist as elements:
+ * the script creates a row's elements once per slot in onCreateItem and fills
+ * them for a given item index in onBindItem. Scrolling the container
+ * (scrollX/scrollY) repositions and rebinds only the slots whose item changed.
+ *
+ * Slot elements must use the id returned by GetItemId() so the helper can
+ * position and hide them.
+ */
+class WidgetVirtualListHelper
+{
+public:
+    struct Config
+    {
+        int itemCount = 0;
+        int itemSize = 0;
+        int gap = 0;
+        int overscan = 2;
+        bool horizontal = false;
+        int onCreateItemCallbackId = -1;
+        int onBindItemCallbackId = -1;
+    };
+
+    struct State
+    {
+        Config config;
+        std::vector<int> slots;
+        bool updating = false;
+    };
+
+    /**
+     * Set (or replace) the virtual list configuration of a container
+     * and bring its slots up to date.
+     * @param widget The widget instance
+     * @param id Container element ID
+     * @param config List configuration
+     */
+    static void SetVirtualList(Widget& widget, const std::wstring& id, const Config& config);
+
+    /**
+     * Try to get the virtual list configuration of a container
+     * @param widget The widget instance
+     * @param id Container element ID
+     * @param config Output parameter for configuration
+     * @return true if the container is a virtual list
+     */
+    static bool TryGetVirtualList(const Widget& widget, const std::wstring& id, Config& config);
+
+    /**
+     * Forget the virtual list state of a container (element removal)
+     * @param widget The widget instance
+     * @param id Container element ID
+     */
+    static void RemoveVirtualList(Widget& widget, const std::wstring& id);
+
+    /**
+     * Recompute the visible range from the container's scroll offset and
+     * size, then create, move, hide and rebind slots as needed.
+     * Does not redraw; callers redraw once afterwards.
+     * @param widget The widget instance
+     * @param id Container element ID
+     */
+    static void Update(Widget& widget, const std::wstring& id);
+
+    /**
+     * Element ID a slot's root element must use
+     * @param listId Container element ID
+     * @param slot Slot number
+     * @return e.g. "list.slot3"
+     */
+    static std::wstring GetItemId(const std::wstring& listId, int slot);
+
+private:
+    // No instances - static utility class
+    WidgetVirtualListHelper() = delete;
+};
+
+#endif // __NOVADESK_WIDGET_VIRTUAL_LIST_HELPER_H__
@@ -11,6 +11,7 @@
 #include <cmath>
 
 #include "AnimationEasing.h"
+#include "AnimationTrack.h"
 #include "ColorUtil.h"
 #include "TextElement.h"
 #include "Widget.h"
@@ -35,58 +36,7 @@ namespace
             ColorUtil::FromFloatRGBA(target.fontColorR, target.fontColorG, target.fontColorB, target.fontAlpha, color, alpha);
             text->SetFontColor(color, alpha);
         }
-    }
-
-    Widget::AnimationTarget SampleTransformAnimationTarget(const Widget::AnimationTarget &from, const Widget::AnimationTarget &to, float p)
-    {
-        Widget::AnimationTarget out{};
-        auto lerp = [p](float a, float b) { return a + (b - a) * p; };
-
-        if (to.hasX) { out.hasX = true; out.x = lerp(from.x, to.x); }
-        if (to.hasY) { out.hasY = true; out.y = lerp(from.y, to.y); }
-        if (to.hasWidth) { out.hasWidth = true; out.width = lerp(from.width, to.width); }
-        if (to.hasHeight) { out.hasHeight = true; out.height = lerp(from.height, to.height); }
-        if (to.hasRotate) { out.hasRotate = true; out.rotate = lerp(from.rotate, to.rotate); }
-        return out;
-    }
-
-    Widget::AnimationTarget SampleAnimationTarget(const Widget::AnimationTarget &from, const Widget::AnimationTarget &to, float p)
-    {
-        Widget::AnimationTarget out = SampleTransformAnimationTarget(from, to, p);
-        auto lerp = [p](float a, float b) { return a + (b - a) * p; };
-
-        if (to.hasFontSize) { out.hasFontSize = true; out.fontSize = lerp(from.fontSize, to.fontSize); }
-        if (to.hasFontWeight) { out.hasFontWeight = true; out.fontWeight = lerp(from.fontWeight, to.fontWeight); }
-        if (to.hasLetterSpacing) { out.hasLetterSpacing = true; out.letterSpacing = lerp(from.letterSpacing, to.letterSpacing); }
-        if (to.hasFontColor)
-        {
-            out.hasFontColor = true;
-            out.fontColorR = lerp(from.fontColorR, to.fontColorR);
-            out.fontColorG = lerp(from.fontColorG, to.fontColorG);
-            out.fontColorB = lerp(from.fontColorB, to.fontColorB);
-            out.fontAlpha = lerp(from.fontAlpha, to.fontAlpha);
-        }
-        return out;
-    }
-
-    void MergeAnimationTarget(Widget::AnimationTarget &base, const Widget::AnimationTarget &patch)
-    {
-        if (patch.hasX) { base.hasX = true; base.x = patch.x; }
-        if (patch.hasY) { base.hasY = true; base.y = patch.y; }
-        if (patch.hasWidth) { base.hasWidth = true; base.width = patch.width; }
-        if (patch.hasHeight) { base.hasHeight = true; base.height = patch.height; }
-        if (patch.hasRotate) { base.hasRotate = true; base.rotate = patch.rotate; }
-        if (patch.hasFontSize) { base.hasFontSize = true; base.fontSize = patch.fontSize; }
-        if (patch.hasFontWeight) { base.hasFontWeight = true; base.fontWeight = patch.fontWeight; }
-        if (patch.hasLetterSpacing) { base.hasLetterSpacing = true; base.letterSpacing = patch.letterSpacing; }
-        if (patch.hasFontColor)
-        {
-            base.hasFontColor = true;
-            base.fontColorR = patch.fontColorR;
-            base.fontColorG = patch.fontColorG;
-            base.fontColorB = patch.fontColorB;
-            base.fontAlpha = patch.fontAlpha;
-        }
+        text->InvalidateRender();
     }
 
     Widget::AnimationTarget CaptureElementAnimationState(Element *element)
@@ -125,52 +75,6 @@ namespace
         return state;
     }
 
-    void ResolveKeyframeStops(
-        Element *element,
-        const std::vector<Widget::AnimationKeyframe> &keyframes,
-        std::vector<float> &offsets,
-        std::vector<std::wstring> &easings,
-        std::vector<Widget::AnimationTarget> &resolved)
-    {
-        offsets.clear();
-        easings.clear();
-        resolved.clear();
-        if (keyframes.empty())
-            return;
-
-        Widget::AnimationTarget carry = CaptureElementAnimationState(element);
-        Widget::AnimationTarget unionMask{};
-
-        for (const Widget::AnimationKeyframe &kf : keyframes)
-            MergeAnimationTarget(unionMask, kf.values);
-
-        for (const Widget::AnimationKeyframe &kf : keyframes)
-        {
-            MergeAnimationTarget(carry, kf.values);
-            Widget::AnimationTarget stop{};
-            if (unionMask.hasX) { stop.hasX = true; stop.x = carry.x; }
-            if (unionMask.hasY) { stop.hasY = true; stop.y = carry.y; }
-            if (unionMask.hasWidth) { stop.hasWidth = true; stop.width = carry.width; }
-            if (unionMask.hasHeight) { stop.hasHeight = true; stop.height = carry.height; }
-            if (unionMask.hasRotate) { stop.hasRotate = true; stop.rotate = carry.rotate; }
-            if (unionMask.hasFontSize) { stop.hasFontSize = true; stop.fontSize = carry.fontSize; }
-            if (unionMask.hasFontWeight) { stop.hasFontWeight = true; stop.fontWeight = carry.fontWeight; }
-            if (unionMask.hasLetterSpacing) { stop.hasLetterSpacing = true; stop.letterSpacing = carry.letterSpacing; }
-            if (unionMask.hasFontColor)
-            {
-                stop.hasFontColor = true;
-                stop.fontColorR = carry.fontColorR;
-                stop.fontColorG = carry.fontColorG;
-                stop.fontColorB = carry.fontColorB;
-                stop.fontAlpha = carry.fontAlpha;
-            }
-
-            offsets.push_back(kf.offset);
-            easings.push_back(kf.easing);
-            resolved.push_back(stop);
-        }
-    }
-
     void ApplyAnimationTargetToElement(Element *element, const Widget::AnimationTarget &target)
     {
         if (!element)
@@ -191,39 +95,6 @@ namespace
         if (element->GetType() == ELEMENT_TEXT)
             ApplyTextAnimationTarget(static_cast<TextElement *>(element), target);
     }
-
-    Widget::AnimationTarget SampleKeyframeTrack(
-        const std::vector<float> &offsets,
-        const std::vector<std::wstring> &easings,
-        const std::vector<Widget::AnimationTarget> &stops,
-        float t,
-        const std::wstring &defaultEasing)
-    {
-        if (offsets.empty() || stops.empty())
-            return Widget::AnimationTarget{};
-
-        if (t <= offsets.front())
-            return stops.front();
-        if (t >= offsets.back())
-            return stops.back();
-
-        for (size_t i = 0; i + 1 < offsets.size(); ++i)
-        {
-            if (t < offsets[i + 1])
-            {
-                const float span = offsets[i + 1] - offsets[i];
-                float u = span > 0.0f ? (t - offsets[i]) / span : 0.0f;
-                if (u < 0.0f) u = 0.0f;
-                if (u > 1.0f) u = 1.0f;
-                std::wstring segmentEasing = defaultEasing;
-                if (i + 1 < easings.size() && !easings[i + 1].empty())
-                    segmentEasing = easings[i + 1];
-                const float p = AnimationEasing::Evaluate(u, segmentEasing);
-                return SampleAnimationTarget(stops[i], stops[i + 1], p);
-            }
-        }
-        return stops.back();
-    }
 }
 
 void WidgetAnimationHelper::StartElementAnimation(
@@ -348,7 +219,7 @@ void WidgetAnimationHelper::StartElementKeyframeAnimation(
         std::sort(sorted.begin(), sorted.end(), [](const Widget::AnimationKeyframe &a, const Widget::AnimationKeyframe &b)
                   { return a.offset < b.offset; });
 
-        ResolveKeyframeStops(element, sorted, anim.keyframeOffsets, anim.keyframeEasings, anim.resolvedStops);
+        AnimationTrack::ResolveKeyframeStops(CaptureElementAnimationState(element), sorted, anim.keyframeOffsets, anim.keyframeEasings, anim.resolvedStops);
         if (anim.resolvedStops.empty())
             return;
 
@@ -392,11 +263,11 @@ void WidgetAnimationHelper::StepAnimations(Widget &widget)
 
             Widget::AnimationTarget sampled{};
             if (it->useKeyframes)
-                sampled = SampleKeyframeTrack(it->keyframeOffsets, it->keyframeEasings, it->resolvedStops, t, it->easing);
+                sampled = AnimationTrack::SampleKeyframes(it->keyframeOffsets, it->keyframeEasings, it->resolvedStops, t, it->easing);
             else
             {
                 const float p = AnimationEasing::Evaluate(t, it->easing);
-                sampled = SampleTransformAnimationTarget(it->from, it->to, p);
+                sampled = AnimationTrack::SampleTransform(it->from, it->to, p);
             }
 
             ApplyAnimationTargetToElement(element, sampled);
@@ -22,11 +22,12 @@ public:
     virtual bool HitTestLocal(const D2D1_POINT_2F& point) override;
     virtual bool CreateGeometry(ID2D1Factory* factory, Microsoft::WRL::ComPtr<ID2D1Geometry>& geometry) const override;
     
-    virtual void SetRadii(float rx, float ry) override { m_RadiusX = rx; m_RadiusY = ry; }
+    virtual void SetRadii(float rx, float ry) override { m_RadiusX = rx; m_RadiusY = ry; InvalidateGeometry(); }
     virtual void SetArcParams(float startAngle, float endAngle, bool clockwise) override {
         m_StartAngle = startAngle;
         m_EndAngle = endAngle;
         m_Clockwise = clockwise;
+        InvalidateGeometry();
     }
     virtual float GetRadiusX() const override { return m_RadiusX; }
     virtual float GetRadiusY() const override { return m_RadiusY; }
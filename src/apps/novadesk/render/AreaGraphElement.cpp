@@ -7,11 +7,16 @@
 
 #include "AreaGraphElement.h"
 #include "Direct2DHelper.h"
+#include "../core/SeriesMath.h"
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 
 namespace
 {
+    // How far back SetData looks for the previous data when the graph scrolls.
+    const size_t kMaxScrollSamples = 1024;
+
     float DistancePointToSegment(const D2D1_POINT_2F &p, const D2D1_POINT_2F &a, const D2D1_POINT_2F &b)
     {
         const float vx = b.x - a.x;
@@ -71,6 +76,8 @@ AreaGraphElement::AreaGraphElement(const std::wstring &id, int x, int y, int w,
 
 void AreaGraphElement::SetData(const std::vector<float> &data)
 {
+    std::vector<float> previous;
+    previous.swap(m_Data);
     if (m_MaxPoints > 0 && data.size() > (size_t)m_MaxPoints)
     {
         m_Data.assign(data.end() - m_MaxPoints, data.end());
@@ -79,6 +86,91 @@ void AreaGraphElement::SetData(const std::vector<float> &data)
     {
         m_Data = data;
     }
+
+    size_t dropped = 0;
+    if (m_Summary.Size() == previous.size() &&
+        SeriesMath::FindScroll(previous.data(), previous.size(), m_Data.data(), m_Data.size(), kMaxScrollSamples, dropped))
+    {
+        if (dropped == 0 && m_Data.size() == previous.size())
+            return;
+        m_Summary.Scroll(m_Data.data(), m_Data.size(), dropped);
+    }
+    else
+    {
+        m_Summary.Assign(m_Data.data(), m_Data.size());
+    }
+    m_DrawIndicesValid = false;
+}
+
+const std::vector<size_t> &AreaGraphElement::GetDrawIndices(float drawWidth)
+{
+    // Sample i sits at left + offset + i * spacing whichever side the graph
+    // starts on (the older samples are merely mirrored).
+    const int numPoints = (int)m_Data.size();
+    const int capacity = (m_MaxPoints > numPoints) ? m_MaxPoints : numPoints;
+    const float spacing = (capacity > 1) ? drawWidth / (float)(capacity - 1) : 0.0f;
+    const float offset = drawWidth - (float)(numPoints - 1) * spacing;
+
+    if (m_DrawIndicesValid && m_DrawDecimation == m_Decimation && m_DrawOffset == offset && m_DrawSpacing == spacing)
+        return m_DrawIndices;
+
+    switch (m_Decimation)
+    {
+    case SeriesDecimation::MinMax:
+        m_Summary.DecimateMinMax(m_Data.data(), offset, spacing, m_DrawIndices);
+        break;
+    case SeriesDecimation::Lttb:
+    {
+        const size_t columns = (size_t)((float)(numPoints - 1) * spacing) + 1;
+        SeriesMath::DecimateLttb(m_Data.data(), m_Data.size(), columns * 2, m_DrawIndices);
+        break;
+    }
+    default:
+        m_DrawIndices.resize(m_Data.size());
+        for (size_t i = 0; i < m_Data.size(); ++i)
+            m_DrawIndices[i] = i;
+        break;
+    }
+
+    m_DrawIndicesValid = true;
+    m_DrawDecimation = m_Decimation;
+    m_DrawOffset = offset;
+    m_DrawSpacing = spacing;
+    return m_DrawIndices;
+}
+
+void AreaGraphElement::BuildPoints(float left, float top, float right, float bottom, std::vector<D2D1_POINT_2F> &points)
+{
+    points.clear();
+    if (m_Data.empty())
+        return;
+
+    float minV = 0.0f;
+    float maxV = 1.0f;
+    BuildAutoRange(minV, maxV);
+    const float range = maxV - minV;
+
+    const int numPoints = (int)m_Data.size();
+    const int capacity = (m_MaxPoints > numPoints) ? m_MaxPoints : numPoints;
+    const float drawWidth = right - left;
+    const float drawHeight = bottom - top;
+    const float dx = (capacity > 1) ? drawWidth / (float)(capacity - 1) : 0.0f;
+
+    const std::vector<size_t> &indices = GetDrawIndices(drawWidth);
+    points.reserve(indices.size());
+    for (size_t index : indices)
+    {
+        const int i = (int)index;
+        float val = m_Data[index];
+        float norm = (range <= 0.000001f) ? 0.0f : (val - minV) / range;
+        if (norm < 0.0f) norm = 0.0f;
+        if (norm > 1.0f) norm = 1.0f;
+
+        float px = m_GraphStartLeft ? (left + (float)(numPoints - 1 - i) * dx) : (right - (float)(numPoints - 1 - i) * dx);
+        float py = !m_Flip ? (bottom - norm * drawHeight) : (top + norm * drawHeight);
+
+        points.push_back(D2D1::Point2F(px, py));
+    }
 }
 
 void AreaGraphElement::Render(ID2D1DeviceContext *context)
@@ -135,105 +227,73 @@ void AreaGraphElement::Render(ID2D1DeviceContext *context)
     }
 
     // 2. Plot Data
-    if (!m_Data.empty())
+    BuildPoints(left, top, right, bottom, m_PointScratch);
+    if (m_PointScratch.size() >= 2)
     {
-        float minV = 0.0f;
-        float maxV = 1.0f;
-        BuildAutoRange(minV, maxV);
-        const float range = maxV - minV;
-
-        const int numPoints = (int)m_Data.size();
-        std::vector<D2D1_POINT_2F> points;
-        points.reserve(numPoints);
-
-        const float drawWidth  = right - left;
-        const float drawHeight = bottom - top;
-
-        for (int i = 0; i < numPoints; ++i)
+        const bool samePoints = m_Points.size() == m_PointScratch.size() &&
+                                std::memcmp(m_Points.data(), m_PointScratch.data(), m_Points.size() * sizeof(D2D1_POINT_2F)) == 0;
+        if (!samePoints || !m_FillGeometry || !m_LineGeometry)
         {
-            float val = m_Data[i];
-            float norm = (range <= 0.000001f) ? 0.0f : (val - minV) / range;
-            if (norm < 0.0f) norm = 0.0f;
-            if (norm > 1.0f) norm = 1.0f;
-
-            int capacity = (m_MaxPoints > numPoints) ? m_MaxPoints : numPoints;
-            float dx = (capacity > 1) ? drawWidth / (float)(capacity - 1) : 0.0f;
-
-            float px = m_GraphStartLeft ? (left + (float)(numPoints - 1 - i) * dx) : (right - (float)(numPoints - 1 - i) * dx);
-            float py = !m_Flip ? (bottom - norm * drawHeight) : (top + norm * drawHeight);
+            m_Points.swap(m_PointScratch);
+            m_FillGeometry.Reset();
+            m_LineGeometry.Reset();
+
+            ID2D1Factory1 *factory = Direct2D::GetFactory();
+            Microsoft::WRL::ComPtr<ID2D1PathGeometry> geometry;
+            Microsoft::WRL::ComPtr<ID2D1GeometrySink> sink;
+            if (factory && SUCCEEDED(factory->CreatePathGeometry(geometry.GetAddressOf())) && SUCCEEDED(geometry->Open(sink.GetAddressOf())))
+            {
+                // Area Fill Path
+                sink->BeginFigure(D2D1::Point2F(m_Points[0].x, bottom), D2D1_FIGURE_BEGIN_FILLED);
+                sink->AddLines(m_Points.data(), (UINT32)m_Points.size());
+                sink->AddLine(D2D1::Point2F(m_Points.back().x, bottom));
+                sink->EndFigure(D2D1_FIGURE_END_CLOSED);
+                if (SUCCEEDED(sink->Close()))
+                    m_FillGeometry = geometry;
+            }
 
-            points.push_back(D2D1::Point2F(px, py));
+            // Top Line Path (separately to ensure clean stroke)
+            geometry.Reset();
+            sink.Reset();
+            if (factory && SUCCEEDED(factory->CreatePathGeometry(geometry.GetAddressOf())) && SUCCEEDED(geometry->Open(sink.GetAddressOf())))
+            {
+                sink->BeginFigure(m_Points[0], D2D1_FIGURE_BEGIN_HOLLOW);
+                sink->AddLines(m_Points.data() + 1, (UINT32)(m_Points.size() - 1));
+                sink->EndFigure(D2D1_FIGURE_END_OPEN);
+                if (SUCCEEDED(sink->Close()))
+                    m_LineGeometry = geometry;
+            }
         }
 
-        if (points.size() >= 2)
+        if (m_FillGeometry)
         {
-            Microsoft::WRL::ComPtr<ID2D1Factory> factory;
-            context->GetFactory(factory.GetAddressOf());
-            if (factory)
+            Microsoft::WRL::ComPtr<ID2D1Brush> fillBrush;
+            Direct2D::CreateBrushFromGradientOrColor(
+                context,
+                elementRect,
+                &m_FillGradient,
+                m_FillColor,
+                m_FillAlpha / 255.0f,
+                fillBrush.GetAddressOf());
+            if (fillBrush)
             {
-                Microsoft::WRL::ComPtr<ID2D1PathGeometry> geometry;
-                if (SUCCEEDED(factory->CreatePathGeometry(geometry.GetAddressOf())))
-                {
-                    Microsoft::WRL::ComPtr<ID2D1GeometrySink> sink;
-                    if (SUCCEEDED(geometry->Open(sink.GetAddressOf())))
-                    {
-                        // Area Fill Path
-                        sink->BeginFigure(D2D1::Point2F(points[0].x, bottom), D2D1_FIGURE_BEGIN_FILLED);
-                        for (const auto &p : points)
-                        {
-                            sink->AddLine(p);
-                        }
-                        sink->AddLine(D2D1::Point2F(points.back().x, bottom));
-                        sink->EndFigure(D2D1_FIGURE_END_CLOSED);
-                        sink->Close();
-
-                        // Draw Fill
-                        Microsoft::WRL::ComPtr<ID2D1Brush> fillBrush;
-                        Direct2D::CreateBrushFromGradientOrColor(
-                            context,
-                            elementRect,
-                            &m_FillGradient,
-                            m_FillColor,
-                            m_FillAlpha / 255.0f,
-                            fillBrush.GetAddressOf());
-                        if (fillBrush)
-                        {
-                            context->FillGeometry(geometry.Get(), fillBrush.Get());
-                        }
-                    }
-                }
+                context->FillGeometry(m_FillGeometry.Get(), fillBrush.Get());
+            }
+        }
 
-                // Top Line Path (separately to ensure clean stroke)
-                {
-                    Microsoft::WRL::ComPtr<ID2D1PathGeometry> lineGeom;
-                    if (SUCCEEDED(factory->CreatePathGeometry(lineGeom.GetAddressOf())))
-                    {
-                        Microsoft::WRL::ComPtr<ID2D1GeometrySink> sink;
-                        if (SUCCEEDED(lineGeom->Open(sink.GetAddressOf())))
-                        {
-                            sink->BeginFigure(points[0], D2D1_FIGURE_BEGIN_HOLLOW);
-                            for (size_t i = 1; i < points.size(); ++i)
-                            {
-                                sink->AddLine(points[i]);
-                            }
-                            sink->EndFigure(D2D1_FIGURE_END_OPEN);
-                            sink->Close();
-
-                            Microsoft::WRL::ComPtr<ID2D1Brush> lineBrush;
-                            Direct2D::CreateBrushFromGradientOrColor(
-                                context,
-                                elementRect,
-                                &m_LineGradient,
-                                m_LineColor,
-                                1.0f,
-                                lineBrush.GetAddressOf());
-                            if (lineBrush)
-                            {
-                                context->DrawGeometry(lineGeom.Get(), lineBrush.Get(), m_LineWidth);
-                            }
-                        }
-                    }
-                }
+        if (m_LineGeometry)
+        {
+            Microsoft::WRL::ComPtr<ID2D1Brush> lineBrush;
+            Direct2D::CreateBrushFromGradientOrColor(
+                context,
+                elementRect,
+                &m_LineGradient,
+                m_LineColor,
+                1.0f,
+                lineBrush.GetAddressOf());
+            if (lineBrush)
+            {
+                context->DrawGeometry(m_LineGeometry.Get(), lineBrush.Get(), m_LineWidth);
             }
         }
     }
@@ -297,31 +357,9 @@ bool AreaGraphElement::HitTest(int x, int y)
     if (m_Data.empty())
         return false;
 
-    float minV = 0.0f;
-    float maxV = 1.0f;
-    BuildAutoRange(minV, maxV);
-    const float range = maxV - minV;
-
-    const int numPoints = static_cast<int>(m_Data.size());
+    // Same plot rectangle as Render(), so both share the decimated samples.
     std::vector<D2D1_POINT_2F> points;
-    points.reserve(static_cast<size_t>(numPoints));
-
-    for (int i = 0; i < numPoints; ++i)
-    {
-        float val = m_Data[static_cast<size_t>(i)];
-        float norm = (range <= 0.000001f) ? 0.0f : (val - minV) / range;
-        if (norm < 0.0f)
-            norm = 0.0f;
-        if (norm > 1.0f)
-            norm = 1.0f;
-
-        int capacity = (m_MaxPoints > numPoints) ? m_MaxPoints : numPoints;
-        float dx = (capacity > 1) ? (width - 1.0f) / static_cast<float>(capacity - 1) : 0.0f;
-
-        float px = m_GraphStartLeft ? (left + static_cast<float>(numPoints - 1 - i) * dx) : (right - static_cast<float>(numPoints - 1 - i) * dx);
-        float py = !m_Flip ? (bottom - norm * (height - 1.0f)) : (top + norm * (height - 1.0f));
-        points.push_back(D2D1::Point2F(px, py));
-    }
+    BuildPoints(left, top, (float)(m_X + GetWidth()) - 1.0f - m_PaddingRight, (float)(m_Y + GetHeight()) - 1.0f - m_PaddingBottom, points);
 
     const D2D1_POINT_2F p = D2D1::Point2F(targetX, targetY);
     const bool fillVisible = (m_FillAlpha > 0) || (m_FillGradient.type != GRADIENT_NONE);
@@ -360,21 +398,15 @@ bool AreaGraphElement::BuildAutoRange(float &outMin, float &outMax) const
         return true;
     }
 
-    if (m_Data.empty())
+    float minV = 0.0f;
+    float maxV = 0.0f;
+    if (!m_Summary.MinMax(minV, maxV))
     {
         outMin = 0.0f;
         outMax = 1.0f;
         return false;
     }
 
-    float minV = m_Data[0];
-    float maxV = m_Data[0];
-    for (float v : m_Data)
-    {
-        if (v < minV) minV = v;
-        if (v > maxV) maxV = v;
-    }
-
     if (fabsf(maxV - minV) < 0.000001f)
     {
         outMin = minV - 0.5f;
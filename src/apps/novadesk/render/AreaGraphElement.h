@@ -9,6 +9,7 @@
 #define __NOVADESK_AREA_GRAPH_ELEMENT_H__
 
 #include "Element.h"
+#include "../core/SeriesSummary.h"
 #include <vector>
 
 class AreaGraphElement : public Element
@@ -67,8 +68,14 @@ public:
     void SetFlip(bool flip) { m_Flip = flip; }
     bool GetFlip() const { return m_Flip; }
 
+    void SetDecimation(SeriesDecimation decimation) { m_Decimation = decimation; }
+    SeriesDecimation GetDecimation() const { return m_Decimation; }
+
 private:
     bool BuildAutoRange(float &outMin, float &outMax) const;
+    // Samples to plot for a plot area drawWidth pixels wide; see LineElement.
+    const std::vector<size_t> &GetDrawIndices(float drawWidth);
+    void BuildPoints(float left, float top, float right, float bottom, std::vector<D2D1_POINT_2F> &points);
 
 private:
     std::vector<float> m_Data;
@@ -95,6 +102,20 @@ private:
 
     bool m_GraphStartLeft = false; // newest on the right
     bool m_Flip = false;
+    SeriesDecimation m_Decimation = SeriesDecimation::MinMax;
+
+    // Follows m_Data incrementally; the fill and line geometries are rebuilt
+    // only when the plotted points change.
+    SeriesSummary m_Summary;
+    std::vector<size_t> m_DrawIndices;
+    bool m_DrawIndicesValid = false;
+    SeriesDecimation m_DrawDecimation = SeriesDecimation::MinMax;
+    float m_DrawOffset = 0.0f;
+    float m_DrawSpacing = 0.0f;
+    std::vector<D2D1_POINT_2F> m_Points;
+    std::vector<D2D1_POINT_2F> m_PointScratch;
+    Microsoft::WRL::ComPtr<ID2D1PathGeometry> m_FillGeometry;
+    Microsoft::WRL::ComPtr<ID2D1PathGeometry> m_LineGeometry;
 };
 
 #endif
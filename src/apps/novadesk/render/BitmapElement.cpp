@@ -172,8 +172,11 @@ void BitmapElement::Render(ID2D1DeviceContext *context)
 
     RenderBackground(context);
 
-    Microsoft::WRL::ComPtr<ID2D1Image> finalImage;
-    if (!m_BitmapImage.BuildProcessedImage(context, finalImage) || !finalImage)
+    // The strip with tint/colour matrix applied is cached by the image, so
+    // every frame (or digit) below is a sub-rectangle blit of the same bitmap.
+    float opacity = 1.0f;
+    ID2D1Bitmap *frames = m_BitmapImage.GetProcessedBitmap(context, opacity);
+    if (!frames)
     {
         RenderBevel(context);
         RestoreRenderTransform(context, originalTransform);
@@ -182,7 +185,6 @@ void BitmapElement::Render(ID2D1DeviceContext *context)
 
     const int contentX = m_X + m_PaddingLeft;
     const int contentY = m_Y + m_PaddingTop;
-    const float opacity = m_BitmapImage.GetImageAlpha() / 255.0f;
     const D2D1_BITMAP_INTERPOLATION_MODE interp = m_AntiAlias ? D2D1_BITMAP_INTERPOLATION_MODE_LINEAR : D2D1_BITMAP_INTERPOLATION_MODE_NEAREST_NEIGHBOR;
 
     if (m_Extend)
@@ -233,18 +235,7 @@ void BitmapElement::Render(ID2D1DeviceContext *context)
             const float digitX = startX + static_cast<float>(i) * (frameWidth + static_cast<float>(spacing));
             const D2D1_RECT_F dstRect = D2D1::RectF(digitX, static_cast<float>(contentY), digitX + frameWidth, static_cast<float>(contentY) + frameHeight);
 
-            if (finalImage.Get() == static_cast<ID2D1Image *>(bitmap))
-            {
-                context->DrawBitmap(bitmap, &dstRect, opacity, interp, &srcRect);
-            }
-            else
-            {
-                D2D1_MATRIX_3X2_F effectTransform;
-                context->GetTransform(&effectTransform);
-                context->SetTransform(D2D1::Matrix3x2F::Translation(dstRect.left, dstRect.top) * effectTransform);
-                context->DrawImage(finalImage.Get(), nullptr, &srcRect, m_AntiAlias ? D2D1_INTERPOLATION_MODE_LINEAR : D2D1_INTERPOLATION_MODE_NEAREST_NEIGHBOR);
-                context->SetTransform(effectTransform);
-            }
+            context->DrawBitmap(frames, &dstRect, opacity, interp, &srcRect);
         }
     }
     else
@@ -272,18 +263,7 @@ void BitmapElement::Render(ID2D1DeviceContext *context)
             static_cast<float>(contentX) + frameWidth,
             static_cast<float>(contentY) + frameHeight);
 
-        if (finalImage.Get() == static_cast<ID2D1Image *>(bitmap))
-        {
-            context->DrawBitmap(bitmap, &dstRect, opacity, interp, &srcRect);
-        }
-        else
-        {
-            D2D1_MATRIX_3X2_F effectTransform;
-            context->GetTransform(&effectTransform);
-            context->SetTransform(D2D1::Matrix3x2F::Translation(dstRect.left, dstRect.top) * effectTransform);
-            context->DrawImage(finalImage.Get(), nullptr, &srcRect, m_AntiAlias ? D2D1_INTERPOLATION_MODE_LINEAR : D2D1_INTERPOLATION_MODE_NEAREST_NEIGHBOR);
-            context->SetTransform(effectTransform);
-        }
+        context->DrawBitmap(frames, &dstRect, opacity, interp, &srcRect);
     }
 
     RenderBevel(context);
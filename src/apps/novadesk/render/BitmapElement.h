@@ -27,6 +27,7 @@ public:
     virtual void Render(ID2D1DeviceContext *context) override;
     virtual int GetAutoWidth() override;
     virtual int GetAutoHeight() override;
+    virtual size_t GetImageMemoryBytes() const override { return m_BitmapImage.GetMemoryBytes(); }
 
     virtual void OnOwnerHWNDSet() override;
     virtual void OnImageDownloaded(const std::wstring& url, const std::vector<BYTE>& buffer) override;
@@ -31,6 +31,7 @@ public:
 
     virtual int GetAutoWidth() override;
     virtual int GetAutoHeight() override;
+    virtual size_t GetImageMemoryBytes() const override { return m_ButtonImage.GetMemoryBytes(); }
 
     virtual void OnOwnerHWNDSet() override;
     virtual void OnImageDownloaded(const std::wstring& url, const std::vector<BYTE>& buffer) override;
@@ -72,7 +73,12 @@ public:
     float GetImageCropH() const { return m_ButtonImage.GetImageCropH(); }
     ImageCropOrigin GetImageCropOrigin() const { return m_ButtonImage.GetImageCropOrigin(); }
 
-    void SetButtonState(ButtonState state) { m_State = state; }
+    void SetButtonState(ButtonState state) {
+        if (state == m_State)
+            return;
+        m_State = state;
+        InvalidateRender();
+    }
     ButtonState GetButtonState() const { return m_State; }
 
 protected:
@@ -31,6 +31,7 @@ public:
         m_EndX = endX;
         m_EndY = endY;
         m_IsCubic = (_wcsicmp(curveType.c_str(), L"cubic") == 0);
+        InvalidateGeometry();
     }
 
     virtual float GetStartX() const override { return m_StartX; }
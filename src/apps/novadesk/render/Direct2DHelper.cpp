@@ -8,6 +8,7 @@
 #include "Direct2DHelper.h"
 #include "../shared/Logging.h"
 #include "../shared/PathUtils.h"
+#include "../core/PerfCounters.h"
 #include <cmath>
 #include <cstring>
 #include <vector>
@@ -24,6 +25,26 @@ namespace Direct2D
 
     namespace
     {
+        /*
+        ** Times one decode and counts it as a load or a failure depending on
+        ** whether the output bitmap was produced.
+        */
+        class ImageLoadScope
+        {
+        public:
+            explicit ImageLoadScope(IWICBitmap **wicBitmap)
+                : m_Timer(PerfCounters::Histogram::ImageLoadTime), m_WicBitmap(wicBitmap) {}
+            ~ImageLoadScope()
+            {
+                const bool loaded = m_WicBitmap && *m_WicBitmap;
+                PerfCounters::Increment(loaded ? PerfCounters::Counter::ImageLoads : PerfCounters::Counter::ImageLoadFailures);
+            }
+
+        private:
+            PerfCounters::ScopedTimer m_Timer;
+            IWICBitmap **m_WicBitmap;
+        };
+
         WICBitmapTransformOptions ExifOrientationToWicTransform(USHORT orientation)
         {
             switch (orientation)
@@ -270,6 +291,7 @@ namespace Direct2D
             return LoadWICBitmapFromURL(path, wicBitmap, useExifOrientation);
         }
 
+        ImageLoadScope loadScope(wicBitmap);
         ComPtr<IWICBitmapDecoder> pDecoder;
         HRESULT hr = g_pWICFactory->CreateDecoderFromFilename(path.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnLoad, pDecoder.GetAddressOf());
         if (FAILED(hr)) return false;
@@ -477,6 +499,7 @@ namespace Direct2D
         }
 
         // Create stream from memory
+        ImageLoadScope loadScope(wicBitmap);
         ComPtr<IWICStream> pStream;
         HRESULT hr = g_pWICFactory->CreateStream(pStream.GetAddressOf());
         if (FAILED(hr))
@@ -617,6 +640,7 @@ namespace Direct2D
     {
         if (!g_pWICFactory) return false;
 
+        ImageLoadScope loadScope(wicBitmap);
         HRSRC hResInfo = FindResourceW(hModule, resourceName, resourceType);
         if (!hResInfo)
         {
@@ -661,6 +685,8 @@ namespace Direct2D
     {
         if (!g_pWICFactory || !data || size == 0) return false;
 
+        ImageLoadScope loadScope(wicBitmap);
+
         ComPtr<IWICStream> pStream;
         HRESULT hr = g_pWICFactory->CreateStream(pStream.GetAddressOf());
         if (FAILED(hr)) return false;
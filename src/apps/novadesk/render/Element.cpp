@@ -9,6 +9,20 @@
 #include "../shared/Logging.h"
 #include "Direct2DHelper.h"
 #include <algorithm>
+#include <unordered_map>
+
+namespace
+{
+    // Live elements and their generation. Elements are only created and
+    // deleted on the UI thread.
+    std::unordered_map<const Element*, uint64_t>& LiveElements()
+    {
+        static std::unordered_map<const Element*, uint64_t> live;
+        return live;
+    }
+
+    uint64_t s_NextGeneration = 1;
+}
 
 Element::Element(ElementType type, const std::wstring& id, int x, int y, int width, int height)
     : m_Type(type), m_Id(id), m_X(x), m_Y(y)
@@ -18,6 +32,28 @@ Element::Element(ElementType type, const std::wstring& id, int x, int y, int wid
     m_WDefined = (width > 0);
     m_HDefined = (height > 0);
     m_ToolTipDisabled = false;
+    m_Generation = s_NextGeneration++;
+    LiveElements()[this] = m_Generation;
+}
+
+Element::~Element()
+{
+    LiveElements().erase(this);
+}
+
+Element* ElementHandle::Get() const
+{
+    if (!m_Element)
+        return nullptr;
+    const auto& live = LiveElements();
+    auto it = live.find(m_Element);
+    return (it != live.end() && it->second == m_Generation) ? m_Element : nullptr;
+}
+
+Element* ElementHandle::Get(const void* widget) const
+{
+    Element* element = Get();
+    return (element && element->GetOwnerWidget() == widget) ? element : nullptr;
 }
 
 /*
@@ -36,6 +72,72 @@ int Element::GetHeight() {
     return h + m_PaddingTop + m_PaddingBottom;
 }
 
+/*
+** Apply a size assigned by the flex parent, remembering the declared one.
+*/
+bool Element::SetLayoutSize(int w, int h)
+{
+    const int oldWidth = m_Width;
+    const int oldHeight = m_Height;
+    const bool oldWDefined = m_WDefined;
+    const bool oldHDefined = m_HDefined;
+
+    if (!m_Declared.saved)
+    {
+        m_Declared.width = m_Width;
+        m_Declared.height = m_Height;
+        m_Declared.wDefined = m_WDefined;
+        m_Declared.hDefined = m_HDefined;
+    }
+
+    m_Width = (w >= 0) ? std::max(0, w - m_PaddingLeft - m_PaddingRight) : m_Declared.width;
+    m_WDefined = (w >= 0) ? true : m_Declared.wDefined;
+    m_Height = (h >= 0) ? std::max(0, h - m_PaddingTop - m_PaddingBottom) : m_Declared.height;
+    m_HDefined = (h >= 0) ? true : m_Declared.hDefined;
+    m_Declared.saved = (w >= 0 || h >= 0);
+    InvalidateContainerIndex();
+    const bool changed = m_Width != oldWidth || m_Height != oldHeight || m_WDefined != oldWDefined || m_HDefined != oldHDefined;
+    if (changed)
+        InvalidateRender();
+    return changed;
+}
+
+/*
+** Measure the element for its flex parent: the declared size, or the auto
+** size where none was declared, plus padding. Same as GetWidth()/GetHeight()
+** except that a size assigned by the parent is ignored.
+*/
+void Element::MeasureForLayout(int& w, int& h)
+{
+    if (!m_LayoutMeasure.valid)
+    {
+        const bool saved = m_Declared.saved;
+        const bool wDefined = saved ? m_Declared.wDefined : m_WDefined;
+        const bool hDefined = saved ? m_Declared.hDefined : m_HDefined;
+        const int width = wDefined ? (saved ? m_Declared.width : m_Width) : GetAutoWidth();
+        const int height = hDefined ? (saved ? m_Declared.height : m_Height) : GetAutoHeight();
+        m_LayoutMeasure.width = width + m_PaddingLeft + m_PaddingRight;
+        m_LayoutMeasure.height = height + m_PaddingTop + m_PaddingBottom;
+        m_LayoutMeasure.valid = true;
+    }
+    w = m_LayoutMeasure.width;
+    h = m_LayoutMeasure.height;
+}
+
+int Element::GetSpecifiedWidth() const
+{
+    if (m_Declared.saved)
+        return m_Declared.wDefined ? m_Declared.width : 0;
+    return m_WDefined ? m_Width : 0;
+}
+
+int Element::GetSpecifiedHeight() const
+{
+    if (m_Declared.saved)
+        return m_Declared.hDefined ? m_Declared.height : 0;
+    return m_HDefined ? m_Height : 0;
+}
+
 /*
 ** Get the bounding box of the element.
 */
@@ -50,6 +152,15 @@ GfxRect Element::GetBackgroundBounds() {
     return GetBounds();
 }
 
+GfxRect Element::GetVisualBounds() {
+    GfxRect bounds = GetBackgroundBounds();
+    if (m_BevelType != 0 && m_BevelWidth > 0) {
+        // RenderBevel strokes a rect 2px outside the bounds.
+        bounds = bounds.Inflate(2 + m_BevelWidth);
+    }
+    return bounds;
+}
+
 /*
 ** Check if a point is within the element's bounds.
 */
@@ -173,16 +284,23 @@ void Element::SetPadding(int left, int top, int right, int bottom) {
     m_PaddingTop = top;
     m_PaddingRight = right;
     m_PaddingBottom = bottom;
+    m_LayoutMeasure.valid = false;
+    InvalidateContainerIndex();
+    InvalidateRender();
 }
 
 void Element::RemoveContainerItem(Element* item)
 {
     m_ContainerItems.erase(std::remove(m_ContainerItems.begin(), m_ContainerItems.end(), item), m_ContainerItems.end());
+    m_ChildIndex.dirty = true;
+    InvalidateRender();
 }
 
 void Element::ClearContainerItems()
 {
     m_ContainerItems.clear();
+    m_ChildIndex.dirty = true;
+    InvalidateRender();
 }
 
 /*
@@ -11,19 +11,13 @@
 #include <windows.h>
 #include <objidl.h>
 #include <d2d1_1.h>
+#include <wrl/client.h>
+#include <cstdint>
 #include <string>
 #include <vector>
 
-// Helper macros for color extraction from COLORREF (0x00BBGGRR)
-#ifndef GetRValue
-#define GetRValue(rgb)      (LOBYTE(rgb))
-#endif
-#ifndef GetGValue
-#define GetGValue(rgb)      (LOBYTE((WORD)(rgb) >> 8))
-#endif
-#ifndef GetBValue
-#define GetBValue(rgb)      (LOBYTE((rgb) >> 16))
-#endif
+#include "../core/GraphicsTypes.h"
+#include "../core/SpanIndex.h"
 
 enum ElementType
 {
@@ -42,39 +36,6 @@ enum ElementType
     ELEMENT_INPUT_BOX
 };
 
-struct GfxRect {
-    int X, Y, Width, Height;
-    GfxRect() : X(0), Y(0), Width(0), Height(0) {}
-    GfxRect(int x, int y, int w, int h) : X(x), Y(y), Width(w), Height(h) {}
-};
-
-struct TextShadow {
-    float offsetX = 0;
-    float offsetY = 0;
-    float blur = 0;
-    COLORREF color = 0;
-    BYTE alpha = 255;
-};
-
-struct GradientStop {
-    COLORREF color;
-    BYTE alpha;
-    float position;
-};
-
-enum GradientType {
-    GRADIENT_NONE,
-    GRADIENT_LINEAR,
-    GRADIENT_RADIAL
-};
-
-struct GradientInfo {
-    GradientType type = GRADIENT_NONE;
-    std::vector<GradientStop> stops;
-    float angle = 0.0f; // For linear
-    std::wstring shape = L"circle"; // For radial
-};
-
 enum TextCase {
     TEXT_CASE_NORMAL,
     TEXT_CASE_UPPER,
@@ -87,10 +48,16 @@ class Element
 {
 public:
     Element(ElementType type, const std::wstring& id, int x, int y, int width, int height);
-    virtual ~Element() {}
+    virtual ~Element();
 
     virtual void Render(ID2D1DeviceContext* context) = 0;
 
+    // Unique per element for the lifetime of the process, never reused.
+    uint64_t GetGeneration() const { return m_Generation; }
+    // Widget the element was added to; lets a handle check ownership.
+    void SetOwnerWidget(const void* widget) { m_OwnerWidget = widget; }
+    const void* GetOwnerWidget() const { return m_OwnerWidget; }
+
     ElementType GetType() const { return m_Type; }
     const std::wstring& GetId() const { return m_Id; }
     int GetX() const { return m_X; }
@@ -102,16 +69,110 @@ public:
     bool IsWDefined() const { return m_WDefined; }
     bool IsHDefined() const { return m_HDefined; }
 
-    void SetPosition(int x, int y) { m_X = x; m_Y = y; }
+    // A move repaints the container but not the element itself, so a cached
+    // element (cacheAsBitmap) keeps its bitmap while it slides around.
+    void SetPosition(int x, int y) {
+        if (x == m_X && y == m_Y)
+            return;
+        m_X = x;
+        m_Y = y;
+        InvalidateContainerIndex();
+        if (m_ContainerElement)
+            m_ContainerElement->InvalidateRender();
+    }
     void SetSize(int w, int h) { 
         m_Width = w; 
         m_Height = h; 
         m_WDefined = (w > 0);
         m_HDefined = (h > 0);
+        m_Declared.saved = false;
+        m_LayoutMeasure.valid = false;
+        InvalidateContainerIndex();
+        InvalidateRender();
+    }
+
+    // Size assigned by a flex parent (stretch/grow/shrink) as an outer size
+    // including padding; < 0 puts that axis back to its declared size.
+    // Unlike SetSize() the declared size is kept for MeasureForLayout().
+    // Returns true if the content size changed.
+    bool SetLayoutSize(int w, int h);
+    bool HasLayoutSize() const { return m_Declared.saved; }
+    // Outer size the element asks its flex parent for, ignoring any size the
+    // parent assigned. Cached until InvalidateLayoutMeasure().
+    void MeasureForLayout(int& w, int& h);
+    void InvalidateLayoutMeasure() { m_LayoutMeasure.valid = false; }
+    // Declared content size, 0 when auto (property round trips).
+    int GetSpecifiedWidth() const;
+    int GetSpecifiedHeight() const;
+
+    // Flex item properties; basis < 0 means the measured size.
+    void SetFlexItem(float grow, float shrink, int basis) {
+        m_FlexGrow = grow;
+        m_FlexShrink = shrink;
+        m_FlexBasis = basis;
+        m_LayoutMeasure.valid = false;
+    }
+    float GetFlexGrow() const { return m_FlexGrow; }
+    float GetFlexShrink() const { return m_FlexShrink; }
+    int GetFlexBasis() const { return m_FlexBasis; }
+
+    // Layout container queued for reflow (WidgetLayoutHelper).
+    void SetLayoutDirty(bool dirty) { m_LayoutDirty = dirty; }
+    bool IsLayoutDirty() const { return m_LayoutDirty; }
+
+    // Render revision of the element and everything below it. Anything that
+    // changes what the element paints must call InvalidateRender(), which also
+    // bumps every ancestor; a cached subtree is reused only while its
+    // revision is unchanged. An auto-sized element may also have changed its
+    // bounds, so its parent's child index rechecks it before the next query.
+    void InvalidateRender() {
+        for (Element* element = this; element; element = element->m_ContainerElement)
+        {
+            ++element->m_RenderRevision;
+            if (element->m_ContainerElement && (!element->m_WDefined || !element->m_HDefined))
+            {
+                element->m_AutoBoundsStale = true;
+                element->m_ContainerElement->m_ChildIndex.recheck = true;
+            }
+        }
+    }
+    uint32_t GetRenderRevision() const { return m_RenderRevision; }
+
+    // cacheAsBitmap: once the subtree has been unchanged for a few frames it
+    // is rasterised into a bitmap and composited from that until invalidated.
+    void SetCacheAsBitmap(bool enabled) {
+        m_CacheAsBitmap = enabled;
+        if (!enabled)
+            ReleaseRenderCache();
+    }
+    bool GetCacheAsBitmap() const { return m_CacheAsBitmap; }
+
+    // Elements that repaint without a property change (caret blink, typing)
+    // keep their subtree out of the bitmap cache.
+    virtual bool IsRenderVolatile() const { return false; }
+
+    // Bitmap retained for cacheAsBitmap (see WidgetLayoutHelper::RenderElement).
+    struct RenderCache {
+        Microsoft::WRL::ComPtr<ID2D1Device> device;
+        Microsoft::WRL::ComPtr<ID2D1Bitmap> bitmap;
+        uint32_t revision = 0;
+        int stableFrames = 0;
+        // Cached region relative to the element position, so moves reuse it.
+        int offsetX = 0;
+        int offsetY = 0;
+        int width = 0;
+        int height = 0;
+    };
+    RenderCache& GetRenderCache() { return m_RenderCache; }
+    void ReleaseRenderCache() { m_RenderCache.bitmap.Reset(); m_RenderCache.device.Reset(); }
+    size_t GetRenderCacheBytes() const {
+        return m_RenderCache.bitmap ? (size_t)m_RenderCache.width * (size_t)m_RenderCache.height * 4 : 0;
     }
 
     virtual int GetAutoWidth() { return 0; }
     virtual int GetAutoHeight() { return 0; }
+    // Bytes held by decoded image data (diagnostics only).
+    virtual size_t GetImageMemoryBytes() const { return 0; }
 
     void SetOwnerHWND(HWND hWnd)
     {
@@ -125,6 +186,8 @@ public:
 
     virtual GfxRect GetBounds();
     virtual GfxRect GetBackgroundBounds();
+    // Everything the element may paint (bevel, shadows); used for culling.
+    virtual GfxRect GetVisualBounds();
 
     virtual bool HitTest(int x, int y);
 
@@ -160,7 +223,7 @@ public:
     
     void SetPadding(int left, int top, int right, int bottom);
 
-    void SetRotate(float angle) { m_Rotate = angle; }
+    void SetRotate(float angle) { m_Rotate = angle; InvalidateContainerIndex(); InvalidateRender(); }
     float GetRotate() const { return m_Rotate; }
 
     void SetTransformMatrix(const float* matrix) {
@@ -170,6 +233,8 @@ public:
         } else {
             m_HasTransformMatrix = false;
         }
+        InvalidateContainerIndex();
+        InvalidateRender();
     }
     bool HasTransformMatrix() const { return m_HasTransformMatrix; }
     const float* GetTransformMatrix() const { return m_TransformMatrix; }
@@ -197,7 +262,7 @@ public:
 
     bool GetAntiAlias() const { return m_AntiAlias; }
 
-    void SetShow(bool show) { m_Show = show; }
+    void SetShow(bool show) { m_Show = show; InvalidateContainerIndex(); InvalidateRender(); }
     bool IsVisible() const { return m_Show; }
 
     void SetContainerId(const std::wstring& id) { m_ContainerId = id; }
@@ -214,12 +279,38 @@ public:
     Element* GetContainer() const { return m_ContainerElement; }
     bool IsContained() const { return m_ContainerElement != nullptr; }
 
-    void AddContainerItem(Element* item) { m_ContainerItems.push_back(item); }
+    void AddContainerItem(Element* item) { m_ContainerItems.push_back(item); m_ChildIndex.dirty = true; InvalidateRender(); }
     void RemoveContainerItem(Element* item);
     void ClearContainerItems();
     const std::vector<Element*>& GetContainerItems() const { return m_ContainerItems; }
     bool IsContainer() const { return !m_ContainerItems.empty(); }
 
+    // Offset of the container's content; children are drawn and hit-tested
+    // shifted by (-scrollX, -scrollY).
+    void SetScroll(int x, int y) {
+        if (x == m_ScrollX && y == m_ScrollY)
+            return;
+        m_ScrollX = x;
+        m_ScrollY = y;
+        InvalidateRender();
+    }
+    int GetScrollX() const { return m_ScrollX; }
+    int GetScrollY() const { return m_ScrollY; }
+
+    // Children indexed along the container's main scroll axis, rebuilt by
+    // WidgetLayoutHelper when a child moves, resizes, or is added/removed.
+    struct ChildIndex {
+        SpanIndex spans;
+        std::vector<SpanIndex::Span> indexed; // span of each item when built
+        bool vertical = true;
+        bool dirty = true;
+        bool recheck = false; // some auto-sized item may have changed size
+    };
+    ChildIndex& GetChildIndex() { return m_ChildIndex; }
+    void InvalidateChildIndex() { m_ChildIndex.dirty = true; }
+    // Set by InvalidateRender() on auto-sized elements; cleared by the parent's index.
+    bool TakeAutoBoundsStale() { const bool stale = m_AutoBoundsStale; m_AutoBoundsStale = false; return stale; }
+
     virtual bool IsTransparentHit() const { return false; }
 
     bool HasAction(UINT message, WPARAM wParam) const;
@@ -315,6 +406,9 @@ protected:
     std::wstring m_CursorsDir;
     Element* m_ContainerElement = nullptr;
     std::vector<Element*> m_ContainerItems;
+    ChildIndex m_ChildIndex;
+    int m_ScrollX = 0;
+    int m_ScrollY = 0;
     
     // Padding properties
     int m_PaddingLeft = 0;
@@ -322,6 +416,37 @@ protected:
     int m_PaddingRight = 0;
     int m_PaddingBottom = 0;
 
+    // Flex item properties
+    float m_FlexGrow = 0.0f;
+    float m_FlexShrink = 0.0f;
+    int m_FlexBasis = -1;
+
+    // Declared size, saved while a flex parent has assigned one
+    struct DeclaredSize
+    {
+        bool saved = false;
+        int width = 0;
+        int height = 0;
+        bool wDefined = false;
+        bool hDefined = false;
+    };
+    DeclaredSize m_Declared;
+
+    struct LayoutMeasure
+    {
+        bool valid = false;
+        int width = 0;
+        int height = 0;
+    };
+    LayoutMeasure m_LayoutMeasure;
+    bool m_LayoutDirty = false;
+    bool m_AutoBoundsStale = false;
+
+    // Retained rendering
+    uint32_t m_RenderRevision = 1;
+    bool m_CacheAsBitmap = false;
+    RenderCache m_RenderCache;
+
     // Transformation properties
     float m_Rotate = 0.0f;
     bool m_HasTransformMatrix = false;
@@ -340,9 +465,36 @@ protected:
     void RenderBevel(ID2D1DeviceContext* context);
     void ApplyRenderTransform(ID2D1DeviceContext* context, D2D1_MATRIX_3X2_F& originalTransform);
     void RestoreRenderTransform(ID2D1DeviceContext* context, const D2D1_MATRIX_3X2_F& originalTransform);
+    void InvalidateContainerIndex() { if (m_ContainerElement) m_ContainerElement->InvalidateChildIndex(); }
 
 protected:
     HWND m_OwnerHWND = nullptr;
+
+private:
+    uint64_t m_Generation = 0;
+    const void* m_OwnerWidget = nullptr;
+};
+
+/*
+** Weak reference to an element. Get() returns nullptr once the element has
+** been deleted, even if a new element is later allocated at the same address,
+** so handles can be held across script callbacks and between messages.
+*/
+class ElementHandle
+{
+public:
+    ElementHandle() = default;
+    ElementHandle(Element* element)
+        : m_Element(element), m_Generation(element ? element->GetGeneration() : 0) {}
+
+    Element* Get() const;
+    // As Get(), but also nullptr unless the element belongs to 'widget'.
+    Element* Get(const void* widget) const;
+    void Reset() { m_Element = nullptr; m_Generation = 0; }
+
+private:
+    Element* m_Element = nullptr;
+    uint64_t m_Generation = 0;
 };
 
 #endif
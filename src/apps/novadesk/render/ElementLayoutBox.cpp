@@ -21,96 +21,49 @@ ElementLayoutBox::ElementLayoutBox(const std::wstring& id, int x, int y, int wid
 
 int ElementLayoutBox::GetAutoWidth()
 {
-    // If width is explicitly defined, use it
-    if (m_WDefined)
-        return m_Width;
-    
     // Calculate auto width based on children and layout direction
     // NOTE: Do NOT include padding here - Element::GetWidth() will add it
-    const auto& children = GetContainerItems();
-    if (children.empty())
-        return 0; // Element::GetWidth() will add padding
-    
-    // Parse flex direction to determine layout
-    std::wstring flexDir = m_FlexDirection;
-    std::transform(flexDir.begin(), flexDir.end(), flexDir.begin(), ::towlower);
-    const bool isHorizontal = (flexDir == L"row" || flexDir == L"rowreverse");
-    
-    int contentWidth = 0;
-    
-    if (isHorizontal)
-    {
-        // Horizontal layout (row): sum all children widths + gaps
-        for (size_t i = 0; i < children.size(); ++i)
-        {
-            Element* child = children[i];
-            if (!child) continue;
-            contentWidth += child->GetWidth();
-            
-            // Add gap between items (not after last item)
-            if (i < children.size() - 1)
-                contentWidth += m_LayoutGap;
-        }
-    }
-    else
-    {
-        // Vertical layout (column): use maximum child width
-        for (Element* child : children)
-        {
-            if (!child) continue;
-            contentWidth = std::max(contentWidth, child->GetWidth());
-        }
-    }
-    
-    // Return content width WITHOUT padding (Element::GetWidth() adds it)
-    return contentWidth;
+    int width = 0;
+    int height = 0;
+    MeasureChildren(width, height);
+    return width;
 }
 
 int ElementLayoutBox::GetAutoHeight()
 {
-    // If height is explicitly defined, use it
-    if (m_HDefined)
-        return m_Height;
-    
     // Calculate auto height based on children and layout direction
     // NOTE: Do NOT include padding here - Element::GetHeight() will add it
+    int width = 0;
+    int height = 0;
+    MeasureChildren(width, height);
+    return height;
+}
+
+void ElementLayoutBox::MeasureChildren(int& width, int& height)
+{
+    width = 0;
+    height = 0;
     const auto& children = GetContainerItems();
     if (children.empty())
-        return 0; // Element::GetHeight() will add padding
-    
-    // Parse flex direction to determine layout
-    std::wstring flexDir = m_FlexDirection;
-    std::transform(flexDir.begin(), flexDir.end(), flexDir.begin(), ::towlower);
-    const bool isHorizontal = (flexDir == L"row" || flexDir == L"rowreverse");
-    
-    int contentHeight = 0;
-    
-    if (isHorizontal)
+        return;
+
+    std::vector<FlexLayoutItem> items;
+    items.reserve(children.size());
+    for (Element* child : children)
     {
-        // Horizontal layout (row): use maximum child height
-        for (Element* child : children)
-        {
-            if (!child) continue;
-            contentHeight = std::max(contentHeight, child->GetHeight());
-        }
+        if (!child) continue;
+        FlexLayoutItem item;
+        child->MeasureForLayout(item.width, item.height);
+        item.basis = child->GetFlexBasis();
+        items.push_back(item);
     }
-    else
-    {
-        // Vertical layout (column): sum all children heights + gaps
-        for (size_t i = 0; i < children.size(); ++i)
-        {
-            Element* child = children[i];
-            if (!child) continue;
-            contentHeight += child->GetHeight();
-            
-            // Add gap between items (not after last item)
-            if (i < children.size() - 1)
-                contentHeight += m_LayoutGap;
-        }
-    }
-    
-    // Return content height WITHOUT padding (Element::GetHeight() adds it)
-    return contentHeight;
+
+    // Wrapping needs a bounded main axis: only a box whose main size is known
+    // can grow along the cross axis line by line.
+    const bool isHorizontal = FlexLayout::IsHorizontal(m_FlexConfig.flexDirection);
+    const bool mainDefined = isHorizontal ? m_WDefined : m_HDefined;
+    const int innerMain = mainDefined ? (isHorizontal ? m_Width : m_Height) : -1;
+    FlexLayout::MeasureContent(m_FlexConfig, innerMain, items, width, height);
 }
 
 bool ElementLayoutBox::HitTestLocal(const D2D1_POINT_2F& point)
@@ -166,6 +119,22 @@ GfxRect ElementLayoutBox::GetBackgroundBounds()
     return GetBounds();
 }
 
+GfxRect ElementLayoutBox::GetVisualBounds()
+{
+    GfxRect visual = ShapeElement::GetVisualBounds();
+    const GfxRect bounds = GetBounds();
+    for (const BoxShadow& shadow : m_BoxShadows)
+    {
+        if (shadow.inset)
+            continue;
+        // The shadow effect blurs with a standard deviation of 'blur'.
+        const int reach = (int)std::ceil(std::max(0.0f, shadow.blur) * 3.0f + std::fabs(shadow.spread)) + 1;
+        const GfxRect cast((int)std::floor(bounds.X + shadow.x), (int)std::floor(bounds.Y + shadow.y), bounds.Width + 1, bounds.Height + 1);
+        visual = visual.Union(cast.Inflate(reach));
+    }
+    return visual;
+}
+
 void ElementLayoutBox::Render(ID2D1DeviceContext* context)
 {
     D2D1_MATRIX_3X2_F originalTransform;
@@ -9,6 +9,7 @@
 
 #include "BoxBorderPaint.h"
 #include "ShapeElement.h"
+#include "../core/FlexLayout.h"
 
 class ElementLayoutBox : public ShapeElement
 {
@@ -62,11 +63,12 @@ public:
     bool HitTestLocal(const D2D1_POINT_2F &point) override;
     bool CreateGeometry(ID2D1Factory *factory, Microsoft::WRL::ComPtr<ID2D1Geometry> &geometry) const override;
     GfxRect GetBackgroundBounds() override;
+    GfxRect GetVisualBounds() override;
 
     int GetAutoWidth() override;
     int GetAutoHeight() override;
 
-    void SetRadii(float rx, float ry) override { m_RadiusX = rx; m_RadiusY = ry; }
+    void SetRadii(float rx, float ry) override { m_RadiusX = rx; m_RadiusY = ry; InvalidateGeometry(); }
     float GetRadiusX() const override { return m_RadiusX; }
     float GetRadiusY() const override { return m_RadiusY; }
     void SetBoxShadows(const std::vector<BoxShadow> &shadows) { m_BoxShadows = shadows; }
@@ -93,11 +95,9 @@ public:
     void SetListStyleType(ListStyleType type) { m_ListMarker.type = type; }
     ListStyleType GetListStyleType() const { return m_ListMarker.type; }
 
-    // Set layout configuration for auto-sizing calculations
-    void SetLayoutDirection(const std::wstring& flexDir) { m_FlexDirection = flexDir; }
-    void SetLayoutGap(int gap) { m_LayoutGap = gap; }
-    const std::wstring& GetLayoutDirection() const { return m_FlexDirection; }
-    int GetLayoutGap() const { return m_LayoutGap; }
+    // Layout configuration for auto-sizing calculations
+    void SetFlexConfig(const FlexLayoutConfig& config) { m_FlexConfig = config; InvalidateLayoutMeasure(); }
+    const FlexLayoutConfig& GetFlexConfig() const { return m_FlexConfig; }
 
 private:
     void RenderSingleShadow(ID2D1DeviceContext *context, const D2D1_ROUNDED_RECT &baseRect, const BoxShadow &shadow);
@@ -106,6 +106,7 @@ private:
                           float markerCenterX, float markerCenterY, float markerSize,
                           ID2D1SolidColorBrush *brush);
     BoxBorderPaintParams BuildBorderPaintParams() const;
+    void MeasureChildren(int& width, int& height);
 
     float m_RadiusX = 0.0f;
     float m_RadiusY = 0.0f;
@@ -116,6 +117,5 @@ private:
     BorderStyle m_BorderStyleLeft = BorderStyle::Solid;
     DisplayType m_DisplayType = DisplayType::Flex;
     ListMarker m_ListMarker;
-    std::wstring m_FlexDirection = L"row";
-    int m_LayoutGap = 0;
+    FlexLayoutConfig m_FlexConfig;
 };
@@ -9,29 +9,16 @@
 #define __NOVADESK_FLEX_LAYOUT_ENGINE_H__
 
 #include <string>
+#include <vector>
 #include "Element.h"
-
-/**
- * Configuration for flexbox layout
- */
-struct FlexLayoutConfig
-{
-    std::wstring direction = L"ltr";        // "ltr" | "rtl" - Text directionality
-    std::wstring flexDirection = L"row";    // "row" | "rowreverse" | "column" | "columnreverse"
-    int gap = 0;                            // Gap between items
-    std::wstring align = L"start";          // "normal" | "stretch" | "center" | "start" | "end" | "flexstart" | "flexend"
-    std::wstring justify = L"start";        // "start" | "center" | "end" - main axis alignment
-    int paddingLeft = 0;
-    int paddingTop = 0;
-    int paddingRight = 0;
-    int paddingBottom = 0;
-};
+#include "../core/FlexLayout.h"
 
 /**
  * FlexLayoutEngine - Implements CSS Flexbox layout algorithm
  * 
  * This engine handles positioning and sizing of child elements within a flex container
- * according to CSS Flexbox specification rules.
+ * according to CSS Flexbox specification rules. The arithmetic lives in FlexLayout
+ * (core library); this class maps elements to and from FlexLayoutItem.
  */
 class FlexLayoutEngine
 {
@@ -39,10 +26,14 @@ public:
     /**
      * Apply flexbox layout to a container and its children
      * 
+     * Children are measured with Element::MeasureForLayout() (cached) and
+     * sized with Element::SetLayoutSize(), so their declared sizes survive.
+     *
      * @param container The container element to layout
      * @param config The flexbox configuration (direction, alignment, gaps, etc.)
+     * @param resizedChildren Optional output: children whose size changed
      */
-    static void ApplyLayout(Element* container, const FlexLayoutConfig& config);
+    static void ApplyLayout(Element* container, const FlexLayoutConfig& config, std::vector<Element*>* resizedChildren = nullptr);
 
 private:
     // No instances - static utility class
@@ -8,8 +8,10 @@
 #include "GeneralImage.h"
 
 #include "Direct2DHelper.h"
+#include "ImageStore.h"
 #include "../shared/Logging.h"
 #include "../shared/PathUtils.h"
+#include "../core/PerfCounters.h"
 #include "../Resource.h"
 
 #include <algorithm>
@@ -31,6 +33,13 @@ GeneralImage::GeneralImage()
 void GeneralImage::ResetBitmapCache()
 {
     m_D2DBitmap.Reset();
+    m_EffectImage.Reset();
+    m_EffectColor.Reset();
+    m_EffectSource.Reset();
+    m_ProcessedBitmap.Reset();
+    m_ProcessedSource.Reset();
+    m_AlphaMask.Clear();
+    m_AlphaMaskSource.Reset();
 }
 
 void GeneralImage::ReloadWICBitmap()
@@ -39,6 +48,15 @@ void GeneralImage::ReloadWICBitmap()
     if (m_LoadedPath.empty())
         return;
 
+    if (!m_DownloadedBuffer.empty())
+    {
+        Direct2D::LoadWICBitmapFromMemory(
+            m_DownloadedBuffer.data(),
+            static_cast<DWORD>(m_DownloadedBuffer.size()),
+            m_pWICBitmap.ReleaseAndGetAddressOf());
+        return;
+    }
+
     const bool ok = Direct2D::LoadWICBitmapFromFile(m_LoadedPath, m_pWICBitmap.ReleaseAndGetAddressOf(), m_UseExifOrientation);
     if (!ok)
     {
@@ -105,6 +123,21 @@ void GeneralImage::SetPath(const std::wstring &path)
             StartAsyncDownload(path);
         }
     }
+    else if (PathUtils::IsMemoryPath(path))
+    {
+        // Bytes an addon put in the image store; decoded like a download.
+        auto stored = ImageStore::Get(path);
+        if (stored)
+        {
+            m_DownloadedBuffer = *stored;
+            ReloadWICBitmap();
+        }
+        else
+        {
+            Logging::Log(LogLevel::Error, L"[novadesk] image not in memory store: %s", path.c_str());
+            LoadFallbackFromResource();
+        }
+    }
     else
     {
         ReloadWICBitmap();
@@ -235,22 +268,40 @@ void GeneralImage::OnImageDownloaded(const std::wstring& url, const std::vector<
 
 void GeneralImage::SetImageTint(COLORREF color, BYTE alpha)
 {
+    if (m_ImageTint == color && m_ImageTintAlpha == alpha && m_HasImageTint == (alpha > 0))
+        return;
+
     m_ImageTint = color;
     m_ImageTintAlpha = alpha;
     m_HasImageTint = (alpha > 0);
+    ++m_EffectRevision;
+}
+
+void GeneralImage::SetGrayscale(bool enable)
+{
+    if (m_Grayscale == enable)
+        return;
+
+    m_Grayscale = enable;
+    ++m_EffectRevision;
 }
 
 void GeneralImage::SetColorMatrix(const float *matrix)
 {
     if (matrix)
     {
+        if (m_HasColorMatrix && memcmp(m_ColorMatrix.data(), matrix, sizeof(float) * 20) == 0)
+            return;
         memcpy(m_ColorMatrix.data(), matrix, sizeof(float) * 20);
         m_HasColorMatrix = true;
     }
     else
     {
+        if (!m_HasColorMatrix)
+            return;
         m_HasColorMatrix = false;
     }
+    ++m_EffectRevision;
 }
 
 void GeneralImage::SetUseExifOrientation(bool enabled)
@@ -368,7 +419,7 @@ bool GeneralImage::BuildFlipTransform(const D2D1_RECT_F &dstRect, D2D1_MATRIX_3X
     return true;
 }
 
-bool GeneralImage::BuildProcessedImage(ID2D1DeviceContext *context, Microsoft::WRL::ComPtr<ID2D1Image> &outImage) const
+bool GeneralImage::BuildProcessedImage(ID2D1DeviceContext *context, Microsoft::WRL::ComPtr<ID2D1Image> &outImage)
 {
     if (!context || !m_D2DBitmap)
         return false;
@@ -380,6 +431,60 @@ bool GeneralImage::BuildProcessedImage(ID2D1DeviceContext *context, Microsoft::W
         return true;
     }
 
+    if (!m_EffectImage || m_EffectSource != m_D2DBitmap || m_EffectContext != context ||
+        m_EffectImageRevision != m_EffectRevision)
+    {
+        m_EffectImage.Reset();
+        m_EffectColor.Reset();
+        BuildEffectChain(context, true, m_EffectImage, &m_EffectColor);
+        m_EffectSource = m_D2DBitmap;
+        m_EffectContext = context;
+        m_EffectImageRevision = m_EffectRevision;
+        m_EffectImageAlpha = m_ImageAlpha;
+        PerfCounters::Increment(PerfCounters::Counter::ImageEffectBuilds);
+    }
+    else if (m_EffectImageAlpha != m_ImageAlpha)
+    {
+        if (m_EffectColor)
+            m_EffectColor->SetValue(D2D1_COLORMATRIX_PROP_COLOR_MATRIX, BuildEffectMatrix(true));
+        m_EffectImageAlpha = m_ImageAlpha;
+    }
+
+    outImage = m_EffectImage;
+    return true;
+}
+
+D2D1_MATRIX_5X4_F GeneralImage::BuildEffectMatrix(bool applyAlpha) const
+{
+    D2D1_MATRIX_5X4_F matrix = D2D1::Matrix5x4F(
+        1.0f, 0.0f, 0.0f, 0.0f,
+        0.0f, 1.0f, 0.0f, 0.0f,
+        0.0f, 0.0f, 1.0f, 0.0f,
+        0.0f, 0.0f, 0.0f, 1.0f,
+        0.0f, 0.0f, 0.0f, 0.0f);
+
+    if (m_HasColorMatrix)
+    {
+        memcpy(&matrix, m_ColorMatrix.data(), sizeof(float) * 20);
+    }
+    else
+    {
+        if (m_HasImageTint)
+        {
+            matrix.m[0][0] = GetRValue(m_ImageTint) / 255.0f;
+            matrix.m[1][1] = GetGValue(m_ImageTint) / 255.0f;
+            matrix.m[2][2] = GetBValue(m_ImageTint) / 255.0f;
+            matrix.m[3][3] = m_ImageTintAlpha / 255.0f;
+        }
+        if (applyAlpha)
+            matrix.m[3][3] *= (m_ImageAlpha / 255.0f);
+    }
+    return matrix;
+}
+
+void GeneralImage::BuildEffectChain(ID2D1DeviceContext *context, bool applyAlpha, Microsoft::WRL::ComPtr<ID2D1Image> &outImage,
+                                    Microsoft::WRL::ComPtr<ID2D1Effect> *colorEffectOut) const
+{
     Microsoft::WRL::ComPtr<ID2D1Image> current = m_D2DBitmap.Get();
 
     if (m_Grayscale)
@@ -402,36 +507,67 @@ bool GeneralImage::BuildProcessedImage(ID2D1DeviceContext *context, Microsoft::W
     Microsoft::WRL::ComPtr<ID2D1Effect> colorEffect;
     if (SUCCEEDED(context->CreateEffect(CLSID_D2D1ColorMatrix, colorEffect.GetAddressOf())))
     {
-        D2D1_MATRIX_5X4_F matrix = D2D1::Matrix5x4F(
-            1.0f, 0.0f, 0.0f, 0.0f,
-            0.0f, 1.0f, 0.0f, 0.0f,
-            0.0f, 0.0f, 1.0f, 0.0f,
-            0.0f, 0.0f, 0.0f, 1.0f,
-            0.0f, 0.0f, 0.0f, 0.0f);
-
-        if (m_HasColorMatrix)
-        {
-            memcpy(&matrix, m_ColorMatrix.data(), sizeof(float) * 20);
-        }
-        else
-        {
-            if (m_HasImageTint)
-            {
-                matrix.m[0][0] = GetRValue(m_ImageTint) / 255.0f;
-                matrix.m[1][1] = GetGValue(m_ImageTint) / 255.0f;
-                matrix.m[2][2] = GetBValue(m_ImageTint) / 255.0f;
-                matrix.m[3][3] = m_ImageTintAlpha / 255.0f;
-            }
-            matrix.m[3][3] *= (m_ImageAlpha / 255.0f);
-        }
-
         colorEffect->SetInput(0, current.Get());
-        colorEffect->SetValue(D2D1_COLORMATRIX_PROP_COLOR_MATRIX, matrix);
+        colorEffect->SetValue(D2D1_COLORMATRIX_PROP_COLOR_MATRIX, BuildEffectMatrix(applyAlpha));
         colorEffect->GetOutput(&current);
+        if (colorEffectOut)
+            *colorEffectOut = colorEffect;
     }
 
     outImage = current;
-    return true;
+}
+
+ID2D1Bitmap *GeneralImage::GetProcessedBitmap(ID2D1DeviceContext *context, float &opacity)
+{
+    opacity = m_ImageAlpha / 255.0f;
+    if (!context || !m_D2DBitmap)
+        return nullptr;
+
+    if (!(m_Grayscale || m_HasImageTint || m_HasColorMatrix))
+    {
+        m_ProcessedBitmap.Reset();
+        m_ProcessedSource.Reset();
+        return m_D2DBitmap.Get();
+    }
+
+    // As in BuildProcessedImage(), a colour matrix replaces the image alpha.
+    if (m_HasColorMatrix)
+        opacity = 1.0f;
+
+    if (m_ProcessedBitmap && m_ProcessedSource == m_D2DBitmap && m_ProcessedRevision == m_EffectRevision)
+        return m_ProcessedBitmap.Get();
+
+    m_ProcessedBitmap.Reset();
+    m_ProcessedSource.Reset();
+
+    Microsoft::WRL::ComPtr<ID2D1BitmapRenderTarget> target;
+    Microsoft::WRL::ComPtr<ID2D1DeviceContext> targetContext;
+    HRESULT hr = context->CreateCompatibleRenderTarget(
+        m_D2DBitmap->GetSize(),
+        m_D2DBitmap->GetPixelSize(),
+        target.GetAddressOf());
+    if (FAILED(hr) || !target || FAILED(target.As(&targetContext)))
+        return nullptr;
+
+    // Effects belong to the context that created them, so the chain is built
+    // on the offscreen target rather than on 'context'.
+    Microsoft::WRL::ComPtr<ID2D1Image> processed;
+    BuildEffectChain(targetContext.Get(), false, processed);
+
+    targetContext->BeginDraw();
+    targetContext->Clear(D2D1::ColorF(0, 0.0f));
+    targetContext->DrawImage(processed.Get());
+    if (FAILED(targetContext->EndDraw()))
+        return nullptr;
+
+    target->GetBitmap(m_ProcessedBitmap.GetAddressOf());
+    if (!m_ProcessedBitmap)
+        return nullptr;
+
+    m_ProcessedSource = m_D2DBitmap;
+    m_ProcessedRevision = m_EffectRevision;
+    PerfCounters::Increment(PerfCounters::Counter::ImageEffectBuilds);
+    return m_ProcessedBitmap.Get();
 }
 
 int GeneralImage::GetAutoWidth() const
@@ -478,27 +614,58 @@ int GeneralImage::GetAutoHeight() const
     return 0;
 }
 
-BYTE GeneralImage::GetPixelAlpha(int x, int y) const
+/*
+** Decoded WIC pixels plus the device bitmap, both 32bpp PBGRA.
+*/
+size_t GeneralImage::GetMemoryBytes() const
+{
+    size_t total = m_DownloadedBuffer.size();
+    if (m_pWICBitmap)
+    {
+        UINT w = 0, h = 0;
+        m_pWICBitmap->GetSize(&w, &h);
+        total += static_cast<size_t>(w) * h * 4;
+    }
+    if (m_D2DBitmap)
+    {
+        const D2D1_SIZE_U size = m_D2DBitmap->GetPixelSize();
+        total += static_cast<size_t>(size.width) * size.height * 4;
+    }
+    if (m_ProcessedBitmap)
+    {
+        const D2D1_SIZE_U size = m_ProcessedBitmap->GetPixelSize();
+        total += static_cast<size_t>(size.width) * size.height * 4;
+    }
+    total += m_AlphaMask.GetMemoryBytes();
+    return total;
+}
+
+void GeneralImage::EnsureAlphaMask() const
 {
+    if (m_AlphaMaskSource == m_pWICBitmap)
+        return;
+
+    m_AlphaMask.Clear();
+    m_AlphaMaskSource = m_pWICBitmap;
     if (!m_pWICBitmap)
-        return 0;
+        return;
 
     UINT width = 0, height = 0;
     m_pWICBitmap->GetSize(&width, &height);
-    if (x < 0 || x >= (int)width || y < 0 || y >= (int)height)
-        return 0;
+    if (width == 0 || height == 0)
+        return;
 
-    Microsoft::WRL::ComPtr<IWICBitmapLock> pLock;
-    WICRect rcLock = { x, y, 1, 1 };
-    if (SUCCEEDED(m_pWICBitmap->Lock(&rcLock, WICBitmapLockRead, pLock.GetAddressOf())))
-    {
-        UINT cbBufferSize = 0;
-        BYTE* pv = nullptr;
-        if (SUCCEEDED(pLock->GetDataPointer(&cbBufferSize, &pv)) && cbBufferSize >= 4)
-        {
-            // 32bppPBGRA format used in Direct2DHelper
-            return pv[3];
-        }
-    }
-    return 0;
+    // 32bppPBGRA format used in Direct2DHelper
+    const UINT stride = width * 4;
+    std::vector<BYTE> pixels(static_cast<size_t>(stride) * height);
+    if (FAILED(m_pWICBitmap->CopyPixels(nullptr, stride, static_cast<UINT>(pixels.size()), pixels.data())))
+        return;
+
+    m_AlphaMask.Build(pixels.data(), static_cast<int>(width), static_cast<int>(height), static_cast<int>(stride));
+}
+
+BYTE GeneralImage::GetPixelAlpha(int x, int y) const
+{
+    EnsureAlphaMask();
+    return m_AlphaMask.Test(x, y) ? 255 : 0;
 }
@@ -17,6 +17,8 @@
 #include <wincodec.h>
 #include <wrl/client.h>
 
+#include "../core/AlphaMask.h"
+
 enum ImageFlipMode
 {
     IMAGE_FLIP_NONE = 0,
@@ -49,7 +51,11 @@ public:
     bool IsLoaded() const { return m_D2DBitmap != nullptr; }
     ID2D1Bitmap *GetBitmap() const { return m_D2DBitmap.Get(); }
     IWICBitmap *GetWICBitmap() const { return m_pWICBitmap.Get(); }
+    size_t GetMemoryBytes() const;
 
+    // 255 if image pixel (x, y) is not fully transparent, 0 otherwise. Reads a
+    // 1-bit mask built once per decoded image (downsampled for very large
+    // images), so per-mouse-move hit tests do not lock the WIC bitmap.
     BYTE GetPixelAlpha(int x, int y) const;
 
     void SetImageTint(COLORREF color, BYTE alpha);
@@ -60,7 +66,7 @@ public:
     void SetImageAlpha(BYTE alpha) { m_ImageAlpha = alpha; }
     BYTE GetImageAlpha() const { return m_ImageAlpha; }
 
-    void SetGrayscale(bool enable) { m_Grayscale = enable; }
+    void SetGrayscale(bool enable);
     bool IsGrayscale() const { return m_Grayscale; }
 
     void SetColorMatrix(const float *matrix);
@@ -86,7 +92,16 @@ public:
     void ApplyFlipToPixel(float &pixelX, float &pixelY, const D2D1_RECT_F &srcRect) const;
     bool BuildFlipTransform(const D2D1_RECT_F &dstRect, D2D1_MATRIX_3X2_F &outTransform) const;
 
-    bool BuildProcessedImage(ID2D1DeviceContext *context, Microsoft::WRL::ComPtr<ID2D1Image> &outImage) const;
+    // Effect graph for grayscale/tint/colour matrix/alpha. The graph is kept
+    // until the bitmap, the context or one of those settings changes; an alpha
+    // change only updates the colour matrix of the existing graph.
+    bool BuildProcessedImage(ID2D1DeviceContext *context, Microsoft::WRL::ComPtr<ID2D1Image> &outImage);
+
+    // Bitmap with grayscale, tint and colour matrix rasterised in. It is kept
+    // until the image or one of those settings changes, so drawing it (or a
+    // frame of it) is a plain blit. 'opacity' receives the image alpha still
+    // to be applied when drawing.
+    ID2D1Bitmap *GetProcessedBitmap(ID2D1DeviceContext *context, float &opacity);
 
     int GetAutoWidth() const;
     int GetAutoHeight() const;
@@ -95,6 +110,10 @@ public:
     void OnImageDownloaded(const std::wstring& url, const std::vector<BYTE>& buffer);
 
 private:
+    D2D1_MATRIX_5X4_F BuildEffectMatrix(bool applyAlpha) const;
+    void BuildEffectChain(ID2D1DeviceContext *context, bool applyAlpha, Microsoft::WRL::ComPtr<ID2D1Image> &outImage,
+                          Microsoft::WRL::ComPtr<ID2D1Effect> *colorEffect = nullptr) const;
+    void EnsureAlphaMask() const;
     void ReloadWICBitmap();
     void ResetBitmapCache();
     void StartAsyncDownload(const std::wstring& url);
@@ -111,6 +130,26 @@ private:
     Microsoft::WRL::ComPtr<IWICBitmap> m_pWICBitmap;
     ID2D1RenderTarget *m_pLastTarget = nullptr;
 
+    // Bumped by the grayscale, tint and colour matrix setters when a value
+    // actually changes; the caches below record the revision they were built at.
+    unsigned int m_EffectRevision = 0;
+
+    Microsoft::WRL::ComPtr<ID2D1Image> m_EffectImage;
+    Microsoft::WRL::ComPtr<ID2D1Effect> m_EffectColor; // last node, carries image alpha
+    Microsoft::WRL::ComPtr<ID2D1Bitmap> m_EffectSource;
+    ID2D1DeviceContext *m_EffectContext = nullptr;
+    unsigned int m_EffectImageRevision = 0;
+    BYTE m_EffectImageAlpha = 255;
+
+    // Processed bitmap excludes image alpha, which is applied as draw opacity,
+    // so fading an image does not rebuild it.
+    Microsoft::WRL::ComPtr<ID2D1Bitmap> m_ProcessedBitmap;
+    Microsoft::WRL::ComPtr<ID2D1Bitmap> m_ProcessedSource; // m_D2DBitmap it was built from
+    unsigned int m_ProcessedRevision = 0;
+
+    mutable AlphaMask m_AlphaMask;
+    mutable Microsoft::WRL::ComPtr<IWICBitmap> m_AlphaMaskSource;
+
     bool m_HasImageTint = false;
     COLORREF m_ImageTint = RGB(0, 0, 0);
     BYTE m_ImageTintAlpha = 255;
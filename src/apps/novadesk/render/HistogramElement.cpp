@@ -7,13 +7,46 @@
 
 #include "HistogramElement.h"
 #include "Direct2DHelper.h"
+#include "../core/SeriesMath.h"
 #include <algorithm>
 
+namespace
+{
+    // How far back SetData looks for the previous data when the graph scrolls.
+    const size_t kMaxScrollSamples = 1024;
+}
+
 HistogramElement::HistogramElement(const std::wstring &id, int x, int y, int w, int h)
     : Element(ELEMENT_HISTOGRAM, id, x, y, w, h)
 {
 }
 
+void HistogramElement::SetSeries(std::vector<float> &stored, SeriesState &state, const std::vector<float> &data)
+{
+    if (stored.empty() && data.empty())
+        return;
+
+    std::vector<float> previous;
+    previous.swap(stored);
+    stored = data;
+
+    size_t dropped = 0;
+    if (state.summary.Size() == previous.size() &&
+        SeriesMath::FindScroll(previous.data(), previous.size(), stored.data(), stored.size(), kMaxScrollSamples, dropped))
+    {
+        if (dropped == 0 && stored.size() == previous.size())
+            return;
+        state.summary.Scroll(stored.data(), stored.size(), dropped);
+        state.appended += stored.size() - (previous.size() - dropped);
+        state.dropped |= dropped > 0;
+    }
+    else
+    {
+        state.summary.Assign(stored.data(), stored.size());
+        state.reset = true;
+    }
+}
+
 bool HistogramElement::BuildAutoRange(float &outMin, float &outMax) const
 {
     if (!m_AutoRange)
@@ -27,25 +60,20 @@ bool HistogramElement::BuildAutoRange(float &outMin, float &outMax) const
     float minV = 0.0f;
     float maxV = 0.0f;
 
-    auto scanSeries = [&](const std::vector<float> &series)
+    auto scanSeries = [&](const SeriesState &state)
     {
-        for (float v : series)
-        {
-            if (!hasValue)
-            {
-                minV = maxV = v;
-                hasValue = true;
-            }
-            else
-            {
-                minV = (std::min)(minV, v);
-                maxV = (std::max)(maxV, v);
-            }
-        }
+        float seriesMin = 0.0f;
+        float seriesMax = 0.0f;
+        if (!state.summary.MinMax(seriesMin, seriesMax))
+            return;
+        minV = hasValue ? (std::min)(minV, seriesMin) : seriesMin;
+        maxV = hasValue ? (std::max)(maxV, seriesMax) : seriesMax;
+        hasValue = true;
     };
 
-    scanSeries(m_PrimaryData);
-    scanSeries(m_SecondaryData);
+    scanSeries(m_PrimaryState);
+    if (!m_SecondaryData.empty())
+        scanSeries(m_SecondaryState);
 
     if (!hasValue)
     {
@@ -76,17 +104,246 @@ float HistogramElement::SampleAtFromNewest(const std::vector<float> &series, int
     return series[static_cast<size_t>(idx)];
 }
 
-float HistogramElement::NormalizeValue(float value, float minValue, float maxValue)
+int HistogramElement::AgeOfColumn(int column, int columns) const
 {
-    const float range = maxValue - minValue;
-    if (range <= 0.000001f)
-        return 0.0f;
-    float n = (value - minValue) / range;
-    if (n < 0.0f)
-        n = 0.0f;
-    if (n > 1.0f)
-        n = 1.0f;
-    return n;
+    // Column u shows the sample that is this many steps older than the newest.
+    if (m_GraphHorizontalOrientation)
+        return m_Flip ? (columns - 1 - column) : column;
+    return m_GraphStartLeft ? column : (columns - 1 - column);
+}
+
+int HistogramElement::TickBar(const std::vector<int> &ring, uint64_t tick) const
+{
+    if (ring.empty() || tick > m_NewestTick || m_NewestTick - tick >= static_cast<uint64_t>(m_Columns))
+        return 0;
+    return ring[static_cast<size_t>(tick % m_TickCapacity)];
+}
+
+void HistogramElement::ComputeTicks(uint64_t firstTick, uint64_t lastTick)
+{
+    const size_t count = static_cast<size_t>(lastTick - firstTick + 1);
+    const float scale = static_cast<float>(m_GraphHorizontalOrientation ? m_BarsWidth : m_BarsHeight);
+
+    auto scaleSeries = [&](const std::vector<float> &series, std::vector<int> &ring)
+    {
+        m_ColumnValues.resize(count);
+        for (size_t i = 0; i < count; ++i)
+            m_ColumnValues[i] = SampleAtFromNewest(series, static_cast<int>(m_NewestTick - (firstTick + i)));
+        m_ScaledBars.resize(count);
+        SeriesMath::ScaleToPixels(m_ColumnValues.data(), count, m_BarsMin, m_BarsMax, scale, m_ScaledBars.data());
+        for (size_t i = 0; i < count; ++i)
+            ring[static_cast<size_t>((firstTick + i) % m_TickCapacity)] = m_ScaledBars[i];
+    };
+
+    scaleSeries(m_PrimaryData, m_PrimaryBars);
+    if (m_HasSecondaryBars)
+        scaleSeries(m_SecondaryData, m_SecondaryBars);
+}
+
+void HistogramElement::BuildChunk(Chunk &chunk) const
+{
+    ID2D1Factory1 *factory = Direct2D::GetFactory();
+
+    int lower[kChunkTicks];
+    int upper[kChunkTicks];
+    std::vector<SeriesMath::Point> outline;
+    std::vector<D2D1_POINT_2F> points;
+
+    for (int band = 0; band < BAND_COUNT; ++band)
+    {
+        chunk.band[band].Reset();
+        if (!factory || (!m_HasSecondaryBars && band != BAND_PRIMARY))
+            continue;
+
+        for (int i = 0; i < kChunkTicks; ++i)
+        {
+            const uint64_t tick = chunk.firstTick + static_cast<uint64_t>(i);
+            const int primary = TickBar(m_PrimaryBars, tick);
+            const int secondary = m_HasSecondaryBars ? TickBar(m_SecondaryBars, tick) : 0;
+            const int both = (std::min)(primary, secondary);
+            if (!m_HasSecondaryBars)
+            {
+                lower[i] = 0;
+                upper[i] = primary;
+            }
+            else if (band == BAND_BOTH)
+            {
+                lower[i] = 0;
+                upper[i] = both;
+            }
+            else
+            {
+                lower[i] = both;
+                if (band == BAND_PRIMARY)
+                    upper[i] = primary > secondary ? primary : both;
+                else
+                    upper[i] = secondary > primary ? secondary : both;
+            }
+        }
+
+        outline.clear();
+        if (!SeriesMath::AppendBandOutline(lower, upper, kChunkTicks, outline))
+            continue;
+
+        points.resize(outline.size());
+        for (size_t i = 0; i < outline.size(); ++i)
+            points[i] = D2D1::Point2F(static_cast<float>(outline[i].u), static_cast<float>(outline[i].v));
+
+        Microsoft::WRL::ComPtr<ID2D1PathGeometry> geometry;
+        Microsoft::WRL::ComPtr<ID2D1GeometrySink> sink;
+        if (FAILED(factory->CreatePathGeometry(geometry.GetAddressOf())) || FAILED(geometry->Open(sink.GetAddressOf())))
+            continue;
+        sink->BeginFigure(points[0], D2D1_FIGURE_BEGIN_FILLED);
+        sink->AddLines(points.data() + 1, static_cast<UINT32>(points.size() - 1));
+        sink->EndFigure(D2D1_FIGURE_END_CLOSED);
+        if (SUCCEEDED(sink->Close()))
+            chunk.band[band] = geometry;
+    }
+}
+
+void HistogramElement::UpdateBars(int width, int height)
+{
+    SeriesState &primary = m_PrimaryState;
+    SeriesState &secondary = m_SecondaryState;
+    const bool pending = primary.reset || secondary.reset ||
+                         primary.appended > 0 || secondary.appended > 0 ||
+                         primary.dropped || secondary.dropped;
+    if (!m_BarsDirty && width == m_BarsWidth && height == m_BarsHeight && !pending)
+        return;
+
+    float minValue = 0.0f;
+    float maxValue = 100.0f;
+    BuildAutoRange(minValue, maxValue);
+
+    const int columns = (std::max)(m_GraphHorizontalOrientation ? height : width, 0);
+    const bool hasSecondary = !m_SecondaryData.empty();
+
+    // A scroll keeps the bars of the samples still shown; everything else
+    // (and a scroll of a whole screen or more) rebuilds.
+    const bool scroll = !m_BarsDirty && width == m_BarsWidth && height == m_BarsHeight &&
+                        !primary.reset && !secondary.reset &&
+                        minValue == m_BarsMin && maxValue == m_BarsMax &&
+                        hasSecondary == m_HasSecondaryBars &&
+                        (!hasSecondary || secondary.appended == primary.appended) &&
+                        (!primary.dropped || m_PrimaryData.size() >= static_cast<size_t>(columns)) &&
+                        (!secondary.dropped || m_SecondaryData.size() >= static_cast<size_t>(columns)) &&
+                        primary.appended < static_cast<size_t>(columns);
+
+    const size_t appended = primary.appended;
+    primary.appended = secondary.appended = 0;
+    primary.dropped = secondary.dropped = false;
+    primary.reset = secondary.reset = false;
+    m_BarsDirty = false;
+
+    if (scroll)
+    {
+        if (appended == 0)
+            return;
+        m_NewestTick += appended;
+        ComputeTicks(m_NewestTick - appended + 1, m_NewestTick);
+        m_StaleFromTick = (std::min)(m_StaleFromTick, m_NewestTick - appended + 1);
+        m_GeometryDirty = true;
+        return;
+    }
+
+    m_BarsWidth = width;
+    m_BarsHeight = height;
+    m_Columns = columns;
+    m_BarsMin = minValue;
+    m_BarsMax = maxValue;
+    m_HasSecondaryBars = hasSecondary;
+    m_TickCapacity = static_cast<size_t>((std::max)(columns, 1));
+    m_PrimaryBars.assign(m_TickCapacity, 0);
+    m_SecondaryBars.assign(hasSecondary ? m_TickCapacity : 0, 0);
+    m_NewestTick = columns > 0 ? static_cast<uint64_t>(columns - 1) : 0;
+    if (columns > 0)
+        ComputeTicks(0, m_NewestTick);
+    m_Chunks.clear();
+    m_StaleFromTick = 0;
+    m_GeometryDirty = true;
+}
+
+void HistogramElement::UpdateBandGeometry(int width, int height)
+{
+    if (!m_GeometryDirty)
+        return;
+    m_GeometryDirty = false;
+
+    ID2D1Factory1 *factory = Direct2D::GetFactory();
+    for (int band = 0; band < BAND_COUNT; ++band)
+        m_BandGeometry[band].Reset();
+    if (!factory || m_Columns <= 0)
+    {
+        m_Chunks.clear();
+        return;
+    }
+
+    const uint64_t columns = static_cast<uint64_t>(m_Columns);
+    const uint64_t oldestTick = m_NewestTick + 1 >= columns ? m_NewestTick + 1 - columns : 0;
+
+    // Drop chunks that scrolled out, and rebuild the ones holding new ticks
+    // plus the oldest one, whose samples leave the screen.
+    while (!m_Chunks.empty() && m_Chunks.front().firstTick + kChunkTicks <= oldestTick)
+        m_Chunks.pop_front();
+    while (!m_Chunks.empty() && m_Chunks.back().firstTick + kChunkTicks > m_StaleFromTick)
+        m_Chunks.pop_back();
+    if (!m_Chunks.empty() && m_Chunks.front().firstTick < oldestTick)
+        BuildChunk(m_Chunks.front());
+
+    uint64_t nextTick = m_Chunks.empty() ? oldestTick - oldestTick % kChunkTicks
+                                         : m_Chunks.back().firstTick + kChunkTicks;
+    for (; nextTick <= m_NewestTick; nextTick += kChunkTicks)
+    {
+        Chunk chunk;
+        chunk.firstTick = nextTick;
+        BuildChunk(chunk);
+        m_Chunks.push_back(std::move(chunk));
+    }
+    m_StaleFromTick = m_NewestTick + 1;
+
+    // Chunk position w holds tick firstTick + w. Map it to the screen column u
+    // running along the graph, and the bar length v to the content rect.
+    const bool ageAlongU = m_GraphHorizontalOrientation ? !m_Flip : m_GraphStartLeft;
+    std::vector<ID2D1Geometry *> parts[BAND_COUNT];
+    std::vector<Microsoft::WRL::ComPtr<ID2D1TransformedGeometry>> placed;
+    for (const Chunk &chunk : m_Chunks)
+    {
+        const float span = static_cast<float>(m_NewestTick - chunk.firstTick);
+        const float su = ageAlongU ? -1.0f : 1.0f;
+        const float cu = ageAlongU ? span + 1.0f : static_cast<float>(m_Columns - 1) - span;
+
+        D2D1::Matrix3x2F placement;
+        if (m_GraphHorizontalOrientation)
+            placement = D2D1::Matrix3x2F(0.0f, su, m_GraphStartLeft ? 1.0f : -1.0f, 0.0f,
+                                         m_GraphStartLeft ? 0.0f : static_cast<float>(width), cu);
+        else
+            placement = D2D1::Matrix3x2F(su, 0.0f, 0.0f, m_Flip ? 1.0f : -1.0f,
+                                         cu, m_Flip ? 0.0f : static_cast<float>(height));
+
+        for (int band = 0; band < BAND_COUNT; ++band)
+        {
+            if (!chunk.band[band])
+                continue;
+            Microsoft::WRL::ComPtr<ID2D1TransformedGeometry> geometry;
+            if (FAILED(factory->CreateTransformedGeometry(chunk.band[band].Get(), placement, geometry.GetAddressOf())))
+                continue;
+            parts[band].push_back(geometry.Get());
+            placed.push_back(geometry);
+        }
+    }
+
+    // Chunks share their edge columns, so each band fills as one winding
+    // group without seams.
+    for (int band = 0; band < BAND_COUNT; ++band)
+    {
+        if (parts[band].empty())
+            continue;
+        factory->CreateGeometryGroup(
+            D2D1_FILL_MODE_WINDING,
+            parts[band].data(),
+            static_cast<UINT32>(parts[band].size()),
+            m_BandGeometry[band].GetAddressOf());
+    }
 }
 
 bool HistogramElement::HitTest(int x, int y)
@@ -141,49 +398,21 @@ bool HistogramElement::HitTest(int x, int y)
     if (targetX < left || targetX >= right || targetY < top || targetY >= bottom)
         return false;
 
-    float minValue = 0.0f;
-    float maxValue = 100.0f;
-    BuildAutoRange(minValue, maxValue);
+    UpdateBars(width, height);
 
-    const bool hasSecondary = !m_SecondaryData.empty();
-    const int samples = m_GraphHorizontalOrientation ? height : width;
-    if (samples <= 0)
+    const bool hasSecondary = m_HasSecondaryBars;
+    const int column = m_GraphHorizontalOrientation
+                           ? static_cast<int>(targetY - top)
+                           : static_cast<int>(targetX - left);
+    if (column < 0 || column >= m_Columns)
         return false;
 
-    int sampleIndex = 0;
-    if (m_GraphHorizontalOrientation)
-    {
-        const int yPix = static_cast<int>(targetY - top);
-        if (yPix < 0 || yPix >= height)
-            return false;
-        sampleIndex = m_Flip ? (height - 1 - yPix) : yPix;
-    }
-    else
-    {
-        const int xPix = static_cast<int>(targetX - left);
-        if (xPix < 0 || xPix >= width)
-            return false;
-        sampleIndex = m_GraphStartLeft ? xPix : (width - 1 - xPix);
-    }
-
-    if (sampleIndex < 0 || sampleIndex >= samples)
+    const uint64_t age = static_cast<uint64_t>(AgeOfColumn(column, m_Columns));
+    if (age > m_NewestTick)
         return false;
-
-    const float primaryValue = SampleAtFromNewest(m_PrimaryData, sampleIndex);
-    const float primaryN = NormalizeValue(primaryValue, minValue, maxValue);
-    const int primarySize = m_GraphHorizontalOrientation
-                                ? static_cast<int>(primaryN * static_cast<float>(width))
-                                : static_cast<int>(primaryN * static_cast<float>(height));
-
-    int secondarySize = 0;
-    if (hasSecondary)
-    {
-        const float secondaryValue = SampleAtFromNewest(m_SecondaryData, sampleIndex);
-        const float secondaryN = NormalizeValue(secondaryValue, minValue, maxValue);
-        secondarySize = m_GraphHorizontalOrientation
-                            ? static_cast<int>(secondaryN * static_cast<float>(width))
-                            : static_cast<int>(secondaryN * static_cast<float>(height));
-    }
+    const uint64_t tick = m_NewestTick - age;
+    const int primarySize = TickBar(m_PrimaryBars, tick);
+    const int secondarySize = hasSecondary ? TickBar(m_SecondaryBars, tick) : 0;
 
     const int bothSize = hasSecondary ? (std::min)(primarySize, secondarySize) : 0;
     const bool bothVisible = hasSecondary && bothSize > 0 && (m_BothAlpha > 0 || m_BothGradient.type != GRADIENT_NONE);
@@ -244,17 +473,18 @@ bool HistogramElement::HitTest(int x, int y)
     return primaryVisible && yOffset < primarySize;
 }
 
-void HistogramElement::DrawSpan(
+void HistogramElement::FillBand(
     ID2D1DeviceContext *context,
-    const D2D1_RECT_F &dstRect,
+    Band band,
     const D2D1_RECT_F &gradientRect,
     const GradientInfo *gradient,
     COLORREF color,
     BYTE alpha)
 {
-    if (!context)
+    ID2D1GeometryGroup *geometry = m_BandGeometry[band].Get();
+    if (!geometry)
         return;
-    if (dstRect.right <= dstRect.left || dstRect.bottom <= dstRect.top)
+    if (alpha == 0 && (!gradient || gradient->type == GRADIENT_NONE))
         return;
 
     Microsoft::WRL::ComPtr<ID2D1Brush> brush;
@@ -267,7 +497,7 @@ void HistogramElement::DrawSpan(
         brush.GetAddressOf());
     if (brush)
     {
-        context->FillRectangle(dstRect, brush.Get());
+        context->FillGeometry(geometry, brush.Get());
     }
 }
 
@@ -288,120 +518,23 @@ void HistogramElement::Render(ID2D1DeviceContext *context)
 
     RenderBackground(context);
 
+    UpdateBars(width, height);
+    UpdateBandGeometry(width, height);
+
+    // The band geometries are in content-local coordinates.
     const float left = static_cast<float>(m_X + m_PaddingLeft);
     const float top = static_cast<float>(m_Y + m_PaddingTop);
-    const float right = left + static_cast<float>(width);
-    const float bottom = top + static_cast<float>(height);
-    const D2D1_RECT_F gradientRect = D2D1::RectF(left, top, right, bottom);
+    const D2D1_RECT_F gradientRect = D2D1::RectF(0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height));
 
-    float minValue = 0.0f;
-    float maxValue = 100.0f;
-    BuildAutoRange(minValue, maxValue);
-
-    const bool hasSecondary = !m_SecondaryData.empty();
-    const int samples = m_GraphHorizontalOrientation ? height : width;
-
-    for (int i = 0; i < samples; ++i)
-    {
-        const float primaryValue = SampleAtFromNewest(m_PrimaryData, i);
-        const float primaryN = NormalizeValue(primaryValue, minValue, maxValue);
-        const int primarySize = m_GraphHorizontalOrientation
-                                    ? static_cast<int>(primaryN * static_cast<float>(width))
-                                    : static_cast<int>(primaryN * static_cast<float>(height));
-
-        int secondarySize = 0;
-        if (hasSecondary)
-        {
-            const float secondaryValue = SampleAtFromNewest(m_SecondaryData, i);
-            const float secondaryN = NormalizeValue(secondaryValue, minValue, maxValue);
-            secondarySize = m_GraphHorizontalOrientation
-                                ? static_cast<int>(secondaryN * static_cast<float>(width))
-                                : static_cast<int>(secondaryN * static_cast<float>(height));
-        }
-
-        const int bothSize = hasSecondary ? (std::min)(primarySize, secondarySize) : 0;
-
-        if (m_GraphHorizontalOrientation)
-        {
-            const int sampleY = m_Flip ? (height - 1 - i) : i;
-            const float y = top + static_cast<float>(sampleY);
-
-            if (hasSecondary && bothSize > 0)
-            {
-                D2D1_RECT_F bothRect = m_GraphStartLeft
-                                           ? D2D1::RectF(left, y, left + static_cast<float>(bothSize), y + 1.0f)
-                                           : D2D1::RectF(right - static_cast<float>(bothSize), y, right, y + 1.0f);
-                DrawSpan(context, bothRect, gradientRect, &m_BothGradient, m_BothColor, m_BothAlpha);
-            }
-
-            if (hasSecondary)
-            {
-                const bool secondaryLarger = secondarySize > primarySize;
-                const int larger = secondaryLarger ? secondarySize : primarySize;
-                if (larger > bothSize)
-                {
-                    D2D1_RECT_F restRect = m_GraphStartLeft
-                                               ? D2D1::RectF(left + static_cast<float>(bothSize), y, left + static_cast<float>(larger), y + 1.0f)
-                                               : D2D1::RectF(right - static_cast<float>(larger), y, right - static_cast<float>(bothSize), y + 1.0f);
-                    if (secondaryLarger)
-                    {
-                        DrawSpan(context, restRect, gradientRect, &m_SecondaryGradient, m_SecondaryColor, m_SecondaryAlpha);
-                    }
-                    else
-                    {
-                        DrawSpan(context, restRect, gradientRect, &m_PrimaryGradient, m_PrimaryColor, m_PrimaryAlpha);
-                    }
-                }
-            }
-            else if (primarySize > 0)
-            {
-                D2D1_RECT_F primaryRect = m_GraphStartLeft
-                                              ? D2D1::RectF(left, y, left + static_cast<float>(primarySize), y + 1.0f)
-                                              : D2D1::RectF(right - static_cast<float>(primarySize), y, right, y + 1.0f);
-                DrawSpan(context, primaryRect, gradientRect, &m_PrimaryGradient, m_PrimaryColor, m_PrimaryAlpha);
-            }
-        }
-        else
-        {
-            const int sampleX = m_GraphStartLeft ? i : (width - 1 - i);
-            const float x = left + static_cast<float>(sampleX);
+    D2D1_MATRIX_3X2_F elementTransform;
+    context->GetTransform(&elementTransform);
+    context->SetTransform(D2D1::Matrix3x2F::Translation(left, top) * elementTransform);
 
-            if (hasSecondary && bothSize > 0)
-            {
-                D2D1_RECT_F bothRect = m_Flip
-                                           ? D2D1::RectF(x, top, x + 1.0f, top + static_cast<float>(bothSize))
-                                           : D2D1::RectF(x, bottom - static_cast<float>(bothSize), x + 1.0f, bottom);
-                DrawSpan(context, bothRect, gradientRect, &m_BothGradient, m_BothColor, m_BothAlpha);
-            }
+    FillBand(context, BAND_BOTH, gradientRect, &m_BothGradient, m_BothColor, m_BothAlpha);
+    FillBand(context, BAND_PRIMARY, gradientRect, &m_PrimaryGradient, m_PrimaryColor, m_PrimaryAlpha);
+    FillBand(context, BAND_SECONDARY, gradientRect, &m_SecondaryGradient, m_SecondaryColor, m_SecondaryAlpha);
 
-            if (hasSecondary)
-            {
-                const bool secondaryLarger = secondarySize > primarySize;
-                const int larger = secondaryLarger ? secondarySize : primarySize;
-                if (larger > bothSize)
-                {
-                    D2D1_RECT_F restRect = m_Flip
-                                               ? D2D1::RectF(x, top + static_cast<float>(bothSize), x + 1.0f, top + static_cast<float>(larger))
-                                               : D2D1::RectF(x, bottom - static_cast<float>(larger), x + 1.0f, bottom - static_cast<float>(bothSize));
-                    if (secondaryLarger)
-                    {
-                        DrawSpan(context, restRect, gradientRect, &m_SecondaryGradient, m_SecondaryColor, m_SecondaryAlpha);
-                    }
-                    else
-                    {
-                        DrawSpan(context, restRect, gradientRect, &m_PrimaryGradient, m_PrimaryColor, m_PrimaryAlpha);
-                    }
-                }
-            }
-            else if (primarySize > 0)
-            {
-                D2D1_RECT_F primaryRect = m_Flip
-                                              ? D2D1::RectF(x, top, x + 1.0f, top + static_cast<float>(primarySize))
-                                              : D2D1::RectF(x, bottom - static_cast<float>(primarySize), x + 1.0f, bottom);
-                DrawSpan(context, primaryRect, gradientRect, &m_PrimaryGradient, m_PrimaryColor, m_PrimaryAlpha);
-            }
-        }
-    }
+    context->SetTransform(elementTransform);
 
     RenderBevel(context);
     RestoreRenderTransform(context, originalTransform);
@@ -10,7 +10,10 @@
 
 #include "Element.h"
 #include "GeneralImage.h"
+#include "../core/SeriesSummary.h"
 
+#include <cstdint>
+#include <deque>
 #include <vector>
 
 class HistogramElement : public Element
@@ -24,21 +27,23 @@ public:
     virtual int GetAutoWidth() override { return 0; }
     virtual int GetAutoHeight() override { return 0; }
 
-    void SetData(const std::vector<float> &data) { m_PrimaryData = data; }
-    void SetData2(const std::vector<float> &data) { m_SecondaryData = data; }
+    // A series that scrolled (samples dropped from the front, new ones
+    // appended) only computes bars for the new samples.
+    void SetData(const std::vector<float> &data) { SetSeries(m_PrimaryData, m_PrimaryState, data); }
+    void SetData2(const std::vector<float> &data) { SetSeries(m_SecondaryData, m_SecondaryState, data); }
     const std::vector<float> &GetData() const { return m_PrimaryData; }
     const std::vector<float> &GetData2() const { return m_SecondaryData; }
 
-    void SetAutoRange(bool enable) { m_AutoRange = enable; }
+    void SetAutoRange(bool enable) { m_BarsDirty |= (m_AutoRange != enable); m_AutoRange = enable; }
     bool GetAutoRange() const { return m_AutoRange; }
 
-    void SetGraphStartLeft(bool left) { m_GraphStartLeft = left; }
+    void SetGraphStartLeft(bool left) { m_BarsDirty |= (m_GraphStartLeft != left); m_GraphStartLeft = left; }
     bool GetGraphStartLeft() const { return m_GraphStartLeft; }
 
-    void SetGraphHorizontalOrientation(bool horizontal) { m_GraphHorizontalOrientation = horizontal; }
+    void SetGraphHorizontalOrientation(bool horizontal) { m_BarsDirty |= (m_GraphHorizontalOrientation != horizontal); m_GraphHorizontalOrientation = horizontal; }
     bool GetGraphHorizontalOrientation() const { return m_GraphHorizontalOrientation; }
 
-    void SetFlip(bool flip) { m_Flip = flip; }
+    void SetFlip(bool flip) { m_BarsDirty |= (m_Flip != flip); m_Flip = flip; }
     bool GetFlip() const { return m_Flip; }
 
     void SetPrimaryColor(COLORREF color, BYTE alpha) { m_PrimaryColor = color; m_PrimaryAlpha = alpha; }
@@ -58,12 +63,47 @@ public:
     const GradientInfo &GetBothGradient() const { return m_BothGradient; }
 
 private:
+    // Filled regions, each drawn as one geometry. Without secondary data only
+    // BAND_PRIMARY is used and spans the whole bar.
+    enum Band
+    {
+        BAND_BOTH = 0,      // 0 .. min(primary, secondary)
+        BAND_PRIMARY,       // min .. primary, where primary is larger
+        BAND_SECONDARY,     // min .. secondary, where secondary is larger
+        BAND_COUNT
+    };
+
+    // Scroll bookkeeping for one series since the bars were last built.
+    struct SeriesState
+    {
+        SeriesSummary summary;
+        size_t appended = 0;  // samples appended
+        bool dropped = false; // samples left the front
+        bool reset = true;    // replaced by unrelated data
+    };
+
+    // Band outlines of kChunkTicks consecutive ticks in (tick - firstTick, bar
+    // length) coordinates. A transform places each chunk on screen, so a
+    // scroll moves chunks instead of rebuilding them.
+    static const int kChunkTicks = 64;
+    struct Chunk
+    {
+        uint64_t firstTick = 0;
+        Microsoft::WRL::ComPtr<ID2D1PathGeometry> band[BAND_COUNT];
+    };
+
+    void SetSeries(std::vector<float> &stored, SeriesState &state, const std::vector<float> &data);
     bool BuildAutoRange(float &outMin, float &outMax) const;
     float SampleAtFromNewest(const std::vector<float> &series, int sampleIndex) const;
-    static float NormalizeValue(float value, float minValue, float maxValue);
-    void DrawSpan(
+    int AgeOfColumn(int column, int columns) const;
+    int TickBar(const std::vector<int> &ring, uint64_t tick) const;
+    void ComputeTicks(uint64_t firstTick, uint64_t lastTick);
+    void BuildChunk(Chunk &chunk) const;
+    void UpdateBars(int width, int height);
+    void UpdateBandGeometry(int width, int height);
+    void FillBand(
         ID2D1DeviceContext *context,
-        const D2D1_RECT_F &dstRect,
+        Band band,
         const D2D1_RECT_F &gradientRect,
         const GradientInfo *gradient,
         COLORREF color,
@@ -87,6 +127,33 @@ private:
     COLORREF m_BothColor = RGB(255, 255, 0);
     BYTE m_BothAlpha = 255;
     GradientInfo m_BothGradient;
+
+    SeriesState m_PrimaryState;
+    SeriesState m_SecondaryState;
+
+    // Every sample shown gets a tick, counting up as samples are appended;
+    // screen column u shows tick m_NewestTick - age(u). Bar lengths are kept
+    // per tick in rings of m_TickCapacity entries, so a scroll computes bars
+    // for the new ticks only. Everything is rebuilt when the range,
+    // orientation or size changes, or the data does not scroll.
+    bool m_BarsDirty = true;
+    bool m_GeometryDirty = true;
+    int m_BarsWidth = 0;
+    int m_BarsHeight = 0;
+    int m_Columns = 0;
+    float m_BarsMin = 0.0f;
+    float m_BarsMax = 0.0f;
+    bool m_HasSecondaryBars = false;
+    uint64_t m_NewestTick = 0;
+    size_t m_TickCapacity = 0;
+    uint64_t m_StaleFromTick = 0;     // chunks holding this tick or later are rebuilt
+    std::vector<float> m_ColumnValues;
+    std::vector<int> m_ScaledBars;
+    std::vector<int> m_PrimaryBars;   // by tick % m_TickCapacity
+    std::vector<int> m_SecondaryBars;
+    std::deque<Chunk> m_Chunks;       // ascending firstTick
+    // All chunks of a band, transformed into content-local coordinates.
+    Microsoft::WRL::ComPtr<ID2D1GeometryGroup> m_BandGeometry[BAND_COUNT];
 };
 
 #endif
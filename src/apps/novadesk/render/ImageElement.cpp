@@ -411,14 +411,7 @@ bool ImageElement::HitTest(int x, int y)
     if (!MapPointToImagePixel(targetX, targetY, imgW, imgH, targetPixelX, targetPixelY))
         return false;
 
-    // Get pixel alpha
-    WICRect rect = {(INT)targetPixelX, (INT)targetPixelY, 1, 1};
-    BYTE pixel[4]; // BGRA
-    HRESULT hr = wic->CopyPixels(&rect, 4, 4, pixel);
-    if (FAILED(hr))
-        return false;
-
-    return pixel[3] > 0; // Alpha channel
+    return m_GeneralImage.GetPixelAlpha((int)targetPixelX, (int)targetPixelY) > 0;
 }
 
 void ImageElement::OnOwnerHWNDSet()
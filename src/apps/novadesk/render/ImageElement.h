@@ -32,6 +32,7 @@ public:
 
     virtual int GetAutoWidth() override;
     virtual int GetAutoHeight() override;
+    virtual size_t GetImageMemoryBytes() const override { return m_GeneralImage.GetMemoryBytes(); }
 
     virtual void OnOwnerHWNDSet() override;
     virtual void OnImageDownloaded(const std::wstring& url, const std::vector<BYTE>& buffer) override;
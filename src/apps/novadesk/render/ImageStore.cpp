@@ -0,0 +1,66 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "ImageStore.h"
+
+#include "../shared/PathUtils.h"
+
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace ImageStore
+{
+    namespace
+    {
+        std::mutex g_Mutex;
+        std::unordered_map<std::wstring, std::shared_ptr<const std::vector<BYTE>>> g_Images;
+        std::deque<std::wstring> g_Order; // oldest first
+
+        void EraseOrder(const std::wstring &path)
+        {
+            auto it = std::find(g_Order.begin(), g_Order.end(), path);
+            if (it != g_Order.end())
+                g_Order.erase(it);
+        }
+    }
+
+    bool Put(const std::wstring &path, const BYTE *data, size_t size)
+    {
+        if (!PathUtils::IsMemoryPath(path) || !data || size == 0)
+            return false;
+
+        auto bytes = std::make_shared<const std::vector<BYTE>>(data, data + size);
+
+        std::lock_guard<std::mutex> lock(g_Mutex);
+        EraseOrder(path);
+        g_Order.push_back(path);
+        g_Images[path] = std::move(bytes);
+
+        while (g_Order.size() > kMaxEntries)
+        {
+            g_Images.erase(g_Order.front());
+            g_Order.pop_front();
+        }
+        return true;
+    }
+
+    std::shared_ptr<const std::vector<BYTE>> Get(const std::wstring &path)
+    {
+        std::lock_guard<std::mutex> lock(g_Mutex);
+        auto it = g_Images.find(path);
+        return it != g_Images.end() ? it->second : nullptr;
+    }
+
+    void Remove(const std::wstring &path)
+    {
+        std::lock_guard<std::mutex> lock(g_Mutex);
+        g_Images.erase(path);
+        EraseOrder(path);
+    }
+}
@@ -0,0 +1,39 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <windows.h>
+
+/*
+** ImageStore keeps encoded images (PNG, JPEG, ...) in memory under
+** "memory://" paths, so addons can hand generated images to image elements
+** without writing them to disk. Image elements given such a path decode the
+** stored bytes like a downloaded image.
+**
+** Entries are replaced when stored again under the same path. Only the most
+** recently stored kMaxEntries are kept; an element that already decoded an
+** evicted image keeps showing it.
+**
+** Safe to call from any thread.
+*/
+namespace ImageStore
+{
+    constexpr size_t kMaxEntries = 32;
+
+    // Store a copy of 'size' bytes under 'path'. Returns false if 'path' is
+    // not a memory:// path or the data is empty.
+    bool Put(const std::wstring &path, const BYTE *data, size_t size);
+
+    // Bytes stored under 'path', or null if there are none.
+    std::shared_ptr<const std::vector<BYTE>> Get(const std::wstring &path);
+
+    void Remove(const std::wstring &path);
+}
@@ -45,6 +45,8 @@ public:
     virtual int GetAutoHeight() override;
     virtual GfxRect GetBounds() override;
     virtual bool HitTest(int x, int y) override;
+    // Caret, selection and typed text change outside property updates.
+    virtual bool IsRenderVolatile() const override { return true; }
 
     // Text content
     void SetText(const std::wstring &text);
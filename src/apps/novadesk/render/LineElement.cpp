@@ -8,9 +8,22 @@
 #include "LineElement.h"
 
 #include "Direct2DHelper.h"
+#include "../core/SeriesMath.h"
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
+
+namespace
+{
+    // How far back SetDataSets looks for the previous data when a series scrolls.
+    const size_t kMaxScrollSamples = 1024;
+
+    bool SamePoints(const std::vector<D2D1_POINT_2F>& a, const std::vector<D2D1_POINT_2F>& b)
+    {
+        return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(D2D1_POINT_2F)) == 0);
+    }
+}
 
 LineElement::LineElement(const std::wstring& id, int x, int y, int w, int h)
     : Element(ELEMENT_LINE, id, x, y, w, h)
@@ -26,6 +39,8 @@ void LineElement::SetLineCount(int count)
 
 void LineElement::SetDataSets(const std::vector<std::vector<float>>& dataSets)
 {
+    std::vector<std::vector<float>> previous;
+    previous.swap(m_DataSets);
     m_DataSets = dataSets;
     if (m_MaxPoints > 0)
     {
@@ -38,6 +53,37 @@ void LineElement::SetDataSets(const std::vector<std::vector<float>>& dataSets)
         }
     }
     EnsureStorage();
+
+    for (size_t i = 0; i < m_DataSets.size(); ++i)
+    {
+        static const std::vector<float> empty;
+        const std::vector<float>& before = (i < previous.size()) ? previous[i] : empty;
+        size_t dropped = 0;
+        if (!SeriesMath::FindScroll(before.data(), before.size(), m_DataSets[i].data(), m_DataSets[i].size(), kMaxScrollSamples, dropped))
+        {
+            dropped = before.size() + 1; // unrelated: rebuild
+        }
+        SyncSeries(i, before, dropped);
+    }
+}
+
+void LineElement::SyncSeries(size_t dataIndex, const std::vector<float>& previous, size_t dropped)
+{
+    SeriesCache& cache = m_SeriesCaches[dataIndex];
+    const std::vector<float>& series = m_DataSets[dataIndex];
+    if (cache.summary.Size() != previous.size() || dropped > previous.size())
+    {
+        cache.summary.Assign(series.data(), series.size());
+    }
+    else if (dropped == 0 && series.size() == previous.size())
+    {
+        return;
+    }
+    else
+    {
+        cache.summary.Scroll(series.data(), series.size(), dropped);
+    }
+    cache.indicesValid = false;
 }
 
 void LineElement::SetLineColors(const std::vector<COLORREF>& colors, const std::vector<BYTE>& alphas)
@@ -69,11 +115,18 @@ void LineElement::SetMaxPoints(int maxPoints)
     m_MaxPoints = (maxPoints < 0) ? 0 : maxPoints;
     if (m_MaxPoints > 0)
     {
-        for (auto& series : m_DataSets)
+        for (size_t i = 0; i < m_DataSets.size(); ++i)
         {
+            auto& series = m_DataSets[i];
             if (series.size() > (size_t)m_MaxPoints)
             {
+                const size_t dropped = series.size() - (size_t)m_MaxPoints;
                 series.erase(series.begin(), series.end() - m_MaxPoints);
+                if (i < m_SeriesCaches.size())
+                {
+                    m_SeriesCaches[i].summary.Scroll(series.data(), series.size(), dropped);
+                    m_SeriesCaches[i].indicesValid = false;
+                }
             }
         }
     }
@@ -152,6 +205,55 @@ void LineElement::EnsureStorage()
             scale = 1.0f;
         }
     }
+
+    // New caches start with an empty summary; SetDataSets summarises the
+    // series it stores through SyncSeries, once.
+    m_SeriesCaches.resize(m_DataSets.size());
+}
+
+const std::vector<size_t>& LineElement::GetDrawIndices(int dataIndex, int totalPoints, int capacityPoints)
+{
+    SeriesCache& cache = m_SeriesCaches[(size_t)dataIndex];
+    const auto& series = m_DataSets[(size_t)dataIndex];
+
+    // Axis position of sample i is offset + i * spacing pixels, with the axis
+    // mirrored when the newest sample is drawn first; same spacing as MapPoint.
+    const float axisLength = (m_GraphHorizontalOrientation ? (float)GetHeight() : (float)GetWidth()) - 1.0f;
+    const float spacing = (capacityPoints > 1) ? (axisLength / (float)(capacityPoints - 1)) : 0.0f;
+    const bool reversed = m_GraphHorizontalOrientation ? m_Flip : m_GraphStartLeft;
+    const float offset = reversed ? (axisLength - (float)(totalPoints - 1) * spacing) : ((float)(capacityPoints - totalPoints) * spacing);
+
+    if (cache.indicesValid && cache.decimation == m_Decimation && cache.offset == offset && cache.spacing == spacing)
+    {
+        return cache.indices;
+    }
+
+    switch (m_Decimation)
+    {
+    case SeriesDecimation::MinMax:
+        cache.summary.DecimateMinMax(series.data(), offset, spacing, cache.indices);
+        break;
+    case SeriesDecimation::Lttb:
+    {
+        // Two samples per pixel column the series spans.
+        const size_t columns = (size_t)((float)(totalPoints - 1) * spacing) + 1;
+        SeriesMath::DecimateLttb(series.data(), series.size(), columns * 2, cache.indices);
+        break;
+    }
+    default:
+        cache.indices.resize(series.size());
+        for (size_t i = 0; i < series.size(); ++i)
+        {
+            cache.indices[i] = i;
+        }
+        break;
+    }
+
+    cache.indicesValid = true;
+    cache.decimation = m_Decimation;
+    cache.offset = offset;
+    cache.spacing = spacing;
+    return cache.indices;
 }
 
 bool LineElement::BuildAutoRange(float& outMin, float& outMax) const
@@ -171,29 +273,30 @@ bool LineElement::BuildAutoRange(float& outMin, float& outMax) const
     float minV = 0.0f;
     float maxV = 0.0f;
 
-    for (size_t seriesIndex = 0; seriesIndex < m_DataSets.size(); ++seriesIndex)
+    for (size_t seriesIndex = 0; seriesIndex < m_SeriesCaches.size(); ++seriesIndex)
     {
-        const auto& series = m_DataSets[seriesIndex];
         float lineScale = 1.0f;
         if (seriesIndex < m_ScaleValues.size())
         {
             lineScale = m_ScaleValues[seriesIndex];
         }
 
-        for (float v : series)
+        float seriesMin = 0.0f;
+        float seriesMax = 0.0f;
+        if (!m_SeriesCaches[seriesIndex].summary.MinMax(seriesMin, seriesMax))
         {
-            v *= lineScale;
-            if (!hasValue)
-            {
-                minV = maxV = v;
-                hasValue = true;
-            }
-            else
-            {
-                minV = std::min(minV, v);
-                maxV = std::max(maxV, v);
-            }
+            continue;
         }
+        seriesMin *= lineScale;
+        seriesMax *= lineScale;
+        if (seriesMin > seriesMax)
+        {
+            std::swap(seriesMin, seriesMax);
+        }
+
+        minV = hasValue ? std::min(minV, seriesMin) : seriesMin;
+        maxV = hasValue ? std::max(maxV, seriesMax) : seriesMax;
+        hasValue = true;
     }
 
     if (!hasValue)
@@ -388,10 +491,11 @@ bool LineElement::HitTest(int x, int y)
             return true;
         }
 
-        for (int j = 1; j < totalPoints; ++j)
+        const std::vector<size_t>& indices = GetDrawIndices(i, totalPoints, capacityPoints);
+        for (size_t k = 1; k < indices.size(); ++k)
         {
             D2D1_POINT_2F b{};
-            if (!MapPoint(i, j, totalPoints, capacityPoints, minV, maxV, b))
+            if (!MapPoint(i, (int)indices[k], totalPoints, capacityPoints, minV, maxV, b))
                 continue;
 
             if (DistancePointToSegment(p, a, b) <= tolerance)
@@ -506,20 +610,9 @@ void LineElement::Render(ID2D1DeviceContext* context)
         const int totalPoints = (int)series.size();
         const int capacityPoints = (m_MaxPoints > totalPoints) ? m_MaxPoints : totalPoints;
 
-        Microsoft::WRL::ComPtr<ID2D1PathGeometry> geometry;
-        if (!factory || FAILED(factory->CreatePathGeometry(geometry.GetAddressOf())))
-            continue;
-
-        Microsoft::WRL::ComPtr<ID2D1GeometrySink> sink;
-        if (FAILED(geometry->Open(sink.GetAddressOf())))
-            continue;
-
         D2D1_POINT_2F first{};
         if (!MapPoint(i, 0, totalPoints, capacityPoints, minV, maxV, first))
-        {
-            sink->Close();
             continue;
-        }
         D2D1_POINT_2F base{};
         if (!m_GraphHorizontalOrientation)
         {
@@ -532,20 +625,35 @@ void LineElement::Render(ID2D1DeviceContext* context)
             base = D2D1::Point2F(baseX, first.y);
         }
 
-        sink->BeginFigure(base, D2D1_FIGURE_BEGIN_HOLLOW);
-        sink->AddLine(first);
-        for (int j = 1; j < totalPoints; ++j)
+        const std::vector<size_t>& indices = GetDrawIndices(i, totalPoints, capacityPoints);
+        m_PointScratch.clear();
+        m_PointScratch.push_back(base);
+        m_PointScratch.push_back(first);
+        for (size_t k = 1; k < indices.size(); ++k)
         {
             D2D1_POINT_2F p{};
-            if (MapPoint(i, j, totalPoints, capacityPoints, minV, maxV, p))
+            if (MapPoint(i, (int)indices[k], totalPoints, capacityPoints, minV, maxV, p))
             {
-                sink->AddLine(p);
+                m_PointScratch.push_back(p);
             }
         }
-        sink->EndFigure(D2D1_FIGURE_END_OPEN);
-        if (FAILED(sink->Close()))
+
+        SeriesCache& cache = m_SeriesCaches[(size_t)i];
+        if (!cache.geometry || !SamePoints(cache.points, m_PointScratch))
         {
-            continue;
+            cache.geometry.Reset();
+            cache.points.swap(m_PointScratch);
+
+            Microsoft::WRL::ComPtr<ID2D1PathGeometry> geometry;
+            Microsoft::WRL::ComPtr<ID2D1GeometrySink> sink;
+            if (!factory || FAILED(factory->CreatePathGeometry(geometry.GetAddressOf())) || FAILED(geometry->Open(sink.GetAddressOf())))
+                continue;
+            sink->BeginFigure(cache.points[0], D2D1_FIGURE_BEGIN_HOLLOW);
+            sink->AddLines(cache.points.data() + 1, (UINT32)(cache.points.size() - 1));
+            sink->EndFigure(D2D1_FIGURE_END_OPEN);
+            if (FAILED(sink->Close()))
+                continue;
+            cache.geometry = geometry;
         }
 
         Microsoft::WRL::ComPtr<ID2D1Brush> brush;
@@ -565,7 +673,7 @@ void LineElement::Render(ID2D1DeviceContext* context)
 
         if (brush)
         {
-            context->DrawGeometry(geometry.Get(), brush.Get(), strokeWidth, strokeStyle.Get());
+            context->DrawGeometry(cache.geometry.Get(), brush.Get(), strokeWidth, strokeStyle.Get());
         }
     }
 
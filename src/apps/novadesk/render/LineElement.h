@@ -9,6 +9,7 @@
 #define __NOVADESK_LINE_ELEMENT_H__
 
 #include "Element.h"
+#include "../core/SeriesSummary.h"
 
 #include <vector>
 
@@ -74,8 +75,28 @@ public:
     float GetScaleMin() const { return m_ScaleMin; }
     float GetScaleMax() const { return m_ScaleMax; }
 
+    void SetDecimation(SeriesDecimation decimation) { m_Decimation = decimation; }
+    SeriesDecimation GetDecimation() const { return m_Decimation; }
+
 private:
+    // Per-series render state. The summary follows the data incrementally;
+    // the drawn sample indices are recomputed only when the data or the axis
+    // mapping change, and the geometry only when the mapped points do.
+    struct SeriesCache
+    {
+        SeriesSummary summary;
+        std::vector<size_t> indices;
+        bool indicesValid = false;
+        SeriesDecimation decimation = SeriesDecimation::MinMax;
+        float offset = 0.0f;
+        float spacing = 0.0f;
+        std::vector<D2D1_POINT_2F> points;
+        Microsoft::WRL::ComPtr<ID2D1PathGeometry> geometry;
+    };
+
     void EnsureStorage();
+    void SyncSeries(size_t dataIndex, const std::vector<float>& previous, size_t dropped);
+    const std::vector<size_t>& GetDrawIndices(int dataIndex, int totalPoints, int capacityPoints);
     bool BuildAutoRange(float& outMin, float& outMax) const;
     bool MapPoint(int dataIndex, int pointIndex, int totalPoints, int capacityPoints, float minValue, float maxValue, D2D1_POINT_2F& outPoint);
     static float DistancePointToSegment(const D2D1_POINT_2F& p, const D2D1_POINT_2F& a, const D2D1_POINT_2F& b);
@@ -100,6 +121,10 @@ private:
     bool m_AutoRange = false;
     float m_ScaleMin = 0.0f;
     float m_ScaleMax = 100.0f;
+    SeriesDecimation m_Decimation = SeriesDecimation::MinMax;
+
+    std::vector<SeriesCache> m_SeriesCaches;
+    std::vector<D2D1_POINT_2F> m_PointScratch;
 };
 
 #endif
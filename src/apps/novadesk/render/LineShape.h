@@ -23,6 +23,7 @@ public:
     virtual void SetLinePoints(float x1, float y1, float x2, float y2) override { 
         m_StartX = x1; m_StartY = y1;
         m_EndX = x2; m_EndY = y2;
+        InvalidateGeometry();
     }
     virtual float GetStartX() const override { return m_StartX; }
     virtual float GetStartY() const override { return m_StartY; }
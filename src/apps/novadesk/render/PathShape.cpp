@@ -39,6 +39,7 @@ void PathShape::SetCombinedGeometry(Microsoft::WRL::ComPtr<ID2D1Geometry> geomet
         (int)ceilf(bounds.bottom - bounds.top)
     );
     m_IsCombineShape = true;
+    InvalidateGeometry();
 }
 
 void PathShape::ClearCombinedGeometry()
@@ -47,6 +48,7 @@ void PathShape::ClearCombinedGeometry()
     m_HasCombinedGeometry = false;
     m_IsCombineShape = false;
     m_CombinedBounds = GfxRect();
+    InvalidateGeometry();
 }
 
 void PathShape::SetCombineData(const std::wstring& baseId, const std::vector<CombineOp>& ops, bool consumeBase)
@@ -68,6 +70,7 @@ void PathShape::SetPathData(const std::wstring& pathData)
 {
     m_PathData = pathData;
     UpdatePathBounds();
+    InvalidateGeometry();
 }
 
 int PathShape::GetAutoWidth()
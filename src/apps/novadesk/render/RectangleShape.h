@@ -19,7 +19,7 @@ public:
     virtual void Render(ID2D1DeviceContext* context) override;
     virtual bool HitTestLocal(const D2D1_POINT_2F& point) override;
     virtual bool CreateGeometry(ID2D1Factory* factory, Microsoft::WRL::ComPtr<ID2D1Geometry>& geometry) const override;
-    virtual void SetRadii(float rx, float ry) override { m_RadiusX = rx; m_RadiusY = ry; }
+    virtual void SetRadii(float rx, float ry) override { m_RadiusX = rx; m_RadiusY = ry; InvalidateGeometry(); }
     virtual float GetRadiusX() const override { return m_RadiusX; }
     virtual float GetRadiusY() const override { return m_RadiusY; }
 
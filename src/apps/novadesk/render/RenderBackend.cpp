@@ -0,0 +1,306 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#include "RenderBackend.h"
+
+#include "Direct2DHelper.h"
+#include "../shared/Logging.h"
+#include "../shared/Settings.h"
+
+using Microsoft::WRL::ComPtr;
+
+namespace
+{
+    bool FinishDraw(ComPtr<ID2D1DeviceContext> &context)
+    {
+        HRESULT hr = context->EndDraw();
+        if (hr == D2DERR_RECREATE_TARGET)
+        {
+            context.Reset();
+            Logging::Log(LogLevel::Error, L"D2D Device lost, resetting RenderContext");
+            return false;
+        }
+        if (FAILED(hr))
+        {
+            Logging::Log(LogLevel::Error, L"D2D EndDraw failed (0x%08X)", hr);
+            return false;
+        }
+        return true;
+    }
+}
+
+LayeredWindowBackend::~LayeredWindowBackend()
+{
+    ReleaseSurface();
+}
+
+void LayeredWindowBackend::ReleaseSurface()
+{
+    if (m_hMemDc && m_hOldBitmap)
+    {
+        SelectObject(m_hMemDc, m_hOldBitmap);
+        m_hOldBitmap = nullptr;
+    }
+    if (m_hBitmap)
+    {
+        DeleteObject(m_hBitmap);
+        m_hBitmap = nullptr;
+    }
+    if (m_hMemDc)
+    {
+        DeleteDC(m_hMemDc);
+        m_hMemDc = nullptr;
+    }
+    m_pBits = nullptr;
+    m_Width = 0;
+    m_Height = 0;
+}
+
+bool LayeredWindowBackend::EnsureSurface(int width, int height)
+{
+    if (!m_hMemDc)
+    {
+        HDC hdcScreen = GetDC(NULL);
+        m_hMemDc = CreateCompatibleDC(hdcScreen);
+        ReleaseDC(NULL, hdcScreen);
+        if (!m_hMemDc)
+            return false;
+    }
+
+    if (width == m_Width && height == m_Height && m_hBitmap)
+        return true;
+
+    if (m_hBitmap)
+    {
+        SelectObject(m_hMemDc, m_hOldBitmap);
+        DeleteObject(m_hBitmap);
+        m_hBitmap = nullptr;
+        m_hOldBitmap = nullptr;
+        m_pBits = nullptr;
+    }
+
+    BITMAPINFO bmi;
+    ZeroMemory(&bmi, sizeof(BITMAPINFO));
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = width;
+    bmi.bmiHeader.biHeight = -height;
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+
+    void *bits = nullptr;
+    m_hBitmap = CreateDIBSection(m_hMemDc, &bmi, DIB_RGB_COLORS, &bits, NULL, 0);
+    if (!m_hBitmap)
+        return false;
+    m_hOldBitmap = (HBITMAP)SelectObject(m_hMemDc, m_hBitmap);
+    m_pBits = bits;
+    m_Width = width;
+    m_Height = height;
+    return true;
+}
+
+ID2D1DeviceContext *LayeredWindowBackend::BeginFrame(int width, int height)
+{
+    if (width <= 0 || height <= 0 || !EnsureSurface(width, height))
+        return nullptr;
+
+    if (!m_pContext)
+    {
+        bool useHW = Settings::GetGlobalBool("useHardwareAcceleration", false);
+        D2D1_RENDER_TARGET_TYPE rtType = useHW ? D2D1_RENDER_TARGET_TYPE_DEFAULT : D2D1_RENDER_TARGET_TYPE_SOFTWARE;
+
+        D2D1_RENDER_TARGET_PROPERTIES props = D2D1::RenderTargetProperties(
+            rtType,
+            D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED),
+            0, 0,
+            D2D1_RENDER_TARGET_USAGE_GDI_COMPATIBLE);
+
+        ComPtr<ID2D1DCRenderTarget> pDCRT;
+        HRESULT hr = Direct2D::GetFactory()->CreateDCRenderTarget(&props, pDCRT.GetAddressOf());
+        if (SUCCEEDED(hr))
+        {
+            hr = pDCRT.As<ID2D1DeviceContext>(&m_pContext);
+        }
+
+        if (FAILED(hr))
+        {
+            Logging::Log(LogLevel::Error, L"Failed to create D2D Context (0x%08X)", hr);
+            return nullptr;
+        }
+    }
+
+    ComPtr<ID2D1DCRenderTarget> pDCRT;
+    if (SUCCEEDED(m_pContext.As(&pDCRT)))
+    {
+        RECT renderRect = {0, 0, width, height};
+        HRESULT hr = pDCRT->BindDC(m_hMemDc, &renderRect);
+        if (FAILED(hr))
+        {
+            Logging::Log(LogLevel::Error, L"BindDC failed (0x%08X)", hr);
+        }
+    }
+
+    m_pContext->BeginDraw();
+    m_pContext->Clear(D2D1::ColorF(0, 0, 0, 0));
+    return m_pContext.Get();
+}
+
+bool LayeredWindowBackend::EndFrame()
+{
+    if (!m_pContext)
+        return false;
+    return FinishDraw(m_pContext);
+}
+
+BYTE *LayeredWindowBackend::GetPixels(int &stride)
+{
+    stride = m_Width * 4;
+    return static_cast<BYTE *>(m_pBits);
+}
+
+WicBitmapBackend::~WicBitmapBackend()
+{
+    ReleaseSurface();
+}
+
+void WicBitmapBackend::Unlock()
+{
+    m_pLock.Reset();
+}
+
+void WicBitmapBackend::ReleaseSurface()
+{
+    Unlock();
+    m_pContext.Reset();
+    m_pBitmap.Reset();
+    m_Width = 0;
+    m_Height = 0;
+}
+
+ID2D1DeviceContext *WicBitmapBackend::BeginFrame(int width, int height)
+{
+    Unlock();
+    if (width <= 0 || height <= 0)
+        return nullptr;
+
+    IWICImagingFactory *wicFactory = Direct2D::GetWICFactory();
+    ID2D1Factory1 *d2dFactory = Direct2D::GetFactory();
+    if (!wicFactory || !d2dFactory)
+        return nullptr;
+
+    if (!m_pBitmap || width != m_Width || height != m_Height)
+    {
+        m_pContext.Reset();
+        m_pBitmap.Reset();
+        HRESULT hr = wicFactory->CreateBitmap(width, height, GUID_WICPixelFormat32bppPBGRA,
+                                              WICBitmapCacheOnDemand, m_pBitmap.GetAddressOf());
+        if (FAILED(hr))
+        {
+            Logging::Log(LogLevel::Error, L"Failed to create offscreen bitmap %dx%d (0x%08X)", width, height, hr);
+            return nullptr;
+        }
+        m_Width = width;
+        m_Height = height;
+    }
+
+    if (!m_pContext)
+    {
+        D2D1_RENDER_TARGET_PROPERTIES props = D2D1::RenderTargetProperties(
+            D2D1_RENDER_TARGET_TYPE_SOFTWARE,
+            D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED));
+
+        ComPtr<ID2D1RenderTarget> target;
+        HRESULT hr = d2dFactory->CreateWicBitmapRenderTarget(m_pBitmap.Get(), &props, target.GetAddressOf());
+        if (SUCCEEDED(hr))
+        {
+            hr = target.As<ID2D1DeviceContext>(&m_pContext);
+        }
+        if (FAILED(hr))
+        {
+            Logging::Log(LogLevel::Error, L"Failed to create offscreen D2D Context (0x%08X)", hr);
+            return nullptr;
+        }
+    }
+
+    m_pContext->BeginDraw();
+    m_pContext->Clear(D2D1::ColorF(0, 0, 0, 0));
+    return m_pContext.Get();
+}
+
+bool WicBitmapBackend::EndFrame()
+{
+    if (!m_pContext)
+        return false;
+    return FinishDraw(m_pContext);
+}
+
+BYTE *WicBitmapBackend::GetPixels(int &stride)
+{
+    stride = 0;
+    if (!m_pBitmap)
+        return nullptr;
+
+    if (!m_pLock)
+    {
+        WICRect rect = {0, 0, m_Width, m_Height};
+        if (FAILED(m_pBitmap->Lock(&rect, WICBitmapLockRead | WICBitmapLockWrite, m_pLock.GetAddressOf())))
+            return nullptr;
+    }
+
+    UINT lockStride = 0;
+    UINT size = 0;
+    BYTE *data = nullptr;
+    if (FAILED(m_pLock->GetStride(&lockStride)) || FAILED(m_pLock->GetDataPointer(&size, &data)))
+        return nullptr;
+    stride = static_cast<int>(lockStride);
+    return data;
+}
+
+bool WicBitmapBackend::SavePng(const std::wstring &path)
+{
+    IWICImagingFactory *wicFactory = Direct2D::GetWICFactory();
+    if (!wicFactory || !m_pBitmap)
+        return false;
+
+    Unlock();
+
+    ComPtr<IWICStream> stream;
+    HRESULT hr = wicFactory->CreateStream(stream.GetAddressOf());
+    if (SUCCEEDED(hr))
+        hr = stream->InitializeFromFilename(path.c_str(), GENERIC_WRITE);
+
+    ComPtr<IWICBitmapEncoder> encoder;
+    if (SUCCEEDED(hr))
+        hr = wicFactory->CreateEncoder(GUID_ContainerFormatPng, nullptr, encoder.GetAddressOf());
+    if (SUCCEEDED(hr))
+        hr = encoder->Initialize(stream.Get(), WICBitmapEncoderNoCache);
+
+    ComPtr<IWICBitmapFrameEncode> frame;
+    if (SUCCEEDED(hr))
+        hr = encoder->CreateNewFrame(frame.GetAddressOf(), nullptr);
+    if (SUCCEEDED(hr))
+        hr = frame->Initialize(nullptr);
+    if (SUCCEEDED(hr))
+        hr = frame->SetSize(m_Width, m_Height);
+
+    WICPixelFormatGUID format = GUID_WICPixelFormat32bppPBGRA;
+    if (SUCCEEDED(hr))
+        hr = frame->SetPixelFormat(&format);
+    if (SUCCEEDED(hr))
+        hr = frame->WriteSource(m_pBitmap.Get(), nullptr);
+    if (SUCCEEDED(hr))
+        hr = frame->Commit();
+    if (SUCCEEDED(hr))
+        hr = encoder->Commit();
+
+    if (FAILED(hr))
+    {
+        Logging::Log(LogLevel::Error, L"Failed to save PNG %s (0x%08X)", path.c_str(), hr);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,91 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#pragma once
+
+#include <windows.h>
+#include <d2d1_1.h>
+#include <wincodec.h>
+#include <wrl/client.h>
+#include <string>
+
+/*
+** Surface a widget frame is drawn into.
+**
+** BeginFrame() returns a device context that is already inside BeginDraw()
+** and cleared to transparent; EndFrame() finishes the frame. After a
+** successful frame GetPixels() exposes the result as top-down, premultiplied
+** 32bpp BGRA.
+*/
+class RenderBackend
+{
+public:
+    virtual ~RenderBackend() {}
+
+    virtual ID2D1DeviceContext *BeginFrame(int width, int height) = 0;
+    // Returns false if the frame failed; the backend drops its context and recreates it next frame.
+    virtual bool EndFrame() = 0;
+    virtual BYTE *GetPixels(int &stride) = 0;
+    virtual void ReleaseSurface() = 0;
+};
+
+/*
+** GDI DIB section + ID2D1DCRenderTarget, presented with UpdateLayeredWindow.
+** Hardware or software rasterisation follows "useHardwareAcceleration".
+*/
+class LayeredWindowBackend : public RenderBackend
+{
+public:
+    ~LayeredWindowBackend() override;
+
+    ID2D1DeviceContext *BeginFrame(int width, int height) override;
+    bool EndFrame() override;
+    BYTE *GetPixels(int &stride) override;
+    void ReleaseSurface() override;
+
+    // Memory DC holding the DIB; valid after BeginFrame() even if drawing failed.
+    HDC GetMemoryDC() const { return m_hMemDc; }
+
+private:
+    bool EnsureSurface(int width, int height);
+
+    Microsoft::WRL::ComPtr<ID2D1DeviceContext> m_pContext;
+    HDC m_hMemDc = nullptr;
+    HBITMAP m_hBitmap = nullptr;
+    HBITMAP m_hOldBitmap = nullptr;
+    void *m_pBits = nullptr;
+    int m_Width = 0;
+    int m_Height = 0;
+};
+
+/*
+** Offscreen WIC bitmap render target. Always rasterised in software and
+** never touches a window or GDI, so frames are deterministic across runs
+** on the same machine; used by the render benchmark.
+*/
+class WicBitmapBackend : public RenderBackend
+{
+public:
+    ~WicBitmapBackend() override;
+
+    ID2D1DeviceContext *BeginFrame(int width, int height) override;
+    bool EndFrame() override;
+    BYTE *GetPixels(int &stride) override;
+    void ReleaseSurface() override;
+
+    IWICBitmap *GetBitmap() const { return m_pBitmap.Get(); }
+    bool SavePng(const std::wstring &path);
+
+private:
+    void Unlock();
+
+    Microsoft::WRL::ComPtr<IWICBitmap> m_pBitmap;
+    Microsoft::WRL::ComPtr<ID2D1DeviceContext> m_pContext;
+    Microsoft::WRL::ComPtr<IWICBitmapLock> m_pLock;
+    int m_Width = 0;
+    int m_Height = 0;
+};
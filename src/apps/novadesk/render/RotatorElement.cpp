@@ -114,7 +114,13 @@ void RotatorElement::Render(ID2D1DeviceContext *context)
 
     const float imageW = bitmap->GetSize().width;
     const float imageH = bitmap->GetSize().height;
-    const float opacity = m_RotatorImage.GetImageAlpha() / 255.0f;
+
+    // Tint/colour matrix are rasterised once by the image; the needle is then
+    // a rotated blit instead of an effect graph resampled every frame.
+    float opacity = 1.0f;
+    ID2D1Bitmap *needle = m_RotatorImage.GetProcessedBitmap(context, opacity);
+    if (!needle)
+        return;
 
     // Calculate the normalized value (0.0-1.0)
     double normalizedValue = 0.0;
@@ -154,9 +160,6 @@ void RotatorElement::Render(ID2D1DeviceContext *context)
 
     context->SetTransform(combinedTransform);
 
-    Microsoft::WRL::ComPtr<ID2D1Image> finalImage;
-    m_RotatorImage.BuildProcessedImage(context, finalImage);
-
     const D2D1_RECT_F srcRect = D2D1::RectF(0.0f, 0.0f, imageW, imageH);
     const D2D1_RECT_F dstRect = D2D1::RectF(0.0f, 0.0f, imageW, imageH);
 
@@ -164,16 +167,7 @@ void RotatorElement::Render(ID2D1DeviceContext *context)
                                                       ? D2D1_BITMAP_INTERPOLATION_MODE_LINEAR
                                                       : D2D1_BITMAP_INTERPOLATION_MODE_NEAREST_NEIGHBOR;
 
-    if (finalImage.Get() == static_cast<ID2D1Image *>(bitmap))
-    {
-        context->DrawBitmap(bitmap, &dstRect, opacity, interp, &srcRect);
-    }
-    else
-    {
-        const D2D1_POINT_2F targetOffset = D2D1::Point2F(0.0f, 0.0f);
-        context->DrawImage(finalImage.Get(), &targetOffset, &srcRect,
-                           m_AntiAlias ? D2D1_INTERPOLATION_MODE_LINEAR : D2D1_INTERPOLATION_MODE_NEAREST_NEIGHBOR);
-    }
+    context->DrawBitmap(needle, &dstRect, opacity, interp, &srcRect);
 
     // Restore original transform
     context->SetTransform(currentTransform);
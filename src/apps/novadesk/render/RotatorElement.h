@@ -21,6 +21,7 @@ public:
     virtual bool HitTest(int x, int y) override;
     virtual int GetAutoWidth() override;
     virtual int GetAutoHeight() override;
+    virtual size_t GetImageMemoryBytes() const override { return m_RotatorImage.GetMemoryBytes(); }
 
     virtual void OnOwnerHWNDSet() override;
     virtual void OnImageDownloaded(const std::wstring& url, const std::vector<BYTE>& buffer) override;
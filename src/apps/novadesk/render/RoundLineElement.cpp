@@ -31,6 +31,69 @@ int RoundLineElement::GetAutoHeight()
     return (int)ceilf(radius * 2.0f) + pad * 2;
 }
 
+ID2D1PathGeometry* RoundLineElement::GetTickGeometry(float radius, float startAngle)
+{
+    const float tickLen = (float)m_Thickness * 1.5f;
+    if (m_TickGeometry && m_TickRadius == radius && m_TickLength == tickLen && m_TickStartAngle == startAngle &&
+        m_TickTotalAngle == m_TotalAngle && m_TickCount == m_Ticks && m_TickClockwise == m_Clockwise) {
+        return m_TickGeometry.Get();
+    }
+
+    m_TickGeometry.Reset();
+    ID2D1Factory1* factory = Direct2D::GetFactory();
+    if (!factory || m_Ticks <= 0) return nullptr;
+
+    Microsoft::WRL::ComPtr<ID2D1PathGeometry> geometry;
+    Microsoft::WRL::ComPtr<ID2D1GeometrySink> sink;
+    if (FAILED(factory->CreatePathGeometry(geometry.GetAddressOf()))) return nullptr;
+    if (FAILED(geometry->Open(sink.GetAddressOf()))) return nullptr;
+
+    float tickAngleStep = m_TotalAngle / (float)m_Ticks;
+    float innerR = radius - tickLen / 2.0f;
+    float outerR = radius + tickLen / 2.0f;
+    for (int i = 0; i <= m_Ticks; i++) {
+        float angle = startAngle + i * tickAngleStep;
+        if (!m_Clockwise) angle = startAngle - i * tickAngleStep;
+        float rad = angle * 3.14159265f / 180.0f;
+        sink->BeginFigure(D2D1::Point2F(innerR * cos(rad), innerR * sin(rad)), D2D1_FIGURE_BEGIN_HOLLOW);
+        sink->AddLine(D2D1::Point2F(outerR * cos(rad), outerR * sin(rad)));
+        sink->EndFigure(D2D1_FIGURE_END_OPEN);
+    }
+    if (FAILED(sink->Close())) return nullptr;
+
+    m_TickGeometry = geometry;
+    m_TickRadius = radius;
+    m_TickLength = tickLen;
+    m_TickStartAngle = startAngle;
+    m_TickTotalAngle = m_TotalAngle;
+    m_TickCount = m_Ticks;
+    m_TickClockwise = m_Clockwise;
+    return m_TickGeometry.Get();
+}
+
+ID2D1StrokeStyle* RoundLineElement::GetStrokeStyle(RoundLineCap startCap, RoundLineCap endCap, const std::vector<float>& dashes)
+{
+    StrokeStyleCache& cache = m_StrokeStyles[dashes.empty() ? 0 : 1];
+    if (cache.built && cache.startCap == startCap && cache.endCap == endCap && cache.dashes == dashes) {
+        return cache.style.Get();
+    }
+
+    cache.style.Reset();
+    ID2D1Factory1* factory = Direct2D::GetFactory();
+    if (!factory) return nullptr;
+
+    cache.built = true;
+    cache.startCap = startCap;
+    cache.endCap = endCap;
+    cache.dashes = dashes;
+
+    D2D1_STROKE_STYLE_PROPERTIES strokeProps = D2D1::StrokeStyleProperties();
+    strokeProps.startCap = startCap == ROUNDLINE_CAP_ROUND ? D2D1_CAP_STYLE_ROUND : D2D1_CAP_STYLE_FLAT;
+    strokeProps.endCap = endCap == ROUNDLINE_CAP_ROUND ? D2D1_CAP_STYLE_ROUND : D2D1_CAP_STYLE_FLAT;
+    factory->CreateStrokeStyle(strokeProps, dashes.empty() ? nullptr : dashes.data(), (UINT32)dashes.size(), cache.style.GetAddressOf());
+    return cache.style.Get();
+}
+
 bool RoundLineElement::HitTest(int x, int y)
 {
     if (!GetPixelHitTest())
@@ -119,23 +182,11 @@ bool RoundLineElement::HitTest(int x, int y)
     };
 
     auto strokeContainsPoint = [&](ID2D1Geometry* geometry, float thickness, RoundLineCap sCap, RoundLineCap eCap, const std::vector<float>& dashes) -> bool {
-        D2D1_STROKE_STYLE_PROPERTIES strokeProps = D2D1::StrokeStyleProperties();
-        strokeProps.startCap = sCap == ROUNDLINE_CAP_ROUND ? D2D1_CAP_STYLE_ROUND : D2D1_CAP_STYLE_FLAT;
-        strokeProps.endCap = eCap == ROUNDLINE_CAP_ROUND ? D2D1_CAP_STYLE_ROUND : D2D1_CAP_STYLE_FLAT;
-
-        Microsoft::WRL::ComPtr<ID2D1StrokeStyle> strokeStyle;
-        if (!dashes.empty()) {
-            if (FAILED(factory->CreateStrokeStyle(strokeProps, dashes.data(), (UINT32)dashes.size(), strokeStyle.GetAddressOf()))) {
-                return false;
-            }
-        } else {
-            if (FAILED(factory->CreateStrokeStyle(strokeProps, nullptr, 0, strokeStyle.GetAddressOf()))) {
-                return false;
-            }
-        }
+        ID2D1StrokeStyle* strokeStyle = GetStrokeStyle(sCap, eCap, dashes);
+        if (!strokeStyle) return false;
 
         BOOL hit = FALSE;
-        if (SUCCEEDED(geometry->StrokeContainsPoint(p, thickness, strokeStyle.Get(), nullptr, &hit)) && hit) return true;
+        if (SUCCEEDED(geometry->StrokeContainsPoint(p, thickness, strokeStyle, nullptr, &hit)) && hit) return true;
         return false;
     };
 
@@ -161,30 +212,9 @@ bool RoundLineElement::HitTest(int x, int y)
 
     // Tick marks hit-test
     if (m_Ticks > 0) {
-        float tickAngleStep = m_TotalAngle / (float)m_Ticks;
-        float tickLen = (float)m_Thickness * 1.5f;
-        float innerR = radius - tickLen / 2.0f;
-        float outerR = radius + tickLen / 2.0f;
-
-        for (int i = 0; i <= m_Ticks; i++) {
-            float angle = startAngle + i * tickAngleStep;
-            if (!m_Clockwise) angle = startAngle - i * tickAngleStep;
-            float rad = angle * 3.14159265f / 180.0f;
-            D2D1_POINT_2F a = D2D1::Point2F(cx + innerR * cos(rad), cy + innerR * sin(rad));
-            D2D1_POINT_2F b = D2D1::Point2F(cx + outerR * cos(rad), cy + outerR * sin(rad));
-
-            Microsoft::WRL::ComPtr<ID2D1PathGeometry> geo;
-            if (FAILED(factory->CreatePathGeometry(geo.GetAddressOf()))) continue;
-            Microsoft::WRL::ComPtr<ID2D1GeometrySink> sink;
-            if (FAILED(geo->Open(sink.GetAddressOf()))) continue;
-            sink->BeginFigure(a, D2D1_FIGURE_BEGIN_HOLLOW);
-            sink->AddLine(b);
-            sink->EndFigure(D2D1_FIGURE_END_OPEN);
-            sink->Close();
-
-            BOOL hit = FALSE;
-            if (SUCCEEDED(geo->StrokeContainsPoint(p, 2.0f, nullptr, nullptr, &hit)) && hit) return true;
-        }
+        ID2D1PathGeometry* ticks = GetTickGeometry(radius, startAngle);
+        BOOL hit = FALSE;
+        if (ticks && SUCCEEDED(ticks->StrokeContainsPoint(D2D1::Point2F(p.x - cx, p.y - cy), 2.0f, nullptr, nullptr, &hit)) && hit) return true;
     }
 
     return false;
@@ -248,23 +278,14 @@ void RoundLineElement::Render(ID2D1DeviceContext* context)
         pSink->EndFigure(D2D1_FIGURE_END_OPEN);
         pSink->Close();
 
-        D2D1_STROKE_STYLE_PROPERTIES strokeProps = D2D1::StrokeStyleProperties();
-        strokeProps.startCap = sCap == ROUNDLINE_CAP_ROUND ? D2D1_CAP_STYLE_ROUND : D2D1_CAP_STYLE_FLAT;
-        strokeProps.endCap = eCap == ROUNDLINE_CAP_ROUND ? D2D1_CAP_STYLE_ROUND : D2D1_CAP_STYLE_FLAT;
-
-        Microsoft::WRL::ComPtr<ID2D1StrokeStyle> pStrokeStyle;
-        if (!dashes.empty()) {
-            Direct2D::GetFactory()->CreateStrokeStyle(strokeProps, dashes.data(), (UINT32)dashes.size(), &pStrokeStyle);
-        } else {
-            Direct2D::GetFactory()->CreateStrokeStyle(strokeProps, nullptr, 0, &pStrokeStyle);
-        }
+        ID2D1StrokeStyle* pStrokeStyle = GetStrokeStyle(sCap, eCap, dashes);
 
         if (endThick != -1 && endThick != thickness) {
             // Tapering implementation (Approximation using multiple segments if needed, here we just use average for now or complex path)
             // For now, let's just draw twice with different thickness or simple average
-            context->DrawGeometry(pPathGeometry.Get(), brush, (thickness + endThick) / 2.0f, pStrokeStyle.Get());
+            context->DrawGeometry(pPathGeometry.Get(), brush, (thickness + endThick) / 2.0f, pStrokeStyle);
         } else {
-            context->DrawGeometry(pPathGeometry.Get(), brush, (float)thickness, pStrokeStyle.Get());
+            context->DrawGeometry(pPathGeometry.Get(), brush, (float)thickness, pStrokeStyle);
         }
     };
 
@@ -298,21 +319,16 @@ void RoundLineElement::Render(ID2D1DeviceContext* context)
     }
 
     if (m_Ticks > 0) {
+        // One stroke for all ticks instead of a DrawLine per tick.
+        ID2D1PathGeometry* ticks = GetTickGeometry(radius, startAngle);
         Microsoft::WRL::ComPtr<ID2D1SolidColorBrush> pTickBrush;
         Direct2D::CreateSolidBrush(context, m_LineColor, m_LineAlpha / 255.0f, &pTickBrush);
-        float tickAngleStep = m_TotalAngle / (float)m_Ticks;
-        float tickLen = (float)m_Thickness * 1.5f;
-        for (int i = 0; i <= m_Ticks; i++) {
-            float angle = startAngle + i * tickAngleStep;
-            if (!m_Clockwise) angle = startAngle - i * tickAngleStep;
-            float rad = angle * 3.14159265f / 180.0f;
-            float innerR = radius - tickLen / 2.0f;
-            float outerR = radius + tickLen / 2.0f;
-            context->DrawLine(
-                D2D1::Point2F(centerX + innerR * cos(rad), centerY + innerR * sin(rad)),
-                D2D1::Point2F(centerX + outerR * cos(rad), centerY + outerR * sin(rad)),
-                pTickBrush.Get(), 2.0f
-            );
+        if (ticks && pTickBrush) {
+            D2D1_MATRIX_3X2_F tickTransform;
+            context->GetTransform(&tickTransform);
+            context->SetTransform(D2D1::Matrix3x2F::Translation(centerX, centerY) * tickTransform);
+            context->DrawGeometry(ticks, pTickBrush.Get(), 2.0f);
+            context->SetTransform(tickTransform);
         }
     }
 
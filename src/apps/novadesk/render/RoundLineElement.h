@@ -94,6 +94,9 @@ public:
 
 
 private:
+    ID2D1PathGeometry* GetTickGeometry(float radius, float startAngle);
+    ID2D1StrokeStyle* GetStrokeStyle(RoundLineCap startCap, RoundLineCap endCap, const std::vector<float>& dashes);
+
     float m_Value; // 0.0 to 1.0
     int m_Radius = 0;
     int m_Thickness = 2;
@@ -117,6 +120,26 @@ private:
 
     GradientInfo m_LineGradient;
     GradientInfo m_LineGradientBg;
+
+    // All tick marks as one geometry centred on (0, 0), rebuilt when the
+    // radius, thickness, angles or tick count change.
+    Microsoft::WRL::ComPtr<ID2D1PathGeometry> m_TickGeometry;
+    float m_TickRadius = 0.0f;
+    float m_TickLength = 0.0f;
+    float m_TickStartAngle = 0.0f;
+    float m_TickTotalAngle = 0.0f;
+    int m_TickCount = 0;
+    bool m_TickClockwise = true;
+
+    // Stroke styles for the undashed (background) and dashed (value) arcs.
+    struct StrokeStyleCache {
+        RoundLineCap startCap = ROUNDLINE_CAP_FLAT;
+        RoundLineCap endCap = ROUNDLINE_CAP_FLAT;
+        std::vector<float> dashes;
+        bool built = false;     // also set when creation failed, so it is not retried every frame
+        Microsoft::WRL::ComPtr<ID2D1StrokeStyle> style;
+    };
+    StrokeStyleCache m_StrokeStyles[2];
 };
 
 #endif
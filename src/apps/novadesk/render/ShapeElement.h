@@ -109,7 +109,28 @@ public:
     bool IsConsumed() const { return m_CombineConsumerCount > 0; }
     D2D1_MATRIX_3X2_F GetRenderTransformMatrix() const;
 
+    // Bumped whenever the shape's outline changes (radii, points, path data).
+    // Position and size are not included; callers compare those separately.
+    unsigned int GetGeometryRevision() const { return m_GeometryRevision; }
+
+    // Opacity mask retained across frames while this shape clips container
+    // children (see WidgetLayoutHelper::RenderContainerChildren).
+    struct ContainerMask {
+        Microsoft::WRL::ComPtr<ID2D1DeviceContext> context;
+        Microsoft::WRL::ComPtr<ID2D1Layer> layer;
+        Microsoft::WRL::ComPtr<ID2D1BitmapBrush> brush;
+        int width = 0;
+        int height = 0;
+        int offsetX = 0;
+        int offsetY = 0;
+        int originX = 0;
+        int originY = 0;
+        unsigned int geometryRevision = 0;
+    };
+    ContainerMask& GetContainerMask() { return m_ContainerMask; }
+
 protected:
+    void InvalidateGeometry() { ++m_GeometryRevision; }
 
     bool m_HasStroke = false;
     float m_StrokeWidth = 1.0f;
@@ -136,6 +157,8 @@ protected:
     bool m_UpdateStrokeStyle = false;
     ID2D1StrokeStyle1* m_StrokeStyle = nullptr;
     int m_CombineConsumerCount = 0;
+    unsigned int m_GeometryRevision = 1;
+    ContainerMask m_ContainerMask;
 
     void CreateBrush(ID2D1DeviceContext* context, ID2D1Brush** ppBrush, bool isStroke);
     void UpdateStrokeStyle(ID2D1DeviceContext* context);
@@ -11,6 +11,7 @@
 #include <d2d1effects.h>
 #include <cwctype>
 #include <algorithm>
+#include <cmath>
 #include "FontManager.h"
 #include "ColorUtil.h"
 #include "Utils.h"
@@ -692,6 +693,20 @@ GfxRect TextElement::GetBounds()
     return GfxRect(x, y, w, h);
 }
 
+GfxRect TextElement::GetVisualBounds()
+{
+    GfxRect visual = Element::GetVisualBounds();
+    const GfxRect bounds = GetBounds();
+    for (const TextShadow &shadow : m_Shadows)
+    {
+        // Shadows are blurred with a standard deviation of blur / 2.
+        const int reach = (int)std::ceil(std::max(0.0f, shadow.blur) * 1.5f) + 1;
+        const GfxRect cast((int)std::floor(bounds.X + shadow.offsetX), (int)std::floor(bounds.Y + shadow.offsetY), bounds.Width + 1, bounds.Height + 1);
+        visual = visual.Union(cast.Inflate(reach));
+    }
+    return visual;
+}
+
 bool TextElement::HitTest(int x, int y)
 {
     // Bounding box check first (Element's bounds)
@@ -1100,8 +1115,7 @@ void TextElement::HandleTextSelectionMouseDown(int x, int y)
     UINT32 position = HitTestTextPosition(x, y);
     m_IsSelecting = true;
     m_SelectionAnchor = position;
-    m_SelectionStart = position;
-    m_SelectionEnd = position;
+    SetSelectionRange(position, position);
 }
 
 void TextElement::HandleTextSelectionMouseMove(int x, int y)
@@ -1112,15 +1126,9 @@ void TextElement::HandleTextSelectionMouseMove(int x, int y)
     UINT32 position = HitTestTextPosition(x, y);
     
     if (position < m_SelectionAnchor)
-    {
-        m_SelectionStart = position;
-        m_SelectionEnd = m_SelectionAnchor;
-    }
+        SetSelectionRange(position, m_SelectionAnchor);
     else
-    {
-        m_SelectionStart = m_SelectionAnchor;
-        m_SelectionEnd = position;
-    }
+        SetSelectionRange(m_SelectionAnchor, position);
 }
 
 void TextElement::HandleTextSelectionMouseUp()
@@ -1130,12 +1138,24 @@ void TextElement::HandleTextSelectionMouseUp()
 
 void TextElement::ClearTextSelection()
 {
-    m_SelectionStart = 0;
-    m_SelectionEnd = 0;
+    SetSelectionRange(0, 0);
     m_SelectionAnchor = 0;
     m_IsSelecting = false;
 }
 
+/*
+** The highlight is part of what the element paints, so a cached subtree
+** (cacheAsBitmap) has to be redrawn whenever the range changes.
+*/
+void TextElement::SetSelectionRange(UINT32 start, UINT32 end)
+{
+    if (start == m_SelectionStart && end == m_SelectionEnd)
+        return;
+    m_SelectionStart = start;
+    m_SelectionEnd = end;
+    InvalidateRender();
+}
+
 std::wstring TextElement::GetSelectedText() const
 {
     if (!HasTextSelection())
@@ -1151,8 +1171,7 @@ std::wstring TextElement::GetSelectedText() const
 void TextElement::SelectAll()
 {
     std::wstring processedText = GetProcessedText();
-    m_SelectionStart = 0;
-    m_SelectionEnd = (UINT32)processedText.length();
+    SetSelectionRange(0, (UINT32)processedText.length());
     m_SelectionAnchor = 0;
 }
 
@@ -1212,8 +1231,7 @@ void TextElement::SelectWordAt(UINT32 position)
     UINT32 wordStart, wordEnd;
     FindWordBoundaries(position, wordStart, wordEnd);
     
-    m_SelectionStart = wordStart;
-    m_SelectionEnd = wordEnd;
+    SetSelectionRange(wordStart, wordEnd);
     m_SelectionAnchor = wordStart;
 }
 
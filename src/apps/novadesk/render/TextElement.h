@@ -152,6 +152,7 @@ public:
     virtual int GetAutoWidth() override;
     virtual int GetAutoHeight() override;
     virtual GfxRect GetBounds() override; // Keeping ROI as GfxRect for now as it's used for layout, but internally use D2D
+    virtual GfxRect GetVisualBounds() override;
     virtual bool HitTest(int x, int y) override;
 
     std::wstring GetProcessedText() const;
@@ -171,6 +172,7 @@ private:
     void ParseInlineStyles();
     UINT32 HitTestTextPosition(int x, int y);
     void FindWordBoundaries(UINT32 position, UINT32& wordStart, UINT32& wordEnd);
+    void SetSelectionRange(UINT32 start, UINT32 end);
 
     std::wstring m_Text;
     std::wstring m_CleanText;
@@ -20,6 +20,7 @@
 #include "../../shared/FileUtils.h"
 #include "../../shared/Logging.h"
 #include "../../shared/PathUtils.h"
+#include "../../core/PerfCounters.h"
 #include "../../shared/System.h"
 #include "../../shared/Utils.h"
 #include "../../domain/Novadesk.h"
@@ -94,6 +95,13 @@ namespace JSEngine
         std::unordered_set<std::wstring> g_staleScripts;
         std::unordered_map<std::wstring, int> g_scriptEvalRevisions;
 
+        // Keep the structured log source in sync with the script being executed.
+        void SetCurrentScriptPath(const std::wstring &path)
+        {
+            g_currentScriptPath = path;
+            Logging::SetThreadLogSource(path);
+        }
+
         class ScriptExecutionScope
         {
         public:
@@ -102,14 +110,14 @@ namespace JSEngine
             {
                 if (!ownerScriptPath.empty())
                 {
-                    g_currentScriptPath = ownerScriptPath;
+                    SetCurrentScriptPath(ownerScriptPath);
                     g_currentScriptDir = PathUtils::GetParentDir(ownerScriptPath);
                 }
             }
 
             ~ScriptExecutionScope()
             {
-                g_currentScriptPath = m_PreviousScriptPath;
+                SetCurrentScriptPath(m_PreviousScriptPath);
                 g_currentScriptDir = m_PreviousScriptDir;
             }
 
@@ -371,7 +379,7 @@ namespace JSEngine
             const std::wstring scriptDir = PathUtils::GetParentDir(finalScriptPath);
             const std::string dirName = Utils::ToString(scriptDir);
             g_currentScriptDir = scriptDir;
-            g_currentScriptPath = finalScriptPath;
+            SetCurrentScriptPath(finalScriptPath);
 
             JSValue global = JS_GetGlobalObject(g_context);
             JSValue mainIpc = CreateMainIpcObject(g_context);
@@ -408,7 +416,7 @@ namespace JSEngine
                 LogQuickJsException(g_context);
                 JS_FreeValue(g_context, result);
                 g_currentScriptDir.clear();
-                g_currentScriptPath.clear();
+                SetCurrentScriptPath(std::wstring());
                 return false;
             }
             JS_FreeValue(g_context, result);
@@ -422,13 +430,13 @@ namespace JSEngine
                 {
                     LogQuickJsException(ctx1 ? ctx1 : g_context);
                     g_currentScriptDir.clear();
-                    g_currentScriptPath.clear();
+                    SetCurrentScriptPath(std::wstring());
                     return false;
                 }
             }
 
             g_currentScriptDir.clear();
-            g_currentScriptPath.clear();
+            SetCurrentScriptPath(std::wstring());
             return true;
         }
 
@@ -455,14 +463,6 @@ namespace JSEngine
 
         JSValue JsConsoleWrite(JSContext *ctx, JSValueConst, int argc, JSValueConst *argv, int magic)
         {
-            std::wstring msg;
-            for (int i = 0; i < argc; ++i)
-            {
-                if (!msg.empty())
-                    msg += L" ";
-                msg += JsValueToWString(ctx, argv[i]);
-            }
-
             LogLevel lvl = LogLevel::Info;
             switch (static_cast<ConsoleLevel>(magic))
             {
@@ -482,6 +482,18 @@ namespace JSEngine
                 lvl = LogLevel::Debug;
                 break;
             }
+
+            // Skip stringifying the arguments when the message would be filtered out anyway.
+            if (!Logging::IsEnabled(lvl))
+                return JS_UNDEFINED;
+
+            std::wstring msg;
+            for (int i = 0; i < argc; ++i)
+            {
+                if (!msg.empty())
+                    msg += L" ";
+                msg += JsValueToWString(ctx, argv[i]);
+            }
             Logging::Log(lvl, L"%s", msg.c_str());
             return JS_UNDEFINED;
         }
@@ -1195,6 +1207,7 @@ namespace JSEngine
             {
                 return JS_ThrowTypeError(ctx, "ipc.sendToUi requires at least a type");
             }
+            PerfCounters::ScopedTimer dispatchTimer(PerfCounters::Histogram::IpcDispatchTime, PerfCounters::Counter::IpcMessages);
             JSValue payload = (argc > 1) ? argv[1] : JS_UNDEFINED;
             JSValue msg = BuildIpcMessage(ctx, argv[0], payload, "main", "ui", nullptr);
             DispatchIpc(g_uiIpcListeners, msg);
@@ -1228,6 +1241,7 @@ namespace JSEngine
             {
                 return JS_ThrowTypeError(ctx, "ipc.sendToMain requires at least a type");
             }
+            PerfCounters::ScopedTimer dispatchTimer(PerfCounters::Histogram::IpcDispatchTime, PerfCounters::Counter::IpcMessages);
             JSValue payload = (argc > 1) ? argv[1] : JS_UNDEFINED;
             JSValue msg = BuildIpcMessage(ctx, argv[0], payload, "ui", "main", nullptr);
             DispatchIpc(g_mainIpcListeners, msg);
@@ -1257,6 +1271,7 @@ namespace JSEngine
                 return JS_ThrowReferenceError(ctx, "No ipcMain handler for channel: %s", channel.c_str());
             }
 
+            PerfCounters::ScopedTimer dispatchTimer(PerfCounters::Histogram::IpcDispatchTime, PerfCounters::Counter::IpcMessages);
             JSValue payload = (argc > 1) ? argv[1] : JS_UNDEFINED;
             JSValue channelVal = JS_NewString(ctx, channel.c_str());
             JSValue eventObj = BuildIpcMessage(ctx, channelVal, payload, "ui", "main", channel.c_str());
@@ -1624,12 +1639,30 @@ namespace JSEngine
         return g_loadedScriptPaths;
     }
 
+    RuntimeStats GetRuntimeStats()
+    {
+        RuntimeStats stats;
+        stats.timerCount = g_timers.size();
+        stats.scriptCount = g_loadedScriptPaths.size();
+        if (g_runtime)
+        {
+            JSMemoryUsage usage{};
+            JS_ComputeMemoryUsage(g_runtime, &usage);
+            stats.mallocSize = usage.malloc_size;
+            stats.memoryUsed = usage.memory_used_size;
+            stats.objectCount = usage.obj_count;
+        }
+        return stats;
+    }
+
     void OnTimer(UINT_PTR id)
     {
         auto it = g_timers.find(id);
         if (it == g_timers.end())
             return;
 
+        PerfCounters::ScopedTimer callbackTimer(PerfCounters::Histogram::TimerCallbackTime, PerfCounters::Counter::TimerCallbacks);
+
         if (it->second.repeat)
         {
             TimerEntry &entry = it->second;
@@ -1895,6 +1928,48 @@ namespace JSEngine
         }
     }
 
+    void CallVirtualListCallback(int callbackId, Widget *widget, const std::wstring &listId, int slot, int index)
+    {
+        if (!g_context || callbackId <= 0 || callbackId >= static_cast<int>(g_eventCallbacks.size()))
+        {
+            return;
+        }
+
+        JSValue callback = g_eventCallbacks[callbackId];
+        if (JS_IsUndefined(callback) || JS_IsNull(callback))
+        {
+            return;
+        }
+
+        JSValue arg = JS_NewObject(g_context);
+        if (widget)
+        {
+            JS_SetPropertyStr(g_context, arg, "widgetId",
+                              JS_NewString(g_context, Utils::ToString(widget->GetOptions().id).c_str()));
+        }
+
+        // e.id is the slot's element id; e.index is -1 for onCreateItem.
+        JS_SetPropertyStr(g_context, arg, "listId", JS_NewString(g_context, Utils::ToString(listId).c_str()));
+        JS_SetPropertyStr(g_context, arg, "id",
+                          JS_NewString(g_context, Utils::ToString(WidgetVirtualListHelper::GetItemId(listId, slot)).c_str()));
+        JS_SetPropertyStr(g_context, arg, "slot", JS_NewInt32(g_context, slot));
+        JS_SetPropertyStr(g_context, arg, "index", JS_NewInt32(g_context, index));
+
+        JSValue argv[1] = {arg};
+        const std::wstring ownerScriptPath = GetWidgetOwnerScriptPath(widget);
+        ScriptExecutionScope scope(ownerScriptPath);
+        JSValue ret = JS_Call(g_context, callback, JS_UNDEFINED, 1, argv);
+        JS_FreeValue(g_context, arg);
+        if (JS_IsException(ret))
+        {
+            LogQuickJsException(g_context);
+        }
+        else
+        {
+            JS_FreeValue(g_context, ret);
+        }
+    }
+
     int RegisterEventCallback(JSContext *ctx, JSValueConst fn)
     {
         if (!ctx || !JS_IsFunction(ctx, fn))
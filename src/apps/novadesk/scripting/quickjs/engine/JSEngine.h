@@ -41,6 +41,15 @@ namespace JSEngine
         std::string dismissalReason;
     };
 
+    struct RuntimeStats
+    {
+        int64_t mallocSize = 0;  // bytes allocated by the QuickJS runtime
+        int64_t memoryUsed = 0;  // bytes in use, including allocator overhead
+        int64_t objectCount = 0;
+        size_t timerCount = 0;
+        size_t scriptCount = 0;
+    };
+
     void InitializeJavaScriptAPI(duk_context *ctx);
     bool LoadAndExecuteScript(duk_context *ctx, const std::wstring &scriptPath = L"");
     bool LoadAndExecuteScripts(duk_context *ctx, const std::vector<std::wstring> &scriptPaths);
@@ -55,6 +64,7 @@ namespace JSEngine
     bool RemoveScript(const std::wstring &scriptPath);
     bool RefreshScript(const std::wstring &scriptPath);
     std::vector<std::wstring> GetLoadedScripts();
+    RuntimeStats GetRuntimeStats();
 
     void OnTimer(UINT_PTR id);
     void OnMessage(UINT message, WPARAM wParam, LPARAM lParam);
@@ -68,6 +78,7 @@ namespace JSEngine
     void TriggerWidgetEvent(Widget *widget, const char *eventName, const MouseEventData *data = nullptr);
     void CallEventCallback(int callbackId, Widget *widget = nullptr, const MouseEventData *data = nullptr);
     void CallEventCallbackWithText(int callbackId, Widget *widget, const std::wstring &text);
+    void CallVirtualListCallback(int callbackId, Widget *widget, const std::wstring &listId, int slot, int index);
     int RegisterEventCallback(JSContext *ctx, JSValueConst fn);
     bool RegisterWidgetEventListener(JSContext *ctx, Widget *widget, const std::string &eventName, JSValueConst fn);
     bool RegisterWidgetContextMenuCallback(JSContext *ctx, const std::wstring &widgetId, int commandId, JSValueConst fn);
@@ -9,6 +9,7 @@
 
 #include <algorithm>
 #include <atomic>
+#include <cstdint>
 #include <cwctype>
 #include <map>
 #include <unordered_map>
@@ -19,7 +20,10 @@
 
 #include "wintoastlib.h"
 #include "../../../Version.h"
+#include "../../core/TaskPool.h"
 #include "../../domain/Novadesk.h"
+#include "../../domain/PerfReport.h"
+#include "../../render/ImageStore.h"
 #include "../../shared/Logging.h"
 #include "../../shared/PathUtils.h"
 #include "../../shared/Settings.h"
@@ -69,10 +73,17 @@ namespace novadesk::scripting::quickjs
             void (*JsCallFunction)(novadesk_context ctx, void *funcPtr, int nargs);
             void (*JsCallFunctionNoArgs)(novadesk_context ctx, void *funcPtr);
             void (*ArrayPushObject)(novadesk_context ctx);
+            void (*RegisterArrayFloat32)(novadesk_context ctx, const char *name, const float *values, size_t count);
+            int (*StoreImage)(novadesk_context ctx, const char *path, const unsigned char *data, size_t size);
+            int (*QueueWork)(void (*work)(void *payload), void *payload);
+            int (*PostToMain)(void (*callback)(novadesk_context ctx, void *payload), void *payload);
+            void *(*CreatePromise)(novadesk_context ctx);
+            int (*SettlePromise)(void *promise, int resolve, void (*build)(novadesk_context ctx, void *payload), void *payload);
         };
 
         using NovadeskAddonInitFn = void (*)(novadesk_context ctx, HWND hMsgWnd, const NovadeskHostAPI *host);
         using NovadeskAddonUnloadFn = void (*)();
+        using NovadeskAddonSetHostApiSizeFn = uint32_t (*)(uint32_t hostSize);
 
         bool g_moduleDebug = false;
         int g_nextTrayCommandId = 1;
@@ -501,6 +512,25 @@ namespace novadesk::scripting::quickjs
             JS_SetPropertyStr(call->ctx, call->stack.back(), name, arr);
         }
 
+        static void host_RegisterArrayFloat32(novadesk_context c, const char *name, const float *values, size_t count)
+        {
+            auto *call = reinterpret_cast<AddonCallContext *>(c);
+            if (!call || call->stack.empty() || !name)
+                return;
+            JSValue buffer = JS_NewArrayBufferCopy(call->ctx, reinterpret_cast<const uint8_t *>(values), count * sizeof(float));
+            JSValue arr = JS_NewTypedArray(call->ctx, 1, &buffer, JS_TYPED_ARRAY_FLOAT32);
+            JS_FreeValue(call->ctx, buffer);
+            JS_SetPropertyStr(call->ctx, call->stack.back(), name, arr);
+        }
+
+        static int host_StoreImage(novadesk_context c, const char *path, const unsigned char *data, size_t size)
+        {
+            (void)c;
+            if (!path)
+                return 0;
+            return ImageStore::Put(Utils::ToWString(path), data, size) ? 1 : 0;
+        }
+
         static void host_RegisterFunction(novadesk_context c, const char *name, int (*func)(novadesk_context), int nargs)
         {
             auto *call = reinterpret_cast<AddonCallContext *>(c);
@@ -784,6 +814,268 @@ namespace novadesk::scripting::quickjs
             call->stack.push_back(obj);
         }
 
+        // Addon async work. Workers and main-thread callbacks are tagged with
+        // the module that owns the callback so UnloadAddonById can drop them.
+        TaskPool g_addonPool;
+        MainQueue g_addonMainQueue;
+
+        struct AddonPromise
+        {
+            JSContext *ctx = nullptr;
+            int addonId = 0;
+            JSValue resolve = JS_UNDEFINED;
+            JSValue reject = JS_UNDEFINED;
+        };
+
+        // Keyed by the id handed out as the promise handle, so a late or
+        // repeated settle finds nothing instead of a freed entry.
+        std::unordered_map<uint64_t, AddonPromise> g_addonPromises;
+        uint64_t g_nextAddonPromiseId = 1;
+
+        static HMODULE ModuleFromAddress(const void *address)
+        {
+            HMODULE module = nullptr;
+            if (!address ||
+                !GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                                    reinterpret_cast<LPCWSTR>(address), &module))
+            {
+                return nullptr;
+            }
+            return module;
+        }
+
+        static AddonInfo *FindAddonByModule(HMODULE module)
+        {
+            if (!module)
+                return nullptr;
+            for (auto &kv : g_loadedAddons)
+            {
+                if (kv.second.handle == module)
+                    return &kv.second;
+            }
+            return nullptr;
+        }
+
+        static AddonInfo *FindAddonById(int addonId)
+        {
+            auto pit = g_addonPathById.find(addonId);
+            if (pit == g_addonPathById.end())
+                return nullptr;
+            auto it = g_loadedAddons.find(pit->second);
+            return it != g_loadedAddons.end() ? &it->second : nullptr;
+        }
+
+        static void RunPendingJobs(JSContext *ctx)
+        {
+            JSRuntime *runtime = ctx ? JS_GetRuntime(ctx) : nullptr;
+            JSContext *jobCtx = nullptr;
+            while (runtime && JS_IsJobPending(runtime))
+            {
+                int err = JS_ExecutePendingJob(runtime, &jobCtx);
+                if (err < 0)
+                {
+                    if (jobCtx)
+                    {
+                        JS_FreeValue(jobCtx, JS_GetException(jobCtx));
+                    }
+                    break;
+                }
+            }
+        }
+
+        static void FreeCallContext(AddonCallContext &call)
+        {
+            for (JSValue &v : call.stack)
+                JS_FreeValue(call.ctx, v);
+            call.stack.clear();
+        }
+
+        static void DispatchAddonMainQueue(void *)
+        {
+            g_addonMainQueue.Drain();
+        }
+
+        static bool PostAddonTask(const void *owner, MainQueue::Task task)
+        {
+            if (!g_addonMainQueue.Post(owner, std::move(task)))
+                return true;
+
+            // One message per batch; everything posted before Drain() starts
+            // rides along with it. If the message cannot be posted the task
+            // stays queued and the next post tries to wake the main thread again.
+            HWND hwnd = JSEngine::GetMessageWindow();
+            if (!hwnd || !PostMessageW(hwnd, JSEngine::WM_NOVADESK_DISPATCH, reinterpret_cast<WPARAM>(&DispatchAddonMainQueue), 0))
+            {
+                Logging::Log(LogLevel::Error, L"Failed to wake the main thread for addon callbacks (Error: %d)", GetLastError());
+                g_addonMainQueue.WakeFailed();
+            }
+            return true;
+        }
+
+        static void RunAddonCallback(HMODULE owner, void (*callback)(novadesk_context, void *), void *payload)
+        {
+            AddonInfo *addon = FindAddonByModule(owner);
+            if (!addon || !addon->exportCtx)
+                return;
+
+            AddonCallContext call;
+            call.ctx = addon->exportCtx;
+            call.addon = addon;
+            callback(reinterpret_cast<novadesk_context>(&call), payload);
+            FreeCallContext(call);
+            if (call.hasThrow)
+            {
+                Logging::Log(LogLevel::Error, L"Addon main-thread callback failed: %s", Utils::ToWString(call.throwMessage).c_str());
+            }
+            RunPendingJobs(addon->exportCtx);
+        }
+
+        static void CallPromiseFunction(AddonPromise &entry, bool resolve, JSValue value)
+        {
+            JSValue ret = JS_Call(entry.ctx, resolve ? entry.resolve : entry.reject, JS_UNDEFINED, 1, &value);
+            JS_FreeValue(entry.ctx, value);
+            if (JS_IsException(ret))
+            {
+                JS_FreeValue(entry.ctx, JS_GetException(entry.ctx));
+            }
+            else
+            {
+                JS_FreeValue(entry.ctx, ret);
+            }
+            JS_FreeValue(entry.ctx, entry.resolve);
+            JS_FreeValue(entry.ctx, entry.reject);
+        }
+
+        static JSValue NewErrorValue(JSContext *ctx, const char *message)
+        {
+            JSValue error = JS_NewError(ctx);
+            JS_SetPropertyStr(ctx, error, "message", JS_NewString(ctx, message));
+            return error;
+        }
+
+        static void SettleAddonPromise(uint64_t id, bool resolve, void (*build)(novadesk_context, void *), void *payload)
+        {
+            auto it = g_addonPromises.find(id);
+            if (it == g_addonPromises.end())
+                return;
+            AddonPromise entry = it->second;
+            g_addonPromises.erase(it);
+
+            AddonCallContext call;
+            call.ctx = entry.ctx;
+            call.addon = FindAddonById(entry.addonId);
+            if (build)
+            {
+                build(reinterpret_cast<novadesk_context>(&call), payload);
+            }
+
+            JSValue value = JS_UNDEFINED;
+            if (call.hasThrow)
+            {
+                resolve = false;
+                value = NewErrorValue(entry.ctx, call.throwMessage.empty() ? "Addon promise rejected" : call.throwMessage.c_str());
+            }
+            else if (!call.stack.empty())
+            {
+                value = JS_DupValue(entry.ctx, call.stack.back());
+            }
+            FreeCallContext(call);
+
+            CallPromiseFunction(entry, resolve, value);
+            RunPendingJobs(entry.ctx);
+        }
+
+        static void RejectAddonPromises(int addonId)
+        {
+            std::vector<AddonPromise> orphaned;
+            for (auto it = g_addonPromises.begin(); it != g_addonPromises.end();)
+            {
+                if (it->second.addonId == addonId)
+                {
+                    orphaned.push_back(it->second);
+                    it = g_addonPromises.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+            for (AddonPromise &entry : orphaned)
+            {
+                CallPromiseFunction(entry, false, NewErrorValue(entry.ctx, "Addon unloaded"));
+            }
+            if (!orphaned.empty())
+            {
+                RunPendingJobs(orphaned.front().ctx);
+            }
+        }
+
+        static int host_QueueWork(void (*work)(void *), void *payload)
+        {
+            if (!work)
+                return 0;
+            HMODULE owner = ModuleFromAddress(reinterpret_cast<const void *>(work));
+            return g_addonPool.Submit(owner, [work, payload]()
+                                      { work(payload); })
+                       ? 1
+                       : 0;
+        }
+
+        static int host_PostToMain(void (*callback)(novadesk_context, void *), void *payload)
+        {
+            if (!callback)
+                return 0;
+            HMODULE owner = ModuleFromAddress(reinterpret_cast<const void *>(callback));
+            return PostAddonTask(owner, [owner, callback, payload]()
+                                 { RunAddonCallback(owner, callback, payload); })
+                       ? 1
+                       : 0;
+        }
+
+        static void *host_CreatePromise(novadesk_context c)
+        {
+            auto *call = reinterpret_cast<AddonCallContext *>(c);
+            if (!call || !call->ctx)
+                return nullptr;
+
+            JSValue funcs[2] = {JS_UNDEFINED, JS_UNDEFINED};
+            JSValue promise = JS_NewPromiseCapability(call->ctx, funcs);
+            if (JS_IsException(promise))
+            {
+                JS_FreeValue(call->ctx, JS_GetException(call->ctx));
+                if (!JS_IsUndefined(funcs[0]))
+                    JS_FreeValue(call->ctx, funcs[0]);
+                if (!JS_IsUndefined(funcs[1]))
+                    JS_FreeValue(call->ctx, funcs[1]);
+                call->hasThrow = true;
+                call->throwMessage = "CreatePromise failed";
+                return nullptr;
+            }
+
+            const uint64_t id = g_nextAddonPromiseId++;
+            AddonPromise &entry = g_addonPromises[id];
+            entry.ctx = call->ctx;
+            entry.addonId = call->addon ? call->addon->id : 0;
+            entry.resolve = funcs[0];
+            entry.reject = funcs[1];
+            call->stack.push_back(promise);
+            return reinterpret_cast<void *>(static_cast<uintptr_t>(id));
+        }
+
+        static int host_SettlePromise(void *promise, int resolve, void (*build)(novadesk_context, void *), void *payload)
+        {
+            if (!promise)
+                return 0;
+            const uint64_t id = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(promise));
+            // Without a build callback there is no addon code left to run, so
+            // the settle does not need to be dropped on unload.
+            HMODULE owner = build ? ModuleFromAddress(reinterpret_cast<const void *>(build)) : nullptr;
+            return PostAddonTask(owner, [id, resolve, build, payload]()
+                                 { SettleAddonPromise(id, resolve != 0, build, payload); })
+                       ? 1
+                       : 0;
+        }
+
         const NovadeskHostAPI g_hostApi = {
             host_RegisterString,
             host_RegisterNumber,
@@ -816,7 +1108,13 @@ namespace novadesk::scripting::quickjs
             host_JsGetFunctionPtr,
             host_JsCallFunction,
             host_JsCallFunctionNoArgs,
-            host_ArrayPushObject};
+            host_ArrayPushObject,
+            host_RegisterArrayFloat32,
+            host_StoreImage,
+            host_QueueWork,
+            host_PostToMain,
+            host_CreatePromise,
+            host_SettlePromise};
 
         bool UnloadAddonById(int addonId)
         {
@@ -831,6 +1129,9 @@ namespace novadesk::scripting::quickjs
                 return false;
             }
 
+            // Workers must be idle before the addon tears down what they use;
+            // callbacks it posted while unloading are dropped afterwards.
+            g_addonPool.Cancel(it->second.handle);
             if (it->second.unloadFn)
             {
                 try
@@ -842,6 +1143,8 @@ namespace novadesk::scripting::quickjs
                     Logging::Log(LogLevel::Error, L"Crash in NovadeskAddonUnload");
                 }
             }
+            g_addonMainQueue.Cancel(it->second.handle);
+            RejectAddonPromises(it->second.id);
 
             for (int id : it->second.registeredFunctionIds)
             {
@@ -1128,6 +1431,12 @@ namespace novadesk::scripting::quickjs
             return JS_NewString(ctx, Utils::ToString(Settings::GetLogPath()).c_str());
         }
 
+        JSValue JsAppGetPerfStats(JSContext *ctx, JSValueConst, int, JSValueConst *)
+        {
+            const std::string report = PerfReport::BuildJson();
+            return JS_ParseJSON(ctx, report.c_str(), report.size(), "<perf-stats>");
+        }
+
         JSValue JsAppIsPortable(JSContext *ctx, JSValueConst, int, JSValueConst *)
         {
             return JS_NewBool(ctx, PathUtils::IsPortableEnvironment() ? 1 : 0);
@@ -1526,6 +1835,18 @@ namespace novadesk::scripting::quickjs
                 return JS_NULL;
             }
 
+            // Optional: tells the addon which appended entries this host has.
+            // Addons without it only use the entries of the first SDK.
+            auto setHostApiSizeFn = reinterpret_cast<NovadeskAddonSetHostApiSizeFn>(GetProcAddress(module, "NovadeskAddonSetHostApiSize"));
+            if (setHostApiSizeFn)
+            {
+                const uint32_t addonApiSize = setHostApiSizeFn(static_cast<uint32_t>(sizeof(NovadeskHostAPI)));
+                if (addonApiSize > sizeof(NovadeskHostAPI))
+                {
+                    Logging::Log(LogLevel::Debug, L"Addon %s was built against a newer addon SDK; entries this host lacks are unavailable", addonPath.c_str());
+                }
+            }
+
             AddonInfo info{};
             info.id = g_nextAddonId++;
             info.handle = module;
@@ -1954,6 +2275,7 @@ namespace novadesk::scripting::quickjs
             JS_SetPropertyStr(ctx, app, "getAppDataPath", JS_NewCFunction(ctx, JsAppGetAppDataPath, "getAppDataPath", 0));
             JS_SetPropertyStr(ctx, app, "getSettingsFilePath", JS_NewCFunction(ctx, JsAppGetSettingsFilePath, "getSettingsFilePath", 0));
             JS_SetPropertyStr(ctx, app, "getLogPath", JS_NewCFunction(ctx, JsAppGetLogPath, "getLogPath", 0));
+            JS_SetPropertyStr(ctx, app, "getPerfStats", JS_NewCFunction(ctx, JsAppGetPerfStats, "getPerfStats", 0));
             JS_SetPropertyStr(ctx, app, "isPortable", JS_NewCFunction(ctx, JsAppIsPortable, "isPortable", 0));
             JS_SetPropertyStr(ctx, app, "isFirstRun", JS_NewCFunction(ctx, JsAppIsFirstRun, "isFirstRun", 0));
             JS_SetPropertyStr(ctx, app, "enableDebugging", JS_NewCFunction(ctx, JsAppEnableDebugging, "enableDebugging", 1));
@@ -76,6 +76,19 @@ namespace novadesk::scripting::quickjs
             return widget;
         }
 
+        const char *DecimationName(SeriesDecimation decimation)
+        {
+            switch (decimation)
+            {
+            case SeriesDecimation::MinMax:
+                return "minMax";
+            case SeriesDecimation::Lttb:
+                return "lttb";
+            default:
+                return "none";
+            }
+        }
+
         std::wstring ToGradientOrRGBAString(const GradientInfo &gradient, COLORREF color, BYTE alpha)
         {
             if (gradient.type == GRADIENT_NONE || gradient.stops.empty())
@@ -567,18 +580,7 @@ namespace novadesk::scripting::quickjs
                 }
             }
 
-            Widget::LayoutConfig cfg;
-            cfg.direction = layoutOptions.direction;
-            cfg.flexDirection = layoutOptions.flexDirection;
-            cfg.gap = layoutOptions.gap;
-            if (!layoutOptions.align.empty())
-                cfg.align = layoutOptions.align;
-            if (!layoutOptions.justify.empty())
-                cfg.justify = layoutOptions.justify;
-            cfg.paddingLeft = layoutOptions.paddingLeft;
-            cfg.paddingTop = layoutOptions.paddingTop;
-            cfg.paddingRight = layoutOptions.paddingRight;
-            cfg.paddingBottom = layoutOptions.paddingBottom;
+            const Widget::LayoutConfig cfg = PropertyParser::GetLayoutBoxFlexConfig(layoutOptions);
 
             // Logging::Log(LogLevel::Debug, L"[PADDING] JsWidgetAddLayoutBox SetLayoutConfig for '%s': L=%d, T=%d, R=%d, B=%d",
             //     shapeOptions.id.c_str(), cfg.paddingLeft, cfg.paddingTop, cfg.paddingRight, cfg.paddingBottom);
@@ -914,41 +916,13 @@ namespace novadesk::scripting::quickjs
             else if (auto *layout = dynamic_cast<ElementLayoutBox *>(element))
             {
                 PropertyParser::LayoutBoxOptions options;
-                Widget::LayoutConfig cfg{};
-                if (widget->TryGetLayoutConfig(id, cfg))
-                {
-                    PropertyParser::PreFillLayoutBoxOptions(
-                        options,
-                        layout,
-                        &cfg.direction,
-                        &cfg.gap,
-                        &cfg.align,
-                        &cfg.justify,
-                        &cfg.paddingLeft,
-                        &cfg.paddingTop,
-                        &cfg.paddingRight,
-                        &cfg.paddingBottom);
-                }
-                else
-                {
-                    PropertyParser::PreFillLayoutBoxOptions(options, layout);
-                }
+                PropertyParser::PreFillLayoutBoxOptions(options, layout);
                 PropertyParser::ParseLayoutBoxOptions(ctx, argv[1], options, baseDir);
                 if (options.hasBoxShadowError)
                     return ThrowTypeError(ctx, "setElementProperties", Utils::ToString(options.boxShadowError).c_str());
                 PropertyParser::ApplyLayoutBoxOptions(layout, options);
 
-                Widget::LayoutConfig nextCfg{};
-                nextCfg.direction = options.direction;
-                nextCfg.flexDirection = options.flexDirection;
-                nextCfg.gap = options.gap;
-                nextCfg.align = options.align.empty() ? L"start" : options.align;
-                nextCfg.justify = options.justify.empty() ? L"start" : options.justify;
-                nextCfg.paddingLeft = options.paddingLeft;
-                nextCfg.paddingTop = options.paddingTop;
-                nextCfg.paddingRight = options.paddingRight;
-                nextCfg.paddingBottom = options.paddingBottom;
-                widget->SetLayoutConfig(id, nextCfg);
+                widget->SetLayoutConfig(id, PropertyParser::GetLayoutBoxFlexConfig(options));
             }
             else if (auto *shape = dynamic_cast<ShapeElement *>(element))
             {
@@ -986,6 +960,51 @@ namespace novadesk::scripting::quickjs
                 PropertyParser::ApplyInputBoxOptions(input, options);
             }
 
+            // Size or content may have changed: reflow the enclosing layout.
+            widget->MarkLayoutDirty(element);
+            widget->UpdateVirtualList(id);
+            widget->Redraw();
+            return JS_UNDEFINED;
+        }
+
+        JSValue JsWidgetSetVirtualList(JSContext *ctx, JSValueConst thisVal, int argc, JSValueConst *argv)
+        {
+            Widget *widget = GetAnyWidget(ctx, thisVal);
+            if (!widget)
+                return JS_UNDEFINED;
+            if (argc < 2 || !JS_IsObject(argv[1]))
+                return ThrowTypeError(ctx, "setVirtualList", "expected (containerId, options)");
+
+            const char *idUtf8 = JS_ToCString(ctx, argv[0]);
+            if (!idUtf8)
+                return JS_EXCEPTION;
+            std::wstring id = Utils::ToWString(idUtf8);
+            JS_FreeCString(ctx, idUtf8);
+
+            if (!widget->FindElementById(id))
+                return JS_UNDEFINED;
+
+            // Partial updates (e.g. only itemCount) keep the rest of the config.
+            WidgetVirtualListHelper::Config cfg;
+            widget->TryGetVirtualList(id, cfg);
+            PropertyParser::VirtualListOptions options;
+            options.itemCount = cfg.itemCount;
+            options.itemSize = cfg.itemSize;
+            options.gap = cfg.gap;
+            options.overscan = cfg.overscan;
+            options.horizontal = cfg.horizontal;
+            options.onCreateItemCallbackId = cfg.onCreateItemCallbackId;
+            options.onBindItemCallbackId = cfg.onBindItemCallbackId;
+            PropertyParser::ParseVirtualListOptions(ctx, argv[1], options);
+
+            cfg.itemCount = options.itemCount;
+            cfg.itemSize = options.itemSize;
+            cfg.gap = options.gap;
+            cfg.overscan = options.overscan;
+            cfg.horizontal = options.horizontal;
+            cfg.onCreateItemCallbackId = options.onCreateItemCallbackId;
+            cfg.onBindItemCallbackId = options.onBindItemCallbackId;
+            widget->SetVirtualList(id, cfg);
             widget->Redraw();
             return JS_UNDEFINED;
         }
@@ -1054,6 +1073,8 @@ namespace novadesk::scripting::quickjs
 
         JSValue GetElementPropertyValue(JSContext *ctx, Widget *widget, Element *element, const std::string &prop)
         {
+            // Geometry must reflect layout changes queued since the last frame.
+            widget->FlushLayout();
             const GfxRect contentBounds = element->GetBounds();
             GfxRect outerBounds = element->GetBackgroundBounds();
             if (element->GetBevelType() != 0)
@@ -1098,10 +1119,22 @@ namespace novadesk::scripting::quickjs
                 return JS_NewString(ctx, Utils::ToString(element->GetCursorsDir()).c_str());
             if (prop == "rotate")
                 return JS_NewFloat64(ctx, element->GetRotate());
+            if (prop == "scrollX")
+                return JS_NewInt32(ctx, element->GetScrollX());
+            if (prop == "scrollY")
+                return JS_NewInt32(ctx, element->GetScrollY());
+            if (prop == "flexGrow")
+                return JS_NewFloat64(ctx, element->GetFlexGrow());
+            if (prop == "flexShrink")
+                return JS_NewFloat64(ctx, element->GetFlexShrink());
+            if (prop == "flexBasis")
+                return JS_NewInt32(ctx, element->GetFlexBasis());
             if (prop == "antiAlias")
                 return JS_NewBool(ctx, element->GetAntiAlias() ? 1 : 0);
             if (prop == "pixelHitTest")
                 return JS_NewBool(ctx, element->GetPixelHitTest() ? 1 : 0);
+            if (prop == "cacheAsBitmap")
+                return JS_NewBool(ctx, element->GetCacheAsBitmap() ? 1 : 0);
             if (prop == "backgroundColorRadius")
                 return JS_NewInt32(ctx, element->GetCornerRadius());
             if (prop == "backgroundColor" && element->HasSolidColor())
@@ -1431,6 +1464,8 @@ namespace novadesk::scripting::quickjs
                     return JS_NewInt32(ctx, graph->GetGridYSpacing());
                 if (prop == "graphStart")
                     return JS_NewString(ctx, graph->GetGraphStartLeft() ? "left" : "right");
+                if (prop == "decimation")
+                    return JS_NewString(ctx, DecimationName(graph->GetDecimation()));
                 if (prop == "flip")
                     return JS_NewBool(ctx, graph->GetFlip() ? 1 : 0);
             }
@@ -1535,6 +1570,8 @@ namespace novadesk::scripting::quickjs
                     return JS_NewFloat64(ctx, line->GetScaleMin());
                 if (prop == "rangeMax")
                     return JS_NewFloat64(ctx, line->GetScaleMax());
+                if (prop == "decimation")
+                    return JS_NewString(ctx, DecimationName(line->GetDecimation()));
 
                 if (prop == "data")
                 {
@@ -1797,17 +1834,26 @@ namespace novadesk::scripting::quickjs
                         return JS_NewString(ctx, styleToStr(layoutBox->GetListStyleType()));
                     }
                     
-                    // Layout configuration properties
+                    // Layout configuration properties read back as the script
+                    // set them, falling back to the parsed value.
                     Widget::LayoutConfig cfg{};
                     if (widget->TryGetLayoutConfig(element->GetId(), cfg))
                     {
+                        auto nameOr = [&](const std::wstring &name, const wchar_t *parsed) -> JSValue
+                        {
+                            return JS_NewString(ctx, Utils::ToString(name.empty() ? std::wstring(parsed) : name).c_str());
+                        };
                         if (prop == "direction")
                         {
-                            return JS_NewString(ctx, Utils::ToString(cfg.direction).c_str());
+                            return JS_NewString(ctx, Utils::ToString(FlexLayout::ToString(cfg.direction)).c_str());
                         }
                         if (prop == "flexDirection")
                         {
-                            return JS_NewString(ctx, Utils::ToString(cfg.flexDirection).c_str());
+                            return nameOr(cfg.names.flexDirection, FlexLayout::ToString(cfg.flexDirection));
+                        }
+                        if (prop == "flexWrap")
+                        {
+                            return nameOr(cfg.names.wrap, FlexLayout::ToString(cfg.wrap));
                         }
                         if (prop == "gap")
                         {
@@ -1815,11 +1861,11 @@ namespace novadesk::scripting::quickjs
                         }
                         if (prop == "alignItems" || prop == "align")
                         {
-                            return JS_NewString(ctx, Utils::ToString(cfg.align).c_str());
+                            return nameOr(cfg.names.align, FlexLayout::ToString(cfg.align));
                         }
                         if (prop == "justifyContent" || prop == "justify")
                         {
-                            return JS_NewString(ctx, Utils::ToString(cfg.justify).c_str());
+                            return nameOr(cfg.names.justify, FlexLayout::ToString(cfg.justify));
                         }
                     }
                     if (prop == "borderStyle")
@@ -2037,6 +2083,7 @@ namespace novadesk::scripting::quickjs
             JS_CFUNC_DEF("setElementProperties", 2, JsWidgetSetElementProperties),
             JS_CFUNC_DEF("setElementPropertyByGroup", 2, JsWidgetSetElementPropertiesByGroup),
             JS_CFUNC_DEF("setElementPropertiesByGroup", 2, JsWidgetSetElementPropertiesByGroup),
+            JS_CFUNC_DEF("setVirtualList", 2, JsWidgetSetVirtualList),
             JS_CFUNC_DEF("getElementProperty", 2, JsWidgetGetElementProperty),
             JS_CFUNC_DEF("isElementExist", 1, JsWidgetIsElementExist),
             JS_CFUNC_DEF("removeElements", 1, JsWidgetRemoveElements),
@@ -44,6 +44,7 @@ namespace PropertyParser
     void ParseRoundLineOptions(JSContext *ctx, JSValueConst obj, RoundLineOptions &options, const std::wstring &baseDir = L"");
     void ParseShapeOptions(JSContext *ctx, JSValueConst obj, ShapeOptions &options, const std::wstring &baseDir = L"");
     void ParseLayoutBoxOptions(JSContext *ctx, JSValueConst obj, LayoutBoxOptions &options, const std::wstring &baseDir = L"");
+    void ParseVirtualListOptions(JSContext *ctx, JSValueConst obj, VirtualListOptions &options);
     void ParseAnimationOptions(JSContext *ctx, JSValueConst obj, AnimationOptions &options);
     void ParseAreaGraphOptions(JSContext *ctx, JSValueConst obj, AreaGraphOptions &options, const std::wstring &baseDir = L"");
     void ParseInputBoxOptions(JSContext *ctx, JSValueConst obj, InputBoxOptions &options, const std::wstring &baseDir = L"");
@@ -74,18 +75,8 @@ namespace PropertyParser
     void PreFillHistogramOptions(HistogramOptions &options, HistogramElement *element);
     void PreFillRoundLineOptions(RoundLineOptions &options, RoundLineElement *element);
     void PreFillShapeOptions(ShapeOptions &options, ShapeElement *element);
-    void PreFillLayoutBoxOptions(
-        LayoutBoxOptions &options,
-        ElementLayoutBox *element,
-        const std::wstring *direction = nullptr,
-        const int *gap = nullptr,
-        const std::wstring *align = nullptr,
-        const std::wstring *justify = nullptr,
-        const int *paddingLeft = nullptr,
-        const int *paddingTop = nullptr,
-        const int *paddingRight = nullptr,
-        const int *paddingBottom = nullptr,
-        const std::wstring *flexDirection = nullptr);
+    void PreFillLayoutBoxOptions(LayoutBoxOptions &options, ElementLayoutBox *element);
+    FlexLayoutConfig GetLayoutBoxFlexConfig(const LayoutBoxOptions &options);
     void PreFillAreaGraphOptions(AreaGraphOptions &options, AreaGraphElement *element);
     void PreFillInputBoxOptions(InputBoxOptions &options, InputBoxElement *element);
 
@@ -22,6 +22,20 @@
 namespace PropertyParser
 {
     using namespace Js;
+
+    // "decimation": "minMax" | "lttb" | "none"; unknown values keep the current mode.
+    static void ParseDecimation(JSContext *ctx, JSValueConst obj, SeriesDecimation &decimation)
+    {
+        std::wstring value = GetStringProp(ctx, obj, "decimation");
+        std::transform(value.begin(), value.end(), value.begin(), ::towlower);
+        if (value == L"minmax")
+            decimation = SeriesDecimation::MinMax;
+        else if (value == L"lttb")
+            decimation = SeriesDecimation::Lttb;
+        else if (value == L"none")
+            decimation = SeriesDecimation::None;
+    }
+
     void ParseAreaGraphOptions(JSContext *ctx, JSValueConst obj, AreaGraphOptions &options, const std::wstring &baseDir)
     {
         ParseElementOptions(ctx, obj, options, baseDir);
@@ -100,6 +114,7 @@ namespace PropertyParser
         GetBoolProp(ctx, obj, "gridVisible", options.gridVisible);
         GetBoolProp(ctx, obj, "graphStartLeft", options.graphStartLeft);
         GetBoolProp(ctx, obj, "flip", options.flip);
+        ParseDecimation(ctx, obj, options.decimation);
     }
     void ParseBarOptions(JSContext *ctx, JSValueConst obj, BarOptions &options, const std::wstring &baseDir)
     {
@@ -189,6 +204,7 @@ namespace PropertyParser
         }
 
         GetBoolProp(ctx, obj, "autoRange", options.autoRange);
+        ParseDecimation(ctx, obj, options.decimation);
         GetFloatProp(ctx, obj, "rangeMin", options.scaleMin);
         GetFloatProp(ctx, obj, "rangeMax", options.scaleMax);
         if (options.scaleMax < options.scaleMin)
@@ -416,6 +432,7 @@ namespace PropertyParser
         element->SetGridYSpacing(options.gridY);
         element->SetGraphStartLeft(options.graphStartLeft);
         element->SetFlip(options.flip);
+        element->SetDecimation(options.decimation);
     }
 
     void ApplyBarOptions(BarElement *element, const BarOptions &options)
@@ -453,6 +470,7 @@ namespace PropertyParser
         element->SetStrokeTransformType(options.transformStroke);
         element->SetAutoRange(options.autoRange);
         element->SetScaleRange(options.scaleMin, options.scaleMax);
+        element->SetDecimation(options.decimation);
     }
 
     void ApplyHistogramOptions(HistogramElement *element, const HistogramOptions &options)
@@ -525,6 +543,7 @@ namespace PropertyParser
         options.gridY = element->GetGridYSpacing();
         options.graphStartLeft = element->GetGraphStartLeft();
         options.flip = element->GetFlip();
+        options.decimation = element->GetDecimation();
     }
 
     void PreFillBarOptions(BarOptions &options, BarElement *element)
@@ -534,8 +553,11 @@ namespace PropertyParser
         options.id = element->GetId();
         options.x = element->GetX();
         options.y = element->GetY();
-        options.width = element->IsWDefined() ? (element->GetWidth() - element->GetPaddingLeft() - element->GetPaddingRight()) : 0;
-        options.height = element->IsHDefined() ? (element->GetHeight() - element->GetPaddingTop() - element->GetPaddingBottom()) : 0;
+        options.width = element->GetSpecifiedWidth();
+        options.height = element->GetSpecifiedHeight();
+        options.flexGrow = element->GetFlexGrow();
+        options.flexShrink = element->GetFlexShrink();
+        options.flexBasis = element->GetFlexBasis();
 
         options.show = element->IsVisible();
         options.containerId = element->GetContainerId();
@@ -545,6 +567,7 @@ namespace PropertyParser
         options.cursorsDir = element->GetCursorsDir();
         options.rotate = element->GetRotate();
         options.antialias = element->GetAntiAlias();
+        options.cacheAsBitmap = element->GetCacheAsBitmap();
         options.solidColorRadius = element->GetCornerRadius();
 
         options.paddingLeft = element->GetPaddingLeft();
@@ -589,8 +612,11 @@ namespace PropertyParser
         options.id = element->GetId();
         options.x = element->GetX();
         options.y = element->GetY();
-        options.width = element->IsWDefined() ? (element->GetWidth() - element->GetPaddingLeft() - element->GetPaddingRight()) : 0;
-        options.height = element->IsHDefined() ? (element->GetHeight() - element->GetPaddingTop() - element->GetPaddingBottom()) : 0;
+        options.width = element->GetSpecifiedWidth();
+        options.height = element->GetSpecifiedHeight();
+        options.flexGrow = element->GetFlexGrow();
+        options.flexShrink = element->GetFlexShrink();
+        options.flexBasis = element->GetFlexBasis();
 
         options.show = element->IsVisible();
         options.containerId = element->GetContainerId();
@@ -600,6 +626,7 @@ namespace PropertyParser
         options.cursorsDir = element->GetCursorsDir();
         options.rotate = element->GetRotate();
         options.antialias = element->GetAntiAlias();
+        options.cacheAsBitmap = element->GetCacheAsBitmap();
         options.solidColorRadius = element->GetCornerRadius();
 
         options.paddingLeft = element->GetPaddingLeft();
@@ -648,6 +675,7 @@ namespace PropertyParser
         options.autoRange = element->GetAutoRange();
         options.scaleMin = element->GetScaleMin();
         options.scaleMax = element->GetScaleMax();
+        options.decimation = element->GetDecimation();
     }
 
     void PreFillHistogramOptions(HistogramOptions &options, HistogramElement *element)
@@ -682,8 +710,11 @@ namespace PropertyParser
         options.id = element->GetId();
         options.x = element->GetX();
         options.y = element->GetY();
-        options.width = element->IsWDefined() ? (element->GetWidth() - element->GetPaddingLeft() - element->GetPaddingRight()) : 0;
-        options.height = element->IsHDefined() ? (element->GetHeight() - element->GetPaddingTop() - element->GetPaddingBottom()) : 0;
+        options.width = element->GetSpecifiedWidth();
+        options.height = element->GetSpecifiedHeight();
+        options.flexGrow = element->GetFlexGrow();
+        options.flexShrink = element->GetFlexShrink();
+        options.flexBasis = element->GetFlexBasis();
 
         options.show = element->IsVisible();
         options.containerId = element->GetContainerId();
@@ -693,6 +724,7 @@ namespace PropertyParser
         options.cursorsDir = element->GetCursorsDir();
         options.rotate = element->GetRotate();
         options.antialias = element->GetAntiAlias();
+        options.cacheAsBitmap = element->GetCacheAsBitmap();
         options.solidColorRadius = element->GetCornerRadius();
 
         options.paddingLeft = element->GetPaddingLeft();
@@ -95,6 +95,7 @@ namespace PropertyParser
         GetBoolProp(ctx, obj, "antiAlias", options.antialias);
         if (GetBoolProp(ctx, obj, "pixelHitTest", options.pixelHitTest))
             options.hasPixelHitTest = true;
+        GetBoolProp(ctx, obj, "cacheAsBitmap", options.cacheAsBitmap);
         GetBoolProp(ctx, obj, "show", options.show);
         std::wstring containerId = GetStringProp(ctx, obj, "container");
         if (!containerId.empty())
@@ -120,6 +121,14 @@ namespace PropertyParser
             options.hasTransformMatrix = true;
         }
 
+        GetIntProp(ctx, obj, "scrollX", options.scrollX);
+        GetIntProp(ctx, obj, "scrollY", options.scrollY);
+        GetFloatProp(ctx, obj, "flexGrow", options.flexGrow);
+        GetFloatProp(ctx, obj, "flexShrink", options.flexShrink);
+        GetIntProp(ctx, obj, "flexBasis", options.flexBasis);
+        if (options.flexGrow < 0.0f) options.flexGrow = 0.0f;
+        if (options.flexShrink < 0.0f) options.flexShrink = 0.0f;
+
         GetEventCallbackProp(ctx, obj, "onLeftMouseUp", options.onLeftMouseUpCallbackId);
         GetEventCallbackProp(ctx, obj, "onLeftMouseDown", options.onLeftMouseDownCallbackId);
         GetEventCallbackProp(ctx, obj, "onLeftDoubleClick", options.onLeftDoubleClickCallbackId);
@@ -166,12 +175,18 @@ namespace PropertyParser
     {
         if (!element)
             return;
+        // Every Apply*Options path lands here, so this covers any property
+        // the subclass applies around it.
+        element->InvalidateRender();
         element->SetPosition(options.x, options.y);
         element->SetSize(options.width, options.height);
         element->SetRotate(options.rotate);
+        element->SetScroll(options.scrollX, options.scrollY);
+        element->SetFlexItem(options.flexGrow, options.flexShrink, options.flexBasis);
         element->SetAntiAlias(options.antialias);
         if (options.hasPixelHitTest)
             element->SetPixelHitTest(options.pixelHitTest);
+        element->SetCacheAsBitmap(options.cacheAsBitmap);
         element->SetShow(options.show);
         element->SetContainerId(options.containerId);
         element->SetGroupId(options.groupId);
@@ -276,8 +291,11 @@ namespace PropertyParser
         options.id = element->GetId();
         options.x = element->GetX();
         options.y = element->GetY();
-        options.width = element->IsWDefined() ? (element->GetWidth() - element->GetPaddingLeft() - element->GetPaddingRight()) : 0;
-        options.height = element->IsHDefined() ? (element->GetHeight() - element->GetPaddingTop() - element->GetPaddingBottom()) : 0;
+        options.width = element->GetSpecifiedWidth();
+        options.height = element->GetSpecifiedHeight();
+        options.flexGrow = element->GetFlexGrow();
+        options.flexShrink = element->GetFlexShrink();
+        options.flexBasis = element->GetFlexBasis();
 
         options.show = element->IsVisible();
         options.containerId = element->GetContainerId();
@@ -286,9 +304,12 @@ namespace PropertyParser
         options.mouseEventCursorName = element->GetMouseEventCursorName();
         options.cursorsDir = element->GetCursorsDir();
         options.rotate = element->GetRotate();
+        options.scrollX = element->GetScrollX();
+        options.scrollY = element->GetScrollY();
         options.antialias = element->GetAntiAlias();
         options.hasPixelHitTest = true;
         options.pixelHitTest = element->GetPixelHitTest();
+        options.cacheAsBitmap = element->GetCacheAsBitmap();
         options.solidColorRadius = element->GetCornerRadius();
 
         options.paddingLeft = element->GetPaddingLeft();
@@ -246,35 +246,28 @@ namespace PropertyParser
         }
         JS_FreeValue(ctx, shadowV);
 
-        options.direction = GetStringProp(ctx, obj, "direction");
-        if (options.direction.empty())
+        // Flex properties may be given directly or inside 'style'; keep the
+        // current value when absent or unknown.
+        auto getFlexProp = [&](const char *name) -> std::wstring
         {
-            JSValue styleDir = JS_GetPropertyStr(ctx, obj, "style");
-            if (JS_IsObject(styleDir))
-                options.direction = GetStringProp(ctx, styleDir, "direction");
-            JS_FreeValue(ctx, styleDir);
-        }
-        if (options.direction.empty())
-            options.direction = L"ltr";
-        std::transform(options.direction.begin(), options.direction.end(), options.direction.begin(), ::towlower);
-        if (options.direction != L"rtl")
-            options.direction = L"ltr";
-
-        // Parse flexDirection property (preserve existing if not provided)
-        std::wstring parsedFlexDir = GetStringProp(ctx, obj, "flexDirection");
-        if (parsedFlexDir.empty())
-        {
-            JSValue styleFlexDir = JS_GetPropertyStr(ctx, obj, "style");
-            if (JS_IsObject(styleFlexDir))
-                parsedFlexDir = GetStringProp(ctx, styleFlexDir, "flexDirection");
-            JS_FreeValue(ctx, styleFlexDir);
-        }
-        if (!parsedFlexDir.empty())
-        {
-            std::transform(parsedFlexDir.begin(), parsedFlexDir.end(), parsedFlexDir.begin(), ::towlower);
-            if (parsedFlexDir == L"rowreverse" || parsedFlexDir == L"column" || parsedFlexDir == L"columnreverse" || parsedFlexDir == L"row")
-                options.flexDirection = parsedFlexDir;
-        }
+            std::wstring value = GetStringProp(ctx, obj, name);
+            if (value.empty())
+            {
+                JSValue style = JS_GetPropertyStr(ctx, obj, "style");
+                if (JS_IsObject(style))
+                    value = GetStringProp(ctx, style, name);
+                JS_FreeValue(ctx, style);
+            }
+            return value;
+        };
+
+        FlexLayout::ParseTextDirection(getFlexProp("direction"), options.direction);
+        const std::wstring parsedFlexDir = getFlexProp("flexDirection");
+        if (FlexLayout::ParseDirection(parsedFlexDir, options.flexDirection))
+            options.flexNames.flexDirection = parsedFlexDir;
+        const std::wstring parsedWrap = getFlexProp("flexWrap");
+        if (FlexLayout::ParseWrap(parsedWrap, options.wrap))
+            options.flexNames.wrap = parsedWrap;
 
         if (!GetIntProp(ctx, obj, "gap", options.gap))
         {
@@ -291,20 +284,16 @@ namespace PropertyParser
         std::wstring parsedAlign = GetStringProp(ctx, obj, "align");
         if (parsedAlign.empty())
             parsedAlign = GetStringProp(ctx, obj, "alignItems");
+        FlexLayout::ParseAlign(parsedAlign, options.align);
         if (!parsedAlign.empty())
-        {
-            std::transform(parsedAlign.begin(), parsedAlign.end(), parsedAlign.begin(), ::towlower);
-            options.align = parsedAlign;
-        }
+            options.flexNames.align = parsedAlign;
 
         std::wstring parsedJustify = GetStringProp(ctx, obj, "justify");
         if (parsedJustify.empty())
             parsedJustify = GetStringProp(ctx, obj, "justifyContent");
+        FlexLayout::ParseJustify(parsedJustify, options.justify);
         if (!parsedJustify.empty())
-        {
-            std::transform(parsedJustify.begin(), parsedJustify.end(), parsedJustify.begin(), ::towlower);
-            options.justify = parsedJustify;
-        }
+            options.flexNames.justify = parsedJustify;
 
         int pad = 0;
         if (GetIntProp(ctx, obj, "padding", pad))
@@ -404,18 +393,14 @@ namespace PropertyParser
                 options.paddingLeft = options.paddingRight = padX;
             if (GetIntProp(ctx, stylePadding, "paddingY", padY))
                 options.paddingTop = options.paddingBottom = padY;
-            std::wstring alignItems = GetStringProp(ctx, stylePadding, "alignItems");
-            if (!alignItems.empty())
-            {
-                std::transform(alignItems.begin(), alignItems.end(), alignItems.begin(), ::towlower);
-                options.align = alignItems;
-            }
-            std::wstring justifyContent = GetStringProp(ctx, stylePadding, "justifyContent");
-            if (!justifyContent.empty())
-            {
-                std::transform(justifyContent.begin(), justifyContent.end(), justifyContent.begin(), ::towlower);
-                options.justify = justifyContent;
-            }
+            const std::wstring styleAlign = GetStringProp(ctx, stylePadding, "alignItems");
+            FlexLayout::ParseAlign(styleAlign, options.align);
+            if (!styleAlign.empty())
+                options.flexNames.align = styleAlign;
+            const std::wstring styleJustify = GetStringProp(ctx, stylePadding, "justifyContent");
+            FlexLayout::ParseJustify(styleJustify, options.justify);
+            if (!styleJustify.empty())
+                options.flexNames.justify = styleJustify;
             
             // Parse display from style object as well
             std::wstring styleDisplay = GetStringProp(ctx, stylePadding, "display");
@@ -513,18 +498,7 @@ namespace PropertyParser
             options.paddingRight,
             options.paddingBottom);
     }
-    void PreFillLayoutBoxOptions(
-        LayoutBoxOptions &options,
-        ElementLayoutBox *element,
-        const std::wstring *direction,
-        const int *gap,
-        const std::wstring *align,
-        const std::wstring *justify,
-        const int *paddingLeft,
-        const int *paddingTop,
-        const int *paddingRight,
-        const int *paddingBottom,
-        const std::wstring *flexDirection)
+    void PreFillLayoutBoxOptions(LayoutBoxOptions &options, ElementLayoutBox *element)
     {
         if (!element)
             return;
@@ -554,15 +528,51 @@ namespace PropertyParser
             options.boxShadows.push_back(outShadow);
         }
 
-        options.direction = direction ? *direction : L"ltr";
-        options.flexDirection = flexDirection ? *flexDirection : element->GetLayoutDirection();
-        options.gap = gap ? *gap : element->GetLayoutGap();
-        options.align = align ? *align : L"";
-        options.justify = justify ? *justify : L"";
-        options.paddingLeft = paddingLeft ? *paddingLeft : element->GetPaddingLeft();
-        options.paddingTop = paddingTop ? *paddingTop : element->GetPaddingTop();
-        options.paddingRight = paddingRight ? *paddingRight : element->GetPaddingRight();
-        options.paddingBottom = paddingBottom ? *paddingBottom : element->GetPaddingBottom();
+        const FlexLayoutConfig &config = element->GetFlexConfig();
+        options.direction = config.direction;
+        options.flexDirection = config.flexDirection;
+        options.wrap = config.wrap;
+        options.gap = config.gap;
+        options.align = config.align;
+        options.justify = config.justify;
+        options.flexNames = config.names;
+        options.paddingLeft = element->GetPaddingLeft();
+        options.paddingTop = element->GetPaddingTop();
+        options.paddingRight = element->GetPaddingRight();
+        options.paddingBottom = element->GetPaddingBottom();
         options.displayType = element->GetDisplayType();
     }
+
+    FlexLayoutConfig GetLayoutBoxFlexConfig(const LayoutBoxOptions &options)
+    {
+        FlexLayoutConfig config;
+        config.direction = options.direction;
+        config.flexDirection = options.flexDirection;
+        config.wrap = options.wrap;
+        config.gap = options.gap;
+        config.align = options.align;
+        config.justify = options.justify;
+        config.names = options.flexNames;
+        config.paddingLeft = options.paddingLeft;
+        config.paddingTop = options.paddingTop;
+        config.paddingRight = options.paddingRight;
+        config.paddingBottom = options.paddingBottom;
+        return config;
+    }
+
+    void ParseVirtualListOptions(JSContext *ctx, JSValueConst obj, VirtualListOptions &options)
+    {
+        GetIntProp(ctx, obj, "itemCount", options.itemCount);
+        GetIntProp(ctx, obj, "itemSize", options.itemSize);
+        GetIntProp(ctx, obj, "gap", options.gap);
+        GetIntProp(ctx, obj, "overscan", options.overscan);
+        GetBoolProp(ctx, obj, "horizontal", options.horizontal);
+        GetEventCallbackProp(ctx, obj, "onCreateItem", options.onCreateItemCallbackId);
+        GetEventCallbackProp(ctx, obj, "onBindItem", options.onBindItemCallbackId);
+
+        if (options.itemCount < 0) options.itemCount = 0;
+        if (options.itemSize < 1) options.itemSize = 1;
+        if (options.gap < 0) options.gap = 0;
+        if (options.overscan < 0) options.overscan = 0;
+    }
 }
@@ -169,8 +169,11 @@ namespace PropertyParser
         options.id = element->GetId();
         options.x = element->GetX();
         options.y = element->GetY();
-        options.width = element->IsWDefined() ? (element->GetWidth() - element->GetPaddingLeft() - element->GetPaddingRight()) : 0;
-        options.height = element->IsHDefined() ? (element->GetHeight() - element->GetPaddingTop() - element->GetPaddingBottom()) : 0;
+        options.width = element->GetSpecifiedWidth();
+        options.height = element->GetSpecifiedHeight();
+        options.flexGrow = element->GetFlexGrow();
+        options.flexShrink = element->GetFlexShrink();
+        options.flexBasis = element->GetFlexBasis();
 
         options.show = element->IsVisible();
         options.containerId = element->GetContainerId();
@@ -180,6 +183,7 @@ namespace PropertyParser
         options.cursorsDir = element->GetCursorsDir();
         options.rotate = element->GetRotate();
         options.antialias = element->GetAntiAlias();
+        options.cacheAsBitmap = element->GetCacheAsBitmap();
         options.solidColorRadius = element->GetCornerRadius();
 
         options.paddingLeft = element->GetPaddingLeft();
@@ -54,6 +54,7 @@ namespace PropertyParser
         bool antialias = true;
         bool hasPixelHitTest = false;
         bool pixelHitTest = false;
+        bool cacheAsBitmap = false;
         bool show = true;
         std::wstring containerId;
         std::wstring groupId;
@@ -63,6 +64,11 @@ namespace PropertyParser
         float rotate = 0.0f;
         bool hasTransformMatrix = false;
         std::vector<float> transformMatrix;
+        int scrollX = 0;
+        int scrollY = 0;
+        float flexGrow = 0.0f;
+        float flexShrink = 0.0f;
+        int flexBasis = -1;
         int onLeftMouseUpCallbackId = -1;
         int onLeftMouseDownCallbackId = -1;
         int onLeftDoubleClickCallbackId = -1;
@@ -183,6 +189,7 @@ namespace PropertyParser
         int gridY = 20;
         bool graphStartLeft = false;
         bool flip = false;
+        SeriesDecimation decimation = SeriesDecimation::MinMax;
     };
 
     struct TextOptions : public ElementOptions
@@ -323,6 +330,7 @@ namespace PropertyParser
         bool autoRange = false;
         float scaleMin = 0.0f;
         float scaleMax = 100.0f;
+        SeriesDecimation decimation = SeriesDecimation::MinMax;
     };
 
     struct HistogramOptions : public ElementOptions
@@ -414,11 +422,13 @@ namespace PropertyParser
         bool hasBoxShadowError = false;
         std::wstring boxShadowError;
 
-        std::wstring direction = L"ltr";
-        std::wstring flexDirection = L"row";
+        FlexTextDirection direction = FlexTextDirection::Ltr;
+        FlexDirection flexDirection = FlexDirection::Row;
+        FlexWrap wrap = FlexWrap::NoWrap;
         int gap = 0;
-        std::wstring align;
-        std::wstring justify;
+        FlexAlign align = FlexAlign::Start;
+        FlexJustify justify = FlexJustify::Start;
+        FlexLayoutNames flexNames;
         int paddingLeft = 0;
         int paddingTop = 0;
         int paddingRight = 0;
@@ -427,6 +437,17 @@ namespace PropertyParser
         ElementLayoutBox::ListStyleType listStyleType = ElementLayoutBox::ListStyleType::Disc;
     };
 
+    struct VirtualListOptions
+    {
+        int itemCount = 0;
+        int itemSize = 0;
+        int gap = 0;
+        int overscan = 2;
+        bool horizontal = false;
+        int onCreateItemCallbackId = -1;
+        int onBindItemCallbackId = -1;
+    };
+
     struct AnimationKeyframeOptions
     {
         float offset = 0.0f;
@@ -8,7 +8,7 @@
 #ifndef __NOVADESK_COLORUTIL_H__
 #define __NOVADESK_COLORUTIL_H__
 
-#include <windows.h>
+#include "../core/PlatformTypes.h"
 #undef min
 #undef max
 #include <string>
@@ -0,0 +1,154 @@
+/* Copyright (C) 2026 OfficialNovadesk
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License; either version 2 of the License, or (at your option) any later
+ * version. If a copy of the GPL was not distributed with this file, You can
+ * obtain one at <https://www.gnu.org/licenses/gpl-2.0.html>. */
+
+#ifndef __NOVADESK_LOGRECORDFORMAT_H__
+#define __NOVADESK_LOGRECORDFORMAT_H__
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/*
+** Structured log file layout shared by Novadesk (writer) and
+** manage_novadesk (reader).
+**
+**   FileHeader                      24 bytes, once at offset 0
+**   RecordHeader + source + message repeated, each record padded to 8 bytes
+**
+** All integers are little-endian. Text is UTF-16 (wchar_t on Windows)
+** without a terminator. A record is only valid once all `size` bytes are
+** present, so a reader can safely stop at a partially written tail.
+*/
+namespace LogRecordFormat
+{
+    constexpr char kMagic[8] = {'N', 'D', 'L', 'O', 'G', '0', '0', '1'};
+    constexpr uint32_t kVersion = 1;
+    constexpr uint32_t kAlignment = 8;
+    constexpr uint32_t kMaxRecordSize = 1u << 20;
+
+    struct FileHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t headerSize;
+        uint64_t createdTime; // FILETIME (UTC, 100 ns ticks)
+    };
+
+    struct RecordHeader
+    {
+        uint32_t size;          // total record bytes including header and padding
+        uint16_t level;         // LogLevel
+        uint16_t sourceLength;  // UTF-16 code units
+        uint32_t messageId;     // hash of the format string
+        uint32_t messageLength; // UTF-16 code units
+        uint64_t timestamp;     // FILETIME (UTC, 100 ns ticks)
+    };
+
+    static_assert(sizeof(FileHeader) == 24, "LogRecordFormat::FileHeader layout changed");
+    static_assert(sizeof(RecordHeader) == 24, "LogRecordFormat::RecordHeader layout changed");
+    static_assert(sizeof(wchar_t) == 2, "LogRecordFormat stores UTF-16 text as wchar_t");
+
+    inline uint32_t HashMessageFormat(const wchar_t *format)
+    {
+        // FNV-1a over the format string so identical call sites share an id.
+        uint32_t hash = 2166136261u;
+        if (!format)
+            return hash;
+        for (const wchar_t *p = format; *p; ++p)
+        {
+            hash ^= (uint32_t)(uint16_t)*p;
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    inline void AppendFileHeader(std::vector<uint8_t> &out, uint64_t createdTime)
+    {
+        FileHeader header = {};
+        memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.headerSize = sizeof(FileHeader);
+        header.createdTime = createdTime;
+
+        const size_t offset = out.size();
+        out.resize(offset + sizeof(header));
+        memcpy(out.data() + offset, &header, sizeof(header));
+    }
+
+    inline bool IsValidFileHeader(const uint8_t *data, uint64_t available)
+    {
+        if (!data || available < sizeof(FileHeader))
+            return false;
+        FileHeader header;
+        memcpy(&header, data, sizeof(header));
+        return memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+               header.version == kVersion &&
+               header.headerSize == sizeof(FileHeader);
+    }
+
+    inline void AppendRecord(std::vector<uint8_t> &out, uint16_t level, uint64_t timestamp, uint32_t messageId,
+                             const wchar_t *source, size_t sourceLength,
+                             const wchar_t *message, size_t messageLength)
+    {
+        if (sourceLength > 0xFFFF)
+            sourceLength = 0xFFFF;
+        const size_t maxMessage = (kMaxRecordSize - sizeof(RecordHeader) - sourceLength * sizeof(wchar_t) - kAlignment) / sizeof(wchar_t);
+        if (messageLength > maxMessage)
+            messageLength = maxMessage;
+
+        const size_t payload = sizeof(RecordHeader) + (sourceLength + messageLength) * sizeof(wchar_t);
+        const size_t size = (payload + kAlignment - 1) & ~(size_t)(kAlignment - 1);
+
+        RecordHeader header = {};
+        header.size = (uint32_t)size;
+        header.level = level;
+        header.sourceLength = (uint16_t)sourceLength;
+        header.messageId = messageId;
+        header.messageLength = (uint32_t)messageLength;
+        header.timestamp = timestamp;
+
+        const size_t offset = out.size();
+        out.resize(offset + size, 0);
+        uint8_t *dst = out.data() + offset;
+        memcpy(dst, &header, sizeof(header));
+        dst += sizeof(header);
+        if (sourceLength)
+            memcpy(dst, source, sourceLength * sizeof(wchar_t));
+        dst += sourceLength * sizeof(wchar_t);
+        if (messageLength)
+            memcpy(dst, message, messageLength * sizeof(wchar_t));
+    }
+
+    /*
+    ** Decode the record header at `offset`. Returns false if the record is
+    ** incomplete (not fully written yet) or malformed.
+    */
+    inline bool ReadRecordHeader(const uint8_t *data, uint64_t available, uint64_t offset, RecordHeader &out)
+    {
+        if (!data || offset + sizeof(RecordHeader) > available)
+            return false;
+        memcpy(&out, data + offset, sizeof(out));
+        if (out.size < sizeof(RecordHeader) || out.size > kMaxRecordSize || (out.size % kAlignment) != 0)
+            return false;
+        if (offset + out.size > available)
+            return false;
+        const uint64_t payload = sizeof(RecordHeader) + ((uint64_t)out.sourceLength + out.messageLength) * sizeof(wchar_t);
+        return payload <= out.size;
+    }
+
+    inline const wchar_t *GetRecordSource(const uint8_t *data, uint64_t offset)
+    {
+        return reinterpret_cast<const wchar_t *>(data + offset + sizeof(RecordHeader));
+    }
+
+    inline const wchar_t *GetRecordMessage(const uint8_t *data, uint64_t offset, const RecordHeader &header)
+    {
+        return reinterpret_cast<const wchar_t *>(data + offset + sizeof(RecordHeader) + header.sourceLength * sizeof(wchar_t));
+    }
+}
+
+#endif
@@ -8,13 +8,168 @@
 #include "Logging.h"
 #include <cstdio>
 #include <cstdarg>
-#include <fstream>
-#include <ctime>
-#include <chrono>
+#include <cwchar>
+#include <atomic>
 #include <vector>
-#include <filesystem>
 #include <string>
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
 #include "PathUtils.h"
+#include "LogRecordFormat.h"
+
+namespace
+{
+    constexpr size_t kQueueCapacity = 4096; // must be a power of two
+    constexpr size_t kMaxBatch = 256;
+    constexpr DWORD kWriterIdleTimeoutMs = 250;
+    constexpr uint64_t kDefaultMaxFileBytes = 10ull * 1024ull * 1024ull;
+    constexpr int kDefaultMaxFiles = 3;
+    constexpr uint64_t kStructuredMaxFileBytes = 256ull * 1024ull * 1024ull;
+
+    struct LogRecord
+    {
+        LogLevel level = LogLevel::Info;
+        FILETIME time = {};
+        uint32_t messageId = 0;
+        std::wstring source;
+        std::wstring message;
+    };
+
+    /*
+    ** Bounded multi-producer / single-consumer ring.
+    ** Producers claim a slot with a CAS on the enqueue position and publish it
+    ** through the slot sequence number; only the writer thread dequeues.
+    */
+    class LogQueue
+    {
+    public:
+        LogQueue()
+        {
+            for (size_t i = 0; i < kQueueCapacity; ++i)
+                m_Slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        bool TryPush(LogRecord &record)
+        {
+            size_t pos = m_EnqueuePos.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                Slot &slot = m_Slots[pos & (kQueueCapacity - 1)];
+                const size_t seq = slot.sequence.load(std::memory_order_acquire);
+                const intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+                if (diff == 0)
+                {
+                    if (m_EnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        slot.record = std::move(record);
+                        slot.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    return false; // full
+                }
+                else
+                {
+                    pos = m_EnqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // Consumer side only.
+        bool TryPop(LogRecord &out)
+        {
+            Slot &slot = m_Slots[m_DequeuePos & (kQueueCapacity - 1)];
+            const size_t seq = slot.sequence.load(std::memory_order_acquire);
+            if ((intptr_t)seq - (intptr_t)(m_DequeuePos + 1) < 0)
+                return false;
+
+            out = std::move(slot.record);
+            slot.record.message.clear();
+            slot.record.source.clear();
+            slot.sequence.store(m_DequeuePos + kQueueCapacity, std::memory_order_release);
+            ++m_DequeuePos;
+            return true;
+        }
+
+        // Consumer side only.
+        bool HasPending() const
+        {
+            const Slot &slot = m_Slots[m_DequeuePos & (kQueueCapacity - 1)];
+            return slot.sequence.load(std::memory_order_seq_cst) == m_DequeuePos + 1;
+        }
+
+    private:
+        struct Slot
+        {
+            std::atomic<size_t> sequence{0};
+            LogRecord record;
+        };
+
+        alignas(64) std::atomic<size_t> m_EnqueuePos{0};
+        alignas(64) size_t m_DequeuePos = 0;
+        Slot m_Slots[kQueueCapacity];
+    };
+
+    // State owned by the writer thread (or by the caller holding s_DirectLock after shutdown).
+    struct WriterState
+    {
+        HANDLE file = INVALID_HANDLE_VALUE;
+        std::wstring openPath;
+        uint64_t fileSize = 0;
+        uint64_t configGeneration = 0;
+        uint64_t reportedDropped = 0;
+        std::wstring productName;
+        std::wstring text;
+        std::string utf8;
+
+        HANDLE structuredFile = INVALID_HANDLE_VALUE;
+        std::wstring structuredPath;
+        uint64_t structuredSize = 0;
+        std::vector<uint8_t> structuredBytes;
+    };
+
+    // Heap-allocated and intentionally never freed so that late log calls
+    // during static destruction cannot touch a destroyed queue.
+    LogQueue *s_Queue = nullptr;
+    WriterState *s_Writer = nullptr;
+    std::once_flag s_StartOnce;
+    HANDLE s_WriterThread = nullptr;
+    HANDLE s_WakeEvent = nullptr;
+    std::atomic<bool> s_WriterRunning{false};
+    std::atomic<bool> s_WriterIdle{false};
+    std::atomic<bool> s_StopRequested{false};
+    std::atomic<bool> s_ShutDown{false};
+    std::mutex s_DirectLock;
+
+    std::mutex s_FlushLock;
+    std::condition_variable s_FlushCv;
+    std::atomic<int> s_FlushWaiters{0};
+
+    std::atomic<bool> s_ConsoleEnabled{true};
+    std::atomic<bool> s_FileEnabled{false};
+    std::atomic<LogLevel> s_MinLevel{LogLevel::Info};
+    std::atomic<bool> s_StructuredEnabled{false};
+    thread_local std::wstring t_LogSource;
+
+    std::mutex s_ConfigLock;
+    std::wstring s_LogFilePath;
+    std::wstring s_StructuredLogPath;
+    std::atomic<uint64_t> s_ConfigGeneration{1};
+    std::atomic<uint64_t> s_AppliedGeneration{0};
+    bool s_ClearOnOpen = false;
+    uint64_t s_MaxFileBytes = kDefaultMaxFileBytes;
+    int s_MaxFiles = kDefaultMaxFiles;
+    std::atomic<LogOverflowPolicy> s_OverflowPolicy{LogOverflowPolicy::Drop};
+
+    std::atomic<uint64_t> s_Enqueued{0};
+    std::atomic<uint64_t> s_Written{0};
+    std::atomic<uint64_t> s_Dropped{0};
+    std::atomic<uint64_t> s_Blocked{0};
+    std::atomic<uint64_t> s_Rotations{0};
+}
 
 static WORD GetConsoleColorForLevel(LogLevel level)
 {
@@ -33,159 +188,648 @@ static WORD GetConsoleColorForLevel(LogLevel level)
     }
 }
 
-// Static member initialization
-bool Logging::s_ConsoleEnabled = true;
-bool Logging::s_FileEnabled = false;
-std::wstring Logging::s_LogFilePath = L"";
-LogLevel Logging::s_MinLevel = LogLevel::Info;
+static const wchar_t *GetLevelTag(LogLevel level)
+{
+    switch (level)
+    {
+    case LogLevel::Info:
+        return L"[LOG]";
+    case LogLevel::Warn:
+        return L"[WARN]";
+    case LogLevel::Error:
+        return L"[ERROR]";
+    case LogLevel::Debug:
+        return L"[DEBUG]";
+    }
+    return L"";
+}
 
 /*
-** Log a message to the debug output and/or file.
-** Supports formatted output similar to printf.
-** Messages are prefixed with [INFO], [ERROR], or [DEBUG] based on level.
+** Append one formatted line:
+** [timestamp] [product] LEVEL message\n
 */
+static void AppendFormattedLine(std::wstring &out, const std::wstring &productName, const LogRecord &record)
+{
+    FILETIME localTime = {};
+    SYSTEMTIME st = {};
+    FileTimeToLocalFileTime(&record.time, &localTime);
+    FileTimeToSystemTime(&localTime, &st);
 
-void Logging::Log(LogLevel level, const wchar_t *format, ...)
+    wchar_t prefix[64];
+    int n = swprintf_s(prefix, L"[%04d-%02d-%02d %02d:%02d:%02d.%03d] [",
+                       st.wYear, st.wMonth, st.wDay, st.wHour, st.wMinute, st.wSecond, st.wMilliseconds);
+    if (n > 0)
+        out.append(prefix, (size_t)n);
+    out += productName;
+    out += L"] ";
+    out += GetLevelTag(record.level);
+    out += L' ';
+    out += record.message;
+    out += L'\n';
+}
+
+static void AppendUtf8(std::string &out, const wchar_t *text, size_t length)
 {
-    // Check if this log level should be displayed
-    if (level < s_MinLevel)
+    if (length == 0)
         return;
-    if (!s_ConsoleEnabled && !s_FileEnabled)
+    int bytes = WideCharToMultiByte(CP_UTF8, 0, text, (int)length, nullptr, 0, nullptr, nullptr);
+    if (bytes <= 0)
         return;
+    const size_t offset = out.size();
+    out.resize(offset + (size_t)bytes);
+    WideCharToMultiByte(CP_UTF8, 0, text, (int)length, &out[offset], bytes, nullptr, nullptr);
+}
 
-    va_list args;
-    va_start(args, format);
+static std::wstring GetRotatedLogPath(const std::wstring &path, int index)
+{
+    size_t dot = path.find_last_of(L'.');
+    size_t slash = path.find_last_of(L"\\/");
+    if (dot == std::wstring::npos || (slash != std::wstring::npos && dot < slash))
+        return path + L"." + std::to_wstring(index);
+    return path.substr(0, dot) + L"." + std::to_wstring(index) + path.substr(dot);
+}
 
-    // Determine required size
-    int len = _vscwprintf(format, args);
-    if (len < 0)
+static void CloseLogFile(WriterState &state)
+{
+    if (state.file != INVALID_HANDLE_VALUE)
     {
-        va_end(args);
+        CloseHandle(state.file);
+        state.file = INVALID_HANDLE_VALUE;
+    }
+    state.openPath.clear();
+    state.fileSize = 0;
+}
+
+static void OpenLogFile(WriterState &state, const std::wstring &path, bool truncate)
+{
+    CloseLogFile(state);
+    if (path.empty())
+        return;
+
+    HANDLE file = CreateFileW(path.c_str(), FILE_APPEND_DATA | (truncate ? GENERIC_WRITE : 0),
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                              truncate ? CREATE_ALWAYS : OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
         return;
+
+    LARGE_INTEGER size = {};
+    if (!truncate && GetFileSizeEx(file, &size))
+        state.fileSize = (uint64_t)size.QuadPart;
+    state.file = file;
+    state.openPath = path;
+}
+
+/*
+** Move logs.log -> logs.1.log -> logs.2.log ... and start a fresh file.
+*/
+static void RotateLogFile(WriterState &state, int maxFiles)
+{
+    const std::wstring path = state.openPath;
+    CloseLogFile(state);
+
+    if (maxFiles > 0)
+    {
+        DeleteFileW(GetRotatedLogPath(path, maxFiles).c_str());
+        for (int i = maxFiles - 1; i >= 1; --i)
+        {
+            MoveFileExW(GetRotatedLogPath(path, i).c_str(), GetRotatedLogPath(path, i + 1).c_str(), MOVEFILE_REPLACE_EXISTING);
+        }
+        MoveFileExW(path.c_str(), GetRotatedLogPath(path, 1).c_str(), MOVEFILE_REPLACE_EXISTING);
     }
 
-    std::vector<wchar_t> buffer(len + 1);
-    vswprintf_s(buffer.data(), buffer.size(), format, args);
-    va_end(args);
+    OpenLogFile(state, path, true);
+    s_Rotations.fetch_add(1, std::memory_order_relaxed);
+}
 
-    const wchar_t *levelStr = L"";
-    switch (level)
+static uint64_t FileTimeToTicks(const FILETIME &time)
+{
+    return ((uint64_t)time.dwHighDateTime << 32) | time.dwLowDateTime;
+}
+
+static void CloseStructuredFile(WriterState &state)
+{
+    if (state.structuredFile != INVALID_HANDLE_VALUE)
     {
-    case LogLevel::Info:
-        levelStr = L"[LOG]";
-        break;
-    case LogLevel::Warn:
-        levelStr = L"[WARN]";
-        break;
-    case LogLevel::Error:
-        levelStr = L"[ERROR]";
-        break;
-    case LogLevel::Debug:
-        levelStr = L"[DEBUG]";
-        break;
+        CloseHandle(state.structuredFile);
+        state.structuredFile = INVALID_HANDLE_VALUE;
     }
+    state.structuredPath.clear();
+    state.structuredSize = 0;
+}
 
-    // Get current timestamp
-    auto now = std::chrono::system_clock::now();
-    auto now_c = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
+/*
+** Open (or create) the structured log. A file that does not start with a
+** valid header is replaced so readers never see mixed formats.
+*/
+static void OpenStructuredFile(WriterState &state, const std::wstring &path, bool truncate)
+{
+    CloseStructuredFile(state);
+    if (path.empty())
+        return;
 
-    tm timeInfo;
-    localtime_s(&timeInfo, &now_c);
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ | FILE_APPEND_DATA,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                              OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return;
 
-    wchar_t timestamp[64];
-    swprintf_s(timestamp, L"[%04d-%02d-%02d %02d:%02d:%02d.%03lld]",
-               timeInfo.tm_year + 1900, timeInfo.tm_mon + 1, timeInfo.tm_mday,
-               timeInfo.tm_hour, timeInfo.tm_min, timeInfo.tm_sec, ms.count());
+    LARGE_INTEGER size = {};
+    GetFileSizeEx(file, &size);
+    bool valid = !truncate && size.QuadPart > 0;
+    if (valid)
+    {
+        uint8_t header[sizeof(LogRecordFormat::FileHeader)] = {};
+        DWORD read = 0;
+        valid = ReadFile(file, header, sizeof(header), &read, nullptr) &&
+                LogRecordFormat::IsValidFileHeader(header, read);
+    }
 
-    // Prepare final output string dynamically
-    // format: timestamp + " [" + productName + "] " + levelStr + " " + buffer + "\n"
-    std::wstring productName = PathUtils::GetProductName();
-    int outputLen = _scwprintf(L"%s [%s] %s %s\n", timestamp, productName.c_str(), levelStr, buffer.data());
+    if (!valid)
+    {
+        CloseHandle(file);
+        file = CreateFileW(path.c_str(), GENERIC_WRITE | FILE_APPEND_DATA,
+                           FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                           CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return;
 
-    if (outputLen < 0)
+        FILETIME now = {};
+        GetSystemTimePreciseAsFileTime(&now);
+        std::vector<uint8_t> header;
+        LogRecordFormat::AppendFileHeader(header, FileTimeToTicks(now));
+        DWORD written = 0;
+        WriteFile(file, header.data(), (DWORD)header.size(), &written, nullptr);
+        size.QuadPart = written;
+    }
+
+    state.structuredFile = file;
+    state.structuredPath = path;
+    state.structuredSize = (uint64_t)size.QuadPart;
+}
+
+static void WriteStructuredRecords(WriterState &state, const std::vector<LogRecord> &batch)
+{
+    if (state.structuredFile == INVALID_HANDLE_VALUE || batch.empty())
         return;
 
-    std::vector<wchar_t> output(outputLen + 1);
-    swprintf_s(output.data(), output.size(), L"%s [%s] %s %s\n", timestamp, productName.c_str(), levelStr, buffer.data());
+    state.structuredBytes.clear();
+    for (const LogRecord &record : batch)
+    {
+        LogRecordFormat::AppendRecord(state.structuredBytes, (uint16_t)record.level, FileTimeToTicks(record.time),
+                                      record.messageId, record.source.data(), record.source.size(),
+                                      record.message.data(), record.message.size());
+    }
 
-    // Output to console (debug output)
-    if (s_ConsoleEnabled || IsDebuggerPresent())
+    if (state.structuredSize + state.structuredBytes.size() > kStructuredMaxFileBytes)
     {
-        HANDLE hOut = GetStdHandle(STD_OUTPUT_HANDLE);
-        CONSOLE_SCREEN_BUFFER_INFO csbi = {};
-        bool canColor = (hOut != INVALID_HANDLE_VALUE) && GetConsoleScreenBufferInfo(hOut, &csbi);
-        if (canColor)
+        // Keep one previous generation; readers notice the file identity change and reload.
+        const std::wstring path = state.structuredPath;
+        CloseStructuredFile(state);
+        MoveFileExW(path.c_str(), GetRotatedLogPath(path, 1).c_str(), MOVEFILE_REPLACE_EXISTING);
+        OpenStructuredFile(state, path, true);
+        if (state.structuredFile == INVALID_HANDLE_VALUE)
+            return;
+    }
+
+    DWORD written = 0;
+    if (WriteFile(state.structuredFile, state.structuredBytes.data(), (DWORD)state.structuredBytes.size(), &written, nullptr))
+        state.structuredSize += written;
+}
+
+static void WriteConsoleRun(HANDLE hOut, bool canColor, LogLevel level, const wchar_t *text, size_t length)
+{
+    if (length == 0)
+        return;
+    if (canColor)
+        SetConsoleTextAttribute(hOut, GetConsoleColorForLevel(level));
+    DWORD written = 0;
+    WriteConsoleW(hOut, text, (DWORD)length, &written, nullptr);
+}
+
+/*
+** Write a batch of records to the console, debugger and log file.
+** Runs on the writer thread, or under s_DirectLock once the writer has stopped.
+*/
+static void WriteBatch(WriterState &state, const std::vector<LogRecord> &batch)
+{
+    std::wstring filePath;
+    std::wstring structuredPath;
+    bool clearFile = false;
+    uint64_t maxBytes = 0;
+    int maxFiles = 0;
+    {
+        std::lock_guard<std::mutex> lock(s_ConfigLock);
+        const uint64_t generation = s_ConfigGeneration.load(std::memory_order_acquire);
+        if (generation != state.configGeneration)
         {
-            SetConsoleTextAttribute(hOut, GetConsoleColorForLevel(level));
+            state.configGeneration = generation;
+            clearFile = s_ClearOnOpen;
+            s_ClearOnOpen = false;
         }
+        filePath = s_LogFilePath;
+        structuredPath = s_StructuredLogPath;
+        maxBytes = s_MaxFileBytes;
+        maxFiles = s_MaxFiles;
+    }
+    const bool consoleEnabled = s_ConsoleEnabled.load(std::memory_order_relaxed);
+    const bool fileEnabled = s_FileEnabled.load(std::memory_order_relaxed);
+
+    // The handle stays open between batches; reopen only when the target changes.
+    if (!fileEnabled || filePath.empty())
+    {
+        if (state.file != INVALID_HANDLE_VALUE)
+            CloseLogFile(state);
+    }
+    else if (clearFile || state.file == INVALID_HANDLE_VALUE || state.openPath != filePath)
+    {
+        OpenLogFile(state, filePath, clearFile);
+    }
+
+    if (structuredPath != state.structuredPath)
+        OpenStructuredFile(state, structuredPath, false);
+    WriteStructuredRecords(state, batch);
+
+    if (state.productName.empty())
+        state.productName = PathUtils::GetProductName();
+
+    state.text.clear();
+
+    const uint64_t dropped = s_Dropped.load(std::memory_order_relaxed);
+    if (dropped != state.reportedDropped)
+    {
+        LogRecord notice;
+        notice.level = LogLevel::Warn;
+        GetSystemTimePreciseAsFileTime(&notice.time);
+        notice.message = std::to_wstring(dropped - state.reportedDropped) + L" log message(s) dropped (log queue full)";
+        state.reportedDropped = dropped;
+        AppendFormattedLine(state.text, state.productName, notice);
+    }
+
+    std::vector<size_t> lineEnds;
+    lineEnds.reserve(batch.size() + 1);
+    if (!state.text.empty())
+        lineEnds.push_back(state.text.size());
+    for (const LogRecord &record : batch)
+    {
+        AppendFormattedLine(state.text, state.productName, record);
+        lineEnds.push_back(state.text.size());
+    }
+
+    if (state.text.empty())
+        return;
+
+    // Console / debugger output
+    if (consoleEnabled || IsDebuggerPresent())
+    {
+        OutputDebugStringW(state.text.c_str());
 
-        OutputDebugStringW(output.data());
+        HANDLE hOut = GetStdHandle(STD_OUTPUT_HANDLE);
         DWORD mode = 0;
         if (hOut != INVALID_HANDLE_VALUE && GetConsoleMode(hOut, &mode))
         {
-            DWORD written = 0;
-            WriteConsoleW(hOut, output.data(), (DWORD)wcslen(output.data()), &written, nullptr);
+            CONSOLE_SCREEN_BUFFER_INFO csbi = {};
+            const bool canColor = GetConsoleScreenBufferInfo(hOut, &csbi) != FALSE;
+
+            // Group consecutive lines of the same level so each colour run is one write.
+            const size_t noticeLines = lineEnds.size() - batch.size();
+            size_t runStart = 0;
+            LogLevel runLevel = noticeLines ? LogLevel::Warn : batch.front().level;
+            for (size_t i = 0; i < lineEnds.size(); ++i)
+            {
+                const LogLevel level = i < noticeLines ? LogLevel::Warn : batch[i - noticeLines].level;
+                const size_t lineStart = i == 0 ? 0 : lineEnds[i - 1];
+                if (level != runLevel)
+                {
+                    WriteConsoleRun(hOut, canColor, runLevel, state.text.data() + runStart, lineStart - runStart);
+                    runStart = lineStart;
+                    runLevel = level;
+                }
+            }
+            WriteConsoleRun(hOut, canColor, runLevel, state.text.data() + runStart, state.text.size() - runStart);
+
+            if (canColor)
+                SetConsoleTextAttribute(hOut, csbi.wAttributes);
         }
         else
         {
-            int utf8Len = WideCharToMultiByte(CP_UTF8, 0, output.data(), -1, nullptr, 0, nullptr, nullptr);
-            if (utf8Len > 1)
+            state.utf8.clear();
+            AppendUtf8(state.utf8, state.text.data(), state.text.size());
+            if (!state.utf8.empty())
             {
-                std::string utf8(utf8Len - 1, '\0');
-                WideCharToMultiByte(CP_UTF8, 0, output.data(), -1, utf8.data(), utf8Len - 1, nullptr, nullptr);
-                fwrite(utf8.data(), 1, utf8.size(), stdout);
+                fwrite(state.utf8.data(), 1, state.utf8.size(), stdout);
                 fflush(stdout);
-                fwrite(utf8.data(), 1, utf8.size(), stderr);
+                fwrite(state.utf8.data(), 1, state.utf8.size(), stderr);
                 fflush(stderr);
             }
         }
+    }
+
+    // File output
+    if (state.file == INVALID_HANDLE_VALUE)
+        return;
 
-        if (canColor)
+    state.utf8.clear();
+    AppendUtf8(state.utf8, state.text.data(), state.text.size());
+    if (state.utf8.empty())
+        return;
+
+    if (maxBytes > 0 && state.fileSize > 0 && state.fileSize + state.utf8.size() > maxBytes)
+    {
+        RotateLogFile(state, maxFiles);
+        if (state.file == INVALID_HANDLE_VALUE)
+            return;
+    }
+
+    DWORD written = 0;
+    if (WriteFile(state.file, state.utf8.data(), (DWORD)state.utf8.size(), &written, nullptr))
+        state.fileSize += written;
+}
+
+
+static void NotifyFlushWaiters()
+{
+    if (s_FlushWaiters.load(std::memory_order_seq_cst) > 0)
+    {
+        std::lock_guard<std::mutex> lock(s_FlushLock);
+        s_FlushCv.notify_all();
+    }
+}
+
+/*
+** Drain whatever is queued right now. Returns the number of records written.
+*/
+static size_t DrainQueue(std::vector<LogRecord> &batch)
+{
+    size_t total = 0;
+    for (;;)
+    {
+        LogRecord record;
+        while (batch.size() < kMaxBatch && s_Queue->TryPop(record))
+            batch.push_back(std::move(record));
+        if (batch.empty())
+            return total;
+
+        WriteBatch(*s_Writer, batch);
+        total += batch.size();
+        s_Written.fetch_add(batch.size(), std::memory_order_seq_cst);
+        batch.clear();
+        NotifyFlushWaiters();
+    }
+}
+
+static DWORD WINAPI LogWriterThreadProc(LPVOID)
+{
+    std::vector<LogRecord> batch;
+    batch.reserve(kMaxBatch);
+    // Apply the configuration set before the writer started, so an early
+    // Flush() (e.g. from SetFileLogging at startup) does not wait it out.
+    uint64_t seenGeneration = s_ConfigGeneration.load(std::memory_order_acquire);
+    WriteBatch(*s_Writer, batch);
+    s_AppliedGeneration.store(seenGeneration, std::memory_order_seq_cst);
+    NotifyFlushWaiters();
+
+    for (;;)
+    {
+        DrainQueue(batch);
+
+        // Apply file logging changes even when nothing is queued (e.g. clear / close).
+        const uint64_t generation = s_ConfigGeneration.load(std::memory_order_acquire);
+        if (generation != seenGeneration)
         {
-            SetConsoleTextAttribute(hOut, csbi.wAttributes);
+            seenGeneration = generation;
+            WriteBatch(*s_Writer, batch);
+            s_AppliedGeneration.store(generation, std::memory_order_seq_cst);
+            NotifyFlushWaiters();
         }
+
+        if (s_StopRequested.load(std::memory_order_acquire))
+            break;
+
+        // Producers only signal the event while the writer is marked idle.
+        s_WriterIdle.store(true, std::memory_order_seq_cst);
+        if (s_Queue->HasPending() || s_StopRequested.load(std::memory_order_seq_cst))
+        {
+            s_WriterIdle.store(false, std::memory_order_relaxed);
+            continue;
+        }
+        WaitForSingleObject(s_WakeEvent, kWriterIdleTimeoutMs);
+        s_WriterIdle.store(false, std::memory_order_relaxed);
     }
 
-    // Output to file
-    if (s_FileEnabled && !s_LogFilePath.empty())
+    DrainQueue(batch);
+    return 0;
+}
+
+static void StartWriter()
+{
+    s_Queue = new LogQueue();
+    s_Writer = new WriterState();
+    s_WakeEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    if (!s_WakeEvent)
+        return;
+
+    s_WriterThread = CreateThread(nullptr, 0, LogWriterThreadProc, nullptr, 0, nullptr);
+    if (s_WriterThread)
+        s_WriterRunning.store(true, std::memory_order_release);
+}
+
+static void WakeWriter()
+{
+    // Order the slot publish before reading the idle flag (pairs with the writer's idle store).
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (s_WriterIdle.load(std::memory_order_seq_cst) && s_WriterIdle.exchange(false))
+        SetEvent(s_WakeEvent);
+}
+
+/*
+** Write a record on the calling thread. Used when the writer thread is not
+** available (failed to start, or already shut down).
+*/
+static void WriteDirect(LogRecord &record)
+{
+    std::lock_guard<std::mutex> lock(s_DirectLock);
+    if (!s_Writer)
+        s_Writer = new WriterState();
+
+    std::vector<LogRecord> batch;
+    batch.push_back(std::move(record));
+    WriteBatch(*s_Writer, batch);
+    s_Written.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void Enqueue(LogRecord &record)
+{
+    std::call_once(s_StartOnce, StartWriter);
+
+    if (!s_WriterRunning.load(std::memory_order_acquire))
+    {
+        s_Enqueued.fetch_add(1, std::memory_order_relaxed);
+        WriteDirect(record);
+        return;
+    }
+
+    if (s_Queue->TryPush(record))
+    {
+        s_Enqueued.fetch_add(1, std::memory_order_seq_cst);
+        if (s_WriterRunning.load(std::memory_order_acquire))
+        {
+            WakeWriter();
+        }
+        else
+        {
+            // Raced with Shutdown(); make sure the record is not stranded in the queue.
+            std::lock_guard<std::mutex> lock(s_DirectLock);
+            std::vector<LogRecord> batch;
+            DrainQueue(batch);
+        }
+        return;
+    }
+
+    const bool mustKeep = record.level >= LogLevel::Warn ||
+                          s_OverflowPolicy.load(std::memory_order_relaxed) == LogOverflowPolicy::Block;
+    if (!mustKeep)
     {
-        std::wofstream logFile(std::filesystem::path(s_LogFilePath), std::ios::app);
-        if (logFile.is_open())
+        s_Dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Backpressure: wait for the writer to free a slot.
+    s_Blocked.fetch_add(1, std::memory_order_relaxed);
+    for (;;)
+    {
+        if (!s_WriterRunning.load(std::memory_order_acquire))
+        {
+            s_Enqueued.fetch_add(1, std::memory_order_relaxed);
+            WriteDirect(record);
+            return;
+        }
+        SetEvent(s_WakeEvent);
+        SwitchToThread();
+        if (s_Queue->TryPush(record))
         {
-            logFile << output.data();
-            logFile.close();
+            s_Enqueued.fetch_add(1, std::memory_order_seq_cst);
+            WakeWriter();
+            return;
         }
     }
 }
 
+/*
+** Log a message to the debug output and/or file.
+** Supports formatted output similar to printf.
+** Messages are prefixed with [LOG], [WARN], [ERROR] or [DEBUG] based on level.
+** Only the message itself is formatted here; the timestamp, prefix and I/O
+** are handled by the writer thread.
+*/
+
+void Logging::Log(LogLevel level, const wchar_t *format, ...)
+{
+    // Check if this log level should be displayed before doing any work
+    if (!IsEnabled(level))
+        return;
+
+    LogRecord record;
+    record.level = level;
+    GetSystemTimePreciseAsFileTime(&record.time);
+    if (s_StructuredEnabled.load(std::memory_order_relaxed))
+    {
+        record.messageId = LogRecordFormat::HashMessageFormat(format);
+        record.source = t_LogSource;
+    }
+
+    va_list args;
+    va_start(args, format);
+
+    wchar_t stackBuffer[512];
+    va_list copy;
+    va_copy(copy, args);
+    int len = _vsnwprintf_s(stackBuffer, _TRUNCATE, format, copy);
+    va_end(copy);
+
+    if (len >= 0)
+    {
+        record.message.assign(stackBuffer, (size_t)len);
+    }
+    else
+    {
+        // Message does not fit the stack buffer; measure and format on the heap.
+        va_copy(copy, args);
+        len = _vscwprintf(format, copy);
+        va_end(copy);
+        if (len < 0)
+        {
+            va_end(args);
+            return;
+        }
+        record.message.resize((size_t)len + 1);
+        vswprintf_s(&record.message[0], record.message.size(), format, args);
+        record.message.resize((size_t)len);
+    }
+    va_end(args);
+
+    Enqueue(record);
+}
+
+/*
+** Returns true if a message at this level would be written anywhere.
+** Callers can use this to skip building expensive log arguments.
+*/
+bool Logging::IsEnabled(LogLevel level)
+{
+    if (level < s_MinLevel.load(std::memory_order_relaxed))
+        return false;
+    return s_ConsoleEnabled.load(std::memory_order_relaxed) || s_FileEnabled.load(std::memory_order_relaxed) ||
+           s_StructuredEnabled.load(std::memory_order_relaxed);
+}
+
 /*
 ** Enable or disable console (debug output) logging.
 */
 
 void Logging::SetConsoleLogging(bool enable)
 {
-    s_ConsoleEnabled = enable;
+    s_ConsoleEnabled.store(enable, std::memory_order_relaxed);
 }
 
 /*
 ** Enable or disable file logging with an option to clear the file.
 ** If filePath is empty, file logging is disabled.
+** Messages queued before the call are still written to the previous target.
 */
 void Logging::SetFileLogging(const std::wstring &filePath, bool clearFile)
 {
-    s_LogFilePath = filePath;
-    s_FileEnabled = !filePath.empty();
+    Flush();
+    {
+        std::lock_guard<std::mutex> lock(s_ConfigLock);
+        s_LogFilePath = filePath;
+        s_ClearOnOpen = !filePath.empty() && clearFile;
+        s_FileEnabled.store(!filePath.empty(), std::memory_order_relaxed);
+        s_ConfigGeneration.fetch_add(1, std::memory_order_acq_rel);
+    }
 
-    if (s_FileEnabled && clearFile)
+    // Let the writer open / truncate / close the file now rather than on the next message.
+    Flush();
+}
+
+/*
+** Write structured records to filePath in addition to the text outputs.
+** The viewer in manage_novadesk maps this file instead of parsing console text.
+*/
+void Logging::SetStructuredLogFile(const std::wstring &filePath)
+{
+    Flush();
     {
-        // Truncate the file
-        std::wofstream logFile(std::filesystem::path(s_LogFilePath), std::ios::trunc);
-        if (logFile.is_open())
-        {
-            logFile.close();
-        }
+        std::lock_guard<std::mutex> lock(s_ConfigLock);
+        s_StructuredLogPath = filePath;
+        s_StructuredEnabled.store(!filePath.empty(), std::memory_order_relaxed);
+        s_ConfigGeneration.fetch_add(1, std::memory_order_acq_rel);
     }
+    Flush();
+}
+
+void Logging::SetThreadLogSource(const std::wstring &source)
+{
+    t_LogSource = source;
 }
 
 /*
@@ -194,5 +838,77 @@ void Logging::SetFileLogging(const std::wstring &filePath, bool clearFile)
 */
 void Logging::SetLogLevel(LogLevel minLevel)
 {
-    s_MinLevel = minLevel;
+    s_MinLevel.store(minLevel, std::memory_order_relaxed);
+}
+
+/*
+** Rotate the log file once it would grow past maxBytes, keeping up to
+** maxFiles older copies (logs.1.log, logs.2.log, ...). maxBytes = 0 disables rotation.
+*/
+void Logging::SetFileRotation(uint64_t maxBytes, int maxFiles)
+{
+    std::lock_guard<std::mutex> lock(s_ConfigLock);
+    s_MaxFileBytes = maxBytes;
+    s_MaxFiles = maxFiles < 0 ? 0 : maxFiles;
+}
+
+/*
+** Choose whether Debug / Info messages are dropped or block the caller
+** while the queue is full.
+*/
+void Logging::SetOverflowPolicy(LogOverflowPolicy policy)
+{
+    s_OverflowPolicy.store(policy, std::memory_order_relaxed);
+}
+
+LogStats Logging::GetStats()
+{
+    LogStats stats;
+    stats.enqueued = s_Enqueued.load(std::memory_order_relaxed);
+    stats.written = s_Written.load(std::memory_order_relaxed);
+    stats.dropped = s_Dropped.load(std::memory_order_relaxed);
+    stats.blocked = s_Blocked.load(std::memory_order_relaxed);
+    stats.rotations = s_Rotations.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void Logging::Flush()
+{
+    if (!s_WriterRunning.load(std::memory_order_acquire))
+        return;
+
+    const uint64_t target = s_Enqueued.load(std::memory_order_seq_cst);
+    const uint64_t generation = s_ConfigGeneration.load(std::memory_order_acquire);
+
+    s_FlushWaiters.fetch_add(1, std::memory_order_seq_cst);
+    SetEvent(s_WakeEvent);
+    {
+        std::unique_lock<std::mutex> lock(s_FlushLock);
+        s_FlushCv.wait_for(lock, std::chrono::seconds(5), [&]()
+                           { return (s_Written.load(std::memory_order_seq_cst) >= target &&
+                                     s_AppliedGeneration.load(std::memory_order_seq_cst) >= generation) ||
+                                    !s_WriterRunning.load(std::memory_order_acquire); });
+    }
+    s_FlushWaiters.fetch_sub(1, std::memory_order_seq_cst);
+}
+
+void Logging::Shutdown()
+{
+    if (s_ShutDown.exchange(true))
+        return;
+    if (!s_WriterRunning.load(std::memory_order_acquire))
+        return;
+
+    s_StopRequested.store(true, std::memory_order_seq_cst);
+    SetEvent(s_WakeEvent);
+    WaitForSingleObject(s_WriterThread, INFINITE);
+    CloseHandle(s_WriterThread);
+    s_WriterThread = nullptr;
+    s_WriterRunning.store(false, std::memory_order_release);
+
+    // Anything pushed while the writer was stopping.
+    std::lock_guard<std::mutex> lock(s_DirectLock);
+    std::vector<LogRecord> batch;
+    DrainQueue(batch);
+    NotifyFlushWaiters();
 }
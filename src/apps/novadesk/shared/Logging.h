@@ -1,4 +1,4 @@
-/* Copyright (C) 2026 OfficialNovadesk 
+/* Copyright (C) 2026 OfficialNovadesk
  *
  * This Source Code Form is subject to the terms of the GNU General Public
  * License; either version 2 of the License, or (at your option) any later
@@ -9,6 +9,7 @@
 #define __NOVADESK_LOGGING_H__
 
 #include <windows.h>
+#include <cstdint>
 #include <string>
 
 enum class LogLevel
@@ -19,20 +20,53 @@ enum class LogLevel
     Error = 3
 };
 
+/*
+** What Log() does when the queue is full.
+** Warn and Error messages always wait for space; the policy only applies
+** to Debug and Info messages.
+*/
+enum class LogOverflowPolicy
+{
+    Drop = 0,
+    Block = 1
+};
+
+struct LogStats
+{
+    uint64_t enqueued = 0;
+    uint64_t written = 0;
+    uint64_t dropped = 0;
+    uint64_t blocked = 0;
+    uint64_t rotations = 0;
+};
+
+/*
+** Messages are formatted on the calling thread, pushed into a bounded
+** lock-free queue and written to the console / log file by a background
+** writer thread. The log file stays open between batches.
+*/
 class Logging
 {
 public:
 
     static void Log(LogLevel level, const wchar_t* format, ...);
+    static bool IsEnabled(LogLevel level);
     static void SetConsoleLogging(bool enable);
     static void SetFileLogging(const std::wstring& filePath, bool clearFile = false);
     static void SetLogLevel(LogLevel minLevel);
+    static void SetFileRotation(uint64_t maxBytes, int maxFiles);
+    static void SetOverflowPolicy(LogOverflowPolicy policy);
+    static LogStats GetStats();
+
+    // Also write binary records (see LogRecordFormat.h) to this file. Empty path disables it.
+    static void SetStructuredLogFile(const std::wstring& filePath);
+    // Source tag (e.g. widget script path) attached to structured records logged from this thread.
+    static void SetThreadLogSource(const std::wstring& source);
 
-private:
-    static bool s_ConsoleEnabled;
-    static bool s_FileEnabled;
-    static std::wstring s_LogFilePath;
-    static LogLevel s_MinLevel;
+    // Block until every message queued so far has been written.
+    static void Flush();
+    // Drain the queue and stop the writer thread. Later messages are written synchronously.
+    static void Shutdown();
 };
 
 #endif
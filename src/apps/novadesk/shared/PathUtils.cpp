@@ -384,7 +384,7 @@ namespace PathUtils {
     */
     std::wstring ResolvePath(const std::wstring& path, const std::wstring& baseDir) {
         if (path.empty()) return L"";
-        if (IsURL(path))
+        if (IsURL(path) || IsMemoryPath(path))
             return path;
         if (IsURL(baseDir))
             return ResolveUrl(path, baseDir);
@@ -436,6 +436,11 @@ namespace PathUtils {
                lower.rfind(L"file://", 0) == 0;
     }
 
+    bool IsMemoryPath(const std::wstring& path)
+    {
+        return path.length() > 9 && _wcsnicmp(path.c_str(), L"memory://", 9) == 0;
+    }
+
     std::wstring GetUrlParentDir(const std::wstring& url)
     {
         if (!IsURL(url))
@@ -42,6 +42,8 @@ namespace PathUtils {
     std::wstring ResolvePath(const std::wstring& path, const std::wstring& baseDir = L"");
     std::wstring GetScriptBaseDir(const std::wstring& scriptPath, const std::wstring& defaultBaseDir);
     bool IsURL(const std::wstring& path);
+    // memory://<key> names an image held in ImageStore; never resolved.
+    bool IsMemoryPath(const std::wstring& path);
     std::wstring GetUrlParentDir(const std::wstring& url);
     std::wstring ResolveUrl(const std::wstring& path, const std::wstring& baseUrl);
 }
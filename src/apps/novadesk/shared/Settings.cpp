@@ -11,6 +11,7 @@
 #include "ColorUtil.h"
 #include "PathUtils.h"
 #include "Novadesk.h"
+#include "../core/PerfCounters.h"
 #include <filesystem>
 #include <fstream>
 #include <iomanip>
@@ -31,6 +32,7 @@ std::wstring Settings::GetSettingsPath()
 
 void Settings::Load()
 {
+    PerfCounters::ScopedTimer ioTimer(PerfCounters::Histogram::SettingsIoTime, PerfCounters::Counter::SettingsLoads);
     std::wstring path = GetSettingsPath();
     std::ifstream i{std::filesystem::path(path)};
     if (i.is_open())
@@ -106,7 +108,8 @@ bool Settings::IsFirstRun()
 void Settings::Save()
 {
     if (!s_Dirty) return;
-    
+
+    PerfCounters::ScopedTimer ioTimer(PerfCounters::Histogram::SettingsIoTime, PerfCounters::Counter::SettingsSaves);
     std::wstring path = GetSettingsPath();
     std::ofstream o{std::filesystem::path(path)};
     if (o.is_open())
@@ -217,3 +220,11 @@ bool Settings::GetGlobalBool(const std::string& key, bool defaultValue)
     }
     return defaultValue;
 }
+
+int Settings::GetGlobalInt(const std::string& key, int defaultValue)
+{
+    if (s_Data.contains(key) && s_Data[key].is_number_integer()) {
+        return s_Data[key].get<int>();
+    }
+    return defaultValue;
+}
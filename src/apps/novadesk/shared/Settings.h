@@ -29,6 +29,7 @@ public:
 
     static void SetGlobalBool(const std::string& key, bool value);
     static bool GetGlobalBool(const std::string& key, bool defaultValue);
+    static int GetGlobalInt(const std::string& key, int defaultValue);
 
 private:
     static void Load();
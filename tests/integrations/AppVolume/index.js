@@ -0,0 +1,43 @@
+import { addon } from "novadesk";
+
+// Exercises the AppVolume session registry: getAll() batch reads and
+// onChange() events. Start, stop or mute an app in the volume mixer while
+// it runs.
+
+const appVolume = addon.load(path.join(__addonsPath, "AppVolume.dll"));
+
+function dump(label) {
+  const all = appVolume.getAll();
+  console.log("[INFO] " + label + ": " + all.length + " processes");
+  all.forEach((p) => {
+    console.log("  pid=" + p.pid + " " + p.processName + " sessions=" + p.sessions +
+      " volume=" + p.volume.toFixed(2) + " muted=" + p.muted + " active=" + p.active);
+  });
+  return all;
+}
+
+let changes = 0;
+appVolume.onChange(() => {
+  changes++;
+  dump("change #" + changes);
+});
+
+const all = dump("initial");
+const target = all.find((p) => p.active);
+if (target) {
+  const before = target.volume;
+  const next = before >= 0.5 ? before - 0.1 : before + 0.1;
+  console.log("[INFO] setVolumeByPid(" + target.pid + ", " + next.toFixed(2) + ") = " +
+    appVolume.setVolumeByPid(target.pid, next));
+  const after = appVolume.getByPid(target.pid);
+  console.log((after && Math.abs(after.volume - next) < 0.01 ? "[PASS]" : "[FAIL]") +
+    " getByPid reflects the new volume without re-enumerating");
+  appVolume.setVolumeByPid(target.pid, before);
+} else {
+  console.log("[INFO] no active session; play some audio to test setVolumeByPid");
+}
+
+setTimeout(() => {
+  appVolume.onChange(null);
+  console.log("[PASS] " + changes + " change events received");
+}, 15000);
@@ -0,0 +1,56 @@
+import { widgetWindow, addon } from "novadesk";
+
+// Polls each AudioLevel analysis mode for a few seconds; play some audio
+// while it runs. Band modes other than "bands" and the waveform come back
+// as Float32Array.
+
+const win = new widgetWindow({
+  id: "audioLevelModes",
+  width: 200,
+  height: 80,
+  backgroundColor: "rgb(20,20,20)"
+});
+
+const audioLevel = addon.load(path.join(__addonsPath, "AudioLevel.dll"));
+
+const modes = [
+  { mode: "bands", bands: 10 },
+  { mode: "cqt", fftSize: 512, fftOverlap: 256, bands: 60 },
+  { mode: "mel", bands: 40, freqMax: 16000 },
+  { mode: "bark", bands: 24, freqMax: 16000 },
+  { mode: "waveform", waveformPoints: 256, waveformDuration: 100 }
+];
+
+function loudest(values) {
+  let index = 0;
+  for (let i = 1; i < values.length; i++) {
+    if (values[i] > values[index]) index = i;
+  }
+  return index;
+}
+
+let current = 0;
+let ticks = 0;
+const interval = setInterval(() => {
+  const options = modes[current];
+  const stats = audioLevel.stats(options);
+  if (!stats) {
+    console.log("[FAIL] " + options.mode + ": no capture device");
+  } else if (options.mode === "waveform") {
+    const w = stats.waveform;
+    console.log("[INFO] waveform typed=" + (w instanceof Float32Array) + " length=" + w.length +
+      " newest=[" + w[w.length - 2].toFixed(3) + ", " + w[w.length - 1].toFixed(3) + "]");
+  } else {
+    const b = stats.bands;
+    console.log("[INFO] " + options.mode + " typed=" + (b instanceof Float32Array) + " length=" + b.length +
+      " loudest=" + loudest(b) + " rms=" + stats.rms[0].toFixed(3));
+  }
+
+  if (++ticks % 30 === 0) {
+    current++;
+    if (current === modes.length) {
+      clearInterval(interval);
+      console.log("[PASS] all modes polled");
+    }
+  }
+}, 100);
@@ -0,0 +1,52 @@
+import { app, widgetWindow } from "novadesk";
+
+console.log("=== BitmapFrameCache Integration ===");
+
+const widget = new widgetWindow({
+  id: "bitmapFrameCacheTest",
+  x: 200,
+  y: 140,
+  width: 420,
+  height: 260,
+  backgroundColor: "#101418",
+  script: "./script.ui.js",
+  show: true
+});
+
+// Frame indices and the needle angle change at ~30 Hz while tint and colour
+// matrix stay put: the tinted strip and needle are rasterised once and every
+// later frame is a blit, so imageEffectBuilds must not grow with the ticks.
+let tick = 0;
+let buildsAtStart = -1;
+const timer = setInterval(function () {
+  tick += 1;
+  ipcMain.send("frames:tick", JSON.stringify({ tick: tick }));
+
+  if (tick === 10) {
+    buildsAtStart = app.getPerfStats().counters.imageEffectBuilds;
+  }
+
+  if (tick === 90) {
+    const stats = app.getPerfStats();
+    const entry = stats.widgets.find((w) => w.id === "bitmapFrameCacheTest");
+    const builds = stats.counters.imageEffectBuilds;
+    console.log("imageEffectBuilds=" + builds + " (at tick 10: " + buildsAtStart + ")");
+    console.log((builds === buildsAtStart ? "[PASS] " : "[FAIL] ") + "frame changes reuse the processed bitmaps");
+    console.log((entry && entry.frames > 0 ? "[PASS] " : "[FAIL] ") + "meters rendered, mean frame " + (entry ? entry.meanFrameUs.toFixed(1) : "n/a") + "us");
+  }
+
+  if (tick === 100) {
+    // A tint change has to rebuild.
+    ipcMain.send("frames:retint", "");
+  }
+
+  if (tick === 110) {
+    const builds = app.getPerfStats().counters.imageEffectBuilds;
+    console.log((builds > buildsAtStart ? "[PASS] " : "[FAIL] ") + "tint change rebuilds the processed bitmap");
+  }
+}, 33);
+
+widget.on("close", function () {
+  clearInterval(timer);
+  app.exit();
+});
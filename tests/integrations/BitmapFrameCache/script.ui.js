@@ -0,0 +1,62 @@
+console.log("=== BitmapFrameCache UI Started ===");
+
+ui.beginUpdate();
+
+ui.addBitmap({
+    id: "tinted-strip",
+    x: 20,
+    y: 20,
+    value: 0,
+    bitmapImageName: "../BatteryBitmap/assets/battery-strip-11.png",
+    bitmapFrames: 11,
+    imageTint: "rgb(120, 200, 255)"
+});
+
+ui.addBitmap({
+    id: "matrix-digits",
+    x: 20,
+    y: 120,
+    value: 0,
+    bitmapImageName: "../BatteryBitmap/assets/battery-strip-11.png",
+    bitmapFrames: 11,
+    bitmapExtend: true,
+    bitmapDigits: 3,
+    colorMatrix: [
+        0.33, 0.33, 0.33, 0,
+        0.33, 0.33, 0.33, 0,
+        0.33, 0.33, 0.33, 0,
+        0, 0, 0, 1,
+        0, 0, 0, 0
+    ]
+});
+
+ui.addRotator({
+    id: "tinted-needle",
+    x: 260,
+    y: 40,
+    width: 140,
+    height: 140,
+    value: 0,
+    rotatorImageName: "../RotatorElement/assets/needle.png",
+    offsetX: 70,
+    offsetY: 70,
+    maxValue: 100,
+    imageTint: "rgb(255, 160, 80)",
+    imageAlpha: 200
+});
+
+ui.endUpdate();
+
+ipcRenderer.on("frames:tick", function (event, raw) {
+    const tick = JSON.parse(raw).tick;
+    ui.beginUpdate();
+    ui.setElementProperties("tinted-strip", { value: (tick % 11) / 10 });
+    ui.setElementProperties("matrix-digits", { value: tick % 1000 });
+    // Fading the needle is draw opacity, not a rebuild.
+    ui.setElementProperties("tinted-needle", { value: tick % 100, imageAlpha: 155 + (tick % 100) });
+    ui.endUpdate();
+});
+
+ipcRenderer.on("frames:retint", function () {
+    ui.setElementProperties("tinted-strip", { imageTint: "rgb(255, 90, 90)" });
+});
@@ -0,0 +1,59 @@
+import { addon, widgetWindow } from "novadesk";
+
+// Exercises BlurBehind: apply() reaches DWM at once and reports the result,
+// repeated apply() calls with the same look are skipped, and queue()d
+// changes made in one turn are sent together. Also captures a
+// software-blurred backdrop.
+
+const blur = addon.load(path.join(__addonsPath, "BlurBehind.dll"));
+
+const win = new widgetWindow({
+  id: "blurBehindTest",
+  width: 320,
+  height: 120,
+  backgroundColor: "rgba(20, 20, 30, 0.4)",
+  script: "./script.ui.js"
+});
+
+const hwnd = win.getHandle();
+
+// apply() is synchronous: the accent and corner are sent before it returns.
+const applied = blur.apply(hwnd, "acrylic", "round");
+const first = blur.stats();
+console.log((applied === true && first.accentCalls === 1 && first.cornerCalls === 1 ? "[PASS]" : "[FAIL]") +
+  " apply() sent the change at once: " + JSON.stringify(first));
+
+// Re-applying the same look, as a refresh handler would, is free.
+for (let i = 0; i < 100; i++) {
+  blur.apply(hwnd, "acrylic", "round");
+}
+const again = blur.stats();
+console.log((again.accentCalls === first.accentCalls && again.cornerCalls === first.cornerCalls ? "[PASS]" : "[FAIL]") +
+  " 100 identical apply() calls reached DWM " + (again.accentCalls - first.accentCalls) + " times" +
+  " (a corner DWM refused is not retried either)");
+
+// Several queued changes in one turn: only the last look is sent, in one flush.
+blur.queue(hwnd, "blurbehind", "square");
+blur.queue(hwnd, "acrylic", "small");
+blur.queue(hwnd, null, "round");
+const queued = blur.stats();
+console.log((queued.accentCalls === again.accentCalls && queued.flushes === 0 ? "[PASS]" : "[FAIL]") +
+  " queue() only records: " + JSON.stringify(queued));
+
+setTimeout(() => {
+  const flushed = blur.stats();
+  console.log((flushed.flushes === 1 && flushed.accentCalls === queued.accentCalls &&
+    flushed.cornerCalls === queued.cornerCalls ? "[PASS]" : "[FAIL]") +
+    " queued changes back to the applied look sent nothing: " + JSON.stringify(flushed));
+
+  blur.queue(hwnd, "none");
+  console.log((blur.flush() === 1 ? "[PASS]" : "[FAIL]") + " flush() sends a queued disable at once");
+
+  console.log((blur.disable(hwnd) === true ? "[PASS]" : "[FAIL]") + " disable() on a disabled window succeeds");
+  console.log((blur.stats().failed === 0 ? "[PASS]" : "[FAIL]") + " no queued change failed");
+
+  const start = Date.now();
+  const shot = blur.captureBlur(hwnd, 24);
+  console.log((shot && shot.path.indexOf("memory://") === 0 ? "[PASS]" : "[FAIL]") +
+    " captureBlur: " + JSON.stringify(shot) + " in " + (Date.now() - start) + "ms");
+}, 200);
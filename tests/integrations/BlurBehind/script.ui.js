@@ -0,0 +1,9 @@
+ui.addText({
+    id: "label",
+    x: 160,
+    y: 60,
+    text: "BlurBehind",
+    fontColor: "rgb(255, 255, 255)",
+    fontSize: 20,
+    textAlign: "centercenter"
+});
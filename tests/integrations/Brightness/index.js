@@ -0,0 +1,65 @@
+import { addon } from "novadesk";
+
+// Exercises the Brightness service: cached reads, coalesced sets and
+// onChange(). Sweeps display 0 as a slider drag would, then restores it.
+// Change resolution or plug a monitor in while it runs to see re-enumeration;
+// a set queued meanwhile still applies afterwards.
+
+const loadStart = Date.now();
+const brightness = addon.load(path.join(__addonsPath, "Brightness.dll"));
+
+// Nothing waits for the first enumeration; values arrive shortly after load.
+const loaded = brightness.getValue();
+const loadElapsed = Date.now() - loadStart;
+console.log((loadElapsed < 500 ? "[PASS]" : "[FAIL]") + " load and first getValue() took " + loadElapsed +
+  "ms (ready=" + loaded.ready + ")");
+
+function whenReady(run) {
+  if (brightness.getValue().ready) {
+    run();
+  } else {
+    setTimeout(() => whenReady(run), 50);
+  }
+}
+
+whenReady(() => {
+  const count = brightness.getDisplayCount();
+  console.log("[INFO] " + count + " displays ready after " + (Date.now() - loadStart) + "ms");
+  for (let i = 0; i < count; i++) {
+    const v = brightness.getValue({ display: i });
+    console.log("  display " + i + ": supported=" + v.supported + " percent=" + v.percent +
+      " raw=" + v.current + " (" + v.min + "-" + v.max + ")");
+  }
+
+  let changes = 0;
+  brightness.onChange(() => {
+    changes++;
+    const v = brightness.getValue();
+    console.log("[INFO] change #" + changes + ": percent=" + v.percent + " pending=" + v.pending);
+  });
+
+  const initial = brightness.getValue();
+  if (initial.supported) {
+    const start = Date.now();
+    for (let p = 0; p <= 100; p += 2) {
+      brightness.setValue({ percent: p });
+    }
+    const elapsed = Date.now() - start;
+    console.log((elapsed < 50 ? "[PASS]" : "[FAIL]") + " 51 setValue calls returned in " + elapsed + "ms");
+    console.log((brightness.getValue().pending ? "[PASS]" : "[INFO]") + " a set is pending right after the sweep");
+
+    setTimeout(() => {
+      const v = brightness.getValue();
+      console.log((Math.abs(v.percent - 100) <= 2 && !v.pending ? "[PASS]" : "[FAIL]") +
+        " only the last level stuck: " + v.percent);
+      brightness.setValue(initial.percent);
+    }, 3000);
+  } else {
+    console.log("[INFO] display 0 has no brightness control");
+  }
+
+  setTimeout(() => {
+    brightness.onChange(null);
+    console.log("[PASS] " + changes + " change events received");
+  }, 15000);
+});
@@ -0,0 +1,36 @@
+import { app, widgetWindow } from "novadesk";
+
+console.log("=== CacheAsBitmap Integration ===");
+
+const widget = new widgetWindow({
+  id: "cacheAsBitmapTest",
+  x: 180,
+  y: 120,
+  width: 520,
+  height: 300,
+  backgroundColor: "#101418",
+  script: "./script.ui.js",
+  show: true
+});
+
+// Only the clock text changes; the shadowed cards should be composited
+// from their cached bitmaps after the first few frames.
+let tick = 0;
+const timer = setInterval(function () {
+  tick += 1;
+  ipcMain.send("cache:tick", JSON.stringify({ tick: tick }));
+
+  if (tick === 20) {
+    const stats = app.getPerfStats();
+    const entry = stats.widgets.find((w) => w.id === "cacheAsBitmapTest");
+    console.log("renderCacheHits=" + stats.counters.renderCacheHits + " renderCacheBuilds=" + stats.counters.renderCacheBuilds +
+      " renderCacheBytes=" + (entry ? entry.renderCacheBytes : 0));
+    console.log((stats.counters.renderCacheHits > 0 ? "[PASS] " : "[FAIL] ") + "static cards served from cache");
+    console.log((entry && entry.renderCacheBytes > 0 ? "[PASS] " : "[FAIL] ") + "cache memory reported");
+  }
+}, 100);
+
+widget.on("close", function () {
+  clearInterval(timer);
+  app.exit();
+});
@@ -0,0 +1,47 @@
+function expectEq(name, actual, expected) {
+  const ok = actual === expected;
+  console.log((ok ? "[PASS] " : "[FAIL] ") + name + " expected=" + expected + " actual=" + actual);
+}
+
+function card(id, x, title) {
+  ui.addLayoutBox({
+    id: id,
+    x: x,
+    y: 30,
+    width: 210,
+    height: 140,
+    backgroundColor: "#ffffff",
+    borderRadius: 14,
+    borderWidth: 1,
+    borderColor: "#202020",
+    cacheAsBitmap: true,
+    boxShadow: [
+      { x: 0, y: 1, blur: 2, spread: 0, color: "rgba(0,0,0,0.12)", inset: false },
+      { x: 0, y: 12, blur: 32, spread: -6, color: "rgba(0,0,0,0.28)", inset: false }
+    ],
+    children: [
+      ui.text({ id: id + "Title", x: 0, y: 0, text: title, fontSize: 18, fontColor: "#111111" })
+    ]
+  });
+}
+
+ui.beginUpdate();
+card("cardA", 30, "static card A");
+card("cardB", 280, "static card B");
+ui.addText({ id: "clock", x: 30, y: 220, text: "tick 0", fontSize: 16, fontColor: "#e0e6ee" });
+ui.endUpdate();
+
+expectEq("cacheAsBitmap getter", ui.getElementProperty("cardA", "cacheAsBitmap"), true);
+expectEq("cacheAsBitmap defaults off", ui.getElementProperty("clock", "cacheAsBitmap"), false);
+
+ipcRenderer.on("cache:tick", function (event, payloadArg) {
+  const raw = (payloadArg === undefined) ? event : payloadArg;
+  const payload = typeof raw === "string" ? JSON.parse(raw) : raw;
+  if (!payload) return;
+
+  ui.setElementProperties("clock", { text: "tick " + payload.tick });
+
+  // Changing a child invalidates the card; it is re-cached once stable again.
+  if (payload.tick === 10)
+    ui.setElementProperties("cardBTitle", { text: "updated card B" });
+});
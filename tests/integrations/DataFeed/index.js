@@ -0,0 +1,49 @@
+import { addon } from "novadesk";
+
+// Reads a shared-memory feed published by the demo producer. Start it first:
+//
+//   datafeed_bench --publish demo 60
+//
+// (built from src/addons/DataFeed/CMakeLists.txt). It publishes 4 records of
+// { counter, value, label } every 100 ms.
+
+const dataFeed = addon.load(path.join(__addonsPath, "DataFeed.dll"));
+
+const feed = dataFeed.open("demo");
+if (feed === null) {
+  console.log("[FAIL] feed 'demo' not found; is the producer running?");
+} else {
+  const info = dataFeed.info(feed);
+  console.log("[INFO] " + info.name + ": " + info.recordCount + " records, fields " +
+    info.fields.join(", ") + " (" + info.types.join(", ") + "), producer pid " + info.producerPid);
+
+  const first = dataFeed.read(feed, 0);
+  console.log((first && typeof first.counter === "number" && typeof first.label === "string" ? "[PASS]" : "[FAIL]") +
+    " read(feed, 0): " + JSON.stringify(first));
+  console.log((dataFeed.read(feed, info.recordCount) === null ? "[PASS]" : "[FAIL]") + " out-of-range record reads null");
+  console.log((dataFeed.readAll(feed).length === info.recordCount ? "[PASS]" : "[FAIL]") + " readAll returns every record");
+
+  // Polling is memory reads only; 10000 reads should take a few ms at most.
+  const start = Date.now();
+  for (let i = 0; i < 10000; i++) {
+    dataFeed.read(feed, i % info.recordCount);
+  }
+  console.log("[INFO] 10000 reads in " + (Date.now() - start) + "ms");
+
+  let notifications = 0;
+  let changedRecords = 0;
+  const sub = dataFeed.subscribe(feed, (change) => {
+    notifications++;
+    changedRecords += change.records.length;
+  }, 20);
+
+  setTimeout(() => {
+    dataFeed.unsubscribe(sub);
+    console.log((notifications > 0 ? "[PASS]" : "[FAIL]") + " " + notifications + " change notifications covering " +
+      changedRecords + " record updates in 2 s");
+    const g = dataFeed.generation(feed);
+    console.log((dataFeed.close(feed) && !dataFeed.close(feed) ? "[PASS]" : "[FAIL]") + " close(feed) at generation " + g);
+  }, 2000);
+}
+
+console.log((dataFeed.open("no-such-feed") === null ? "[PASS]" : "[FAIL]") + " open() of a missing feed returns null");
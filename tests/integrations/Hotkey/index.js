@@ -0,0 +1,43 @@
+import { addon } from "novadesk";
+
+// Exercises the Hotkey addon's hook table and event ring. Press and release
+// Ctrl+Shift+K a few times (also releasing the modifiers first), then hold
+// any keys to load the hook; stats are printed every 5 seconds.
+
+const hotkey = addon.load(path.join(__addonsPath, "Hotkey.dll"));
+
+let downs = 0;
+let ups = 0;
+const id = hotkey.register("Ctrl+Shift+K", {
+  onKeyDown: () => {
+    downs++;
+    console.log("[INFO] Ctrl+Shift+K down #" + downs);
+  },
+  onKeyUp: () => {
+    ups++;
+    console.log("[INFO] Ctrl+Shift+K up #" + ups);
+  }
+});
+
+// Register and drop a second hotkey while the first stays live, so the
+// table is rebuilt under the running hook.
+const temp = hotkey.register("Alt+F9", () => console.log("[INFO] Alt+F9"));
+console.log((hotkey.unregister(temp) ? "[PASS]" : "[FAIL]") + " unregister(" + temp + ")");
+console.log((!hotkey.unregister(temp) ? "[PASS]" : "[FAIL]") + " second unregister returns false");
+
+function report() {
+  const s = hotkey.stats();
+  console.log("[INFO] hook calls=" + s.hookCalls + " last=" + s.lastMicros.toFixed(1) +
+    "us avg=" + s.avgMicros.toFixed(1) + "us max=" + s.maxMicros.toFixed(1) +
+    "us events=" + s.events + " dropped=" + s.dropped + " hooked=" + s.hooked);
+}
+
+const timer = setInterval(report, 5000);
+
+setTimeout(() => {
+  clearInterval(timer);
+  report();
+  console.log((downs === ups ? "[PASS]" : "[FAIL]") + " every key down got a key up (" + downs + "/" + ups + ")");
+  hotkey.unregister(id);
+  console.log((!hotkey.stats().hooked ? "[PASS]" : "[FAIL]") + " hook removed with the last hotkey");
+}, 30000);
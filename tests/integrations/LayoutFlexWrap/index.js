@@ -0,0 +1,16 @@
+import { app, widgetWindow } from "novadesk";
+
+console.log("=== LayoutFlexWrap Integration ===");
+
+new widgetWindow({
+  id: "LayoutFlexWrapWindow",
+  x: 200,
+  y: 140,
+  width: 420,
+  height: 360,
+  backgroundColor: "rgba(18,20,28,0.96)",
+  script: "./script.ui.js",
+  show: true
+}).on("close", function () {
+  app.exit();
+});
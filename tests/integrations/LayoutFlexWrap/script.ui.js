@@ -0,0 +1,99 @@
+function pass(name, details) {
+  console.log("[PASS] " + name + (details ? " -> " + details : ""));
+}
+
+function fail(name, details) {
+  console.log("[FAIL] " + name + (details ? " -> " + details : ""));
+}
+
+function expectEq(name, actual, expected) {
+  if (actual === expected) pass(name, "expected=" + expected + " actual=" + actual);
+  else fail(name, "expected=" + expected + " actual=" + actual);
+}
+
+function box(id, width, height, extra) {
+  const options = {
+    id: id,
+    type: "rectangle",
+    width: width,
+    height: height,
+    fillColor: "rgba(0,160,255,0.8)"
+  };
+  for (const key in extra || {}) options[key] = extra[key];
+  return ui.shape(options);
+}
+
+// flexWrap: five 50px items, 200px wide, gap 10 -> three on the first line.
+ui.addLayoutBox({
+  id: "wrapRow",
+  x: 10,
+  y: 10,
+  width: 200,
+  height: 80,
+  gap: 10,
+  flexWrap: "wrap",
+  children: [
+    box("wrap0", 50, 20),
+    box("wrap1", 50, 20),
+    box("wrap2", 50, 20),
+    box("wrap3", 50, 20),
+    box("wrap4", 50, 20)
+  ]
+});
+
+expectEq("wrap: third item stays on line 1", ui.getElementProperty("wrap2", "y"), 0);
+expectEq("wrap: fourth item starts line 2 (x)", ui.getElementProperty("wrap3", "x"), 0);
+expectEq("wrap: fourth item starts line 2 (y)", ui.getElementProperty("wrap3", "y"), 30);
+expectEq("flexWrap getter", ui.getElementProperty("wrapRow", "flexWrap"), "wrap");
+
+// flexGrow: 300px row, two 50px items growing 1:3 with a 20px gap.
+ui.addLayoutBox({
+  id: "growRow",
+  x: 10,
+  y: 110,
+  width: 300,
+  height: 30,
+  gap: 20,
+  children: [
+    box("grow0", 50, 20, { flexGrow: 1 }),
+    box("grow1", 50, 20, { flexGrow: 3 })
+  ]
+});
+
+expectEq("flexGrow: first share", ui.getElementProperty("grow0", "width"), 95);
+expectEq("flexGrow: second share", ui.getElementProperty("grow1", "width"), 185);
+expectEq("flexGrow: second position", ui.getElementProperty("grow1", "x"), 115);
+
+// space-between pins the outer items to the edges.
+ui.addLayoutBox({
+  id: "spaceRow",
+  x: 10,
+  y: 160,
+  width: 300,
+  height: 30,
+  justifyContent: "space-between",
+  children: [
+    box("space0", 40, 20),
+    box("space1", 40, 20),
+    box("space2", 40, 20)
+  ]
+});
+
+expectEq("spaceBetween: middle item", ui.getElementProperty("space1", "x"), 130);
+expectEq("spaceBetween: last item", ui.getElementProperty("space2", "x"), 260);
+expectEq("justifyContent getter", ui.getElementProperty("spaceRow", "justifyContent"), "spaceBetween");
+
+// Changing one item only reflows its own layout box.
+ui.setElementProperties("space0", { width: 100 });
+expectEq("reflow after resize: middle item", ui.getElementProperty("space1", "x"), 160);
+expectEq("reflow after resize: other box untouched", ui.getElementProperty("grow1", "x"), 115);
+
+// A grown item keeps its declared size: shrinking the row gives it back.
+ui.setElementProperties("growRow", { width: 140 });
+expectEq("grow recomputed from the declared basis", ui.getElementProperty("grow0", "width"), 55);
+
+// Getters read back what the script set, not the parsed value's name.
+ui.setElementProperties("spaceRow", { align: "flexEnd", flexDirection: "row-reverse" });
+expectEq("align getter keeps the script's string", ui.getElementProperty("spaceRow", "align"), "flexEnd");
+expectEq("flexDirection getter keeps the script's string", ui.getElementProperty("spaceRow", "flexDirection"), "row-reverse");
+expectEq("justifyContent kept across an unrelated set", ui.getElementProperty("spaceRow", "justifyContent"), "spaceBetween");
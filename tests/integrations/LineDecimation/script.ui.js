@@ -0,0 +1,86 @@
+// Long series (200k samples) on ~500px wide charts.
+// Covers: decimation ("minMax" default, "lttb", "none") on line and areaGraph,
+// scrolling updates through setElementProperties.
+
+function logAssert(name, actual, expected) {
+    var ok = actual === expected;
+    console.log((ok ? "[PASS] " : "[FAIL] ") + name + " | expected=" + expected + " actual=" + actual);
+}
+
+var SAMPLES = 200000;
+var phase = 0;
+
+function sample(i) {
+    return 50 + Math.sin(i * 0.002) * 30 + Math.sin(i * 0.37) * 8 + ((i % 997) === 0 ? 15 : 0);
+}
+
+var series = [];
+for (var i = 0; i < SAMPLES; i++)
+    series.push(sample(i));
+phase = SAMPLES;
+
+ui.beginUpdate();
+
+ui.addLine({
+    id: "line-minmax",
+    x: 20,
+    y: 20,
+    width: 520,
+    height: 120,
+    lineCount: 1,
+    data: series,
+    lineColor: "rgba(45, 196, 255, 1)",
+    autoRange: true,
+    maxPoints: SAMPLES,
+    backgroundColor: "rgba(255, 255, 255, 0.04)"
+});
+
+ui.addLine({
+    id: "line-lttb",
+    x: 20,
+    y: 150,
+    width: 520,
+    height: 120,
+    lineCount: 1,
+    data: series,
+    lineColor: "rgba(255, 160, 70, 1)",
+    autoRange: true,
+    maxPoints: SAMPLES,
+    decimation: "lttb",
+    backgroundColor: "rgba(255, 255, 255, 0.04)"
+});
+
+ui.addAreaGraph({
+    id: "area-minmax",
+    x: 20,
+    y: 280,
+    width: 520,
+    height: 120,
+    data: series,
+    autoRange: true,
+    maxPoints: SAMPLES,
+    lineColor: "rgba(130, 255, 140, 1)",
+    fillColor: "rgba(130, 255, 140, 0.25)"
+});
+
+ui.endUpdate();
+
+logAssert("line decimation default", ui.getElementProperty("line-minmax", "decimation"), "minMax");
+logAssert("line decimation lttb", ui.getElementProperty("line-lttb", "decimation"), "lttb");
+logAssert("areaGraph decimation default", ui.getElementProperty("area-minmax", "decimation"), "minMax");
+
+ui.setElementProperties("line-lttb", { decimation: "bogus" });
+logAssert("unknown decimation keeps mode", ui.getElementProperty("line-lttb", "decimation"), "lttb");
+
+ipcRenderer.on("decimation:tick", function (event, payloadArg) {
+    // Scroll: drop the oldest samples, append new ones (maxPoints trims).
+    for (var k = 0; k < 4; k++)
+        series.push(sample(phase++));
+    series.splice(0, 4);
+
+    ui.beginUpdate();
+    ui.setElementProperties("line-minmax", { data: series });
+    ui.setElementProperties("line-lttb", { data: series });
+    ui.setElementProperties("area-minmax", { data: series });
+    ui.endUpdate();
+});
@@ -0,0 +1,25 @@
+import { widgetWindow, addon } from "novadesk";
+
+// Shows the current SMTC session with its cover art; play, pause, seek and
+// skip tracks in any player while it runs. The thumbnail is a memory:// path
+// into the host image store, so nothing is written to %TEMP%.
+
+const nowPlaying = addon.load(path.join(__addonsPath, "NowPlaying.dll"));
+
+new widgetWindow({
+  id: "nowPlayingTest",
+  width: 360,
+  height: 120,
+  backgroundColor: "rgb(20,20,20)",
+  script: "./script.ui.js"
+});
+
+let lastThumbnail = "";
+setInterval(() => {
+  const stats = nowPlaying.stats();
+  if (stats.thumbnail !== lastThumbnail) {
+    lastThumbnail = stats.thumbnail;
+    console.log("[INFO] cover " + (stats.thumbnail || "(none)"));
+  }
+  ipcMain.send("now-playing", stats);
+}, 250);
@@ -0,0 +1,49 @@
+ui.beginUpdate();
+
+ui.addImage({
+  id: "cover",
+  x: 10, y: 10,
+  width: 100, height: 100,
+  preserveAspectRatio: "preserve"
+});
+
+ui.addText({
+  id: "title",
+  text: "waiting...",
+  x: 120, y: 14,
+  width: 230, height: 24,
+  fontSize: 15,
+  fontColor: "rgb(230,230,230)"
+});
+
+ui.addText({
+  id: "position",
+  text: "",
+  x: 120, y: 44,
+  width: 230, height: 20,
+  fontSize: 13,
+  fontColor: "rgb(160,160,160)"
+});
+
+ui.endUpdate();
+
+function formatTime(sec) {
+  const m = Math.floor(sec / 60);
+  const s = sec % 60;
+  return m + ":" + (s < 10 ? "0" : "") + s;
+}
+
+let cover = "";
+ipcRenderer.on("now-playing", (event, stats) => {
+  if (stats.thumbnail !== cover) {
+    cover = stats.thumbnail;
+    ui.setElementProperties("cover", { path: cover });
+  }
+  ui.setElementProperties("title", {
+    text: stats.available ? stats.artist + " - " + stats.title : "no session"
+  });
+  ui.setElementProperties("position", {
+    text: formatTime(stats.position) + " / " + formatTime(stats.duration) +
+      (stats.state === 1 ? "  playing" : stats.state === 2 ? "  paused" : "")
+  });
+});
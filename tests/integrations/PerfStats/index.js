@@ -0,0 +1,40 @@
+import { app, widgetWindow } from "novadesk";
+
+const win = new widgetWindow({
+  id: "perfStatsDemo",
+  width: 200,
+  height: 80,
+  backgroundColor: "rgb(20,20,20)"
+});
+
+let ticks = 0;
+const interval = setInterval(() => {
+  ticks++;
+  if (ticks < 10)
+    return;
+  clearInterval(interval);
+
+  const stats = app.getPerfStats();
+  console.log("Uptime (ms): " + stats.uptimeMs);
+  console.log("Counters: " + JSON.stringify(stats.counters));
+
+  const frame = stats.histograms.widgetFrameTime;
+  console.log("Frame time: count=" + frame.count + " p50=" + frame.p50Us + "us p95=" + frame.p95Us + "us max=" + frame.maxUs + "us");
+
+  const timer = stats.histograms.timerCallbackTime;
+  console.log("Timer callbacks: " + stats.counters.timerCallbacks + " (p95 " + timer.p95Us + "us)");
+  console.log("Buckets per histogram: " + frame.buckets.length);
+
+  console.log("JS heap used (bytes): " + stats.js.heapUsedBytes + ", timers: " + stats.js.timers);
+  console.log("Working set (bytes): " + stats.process.workingSetBytes);
+
+  stats.widgets.forEach((w) => {
+    console.log("Widget " + w.id + ": frames=" + w.frames + " mean=" + w.meanFrameUs.toFixed(1) + "us elements=" + w.elements + " imageBytes=" + w.imageBytes);
+  });
+
+  // The running callback is recorded when it returns.
+  if (stats.counters.timerCallbacks < ticks - 1)
+    console.error("Expected at least " + (ticks - 1) + " timer callbacks to be counted");
+  if (!stats.widgets.some((w) => w.id === "perfStatsDemo"))
+    console.error("Expected perfStatsDemo in widget stats");
+}, 50);
@@ -0,0 +1,16 @@
+import { app, widgetWindow } from "novadesk";
+
+console.log("=== VirtualList Integration ===");
+
+new widgetWindow({
+  id: "VirtualListWindow",
+  x: 220,
+  y: 120,
+  width: 520,
+  height: 680,
+  backgroundColor: "rgba(18,20,28,0.96)",
+  script: "./script.ui.js",
+  show: true
+}).on("close", function () {
+  app.exit();
+});
@@ -0,0 +1,127 @@
+console.log("=== VirtualList UI Ready ===");
+
+const LIST_X = 40;
+const LIST_Y = 90;
+const LIST_W = 420;
+const LIST_H = 520;
+
+const ROW_H = 40;
+const ROW_GAP = 4;
+const ROW_COUNT = 10000;
+
+const contentHeight = ROW_COUNT * (ROW_H + ROW_GAP) - ROW_GAP;
+const maxScroll = Math.max(0, contentHeight - LIST_H);
+
+let scrollY = 0;
+let binds = 0;
+
+function clamp(v, min, max) {
+  if (v < min) return min;
+  if (v > max) return max;
+  return v;
+}
+
+function scrollBy(delta) {
+  scrollY = clamp(scrollY + delta, 0, maxScroll);
+  ui.beginUpdate();
+  // Only the container scrolls; the list rebinds the rows that came into view.
+  ui.setElementProperties("vl_list", { scrollY: scrollY });
+  ui.setElementProperties("vl_info", {
+    text: "Scroll: " + scrollY + " / " + maxScroll + "  binds: " + binds
+  });
+  ui.endUpdate();
+}
+
+ui.beginUpdate();
+
+ui.addText({
+  id: "vl_title",
+  x: 24,
+  y: 20,
+  width: 480,
+  height: 34,
+  text: "Virtual List (" + ROW_COUNT + " rows)",
+  fontSize: 26,
+  fontWeight: "bold",
+  fontColor: "rgb(232,236,255)"
+});
+
+ui.addText({
+  id: "vl_sub",
+  x: 24,
+  y: 52,
+  width: 480,
+  height: 24,
+  text: "Mouse wheel over the list; only visible rows exist as elements",
+  fontSize: 14,
+  fontColor: "rgb(164,176,220)"
+});
+
+ui.addShape({
+  id: "vl_list",
+  type: "rectangle",
+  x: LIST_X,
+  y: LIST_Y,
+  width: LIST_W,
+  height: LIST_H,
+  radius: 10,
+  fillColor: "rgba(28,32,52,0.92)",
+  strokeColor: "rgba(116,132,190,0.40)",
+  strokeWidth: 1,
+  onScrollUp: function () { scrollBy(-ROW_H * 3); },
+  onScrollDown: function () { scrollBy(ROW_H * 3); }
+});
+
+ui.addText({
+  id: "vl_info",
+  x: 40,
+  y: 624,
+  width: 460,
+  height: 24,
+  text: "Scroll: 0 / " + maxScroll,
+  fontSize: 14,
+  fontColor: "rgb(174,186,232)"
+});
+
+ui.setVirtualList("vl_list", {
+  itemCount: ROW_COUNT,
+  itemSize: ROW_H,
+  gap: ROW_GAP,
+  overscan: 3,
+  onCreateItem: function (e) {
+    // e.id is the slot element id the list positions and hides.
+    ui.addShape({
+      id: e.id,
+      type: "rectangle",
+      container: "vl_list",
+      x: 8,
+      y: 0,
+      width: LIST_W - 16,
+      height: ROW_H,
+      radius: 6,
+      fillColor: "rgba(92,120,220,0.35)",
+      onLeftMouseUp: function () {
+        console.log("clicked " + ui.getElementProperty(e.id + ".label", "text"));
+      }
+    });
+    ui.addText({
+      id: e.id + ".label",
+      container: e.id,
+      x: 12,
+      y: 10,
+      width: LIST_W - 40,
+      height: 20,
+      fontSize: 14,
+      fontColor: "rgb(226,232,255)"
+    });
+  },
+  onBindItem: function (e) {
+    binds++;
+    ui.setElementProperties(e.id + ".label", { text: "Row " + (e.index + 1) });
+    ui.setElementProperties(e.id, {
+      fillColor: e.index % 2 ? "rgba(92,120,220,0.35)" : "rgba(120,92,220,0.35)"
+    });
+  }
+});
+
+ui.endUpdate();